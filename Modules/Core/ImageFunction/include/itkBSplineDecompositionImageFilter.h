@@ -32,8 +32,10 @@
 
 #include "itkImageLinearIteratorWithIndex.h"
 #include "vnl/vnl_matrix.h"
+#include "itkProgressReporter.h"
 
-#include "itkImageToImageFilter.h"
+#include "itkInPlaceImageFilter.h"
+#include "itkMultiThreader.h"
 
 namespace itk
 {
@@ -62,26 +64,35 @@ namespace itk
  *               Requires the same order of Spline for each dimension.
  *               Can only process LargestPossibleRegion
  *
+ * The lines of each dimension are split over the threads. Along the
+ * dimensions other than the first one, each thread filters blocks of
+ * adjacent lines together, with the values of the lines interleaved, so
+ * that the recursions run over contiguous memory and are vectorized
+ * across the lines.
+ *
+ * When the input and output image types are the same, InPlaceOn()
+ * computes the coefficients in the input buffer instead of a copy of it.
+ * In-place computation is off by default.
+ *
  * \sa itkBSplineInterpolateImageFunction
  *
  * \ingroup ImageFilters
- * \ingroup SingleThreaded
  * \ingroup CannotBeStreamed
  * \ingroup ITKImageFunction
  */
 template< typename TInputImage, typename TOutputImage >
 class ITK_TEMPLATE_EXPORT BSplineDecompositionImageFilter:
-  public ImageToImageFilter< TInputImage, TOutputImage >
+  public InPlaceImageFilter< TInputImage, TOutputImage >
 {
 public:
   /** Standard class typedefs. */
   typedef BSplineDecompositionImageFilter                 Self;
-  typedef ImageToImageFilter< TInputImage, TOutputImage > Superclass;
+  typedef InPlaceImageFilter< TInputImage, TOutputImage > Superclass;
   typedef SmartPointer< Self >                            Pointer;
   typedef SmartPointer< const Self >                      ConstPointer;
 
   /** Run-time type information (and related methods). */
-  itkTypeMacro(BSplineDecompositionImageFilter, ImageToImageFilter);
+  itkTypeMacro(BSplineDecompositionImageFilter, InPlaceImageFilter);
 
   /** New macro for creation of through a Smart Pointer */
   itkNewMacro(Self);
@@ -94,6 +105,8 @@ public:
 
   typedef typename itk::NumericTraits< typename TOutputImage::PixelType >::RealType CoeffType;
 
+  typedef typename TOutputImage::SizeValueType SizeValueType;
+
   /** Dimension underlying input image. */
   itkStaticConstMacro(ImageDimension, unsigned int, TInputImage::ImageDimension);
   itkStaticConstMacro(OutputImageDimension, unsigned int,
@@ -136,42 +149,50 @@ protected:
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(BSplineDecompositionImageFilter);
 
+  /** Number of adjacent lines filtered together along the dimensions
+   * other than the first one. */
+  static ITK_CONSTEXPR_VAR unsigned int LineBlockSize = 8;
+
   /** Determines the poles given the Spline Order. */
   virtual void SetPoles();
 
-  /** Converts a vector of data to a vector of Spline coefficients. */
-  virtual bool DataToCoefficients1D();
+  /** Converts numberOfLines interleaved lines of dataLength values to
+   * Spline coefficients, in place. The n-th value of the l-th line is
+   * scratch[n * numberOfLines + l]. */
+  bool DataToCoefficients1D(CoeffType *scratch, SizeValueType dataLength,
+                            SizeValueType numberOfLines) const;
 
   /** Converts an N-dimension image of data to an equivalent sized image
    *    of spline coefficients. */
   void DataToCoefficientsND();
 
+  /** Converts the lines of the given range along the given dimension,
+   * using the given scratch. */
+  void DataToCoefficientsLines(unsigned int direction, SizeValueType firstLine,
+                               SizeValueType endLine, std::vector< CoeffType > & scratch,
+                               ProgressReporter & progress);
+
   /** Determines the first coefficient for the causal filtering of the data. */
-  virtual void SetInitialCausalCoefficient(double z);
+  void SetInitialCausalCoefficient(double z, CoeffType *scratch, SizeValueType dataLength,
+                                   SizeValueType numberOfLines) const;
 
   /** Determines the first coefficient for the anti-causal filtering of the
     data. */
-  virtual void SetInitialAntiCausalCoefficient(double z);
+  void SetInitialAntiCausalCoefficient(double z, CoeffType *scratch, SizeValueType dataLength,
+                                       SizeValueType numberOfLines) const;
 
   /** Copy the input image into the output image.
    *  Used to initialize the Coefficients image before calculation. */
   void CopyImageToImage();
 
-  /** Copies a vector of data from the Coefficients image (one line of the
-   *  output image) to the scratch. */
-  void CopyCoefficientsToScratch(OutputLinearIterator &);
+  /** Data shared by the threads converting the lines of one dimension. */
+  struct ThreadStruct
+  {
+    Self *       Filter;
+    unsigned int Direction;
+  };
 
-  /** Copies a vector of data from the scratch to the Coefficients image
-   *  (one line of the output image). */
-  void CopyScratchToCoefficients(OutputLinearIterator &);
-
-  // Variables needed by the smoothing spline routine.
-
-  /** Temporary storage for processing of Coefficients. */
-  std::vector< CoeffType >           m_Scratch;
-
-  /** Image size. */
-  typename TInputImage::SizeType m_DataLength;
+  static ITK_THREAD_RETURN_TYPE DataToCoefficientsThreaderCallback(void *arg);
 
   /** User specified spline order (3rd or cubic is the default). */
   unsigned int m_SplineOrder;
@@ -184,9 +205,6 @@ private:
 
   /** Tolerance used for determining initial causal coefficient. Default is 1e-10.*/
   double m_Tolerance;
-
-  /** Direction for iterator incrementing. Default is 0. */
-  unsigned int m_IteratorDirection;
 };
 } // namespace itk
 
@@ -28,10 +28,10 @@
 #ifndef itkBSplineDecompositionImageFilter_hxx
 #define itkBSplineDecompositionImageFilter_hxx
 #include "itkBSplineDecompositionImageFilter.h"
-#include "itkImageRegionConstIteratorWithIndex.h"
-#include "itkImageRegionIterator.h"
+#include "itkImageAlgorithm.h"
 #include "itkProgressReporter.h"
 #include "itkVector.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -40,11 +40,13 @@ template< typename TInputImage, typename TOutputImage >
 BSplineDecompositionImageFilter< TInputImage, TOutputImage >
 ::BSplineDecompositionImageFilter() :
   m_SplineOrder( 0 ),
-  m_Tolerance( 1e-10 ),   // Need some guidance on this one...what is reasonable?
-  m_IteratorDirection( 0 )
+  m_Tolerance( 1e-10 )   // Need some guidance on this one...what is reasonable?
 {
   int SplineOrder = 3;
   this->SetSplineOrder(SplineOrder);
+
+  // The input is only overwritten on request
+  this->InPlaceOff();
 }
 
 template< typename TInputImage, typename TOutputImage >
@@ -59,14 +61,15 @@ BSplineDecompositionImageFilter< TInputImage, TOutputImage >
 template< typename TInputImage, typename TOutputImage >
 bool
 BSplineDecompositionImageFilter< TInputImage, TOutputImage >
-::DataToCoefficients1D()
+::DataToCoefficients1D(CoeffType *scratch, SizeValueType dataLength,
+                       SizeValueType numberOfLines) const
 {
   // See Unser, 1993, Part II, Equation 2.5,
   // or Unser, 1999, Box 2. for an explanation.
 
   double c0 = 1.0;
 
-  if ( m_DataLength[m_IteratorDirection] == 1 ) // Required by mirror boundaries
+  if ( dataLength == 1 ) // Required by mirror boundaries
     {
     return false;
     }
@@ -79,28 +82,42 @@ BSplineDecompositionImageFilter< TInputImage, TOutputImage >
     }
 
   // Apply the gain
-  for ( unsigned int n = 0; n < m_DataLength[m_IteratorDirection]; n++ )
+  const SizeValueType numberOfValues = dataLength * numberOfLines;
+  for ( SizeValueType i = 0; i < numberOfValues; i++ )
     {
-    m_Scratch[n] *= c0;
+    scratch[i] *= c0;
     }
 
-  // Loop over all poles
+  // Loop over all poles. The recursions run along the lines, and the
+  // inner loops across the interleaved lines.
   for ( int k = 0; k < m_NumberOfPoles; k++ )
     {
+    const double z = m_SplinePoles[k];
+
     // Causal initialization
-    this->SetInitialCausalCoefficient(m_SplinePoles[k]);
+    this->SetInitialCausalCoefficient(z, scratch, dataLength, numberOfLines);
     // Causal recursion
-    for ( unsigned int n = 1; n < m_DataLength[m_IteratorDirection]; n++ )
+    for ( SizeValueType n = 1; n < dataLength; n++ )
       {
-      m_Scratch[n] += m_SplinePoles[k] * m_Scratch[n - 1];
+      CoeffType *       current = scratch + n * numberOfLines;
+      const CoeffType * previous = current - numberOfLines;
+      for ( SizeValueType l = 0; l < numberOfLines; l++ )
+        {
+        current[l] += z * previous[l];
+        }
       }
 
     // anticausal initialization
-    this->SetInitialAntiCausalCoefficient(m_SplinePoles[k]);
+    this->SetInitialAntiCausalCoefficient(z, scratch, dataLength, numberOfLines);
     // anticausal recursion
-    for ( int n = m_DataLength[m_IteratorDirection] - 2; 0 <= n; n-- )
+    for ( SizeValueType n = dataLength - 1; n > 0; n-- )
       {
-      m_Scratch[n] = m_SplinePoles[k] * ( m_Scratch[n + 1] - m_Scratch[n] );
+      CoeffType *       current = scratch + ( n - 1 ) * numberOfLines;
+      const CoeffType * next = current + numberOfLines;
+      for ( SizeValueType l = 0; l < numberOfLines; l++ )
+        {
+        current[l] = z * ( next[l] - current[l] );
+        }
       }
     }
   return true;
@@ -166,60 +183,80 @@ BSplineDecompositionImageFilter< TInputImage, TOutputImage >
 template< typename TInputImage, typename TOutputImage >
 void
 BSplineDecompositionImageFilter< TInputImage, TOutputImage >
-::SetInitialCausalCoefficient(double z)
+::SetInitialCausalCoefficient(double z, CoeffType *scratch, SizeValueType dataLength,
+                              SizeValueType numberOfLines) const
 {
   // See Unser, 1999, Box 2 for explanation
-  CoeffType     sum;
   double        zn, z2n, iz;
-  typename TInputImage::SizeValueType horizon;
+  SizeValueType horizon;
+
+  // The sums are accumulated in the first value of each line.
+  CoeffType *sum = scratch;
 
   // Yhis initialization corresponds to mirror boundaries
-  horizon = m_DataLength[m_IteratorDirection];
+  horizon = dataLength;
   zn = z;
   if ( m_Tolerance > 0.0 )
     {
-    horizon = (typename TInputImage::SizeValueType)
+    horizon = (SizeValueType)
       std::ceil( std::log(m_Tolerance) / std::log( std::fabs(z) ) );
     }
-  if ( horizon < m_DataLength[m_IteratorDirection] )
+  if ( horizon < dataLength )
     {
     // Accelerated loop
-    sum = m_Scratch[0];   // verify this
-    for ( unsigned int n = 1; n < horizon; n++ )
+    for ( SizeValueType n = 1; n < horizon; n++ )
       {
-      sum += zn * m_Scratch[n];
+      const CoeffType *values = scratch + n * numberOfLines;
+      for ( SizeValueType l = 0; l < numberOfLines; l++ )
+        {
+        sum[l] += zn * values[l];
+        }
       zn *= z;
       }
-    m_Scratch[0] = sum;
     }
   else
     {
     // Full loop
     iz = 1.0 / z;
-    z2n = std::pow( z, (double)( m_DataLength[m_IteratorDirection] - 1L ) );
-    sum = m_Scratch[0] + z2n * m_Scratch[m_DataLength[m_IteratorDirection] - 1L];
+    z2n = std::pow( z, (double)( dataLength - 1L ) );
+    const CoeffType *last = scratch + ( dataLength - 1 ) * numberOfLines;
+    for ( SizeValueType l = 0; l < numberOfLines; l++ )
+      {
+      sum[l] += z2n * last[l];
+      }
     z2n *= z2n * iz;
-    for ( unsigned int n = 1; n <= ( m_DataLength[m_IteratorDirection] - 2 ); n++ )
+    for ( SizeValueType n = 1; n <= ( dataLength - 2 ); n++ )
       {
-      sum += ( zn + z2n ) * m_Scratch[n];
+      const CoeffType *values = scratch + n * numberOfLines;
+      for ( SizeValueType l = 0; l < numberOfLines; l++ )
+        {
+        sum[l] += ( zn + z2n ) * values[l];
+        }
       zn *= z;
       z2n *= iz;
       }
-    m_Scratch[0] = sum / ( 1.0 - zn * zn );
+    for ( SizeValueType l = 0; l < numberOfLines; l++ )
+      {
+      sum[l] = sum[l] / ( 1.0 - zn * zn );
+      }
     }
 }
 
 template< typename TInputImage, typename TOutputImage >
 void
 BSplineDecompositionImageFilter< TInputImage, TOutputImage >
-::SetInitialAntiCausalCoefficient(double z)
+::SetInitialAntiCausalCoefficient(double z, CoeffType *scratch, SizeValueType dataLength,
+                                  SizeValueType numberOfLines) const
 {
   // This initialization corresponds to mirror boundaries.
   // See Unser, 1999, Box 2 for explanation.
   // Also see erratum at http://bigwww.epfl.ch/publications/unser9902.html
-  m_Scratch[m_DataLength[m_IteratorDirection] - 1] =
-    ( z / ( z * z - 1.0 ) )
-    * ( z * m_Scratch[m_DataLength[m_IteratorDirection] - 2] + m_Scratch[m_DataLength[m_IteratorDirection] - 1] );
+  CoeffType *       last = scratch + ( dataLength - 1 ) * numberOfLines;
+  const CoeffType * beforeLast = last - numberOfLines;
+  for ( SizeValueType l = 0; l < numberOfLines; l++ )
+    {
+    last[l] = ( z / ( z * z - 1.0 ) ) * ( z * beforeLast[l] + last[l] );
+    }
 }
 
 template< typename TInputImage, typename TOutputImage >
@@ -231,93 +268,122 @@ BSplineDecompositionImageFilter< TInputImage, TOutputImage >
 
   Size< ImageDimension > size = output->GetBufferedRegion().GetSize();
 
-  unsigned int count = output->GetBufferedRegion().GetNumberOfPixels() / size[0] * ImageDimension;
-
-  ProgressReporter progress(this, 0, count, 10);
-
-  // Initialize coeffient array
-  this->CopyImageToImage();   // Coefficients are initialized to the input data
-
-  // Loop through each dimension
+  // Loop through each dimension, the lines of a dimension being split
+  // over the threads
   for ( unsigned int n = 0; n < ImageDimension; n++ )
     {
-    m_IteratorDirection = n;
-
-    // Initialize iterators
-    OutputLinearIterator CIterator( output, output->GetBufferedRegion() );
-    CIterator.SetDirection(m_IteratorDirection);
-    // For each data vector
-    while ( !CIterator.IsAtEnd() )
+    if ( size[n] <= 1 )
       {
-      // Copy coefficients to scratch
-      this->CopyCoefficientsToScratch(CIterator);
-
-      // Perform 1D BSpline calculations
-      this->DataToCoefficients1D();
-
-      // Copy scratch back to coefficients.
-      // Brings us back to the end of the line we were working on.
-      CIterator.GoToBeginOfLine();
-      this->CopyScratchToCoefficients(CIterator);   // m_Scratch = m_Image;
-      CIterator.NextLine();
-      progress.CompletedPixel();
+      continue;
       }
+    ThreadStruct str;
+    str.Filter = this;
+    str.Direction = n;
+
+    this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+    this->GetMultiThreader()->SetSingleMethod( Self::DataToCoefficientsThreaderCallback, &str );
+    this->GetMultiThreader()->SingleMethodExecute();
     }
 }
 
 template< typename TInputImage, typename TOutputImage >
-void
+ITK_THREAD_RETURN_TYPE
 BSplineDecompositionImageFilter< TInputImage, TOutputImage >
-::CopyImageToImage()
+::DataToCoefficientsThreaderCallback(void *arg)
 {
-  typedef ImageRegionConstIteratorWithIndex< TInputImage > InputIterator;
-  typedef ImageRegionIterator< TOutputImage >              OutputIterator;
-  typedef typename TOutputImage::PixelType                 OutputPixelType;
+  MultiThreader::ThreadInfoStruct * info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  const ThreadIdType threadId = info->ThreadID;
+  const ThreadIdType numberOfThreads = info->NumberOfThreads;
+  ThreadStruct * str = static_cast< ThreadStruct * >( info->UserData );
 
-  InputIterator  inIt( this->GetInput(), this->GetInput()->GetBufferedRegion() );
-  OutputIterator outIt( this->GetOutput(), this->GetOutput()->GetBufferedRegion() );
+  const typename TOutputImage::RegionType region = str->Filter->GetOutput()->GetBufferedRegion();
+  const SizeValueType dataLength = region.GetSize( str->Direction );
+  const SizeValueType numberOfLines = region.GetNumberOfPixels() / dataLength;
 
-  inIt.GoToBegin();
-  outIt.GoToBegin();
+  // Split the lines in contiguous ranges, so that the blocks of adjacent
+  // lines are mostly full
+  const SizeValueType firstLine = numberOfLines * threadId / numberOfThreads;
+  const SizeValueType endLine = numberOfLines * ( threadId + 1 ) / numberOfThreads;
 
-  while ( !outIt.IsAtEnd() )
-    {
-    outIt.Set( static_cast< OutputPixelType >( inIt.Get() ) );
-    ++inIt;
-    ++outIt;
-    }
+  ProgressReporter progress( str->Filter, threadId, endLine - firstLine, 10,
+                             static_cast< float >( str->Direction ) / ImageDimension,
+                             1.0f / ImageDimension );
+
+  std::vector< CoeffType > scratch( dataLength * LineBlockSize );
+  str->Filter->DataToCoefficientsLines( str->Direction, firstLine, endLine, scratch, progress );
+
+  return ITK_THREAD_RETURN_VALUE;
 }
 
 template< typename TInputImage, typename TOutputImage >
 void
 BSplineDecompositionImageFilter< TInputImage, TOutputImage >
-::CopyScratchToCoefficients(OutputLinearIterator & Iter)
+::DataToCoefficientsLines(unsigned int direction, SizeValueType firstLine, SizeValueType endLine,
+                          std::vector< CoeffType > & scratch, ProgressReporter & progress)
 {
   typedef typename TOutputImage::PixelType OutputPixelType;
-  typename TOutputImage::SizeValueType j = 0;
-  while ( !Iter.IsAtEndOfLine() )
+
+  OutputImagePointer output = this->GetOutput();
+  const typename TOutputImage::SizeType size = output->GetBufferedRegion().GetSize();
+  OutputPixelType * buffer = output->GetBufferPointer();
+
+  // The values of a line are stride pixels apart, and the lines starting
+  // in the same slab of stride pixels are adjacent in memory.
+  SizeValueType stride = 1;
+  for ( unsigned int d = 0; d < direction; d++ )
+    {
+    stride *= size[d];
+    }
+  const SizeValueType dataLength = size[direction];
+
+  SizeValueType line = firstLine;
+  while ( line < endLine )
     {
-    Iter.Set( static_cast< OutputPixelType >( m_Scratch[j] ) );
-    ++Iter;
-    ++j;
+    const SizeValueType slab = line / stride;
+    const SizeValueType offset = line % stride;
+    SizeValueType blockSize = std::min( endLine - line, stride - offset );
+    blockSize = std::min( blockSize, static_cast< SizeValueType >( LineBlockSize ) );
+
+    OutputPixelType * start = buffer + slab * dataLength * stride + offset;
+    for ( SizeValueType n = 0; n < dataLength; n++ )
+      {
+      const OutputPixelType * values = start + n * stride;
+      CoeffType *             scratchValues = &scratch[n * blockSize];
+      for ( SizeValueType l = 0; l < blockSize; l++ )
+        {
+        scratchValues[l] = static_cast< CoeffType >( values[l] );
+        }
+      }
+
+    if ( this->DataToCoefficients1D( &scratch[0], dataLength, blockSize ) )
+      {
+      for ( SizeValueType n = 0; n < dataLength; n++ )
+        {
+        OutputPixelType * values = start + n * stride;
+        const CoeffType * scratchValues = &scratch[n * blockSize];
+        for ( SizeValueType l = 0; l < blockSize; l++ )
+          {
+          values[l] = static_cast< OutputPixelType >( scratchValues[l] );
+          }
+        }
+      }
+
+    for ( SizeValueType l = 0; l < blockSize; l++ )
+      {
+      progress.CompletedPixel();
+      }
+    line += blockSize;
     }
 }
 
-/**
- */
 template< typename TInputImage, typename TOutputImage >
 void
 BSplineDecompositionImageFilter< TInputImage, TOutputImage >
-::CopyCoefficientsToScratch(OutputLinearIterator & Iter)
+::CopyImageToImage()
 {
-  typename TOutputImage::SizeValueType j = 0;
-
-  while ( !Iter.IsAtEndOfLine() )
-    {
-    m_Scratch[j] = static_cast< CoeffType >( Iter.Get() );
-    ++Iter;
-    ++j;
-    }
+  ImageAlgorithm::Copy( this->GetInput(), this->GetOutput(),
+                        this->GetInput()->GetBufferedRegion(),
+                        this->GetOutput()->GetBufferedRegion() );
 }
 
 template< typename TInputImage, typename TOutputImage >
@@ -354,31 +420,18 @@ void
 BSplineDecompositionImageFilter< TInputImage, TOutputImage >
 ::GenerateData()
 {
-  // Allocate scratch memory
-  InputImageConstPointer inputPtr = this->GetInput();
+  // Allocate memory for output image, or reuse the input buffer when
+  // running in place
+  this->AllocateOutputs();
 
-  m_DataLength = inputPtr->GetBufferedRegion().GetSize();
-
-  typename TOutputImage::SizeValueType maxLength = 0;
-  for ( unsigned int n = 0; n < ImageDimension; n++ )
+  // Coefficients are initialized to the input data
+  if ( !this->GetRunningInPlace() )
     {
-    if ( m_DataLength[n] > maxLength )
-      {
-      maxLength = m_DataLength[n];
-      }
+    this->CopyImageToImage();
     }
-  m_Scratch.resize(maxLength);
-
-  // Allocate memory for output image
-  OutputImagePointer outputPtr = this->GetOutput();
-  outputPtr->SetBufferedRegion( outputPtr->GetRequestedRegion() );
-  outputPtr->Allocate();
 
   // Calculate actual output
   this->DataToCoefficientsND();
-
-  // Clean up
-  m_Scratch.clear();
 }
 } // namespace itk
 
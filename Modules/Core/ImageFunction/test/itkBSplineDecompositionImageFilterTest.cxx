@@ -28,6 +28,8 @@
 #include "itkFilterWatcher.h"
 #include "vnl/vnl_sample.h"
 #include "makeRandomImageBsplineInterpolator.h"
+#include "itkImageAlgorithm.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 
 
 /** Note:  This is the same test used for the itkBSplineResampleImageFunctionTest
@@ -106,5 +108,92 @@ int itkBSplineDecompositionImageFilterTest(int, char* [] )
     return EXIT_FAILURE;
     }
 
+  /** The coefficients of a 3D image must interpolate the image at the
+   *  grid points, and must not depend on the number of threads nor on
+   *  the coefficients being computed in place. */
+  typedef itk::Image<double,3>                                      Image3DType;
+  typedef itk::BSplineDecompositionImageFilter<Image3DType,Image3DType> Filter3DType;
+  typedef itk::BSplineResampleImageFunction<Image3DType,double>     Resample3DFunctionType;
+
+  Image3DType::SizeType size3D;
+  size3D[0] = 23;
+  size3D[1] = 17;
+  size3D[2] = 9;
+  Image3DType::Pointer image3D = Image3DType::New();
+  image3D->SetRegions( size3D );
+  image3D->Allocate();
+  for ( itk::ImageRegionIterator<Image3DType> it( image3D, image3D->GetLargestPossibleRegion() );
+        !it.IsAtEnd(); ++it )
+    {
+    it.Set( vnl_sample_uniform( -10.0, 10.0 ) );
+    }
+
+  for ( unsigned int splineOrder = 2; splineOrder <= 5; ++splineOrder )
+    {
+    Filter3DType::Pointer singleThreaded = Filter3DType::New();
+    singleThreaded->SetSplineOrder( splineOrder );
+    singleThreaded->SetNumberOfThreads( 1 );
+    singleThreaded->SetInput( image3D );
+    singleThreaded->Update();
+
+    Resample3DFunctionType::Pointer resample3D = Resample3DFunctionType::New();
+    resample3D->SetSplineOrder( splineOrder );
+    resample3D->SetInputImage( singleThreaded->GetOutput() );
+    for ( itk::ImageRegionConstIteratorWithIndex<Image3DType> it( image3D, image3D->GetLargestPossibleRegion() );
+          !it.IsAtEnd(); ++it )
+      {
+      Resample3DFunctionType::ContinuousIndexType index;
+      for ( unsigned int j = 0; j < 3; j++ )
+        {
+        index[j] = it.GetIndex()[j];
+        }
+      const double value = resample3D->EvaluateAtContinuousIndex( index );
+      if ( itk::Math::abs( value - it.Get() ) > 1e-6 )
+        {
+        std::cout << "The spline of order " << splineOrder << " does not interpolate the image at "
+                  << it.GetIndex() << ": " << value << " != " << it.Get() << std::endl;
+        std::cout << " Test failed. " << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+
+    // In place computation on a copy of the input
+    Image3DType::Pointer copy3D = Image3DType::New();
+    copy3D->SetRegions( size3D );
+    copy3D->Allocate();
+    itk::ImageAlgorithm::Copy( image3D.GetPointer(), copy3D.GetPointer(),
+                               image3D->GetLargestPossibleRegion(), copy3D->GetLargestPossibleRegion() );
+
+    Filter3DType::Pointer multiThreaded = Filter3DType::New();
+    multiThreaded->SetSplineOrder( splineOrder );
+    multiThreaded->SetNumberOfThreads( 3 );
+    multiThreaded->InPlaceOn();
+    multiThreaded->SetInput( copy3D );
+    const Image3DType::PixelType * copyBuffer = copy3D->GetBufferPointer();
+    multiThreaded->Update();
+
+    if ( multiThreaded->GetOutput()->GetBufferPointer() != copyBuffer )
+      {
+      std::cout << "The coefficients were not computed in place." << std::endl;
+      std::cout << " Test failed. " << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    itk::ImageRegionConstIterator<Image3DType> singleIt( singleThreaded->GetOutput(),
+                                                        image3D->GetLargestPossibleRegion() );
+    itk::ImageRegionConstIterator<Image3DType> multiIt( multiThreaded->GetOutput(),
+                                                       image3D->GetLargestPossibleRegion() );
+    for (; !singleIt.IsAtEnd(); ++singleIt, ++multiIt )
+      {
+      if ( itk::Math::NotExactlyEquals( singleIt.Get(), multiIt.Get() ) )
+        {
+        std::cout << "The coefficients depend on the number of threads: "
+                  << singleIt.Get() << " != " << multiIt.Get() << std::endl;
+        std::cout << " Test failed. " << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
   return EXIT_SUCCESS;
 }
@@ -26,7 +26,6 @@
 #include "itkExpImageFilter.h"
 #include "itkImageRegionIterator.h"
 #include "itkImageRegionIteratorWithIndex.h"
-#include "itkImportImageFilter.h"
 #include "itkIterationReporter.h"
 #include "itkSubtractImageFilter.h"
 #include "itkVectorIndexSelectionCastImageFilter.h"
@@ -509,33 +508,24 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>::RealIma
 N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
 ::UpdateBiasFieldEstimate( RealImageType* fieldEstimate )
 {
-  // Temporarily set the direction cosine to identity since the B-spline
-  // approximation algorithm works in parametric space and not physical
-  // space.
-  typename ScalarImageType::DirectionType identity;
-  identity.SetIdentity();
-
+  // The field estimate is fitted on its own grid, so it is given to the
+  // B-spline approximation as an image with one weight per pixel rather than
+  // as a point set.  The weight of the pixels outside the mask or with a
+  // non-positive confidence is zero, so they do not contribute to the fit.
+  // The direction cosine is ignored since the B-spline approximation
+  // algorithm works in parametric space and not physical space.
   const typename ScalarImageType::RegionType & bufferedRegion = fieldEstimate->GetBufferedRegion();
-  const SizeValueType numberOfPixels = bufferedRegion.GetNumberOfPixels();
-  const bool filterHandlesMemory = false;
-
-  typedef ImportImageFilter<RealType, ImageDimension> ImporterType;
-  typename ImporterType::Pointer importer = ImporterType::New();
-  importer->SetImportPointer( fieldEstimate->GetBufferPointer(), numberOfPixels, filterHandlesMemory );
-  importer->SetRegion( fieldEstimate->GetBufferedRegion() );
-  importer->SetOrigin( fieldEstimate->GetOrigin() );
-  importer->SetSpacing( fieldEstimate->GetSpacing() );
-  importer->SetDirection( identity );
-  importer->Update();
 
-  const typename ImporterType::OutputImageType * parametricFieldEstimate = importer->GetOutput();
+  typename ScalarImageType::Pointer parametricFieldEstimate = ScalarImageType::New();
+  parametricFieldEstimate->SetOrigin( fieldEstimate->GetOrigin() );
+  parametricFieldEstimate->SetSpacing( fieldEstimate->GetSpacing() );
+  parametricFieldEstimate->SetRegions( bufferedRegion );
+  parametricFieldEstimate->Allocate();
 
-  PointSetPointer fieldPoints = PointSetType::New();
-  fieldPoints->Initialize();
-
-  typename BSplineFilterType::WeightsContainerType::Pointer weights =
-    BSplineFilterType::WeightsContainerType::New();
-  weights->Initialize();
+  RealImagePointer fieldWeights = RealImageType::New();
+  fieldWeights->CopyInformation( parametricFieldEstimate );
+  fieldWeights->SetRegions( bufferedRegion );
+  fieldWeights->Allocate();
 
   const MaskImageType * maskImage = this->GetMaskImage();
   const RealImageType * confidenceImage = this->GetConfidenceImage();
@@ -544,12 +534,17 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
   const bool useMaskLabel = this->GetUseMaskLabel();
 #endif
 
-  ImageRegionConstIteratorWithIndex<RealImageType>
-    It( parametricFieldEstimate, parametricFieldEstimate->GetRequestedRegion() );
+  ImageRegionConstIteratorWithIndex<RealImageType> It( fieldEstimate, bufferedRegion );
+  ImageRegionIterator<ScalarImageType> ItF( parametricFieldEstimate, bufferedRegion );
+  ImageRegionIterator<RealImageType> ItW( fieldWeights, bufferedRegion );
 
-  unsigned int index = 0;
-  for ( It.GoToBegin(); !It.IsAtEnd(); ++It )
+  for ( It.GoToBegin(), ItF.GoToBegin(), ItW.GoToBegin(); !It.IsAtEnd(); ++It, ++ItF, ++ItW )
     {
+    ScalarType scalar;
+    scalar[0] = It.Get();
+    ItF.Set( scalar );
+
+    RealType confidenceWeight = 0.0;
     if( ( !maskImage ||
 #if ! defined ( ITK_FUTURE_LEGACY_REMOVE )
           ( useMaskLabel && maskImage->GetPixel( It.GetIndex() ) == maskLabel ) || ( !useMaskLabel &&
@@ -561,23 +556,13 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
         && ( !confidenceImage ||
              confidenceImage->GetPixel( It.GetIndex() ) > 0.0 ) )
       {
-      PointType point;
-      parametricFieldEstimate->TransformIndexToPhysicalPoint( It.GetIndex(), point );
-
-      ScalarType scalar;
-      scalar[0] = It.Get();
-
-      fieldPoints->SetPointData( index, scalar );
-      fieldPoints->SetPoint( index, point );
-
-      RealType confidenceWeight = 1.0;
+      confidenceWeight = 1.0;
       if( confidenceImage )
         {
         confidenceWeight = confidenceImage->GetPixel( It.GetIndex() );
         }
-      weights->InsertElement( index, confidenceWeight );
-      index++;
       }
+    ItW.Set( confidenceWeight );
     }
 
   typename BSplineFilterType::Pointer bspliner = BSplineFilterType::New();
@@ -614,8 +599,8 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
   bspliner->SetNumberOfLevels( numberOfFittingLevels );
   bspliner->SetSplineOrder( this->m_SplineOrder );
   bspliner->SetNumberOfControlPoints( numberOfControlPoints );
-  bspliner->SetInput( fieldPoints );
-  bspliner->SetPointWeights( weights );
+  bspliner->SetScatteredDataImage( parametricFieldEstimate );
+  bspliner->SetConfidenceImage( fieldWeights );
   bspliner->Update();
 
   typename BiasFieldControlPointLatticeType::Pointer phiLattice = bspliner->GetPhiLattice();
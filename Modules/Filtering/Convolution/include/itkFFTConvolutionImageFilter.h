@@ -24,6 +24,8 @@
 #include "itkHalfHermitianToRealInverseFFTImageFilter.h"
 #include "itkRealToHalfHermitianForwardFFTImageFilter.h"
 #include "itkZeroFluxNeumannBoundaryCondition.h"
+#include "itkSimpleFastMutexLock.h"
+#include <vector>
 
 namespace itk
 {
@@ -36,6 +38,12 @@ namespace itk
  * convolution theorem to accelerate the convolution computation when
  * the kernel is large.
  *
+ * By default, the whole input image, padded by the kernel size, is
+ * transformed at once. When a TileSize is set, the output is instead
+ * computed block by block with the overlap-save method, which bounds
+ * the memory used by the Fourier transforms and makes the filter
+ * streamable.
+ *
  * \warning This filter ignores the spacing, origin, and orientation
  * of the kernel image and treats them as identical to those in the
  * input image.
@@ -105,6 +113,19 @@ public:
   itkSetMacro(SizeGreatestPrimeFactor, SizeValueType);
   itkGetMacro(SizeGreatestPrimeFactor, SizeValueType);
 
+  /** Set/Get the size of the output blocks computed at once. Each block
+   * of the input, padded by the kernel size, is transformed, multiplied
+   * with the transform of the kernel, which is computed once for all the
+   * blocks, and transformed back. The blocks are processed in parallel,
+   * each thread working on its own blocks, and only the input region
+   * needed by the output requested region is requested. A zero size
+   * along a dimension means the whole output requested region along
+   * that dimension. The default size, zero along all the dimensions,
+   * transforms the whole padded input at once. Blocks a few times larger
+   * than the kernel are the most efficient. */
+  itkSetMacro(TileSize, OutputSizeType);
+  itkGetConstReferenceMacro(TileSize, OutputSizeType);
+
 protected:
   FFTConvolutionImageFilter();
   ~FFTConvolutionImageFilter() {}
@@ -122,7 +143,9 @@ protected:
    * general is going to be a different size than the output requested
    * region. As such, this filter needs to provide an implementation
    * for GenerateInputRequestedRegion() in order to inform the
-   * pipeline execution model.
+   * pipeline execution model. When the output is computed by tiles,
+   * only the output requested region padded by the kernel size is
+   * requested from the input.
    *
    * \sa ProcessObject::GenerateInputRequestedRegion()  */
   void GenerateInputRequestedRegion() ITK_OVERRIDE;
@@ -130,6 +153,28 @@ protected:
   /** This filter uses a minipipeline to compute the output. */
   void GenerateData() ITK_OVERRIDE;
 
+  /** Whether the output is computed by tiles, i.e. whether a non zero
+   * TileSize is set. Subclasses whose GenerateData() works on the whole
+   * image in the Fourier domain override this method to return false. */
+  virtual bool GetUseTiles() const;
+
+  /** Compute the output requested region tile by tile, with the
+   * overlap-save method. */
+  void GenerateDataByTiles();
+
+  /** Compute the output in the given tile, using the transform of the
+   * kernel and the per thread transform filters and block image. */
+  void ConvolveTile(const OutputRegionType & tile,
+                    const InternalComplexImageType * transformedKernel,
+                    FFTFilterType * fftFilter,
+                    IFFTFilterType * ifftFilter,
+                    InternalImageType * block);
+
+  /** Get the size of the blocks transformed for each tile: the tile size
+   * plus the kernel size minus one, increased to a size whose greatest
+   * prime factor is at most SizeGreatestPrimeFactor. */
+  InputSizeType GetTilePadSize() const;
+
   /** Prepare the input images for operations in the Fourier
    * domain. This includes resizing the input and kernel images,
    * normalizing the kernel if requested, shifting the kernel, and
@@ -163,6 +208,13 @@ protected:
                      InternalComplexImagePointerType & preparedKernel,
                      ProgressAccumulator * progress, float progressWeight);
 
+  /** Normalize the kernel if requested, pad it with zeros to padSize,
+   * shift its center to the origin and take its Fourier transform. */
+  void TransformKernel(const KernelImageType * kernel,
+                       const InputSizeType & padSize,
+                       InternalComplexImagePointerType & transformedKernel,
+                       ProgressAccumulator * progress, float progressWeight);
+
   /** Produce output from the final Fourier domain image. */
   void ProduceOutput(InternalComplexImageType * paddedOutput,
                      ProgressAccumulator * progress,
@@ -192,7 +244,23 @@ protected:
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(FFTConvolutionImageFilter);
 
-  SizeValueType m_SizeGreatestPrimeFactor;
+  /** Data shared by the threads convolving the tiles. */
+  struct TileThreadStruct
+  {
+    Self *                                          Filter;
+    std::vector< OutputRegionType >                 Tiles;
+    SizeValueType                                   NextTile;
+    SimpleFastMutexLock                             Lock;
+    const InternalComplexImageType *                TransformedKernel;
+    std::vector< typename FFTFilterType::Pointer >  FFTFilters;
+    std::vector< typename IFFTFilterType::Pointer > IFFTFilters;
+    std::vector< InternalImagePointerType >         Blocks;
+  };
+
+  static ITK_THREAD_RETURN_TYPE ConvolveTilesThreaderCallback(void *arg);
+
+  SizeValueType  m_SizeGreatestPrimeFactor;
+  OutputSizeType m_TileSize;
 };
 }
 
@@ -27,6 +27,8 @@
 #include "itkCyclicShiftImageFilter.h"
 #include "itkExtractImageFilter.h"
 #include "itkImageBase.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
 #include "itkMultiplyImageFilter.h"
 #include "itkNormalizeToConstantImageFilter.h"
 #include "itkMath.h"
@@ -39,6 +41,7 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
 ::FFTConvolutionImageFilter()
 {
   m_SizeGreatestPrimeFactor = FFTFilterType::New()->GetSizeGreatestPrimeFactor();
+  m_TileSize.Fill( 0 );
 }
 
 template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
@@ -46,14 +49,8 @@ void
 FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
 ::GenerateInputRequestedRegion()
 {
-  // Request the largest possible region for both input images.
-  if ( this->GetInput() )
-    {
-    typename InputImageType::Pointer imagePtr =
-      const_cast< InputImageType * >( this->GetInput() );
-    imagePtr->SetRequestedRegionToLargestPossibleRegion();
-    }
-
+  // Request the largest possible region for the kernel, and for the
+  // input unless the output is computed by tiles.
   if ( this->GetKernelImage() )
     {
     // Input kernel is an image, cast away the constness so we can set
@@ -62,6 +59,31 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
       const_cast< KernelImageType * >( this->GetKernelImage() );
     kernelPtr->SetRequestedRegionToLargestPossibleRegion();
     }
+
+  if ( this->GetInput() )
+    {
+    typename InputImageType::Pointer imagePtr =
+      const_cast< InputImageType * >( this->GetInput() );
+    if ( !this->GetUseTiles() || !this->GetKernelImage() )
+      {
+      imagePtr->SetRequestedRegionToLargestPossibleRegion();
+      return;
+      }
+
+    // Pad the output requested region by the kernel size, and let the
+    // boundary condition tell which part of the input it needs.
+    typedef typename OutputIndexType::IndexValueType IndexValueType;
+    const KernelSizeType kernelSize = this->GetKernelImage()->GetLargestPossibleRegion().GetSize();
+    OutputRegionType paddedRegion = this->GetOutput()->GetRequestedRegion();
+    for ( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+      paddedRegion.SetIndex( i, paddedRegion.GetIndex(i)
+                             - static_cast< IndexValueType >( kernelSize[i] - 1 - kernelSize[i] / 2 ) );
+      paddedRegion.SetSize( i, paddedRegion.GetSize(i) + kernelSize[i] - 1 );
+      }
+    imagePtr->SetRequestedRegion( this->GetBoundaryCondition()->GetInputRequestedRegion(
+                                    imagePtr->GetLargestPossibleRegion(), paddedRegion ) );
+    }
 }
 
 template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
@@ -69,6 +91,12 @@ void
 FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
 ::GenerateData()
 {
+  if ( this->GetUseTiles() )
+    {
+    this->GenerateDataByTiles();
+    return;
+    }
+
   // Create a process accumulator for tracking the progress of this minipipeline
   ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
   progress->SetMiniPipelineFilter( this );
@@ -201,14 +229,14 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
 template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
 void
 FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
-::PrepareKernel(const KernelImageType * kernel,
-                InternalComplexImagePointerType & preparedKernel,
-                ProgressAccumulator * progress, float progressWeight)
+::TransformKernel(const KernelImageType * kernel,
+                  const InputSizeType & padSize,
+                  InternalComplexImagePointerType & transformedKernel,
+                  ProgressAccumulator * progress, float progressWeight)
 {
   KernelRegionType kernelRegion = kernel->GetLargestPossibleRegion();
   KernelSizeType kernelSize = kernelRegion.GetSize();
 
-  InputSizeType padSize = this->GetPadSize();
   typename KernelImageType::SizeType kernelUpperBound;
   for (unsigned int i = 0; i < ImageDimension; ++i)
     {
@@ -276,9 +304,23 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
   typename FFTFilterType::Pointer kernelFFTFilter = FFTFilterType::New();
   kernelFFTFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
   kernelFFTFilter->SetInput( kernelShifter->GetOutput() );
-  progress->RegisterInternalFilter( kernelFFTFilter, 0.699f * progressWeight );
+  progress->RegisterInternalFilter( kernelFFTFilter, 0.7f * progressWeight );
   kernelFFTFilter->Update();
 
+  transformedKernel = kernelFFTFilter->GetOutput();
+  transformedKernel->DisconnectPipeline();
+}
+
+template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
+void
+FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::PrepareKernel(const KernelImageType * kernel,
+                InternalComplexImagePointerType & preparedKernel,
+                ProgressAccumulator * progress, float progressWeight)
+{
+  InternalComplexImagePointerType transformedKernel;
+  this->TransformKernel( kernel, this->GetPadSize(), transformedKernel, progress, 0.999f * progressWeight );
+
   typedef ChangeInformationImageFilter< InternalComplexImageType > InfoFilterType;
   typename InfoFilterType::Pointer kernelInfoFilter = InfoFilterType::New();
   kernelInfoFilter->ChangeRegionOn();
@@ -294,7 +336,7 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
     }
   kernelInfoFilter->SetOutputOffset( kernelOffset );
   kernelInfoFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
-  kernelInfoFilter->SetInput( kernelFFTFilter->GetOutput() );
+  kernelInfoFilter->SetInput( transformedKernel );
   progress->RegisterInternalFilter( kernelInfoFilter, 0.001f * progressWeight );
   kernelInfoFilter->Update();
 
@@ -365,6 +407,273 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
 
 }
 
+template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
+bool
+FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::GetUseTiles() const
+{
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    if ( m_TileSize[i] > 0 )
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
+void
+FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::GenerateDataByTiles()
+{
+  this->AllocateOutputs();
+
+  const OutputRegionType requestedRegion = this->GetOutput()->GetRequestedRegion();
+  if ( requestedRegion.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  // The same transform of the kernel is used for all the tiles.
+  ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
+  progress->SetMiniPipelineFilter( this );
+
+  const InputSizeType blockSize = this->GetTilePadSize();
+  InternalComplexImagePointerType transformedKernel;
+  this->TransformKernel( this->GetKernelImage(), blockSize, transformedKernel, progress, 0.1f );
+
+  // Split the output requested region in tiles
+  TileThreadStruct str;
+  str.Filter = this;
+  str.NextTile = 0;
+  str.TransformedKernel = transformedKernel;
+
+  OutputSizeType tileSize;
+  OutputSizeType numberOfTiles;
+  SizeValueType totalNumberOfTiles = 1;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    tileSize[i] = requestedRegion.GetSize(i);
+    if ( m_TileSize[i] > 0 && m_TileSize[i] < tileSize[i] )
+      {
+      tileSize[i] = m_TileSize[i];
+      }
+    numberOfTiles[i] = ( requestedRegion.GetSize(i) + tileSize[i] - 1 ) / tileSize[i];
+    totalNumberOfTiles *= numberOfTiles[i];
+    }
+  str.Tiles.reserve( totalNumberOfTiles );
+  for ( SizeValueType t = 0; t < totalNumberOfTiles; ++t )
+    {
+    OutputRegionType tile;
+    SizeValueType remainder = t;
+    for ( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+      const SizeValueType position = remainder % numberOfTiles[i];
+      remainder /= numberOfTiles[i];
+      tile.SetIndex( i, requestedRegion.GetIndex(i)
+                     + static_cast< typename OutputIndexType::IndexValueType >( position * tileSize[i] ) );
+      tile.SetSize( i, std::min( tileSize[i], requestedRegion.GetSize(i) - position * tileSize[i] ) );
+      }
+    str.Tiles.push_back( tile );
+    }
+
+  // Each thread gets its own transform filters and block. When there is
+  // a single tile, the transforms themselves are multithreaded.
+  ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+  if ( static_cast< SizeValueType >( numberOfThreads ) > totalNumberOfTiles )
+    {
+    numberOfThreads = static_cast< ThreadIdType >( totalNumberOfTiles );
+    }
+  this->GetMultiThreader()->SetNumberOfThreads( numberOfThreads );
+  numberOfThreads = this->GetMultiThreader()->GetNumberOfThreads();
+
+  typename InternalImageType::RegionType blockRegion;
+  blockRegion.SetSize( blockSize );
+  for ( ThreadIdType t = 0; t < numberOfThreads; ++t )
+    {
+    InternalImagePointerType block = InternalImageType::New();
+    block->SetRegions( blockRegion );
+    block->Allocate( true );
+    str.Blocks.push_back( block );
+
+    typename FFTFilterType::Pointer fftFilter = FFTFilterType::New();
+    fftFilter->SetInput( block );
+    typename IFFTFilterType::Pointer ifftFilter = IFFTFilterType::New();
+    ifftFilter->SetActualXDimensionIsOdd( blockSize[0] % 2 != 0 );
+    ifftFilter->SetInput( fftFilter->GetOutput() );
+    if ( numberOfThreads == 1 )
+      {
+      fftFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
+      ifftFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
+      }
+    else
+      {
+      fftFilter->SetNumberOfThreads( 1 );
+      ifftFilter->SetNumberOfThreads( 1 );
+      }
+    str.FFTFilters.push_back( fftFilter );
+    str.IFFTFilters.push_back( ifftFilter );
+    }
+
+  this->GetMultiThreader()->SetSingleMethod( Self::ConvolveTilesThreaderCallback, &str );
+  this->GetMultiThreader()->SingleMethodExecute();
+  this->UpdateProgress( 1.0f );
+}
+
+template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
+ITK_THREAD_RETURN_TYPE
+FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::ConvolveTilesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct * info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  const ThreadIdType threadId = info->ThreadID;
+  TileThreadStruct * str = static_cast< TileThreadStruct * >( info->UserData );
+
+  const SizeValueType numberOfTiles = str->Tiles.size();
+  while ( true )
+    {
+    SizeValueType tileNumber;
+    str->Lock.Lock();
+    tileNumber = str->NextTile++;
+    str->Lock.Unlock();
+    if ( tileNumber >= numberOfTiles )
+      {
+      break;
+      }
+
+    str->Filter->ConvolveTile( str->Tiles[tileNumber], str->TransformedKernel,
+                               str->FFTFilters[threadId], str->IFFTFilters[threadId],
+                               str->Blocks[threadId] );
+
+    // Progress events are only sent from the first thread
+    if ( threadId == 0 )
+      {
+      str->Filter->UpdateProgress( 0.1f + 0.9f * static_cast< float >( tileNumber + 1 ) / numberOfTiles );
+      }
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
+void
+FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::ConvolveTile(const OutputRegionType & tile,
+               const InternalComplexImageType * transformedKernel,
+               FFTFilterType * fftFilter,
+               IFFTFilterType * ifftFilter,
+               InternalImageType * block)
+{
+  typedef typename OutputIndexType::IndexValueType IndexValueType;
+
+  const InputImageType * input = this->GetInput();
+  const KernelSizeType kernelSize = this->GetKernelImage()->GetLargestPossibleRegion().GetSize();
+
+  // The output at index x depends on the input from x - (kernelSize - 1 -
+  // kernelSize / 2) to x + kernelSize / 2. This part of the input is
+  // copied at the beginning of the block; with a block at least that
+  // large, the circular convolution of the block is the linear one at
+  // the output positions, and the rest of the block is not used.
+  InputRegionType neededRegion;
+  typename InternalImageType::RegionType blockNeededRegion;
+  typename InternalImageType::IndexType  tileInBlockIndex;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    const SizeValueType lowerPad = kernelSize[i] - 1 - kernelSize[i] / 2;
+    neededRegion.SetIndex( i, tile.GetIndex(i) - static_cast< IndexValueType >( lowerPad ) );
+    neededRegion.SetSize( i, tile.GetSize(i) + kernelSize[i] - 1 );
+    blockNeededRegion.SetIndex( i, 0 );
+    blockNeededRegion.SetSize( i, neededRegion.GetSize(i) );
+    tileInBlockIndex[i] = static_cast< IndexValueType >( lowerPad );
+    }
+
+  if ( input->GetBufferedRegion().IsInside( neededRegion ) )
+    {
+    ImageRegionConstIterator< InputImageType > inputIt( input, neededRegion );
+    ImageRegionIterator< InternalImageType >   blockIt( block, blockNeededRegion );
+    for (; !inputIt.IsAtEnd(); ++inputIt, ++blockIt )
+      {
+      blockIt.Set( static_cast< TInternalPrecision >( inputIt.Get() ) );
+      }
+    }
+  else
+    {
+    // Extend the input with the boundary condition
+    const InputRegionType largestRegion = input->GetLargestPossibleRegion();
+    const BoundaryConditionType * boundaryCondition = this->GetBoundaryCondition();
+    ImageRegionIteratorWithIndex< InternalImageType > blockIt( block, blockNeededRegion );
+    for (; !blockIt.IsAtEnd(); ++blockIt )
+      {
+      InputIndexType index;
+      for ( unsigned int i = 0; i < ImageDimension; ++i )
+        {
+        index[i] = neededRegion.GetIndex(i) + blockIt.GetIndex()[i];
+        }
+      if ( largestRegion.IsInside( index ) )
+        {
+        blockIt.Set( static_cast< TInternalPrecision >( input->GetPixel( index ) ) );
+        }
+      else
+        {
+        blockIt.Set( static_cast< TInternalPrecision >( boundaryCondition->GetPixel( index, input ) ) );
+        }
+      }
+    }
+  block->Modified();
+
+  // Multiply the transform of the block by the one of the kernel
+  fftFilter->Update();
+  InternalComplexImageType * transformedBlock = fftFilter->GetOutput();
+  InternalComplexType * blockData = transformedBlock->GetBufferPointer();
+  const InternalComplexType * kernelData = transformedKernel->GetBufferPointer();
+  const SizeValueType numberOfValues = transformedBlock->GetBufferedRegion().GetNumberOfPixels();
+  for ( SizeValueType i = 0; i < numberOfValues; ++i )
+    {
+    blockData[i] *= kernelData[i];
+    }
+
+  // The transform of the block was changed in place
+  ifftFilter->Modified();
+  ifftFilter->Update();
+
+  typename InternalImageType::RegionType tileInBlockRegion( tileInBlockIndex, tile.GetSize() );
+  ImageRegionConstIterator< InternalImageType > resultIt( ifftFilter->GetOutput(), tileInBlockRegion );
+  ImageRegionIterator< OutputImageType >        outputIt( this->GetOutput(), tile );
+  for (; !outputIt.IsAtEnd(); ++resultIt, ++outputIt )
+    {
+    outputIt.Set( static_cast< OutputPixelType >( resultIt.Get() ) );
+    }
+}
+
+template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
+typename FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >::InputSizeType
+FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::GetTilePadSize() const
+{
+  const OutputSizeType requestedSize = this->GetOutput()->GetRequestedRegion().GetSize();
+  const KernelSizeType kernelSize = this->GetKernelImage()->GetLargestPossibleRegion().GetSize();
+
+  InputSizeType padSize;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    SizeValueType tileSize = requestedSize[i];
+    if ( m_TileSize[i] > 0 && m_TileSize[i] < tileSize )
+      {
+      tileSize = m_TileSize[i];
+      }
+    padSize[i] = tileSize + kernelSize[i] - 1;
+    if( m_SizeGreatestPrimeFactor > 1 )
+      {
+      while ( Math::GreatestPrimeFactor( padSize[i] ) > m_SizeGreatestPrimeFactor )
+        {
+        padSize[i]++;
+        }
+      }
+    }
+
+  return padSize;
+}
+
 template< typename TInputImage, typename TKernelImage, typename TOutputImage, typename TInternalPrecision >
 typename FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >::InputSizeType
 FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
@@ -425,6 +734,7 @@ FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPre
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "SizeGreatestPrimeFactor: " << m_SizeGreatestPrimeFactor << std::endl;
+  os << indent << "TileSize: " << m_TileSize << std::endl;
 }
 
 }
@@ -0,0 +1,182 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFFTConvolutionImageFilter.h"
+#include "itkConstantBoundaryCondition.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkRandomImageSource.h"
+#include "itkStreamingImageFilter.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+template< typename TImage >
+bool
+FFTConvolutionImageFilterTilesTestCompare(const TImage * expected, const TImage * result, const char * description)
+{
+  if ( expected->GetLargestPossibleRegion() != result->GetLargestPossibleRegion() )
+    {
+    std::cerr << "Test failed for " << description << ": the output regions differ: "
+              << expected->GetLargestPossibleRegion() << result->GetLargestPossibleRegion() << std::endl;
+    return false;
+    }
+  itk::ImageRegionConstIterator< TImage > expectedIt( expected, expected->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< TImage > resultIt( result, expected->GetLargestPossibleRegion() );
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++resultIt )
+    {
+    if ( itk::Math::abs( expectedIt.Get() - resultIt.Get() ) > 1e-3 )
+      {
+      std::cerr << "Test failed for " << description << " at index " << expectedIt.GetIndex()
+                << ": expected " << expectedIt.Get() << ", got " << resultIt.Get() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkFFTConvolutionImageFilterTilesTest(int, char *[])
+{
+  typedef itk::Image< float, 3 >                           ImageType;
+  typedef itk::FFTConvolutionImageFilter< ImageType >      FilterType;
+  typedef itk::ConstantBoundaryCondition< ImageType >      ConstantBoundaryConditionType;
+
+  typedef itk::RandomImageSource< ImageType >              SourceType;
+
+  ImageType::SizeType imageSize;
+  imageSize[0] = 37;
+  imageSize[1] = 29;
+  imageSize[2] = 11;
+  SourceType::Pointer source = SourceType::New();
+  source->SetSize( imageSize );
+  source->SetMin( 0.0 );
+  source->SetMax( 10.0 );
+  TRY_EXPECT_NO_EXCEPTION( source->Update() );
+  ImageType::Pointer image = source->GetOutput();
+  image->DisconnectPipeline();
+  ImageType::IndexType imageIndex;
+  imageIndex[0] = 3;
+  imageIndex[1] = -2;
+  imageIndex[2] = 0;
+  image->SetOrigin( 1.0 );
+  ImageType::RegionType imageRegion( imageIndex, imageSize );
+  image->SetRegions( imageRegion );
+
+  // Kernel with odd and even sizes
+  ImageType::SizeType kernelSize;
+  kernelSize[0] = 7;
+  kernelSize[1] = 4;
+  kernelSize[2] = 5;
+  SourceType::Pointer kernelSource = SourceType::New();
+  kernelSource->SetSize( kernelSize );
+  kernelSource->SetMin( 0.0 );
+  kernelSource->SetMax( 10.0 );
+  TRY_EXPECT_NO_EXCEPTION( kernelSource->Update() );
+  ImageType::Pointer kernel = kernelSource->GetOutput();
+
+  FilterType::Pointer filter = FilterType::New();
+  FilterType::OutputSizeType tileSize;
+  tileSize.Fill( 0 );
+  TEST_SET_GET_VALUE( tileSize, filter->GetTileSize() );
+
+  ConstantBoundaryConditionType constantBoundaryCondition;
+  constantBoundaryCondition.SetConstant( 2.0f );
+
+  bool passed = true;
+  for ( unsigned int mode = 0; mode < 3; ++mode )
+    {
+    FilterType::Pointer reference = FilterType::New();
+    reference->SetInput( image );
+    reference->SetKernelImage( kernel );
+    reference->SetNormalize( mode == 1 );
+    if ( mode == 1 )
+      {
+      reference->SetOutputRegionModeToValid();
+      }
+    if ( mode == 2 )
+      {
+      reference->SetBoundaryCondition( &constantBoundaryCondition );
+      }
+    TRY_EXPECT_NO_EXCEPTION( reference->Update() );
+
+    const itk::SizeValueType tileSizes[][3] = { { 8, 8, 8 }, { 0, 10, 3 }, { 100, 100, 100 }, { 1, 1, 1 } };
+    const itk::ThreadIdType numberOfThreads[] = { 1, 3, 4, 2 };
+    for ( unsigned int t = 0; t < 4; ++t )
+      {
+      FilterType::Pointer tiled = FilterType::New();
+      tiled->SetInput( image );
+      tiled->SetKernelImage( kernel );
+      tiled->SetNormalize( reference->GetNormalize() );
+      tiled->SetOutputRegionMode( reference->GetOutputRegionMode() );
+      tiled->SetBoundaryCondition( reference->GetBoundaryCondition() );
+      for ( unsigned int i = 0; i < 3; ++i )
+        {
+        tileSize[i] = tileSizes[t][i];
+        }
+      tiled->SetTileSize( tileSize );
+      TEST_SET_GET_VALUE( tileSize, tiled->GetTileSize() );
+      tiled->SetNumberOfThreads( numberOfThreads[t] );
+      TRY_EXPECT_NO_EXCEPTION( tiled->Update() );
+
+      std::ostringstream description;
+      description << "mode " << mode << " and tile size " << tileSize;
+      passed &= FFTConvolutionImageFilterTilesTestCompare< ImageType >( reference->GetOutput(), tiled->GetOutput(),
+                                                                        description.str().c_str() );
+      }
+
+    // With tiles, the filter can be streamed
+    FilterType::Pointer streamed = FilterType::New();
+    streamed->SetInput( image );
+    streamed->SetKernelImage( kernel );
+    streamed->SetNormalize( reference->GetNormalize() );
+    streamed->SetOutputRegionMode( reference->GetOutputRegionMode() );
+    streamed->SetBoundaryCondition( reference->GetBoundaryCondition() );
+    tileSize.Fill( 16 );
+    streamed->SetTileSize( tileSize );
+
+    typedef itk::StreamingImageFilter< ImageType, ImageType > StreamingFilterType;
+    StreamingFilterType::Pointer streamer = StreamingFilterType::New();
+    streamer->SetInput( streamed->GetOutput() );
+    streamer->SetNumberOfStreamDivisions( 4 );
+    TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+
+    if ( streamed->GetOutput()->GetBufferedRegion() == streamed->GetOutput()->GetLargestPossibleRegion() )
+      {
+      std::cerr << "Test failed: the output was not streamed." << std::endl;
+      passed = false;
+      }
+    if ( image->GetRequestedRegion() == image->GetLargestPossibleRegion() )
+      {
+      std::cerr << "Test failed: the whole input was requested for the last stream." << std::endl;
+      passed = false;
+      }
+
+    std::ostringstream description;
+    description << "mode " << mode << " streamed";
+    passed &= FFTConvolutionImageFilterTilesTestCompare< ImageType >( reference->GetOutput(), streamer->GetOutput(),
+                                                                      description.str().c_str() );
+    }
+
+  if ( !passed )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
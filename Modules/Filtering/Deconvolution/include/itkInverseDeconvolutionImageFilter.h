@@ -110,6 +110,9 @@ protected:
   /** This filter uses a minipipeline to compute the output. */
   virtual void GenerateData() ITK_OVERRIDE;
 
+  /** The deconvolution is computed over the whole image. */
+  virtual bool GetUseTiles() const ITK_OVERRIDE { return false; }
+
   virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
 
 private:
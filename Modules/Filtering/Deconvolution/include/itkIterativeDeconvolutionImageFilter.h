@@ -39,6 +39,9 @@ namespace itk
  * resume iterating, you must call SetStopIteration( bool ) with the
  * argument set to false before calling Update() a second time.
  *
+ * The iterations work on the whole image in the Fourier domain, so the
+ * TileSize inherited from FFTConvolutionImageFilter is ignored.
+ *
  * This code was adapted from the Insight Journal contribution:
  *
  * "Deconvolution: infrastructure and reference algorithms"
@@ -125,6 +128,9 @@ protected:
    * ThreadedGenerateData is not overridden. */
   virtual void GenerateData() ITK_OVERRIDE;
 
+  /** The deconvolution is computed over the whole image. */
+  virtual bool GetUseTiles() const ITK_OVERRIDE { return false; }
+
   /** Discrete Fourier transform of the padded kernel. */
   InternalComplexImagePointerType m_TransferFunction;
 
@@ -23,6 +23,7 @@
 #include "itkContinuousIndex.h"
 #include "itkImportImageFilter.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
 
 namespace itk
 {
@@ -209,7 +210,82 @@ DisplacementFieldToBSplineImageFilter<TInputImage, TInputPointSet, TOutputImage>
       }
     }
 
-  if( inputField )
+  // When the B-spline domain is the grid of the input field and no point set
+  // is given, the field is passed to the B-spline approximation as an image
+  // with one weight per pixel, so no point is created for each pixel.
+
+  typedef typename BSplineFilterType::PointDataImageType FieldImageType;
+  typedef typename BSplineFilterType::RealImageType      WeightsImageType;
+
+  const bool fitOnInputFieldGrid = inputField && !inputPointSet &&
+    this->m_UseInputFieldToDefineTheBSplineDomain && !this->m_EstimateInverse &&
+    inputField->GetBufferedRegion() == bsplineParametricDomainField->GetBufferedRegion();
+
+  typename FieldImageType::Pointer fieldImage;
+  typename WeightsImageType::Pointer weightsImage;
+
+  if( fitOnInputFieldGrid )
+    {
+    itkDebugMacro( "Fitting the input displacement field on its grid. " );
+
+    fieldImage = FieldImageType::New();
+    fieldImage->SetOrigin( this->m_BSplineDomainOrigin );
+    fieldImage->SetSpacing( this->m_BSplineDomainSpacing );
+    fieldImage->SetRegions( inputField->GetBufferedRegion() );
+    fieldImage->Allocate();
+
+    weightsImage = WeightsImageType::New();
+    weightsImage->CopyInformation( fieldImage );
+    weightsImage->SetRegions( inputField->GetBufferedRegion() );
+    weightsImage->Allocate();
+
+    ImageRegionConstIteratorWithIndex<InputFieldType> It( inputField, inputField->GetBufferedRegion() );
+    ImageRegionIterator<FieldImageType> ItF( fieldImage, fieldImage->GetBufferedRegion() );
+    ImageRegionIterator<WeightsImageType> ItW( weightsImage, weightsImage->GetBufferedRegion() );
+
+    for ( It.GoToBegin(), ItF.GoToBegin(), ItW.GoToBegin(); !It.IsAtEnd(); ++It, ++ItF, ++ItW )
+      {
+      typename DisplacementFieldType::IndexType index = It.GetIndex();
+
+      bool isOnStationaryBoundary = false;
+      if( this->m_EnforceStationaryBoundary )
+        {
+        for( unsigned int d = 0; d < ImageDimension; d++ )
+          {
+          if( index[d] == startIndex[d] || index[d] == startIndex[d] + static_cast<int>( this->m_BSplineDomainSize[d] ) - 1 )
+            {
+            isOnStationaryBoundary = true;
+            break;
+            }
+          }
+        }
+
+      VectorType data = It.Get();
+      typename WeightsContainerType::Element weight = 1.0;
+
+      if( isOnStationaryBoundary )
+        {
+        data.Fill( 0.0 );
+        weight = boundaryWeight;
+        }
+      else if( confidenceImage )
+        {
+        weight = NumericTraits<typename WeightsContainerType::Element>::ZeroValue();
+        if( confidenceImage->GetPixel( index ) > 0.0 )
+          {
+          weight = static_cast<typename WeightsContainerType::Element>( confidenceImage->GetPixel( index ) );
+          }
+        }
+
+      ItF.Set( data );
+      ItW.Set( weight );
+      if( weight > 0.0 )
+        {
+        numberOfPoints++;
+        }
+      }
+    }
+  else if( inputField )
     {
     itkDebugMacro( "Gathering information from the input displacement field. " );
 
@@ -381,8 +457,16 @@ DisplacementFieldToBSplineImageFilter<TInputImage, TInputPointSet, TOutputImage>
   bspliner->SetSplineOrder( this->m_SplineOrder );
   bspliner->SetNumberOfControlPoints( this->m_NumberOfControlPoints );
   bspliner->SetCloseDimension( close );
-  bspliner->SetInput( fieldPoints );
-  bspliner->SetPointWeights( weights );
+  if( fitOnInputFieldGrid )
+    {
+    bspliner->SetScatteredDataImage( fieldImage );
+    bspliner->SetConfidenceImage( weightsImage );
+    }
+  else
+    {
+    bspliner->SetInput( fieldPoints );
+    bspliner->SetPointWeights( weights );
+    }
   bspliner->SetGenerateOutputImage( true );
   bspliner->Update();
 
@@ -52,6 +52,11 @@ namespace itk
  * Danielsson, Per-Erik.  Euclidean Distance Mapping.  Computer
  * Graphics and Image Processing 14, 227-248 (1980).
  *
+ * ExactEuclideanDistanceMapImageFilter computes the exact distance and
+ * the nearest features with multiple threads and less memory.
+ *
+ * \sa ExactEuclideanDistanceMapImageFilter
+ *
  * \ingroup ImageFeatureExtraction
  * \ingroup ITKDistanceMap
  */
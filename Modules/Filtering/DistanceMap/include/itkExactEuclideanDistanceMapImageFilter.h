@@ -0,0 +1,208 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkExactEuclideanDistanceMapImageFilter_h
+#define itkExactEuclideanDistanceMapImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkMultiThreader.h"
+
+namespace itk
+{
+/** \class ExactEuclideanDistanceMapImageFilter
+ *
+ * \tparam TInputImage Input Image Type
+ * \tparam TOutputImage Output Image Type
+ * \tparam TDistance Type used to store the intermediate squared
+ * distances, float by default. An integer type like int32_t halves the
+ * memory of double and gives exact distances, but requires the squared
+ * spacing to be integral.
+ *
+ * \brief Exact Euclidean distance transform of a binary image in linear
+ * time, with the nearest feature map.
+ *
+ * The output is the Euclidean distance from each pixel to the nearest
+ * feature pixel, i.e. the nearest pixel of the input which is not equal
+ * to the BackgroundValue. The feature pixels have a distance of 0.
+ *
+ * The squared distance is separable: it is computed by a 1D transform
+ * along each dimension in turn, each 1D transform being the lower
+ * envelope of the parabolas rooted at the values of the previous one
+ * (Felzenszwalb and Huttenlocher, Distance Transforms of Sampled
+ * Functions, Theory of Computing 8, 2012, and Meijster, Roerdink and
+ * Hesselink, A General Algorithm for Computing Distance Transforms in
+ * Linear Time, 2000). The lines of each pass are independent and are
+ * processed by all the threads.
+ *
+ * When ComputeNearestFeatureImage is on, the second output holds, for
+ * each pixel, the offset in the largest possible region of the input of
+ * its nearest feature pixel, which can be converted to an index with
+ * ImageBase::ComputeIndex(). This is the Voronoi partition of the
+ * feature pixels. When the input has no feature pixel, the distances are
+ * the maximum of the output pixel type, and the nearest features are
+ * NumericTraits< SizeValueType >::max().
+ *
+ * Unlike DanielssonDistanceMapImageFilter, the filter does not store
+ * any vector image, and unlike SignedMaurerDistanceMapImageFilter, it
+ * only produces the requested region of the output: the dimensions are
+ * processed from the last one to the first one, so the intermediate
+ * squared distances are only stored for the slab of the requested
+ * region along the last dimension. The whole input is needed for every
+ * requested region, but as it is usually a binary image of small pixels,
+ * this allows the filter to be streamed, for example with a
+ * StreamingImageFilter, on volumes whose distance map does not fit in
+ * memory.
+ *
+ * \sa DanielssonDistanceMapImageFilter
+ * \sa SignedMaurerDistanceMapImageFilter
+ *
+ * \ingroup ImageFeatureExtraction
+ * \ingroup ITKDistanceMap
+ */
+template< typename TInputImage,
+          typename TOutputImage,
+          typename TDistance = float >
+class ITK_TEMPLATE_EXPORT ExactEuclideanDistanceMapImageFilter:
+  public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard class typedefs. */
+  typedef ExactEuclideanDistanceMapImageFilter            Self;
+  typedef ImageToImageFilter< TInputImage, TOutputImage > Superclass;
+  typedef SmartPointer< Self >                            Pointer;
+  typedef SmartPointer< const Self >                      ConstPointer;
+
+  typedef DataObject::Pointer DataObjectPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ExactEuclideanDistanceMapImageFilter, ImageToImageFilter);
+
+  /** The dimension of the input and output images. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TOutputImage::ImageDimension);
+
+  /** Image typedef support. */
+  typedef TInputImage                          InputImageType;
+  typedef typename InputImageType::PixelType   InputPixelType;
+  typedef TOutputImage                         OutputImageType;
+  typedef typename OutputImageType::PixelType  OutputPixelType;
+  typedef typename OutputImageType::RegionType OutputImageRegionType;
+  typedef typename OutputImageType::IndexType  IndexType;
+  typedef typename OutputImageType::SizeType   SizeType;
+
+  /** Type of the intermediate squared distances. */
+  typedef TDistance DistanceType;
+
+  /** Image of the intermediate squared distances. */
+  typedef Image< DistanceType, itkGetStaticConstMacro(ImageDimension) > DistanceImageType;
+
+  /** Image of the offsets of the nearest features. */
+  typedef Image< SizeValueType, itkGetStaticConstMacro(ImageDimension) > NearestFeatureImageType;
+
+  /** Set/Get the background value of the input. The pixels with other
+   * values are the features. Defaults to 0. */
+  itkSetMacro(BackgroundValue, InputPixelType);
+  itkGetConstReferenceMacro(BackgroundValue, InputPixelType);
+
+  /** Set/Get whether the output is the squared distance. Defaults to
+   * false. */
+  itkSetMacro(SquaredDistance, bool);
+  itkGetConstReferenceMacro(SquaredDistance, bool);
+  itkBooleanMacro(SquaredDistance);
+
+  /** Set/Get whether the distance is computed in physical units. When
+   * off, the distances are in pixels. Defaults to true. */
+  itkSetMacro(UseImageSpacing, bool);
+  itkGetConstReferenceMacro(UseImageSpacing, bool);
+  itkBooleanMacro(UseImageSpacing);
+
+  /** Set/Get whether the nearest feature image is computed. Defaults to
+   * false. */
+  itkSetMacro(ComputeNearestFeatureImage, bool);
+  itkGetConstReferenceMacro(ComputeNearestFeatureImage, bool);
+  itkBooleanMacro(ComputeNearestFeatureImage);
+
+  /** Get the distance map. */
+  OutputImageType * GetDistanceMap()
+  {
+    return this->GetOutput();
+  }
+
+  /** Get the offsets of the nearest features in the largest possible
+   * region of the input. Only allocated when ComputeNearestFeatureImage
+   * is on. */
+  NearestFeatureImageType * GetNearestFeatureImage();
+
+  /** Create the outputs. */
+  typedef ProcessObject::DataObjectPointerArraySizeType DataObjectPointerArraySizeType;
+  using Superclass::MakeOutput;
+  virtual DataObjectPointer MakeOutput(DataObjectPointerArraySizeType idx) ITK_OVERRIDE;
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  // Begin concept checking
+  itkConceptMacro( SameDimensionCheck,
+                   ( Concept::SameDimension< TInputImage::ImageDimension, TOutputImage::ImageDimension > ) );
+  itkConceptMacro( DistanceHasNumericTraitsCheck,
+                   ( Concept::HasNumericTraits< DistanceType > ) );
+  // End concept checking
+#endif
+
+protected:
+  ExactEuclideanDistanceMapImageFilter();
+  virtual ~ExactEuclideanDistanceMapImageFilter() {}
+
+  void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+  /** The distance to the features depends on the whole input. */
+  virtual void GenerateInputRequestedRegion() ITK_OVERRIDE;
+
+  virtual void GenerateData() ITK_OVERRIDE;
+
+private:
+  ITK_DISALLOW_COPY_AND_ASSIGN(ExactEuclideanDistanceMapImageFilter);
+
+  static ITK_THREAD_RETURN_TYPE PassThreaderCallback(void *arg);
+
+  /** Compute the 1D transform of the lines of the current pass in a
+   * piece of m_LineRegion. */
+  void ThreadedPass(const OutputImageRegionType & lineRegionForThread, ThreadIdType threadId);
+
+  InputPixelType m_BackgroundValue;
+  bool           m_SquaredDistance;
+  bool           m_UseImageSpacing;
+  bool           m_ComputeNearestFeatureImage;
+
+  /** State of the current pass. */
+  unsigned int                              m_CurrentPass;
+  unsigned int                              m_CurrentDimension;
+  OutputImageRegionType                     m_LineRegion;
+  unsigned int                              m_NumberOfPieces;
+  double                                    m_Weights[ImageDimension];
+  SizeValueType                             m_FeatureStrides[ImageDimension];
+  typename DistanceImageType::Pointer       m_Distance;
+  typename NearestFeatureImageType::Pointer m_NearestFeature;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkExactEuclideanDistanceMapImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,392 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkExactEuclideanDistanceMapImageFilter_hxx
+#define itkExactEuclideanDistanceMapImageFilter_hxx
+
+#include "itkExactEuclideanDistanceMapImageFilter.h"
+#include "itkImageRegionSplitterBase.h"
+#include "itkProgressReporter.h"
+#include "itkMath.h"
+#include <vector>
+
+namespace itk
+{
+template< typename TInputImage, typename TOutputImage, typename TDistance >
+ExactEuclideanDistanceMapImageFilter< TInputImage, TOutputImage, TDistance >
+::ExactEuclideanDistanceMapImageFilter() :
+  m_BackgroundValue( NumericTraits< InputPixelType >::ZeroValue() ),
+  m_SquaredDistance(false),
+  m_UseImageSpacing(true),
+  m_ComputeNearestFeatureImage(false),
+  m_CurrentPass(0),
+  m_CurrentDimension(0),
+  m_NumberOfPieces(0)
+{
+  this->SetNumberOfRequiredOutputs(2);
+  this->SetNthOutput( 1, this->MakeOutput(1) );
+
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    m_Weights[d] = 1.0;
+    m_FeatureStrides[d] = 0;
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TDistance >
+typename ExactEuclideanDistanceMapImageFilter< TInputImage, TOutputImage, TDistance >::DataObjectPointer
+ExactEuclideanDistanceMapImageFilter< TInputImage, TOutputImage, TDistance >
+::MakeOutput(DataObjectPointerArraySizeType idx)
+{
+  if ( idx == 1 )
+    {
+    return NearestFeatureImageType::New().GetPointer();
+    }
+  return Superclass::MakeOutput(idx);
+}
+
+template< typename TInputImage, typename TOutputImage, typename TDistance >
+typename ExactEuclideanDistanceMapImageFilter< TInputImage, TOutputImage, TDistance >::NearestFeatureImageType *
+ExactEuclideanDistanceMapImageFilter< TInputImage, TOutputImage, TDistance >
+::GetNearestFeatureImage()
+{
+  return dynamic_cast< NearestFeatureImageType * >( this->ProcessObject::GetOutput(1) );
+}
+
+template< typename TInputImage, typename TOutputImage, typename TDistance >
+void
+ExactEuclideanDistanceMapImageFilter< TInputImage, TOutputImage, TDistance >
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType *input = const_cast< InputImageType * >( this->GetInput() );
+  if ( input )
+    {
+    input->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TDistance >
+void
+ExactEuclideanDistanceMapImageFilter< TInputImage, TOutputImage, TDistance >
+::GenerateData()
+{
+  const InputImageType *input = this->GetInput();
+  OutputImageType *     output = this->GetOutput();
+
+  const OutputImageRegionType & largestRegion = input->GetLargestPossibleRegion();
+  const OutputImageRegionType & requestedRegion = output->GetRequestedRegion();
+
+  // The weight of each dimension in the squared distance
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    const double spacing = m_UseImageSpacing ? input->GetSpacing()[d] : 1.0;
+    m_Weights[d] = spacing * spacing;
+    if ( NumericTraits< DistanceType >::is_integer && m_Weights[d] != std::floor(m_Weights[d]) )
+      {
+      itkExceptionMacro(<< "The squared spacing " << m_Weights[d] << " along dimension " << d
+                        << " can not be represented by the integer distance type."
+                        << " Turn UseImageSpacing off or use a floating point distance type.");
+      }
+    }
+
+  // Offsets of the pixels in the largest possible region
+  SizeValueType stride = 1;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    m_FeatureStrides[d] = stride;
+    stride *= largestRegion.GetSize(d);
+    }
+
+  output->SetBufferedRegion(requestedRegion);
+  output->Allocate();
+
+  NearestFeatureImageType *nearestFeature = this->GetNearestFeatureImage();
+  nearestFeature->SetBufferedRegion( m_ComputeNearestFeatureImage ? requestedRegion : OutputImageRegionType() );
+  nearestFeature->Allocate();
+
+  // The dimensions are processed from the last one, so that the
+  // intermediate results are only needed in the slab of the requested
+  // region along the last dimension.
+  if ( ImageDimension > 1 )
+    {
+    OutputImageRegionType distanceRegion = largestRegion;
+    distanceRegion.SetIndex( ImageDimension - 1, requestedRegion.GetIndex(ImageDimension - 1) );
+    distanceRegion.SetSize( ImageDimension - 1, requestedRegion.GetSize(ImageDimension - 1) );
+
+    m_Distance = DistanceImageType::New();
+    m_Distance->CopyInformation(output);
+    m_Distance->SetRegions(distanceRegion);
+    m_Distance->Allocate();
+    if ( m_ComputeNearestFeatureImage )
+      {
+      m_NearestFeature = NearestFeatureImageType::New();
+      m_NearestFeature->CopyInformation(output);
+      m_NearestFeature->SetRegions(distanceRegion);
+      m_NearestFeature->Allocate();
+      }
+    }
+
+  MultiThreader *multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfThreads( this->GetNumberOfThreads() );
+  multiThreader->SetSingleMethod(this->PassThreaderCallback, this);
+  const ThreadIdType numberOfThreads = multiThreader->GetNumberOfThreads();
+
+  for ( m_CurrentPass = 0; m_CurrentPass < ImageDimension; ++m_CurrentPass )
+    {
+    m_CurrentDimension = ImageDimension - 1 - m_CurrentPass;
+
+    // The lines of the pass go through the whole image along the current
+    // dimension. Along the dimensions already processed, only the
+    // requested region is needed.
+    m_LineRegion = largestRegion;
+    m_LineRegion.SetSize(m_CurrentDimension, 1);
+    for ( unsigned int d = m_CurrentDimension + 1; d < ImageDimension; ++d )
+      {
+      m_LineRegion.SetIndex( d, requestedRegion.GetIndex(d) );
+      m_LineRegion.SetSize( d, requestedRegion.GetSize(d) );
+      }
+    m_NumberOfPieces = this->GetImageRegionSplitter()->GetNumberOfSplits(m_LineRegion, numberOfThreads);
+
+    multiThreader->SingleMethodExecute();
+    }
+
+  m_Distance = ITK_NULLPTR;
+  m_NearestFeature = ITK_NULLPTR;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TDistance >
+ITK_THREAD_RETURN_TYPE
+ExactEuclideanDistanceMapImageFilter< TInputImage, TOutputImage, TDistance >
+::PassThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self *filter = static_cast< Self * >( info->UserData );
+
+  const ThreadIdType threadId = info->ThreadID;
+  if ( threadId < filter->m_NumberOfPieces )
+    {
+    OutputImageRegionType lineRegionForThread = filter->m_LineRegion;
+    filter->GetImageRegionSplitter()->GetSplit(threadId, filter->m_NumberOfPieces, lineRegionForThread);
+    filter->ThreadedPass(lineRegionForThread, threadId);
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TDistance >
+void
+ExactEuclideanDistanceMapImageFilter< TInputImage, TOutputImage, TDistance >
+::ThreadedPass(const OutputImageRegionType & lineRegionForThread, ThreadIdType threadId)
+{
+  const InputImageType *input = this->GetInput();
+  OutputImageType *     output = this->GetOutput();
+  NearestFeatureImageType *nearestFeature = this->GetNearestFeatureImage();
+
+  const OutputImageRegionType & largestRegion = input->GetLargestPossibleRegion();
+  const OutputImageRegionType & requestedRegion = output->GetRequestedRegion();
+
+  const unsigned int dimension = m_CurrentDimension;
+  const bool firstPass = ( m_CurrentPass == 0 );
+  const bool lastPass = ( m_CurrentPass == ImageDimension - 1 );
+  const double weight = m_Weights[dimension];
+  const DistanceType infinity = NumericTraits< DistanceType >::max();
+
+  // The whole line is read, and the part in the requested region is written
+  const SizeValueType  length = largestRegion.GetSize(dimension);
+  const IndexValueType lineStart = largestRegion.GetIndex(dimension);
+  const IndexValueType outputBegin = requestedRegion.GetIndex(dimension) - lineStart;
+  const IndexValueType outputEnd = outputBegin + static_cast< IndexValueType >( requestedRegion.GetSize(dimension) );
+
+  std::vector< double >         values(length);
+  std::vector< SizeValueType >  features(length);
+  std::vector< IndexValueType > sites(length);
+  std::vector< double >         boundaries(length + 1);
+
+  ProgressReporter progress( this, threadId, lineRegionForThread.GetNumberOfPixels(), 100,
+                             static_cast< float >( m_CurrentPass ) / ImageDimension,
+                             1.0f / ImageDimension );
+
+  IndexType index = lineRegionForThread.GetIndex();
+  const SizeValueType numberOfLines = lineRegionForThread.GetNumberOfPixels();
+  for ( SizeValueType line = 0; line < numberOfLines; ++line )
+    {
+    // Read the line, the features of the first pass are the foreground
+    // pixels of the input
+    index[dimension] = lineStart;
+    if ( firstPass )
+      {
+      const InputPixelType *in = input->GetBufferPointer() + input->ComputeOffset(index);
+      const OffsetValueType inStride = input->GetOffsetTable()[dimension];
+      SizeValueType         feature = 0;
+      for ( unsigned int d = 0; d < ImageDimension; ++d )
+        {
+        feature += ( index[d] - largestRegion.GetIndex(d) ) * m_FeatureStrides[d];
+        }
+      for ( SizeValueType i = 0; i < length; ++i, in += inStride, feature += m_FeatureStrides[dimension] )
+        {
+        values[i] = ( *in != m_BackgroundValue ) ? 0.0 : -1.0;
+        features[i] = feature;
+        }
+      }
+    else
+      {
+      const OffsetValueType offset = m_Distance->ComputeOffset(index);
+      const OffsetValueType stride = m_Distance->GetOffsetTable()[dimension];
+      const DistanceType *  in = m_Distance->GetBufferPointer() + offset;
+      for ( SizeValueType i = 0; i < length; ++i, in += stride )
+        {
+        values[i] = ( *in == infinity ) ? -1.0 : static_cast< double >( *in );
+        }
+      if ( m_ComputeNearestFeatureImage )
+        {
+        const SizeValueType *featureIn = m_NearestFeature->GetBufferPointer() + offset;
+        for ( SizeValueType i = 0; i < length; ++i, featureIn += stride )
+          {
+          features[i] = *featureIn;
+          }
+        }
+      }
+
+    // Lower envelope of the parabolas rooted at the finite values.
+    // boundaries[k] is the position where the parabola of sites[k] starts
+    // to be the lowest.
+    IndexValueType numberOfSites = 0;
+    for ( IndexValueType q = 0; q < static_cast< IndexValueType >( length ); ++q )
+      {
+      if ( values[q] < 0.0 )
+        {
+        continue;
+        }
+      double boundary = NumericTraits< double >::NonpositiveMin();
+      while ( numberOfSites > 0 )
+        {
+        const IndexValueType p = sites[numberOfSites - 1];
+        boundary = ( ( values[q] + weight * q * q ) - ( values[p] + weight * p * p ) ) / ( 2.0 * weight * ( q - p ) );
+        if ( boundary > boundaries[numberOfSites - 1] )
+          {
+          break;
+          }
+        --numberOfSites;
+        boundary = NumericTraits< double >::NonpositiveMin();
+        }
+      sites[numberOfSites] = q;
+      boundaries[numberOfSites] = boundary;
+      ++numberOfSites;
+      }
+
+    // Write the distances to the lowest parabola
+    index[dimension] = lineStart + outputBegin;
+    IndexValueType k = 0;
+    if ( lastPass )
+      {
+      OutputPixelType *     out = output->GetBufferPointer() + output->ComputeOffset(index);
+      const OffsetValueType outStride = output->GetOffsetTable()[dimension];
+      SizeValueType *       featureOut = ITK_NULLPTR;
+      OffsetValueType       featureStride = 0;
+      if ( m_ComputeNearestFeatureImage )
+        {
+        featureOut = nearestFeature->GetBufferPointer() + nearestFeature->ComputeOffset(index);
+        featureStride = nearestFeature->GetOffsetTable()[dimension];
+        }
+      for ( IndexValueType x = outputBegin; x < outputEnd; ++x, out += outStride, featureOut += featureStride )
+        {
+        if ( numberOfSites == 0 )
+          {
+          *out = NumericTraits< OutputPixelType >::max();
+          if ( featureOut )
+            {
+            *featureOut = NumericTraits< SizeValueType >::max();
+            }
+          continue;
+          }
+        while ( k + 1 < numberOfSites && boundaries[k + 1] < x )
+          {
+          ++k;
+          }
+        const IndexValueType site = sites[k];
+        const double         distance = weight * ( x - site ) * ( x - site ) + values[site];
+        *out = static_cast< OutputPixelType >( m_SquaredDistance ? distance : std::sqrt(distance) );
+        if ( featureOut )
+          {
+          *featureOut = features[site];
+          }
+        }
+      }
+    else
+      {
+      const OffsetValueType offset = m_Distance->ComputeOffset(index);
+      const OffsetValueType stride = m_Distance->GetOffsetTable()[dimension];
+      DistanceType *        out = m_Distance->GetBufferPointer() + offset;
+      SizeValueType *       featureOut = m_ComputeNearestFeatureImage ? m_NearestFeature->GetBufferPointer() + offset
+                                                                      : ITK_NULLPTR;
+      for ( IndexValueType x = outputBegin; x < outputEnd; ++x, out += stride )
+        {
+        if ( numberOfSites == 0 )
+          {
+          *out = infinity;
+          continue;
+          }
+        while ( k + 1 < numberOfSites && boundaries[k + 1] < x )
+          {
+          ++k;
+          }
+        const IndexValueType site = sites[k];
+        *out = static_cast< DistanceType >( weight * ( x - site ) * ( x - site ) + values[site] );
+        if ( featureOut )
+          {
+          featureOut[( x - outputBegin ) * stride] = features[site];
+          }
+        }
+      }
+
+    progress.CompletedPixel();
+
+    // Next line
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      if ( d == dimension )
+        {
+        continue;
+        }
+      ++index[d];
+      if ( index[d] < lineRegionForThread.GetIndex(d) + static_cast< IndexValueType >( lineRegionForThread.GetSize(d) ) )
+        {
+        break;
+        }
+      index[d] = lineRegionForThread.GetIndex(d);
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TDistance >
+void
+ExactEuclideanDistanceMapImageFilter< TInputImage, TOutputImage, TDistance >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "BackgroundValue: "
+     << static_cast< typename NumericTraits< InputPixelType >::PrintType >( m_BackgroundValue ) << std::endl;
+  os << indent << "SquaredDistance: " << m_SquaredDistance << std::endl;
+  os << indent << "UseImageSpacing: " << m_UseImageSpacing << std::endl;
+  os << indent << "ComputeNearestFeatureImage: " << m_ComputeNearestFeatureImage << std::endl;
+}
+} // end namespace itk
+
+#endif
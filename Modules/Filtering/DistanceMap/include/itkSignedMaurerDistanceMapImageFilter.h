@@ -55,6 +55,9 @@ namespace itk
  *  Arbitrary Dimensions", IEEE - Transactions on Pattern Analysis and
  *  Machine Intelligence, 25(2): 265-270, 2003.
  *
+ * \sa ExactEuclideanDistanceMapImageFilter for the unsigned distance,
+ * which can be streamed.
+ *
  * \ingroup ImageFeatureExtraction
  * \ingroup ITKDistanceMap
  */
@@ -0,0 +1,214 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <iostream>
+#include "itkExactEuclideanDistanceMapImageFilter.h"
+#include "itkStreamingImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+// Compare the filter with a brute force search of the nearest feature,
+// on an image of sparse random features and a few lines of features.
+// The nearest features may differ when several features are at the same
+// distance, so they are checked through their distance.
+template< typename TImage, typename TDistance >
+int
+ExactEuclideanDistanceMapImageFilterTestCompare(const typename TImage::SizeType & size,
+                                                const typename TImage::SpacingType & spacing,
+                                                bool useImageSpacing,
+                                                itk::ThreadIdType numberOfThreads,
+                                                unsigned int numberOfStreamDivisions)
+{
+  typedef itk::Image< float, TImage::ImageDimension >                                    OutputImageType;
+  typedef itk::ExactEuclideanDistanceMapImageFilter< TImage, OutputImageType, TDistance > FilterType;
+  typedef typename FilterType::NearestFeatureImageType                                   NearestFeatureImageType;
+  typedef itk::StreamingImageFilter< OutputImageType, OutputImageType >                  DistanceStreamerType;
+  typedef itk::StreamingImageFilter< NearestFeatureImageType, NearestFeatureImageType >  FeatureStreamerType;
+
+  typename TImage::Pointer input = TImage::New();
+  typename TImage::IndexType start;
+  start.Fill(-3);
+  const typename TImage::RegionType region(start, size);
+  input->SetRegions(region);
+  input->SetSpacing(spacing);
+  input->Allocate();
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 3 );
+
+  for ( itk::ImageRegionIteratorWithIndex< TImage > it( input, region ); !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::IndexType & index = it.GetIndex();
+    const bool onLine = index[0] == 5 && index[TImage::ImageDimension - 1] % 3 == 0;
+    const bool feature = ( generator->GetIntegerVariate( 96 ) == 0 ) || onLine;
+    it.Set( feature ? 7 : 0 );
+    }
+
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(input);
+  filter->SetUseImageSpacing(useImageSpacing);
+  filter->SetComputeNearestFeatureImage(true);
+  filter->SetNumberOfThreads(numberOfThreads);
+
+  typename DistanceStreamerType::Pointer distanceStreamer = DistanceStreamerType::New();
+  distanceStreamer->SetInput( filter->GetOutput() );
+  distanceStreamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  TRY_EXPECT_NO_EXCEPTION( distanceStreamer->Update() );
+
+  typename FeatureStreamerType::Pointer featureStreamer = FeatureStreamerType::New();
+  featureStreamer->SetInput( filter->GetNearestFeatureImage() );
+  featureStreamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  TRY_EXPECT_NO_EXCEPTION( featureStreamer->Update() );
+
+  const OutputImageType *        distances = distanceStreamer->GetOutput();
+  const NearestFeatureImageType *features = featureStreamer->GetOutput();
+
+  std::vector< typename TImage::IndexType > featureIndices;
+  for ( itk::ImageRegionConstIteratorWithIndex< TImage > it( input, input->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != 0 )
+      {
+      featureIndices.push_back( it.GetIndex() );
+      }
+    }
+
+  for ( itk::ImageRegionConstIteratorWithIndex< OutputImageType > it( distances, distances->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::IndexType & index = it.GetIndex();
+    double expected = itk::NumericTraits< double >::max();
+    for ( size_t f = 0; f < featureIndices.size(); ++f )
+      {
+      double distance = 0.0;
+      for ( unsigned int d = 0; d < TImage::ImageDimension; ++d )
+        {
+        const double x = ( featureIndices[f][d] - index[d] ) * ( useImageSpacing ? spacing[d] : 1.0 );
+        distance += x * x;
+        }
+      expected = std::min(expected, distance);
+      }
+    expected = std::sqrt(expected);
+
+    const typename TImage::IndexType featureIndex = input->ComputeIndex( features->GetPixel(index) );
+    double featureDistance = 0.0;
+    for ( unsigned int d = 0; d < TImage::ImageDimension; ++d )
+      {
+      const double x = ( featureIndex[d] - index[d] ) * ( useImageSpacing ? spacing[d] : 1.0 );
+      featureDistance += x * x;
+      }
+    featureDistance = std::sqrt(featureDistance);
+
+    if ( itk::Math::abs( expected - it.Get() ) > 1e-4 || input->GetPixel(featureIndex) == 0
+         || itk::Math::abs( expected - featureDistance ) > 1e-4 )
+      {
+      std::cerr << "Test failed for size " << size << ", " << numberOfThreads << " threads and "
+                << numberOfStreamDivisions << " stream divisions at index " << index << ": expected "
+                << expected << ", got " << it.Get() << " with the nearest feature " << featureIndex << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int itkExactEuclideanDistanceMapImageFilterTest(int, char *[])
+{
+  typedef itk::Image< unsigned char, 2 >                                           ImageType;
+  typedef itk::Image< float, 2 >                                                   OutputImageType;
+  typedef itk::ExactEuclideanDistanceMapImageFilter< ImageType, OutputImageType >  FilterType;
+
+  FilterType::Pointer filter = FilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( filter, ExactEuclideanDistanceMapImageFilter, ImageToImageFilter );
+
+  TEST_SET_GET_BOOLEAN( filter, SquaredDistance, false );
+  TEST_SET_GET_BOOLEAN( filter, UseImageSpacing, true );
+  TEST_SET_GET_BOOLEAN( filter, ComputeNearestFeatureImage, false );
+  TEST_SET_GET_VALUE( 0, filter->GetBackgroundValue() );
+
+  int status = EXIT_SUCCESS;
+
+  ImageType::SizeType size2;
+  size2[0] = 43;
+  size2[1] = 37;
+  ImageType::SpacingType spacing2;
+  spacing2[0] = 0.7;
+  spacing2[1] = 1.3;
+  status |= ExactEuclideanDistanceMapImageFilterTestCompare< ImageType, float >(size2, spacing2, true, 1, 1);
+  status |= ExactEuclideanDistanceMapImageFilterTestCompare< ImageType, double >(size2, spacing2, true, 3, 4);
+  status |= ExactEuclideanDistanceMapImageFilterTestCompare< ImageType, int >(size2, spacing2, false, 2, 3);
+
+  typedef itk::Image< short, 3 > Image3DType;
+  Image3DType::SizeType size3;
+  size3[0] = 19;
+  size3[1] = 17;
+  size3[2] = 23;
+  Image3DType::SpacingType spacing3;
+  spacing3[0] = 1.0;
+  spacing3[1] = 2.0;
+  spacing3[2] = 3.0;
+  status |= ExactEuclideanDistanceMapImageFilterTestCompare< Image3DType, float >(size3, spacing3, true, 4, 5);
+  status |= ExactEuclideanDistanceMapImageFilterTestCompare< Image3DType, int >(size3, spacing3, true, 3, 1);
+
+  typedef itk::Image< unsigned char, 1 > Image1DType;
+  Image1DType::SizeType size1;
+  size1[0] = 101;
+  Image1DType::SpacingType spacing1;
+  spacing1[0] = 0.5;
+  status |= ExactEuclideanDistanceMapImageFilterTestCompare< Image1DType, float >(size1, spacing1, true, 2, 3);
+
+  // The squared distance, and an image without feature
+  ImageType::Pointer empty = ImageType::New();
+  empty->SetRegions(size2);
+  empty->Allocate();
+  empty->FillBuffer(0);
+  empty->SetPixel( ImageType::IndexType(), 1 );
+  filter->SetInput(empty);
+  filter->SetUseImageSpacing(false);
+  filter->SquaredDistanceOn();
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  ImageType::IndexType corner;
+  corner[0] = 42;
+  corner[1] = 36;
+  TEST_EXPECT_EQUAL( filter->GetOutput()->GetPixel(corner), 42.0f * 42.0f + 36.0f * 36.0f );
+
+  empty->FillBuffer(0);
+  empty->Modified();
+  filter->ComputeNearestFeatureImageOn();
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  TEST_EXPECT_EQUAL( filter->GetOutput()->GetPixel(corner), itk::NumericTraits< float >::max() );
+  TEST_EXPECT_EQUAL( filter->GetNearestFeatureImage()->GetPixel(corner), itk::NumericTraits< itk::SizeValueType >::max() );
+
+  // An integer distance type requires an integral squared spacing
+  typedef itk::ExactEuclideanDistanceMapImageFilter< ImageType, OutputImageType, int > IntegerFilterType;
+  IntegerFilterType::Pointer integerFilter = IntegerFilterType::New();
+  empty->SetSpacing(spacing2);
+  integerFilter->SetInput(empty);
+  TRY_EXPECT_EXCEPTION( integerFilter->Update() );
+  integerFilter->UseImageSpacingOff();
+  TRY_EXPECT_NO_EXCEPTION( integerFilter->Update() );
+
+  if ( status == EXIT_SUCCESS )
+    {
+    std::cout << "Test passed." << std::endl;
+    }
+  return status;
+}
@@ -26,7 +26,10 @@ namespace itk
  *
  * \brief VNL based complex to complex Fast Fourier Transform.
  *
- * This filter requires input images with sizes which are a power of two.
+ * The lines of each dimension are transformed in parallel. The sizes
+ * whose prime factorization consists of 2s, 3s, and 5s are the fastest.
+ * The other sizes are supported through Bluestein's algorithm, which is
+ * several times slower.
  *
  * \ingroup FourierTransform
  * \ingroup ITKFFT
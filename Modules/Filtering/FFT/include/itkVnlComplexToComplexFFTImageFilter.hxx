@@ -46,33 +46,14 @@ VnlComplexToComplexFFTImageFilter< TImage >
   const typename ImageType::RegionType bufferedRegion = input->GetBufferedRegion();
   const typename ImageType::SizeType & imageSize = bufferedRegion.GetSize();
 
-  for( unsigned int ii = 0; ii < ImageDimension; ++ii )
-    {
-    if ( !VnlFFTCommon::IsDimensionSizeLegal( imageSize[ii] ) )
-      {
-      itkExceptionMacro(<< "Cannot compute FFT of image with size "
-                        << imageSize << ". VnlComplexToComplexFFTImageFilter operates "
-                        << "only on images whose size in each dimension is a multiple of "
-                        << "2, 3, or 5." );
-      }
-    }
-
   // Copy the input to the output, and we will work in place on the output.
   ImageAlgorithm::Copy< ImageType, ImageType >( input, output, bufferedRegion, bufferedRegion );
 
   typedef std::complex< typename PixelType::value_type > VclPixelType;
   VclPixelType * outputBuffer = static_cast< VclPixelType * >( output->GetBufferPointer() );
 
-  // call the proper transform, based on compile type template parameter
-  VnlFFTCommon::VnlFFTTransform< Image< typename PixelType::value_type , ImageDimension > > vnlfft( imageSize );
-  if ( this->GetTransformDirection() == Superclass::INVERSE )
-    {
-    vnlfft.transform( outputBuffer, 1 );
-    }
-  else
-    {
-    vnlfft.transform( outputBuffer, -1 );
-    }
+  const int direction = ( this->GetTransformDirection() == Superclass::INVERSE ) ? 1 : -1;
+  VnlFFTCommon::Transform( outputBuffer, imageSize, direction, this->GetNumberOfThreads() );
 }
 
 
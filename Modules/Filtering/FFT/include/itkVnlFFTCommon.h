@@ -19,8 +19,18 @@
 #define itkVnlFFTCommon_h
 
 #include "itkIntTypes.h"
+#include "itkLightObject.h"
+#include "itkMultiThreader.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkSize.h"
 
+#include "vnl/algo/vnl_fft.h"
 #include "vnl/algo/vnl_fft_base.h"
+#include "vnl/algo/vnl_fft_prime_factors.h"
+
+#include <complex>
+#include <map>
+#include <vector>
 
 namespace itk
 {
@@ -34,7 +44,10 @@ struct VnlFFTCommon
 {
 
   /** Vnl's FFT supports discrete Fourier transforms for images whose
-  sizes have a prime factorization consisting of 2's, 3's, and 5's. */
+  sizes have a prime factorization consisting of 2's, 3's, and 5's.
+  Transform() also supports the other sizes, through Bluestein's
+  algorithm, but they are several times slower, so this still tells
+  whether a size can be transformed efficiently. */
   template< typename TSizeValue >
   static bool IsDimensionSizeLegal(TSizeValue n);
 
@@ -52,6 +65,104 @@ struct VnlFFTCommon
     VnlFFTTransform(const typename TImage::SizeType & s);
   };
 
+  /** \class VnlFFTLinePlan
+   * \brief Precomputed data to transform lines of a given size.
+   *
+   * For sizes whose prime factors are 2, 3 and 5, the plan holds the
+   * twiddle factors of vnl's FFT. For the other sizes, the transform is
+   * computed with Bluestein's algorithm, as a circular convolution with a
+   * chirp of a size whose prime factors are 2, 3 and 5, and the plan holds
+   * the chirp and the transform of the convolution kernel.
+   *
+   * The plans are built once per size and shared: use GetPlan() to get
+   * one. A plan is not modified after its construction, so it can be used
+   * by several threads at once.
+   *
+   * \ingroup ITKFFT
+   */
+  template< typename TValue >
+  class VnlFFTLinePlan: public LightObject
+  {
+  public:
+    typedef VnlFFTLinePlan             Self;
+    typedef LightObject                Superclass;
+    typedef SmartPointer< Self >       Pointer;
+    typedef SmartPointer< const Self > ConstPointer;
+    typedef std::complex< TValue >     ComplexType;
+
+    itkTypeMacro(VnlFFTLinePlan, LightObject);
+
+    /** Get the plan for lines of n values. The plans of the last
+     * MaximumNumberOfCachedPlans sizes are kept. */
+    static ConstPointer GetPlan(SizeValueType n);
+
+    static ITK_CONSTEXPR_VAR unsigned int MaximumNumberOfCachedPlans = 32;
+
+    /** Number of values of the lines. */
+    SizeValueType GetSize() const { return m_Size; }
+
+    /** Number of values of the work area required by Transform(). */
+    SizeValueType GetWorkSize() const { return m_ConvolutionSize; }
+
+    /** Transform in place lot lines of GetSize() values. The k-th value of
+     * the l-th line is data[l * jump + k * increment]. The direction is -1
+     * for the forward transform and +1 for the inverse transform, which is
+     * not normalized. */
+    void Transform(ComplexType * data, SizeValueType increment, SizeValueType jump,
+                   SizeValueType lot, int direction, ComplexType * work) const;
+
+  protected:
+    VnlFFTLinePlan(SizeValueType n);
+    virtual ~VnlFFTLinePlan() {}
+
+  private:
+    ITK_DISALLOW_COPY_AND_ASSIGN(VnlFFTLinePlan);
+
+    /** Call vnl's FFT on lines whose size has only small prime factors. */
+    void TransformWithFactors(ComplexType * data, SizeValueType increment, SizeValueType jump,
+                              SizeValueType lot, int direction) const;
+
+    SizeValueType                   m_Size;
+    SizeValueType                   m_ConvolutionSize;
+    vnl_fft_prime_factors< TValue > m_Factors;
+    std::vector< ComplexType >      m_Chirp;
+    std::vector< ComplexType >      m_ForwardKernel;
+    std::vector< ComplexType >      m_InverseKernel;
+
+    typedef std::map< SizeValueType, ConstPointer > CacheType;
+    static SimpleFastMutexLock m_CacheLock;
+    static CacheType           m_Cache;
+  };
+
+  /** Compute in place the discrete Fourier transform of an image buffer
+   * of the given size, the first dimension varying fastest. The direction
+   * is -1 for the forward transform and +1 for the inverse transform,
+   * which is not normalized. The lines of each dimension are split over
+   * numberOfThreads threads, and each thread transforms its lines in
+   * batches, which vnl's FFT vectorizes. */
+  template< typename TValue, unsigned int VDimension >
+  static void Transform(std::complex< TValue > * signal, const Size< VDimension > & size,
+                        int direction, ThreadIdType numberOfThreads);
+
+private:
+  template< typename TValue >
+  struct TransformLinesThreadStruct
+  {
+    std::complex< TValue > *                        Signal;
+    typename VnlFFTLinePlan< TValue >::ConstPointer Plan;
+    SizeValueType                                   Stride;
+    SizeValueType                                   NumberOfLines;
+    int                                             Direction;
+  };
+
+  /** Transform the lines of the given range along one dimension. */
+  template< typename TValue >
+  static void TransformLines(const TransformLinesThreadStruct< TValue > & str,
+                             SizeValueType firstLine, SizeValueType endLine);
+
+  template< typename TValue >
+  static ITK_THREAD_RETURN_TYPE TransformLinesThreaderCallback(void *arg);
+
 };
 } // namespace itk
 
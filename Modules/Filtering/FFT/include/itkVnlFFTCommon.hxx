@@ -19,6 +19,9 @@
 #define itkVnlFFTCommon_hxx
 
 #include "itkVnlFFTCommon.h"
+#include "itkMath.h"
+#include "itkMutexLockHolder.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -51,6 +54,245 @@ VnlFFTCommon::VnlFFTTransform< TImage >
     }
 }
 
+
+template< typename TValue >
+SimpleFastMutexLock VnlFFTCommon::VnlFFTLinePlan< TValue >::m_CacheLock;
+
+template< typename TValue >
+typename VnlFFTCommon::VnlFFTLinePlan< TValue >::CacheType VnlFFTCommon::VnlFFTLinePlan< TValue >::m_Cache;
+
+template< typename TValue >
+typename VnlFFTCommon::VnlFFTLinePlan< TValue >::ConstPointer
+VnlFFTCommon::VnlFFTLinePlan< TValue >
+::GetPlan(SizeValueType n)
+{
+  MutexLockHolder< SimpleFastMutexLock > lockHolder(m_CacheLock);
+
+  typename CacheType::const_iterator it = m_Cache.find(n);
+  if ( it != m_Cache.end() )
+    {
+    return it->second;
+    }
+  if ( m_Cache.size() >= MaximumNumberOfCachedPlans )
+    {
+    // The plans in use are kept alive by their users
+    m_Cache.clear();
+    }
+  Pointer plan = new Self(n);
+  plan->UnRegister();
+  m_Cache[n] = plan.GetPointer();
+  return plan.GetPointer();
+}
+
+template< typename TValue >
+VnlFFTCommon::VnlFFTLinePlan< TValue >
+::VnlFFTLinePlan(SizeValueType n):
+  m_Size(n),
+  m_ConvolutionSize(0)
+{
+  if ( IsDimensionSizeLegal(n) )
+    {
+    m_Factors.resize(n);
+    return;
+    }
+
+  // Bluestein's algorithm: with w_k = exp(-i pi k^2 / n), the transform is
+  // X_k = w_k sum_j (x_j w_j) conj(w_{k-j}), a convolution computed with
+  // transforms of a fast size large enough to avoid aliasing.
+  m_ConvolutionSize = 2 * n - 1;
+  while ( !IsDimensionSizeLegal(m_ConvolutionSize) )
+    {
+    ++m_ConvolutionSize;
+    }
+  m_Factors.resize(m_ConvolutionSize);
+
+  m_Chirp.resize(n);
+  for ( SizeValueType k = 0; k < n; ++k )
+    {
+    // k^2 modulo 2n keeps the angle accurate for large sizes
+    const SizeValueType r = static_cast< SizeValueType >(
+      ( static_cast< unsigned long long >( k ) * k ) % ( 2 * static_cast< unsigned long long >( n ) ) );
+    const double angle = -itk::Math::pi * static_cast< double >( r ) / static_cast< double >( n );
+    m_Chirp[k] = ComplexType( static_cast< TValue >( std::cos(angle) ), static_cast< TValue >( std::sin(angle) ) );
+    }
+
+  // The kernels are the transforms of conj(w) for the forward transform
+  // and of w for the inverse one, wrapped around, and include the
+  // normalization of the inverse transform of the convolution.
+  const TValue scale = static_cast< TValue >( 1.0 / m_ConvolutionSize );
+  m_ForwardKernel.assign(m_ConvolutionSize, ComplexType(0));
+  m_InverseKernel.assign(m_ConvolutionSize, ComplexType(0));
+  for ( SizeValueType k = 0; k < n; ++k )
+    {
+    m_ForwardKernel[k] = std::conj(m_Chirp[k]) * scale;
+    m_InverseKernel[k] = m_Chirp[k] * scale;
+    if ( k > 0 )
+      {
+      m_ForwardKernel[m_ConvolutionSize - k] = m_ForwardKernel[k];
+      m_InverseKernel[m_ConvolutionSize - k] = m_InverseKernel[k];
+      }
+    }
+  this->TransformWithFactors(&m_ForwardKernel[0], 1, m_ConvolutionSize, 1, -1);
+  this->TransformWithFactors(&m_InverseKernel[0], 1, m_ConvolutionSize, 1, -1);
+}
+
+template< typename TValue >
+void
+VnlFFTCommon::VnlFFTLinePlan< TValue >
+::TransformWithFactors(ComplexType * data, SizeValueType increment, SizeValueType jump,
+                       SizeValueType lot, int direction) const
+{
+  TValue *  real = reinterpret_cast< TValue * >( data );
+  long      info = 0;
+  vnl_fft_gpfa(real, real + 1, m_Factors.trigs(),
+               2 * static_cast< long >( increment ), 2 * static_cast< long >( jump ),
+               m_Factors.number(), static_cast< long >( lot ), direction, m_Factors.pqr(), &info);
+  if ( info == -1 )
+    {
+    itkGenericExceptionMacro("Error calling vnl_fft_gpfa");
+    }
+}
+
+template< typename TValue >
+void
+VnlFFTCommon::VnlFFTLinePlan< TValue >
+::Transform(ComplexType * data, SizeValueType increment, SizeValueType jump,
+            SizeValueType lot, int direction, ComplexType * work) const
+{
+  if ( m_ConvolutionSize == 0 )
+    {
+    this->TransformWithFactors(data, increment, jump, lot, direction);
+    return;
+    }
+
+  const ComplexType * kernel = ( direction < 0 ) ? &m_ForwardKernel[0] : &m_InverseKernel[0];
+  for ( SizeValueType l = 0; l < lot; ++l )
+    {
+    ComplexType * line = data + l * jump;
+    for ( SizeValueType k = 0; k < m_Size; ++k )
+      {
+      const ComplexType w = ( direction < 0 ) ? m_Chirp[k] : std::conj(m_Chirp[k]);
+      work[k] = line[k * increment] * w;
+      }
+    std::fill(work + m_Size, work + m_ConvolutionSize, ComplexType(0));
+
+    this->TransformWithFactors(work, 1, m_ConvolutionSize, 1, -1);
+    for ( SizeValueType k = 0; k < m_ConvolutionSize; ++k )
+      {
+      work[k] *= kernel[k];
+      }
+    this->TransformWithFactors(work, 1, m_ConvolutionSize, 1, 1);
+
+    for ( SizeValueType k = 0; k < m_Size; ++k )
+      {
+      const ComplexType w = ( direction < 0 ) ? m_Chirp[k] : std::conj(m_Chirp[k]);
+      line[k * increment] = work[k] * w;
+      }
+    }
+}
+
+template< typename TValue, unsigned int VDimension >
+void
+VnlFFTCommon
+::Transform(std::complex< TValue > * signal, const Size< VDimension > & size,
+            int direction, ThreadIdType numberOfThreads)
+{
+  SizeValueType stride = 1;
+  SizeValueType totalSize = 1;
+  for ( unsigned int d = 0; d < VDimension; ++d )
+    {
+    totalSize *= size[d];
+    }
+
+  for ( unsigned int d = 0; d < VDimension; stride *= size[d], ++d )
+    {
+    if ( size[d] <= 1 )
+      {
+      continue;
+      }
+
+    TransformLinesThreadStruct< TValue > str;
+    str.Signal = signal;
+    str.Plan = VnlFFTLinePlan< TValue >::GetPlan(size[d]);
+    str.Stride = stride;
+    str.NumberOfLines = totalSize / size[d];
+    str.Direction = direction;
+
+    // Small transforms are not worth starting threads
+    const SizeValueType minimumValuesPerThread = 4096;
+    ThreadIdType threads = numberOfThreads;
+    if ( static_cast< SizeValueType >( threads ) > totalSize / minimumValuesPerThread )
+      {
+      threads = static_cast< ThreadIdType >( totalSize / minimumValuesPerThread );
+      }
+    if ( threads <= 1 )
+      {
+      TransformLines(str, 0, str.NumberOfLines);
+      }
+    else
+      {
+      MultiThreader::Pointer threader = MultiThreader::New();
+      threader->SetNumberOfThreads(threads);
+      threader->SetSingleMethod(TransformLinesThreaderCallback< TValue >, &str);
+      threader->SingleMethodExecute();
+      }
+    }
+}
+
+template< typename TValue >
+void
+VnlFFTCommon
+::TransformLines(const TransformLinesThreadStruct< TValue > & str,
+                 SizeValueType firstLine, SizeValueType endLine)
+{
+  const SizeValueType n = str.Plan->GetSize();
+  const SizeValueType stride = str.Stride;
+
+  std::vector< std::complex< TValue > > work( str.Plan->GetWorkSize() );
+  std::complex< TValue > * workPointer = work.empty() ? ITK_NULLPTR : &work[0];
+
+  if ( stride == 1 )
+    {
+    // Lines along the first dimension are contiguous and consecutive
+    str.Plan->Transform(str.Signal + firstLine * n, 1, n, endLine - firstLine,
+                        str.Direction, workPointer);
+    return;
+    }
+
+  // Along the other dimensions, the lines starting in the same slab
+  // (stride consecutive values) are transformed together
+  SizeValueType line = firstLine;
+  while ( line < endLine )
+    {
+    const SizeValueType slab = line / stride;
+    const SizeValueType offset = line % stride;
+    const SizeValueType lot = std::min( endLine - line, stride - offset );
+    str.Plan->Transform(str.Signal + slab * n * stride + offset, stride, 1, lot,
+                        str.Direction, workPointer);
+    line += lot;
+    }
+}
+
+template< typename TValue >
+ITK_THREAD_RETURN_TYPE
+VnlFFTCommon
+::TransformLinesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct * info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  const TransformLinesThreadStruct< TValue > & str =
+    *static_cast< TransformLinesThreadStruct< TValue > * >( info->UserData );
+
+  const SizeValueType threadId = info->ThreadID;
+  const SizeValueType numberOfThreads = info->NumberOfThreads;
+  const SizeValueType firstLine = str.NumberOfLines * threadId / numberOfThreads;
+  const SizeValueType endLine = str.NumberOfLines * ( threadId + 1 ) / numberOfThreads;
+  if ( firstLine < endLine )
+    {
+    TransformLines(str, firstLine, endLine);
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 } // end namespace itk
 
 #endif // itkVnlFFTCommon_hxx
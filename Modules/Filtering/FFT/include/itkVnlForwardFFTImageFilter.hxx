@@ -50,39 +50,22 @@ VnlForwardFFTImageFilter< TInputImage, TOutputImage >
   outputPtr->SetBufferedRegion( outputPtr->GetRequestedRegion() );
   outputPtr->Allocate();
 
-  unsigned int vectorSize = 1;
+  SizeValueType vectorSize = 1;
   for ( unsigned int i = 0; i < ImageDimension; i++ )
     {
-    if ( !VnlFFTCommon::IsDimensionSizeLegal( inputSize[i] ) )
-      {
-      itkExceptionMacro(<< "Cannot compute FFT of image with size "
-                        << inputSize << ". VnlForwardFFTImageFilter operates "
-                        << "only on images whose size in each dimension is a multiple of "
-                        << "2, 3, or 5." );
-      }
     vectorSize *= inputSize[i];
     }
 
+  // The output holds the whole image, so the transform is computed in
+  // place in the output buffer.
   const InputPixelType *in = inputPtr->GetBufferPointer();
-  SignalVectorType signal( vectorSize );
-  for ( unsigned int i = 0; i < vectorSize; i++ )
+  OutputPixelType *out = outputPtr->GetBufferPointer();
+  for ( SizeValueType i = 0; i < vectorSize; i++ )
     {
-    signal[i] = in[i];
+    out[i] = in[i];
     }
 
-  // call the proper transform, based on compile type template parameter
-  VnlFFTCommon::VnlFFTTransform< InputImageType > vnlfft( inputSize );
-  vnlfft.transform( signal.data_block(), -1 );
-
-  // Copy the VNL output back to the ITK image.
-  ImageRegionIteratorWithIndex< TOutputImage > oIt( outputPtr,
-                                                    outputPtr->GetLargestPossibleRegion() );
-  for (oIt.GoToBegin(); !oIt.IsAtEnd(); ++oIt)
-    {
-    typename OutputImageType::IndexType index = oIt.GetIndex();
-    typename OutputImageType::OffsetValueType offset = inputPtr->ComputeOffset( index );
-    oIt.Set( signal[offset] );
-    }
+  VnlFFTCommon::Transform( out, inputSize, -1, this->GetNumberOfThreads() );
 }
 
 template< typename TInputImage, typename TOutputImage >
@@ -53,16 +53,9 @@ VnlHalfHermitianToRealInverseFFTImageFilter< TInputImage, TOutputImage >
   outputPtr->SetBufferedRegion( outputPtr->GetRequestedRegion() );
   outputPtr->Allocate();
 
-  unsigned int vectorSize = 1;
+  SizeValueType vectorSize = 1;
   for ( unsigned int i = 0; i < ImageDimension; i++ )
     {
-    if ( !VnlFFTCommon::IsDimensionSizeLegal( outputSize[i] ) )
-      {
-      itkExceptionMacro(<< "Cannot compute FFT of image with size "
-                        << outputSize << ". VnlHalfHermitianToRealInverseFFTImageFilter operates "
-                        << "only on images whose size in each dimension is a multiple of "
-                        << "2, 3, or 5." );
-      }
     vectorSize *= outputSize[i];
     }
 
@@ -99,16 +92,14 @@ VnlHalfHermitianToRealInverseFFTImageFilter< TInputImage, TOutputImage >
 
   OutputPixelType *out = outputPtr->GetBufferPointer();
 
-  // call the proper transform, based on compile type template parameter
-  VnlFFTCommon::VnlFFTTransform< OutputImageType > vnlfft( outputSize );
-  vnlfft.transform( signal.data_block(), 1 );
+  VnlFFTCommon::Transform( signal.data_block(), outputSize, 1, this->GetNumberOfThreads() );
 
   // Copy the VNL output back to the ITK image. Extract the real part
   // of the signal. Ideally, the normalization by the number of
   // elements should have been accounted for by the VNL inverse
   // Fourier transform, but it is not. So, we take care of it by
   // dividing the signal by the vectorSize.
-  for ( unsigned int i = 0; i < vectorSize; i++ )
+  for ( SizeValueType i = 0; i < vectorSize; i++ )
     {
     out[i] = signal[i].real() / vectorSize;
     }
@@ -29,8 +29,10 @@ namespace itk
  *
  * \brief VNL-based reverse Fast Fourier Transform.
  *
- * The input image size must be a multiple of combinations of 2s, 3s,
- * and/or 5s in all dimensions.
+ * The lines of each dimension are transformed in parallel. The sizes
+ * whose prime factorization consists of 2s, 3s, and 5s are the fastest.
+ * The other sizes are supported through Bluestein's algorithm, which is
+ * several times slower.
  *
  * \ingroup FourierTransform
  *
@@ -28,8 +28,10 @@ namespace itk
  *
  * \brief VNL-based forward Fast Fourier Transform.
  *
- * The input image size in all dimensions must have a prime
- * factorization consisting of 2s, 3s, and 5s.
+ * The lines of each dimension are transformed in parallel. The sizes
+ * whose prime factorization consists of 2s, 3s, and 5s are the fastest.
+ * The other sizes are supported through Bluestein's algorithm, which is
+ * several times slower.
  *
  * \ingroup FourierTransform
  *
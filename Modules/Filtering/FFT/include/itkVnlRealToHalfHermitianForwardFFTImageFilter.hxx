@@ -49,29 +49,20 @@ VnlRealToHalfHermitianForwardFFTImageFilter< TInputImage, TOutputImage >
   outputPtr->SetBufferedRegion( outputPtr->GetRequestedRegion() );
   outputPtr->Allocate();
 
-  unsigned int vectorSize = 1;
+  SizeValueType vectorSize = 1;
   for ( unsigned int i = 0; i < ImageDimension; i++ )
     {
-    if ( !VnlFFTCommon::IsDimensionSizeLegal( inputSize[i] ) )
-      {
-      itkExceptionMacro(<< "Cannot compute FFT of image with size "
-                        << inputSize << ". VnlRealToHalfHermitianForwardFFTImageFilter operates "
-                        << "only on images whose size in each dimension has a prime "
-                        << "factorization consisting of only 2s, 3s, or 5s." );
-      }
     vectorSize *= inputSize[i];
     }
 
   const InputPixelType *in = inputPtr->GetBufferPointer();
   SignalVectorType signal( vectorSize );
-  for ( unsigned int i = 0; i < vectorSize; i++ )
+  for ( SizeValueType i = 0; i < vectorSize; i++ )
     {
     signal[i] = in[i];
     }
 
-  // call the proper transform, based on compile type template parameter
-  VnlFFTCommon::VnlFFTTransform< InputImageType > vnlfft( inputSize );
-  vnlfft.transform( signal.data_block(), -1 );
+  VnlFFTCommon::Transform( signal.data_block(), inputSize, -1, this->GetNumberOfThreads() );
 
   // Copy the VNL output back to the ITK image.
   ImageRegionIteratorWithIndex< TOutputImage > oIt( outputPtr,
@@ -0,0 +1,176 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkVnlFFTCommon.h"
+#include "itkVnlForwardFFTImageFilter.h"
+#include "itkVnlInverseFFTImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkRandomImageSource.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+// Compare VnlFFTCommon::Transform with a direct evaluation of the
+// discrete Fourier transform.
+template< unsigned int VDimension >
+int
+VnlFFTCommonTestCompareWithDFT(const itk::Size< VDimension > & size, int direction,
+                               itk::ThreadIdType numberOfThreads)
+{
+  typedef std::complex< double > ComplexType;
+
+  itk::SizeValueType numberOfValues = 1;
+  for ( unsigned int d = 0; d < VDimension; ++d )
+    {
+    numberOfValues *= size[d];
+    }
+
+  std::vector< ComplexType > signal( numberOfValues );
+  for ( itk::SizeValueType i = 0; i < numberOfValues; ++i )
+    {
+    signal[i] = ComplexType( std::sin( 1.3 * i ), std::cos( 0.7 * i + 1.0 ) );
+    }
+  std::vector< ComplexType > transformed = signal;
+  itk::VnlFFTCommon::Transform( &transformed[0], size, direction, numberOfThreads );
+
+  double maximumError = 0.0;
+  for ( itk::SizeValueType k = 0; k < numberOfValues; ++k )
+    {
+    ComplexType expected( 0.0 );
+    for ( itk::SizeValueType j = 0; j < numberOfValues; ++j )
+      {
+      double phase = 0.0;
+      itk::SizeValueType kk = k;
+      itk::SizeValueType jj = j;
+      for ( unsigned int d = 0; d < VDimension; ++d )
+        {
+        phase += static_cast< double >( ( ( kk % size[d] ) * ( jj % size[d] ) ) % size[d] ) / size[d];
+        kk /= size[d];
+        jj /= size[d];
+        }
+      const double angle = direction * 2.0 * itk::Math::pi * phase;
+      expected += signal[j] * ComplexType( std::cos( angle ), std::sin( angle ) );
+      }
+    maximumError = std::max( maximumError, std::abs( expected - transformed[k] ) );
+    }
+
+  if ( maximumError > 1e-10 * numberOfValues )
+    {
+    std::cerr << "Test failed for size " << size << ", direction " << direction << " and "
+              << numberOfThreads << " threads: maximum error " << maximumError << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int itkVnlFFTCommonTest(int, char *[])
+{
+  int status = EXIT_SUCCESS;
+
+  // Sizes with prime factors 2, 3 and 5 and other sizes, transformed with
+  // Bluestein's algorithm.
+  const itk::SizeValueType sizes[] = { 1, 2, 7, 12, 13, 30, 97 };
+  const unsigned int numberOfSizes = sizeof( sizes ) / sizeof( sizes[0] );
+  for ( unsigned int i = 0; i < numberOfSizes; ++i )
+    {
+    TEST_EXPECT_EQUAL( itk::VnlFFTCommon::VnlFFTLinePlan< double >::GetPlan( sizes[i] )->GetSize(), sizes[i] );
+
+    itk::Size< 1 > size1;
+    size1[0] = sizes[i];
+    status |= VnlFFTCommonTestCompareWithDFT< 1 >( size1, -1, 1 );
+    status |= VnlFFTCommonTestCompareWithDFT< 1 >( size1, 1, 1 );
+
+    itk::Size< 3 > size3;
+    size3[0] = sizes[i];
+    size3[1] = 3;
+    size3[2] = sizes[numberOfSizes - 1 - i] % 11 + 1;
+    status |= VnlFFTCommonTestCompareWithDFT< 3 >( size3, -1, 2 );
+    status |= VnlFFTCommonTestCompareWithDFT< 3 >( size3, 1, 2 );
+    }
+
+  // The plans are shared
+  TEST_EXPECT_TRUE( itk::VnlFFTCommon::VnlFFTLinePlan< float >::GetPlan( 13 )
+                    == itk::VnlFFTCommon::VnlFFTLinePlan< float >::GetPlan( 13 ) );
+
+  // Large enough images are transformed by several threads, and the result
+  // must not depend on the number of threads.
+  typedef itk::Image< float, 3 >                                 ImageType;
+  typedef itk::VnlForwardFFTImageFilter< ImageType >             ForwardFilterType;
+  typedef ForwardFilterType::OutputImageType                     ComplexImageType;
+  typedef itk::VnlInverseFFTImageFilter< ComplexImageType >      InverseFilterType;
+
+  typedef itk::RandomImageSource< ImageType >                    SourceType;
+
+  SourceType::Pointer source = SourceType::New();
+  ImageType::SizeValueType size[3] = { 67, 40, 9 };
+  source->SetSize( size );
+  source->SetMin( 0.0 );
+  source->SetMax( 10.0 );
+  TRY_EXPECT_NO_EXCEPTION( source->Update() );
+  ImageType::Pointer image = source->GetOutput();
+
+  ComplexImageType::Pointer transforms[2];
+  const itk::ThreadIdType numberOfThreads[2] = { 1, 4 };
+  for ( unsigned int t = 0; t < 2; ++t )
+    {
+    ForwardFilterType::Pointer forward = ForwardFilterType::New();
+    forward->SetInput( image );
+    forward->SetNumberOfThreads( numberOfThreads[t] );
+    TRY_EXPECT_NO_EXCEPTION( forward->Update() );
+    transforms[t] = forward->GetOutput();
+    }
+
+  InverseFilterType::Pointer inverse = InverseFilterType::New();
+  inverse->SetInput( transforms[1] );
+  inverse->SetNumberOfThreads( 4 );
+  TRY_EXPECT_NO_EXCEPTION( inverse->Update() );
+
+  itk::ImageRegionConstIterator< ComplexImageType > it0( transforms[0], transforms[0]->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< ComplexImageType > it1( transforms[1], transforms[1]->GetLargestPossibleRegion() );
+  for (; !it0.IsAtEnd(); ++it0, ++it1 )
+    {
+    if ( it0.Get() != it1.Get() )
+      {
+      std::cerr << "Test failed: the transform depends on the number of threads at index "
+                << it0.GetIndex() << ": " << it0.Get() << " != " << it1.Get() << std::endl;
+      status = EXIT_FAILURE;
+      break;
+      }
+    }
+
+  itk::ImageRegionConstIterator< ImageType > inputIt( image, image->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< ImageType > outputIt( inverse->GetOutput(), image->GetLargestPossibleRegion() );
+  for (; !inputIt.IsAtEnd(); ++inputIt, ++outputIt )
+    {
+    if ( itk::Math::abs( inputIt.Get() - outputIt.Get() ) > 1e-3 )
+      {
+      std::cerr << "Test failed: the inverse transform differs from the input at index "
+                << inputIt.GetIndex() << ": " << inputIt.Get() << " != " << outputIt.Get() << std::endl;
+      status = EXIT_FAILURE;
+      break;
+      }
+    }
+
+  if ( status == EXIT_SUCCESS )
+    {
+    std::cout << "Test passed." << std::endl;
+    }
+  return status;
+}
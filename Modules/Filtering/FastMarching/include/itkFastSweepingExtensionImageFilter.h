@@ -0,0 +1,161 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFastSweepingExtensionImageFilter_h
+#define itkFastSweepingExtensionImageFilter_h
+
+#include "itkFastSweepingImageFilter.h"
+
+namespace itk
+{
+/** \class FastSweepingExtensionImageFilter
+ * \brief Extend auxiliary variables smoothly using Fast Sweeping.
+ *
+ * This class computes the arrival times as FastSweepingImageFilter, and
+ * simultaneously extends a set of auxiliary values from the initial front,
+ * as FastMarchingExtensionImageFilter does: the extension value at a pixel
+ * is a weighted sum of the extension values at the upwind neighbors used
+ * in the calculation of its arrival time. The extension value is updated
+ * whenever the sweeps visit a pixel whose arrival time is final, so that
+ * the extension values converge along with the arrival times. Only the
+ * neighbors with strictly smaller arrival times are used.
+ *
+ * The auxiliary variables on the front are represented by two auxiliary
+ * variable containers: one containing the value of the variables at the
+ * alive points and one containing the value of the variables at the trial
+ * points. The auxiliary images are zero where the arrival time is not
+ * computed.
+ *
+ * \sa FastSweepingImageFilter
+ * \sa FastMarchingExtensionImageFilter
+ * \sa AuxVarTypeDefault
+ * \ingroup LevelSetSegmentation
+ * \ingroup ITKFastMarching
+ */
+template<
+  typename TLevelSet,
+  typename TAuxValue,
+  unsigned int VAuxDimension = 1,
+  typename TSpeedImage = Image< float,  TLevelSet ::ImageDimension >
+  >
+class ITK_TEMPLATE_EXPORT FastSweepingExtensionImageFilter:
+  public FastSweepingImageFilter< TLevelSet, TSpeedImage >
+{
+public:
+  /** Standard class typdedefs. */
+  typedef FastSweepingExtensionImageFilter                  Self;
+  typedef FastSweepingImageFilter< TLevelSet, TSpeedImage > Superclass;
+  typedef SmartPointer< Self >                              Pointer;
+  typedef SmartPointer< const Self >                        ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(FastSweepingExtensionImageFilter, FastSweepingImageFilter);
+
+  /** Inherited typedefs. */
+  typedef typename Superclass::LevelSetType      LevelSetType;
+  typedef typename Superclass::SpeedImageType    SpeedImageType;
+  typedef typename Superclass::LevelSetImageType LevelSetImageType;
+  typedef typename Superclass::PixelType         PixelType;
+  typedef typename Superclass::AxisNodeType      AxisNodeType;
+
+  /** The dimension of the level set. */
+  itkStaticConstMacro(SetDimension, unsigned int, Superclass::SetDimension);
+
+  /** Number of auxiliary variables to be extended. */
+  itkStaticConstMacro(AuxDimension, unsigned int, VAuxDimension);
+
+  /** AuxVarType typedef support. */
+  typedef AuxVarTypeDefault< TAuxValue,
+                             itkGetStaticConstMacro(AuxDimension),
+                             itkGetStaticConstMacro(SetDimension) >
+  AuxVarType;
+  typedef typename AuxVarType::AuxValueType       AuxValueType;
+  typedef typename AuxVarType::AuxValueVectorType AuxValueVectorType;
+  typedef typename AuxVarType::AuxValueContainer  AuxValueContainer;
+  typedef typename AuxVarType::AuxImageType       AuxImageType;
+  typedef typename AuxVarType::AuxImagePointer    AuxImagePointer;
+
+  /** Index typedef support. */
+  typedef Index< itkGetStaticConstMacro(SetDimension) > IndexType;
+
+  /** Get one of the extended auxiliary variable image. */
+  AuxImageType * GetAuxiliaryImage(unsigned int idx);
+
+  /** Set the container auxiliary values at the initial alive points. */
+  void SetAuxiliaryAliveValues(AuxValueContainer *values)
+  {
+    m_AuxAliveValues = values;
+  }
+
+  /** Get the container of auxiliary values at the initial alive points. */
+  AuxValueContainer * GetAuxiliaryAliveValues(void)
+  {
+    return m_AuxAliveValues.GetPointer();
+  }
+
+  /** Set the container of auxiliary values at the initial trial points. */
+  void SetAuxiliaryTrialValues(AuxValueContainer *values)
+  {
+    m_AuxTrialValues = values;
+  }
+
+  /** Get the container of auxiliary values at the initial trial points. */
+  typename AuxValueContainer::Pointer GetAuxiliaryTrialValues()
+  {
+    return m_AuxTrialValues;
+  }
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  // Begin concept checking
+  itkConceptMacro( AuxValueHasNumericTraitsCheck,
+                   ( Concept::HasNumericTraits< TAuxValue > ) );
+  // End concept checking
+#endif
+
+protected:
+  FastSweepingExtensionImageFilter();
+  ~FastSweepingExtensionImageFilter(){}
+  void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+  virtual void Initialize(LevelSetImageType *) ITK_OVERRIDE;
+
+  virtual bool UpdateValue(const IndexType & index,
+                           const SpeedImageType *speed, LevelSetImageType *output) ITK_OVERRIDE;
+
+  /** Generate the output image meta information */
+  virtual void GenerateOutputInformation() ITK_OVERRIDE;
+
+  virtual void EnlargeOutputRequestedRegion(DataObject *output) ITK_OVERRIDE;
+
+private:
+  ITK_DISALLOW_COPY_AND_ASSIGN(FastSweepingExtensionImageFilter);
+
+  typename AuxValueContainer::Pointer m_AuxAliveValues;
+  typename AuxValueContainer::Pointer m_AuxTrialValues;
+
+  AuxImageType *m_AuxImages[AuxDimension];
+};
+} // namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkFastSweepingExtensionImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,287 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFastSweepingExtensionImageFilter_hxx
+#define itkFastSweepingExtensionImageFilter_hxx
+
+#include "itkFastSweepingExtensionImageFilter.h"
+
+namespace itk
+{
+template< typename TLevelSet, typename TAuxValue, unsigned int VAuxDimension,
+          typename TSpeedImage >
+FastSweepingExtensionImageFilter< TLevelSet, TAuxValue, VAuxDimension, TSpeedImage >
+::FastSweepingExtensionImageFilter()
+{
+  m_AuxAliveValues = ITK_NULLPTR;
+  m_AuxTrialValues = ITK_NULLPTR;
+
+  this->ProcessObject::SetNumberOfRequiredOutputs(1 + AuxDimension);
+
+  AuxImagePointer ptr;
+  for ( unsigned int k = 0; k < VAuxDimension; k++ )
+    {
+    ptr = AuxImageType::New();
+    this->ProcessObject::SetNthOutput( k + 1, ptr.GetPointer() );
+    this->m_AuxImages[k] = ptr.GetPointer();
+    }
+}
+
+template< typename TLevelSet, typename TAuxValue, unsigned int VAuxDimension,
+          typename TSpeedImage >
+void
+FastSweepingExtensionImageFilter< TLevelSet, TAuxValue, VAuxDimension, TSpeedImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Aux alive values: ";
+  os << m_AuxAliveValues.GetPointer() << std::endl;
+  os << indent << "Aux trial values: ";
+  os << m_AuxTrialValues.GetPointer() << std::endl;
+}
+
+/*
+ *
+ */
+template< typename TLevelSet, typename TAuxValue, unsigned int VAuxDimension,
+          typename TSpeedImage >
+typename FastSweepingExtensionImageFilter< TLevelSet, TAuxValue, VAuxDimension, TSpeedImage >
+::AuxImageType *
+FastSweepingExtensionImageFilter< TLevelSet, TAuxValue, VAuxDimension, TSpeedImage >
+::GetAuxiliaryImage(unsigned int idx)
+{
+  if ( idx >= AuxDimension || this->GetNumberOfIndexedOutputs() < idx + 2 )
+    {
+    return ITK_NULLPTR;
+    }
+
+  return this->m_AuxImages[idx];
+}
+
+/*
+ *
+ */
+template< typename TLevelSet, typename TAuxValue, unsigned int VAuxDimension,
+          typename TSpeedImage >
+void
+FastSweepingExtensionImageFilter< TLevelSet, TAuxValue, VAuxDimension, TSpeedImage >
+::GenerateOutputInformation()
+{
+  // call the superclass implementation of this function
+  this->Superclass::GenerateOutputInformation();
+
+  // set the size of all the auxiliary outputs
+  // to be the same as the primary output
+  typename Superclass::LevelSetPointer primaryOutput = this->GetOutput();
+  for ( unsigned int k = 0; k < VAuxDimension; k++ )
+    {
+    AuxImageType *ptr = this->GetAuxiliaryImage(k);
+    ptr->CopyInformation(primaryOutput);
+    }
+}
+
+/*
+ *
+ */
+template< typename TLevelSet, typename TAuxValue, unsigned int VAuxDimension,
+          typename TSpeedImage >
+void
+FastSweepingExtensionImageFilter< TLevelSet, TAuxValue, VAuxDimension, TSpeedImage >
+::EnlargeOutputRequestedRegion(
+  DataObject *itkNotUsed(output) )
+{
+  // This filter requires all of the output images in the buffer.
+  for ( unsigned int j = 0; j < this->GetNumberOfIndexedOutputs(); j++ )
+    {
+    if ( this->ProcessObject::GetOutput(j) )
+      {
+      this->ProcessObject::GetOutput(j)->SetRequestedRegionToLargestPossibleRegion();
+      }
+    }
+}
+
+/*
+ *
+ */
+template< typename TLevelSet, typename TAuxValue, unsigned int VAuxDimension,
+          typename TSpeedImage >
+void
+FastSweepingExtensionImageFilter< TLevelSet, TAuxValue, VAuxDimension, TSpeedImage >
+::Initialize(LevelSetImageType *output)
+{
+  this->Superclass::Initialize(output);
+
+  if ( this->GetAlivePoints() && !m_AuxAliveValues )
+    {
+    itkExceptionMacro(<< "in Initialize(): Null pointer for AuxAliveValues");
+    }
+
+  if ( m_AuxAliveValues
+       && m_AuxAliveValues->Size() != ( this->GetAlivePoints() )->Size() )
+    {
+    itkExceptionMacro(<< "in Initialize(): AuxAliveValues is the wrong size");
+    }
+
+  if ( this->GetTrialPoints() && !m_AuxTrialValues )
+    {
+    itkExceptionMacro(<< "in Initialize(): Null pointer for AuxTrialValues");
+    }
+
+  if ( m_AuxTrialValues
+       && m_AuxTrialValues->Size() != ( this->GetTrialPoints() )->Size() )
+    {
+    itkExceptionMacro(<< "in Initialize(): AuxTrialValues is the wrong size");
+    }
+
+  // allocate memory for the auxiliary outputs
+  for ( unsigned int k = 0; k < VAuxDimension; k++ )
+    {
+    AuxImageType *ptr = this->GetAuxiliaryImage(k);
+    ptr->SetBufferedRegion( ptr->GetRequestedRegion() );
+    ptr->Allocate();
+    ptr->FillBuffer( NumericTraits< AuxValueType >::ZeroValue() );
+    }
+
+  // set the auxiliary values of the alive and trial points
+  typename Superclass::NodeType node;
+
+  AuxValueVectorType auxVec;
+
+  for ( unsigned int c = 0; c < 2; c++ )
+    {
+    AuxValueContainer *values = c == 0 ? m_AuxAliveValues.GetPointer() : m_AuxTrialValues.GetPointer();
+    if ( !values )
+      {
+      continue;
+      }
+
+    typename Superclass::NodeContainer *points =
+      c == 0 ? this->GetAlivePoints().GetPointer() : this->GetTrialPoints().GetPointer();
+
+    typename AuxValueContainer::ConstIterator auxIter = values->Begin();
+    typename Superclass::NodeContainer::ConstIterator pointsIter = points->Begin();
+    typename Superclass::NodeContainer::ConstIterator pointsEnd = points->End();
+
+    for (; pointsIter != pointsEnd; ++pointsIter, ++auxIter )
+      {
+      node = pointsIter.Value();
+      auxVec = auxIter.Value();
+
+      // check if node index is within the output level set
+      if ( !this->GetOutput()->GetBufferedRegion().IsInside( node.GetIndex() ) )
+        {
+        continue;
+        }
+
+      for ( unsigned int k = 0; k < VAuxDimension; k++ )
+        {
+        this->m_AuxImages[k]->SetPixel(node.GetIndex(), auxVec[k]);
+        }
+      } // end container loop
+    }
+}
+
+template< typename TLevelSet, typename TAuxValue, unsigned int VAuxDimension,
+          typename TSpeedImage >
+bool
+FastSweepingExtensionImageFilter< TLevelSet, TAuxValue, VAuxDimension, TSpeedImage >
+::UpdateValue(
+  const IndexType & index,
+  const SpeedImageType *speed,
+  LevelSetImageType *output)
+{
+  // A extension value at node is chosen such that
+  // grad(F) dot_product grad(Phi) = 0
+  // where F is the extended speed function and Phi is
+  // the level set function.
+  //
+  // The extension value can approximated as a weighted
+  // sum of the values from nodes used in the calculation
+  // of the distance by the superclass.
+  //
+  // For more detail see Chapter 11 of
+  // "Level Set Methods and Fast Marching Methods", J.A. Sethian,
+  // Cambridge Press, Second edition, 1999.
+
+  AxisNodeType nodesUsed[SetDimension];
+  unsigned int numberOfNodesUsed;
+  double       solution;
+
+  this->ComputeSolution(index, speed, output, nodesUsed, numberOfNodesUsed, solution);
+
+  if ( numberOfNodesUsed == 0 || solution > this->GetStoppingValue() )
+    {
+    return false;
+    }
+
+  const PixelType outputPixel = static_cast< PixelType >( solution );
+  const PixelType currentPixel = output->GetPixel(index);
+  if ( currentPixel < outputPixel )
+    {
+    return false;
+    }
+
+  bool changed = false;
+  if ( outputPixel < currentPixel )
+    {
+    output->SetPixel(index, outputPixel);
+    changed = true;
+    }
+
+  // the extension values are also updated when the arrival time is
+  // final, since the extension values of the neighbors may have changed
+  for ( unsigned int k = 0; k < VAuxDimension; k++ )
+    {
+    double       numer = 0.0;
+    double       denom = 0.;
+    AuxValueType auxVal;
+
+    for ( unsigned int j = 0; j < numberOfNodesUsed; j++ )
+      {
+      const AxisNodeType & node = nodesUsed[j];
+
+      if ( !( node.GetValue() < outputPixel ) )
+        {
+        break;
+        }
+
+      auxVal = this->m_AuxImages[k]->GetPixel( node.GetIndex() );
+      numer += auxVal * ( solution - node.GetValue() );
+      denom += solution - node.GetValue();
+      }
+
+    if ( denom > 0 )
+      {
+      auxVal = static_cast< AuxValueType >( numer / denom );
+      }
+    else
+      {
+      auxVal = NumericTraits< AuxValueType >::ZeroValue();
+      }
+
+    if ( Math::NotExactlyEquals( auxVal, this->m_AuxImages[k]->GetPixel(index) ) )
+      {
+      this->m_AuxImages[k]->SetPixel(index, auxVal);
+      changed = true;
+      }
+    }
+
+  return changed;
+}
+} // namespace itk
+
+#endif
@@ -0,0 +1,392 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFastSweepingImageFilter_h
+#define itkFastSweepingImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkLevelSet.h"
+#include "itkAtomicInt.h"
+#include "itkMath.h"
+
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class FastSweepingImageFilter
+ * \brief Solve an Eikonal equation using Fast Sweeping on tiles with
+ * several threads.
+ *
+ * FastSweepingImageFilter computes the same arrival times as
+ * FastMarchingImageFilter: the speed is non-negative and depends on the
+ * position only, and the value of a pixel is given by the same upwind
+ * discretization of the Eikonal equation. Instead of moving the front one
+ * grid point at a time, the values are relaxed by Gauss-Seidel sweeps of
+ * the grid in the 2^N alternating orders, until no value decreases.
+ *
+ * The output is divided into tiles of TileSize pixels along each
+ * dimension. A tile is swept until its values do not change anymore, and
+ * its neighbors across the faces where values changed are then swept in
+ * turn, starting from the tiles of the trial points. The tiles are colored
+ * by the parities of their positions in the grid of tiles, so that two
+ * tiles of the same color never share a face, and the tiles of a color are
+ * swept concurrently by the threads of the filter. The colors are swept
+ * one after the other in a fixed order, so that the output does not depend
+ * on the number of threads. It may differ from the output of fast marching
+ * by the rounding of the values to the pixel type.
+ *
+ * The initial front is specified by a container of trial points, whose
+ * values are fixed, and optionally by a container of alive points, which
+ * are also fixed but are not collected. The speed function is specified
+ * either as a speed image, set with SetInput(), or as a speed constant.
+ * The output information is computed as in FastMarchingImageFilter.
+ *
+ * Only the values up to StoppingValue are computed: the other pixels keep
+ * the LargeValue, and the sweeps do not spread beyond the tiles where a
+ * value is below the stopping value. With a small stopping value, the work
+ * is limited to a narrowband around the front.
+ * When CollectPoints is on, the points whose value is at most the
+ * stopping value are collected in increasing order of value.
+ *
+ * Implementation of this class is based on
+ * "A fast sweeping method for Eikonal equations", H. Zhao,
+ * Mathematics of Computation, 74(250), 2005, and on the domain
+ * decomposition of "Parallel implementations of the fast sweeping
+ * method", H. Zhao, Journal of Computational Mathematics, 25(4), 2007.
+ *
+ * \sa FastMarchingImageFilter
+ * \sa LevelSetTypeDefault
+ * \ingroup LevelSetSegmentation
+ * \ingroup ITKFastMarching
+ */
+template<
+  typename TLevelSet,
+  typename TSpeedImage = Image< float,  TLevelSet ::ImageDimension > >
+class ITK_TEMPLATE_EXPORT FastSweepingImageFilter:
+  public ImageToImageFilter< TSpeedImage, TLevelSet >
+{
+public:
+  /** Standard class typdedefs. */
+  typedef FastSweepingImageFilter                      Self;
+  typedef ImageToImageFilter< TSpeedImage, TLevelSet > Superclass;
+  typedef SmartPointer< Self >                         Pointer;
+  typedef SmartPointer< const Self >                   ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(FastSweepingImageFilter, ImageToImageFilter);
+
+  /** Typedef support of level set method types. */
+  typedef LevelSetTypeDefault< TLevelSet >            LevelSetType;
+  typedef typename LevelSetType::LevelSetImageType    LevelSetImageType;
+  typedef typename LevelSetType::LevelSetPointer      LevelSetPointer;
+  typedef typename LevelSetType::PixelType            PixelType;
+  typedef typename LevelSetType::NodeType             NodeType;
+  typedef typename NodeType::IndexType                NodeIndexType;
+  typedef typename LevelSetType::NodeContainer        NodeContainer;
+  typedef typename LevelSetType::NodeContainerPointer NodeContainerPointer;
+  typedef typename LevelSetImageType::SizeType        OutputSizeType;
+  typedef typename LevelSetImageType::RegionType      OutputRegionType;
+  typedef typename LevelSetImageType::SpacingType     OutputSpacingType;
+  typedef typename LevelSetImageType::DirectionType   OutputDirectionType;
+  typedef typename LevelSetImageType::PointType       OutputPointType;
+
+  class AxisNodeType:public NodeType
+  {
+public:
+    AxisNodeType() : m_Axis(0) {}
+    int GetAxis() const { return m_Axis; }
+    void SetAxis(int axis) { m_Axis = axis; }
+    const AxisNodeType & operator=(const NodeType & node)
+    { this->NodeType::operator=(node); return *this; }
+
+private:
+    int m_Axis;
+  };
+
+  /** SpeedImage typedef support. */
+  typedef TSpeedImage SpeedImageType;
+
+  /** SpeedImagePointer typedef support. */
+  typedef typename SpeedImageType::Pointer      SpeedImagePointer;
+  typedef typename SpeedImageType::ConstPointer SpeedImageConstPointer;
+
+  /** Dimension of the level set and the speed image. */
+  itkStaticConstMacro(SetDimension, unsigned int,
+                      LevelSetType::SetDimension);
+  itkStaticConstMacro(SpeedImageDimension, unsigned int,
+                      SpeedImageType::ImageDimension);
+
+  /** Index typedef support. */
+  typedef Index< itkGetStaticConstMacro(SetDimension) > IndexType;
+
+  /** Enum of Fast Sweeping point types. FarPoints are updated by the
+   * sweeps; AlivePoints and TrialPoints represent the initial front and
+   * keep their values. */
+  enum LabelType { FarPoint = 0, AlivePoint, TrialPoint };
+
+  /** LabelImage typedef support. */
+  typedef Image< unsigned char, itkGetStaticConstMacro(SetDimension) > LabelImageType;
+
+  /** LabelImagePointer typedef support. */
+  typedef typename LabelImageType::Pointer LabelImagePointer;
+
+  /** Set the container of Alive Points representing the initial front.
+   * Alive points are represented as a VectorContainer of LevelSetNodes. */
+  void SetAlivePoints(NodeContainer *points)
+  {
+    m_AlivePoints = points;
+    this->Modified();
+  }
+
+  /** Get the container of Alive Points representing the initial front. */
+  NodeContainerPointer GetAlivePoints()
+  {
+    return m_AlivePoints;
+  }
+
+  /** Set the container of Trial Points representing the initial front.
+   * Trial points are represented as a VectorContainer of LevelSetNodes. */
+  void SetTrialPoints(NodeContainer *points)
+  {
+    m_TrialPoints = points;
+    this->Modified();
+  }
+
+  /** Get the container of Trial Points representing the initial front. */
+  NodeContainerPointer GetTrialPoints()
+  {
+    return m_TrialPoints;
+  }
+
+  /** Get the point type label image. */
+  LabelImagePointer GetLabelImage() const
+  {
+    return m_LabelImage;
+  }
+
+  /** Set the Speed Constant. If the Speed Image is ITK_NULLPTR,
+   * the SpeedConstant value is used for the whole level set.
+   * By default, the SpeedConstant is set to 1.0. */
+  void SetSpeedConstant(double value)
+  {
+    m_SpeedConstant = value;
+    m_InverseSpeed = -1.0 * itk::Math::sqr(1.0 / m_SpeedConstant);
+    this->Modified();
+  }
+
+  /** Get the Speed Constant. */
+  itkGetConstReferenceMacro(SpeedConstant, double);
+
+  /** Set/Get the Normalization Factor for the Speed Image.
+      The values in the Speed Image is divided by this
+      factor. This allows the use of images with
+      integer pixel types to represent the speed. */
+  itkSetMacro(NormalizationFactor, double);
+  itkGetConstMacro(NormalizationFactor, double);
+
+  /** Set/Get the Stopping Value. Only the arrival times up to the
+   * stopping value are computed. */
+  itkSetMacro(StoppingValue, double);
+  itkGetConstReferenceMacro(StoppingValue, double);
+
+  /** Set/Get the Collect Points flag. Instrument the algorithm to collect
+   * a container of all the nodes whose value is at most the stopping
+   * value. Useful for creating Narrowbands for level set algorithms that
+   * supports narrow banding. */
+  itkSetMacro(CollectPoints, bool);
+  itkGetConstReferenceMacro(CollectPoints, bool);
+  itkBooleanMacro(CollectPoints);
+
+  /** Get the container of Processed Points. If the CollectPoints flag
+   * is set, the algorithm collects a container of all processed nodes,
+   * sorted by value. */
+  NodeContainerPointer GetProcessedPoints() const
+  {
+    return m_ProcessedPoints;
+  }
+
+  /** Set/Get the number of pixels of the tiles along each dimension.
+   * Defaults to 16. */
+  itkSetClampMacro(TileSize, SizeValueType, 1, NumericTraits< SizeValueType >::max());
+  itkGetConstMacro(TileSize, SizeValueType);
+
+  /** The output largeset possible, spacing and origin is computed as follows.
+   * If the speed image is ITK_NULLPTR or if the OverrideOutputInformation is true,
+   * the output information is set from user specified parameters. These
+   * parameters can be specified using methods SetOutputRegion(), SetOutputSpacing(), SetOutputDirection(),
+   * and SetOutputOrigin(). Else if the speed image is not ITK_NULLPTR, the output information
+   * is copied from the input speed image. */
+  virtual void SetOutputSize(const OutputSizeType & size)
+  { m_OutputRegion = size; }
+  virtual OutputSizeType GetOutputSize() const
+  { return m_OutputRegion.GetSize(); }
+  itkSetMacro(OutputRegion, OutputRegionType);
+  itkGetConstReferenceMacro(OutputRegion, OutputRegionType);
+  itkSetMacro(OutputSpacing, OutputSpacingType);
+  itkGetConstReferenceMacro(OutputSpacing, OutputSpacingType);
+  itkSetMacro(OutputDirection, OutputDirectionType);
+  itkGetConstReferenceMacro(OutputDirection, OutputDirectionType);
+  itkSetMacro(OutputOrigin, OutputPointType);
+  itkGetConstReferenceMacro(OutputOrigin, OutputPointType);
+  itkSetMacro(OverrideOutputInformation, bool);
+  itkGetConstReferenceMacro(OverrideOutputInformation, bool);
+  itkBooleanMacro(OverrideOutputInformation);
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  // Begin concept checking
+  itkConceptMacro( SameDimensionCheck,
+                   ( Concept::SameDimension< SetDimension, SpeedImageDimension > ) );
+  itkConceptMacro( SpeedConvertibleToDoubleCheck,
+                   ( Concept::Convertible< typename TSpeedImage::PixelType, double > ) );
+  itkConceptMacro( DoubleConvertibleToLevelSetCheck,
+                   ( Concept::Convertible< double, PixelType > ) );
+  itkConceptMacro( LevelSetOStreamWritableCheck,
+                   ( Concept::OStreamWritable< PixelType > ) );
+  // End concept checking
+#endif
+
+protected:
+  FastSweepingImageFilter();
+  ~FastSweepingImageFilter(){}
+  void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+  virtual void Initialize(LevelSetImageType *);
+
+  /** Solves the discretized Eikonal equation at a pixel from the current
+   * values of its neighbors, as FastMarchingImageFilter::UpdateValue()
+   * does from its alive neighbors. The neighbors used in the calculation
+   * are stored in nodesUsed, sorted by value, and their number in
+   * numberOfNodesUsed. The solution is the LargeValue if no neighbor has
+   * a value. */
+  void ComputeSolution(const IndexType & index,
+                       const SpeedImageType *, const LevelSetImageType *,
+                       AxisNodeType *nodesUsed, unsigned int & numberOfNodesUsed,
+                       double & solution) const;
+
+  /** Updates the value of a far point, and returns true if the value
+   * changed. The far points of the tiles of a color are updated
+   * concurrently, so the update may only write to the pixels at index. */
+  virtual bool UpdateValue(const IndexType & index,
+                           const SpeedImageType *, LevelSetImageType *);
+
+  void GenerateData() ITK_OVERRIDE;
+
+  /** Generate the output image meta information. */
+  virtual void GenerateOutputInformation() ITK_OVERRIDE;
+
+  virtual void EnlargeOutputRequestedRegion(DataObject *output) ITK_OVERRIDE;
+
+  /** Get Large Value. This value is used to
+      represent the concept of infinity for the time assigned to pixels that
+      have not been visited. This value is set by default to half the
+      max() of the pixel type used to represent the time-crossing map. */
+  itkGetConstReferenceMacro(LargeValue, PixelType);
+
+  OutputRegionType m_BufferedRegion;
+  typedef typename LevelSetImageType::IndexType LevelSetIndexType;
+  LevelSetIndexType m_StartIndex;
+  LevelSetIndexType m_LastIndex;
+
+  itkGetConstReferenceMacro(StartIndex, LevelSetIndexType);
+  itkGetConstReferenceMacro(LastIndex, LevelSetIndexType);
+
+private:
+  ITK_DISALLOW_COPY_AND_ASSIGN(FastSweepingImageFilter);
+
+  /** A tile of the output. FaceChanged records, for the lower and upper
+   *  faces along each dimension, whether a value changed on the face during
+   *  the last visit of the tile. */
+  struct TileType
+  {
+    OutputRegionType Region;
+    unsigned int     Color;
+    bool             Active;
+    bool             Visited;
+    bool             FaceChanged[2 * SetDimension];
+    std::string      ErrorDescription;
+  };
+
+  struct SweepThreadStruct
+  {
+    Self                      *Filter;
+    const SpeedImageType      *SpeedImage;
+    LevelSetImageType         *Output;
+    AtomicInt< SizeValueType > NextTile;
+  };
+
+  /** Splits the output into tiles, and activates the tiles of the alive
+   *  and trial points. */
+  void InitializeTiles();
+
+  /** Index of the tile of a pixel. */
+  SizeValueType ComputeTileIndex(const IndexType & index) const;
+
+  static ITK_THREAD_RETURN_TYPE SweepThreaderCallback(void *arg);
+
+  /** Sweeps a tile in the alternating orders until a sweep does not
+   *  change any value. */
+  void SweepTile(TileType & tile, const SpeedImageType *, LevelSetImageType *);
+
+  /** Sweeps a tile once, in the order given by the bits of the sweep
+   *  number: along the dimension d, the pixels are visited backwards when
+   *  the bit d is set. Returns true if a value changed. */
+  bool SweepTileOnce(TileType & tile, unsigned int sweep,
+                     const SpeedImageType *, LevelSetImageType *);
+
+  /** Collects the points whose value is at most the stopping value in the
+   *  visited tiles, sorted by value. */
+  void CollectProcessedPoints(const LevelSetImageType *);
+
+  NodeContainerPointer m_AlivePoints;
+  NodeContainerPointer m_TrialPoints;
+
+  LabelImagePointer m_LabelImage;
+
+  double m_SpeedConstant;
+  double m_InverseSpeed;
+  double m_StoppingValue;
+
+  bool                 m_CollectPoints;
+  NodeContainerPointer m_ProcessedPoints;
+
+  OutputRegionType    m_OutputRegion;
+  OutputPointType     m_OutputOrigin;
+  OutputSpacingType   m_OutputSpacing;
+  OutputDirectionType m_OutputDirection;
+  bool                m_OverrideOutputInformation;
+
+  typename LevelSetImageType::PixelType m_LargeValue;
+
+  double m_NormalizationFactor;
+
+  SizeValueType                m_TileSize;
+  std::vector< TileType >      m_Tiles;
+  SizeValueType                m_TileGridSize[SetDimension];
+  SizeValueType                m_TileGridStrides[SetDimension];
+  std::vector< SizeValueType > m_SweptTiles;
+};
+} // namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkFastSweepingImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,666 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFastSweepingImageFilter_hxx
+#define itkFastSweepingImageFilter_hxx
+
+#include "itkFastSweepingImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkNumericTraits.h"
+#include "itkMath.h"
+#include <algorithm>
+
+namespace itk
+{
+template< typename TLevelSet, typename TSpeedImage >
+FastSweepingImageFilter< TLevelSet, TSpeedImage >
+::FastSweepingImageFilter()
+{
+  this->ProcessObject::SetNumberOfRequiredInputs(0);
+
+  OutputSizeType outputSize;
+  outputSize.Fill(16);
+  typename LevelSetImageType::IndexType outputIndex;
+  outputIndex.Fill(0);
+
+  m_OutputRegion.SetSize(outputSize);
+  m_OutputRegion.SetIndex(outputIndex);
+
+  m_OutputOrigin.Fill(0.0);
+  m_OutputSpacing.Fill(1.0);
+  m_OutputDirection.SetIdentity();
+  m_OverrideOutputInformation = false;
+
+  m_AlivePoints = ITK_NULLPTR;
+  m_TrialPoints = ITK_NULLPTR;
+  m_ProcessedPoints = ITK_NULLPTR;
+
+  m_SpeedConstant = 1.0;
+  m_InverseSpeed = -1.0;
+  m_LabelImage = LabelImageType::New();
+
+  m_LargeValue    = static_cast< PixelType >( NumericTraits< PixelType >::max() / 2.0 );
+  m_StoppingValue = static_cast< double >( m_LargeValue );
+  m_CollectPoints = false;
+
+  m_NormalizationFactor = 1.0;
+
+  m_TileSize = 16;
+  for ( unsigned int d = 0; d < SetDimension; d++ )
+    {
+    m_TileGridSize[d] = 0;
+    m_TileGridStrides[d] = 0;
+    }
+}
+
+template< typename TLevelSet, typename TSpeedImage >
+void
+FastSweepingImageFilter< TLevelSet, TSpeedImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Alive points: " << m_AlivePoints.GetPointer() << std::endl;
+  os << indent << "Trial points: " << m_TrialPoints.GetPointer() << std::endl;
+  os << indent << "Speed constant: " << m_SpeedConstant << std::endl;
+  os << indent << "Stopping value: " << m_StoppingValue << std::endl;
+  os << indent << "Large Value: "
+     << static_cast< typename NumericTraits< PixelType >::PrintType >( m_LargeValue )
+     << std::endl;
+  os << indent << "Normalization Factor: " << m_NormalizationFactor << std::endl;
+  os << indent << "Collect points: " << m_CollectPoints << std::endl;
+  os << indent << "Tile size: " << m_TileSize << std::endl;
+  os << indent << "OverrideOutputInformation: ";
+  os << m_OverrideOutputInformation << std::endl;
+  os << indent << "OutputRegion: " << m_OutputRegion << std::endl;
+  os << indent << "OutputOrigin:  " << m_OutputOrigin << std::endl;
+  os << indent << "OutputSpacing: " << m_OutputSpacing << std::endl;
+  os << indent << "OutputDirection: " << m_OutputDirection << std::endl;
+}
+
+template< typename TLevelSet, typename TSpeedImage >
+void
+FastSweepingImageFilter< TLevelSet, TSpeedImage >
+::GenerateOutputInformation()
+{
+  // copy output information from input image
+  Superclass::GenerateOutputInformation();
+
+  // use user-specified output information
+  if ( this->GetInput() == ITK_NULLPTR || m_OverrideOutputInformation )
+    {
+    LevelSetPointer output = this->GetOutput();
+    output->SetLargestPossibleRegion(m_OutputRegion);
+    output->SetOrigin(m_OutputOrigin);
+    output->SetSpacing(m_OutputSpacing);
+    output->SetDirection(m_OutputDirection);
+    }
+}
+
+template< typename TLevelSet, typename TSpeedImage >
+void
+FastSweepingImageFilter< TLevelSet, TSpeedImage >
+::EnlargeOutputRequestedRegion(
+  DataObject *output)
+{
+  // enlarge the requested region of the output
+  // to the whole data set
+  TLevelSet *imgData;
+
+  imgData = dynamic_cast< TLevelSet * >( output );
+  if ( imgData )
+    {
+    imgData->SetRequestedRegionToLargestPossibleRegion();
+    }
+  else
+    {
+    // Pointer could not be cast to TLevelSet *
+    itkWarningMacro( << "itk::FastSweepingImageFilter"
+                     << "::EnlargeOutputRequestedRegion cannot cast "
+                     << typeid( output ).name() << " to "
+                     << typeid( TLevelSet * ).name() );
+    }
+}
+
+template< typename TLevelSet, typename TSpeedImage >
+void
+FastSweepingImageFilter< TLevelSet, TSpeedImage >
+::Initialize(LevelSetImageType *output)
+{
+  // allocate memory for the output buffer
+  output->SetBufferedRegion( output->GetRequestedRegion() );
+  output->Allocate();
+
+  // cache some buffered region information
+  m_BufferedRegion = output->GetBufferedRegion();
+  m_StartIndex = m_BufferedRegion.GetIndex();
+  m_LastIndex = m_StartIndex + m_BufferedRegion.GetSize();
+  typename LevelSetImageType::OffsetType offset;
+  offset.Fill(1);
+  m_LastIndex -= offset;
+
+  // allocate memory for the PointTypeImage
+  m_LabelImage->CopyInformation(output);
+  m_LabelImage->SetBufferedRegion(
+    output->GetBufferedRegion() );
+  m_LabelImage->Allocate();
+
+  // set all output value to infinity and all points type to FarPoint
+  output->FillBuffer(m_LargeValue);
+  m_LabelImage->FillBuffer(FarPoint);
+
+  // process the input alive and trial points
+  NodeType      node;
+  NodeIndexType idx;
+
+  for ( unsigned int c = 0; c < 2; c++ )
+    {
+    NodeContainer *points = c == 0 ? m_AlivePoints.GetPointer() : m_TrialPoints.GetPointer();
+    if ( !points )
+      {
+      continue;
+      }
+
+    typename NodeContainer::ConstIterator pointsIter = points->Begin();
+    typename NodeContainer::ConstIterator pointsEnd = points->End();
+
+    for (; pointsIter != pointsEnd; ++pointsIter )
+      {
+      node = pointsIter.Value();
+      idx = node.GetIndex();
+
+      // check if node index is within the output level set
+      if ( m_BufferedRegion.IsInside( idx ) )
+        {
+        m_LabelImage->SetPixel(idx, c == 0 ? AlivePoint : TrialPoint);
+        output->SetPixel(idx, node.GetValue());
+        }
+      }
+    }
+}
+
+template< typename TLevelSet, typename TSpeedImage >
+void
+FastSweepingImageFilter< TLevelSet, TSpeedImage >
+::InitializeTiles()
+{
+  SizeValueType numberOfTiles = 1;
+  for ( unsigned int d = 0; d < SetDimension; d++ )
+    {
+    m_TileGridSize[d] = ( m_BufferedRegion.GetSize()[d] + m_TileSize - 1 ) / m_TileSize;
+    m_TileGridStrides[d] = numberOfTiles;
+    numberOfTiles *= m_TileGridSize[d];
+    }
+
+  m_Tiles.clear();
+  m_Tiles.resize(numberOfTiles);
+  for ( SizeValueType t = 0; t < numberOfTiles; t++ )
+    {
+    TileType & tile = m_Tiles[t];
+    IndexType  tileIndex;
+    OutputSizeType tileSize;
+    tile.Color = 0;
+    for ( unsigned int d = 0; d < SetDimension; d++ )
+      {
+      const SizeValueType position = ( t / m_TileGridStrides[d] ) % m_TileGridSize[d];
+      tileIndex[d] = m_StartIndex[d] + static_cast< IndexValueType >( position * m_TileSize );
+      tileSize[d] = std::min( m_TileSize, static_cast< SizeValueType >( m_LastIndex[d] - tileIndex[d] + 1 ) );
+      tile.Color |= static_cast< unsigned int >( position % 2 ) << d;
+      }
+    tile.Region.SetIndex(tileIndex);
+    tile.Region.SetSize(tileSize);
+    tile.Active = false;
+    tile.Visited = false;
+    tile.ErrorDescription.clear();
+    }
+
+  // the sweeps start from the tiles of the initial front
+  for ( unsigned int c = 0; c < 2; c++ )
+    {
+    NodeContainer *points = c == 0 ? m_AlivePoints.GetPointer() : m_TrialPoints.GetPointer();
+    if ( !points )
+      {
+      continue;
+      }
+
+    typename NodeContainer::ConstIterator pointsIter = points->Begin();
+    typename NodeContainer::ConstIterator pointsEnd = points->End();
+
+    for (; pointsIter != pointsEnd; ++pointsIter )
+      {
+      if ( m_BufferedRegion.IsInside( pointsIter.Value().GetIndex() ) )
+        {
+        m_Tiles[this->ComputeTileIndex( pointsIter.Value().GetIndex() )].Active = true;
+        }
+      }
+    }
+}
+
+template< typename TLevelSet, typename TSpeedImage >
+SizeValueType
+FastSweepingImageFilter< TLevelSet, TSpeedImage >
+::ComputeTileIndex(const IndexType & index) const
+{
+  SizeValueType tileIndex = 0;
+  for ( unsigned int d = 0; d < SetDimension; d++ )
+    {
+    tileIndex += static_cast< SizeValueType >( index[d] - m_StartIndex[d] ) / m_TileSize * m_TileGridStrides[d];
+    }
+  return tileIndex;
+}
+
+template< typename TLevelSet, typename TSpeedImage >
+void
+FastSweepingImageFilter< TLevelSet, TSpeedImage >
+::GenerateData()
+{
+  if( m_NormalizationFactor < itk::Math::eps )
+    {
+    ExceptionObject err(__FILE__, __LINE__);
+    err.SetLocation(ITK_LOCATION);
+    err.SetDescription("Normalization Factor is null or negative");
+    throw err;
+    }
+
+  LevelSetPointer        output      = this->GetOutput();
+  SpeedImageConstPointer speedImage  = this->GetInput();
+
+  this->Initialize(output);
+  this->InitializeTiles();
+
+  this->UpdateProgress(0.0);   // Send first progress event
+
+  SweepThreadStruct str;
+  str.Filter = this;
+  str.SpeedImage = speedImage;
+  str.Output = output;
+
+  const unsigned int numberOfColors = 1u << SetDimension;
+
+  bool active = true;
+  while ( active )
+    {
+    for ( unsigned int color = 0; color < numberOfColors; color++ )
+      {
+      // the active tiles of a color do not share faces, so that they can
+      // be swept concurrently
+      m_SweptTiles.clear();
+      for ( SizeValueType t = 0; t < m_Tiles.size(); t++ )
+        {
+        if ( m_Tiles[t].Active && m_Tiles[t].Color == color )
+          {
+          m_Tiles[t].Active = false;
+          m_SweptTiles.push_back(t);
+          }
+        }
+      if ( m_SweptTiles.empty() )
+        {
+        continue;
+        }
+
+      str.NextTile = 0;
+      const ThreadIdType numberOfThreads =
+        static_cast< ThreadIdType >( std::min( static_cast< SizeValueType >( this->GetNumberOfThreads() ),
+                                               static_cast< SizeValueType >( m_SweptTiles.size() ) ) );
+      this->GetMultiThreader()->SetNumberOfThreads(numberOfThreads);
+      this->GetMultiThreader()->SetSingleMethod(this->SweepThreaderCallback, &str);
+      this->GetMultiThreader()->SingleMethodExecute();
+
+      // sweep the neighbors across the faces where values changed
+      for ( SizeValueType i = 0; i < m_SweptTiles.size(); i++ )
+        {
+        const SizeValueType t = m_SweptTiles[i];
+        TileType &          tile = m_Tiles[t];
+
+        if ( !tile.ErrorDescription.empty() )
+          {
+          ExceptionObject err(__FILE__, __LINE__);
+          err.SetLocation(ITK_LOCATION);
+          err.SetDescription(tile.ErrorDescription);
+          throw err;
+          }
+
+        tile.Visited = true;
+        for ( unsigned int d = 0; d < SetDimension; d++ )
+          {
+          const SizeValueType position = ( t / m_TileGridStrides[d] ) % m_TileGridSize[d];
+          if ( tile.FaceChanged[2 * d] && position > 0 )
+            {
+            m_Tiles[t - m_TileGridStrides[d]].Active = true;
+            }
+          if ( tile.FaceChanged[2 * d + 1] && position + 1 < m_TileGridSize[d] )
+            {
+            m_Tiles[t + m_TileGridStrides[d]].Active = true;
+            }
+          }
+        }
+      }
+
+    active = false;
+    for ( SizeValueType t = 0; t < m_Tiles.size() && !active; t++ )
+      {
+      active = m_Tiles[t].Active;
+      }
+
+    if ( this->GetAbortGenerateData() )
+      {
+      this->InvokeEvent( AbortEvent() );
+      this->ResetPipeline();
+      ProcessAborted e(__FILE__, __LINE__);
+      e.SetDescription("Process aborted.");
+      e.SetLocation(ITK_LOCATION);
+      throw e;
+      }
+    }
+
+  if ( m_CollectPoints )
+    {
+    this->CollectProcessedPoints(output);
+    }
+
+  this->UpdateProgress(1.0);
+}
+
+template< typename TLevelSet, typename TSpeedImage >
+ITK_THREAD_RETURN_TYPE
+FastSweepingImageFilter< TLevelSet, TSpeedImage >
+::SweepThreaderCallback(void *arg)
+{
+  SweepThreadStruct *str = (SweepThreadStruct *)
+                           ( ( (MultiThreader::ThreadInfoStruct *)( arg ) )->UserData );
+  Self *filter = str->Filter;
+
+  SizeValueType i;
+  while ( ( i = str->NextTile++ ) < filter->m_SweptTiles.size() )
+    {
+    TileType & tile = filter->m_Tiles[filter->m_SweptTiles[i]];
+
+    // exceptions cannot leave the thread: they are thrown again after
+    // the tiles of the color have been swept
+    try
+      {
+      filter->SweepTile(tile, str->SpeedImage, str->Output);
+      }
+    catch ( ExceptionObject & err )
+      {
+      tile.ErrorDescription = err.GetDescription();
+      }
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TLevelSet, typename TSpeedImage >
+void
+FastSweepingImageFilter< TLevelSet, TSpeedImage >
+::SweepTile(TileType & tile, const SpeedImageType *speedImage, LevelSetImageType *output)
+{
+  for ( unsigned int f = 0; f < 2 * SetDimension; f++ )
+    {
+    tile.FaceChanged[f] = false;
+    }
+
+  // a sweep which does not change any value leaves every pixel of the
+  // tile consistent with its neighbors
+  const unsigned int numberOfSweepOrders = 1u << SetDimension;
+  unsigned int       sweep = 0;
+  while ( this->SweepTileOnce(tile, sweep, speedImage, output) )
+    {
+    sweep = ( sweep + 1 ) % numberOfSweepOrders;
+    }
+}
+
+template< typename TLevelSet, typename TSpeedImage >
+bool
+FastSweepingImageFilter< TLevelSet, TSpeedImage >
+::SweepTileOnce(TileType & tile, unsigned int sweep,
+                const SpeedImageType *speedImage, LevelSetImageType *output)
+{
+  const IndexType & first = tile.Region.GetIndex();
+  IndexType         last;
+  IndexType         index;
+  for ( unsigned int d = 0; d < SetDimension; d++ )
+    {
+    last[d] = first[d] + static_cast< IndexValueType >( tile.Region.GetSize()[d] ) - 1;
+    index[d] = ( sweep >> d ) & 1 ? last[d] : first[d];
+    }
+
+  bool changed = false;
+
+  const SizeValueType numberOfPixels = tile.Region.GetNumberOfPixels();
+  for ( SizeValueType p = 0; p < numberOfPixels; p++ )
+    {
+    if ( m_LabelImage->GetPixel(index) == FarPoint
+         && this->UpdateValue(index, speedImage, output) )
+      {
+      changed = true;
+      for ( unsigned int d = 0; d < SetDimension; d++ )
+        {
+        if ( index[d] == first[d] )
+          {
+          tile.FaceChanged[2 * d] = true;
+          }
+        if ( index[d] == last[d] )
+          {
+          tile.FaceChanged[2 * d + 1] = true;
+          }
+        }
+      }
+
+    // move to the next pixel in the order of the sweep
+    for ( unsigned int d = 0; d < SetDimension; d++ )
+      {
+      if ( ( sweep >> d ) & 1 )
+        {
+        if ( index[d] > first[d] )
+          {
+          --index[d];
+          break;
+          }
+        index[d] = last[d];
+        }
+      else
+        {
+        if ( index[d] < last[d] )
+          {
+          ++index[d];
+          break;
+          }
+        index[d] = first[d];
+        }
+      }
+    }
+
+  return changed;
+}
+
+template< typename TLevelSet, typename TSpeedImage >
+void
+FastSweepingImageFilter< TLevelSet, TSpeedImage >
+::ComputeSolution(
+  const IndexType & index,
+  const SpeedImageType *speedImage,
+  const LevelSetImageType *output,
+  AxisNodeType *nodesUsed,
+  unsigned int & numberOfNodesUsed,
+  double & solution) const
+{
+  IndexType neighIndex = index;
+
+  PixelType neighValue;
+
+  // just to make sure the index is initialized (really cautious)
+  AxisNodeType node;
+  node.SetIndex( index );
+
+  for ( unsigned int j = 0; j < SetDimension; j++ )
+    {
+    node.SetValue(m_LargeValue);
+
+    // find smallest valued neighbor in this dimension
+    for ( int s = -1; s < 2; s = s + 2 )
+      {
+      neighIndex[j] = index[j] + s;
+
+      // make sure neighIndex is not outside from the image
+      if ( ( neighIndex[j] > m_LastIndex[j] ) ||
+           ( neighIndex[j] < m_StartIndex[j] ) )
+        {
+        continue;
+        }
+
+      neighValue = output->GetPixel(neighIndex);
+
+      // let's find the minimum value given a direction j
+      if ( node.GetValue() > neighValue )
+        {
+        node.SetValue(neighValue);
+        node.SetIndex(neighIndex);
+        }
+      }
+
+    nodesUsed[j] = node;
+    nodesUsed[j].SetAxis(j);
+
+    // reset neighIndex
+    neighIndex[j] = index[j];
+    }
+
+  // sort the local list
+  std::sort(nodesUsed, nodesUsed + SetDimension);
+
+  // solve quadratic equation
+  solution = static_cast< double >( m_LargeValue );
+  numberOfNodesUsed = 0;
+
+  double aa( 0.0 );
+  double bb( 0.0 );
+  double cc( m_InverseSpeed );
+
+  if ( speedImage )
+    {
+    cc = static_cast< double >( speedImage->GetPixel(index)  ) / m_NormalizationFactor;
+    cc = -1.0 * itk::Math::sqr(1.0 / cc);
+    }
+
+  const OutputSpacingType & spacing = output->GetSpacing();
+
+  double discrim;
+
+  for ( unsigned int j = 0; j < SetDimension; j++ )
+    {
+    const double value = static_cast< double >( nodesUsed[j].GetValue() );
+
+    if ( value >= static_cast< double >( m_LargeValue ) || solution < value )
+      {
+      break;
+      }
+
+    const int    axis = nodesUsed[j].GetAxis();
+    // spaceFactor = \frac{1}{spacing[axis]^2}
+    const double spaceFactor = itk::Math::sqr(1.0 / spacing[axis]);
+    aa += spaceFactor;
+    bb += value * spaceFactor;
+    cc += itk::Math::sqr(value) * spaceFactor;
+
+    discrim = itk::Math::sqr(bb) - aa * cc;
+    if ( discrim < 0.0 )
+      {
+      // Discriminant of quadratic eqn. is negative
+      ExceptionObject err(__FILE__, __LINE__);
+      err.SetLocation(ITK_LOCATION);
+      err.SetDescription("Discriminant of quadratic equation is negative");
+      throw err;
+      }
+
+    solution = ( std::sqrt(discrim) + bb ) / aa;
+    numberOfNodesUsed = j + 1;
+    }
+}
+
+template< typename TLevelSet, typename TSpeedImage >
+bool
+FastSweepingImageFilter< TLevelSet, TSpeedImage >
+::UpdateValue(
+  const IndexType & index,
+  const SpeedImageType *speedImage,
+  LevelSetImageType *output)
+{
+  AxisNodeType nodesUsed[SetDimension];
+  unsigned int numberOfNodesUsed;
+  double       solution;
+
+  this->ComputeSolution(index, speedImage, output, nodesUsed, numberOfNodesUsed, solution);
+
+  if ( solution > m_StoppingValue )
+    {
+    return false;
+    }
+
+  // the values only decrease, so that the sweeps terminate
+  const PixelType outputPixel = static_cast< PixelType >( solution );
+  if ( outputPixel < output->GetPixel(index) )
+    {
+    output->SetPixel(index, outputPixel);
+    return true;
+    }
+
+  return false;
+}
+
+template< typename TLevelSet, typename TSpeedImage >
+void
+FastSweepingImageFilter< TLevelSet, TSpeedImage >
+::CollectProcessedPoints(const LevelSetImageType *output)
+{
+  std::vector< NodeType > points;
+  NodeType                node;
+
+  for ( SizeValueType t = 0; t < m_Tiles.size(); t++ )
+    {
+    if ( !m_Tiles[t].Visited )
+      {
+      continue;
+      }
+
+    ImageRegionConstIteratorWithIndex< LevelSetImageType > outIt( output, m_Tiles[t].Region );
+    for (; !outIt.IsAtEnd(); ++outIt )
+      {
+      const PixelType value = outIt.Get();
+      if ( value < m_LargeValue && static_cast< double >( value ) <= m_StoppingValue
+           && m_LabelImage->GetPixel( outIt.GetIndex() ) != AlivePoint )
+        {
+        node.SetValue(value);
+        node.SetIndex( outIt.GetIndex() );
+        points.push_back(node);
+        }
+      }
+    }
+
+  // the order of the tiles and of the pixels in the tiles breaks the ties
+  std::stable_sort( points.begin(), points.end() );
+
+  m_ProcessedPoints = NodeContainer::New();
+  m_ProcessedPoints->Reserve( points.size() );
+  for ( SizeValueType i = 0; i < points.size(); i++ )
+    {
+    m_ProcessedPoints->SetElement(i, points[i]);
+    }
+}
+} // namespace itk
+
+#endif
@@ -0,0 +1,164 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFastSweepingExtensionImageFilter.h"
+#include "itkFastMarchingExtensionImageFilter.h"
+#include "itkImageDuplicator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkTestingMacros.h"
+
+// Extend two auxiliary values from the pixels next to a circle, as the
+// reinitialization of a level set does, and compare the distances and the
+// extended values with the ones of fast marching.
+int itkFastSweepingExtensionImageFilterTest(int, char *[])
+{
+  const unsigned int Dimension = 2;
+
+  typedef itk::Image< float, Dimension >                               ImageType;
+  typedef itk::FastSweepingExtensionImageFilter< ImageType, float, 2 > SweeperType;
+  typedef itk::FastMarchingExtensionImageFilter< ImageType, float, 2 > MarcherType;
+  typedef SweeperType::NodeType                                        NodeType;
+  typedef SweeperType::NodeContainer                                   NodeContainer;
+  typedef SweeperType::AuxValueContainer                               AuxValueContainer;
+  typedef SweeperType::AuxValueVectorType                              AuxValueVectorType;
+
+  ImageType::SizeType size;
+  size[0] = 70;
+  size[1] = 57;
+
+  // the pixels of the band around a circle, with their distance to the circle
+  const double center[Dimension] = { 31.3, 27.8 };
+  const double radius = 12.4;
+
+  NodeContainer::Pointer     trialPoints = NodeContainer::New();
+  AuxValueContainer::Pointer auxTrialValues = AuxValueContainer::New();
+  unsigned int               numberOfTrialPoints = 0;
+  ImageType::IndexType       index;
+  for ( index[1] = 0; index[1] < static_cast< ImageType::IndexValueType >( size[1] ); ++index[1] )
+    {
+    for ( index[0] = 0; index[0] < static_cast< ImageType::IndexValueType >( size[0] ); ++index[0] )
+      {
+      const double dx = index[0] - center[0];
+      const double dy = index[1] - center[1];
+      const double distance = std::sqrt(dx * dx + dy * dy);
+      if ( itk::Math::abs(distance - radius) <= 1.0 )
+        {
+        NodeType node;
+        node.SetIndex(index);
+        node.SetValue( itk::Math::abs(distance - radius) );
+        trialPoints->InsertElement(numberOfTrialPoints, node);
+
+        AuxValueVectorType auxValues;
+        auxValues[0] = dx / distance;
+        auxValues[1] = 5.0 + std::sin( 3.0 * std::atan2(dy, dx) );
+        auxTrialValues->InsertElement(numberOfTrialPoints, auxValues);
+        ++numberOfTrialPoints;
+        }
+      }
+    }
+
+  ImageType::Pointer speedImage = ImageType::New();
+  speedImage->SetRegions(size);
+  speedImage->Allocate();
+  speedImage->FillBuffer(1.0);
+
+  MarcherType::Pointer marcher = MarcherType::New();
+  marcher->SetInput(speedImage);
+  marcher->SetTrialPoints(trialPoints);
+  marcher->SetAuxiliaryTrialValues(auxTrialValues);
+  TRY_EXPECT_NO_EXCEPTION( marcher->Update() );
+
+  SweeperType::Pointer sweeper = SweeperType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( sweeper, FastSweepingExtensionImageFilter, FastSweepingImageFilter );
+
+  sweeper->SetInput(speedImage);
+  sweeper->SetTrialPoints(trialPoints);
+
+  // deliberately cause an exception by not setting AuxTrialValues
+  TRY_EXPECT_EXCEPTION( sweeper->Update() );
+  sweeper->ResetPipeline();
+
+  // deliberately cause an exception by setting AuxTrialValues of the wrong size
+  AuxValueContainer::Pointer wrongSize = AuxValueContainer::New();
+  sweeper->SetAuxiliaryTrialValues(wrongSize);
+  TRY_EXPECT_EXCEPTION( sweeper->Update() );
+  sweeper->ResetPipeline();
+
+  sweeper->SetAuxiliaryTrialValues(auxTrialValues);
+  sweeper->SetTileSize(8);
+
+  ImageType::Pointer singleThreaded[3];
+  for ( itk::ThreadIdType numberOfThreads = 1; numberOfThreads <= 4; numberOfThreads += 3 )
+    {
+    sweeper->SetNumberOfThreads(numberOfThreads);
+    TRY_EXPECT_NO_EXCEPTION( sweeper->Update() );
+
+    ImageType::Pointer outputs[3] = { sweeper->GetOutput(),
+                                      sweeper->GetAuxiliaryImage(0),
+                                      sweeper->GetAuxiliaryImage(1) };
+    ImageType::Pointer references[3] = { marcher->GetOutput(),
+                                         marcher->GetAuxiliaryImage(0),
+                                         marcher->GetAuxiliaryImage(1) };
+
+    for ( unsigned int k = 0; k < 3; ++k )
+      {
+      if ( !singleThreaded[k] )
+        {
+        typedef itk::ImageDuplicator< ImageType > DuplicatorType;
+        DuplicatorType::Pointer duplicator = DuplicatorType::New();
+        duplicator->SetInputImage(outputs[k]);
+        duplicator->Update();
+        singleThreaded[k] = duplicator->GetOutput();
+        }
+
+      double maximumDifference = 0.0;
+      itk::SizeValueType differentValues = 0;
+      itk::ImageRegionConstIterator< ImageType > referenceIt( references[k], references[k]->GetBufferedRegion() );
+      itk::ImageRegionConstIterator< ImageType > singleThreadedIt( singleThreaded[k],
+                                                                   singleThreaded[k]->GetBufferedRegion() );
+      itk::ImageRegionConstIterator< ImageType > outputIt( outputs[k], outputs[k]->GetBufferedRegion() );
+      for (; !outputIt.IsAtEnd(); ++outputIt, ++singleThreadedIt, ++referenceIt )
+        {
+        maximumDifference = std::max( maximumDifference,
+                                      static_cast< double >( itk::Math::abs( outputIt.Get() - referenceIt.Get() ) ) );
+        if ( itk::Math::NotExactlyEquals( outputIt.Get(), singleThreadedIt.Get() ) )
+          {
+          ++differentValues;
+          }
+        }
+
+      std::cout << numberOfThreads << " threads, output " << k
+                << ": largest difference with fast marching " << maximumDifference << std::endl;
+
+      if ( differentValues > 0 )
+        {
+        std::cerr << "Test failed: " << differentValues << " values of output " << k
+                  << " differ from the sweeps with a single thread." << std::endl;
+        return EXIT_FAILURE;
+        }
+      if ( maximumDifference > 1e-4 )
+        {
+        std::cerr << "Test failed: output " << k << " differs from fast marching." << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,219 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFastSweepingImageFilter.h"
+#include "itkFastMarchingImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+// Arrival times from three seeds through a varying speed, on an image with
+// an anisotropic spacing. The sweeps must give the arrival times of fast
+// marching, and must not depend on the number of threads or on the size of
+// the tiles.
+int itkFastSweepingImageFilterTest(int, char *[])
+{
+  const unsigned int Dimension = 3;
+
+  typedef itk::Image< float, Dimension >                        ImageType;
+  typedef itk::FastSweepingImageFilter< ImageType, ImageType >  SweeperType;
+  typedef itk::FastMarchingImageFilter< ImageType, ImageType >  MarcherType;
+  typedef SweeperType::NodeType                                 NodeType;
+  typedef SweeperType::NodeContainer                            NodeContainer;
+
+  ImageType::SizeType size;
+  size[0] = 45;
+  size[1] = 38;
+  size[2] = 30;
+  ImageType::IndexType start;
+  start[0] = -3;
+  start[1] = 5;
+  start[2] = 0;
+  ImageType::RegionType region(start, size);
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.0;
+  spacing[1] = 0.8;
+  spacing[2] = 1.5;
+
+  ImageType::Pointer speedImage = ImageType::New();
+  speedImage->SetRegions(region);
+  speedImage->SetSpacing(spacing);
+  speedImage->Allocate();
+  for ( itk::ImageRegionIteratorWithIndex< ImageType > it( speedImage, region ); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    it.Set( 2.0f * ( 1.0f + 0.5f * std::sin(0.3f * index[0]) * std::cos(0.2f * index[1] + 0.1f * index[2]) ) );
+    }
+
+  NodeContainer::Pointer trialPoints = NodeContainer::New();
+  const int seeds[3][Dimension] = { { 5, 12, 4 }, { 30, 30, 20 }, { 38, 9, 27 } };
+  const float seedValues[3] = { 0.0f, 0.0f, 1.5f };
+  for ( unsigned int s = 0; s < 3; ++s )
+    {
+    NodeType node;
+    ImageType::IndexType index;
+    for ( unsigned int d = 0; d < Dimension; ++d )
+      {
+      index[d] = seeds[s][d];
+      }
+    node.SetIndex(index);
+    node.SetValue(seedValues[s]);
+    trialPoints->InsertElement(s, node);
+    }
+
+  // this node is out of range
+  NodeType outOfRange;
+  ImageType::IndexType outOfRangeIndex;
+  outOfRangeIndex.Fill(100);
+  outOfRange.SetIndex(outOfRangeIndex);
+  outOfRange.SetValue(0.0);
+  trialPoints->InsertElement(3, outOfRange);
+
+  MarcherType::Pointer marcher = MarcherType::New();
+  marcher->SetInput(speedImage);
+  marcher->SetTrialPoints(trialPoints);
+  marcher->SetNormalizationFactor(2.0);
+  TRY_EXPECT_NO_EXCEPTION( marcher->Update() );
+  ImageType::Pointer reference = marcher->GetOutput();
+
+  SweeperType::Pointer sweeper = SweeperType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( sweeper, FastSweepingImageFilter, ImageToImageFilter );
+
+  sweeper->SetInput(speedImage);
+  sweeper->SetTrialPoints(trialPoints);
+
+  sweeper->SetNormalizationFactor(0.0);
+  TRY_EXPECT_EXCEPTION( sweeper->Update() );
+  sweeper->ResetPipeline();
+  sweeper->SetNormalizationFactor(2.0);
+  TEST_SET_GET_VALUE( 2.0, sweeper->GetNormalizationFactor() );
+
+  TEST_SET_GET_VALUE( 16, sweeper->GetTileSize() );
+  TEST_SET_GET_VALUE( false, sweeper->GetCollectPoints() );
+
+  const itk::SizeValueType tileSizes[2] = { 16, 5 };
+  ImageType::Pointer singleThreaded;
+  for ( unsigned int t = 0; t < 2; ++t )
+    {
+    sweeper->SetTileSize(tileSizes[t]);
+    TEST_SET_GET_VALUE( tileSizes[t], sweeper->GetTileSize() );
+
+    for ( itk::ThreadIdType numberOfThreads = 1; numberOfThreads <= 3; numberOfThreads += 2 )
+      {
+      sweeper->SetNumberOfThreads(numberOfThreads);
+      TRY_EXPECT_NO_EXCEPTION( sweeper->Update() );
+
+      ImageType::Pointer output = sweeper->GetOutput();
+      if ( !singleThreaded )
+        {
+        singleThreaded = output;
+        singleThreaded->DisconnectPipeline();
+        }
+
+      double maximumDifference = 0.0;
+      itk::SizeValueType differentValues = 0;
+      itk::ImageRegionConstIterator< ImageType > referenceIt( reference, region );
+      itk::ImageRegionConstIterator< ImageType > singleThreadedIt( singleThreaded, region );
+      itk::ImageRegionConstIterator< ImageType > outputIt( output, region );
+      for (; !outputIt.IsAtEnd(); ++outputIt, ++singleThreadedIt, ++referenceIt )
+        {
+        maximumDifference = std::max( maximumDifference,
+                                      itk::Math::abs( outputIt.Get() - referenceIt.Get() )
+                                      / ( 1.0 + referenceIt.Get() ) );
+        if ( itk::Math::NotExactlyEquals( outputIt.Get(), singleThreadedIt.Get() ) )
+          {
+          ++differentValues;
+          }
+        }
+
+      std::cout << "Tile size " << tileSizes[t] << ", " << numberOfThreads
+                << " threads: largest relative difference with fast marching " << maximumDifference << std::endl;
+
+      if ( differentValues > 0 )
+        {
+        std::cerr << "Test failed: " << differentValues << " values differ from the sweeps with a single thread"
+                  << " and tiles of " << tileSizes[0] << " pixels." << std::endl;
+        return EXIT_FAILURE;
+        }
+      if ( maximumDifference > 1e-5 )
+        {
+        std::cerr << "Test failed: the sweeps differ from fast marching." << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // Narrowband
+  const double stoppingValue = 6.0;
+  marcher->SetStoppingValue(stoppingValue);
+  marcher->CollectPointsOn();
+  TRY_EXPECT_NO_EXCEPTION( marcher->Update() );
+
+  sweeper->SetStoppingValue(stoppingValue);
+  TEST_SET_GET_VALUE( stoppingValue, sweeper->GetStoppingValue() );
+  sweeper->CollectPointsOn();
+  TEST_SET_GET_VALUE( true, sweeper->GetCollectPoints() );
+  sweeper->SetNumberOfThreads(3);
+  TRY_EXPECT_NO_EXCEPTION( sweeper->Update() );
+
+  ImageType::Pointer     output = sweeper->GetOutput();
+  NodeContainer::Pointer processedPoints = sweeper->GetProcessedPoints();
+  std::cout << processedPoints->Size() << " points processed by the sweeps, "
+            << marcher->GetProcessedPoints()->Size() << " by fast marching" << std::endl;
+
+  itk::SizeValueType pointsInBand = 0;
+  for ( itk::ImageRegionConstIteratorWithIndex< ImageType > it( output, region ); !it.IsAtEnd(); ++it )
+    {
+    const float value = it.Get();
+    const float referenceValue = reference->GetPixel( it.GetIndex() );
+    if ( value <= stoppingValue )
+      {
+      ++pointsInBand;
+      if ( itk::Math::abs( value - referenceValue ) > 1e-5 * ( 1.0 + referenceValue ) )
+        {
+        std::cerr << "Test failed: the value at " << it.GetIndex() << " is " << value << " instead of "
+                  << referenceValue << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    else if ( referenceValue < stoppingValue - 1e-4 )
+      {
+      std::cerr << "Test failed: the value at " << it.GetIndex() << " is not computed." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  if ( processedPoints->Size() != pointsInBand )
+    {
+    std::cerr << "Test failed: " << processedPoints->Size() << " points processed instead of "
+              << pointsInBand << std::endl;
+    return EXIT_FAILURE;
+    }
+  for ( unsigned int i = 0; i < processedPoints->Size(); ++i )
+    {
+    const NodeType & node = processedPoints->ElementAt(i);
+    if ( itk::Math::NotExactlyEquals( node.GetValue(), output->GetPixel( node.GetIndex() ) )
+         || ( i > 0 && node.GetValue() < processedPoints->ElementAt(i - 1).GetValue() ) )
+      {
+      std::cerr << "Test failed: the processed points are not sorted by value." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
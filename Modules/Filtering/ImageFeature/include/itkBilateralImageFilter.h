@@ -52,6 +52,11 @@ namespace itk
  * Manduchi (Bilateral Filtering for Gray and ColorImages. IEEE
  * ICCV. 1998.)
  *
+ * The cost of this filter grows with the size of the domain kernel. For
+ * large domain sigmas, PermutohedralBilateralImageFilter computes a fast
+ * approximation whose cost does not depend on the sigmas.
+ *
+ * \sa PermutohedralBilateralImageFilter
  * \sa GaussianOperator
  * \sa RecursiveGaussianImageFilter
  * \sa DiscreteGaussianImageFilter
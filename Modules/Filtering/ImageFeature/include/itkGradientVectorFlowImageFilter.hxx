@@ -19,6 +19,8 @@
 #define itkGradientVectorFlowImageFilter_hxx
 #include "itkGradientVectorFlowImageFilter.h"
 #include "itkImageAlgorithm.h"
+#include "itkImageRegionSplitterBase.h"
+#include "vnl/algo/vnl_svd.h"
 
 namespace itk
 {
@@ -34,6 +36,16 @@ GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
     {
     m_Steps[i] = 1.0;
     }
+
+  m_UseMultigridSolver = false;
+  m_MaximumNumberOfVCycles = 20;
+  m_NumberOfSmoothingIterations = 2;
+  m_Tolerance = 1e-6;
+  m_ElapsedVCycles = 0;
+  m_RelativeResidual = 0.0;
+  m_CurrentOperation = SmoothEvenPixels;
+  m_CurrentLevel = 0;
+  m_NumberOfPieces = 0;
 }
 
 template< typename TInputImage, typename TOutputImage, typename TInternalPixel >
@@ -48,6 +60,12 @@ GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
 
   output->Allocate();
 
+  if ( m_UseMultigridSolver )
+    {
+    this->SolveMultigrid();
+    return;
+    }
+
   this->InitInterImage();
 
 /*
@@ -271,6 +289,777 @@ GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
     }
 }
 
+/*
+ * Computes the steady state of the diffusion, the solution of
+ * b v - mu Laplacian(v) = c for each component. Each component has its own
+ * conjugate gradients, preconditioned by a V-cycle of a cell centered
+ * geometric multigrid. The components share the operator, so they are
+ * smoothed, restricted and prolonged together.
+ */
+template< typename TInputImage, typename TOutputImage, typename TInternalPixel >
+void
+GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
+::SolveMultigrid()
+{
+  this->InitializeMultigrid();
+
+  const MultigridLevel & finest = m_Levels[0];
+  const SizeValueType    numberOfPixels = finest.Region.GetNumberOfPixels();
+
+  double rhsNorm = 0.0;
+  const InternalVectorType *rhs = finest.Rhs->GetBufferPointer();
+  for ( SizeValueType n = 0; n < numberOfPixels; ++n )
+    {
+    rhsNorm += rhs[n].GetSquaredNorm();
+    }
+  rhsNorm = std::sqrt(rhsNorm);
+
+  // The right hand side of the finest level is replaced by the residual,
+  // which is the right hand side of the V-cycles
+  this->ExecuteMultigridOperation(ComputeInitialResidual, 0);
+  ComponentSumsType residualNorms = this->SumOverThreads();
+
+  ComponentSumsType previousRho;
+  previousRho.Fill(0.0);
+  m_ElapsedVCycles = 0;
+  while ( true )
+    {
+    double residualNorm = 0.0;
+    for ( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      residualNorm += residualNorms[i];
+      }
+    residualNorm = std::sqrt(residualNorm);
+    m_RelativeResidual = rhsNorm > 0.0 ? residualNorm / rhsNorm : residualNorm;
+
+    if ( m_RelativeResidual <= m_Tolerance || m_ElapsedVCycles >= m_MaximumNumberOfVCycles )
+      {
+      break;
+      }
+
+    finest.V->FillBuffer( InternalVectorType( NumericTraits< InternalPixelType >::ZeroValue() ) );
+    this->VCycle(0);
+    ++m_ElapsedVCycles;
+
+    this->ExecuteMultigridOperation(DotResidualAndCorrection, 0);
+    const ComponentSumsType rho = this->SumOverThreads();
+    for ( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      m_Beta[i] = ( m_ElapsedVCycles > 1 && previousRho[i] > 0.0 ) ? rho[i] / previousRho[i] : 0.0;
+      }
+    this->ExecuteMultigridOperation(UpdateDirection, 0);
+
+    this->ExecuteMultigridOperation(ApplyOperatorToDirection, 0);
+    const ComponentSumsType sigma = this->SumOverThreads();
+    for ( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      m_Alpha[i] = sigma[i] > 0.0 ? rho[i] / sigma[i] : 0.0;
+      }
+    this->ExecuteMultigridOperation(UpdateSolution, 0);
+    residualNorms = this->SumOverThreads();
+
+    previousRho = rho;
+    this->UpdateProgress( static_cast< float >( m_ElapsedVCycles ) / m_MaximumNumberOfVCycles );
+    }
+
+  typedef typename OutputImageType::PixelType::ValueType OutputValueType;
+
+  const InternalVectorType *v = m_Solution->GetBufferPointer();
+  OutputImageIterator       outputIt( this->GetOutput(), this->GetOutput()->GetBufferedRegion() );
+  for ( outputIt.GoToBegin(); !outputIt.IsAtEnd(); ++outputIt, ++v )
+    {
+    typename OutputImageType::PixelType value;
+    for ( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      value[i] = static_cast< OutputValueType >( ( *v )[i] );
+      }
+    outputIt.Set(value);
+    }
+
+  m_Levels.clear();
+  m_Solution = ITK_NULLPTR;
+  m_Direction = ITK_NULLPTR;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TInternalPixel >
+void
+GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
+::InitializeMultigrid()
+{
+  m_Levels.clear();
+
+  const RegionType & region = this->GetInput()->GetLargestPossibleRegion();
+
+  // The finest level has b and c as the right hand side (eqn 15), and the
+  // input is the initial guess of the solution. The weights of the
+  // neighbors are scaled by the steps, as in the explicit scheme, and by
+  // the image spacing when the Laplacian filter uses it. The component
+  // images of the explicit scheme have a unit spacing, so only the
+  // multigrid solver takes the spacing into account.
+  double noiseLevel = m_NoiseLevel;
+  for ( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    noiseLevel /= m_Steps[d];
+    }
+  const typename InputImageType::SpacingType & spacing = this->GetInput()->GetSpacing();
+
+  MultigridLevel finest = MultigridLevel();
+  finest.Region.SetSize( region.GetSize() );
+  for ( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    finest.Coarsened[d] = false;
+    finest.Weights[d] = noiseLevel;
+    if ( m_LaplacianFilter->GetUseImageSpacing() )
+      {
+      finest.Weights[d] /= spacing[d] * spacing[d];
+      }
+    }
+  m_Levels.push_back(finest);
+
+  while ( true )
+    {
+    MultigridLevel & level = m_Levels.back();
+
+    OffsetValueType stride = 1;
+    for ( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      level.Strides[d] = stride;
+      stride *= level.Region.GetSize(d);
+      }
+
+    level.B = InternalImageType::New();
+    level.B->SetRegions(level.Region);
+    level.B->Allocate();
+    level.V = InternalVectorImageType::New();
+    level.V->SetRegions(level.Region);
+    level.V->Allocate();
+    level.Rhs = InternalVectorImageType::New();
+    level.Rhs->SetRegions(level.Region);
+    level.Rhs->Allocate();
+    level.Residual = InternalVectorImageType::New();
+    level.Residual->SetRegions(level.Region);
+    level.Residual->Allocate();
+
+    if ( m_Levels.size() == 1 )
+      {
+      m_Solution = InternalVectorImageType::New();
+      m_Solution->SetRegions(level.Region);
+      m_Solution->Allocate();
+      m_Direction = InternalVectorImageType::New();
+      m_Direction->SetRegions(level.Region);
+      m_Direction->Allocate(true);
+
+      InternalPixelType * b = level.B->GetBufferPointer();
+      InternalVectorType *v = m_Solution->GetBufferPointer();
+      InternalVectorType *c = level.Rhs->GetBufferPointer();
+
+      InputImageConstIterator inputIt( this->GetInput(), region );
+      for ( inputIt.GoToBegin(); !inputIt.IsAtEnd(); ++inputIt, ++b, ++v, ++c )
+        {
+        const PixelType f = inputIt.Get();
+        double          magnitude = 0.0;
+        for ( unsigned int i = 0; i < ImageDimension; i++ )
+          {
+          magnitude += static_cast< double >( f[i] ) * f[i];
+          }
+        *b = static_cast< InternalPixelType >( magnitude );
+        for ( unsigned int i = 0; i < ImageDimension; i++ )
+          {
+          ( *v )[i] = static_cast< InternalPixelType >( f[i] );
+          ( *c )[i] = static_cast< InternalPixelType >( magnitude * f[i] );
+          }
+        }
+      }
+    else
+      {
+      this->ExecuteMultigridOperation( RestrictCoefficients, static_cast< unsigned int >( m_Levels.size() - 1 ) );
+      }
+
+    // Halve the dimensions larger than 2, until the coarsest level is
+    // small enough to be solved directly
+    MultigridLevel coarse = MultigridLevel();
+    SizeType       size;
+    bool           coarsened = false;
+    for ( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      const SizeValueType fineSize = m_Levels.back().Region.GetSize(d);
+      coarse.Coarsened[d] = fineSize > 2;
+      size[d] = coarse.Coarsened[d] ? ( fineSize + 1 ) / 2 : fineSize;
+      coarse.Weights[d] = m_Levels.back().Weights[d] / ( coarse.Coarsened[d] ? 4.0 : 1.0 );
+      coarsened = coarsened || coarse.Coarsened[d];
+      }
+    if ( !coarsened )
+      {
+      break;
+      }
+    coarse.Region.SetSize(size);
+    m_Levels.push_back(coarse);
+    }
+
+  // The coarsest level is solved with the pseudo-inverse of its operator,
+  // which also handles the pixels without any edge around.
+  const MultigridLevel &    coarsest = m_Levels.back();
+  const unsigned int        numberOfPixels = static_cast< unsigned int >( coarsest.Region.GetNumberOfPixels() );
+  const InternalPixelType * b = coarsest.B->GetBufferPointer();
+
+  vnl_matrix< double > A(numberOfPixels, numberOfPixels, 0.0);
+  for ( unsigned int n = 0; n < numberOfPixels; ++n )
+    {
+    const IndexType index = coarsest.B->ComputeIndex(n);
+    A(n, n) = b[n];
+    for ( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      if ( index[d] > 0 )
+        {
+        A(n, n - coarsest.Strides[d]) -= coarsest.Weights[d];
+        A(n, n) += coarsest.Weights[d];
+        }
+      if ( index[d] + 1 < static_cast< IndexValueType >( coarsest.Region.GetSize(d) ) )
+        {
+        A(n, n + coarsest.Strides[d]) -= coarsest.Weights[d];
+        A(n, n) += coarsest.Weights[d];
+        }
+      }
+    }
+  vnl_svd< double > svd(A);
+  svd.zero_out_relative(1e-12);
+  m_CoarsestInverse = svd.pinverse();
+}
+
+template< typename TInputImage, typename TOutputImage, typename TInternalPixel >
+void
+GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
+::VCycle(unsigned int level)
+{
+  if ( level + 1 == m_Levels.size() )
+    {
+    this->SolveCoarsest();
+    return;
+    }
+
+  for ( unsigned int i = 0; i < m_NumberOfSmoothingIterations; i++ )
+    {
+    this->ExecuteMultigridOperation(SmoothEvenPixels, level);
+    this->ExecuteMultigridOperation(SmoothOddPixels, level);
+    }
+
+  this->ExecuteMultigridOperation(ComputeResidual, level);
+  this->ExecuteMultigridOperation(RestrictResidual, level + 1);
+  this->VCycle(level + 1);
+  this->ExecuteMultigridOperation(ProlongCorrection, level);
+
+  for ( unsigned int i = 0; i < m_NumberOfSmoothingIterations; i++ )
+    {
+    this->ExecuteMultigridOperation(SmoothOddPixels, level);
+    this->ExecuteMultigridOperation(SmoothEvenPixels, level);
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TInternalPixel >
+void
+GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
+::SolveCoarsest()
+{
+  const MultigridLevel &     coarsest = m_Levels.back();
+  const unsigned int         numberOfPixels = m_CoarsestInverse.rows();
+  const InternalVectorType * rhs = coarsest.Rhs->GetBufferPointer();
+  InternalVectorType *       v = coarsest.V->GetBufferPointer();
+
+  for ( unsigned int n = 0; n < numberOfPixels; ++n )
+    {
+    for ( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      double value = 0.0;
+      for ( unsigned int m = 0; m < numberOfPixels; ++m )
+        {
+        value += m_CoarsestInverse(n, m) * rhs[m][i];
+        }
+      v[n][i] = static_cast< InternalPixelType >( value );
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TInternalPixel >
+void
+GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
+::ExecuteMultigridOperation(MultigridOperationType operation, unsigned int level)
+{
+  m_CurrentOperation = operation;
+  m_CurrentLevel = level;
+
+  MultiThreader *multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfThreads( this->GetNumberOfThreads() );
+  m_NumberOfPieces = this->GetImageRegionSplitter()->GetNumberOfSplits( m_Levels[level].Region,
+                                                                        multiThreader->GetNumberOfThreads() );
+  m_ThreadSums.assign( m_NumberOfPieces, ComponentSumsType(0.0) );
+
+  multiThreader->SetSingleMethod(this->MultigridThreaderCallback, this);
+  multiThreader->SingleMethodExecute();
+}
+
+template< typename TInputImage, typename TOutputImage, typename TInternalPixel >
+ITK_THREAD_RETURN_TYPE
+GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
+::MultigridThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self *filter = static_cast< Self * >( info->UserData );
+
+  const ThreadIdType threadId = info->ThreadID;
+  if ( threadId < filter->m_NumberOfPieces )
+    {
+    RegionType region = filter->m_Levels[filter->m_CurrentLevel].Region;
+    filter->GetImageRegionSplitter()->GetSplit(threadId, filter->m_NumberOfPieces, region);
+
+    switch ( filter->m_CurrentOperation )
+      {
+      case SmoothEvenPixels:
+        filter->ThreadedSmooth(region, 0);
+        break;
+      case SmoothOddPixels:
+        filter->ThreadedSmooth(region, 1);
+        break;
+      case ComputeResidual:
+        filter->ThreadedResidual(region, threadId);
+        break;
+      case RestrictCoefficients:
+        filter->ThreadedRestrictCoefficients(region);
+        break;
+      case RestrictResidual:
+        filter->ThreadedRestrictResidual(region);
+        break;
+      case ProlongCorrection:
+        filter->ThreadedProlong(region);
+        break;
+      default:
+        filter->ThreadedConjugateGradient(region, threadId);
+        break;
+      }
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TInternalPixel >
+void
+GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
+::NeighborSum(const MultigridLevel & level, const InternalVectorType *v, OffsetValueType offset,
+              const IndexType & index, InternalVectorType & sum, double & diagonal) const
+{
+  // The missing neighbors of the pixels on the border have the value of the
+  // pixel, so they do not contribute to the Laplacian (zero flux)
+  diagonal = level.B->GetBufferPointer()[offset];
+  sum.Fill(NumericTraits< InternalPixelType >::ZeroValue());
+  for ( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    const InternalPixelType weight = static_cast< InternalPixelType >( level.Weights[d] );
+    if ( index[d] > 0 )
+      {
+      const InternalVectorType & neighbor = v[offset - level.Strides[d]];
+      for ( unsigned int i = 0; i < ImageDimension; i++ )
+        {
+        sum[i] += weight * neighbor[i];
+        }
+      diagonal += level.Weights[d];
+      }
+    if ( index[d] + 1 < static_cast< IndexValueType >( level.Region.GetSize(d) ) )
+      {
+      const InternalVectorType & neighbor = v[offset + level.Strides[d]];
+      for ( unsigned int i = 0; i < ImageDimension; i++ )
+        {
+        sum[i] += weight * neighbor[i];
+        }
+      diagonal += level.Weights[d];
+      }
+    }
+}
+
+/*
+ * Red-black Gauss-Seidel iteration: the pixels of one parity only depend
+ * on the pixels of the other parity, so they are updated in place by all
+ * the threads.
+ */
+template< typename TInputImage, typename TOutputImage, typename TInternalPixel >
+void
+GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
+::ThreadedSmooth(const RegionType & region, unsigned int parity)
+{
+  const MultigridLevel &     level = m_Levels[m_CurrentLevel];
+  InternalVectorType *       v = level.V->GetBufferPointer();
+  const InternalVectorType * rhs = level.Rhs->GetBufferPointer();
+
+  const IndexValueType begin = region.GetIndex(0);
+  const IndexValueType end = begin + static_cast< IndexValueType >( region.GetSize(0) );
+
+  RegionType lineRegion = region;
+  lineRegion.SetSize(0, 1);
+  for ( ImageRegionConstIteratorWithIndex< InternalImageType > lineIt( level.B, lineRegion ); !lineIt.IsAtEnd(); ++lineIt )
+    {
+    IndexType             index = lineIt.GetIndex();
+    const OffsetValueType lineOffset = level.B->ComputeOffset(index) - begin;
+
+    IndexValueType indexSum = 0;
+    for ( unsigned int d = 1; d < ImageDimension; d++ )
+      {
+      indexSum += index[d];
+      }
+
+    for ( index[0] = begin + ( ( parity + begin + indexSum ) & 1 ); index[0] < end; index[0] += 2 )
+      {
+      const OffsetValueType offset = lineOffset + index[0];
+
+      InternalVectorType neighbors;
+      double             diagonal;
+      this->NeighborSum(level, v, offset, index, neighbors, diagonal);
+      if ( diagonal > 0.0 )
+        {
+        for ( unsigned int i = 0; i < ImageDimension; i++ )
+          {
+          v[offset][i] = static_cast< InternalPixelType >( ( rhs[offset][i] + neighbors[i] ) / diagonal );
+          }
+        }
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TInternalPixel >
+void
+GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
+::ThreadedResidual(const RegionType & region, ThreadIdType threadId)
+{
+  const MultigridLevel &     level = m_Levels[m_CurrentLevel];
+  const InternalVectorType * v = level.V->GetBufferPointer();
+  const InternalVectorType * rhs = level.Rhs->GetBufferPointer();
+  InternalVectorType *       residual = level.Residual->GetBufferPointer();
+
+  ComponentSumsType norms(0.0);
+  for ( ImageRegionConstIteratorWithIndex< InternalImageType > it( level.B, region ); !it.IsAtEnd(); ++it )
+    {
+    const IndexType       index = it.GetIndex();
+    const OffsetValueType offset = level.B->ComputeOffset(index);
+
+    InternalVectorType neighbors;
+    double             diagonal;
+    this->NeighborSum(level, v, offset, index, neighbors, diagonal);
+    for ( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      const double value = rhs[offset][i] + neighbors[i] - diagonal * v[offset][i];
+      residual[offset][i] = static_cast< InternalPixelType >( value );
+      norms[i] += value * value;
+      }
+    }
+  m_ThreadSums[threadId] = norms;
+}
+
+/*
+ * Each pixel of the coarse level has the average of the coefficients b of
+ * its children on the fine level.
+ */
+template< typename TInputImage, typename TOutputImage, typename TInternalPixel >
+void
+GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
+::ThreadedRestrictCoefficients(const RegionType & region)
+{
+  const MultigridLevel &    coarse = m_Levels[m_CurrentLevel];
+  const MultigridLevel &    fine = m_Levels[m_CurrentLevel - 1];
+  const InternalPixelType * fineB = fine.B->GetBufferPointer();
+  InternalPixelType *       coarseB = coarse.B->GetBufferPointer();
+
+  for ( ImageRegionConstIteratorWithIndex< InternalImageType > it( coarse.B, region ); !it.IsAtEnd(); ++it )
+    {
+    const IndexType index = it.GetIndex();
+
+    double       b = 0.0;
+    unsigned int numberOfChildren = 0;
+    for ( unsigned int corner = 0; corner < ( 1u << ImageDimension ); ++corner )
+      {
+      OffsetValueType childOffset = 0;
+      bool            inside = true;
+      for ( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        const unsigned int   bit = ( corner >> d ) & 1;
+        const IndexValueType child = coarse.Coarsened[d] ? 2 * index[d] + bit : index[d];
+        inside = inside && ( coarse.Coarsened[d] || bit == 0 )
+                 && child < static_cast< IndexValueType >( fine.Region.GetSize(d) );
+        childOffset += child * fine.Strides[d];
+        }
+      if ( inside )
+        {
+        b += fineB[childOffset];
+        ++numberOfChildren;
+        }
+      }
+    coarseB[coarse.B->ComputeOffset(index)] = static_cast< InternalPixelType >( b / numberOfChildren );
+    }
+}
+
+/*
+ * The residual is restricted with the transpose of the prolongation,
+ * normalized by the ratio of the volumes of the pixels, and becomes the
+ * right hand side of the correction computed on the coarse level.
+ */
+template< typename TInputImage, typename TOutputImage, typename TInternalPixel >
+void
+GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
+::ThreadedRestrictResidual(const RegionType & region)
+{
+  const MultigridLevel &     coarse = m_Levels[m_CurrentLevel];
+  const MultigridLevel &     fine = m_Levels[m_CurrentLevel - 1];
+  const InternalVectorType * fineResidual = fine.Residual->GetBufferPointer();
+  InternalVectorType *       rhs = coarse.Rhs->GetBufferPointer();
+  InternalVectorType *       v = coarse.V->GetBufferPointer();
+
+  for ( ImageRegionConstIteratorWithIndex< InternalImageType > it( coarse.B, region ); !it.IsAtEnd(); ++it )
+    {
+    const IndexType       index = it.GetIndex();
+    const OffsetValueType offset = coarse.B->ComputeOffset(index);
+
+    // The fine pixels interpolated from this coarse pixel, with their
+    // weights, along each dimension
+    OffsetValueType fineOffsets[ImageDimension][4];
+    double          fineWeights[ImageDimension][4];
+    unsigned int    numberOfFinePixels[ImageDimension];
+    for ( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      numberOfFinePixels[d] = 0;
+      if ( !coarse.Coarsened[d] )
+        {
+        fineOffsets[d][0] = index[d] * fine.Strides[d];
+        fineWeights[d][0] = 1.0;
+        numberOfFinePixels[d] = 1;
+        continue;
+        }
+      const IndexValueType fineSize = static_cast< IndexValueType >( fine.Region.GetSize(d) );
+      const IndexValueType coarseSize = static_cast< IndexValueType >( coarse.Region.GetSize(d) );
+      for ( IndexValueType i = 2 * index[d] - 1; i <= 2 * index[d] + 2; ++i )
+        {
+        if ( i < 0 || i >= fineSize )
+          {
+          continue;
+          }
+        const IndexValueType closest = i / 2;
+        IndexValueType       neighbor = ( i & 1 ) ? closest + 1 : closest - 1;
+        if ( neighbor < 0 || neighbor >= coarseSize )
+          {
+          neighbor = closest;
+          }
+        const double weight = ( closest == index[d] ? 0.375 : 0.0 ) + ( neighbor == index[d] ? 0.125 : 0.0 );
+        if ( weight > 0.0 )
+          {
+          fineOffsets[d][numberOfFinePixels[d]] = i * fine.Strides[d];
+          fineWeights[d][numberOfFinePixels[d]] = weight;
+          ++numberOfFinePixels[d];
+          }
+        }
+      }
+
+    Vector< double, ImageDimension > sum;
+    sum.Fill(0.0);
+    unsigned int position[ImageDimension];
+    std::fill(position, position + ImageDimension, 0u);
+    while ( true )
+      {
+      double          weight = 1.0;
+      OffsetValueType fineOffset = 0;
+      for ( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        weight *= fineWeights[d][position[d]];
+        fineOffset += fineOffsets[d][position[d]];
+        }
+      for ( unsigned int i = 0; i < ImageDimension; i++ )
+        {
+        sum[i] += weight * fineResidual[fineOffset][i];
+        }
+
+      unsigned int d = 0;
+      while ( d < ImageDimension && ++position[d] == numberOfFinePixels[d] )
+        {
+        position[d++] = 0;
+        }
+      if ( d == ImageDimension )
+        {
+        break;
+        }
+      }
+
+    for ( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      rhs[offset][i] = static_cast< InternalPixelType >( sum[i] );
+      }
+    v[offset].Fill(NumericTraits< InternalPixelType >::ZeroValue());
+    }
+}
+
+/*
+ * Adds the correction of the coarse level to the fine level, with a
+ * multilinear interpolation between the centers of the coarse pixels.
+ */
+template< typename TInputImage, typename TOutputImage, typename TInternalPixel >
+void
+GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
+::ThreadedProlong(const RegionType & region)
+{
+  const MultigridLevel &     fine = m_Levels[m_CurrentLevel];
+  const MultigridLevel &     coarse = m_Levels[m_CurrentLevel + 1];
+  InternalVectorType *       v = fine.V->GetBufferPointer();
+  const InternalVectorType * correction = coarse.V->GetBufferPointer();
+
+  for ( ImageRegionConstIteratorWithIndex< InternalImageType > it( fine.B, region ); !it.IsAtEnd(); ++it )
+    {
+    const IndexType       index = it.GetIndex();
+    const OffsetValueType offset = fine.B->ComputeOffset(index);
+
+    // The closest coarse pixel, and its neighbor on the side of the fine
+    // pixel, along each dimension
+    IndexValueType closest[ImageDimension];
+    IndexValueType neighbor[ImageDimension];
+    for ( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      if ( coarse.Coarsened[d] )
+        {
+        closest[d] = index[d] / 2;
+        neighbor[d] = ( index[d] & 1 ) ? closest[d] + 1 : closest[d] - 1;
+        if ( neighbor[d] < 0 || neighbor[d] >= static_cast< IndexValueType >( coarse.Region.GetSize(d) ) )
+          {
+          neighbor[d] = closest[d];
+          }
+        }
+      else
+        {
+        closest[d] = index[d];
+        neighbor[d] = index[d];
+        }
+      }
+
+    for ( unsigned int corner = 0; corner < ( 1u << ImageDimension ); ++corner )
+      {
+      double          weight = 1.0;
+      OffsetValueType cornerOffset = 0;
+      for ( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        const bool bit = ( corner >> d ) & 1;
+        if ( coarse.Coarsened[d] )
+          {
+          weight *= bit ? 0.25 : 0.75;
+          }
+        else if ( bit )
+          {
+          weight = 0.0;
+          }
+        cornerOffset += ( bit ? neighbor[d] : closest[d] ) * coarse.Strides[d];
+        }
+      if ( weight > 0.0 )
+        {
+        for ( unsigned int i = 0; i < ImageDimension; i++ )
+          {
+          v[offset][i] += static_cast< InternalPixelType >( weight * correction[cornerOffset][i] );
+          }
+        }
+      }
+    }
+}
+
+/*
+ * The operations of the conjugate gradients on the finest level: the
+ * residual is in the right hand side of the level, the preconditioned
+ * residual in the solution of the V-cycle, and the product of the operator
+ * and the direction in the residual of the level.
+ */
+template< typename TInputImage, typename TOutputImage, typename TInternalPixel >
+void
+GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
+::ThreadedConjugateGradient(const RegionType & region, ThreadIdType threadId)
+{
+  const MultigridLevel &     finest = m_Levels[0];
+  InternalVectorType *       x = m_Solution->GetBufferPointer();
+  InternalVectorType *       p = m_Direction->GetBufferPointer();
+  InternalVectorType *       r = finest.Rhs->GetBufferPointer();
+  const InternalVectorType * z = finest.V->GetBufferPointer();
+  InternalVectorType *       q = finest.Residual->GetBufferPointer();
+  ComponentSumsType &        sums = m_ThreadSums[threadId];
+
+  if ( m_CurrentOperation == ComputeInitialResidual || m_CurrentOperation == ApplyOperatorToDirection )
+    {
+    const bool                 initial = ( m_CurrentOperation == ComputeInitialResidual );
+    const InternalVectorType * v = initial ? x : p;
+    for ( ImageRegionConstIteratorWithIndex< InternalImageType > it( finest.B, region ); !it.IsAtEnd(); ++it )
+      {
+      const IndexType       index = it.GetIndex();
+      const OffsetValueType offset = finest.B->ComputeOffset(index);
+
+      InternalVectorType neighbors;
+      double             diagonal;
+      this->NeighborSum(finest, v, offset, index, neighbors, diagonal);
+      for ( unsigned int i = 0; i < ImageDimension; i++ )
+        {
+        const double product = diagonal * v[offset][i] - neighbors[i];
+        if ( initial )
+          {
+          r[offset][i] = static_cast< InternalPixelType >( r[offset][i] - product );
+          sums[i] += static_cast< double >( r[offset][i] ) * r[offset][i];
+          }
+        else
+          {
+          q[offset][i] = static_cast< InternalPixelType >( product );
+          sums[i] += p[offset][i] * product;
+          }
+        }
+      }
+    return;
+    }
+
+  // The pieces of the region are contiguous in the buffers
+  const OffsetValueType begin = finest.B->ComputeOffset( region.GetIndex() );
+  const OffsetValueType end = begin + static_cast< OffsetValueType >( region.GetNumberOfPixels() );
+  switch ( m_CurrentOperation )
+    {
+    case DotResidualAndCorrection:
+      for ( OffsetValueType n = begin; n < end; ++n )
+        {
+        for ( unsigned int i = 0; i < ImageDimension; i++ )
+          {
+          sums[i] += static_cast< double >( r[n][i] ) * z[n][i];
+          }
+        }
+      break;
+    case UpdateDirection:
+      for ( OffsetValueType n = begin; n < end; ++n )
+        {
+        for ( unsigned int i = 0; i < ImageDimension; i++ )
+          {
+          p[n][i] = static_cast< InternalPixelType >( z[n][i] + m_Beta[i] * p[n][i] );
+          }
+        }
+      break;
+    case UpdateSolution:
+      for ( OffsetValueType n = begin; n < end; ++n )
+        {
+        for ( unsigned int i = 0; i < ImageDimension; i++ )
+          {
+          x[n][i] = static_cast< InternalPixelType >( x[n][i] + m_Alpha[i] * p[n][i] );
+          r[n][i] = static_cast< InternalPixelType >( r[n][i] - m_Alpha[i] * q[n][i] );
+          sums[i] += static_cast< double >( r[n][i] ) * r[n][i];
+          }
+        }
+      break;
+    default:
+      break;
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TInternalPixel >
+typename GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >::ComponentSumsType
+GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
+::SumOverThreads() const
+{
+  ComponentSumsType sums(0.0);
+  for ( unsigned int t = 0; t < m_ThreadSums.size(); ++t )
+    {
+    sums += m_ThreadSums[t];
+    }
+  return sums;
+}
+
 template< typename TInputImage, typename TOutputImage, typename TInternalPixel >
 void
 GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
@@ -281,6 +1070,12 @@ GradientVectorFlowImageFilter< TInputImage, TOutputImage, TInternalPixel >
   os << indent << "NoiseLevel: " << m_NoiseLevel << std::endl;
   os << indent << "IterationNum: " << m_IterationNum << std::endl;
   os << indent << "TimeStep: " << m_TimeStep << std::endl;
+  os << indent << "UseMultigridSolver: " << m_UseMultigridSolver << std::endl;
+  os << indent << "MaximumNumberOfVCycles: " << m_MaximumNumberOfVCycles << std::endl;
+  os << indent << "NumberOfSmoothingIterations: " << m_NumberOfSmoothingIterations << std::endl;
+  os << indent << "Tolerance: " << m_Tolerance << std::endl;
+  os << indent << "ElapsedVCycles: " << m_ElapsedVCycles << std::endl;
+  os << indent << "RelativeResidual: " << m_RelativeResidual << std::endl;
   if ( m_LaplacianFilter )
     {
     os << indent << "LaplacianFilter: " << m_LaplacianFilter << std::endl;
@@ -21,6 +21,8 @@
 
 #include "itkImageToImageFilter.h"
 #include "itkEllipseSpatialObject.h"
+#include "itkGaussianDerivativeImageFunction.h"
+#include "itkHoughTransformAccumulators.h"
 
 namespace itk
 {
@@ -41,6 +43,15 @@ namespace itk
  * radius given by the user, and fills in the array of radii.
  * The SweepAngle value can be adjusted to improve the segmentation.
  *
+ * The votes are cast by multiple threads, each one in its own
+ * accumulators for its part of the input, and the accumulators are summed
+ * at the end. The cosines and sines of the sweep angles are computed once
+ * per update. The accumulator does not depend on the number of threads,
+ * but the radius image may differ in its last bits, since the sums of the
+ * distances are rounded in a different order.
+ *
+ * \sa HoughTransform3DSpheresImageFilter
+ *
  * \ingroup ImageFeatureExtraction
  *
  * \ingroup ITKImageFeature
@@ -193,6 +204,28 @@ private:
   ModifiedTimeType      m_OldModifiedTime;
 
   CirclesListSizeType m_OldNumberOfCircles;
+
+  typedef GaussianDerivativeImageFunction< InputImageType > DoGFunctionType;
+  typedef HoughTransformAccumulators< OutputImageType >     AccumulatorsType;
+
+  struct VoteThreadStruct
+  {
+    Self                                               *Filter;
+    unsigned int                                       NumberOfPieces;
+    std::vector< typename DoGFunctionType::Pointer >   DoGFunctions;
+    AccumulatorsType                                   Votes;
+    AccumulatorsType                                   Radii;
+  };
+
+  static ITK_THREAD_RETURN_TYPE VoteThreaderCallback(void *arg);
+
+  /** Cast the votes of the pixels of a region. */
+  void ThreadedVote(const OutputImageRegionType & region, DoGFunctionType *DoGFunction,
+                    OutputImageType *votes, OutputImageType *radii, ThreadIdType threadId);
+
+  /** Cosines and sines of the sweep angles. */
+  std::vector< double > m_SweepCosines;
+  std::vector< double > m_SweepSines;
 };
 } // end namespace itk
 
@@ -21,8 +21,8 @@
 #include "itkHoughTransform2DCirclesImageFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
 #include "itkDiscreteGaussianImageFilter.h"
-#include "itkGaussianDerivativeImageFunction.h"
 #include "itkMinimumMaximumImageCalculator.h"
+#include "itkProgressReporter.h"
 #include "itkMath.h"
 
 namespace itk
@@ -89,11 +89,6 @@ HoughTransform2DCirclesImageFilter< TInputPixelType, TOutputPixelType >
   this->AllocateOutputs();
   outputImage->FillBuffer(0);
 
-  typedef GaussianDerivativeImageFunction< InputImageType > DoGFunctionType;
-  typename DoGFunctionType::Pointer DoGFunction = DoGFunctionType::New();
-  DoGFunction->SetInputImage(inputImage);
-  DoGFunction->SetSigma(m_SigmaGradient);
-
   m_RadiusImage = OutputImageType::New();
 
   m_RadiusImage->SetRegions( outputImage->GetLargestPossibleRegion() );
@@ -102,13 +97,98 @@ HoughTransform2DCirclesImageFilter< TInputPixelType, TOutputPixelType >
   m_RadiusImage->SetDirection( inputImage->GetDirection() );
   m_RadiusImage->Allocate( true ); // initialize buffer to zero
 
-  ImageRegionConstIteratorWithIndex< InputImageType > image_it( inputImage,
-    inputImage->GetRequestedRegion() );
+  m_SweepCosines.clear();
+  m_SweepSines.clear();
+  for ( double angle = -m_SweepAngle; angle <= m_SweepAngle; angle += 0.05 )
+    {
+    m_SweepCosines.push_back( std::cos(angle) );
+    m_SweepSines.push_back( std::sin(angle) );
+    }
+
+  // Each thread votes in its own accumulators, with its own derivative
+  // function since the image functions are not thread safe
+  MultiThreader *multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfThreads( this->GetNumberOfThreads() );
+  const ThreadIdType numberOfThreads = multiThreader->GetNumberOfThreads();
+
+  VoteThreadStruct str;
+  str.Filter = this;
+  str.NumberOfPieces =
+    this->GetImageRegionSplitter()->GetNumberOfSplits( inputImage->GetRequestedRegion(), numberOfThreads );
+  for ( unsigned int i = 0; i < str.NumberOfPieces; ++i )
+    {
+    typename DoGFunctionType::Pointer DoGFunction = DoGFunctionType::New();
+    DoGFunction->SetInputImage(inputImage);
+    DoGFunction->SetSigma(m_SigmaGradient);
+    str.DoGFunctions.push_back(DoGFunction);
+    }
+  str.Votes.Initialize(outputImage, str.NumberOfPieces);
+  str.Radii.Initialize(m_RadiusImage, str.NumberOfPieces);
+
+  multiThreader->SetSingleMethod(this->VoteThreaderCallback, &str);
+  multiThreader->SingleMethodExecute();
+
+  str.Votes.Reduce(multiThreader, numberOfThreads);
+  str.Radii.Reduce(multiThreader, numberOfThreads);
+
+  // Compute the average radius
+  ImageRegionConstIterator< OutputImageType > output_it( outputImage,
+    outputImage->GetLargestPossibleRegion() );
+  ImageRegionIterator< OutputImageType > radius_it( m_RadiusImage,
+    m_RadiusImage->GetLargestPossibleRegion() );
+  output_it.GoToBegin();
+  radius_it.GoToBegin();
+  while ( !output_it.IsAtEnd() )
+    {
+    if ( output_it.Get() > 0 )
+      {
+      radius_it.Set( radius_it.Get() / output_it.Get() );
+      }
+    ++output_it;
+    ++radius_it;
+    }
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+ITK_THREAD_RETURN_TYPE
+HoughTransform2DCirclesImageFilter< TInputPixelType, TOutputPixelType >
+::VoteThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  VoteThreadStruct *str = static_cast< VoteThreadStruct * >( info->UserData );
+  Self *filter = str->Filter;
+
+  const ThreadIdType threadId = info->ThreadID;
+  if ( threadId < str->NumberOfPieces )
+    {
+    OutputImageRegionType region = filter->GetInput()->GetRequestedRegion();
+    filter->GetImageRegionSplitter()->GetSplit(threadId, str->NumberOfPieces, region);
+    filter->ThreadedVote( region, str->DoGFunctions[threadId], str->Votes.GetAccumulator(threadId),
+                          str->Radii.GetAccumulator(threadId), threadId );
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+void
+HoughTransform2DCirclesImageFilter< TInputPixelType, TOutputPixelType >
+::ThreadedVote(const OutputImageRegionType & region, DoGFunctionType *DoGFunction,
+               OutputImageType *votes, OutputImageType *radii, ThreadIdType threadId)
+{
+  const InputImageType *inputImage = this->GetInput();
+  const OutputImageRegionType & accumulatorRegion = votes->GetBufferedRegion();
+
+  ProgressReporter progress( this, threadId, region.GetNumberOfPixels() );
+
+  ImageRegionConstIteratorWithIndex< InputImageType > image_it( inputImage, region );
   image_it.GoToBegin();
 
   Index< 2 >        index;
   Point< float, 2 > point;
 
+  const size_t numberOfAngles = m_SweepCosines.size();
+
   while ( !image_it.IsAtEnd() )
     {
     if ( image_it.Get() > m_Threshold )
@@ -128,50 +208,36 @@ HoughTransform2DCirclesImageFilter< TInputPixelType, TOutputPixelType >
         Vx /= norm;
         Vy /= norm;
 
-        for ( double angle = -m_SweepAngle; angle <= m_SweepAngle; angle += 0.05 )
+        for ( size_t a = 0; a < numberOfAngles; ++a )
           {
+          const double cosAngle = m_SweepCosines[a];
+          const double sinAngle = m_SweepSines[a];
           double i = m_MinimumRadius;
           double distance;
 
           do
             {
-            index[0] = (IndexValueType)( point[0] - i * ( Vx * std::cos(angle) + Vy * std::sin(angle) ) );
-            index[1] = (IndexValueType)( point[1] - i * ( Vx * std::sin(angle) + Vy * std::cos(angle) ) );
+            index[0] = (IndexValueType)( point[0] - i * ( Vx * cosAngle + Vy * sinAngle ) );
+            index[1] = (IndexValueType)( point[1] - i * ( Vx * sinAngle + Vy * cosAngle ) );
 
             distance = std::sqrt( ( index[1] - point[1] ) * ( index[1] - point[1] )
                                  + ( index[0] - point[0] ) * ( index[0] - point[0] ) );
 
-            if ( outputImage->GetRequestedRegion().IsInside(index) )
+            if ( accumulatorRegion.IsInside(index) )
               {
-              outputImage->SetPixel(index, outputImage->GetPixel(index) + 1);
-              m_RadiusImage->SetPixel( index, ( m_RadiusImage->GetPixel(index) + distance ) );
+              votes->SetPixel(index, votes->GetPixel(index) + 1);
+              radii->SetPixel( index, ( radii->GetPixel(index) + distance ) );
               }
 
             i = i + 1;
             }
-          while ( outputImage->GetRequestedRegion().IsInside(index)
+          while ( accumulatorRegion.IsInside(index)
                   && ( distance < m_MaximumRadius ) );
           }
         }
       }
     ++image_it;
-    }
-
-  // Compute the average radius
-  ImageRegionConstIterator< OutputImageType > output_it( outputImage,
-    outputImage->GetLargestPossibleRegion() );
-  ImageRegionIterator< OutputImageType > radius_it( m_RadiusImage,
-    m_RadiusImage->GetLargestPossibleRegion() );
-  output_it.GoToBegin();
-  radius_it.GoToBegin();
-  while ( !output_it.IsAtEnd() )
-    {
-    if ( output_it.Get() > 0 )
-      {
-      radius_it.Set( radius_it.Get() / output_it.Get() );
-      }
-    ++output_it;
-    ++radius_it;
+    progress.CompletedPixel();
     }
 }
 
@@ -21,6 +21,7 @@
 
 #include "itkImageToImageFilter.h"
 #include "itkLineSpatialObject.h"
+#include "itkHoughTransformAccumulators.h"
 
 namespace itk
 {
@@ -50,6 +51,11 @@ namespace itk
  * (500 by default) for the angle axis. The distance axis depends on the
  * size of the diagonal of the input image.
  *
+ * The votes are cast by multiple threads, each one in its own
+ * accumulator for its part of the input, and the accumulators are summed
+ * at the end. The cosines and sines of the angles are computed once per
+ * update.
+ *
  * \ingroup ImageFeatureExtraction
  * \sa LineSpatialObject
  *
@@ -196,6 +202,28 @@ private:
   float              m_Variance;
   ModifiedTimeType   m_OldModifiedTime;
   LinesListSizeType  m_OldNumberOfLines;
+
+  typedef HoughTransformAccumulators< OutputImageType > AccumulatorsType;
+
+  struct VoteThreadStruct
+  {
+    Self             *Filter;
+    unsigned int     NumberOfPieces;
+    AccumulatorsType Votes;
+  };
+
+  static ITK_THREAD_RETURN_TYPE VoteThreaderCallback(void *arg);
+
+  /** Cast the votes of the pixels of a region. */
+  void ThreadedVote(const OutputImageRegionType & region, OutputImageType *votes, ThreadIdType threadId);
+
+  /** Compute the cosines and sines of the angles, and their indices in
+   * the accumulator. */
+  void ComputeAngleTables();
+
+  std::vector< double >         m_Cosines;
+  std::vector< double >         m_Sines;
+  std::vector< IndexValueType > m_AngleIndices;
 };
 } // end namespace itk
 
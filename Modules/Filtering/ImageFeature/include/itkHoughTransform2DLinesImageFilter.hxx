@@ -23,6 +23,7 @@
 #include "itkDiscreteGaussianImageFilter.h"
 #include "itkMinimumMaximumImageCalculator.h"
 #include "itkCastImageFilter.h"
+#include "itkProgressReporter.h"
 #include "itkMath.h"
 
 namespace itk
@@ -115,36 +116,109 @@ HoughTransform2DLinesImageFilter< TInputPixelType, TOutputPixelType >
   this->AllocateOutputs();
   outputImage->FillBuffer(0);
 
+  this->ComputeAngleTables();
+
+  MultiThreader *multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfThreads( this->GetNumberOfThreads() );
+  const ThreadIdType numberOfThreads = multiThreader->GetNumberOfThreads();
+
+  // Each thread votes in its own accumulator
+  VoteThreadStruct str;
+  str.Filter = this;
+  str.NumberOfPieces =
+    this->GetImageRegionSplitter()->GetNumberOfSplits( inputImage->GetRequestedRegion(), numberOfThreads );
+  str.Votes.Initialize(outputImage, str.NumberOfPieces);
+
+  multiThreader->SetSingleMethod(this->VoteThreaderCallback, &str);
+  multiThreader->SingleMethodExecute();
+
+  str.Votes.Reduce(multiThreader, numberOfThreads);
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+void
+HoughTransform2DLinesImageFilter< TInputPixelType, TOutputPixelType >
+::ComputeAngleTables()
+{
   const double nPI = 4.0 * std::atan(1.0);
 
-  ImageRegionConstIteratorWithIndex< InputImageType > image_it( inputImage,  inputImage->GetRequestedRegion() );
+  m_Cosines.clear();
+  m_Sines.clear();
+  m_AngleIndices.clear();
+  for ( double angle = -nPI; angle < nPI; angle += nPI / m_AngleResolution )
+    {
+    m_Cosines.push_back( std::cos(angle) );
+    m_Sines.push_back( std::sin(angle) );
+    // m_Theta
+    m_AngleIndices.push_back( (IndexValueType)( ( m_AngleResolution / 2 ) + m_AngleResolution * angle / ( 2 * nPI ) ) );
+    }
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+ITK_THREAD_RETURN_TYPE
+HoughTransform2DLinesImageFilter< TInputPixelType, TOutputPixelType >
+::VoteThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  VoteThreadStruct *str = static_cast< VoteThreadStruct * >( info->UserData );
+  Self *filter = str->Filter;
+
+  const ThreadIdType threadId = info->ThreadID;
+  if ( threadId < str->NumberOfPieces )
+    {
+    OutputImageRegionType region = filter->GetInput()->GetRequestedRegion();
+    filter->GetImageRegionSplitter()->GetSplit(threadId, str->NumberOfPieces, region);
+    filter->ThreadedVote( region, str->Votes.GetAccumulator(threadId), threadId );
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+void
+HoughTransform2DLinesImageFilter< TInputPixelType, TOutputPixelType >
+::ThreadedVote(const OutputImageRegionType & region, OutputImageType *votes, ThreadIdType threadId)
+{
+  const InputImageType *inputImage = this->GetInput();
+
+  ProgressReporter progress( this, threadId, region.GetNumberOfPixels() );
+
+  ImageRegionConstIteratorWithIndex< InputImageType > image_it( inputImage, region );
   image_it.GoToBegin();
 
+  const IndexValueType  distanceSize = votes->GetBufferedRegion().GetSize()[0];
+  const SizeValueType   numberOfBins = votes->GetBufferedRegion().GetNumberOfPixels();
+  TOutputPixelType *    buffer = votes->GetBufferPointer();
+  const size_t          numberOfAngles = m_Cosines.size();
+
   Index< 2 > index;
 
   while ( !image_it.IsAtEnd() )
     {
     if ( image_it.Get() > m_Threshold )
       {
-      for ( double angle = -nPI; angle < nPI; angle += nPI / m_AngleResolution )
+      for ( size_t a = 0; a < numberOfAngles; ++a )
         {
-        index[0] =
-          // m_R
-          (IndexValueType)( image_it.GetIndex()[0] * std::cos(angle) + image_it.GetIndex()[1] * std::sin(angle) );
+        // m_R
+        index[0] = (IndexValueType)( image_it.GetIndex()[0] * m_Cosines[a] + image_it.GetIndex()[1] * m_Sines[a] );
         // m_Theta
-        index[1] = (IndexValueType)( ( m_AngleResolution / 2 ) + m_AngleResolution * angle / ( 2 * nPI ) );
+        index[1] = m_AngleIndices[a];
 
-        if ( ( index[0] > 0 )
-             && ( index[0] <= (IndexValueType)outputImage->GetBufferedRegion().GetSize()[0] ) )
-        // the preceding "if" should be replacable with "if (
-        // outputImage->GetBufferedRegion().IsInside(index) )" but
-        // the algorithm fails if it is
+        // The distances equal to the size of the accumulator vote in the
+        // next row, as they always did, except in the last row where they
+        // would be outside of the accumulator.
+        if ( ( index[0] > 0 ) && ( index[0] <= distanceSize ) )
           {
-          outputImage->SetPixel(index, outputImage->GetPixel(index) + 1);
+          const OffsetValueType offset = votes->ComputeOffset(index);
+          if ( offset < static_cast< OffsetValueType >( numberOfBins ) )
+            {
+            buffer[offset] += 1;
+            }
           }
         }
       }
     ++image_it;
+    progress.CompletedPixel();
     }
 }
 
@@ -184,7 +258,8 @@ HoughTransform2DLinesImageFilter< TInputPixelType, TOutputPixelType >
   ImageRegionConstIteratorWithIndex< InputImageType > image_it( inputImage,  inputImage->GetRequestedRegion() );
   image_it.GoToBegin();
 
-  const double nPI = 4.0 * std::atan(1.0);
+  this->ComputeAngleTables();
+  const size_t numberOfAngles = m_Cosines.size();
 
   while ( !image_it.IsAtEnd() )
     {
@@ -194,12 +269,12 @@ HoughTransform2DLinesImageFilter< TInputPixelType, TOutputPixelType >
       valuemax = -1;
       maxIndex[0] = 0;
       maxIndex[1] = 0;
-      for ( double angle = -nPI; angle < nPI; angle += nPI / m_AngleResolution )
+      for ( size_t a = 0; a < numberOfAngles; ++a )
         {
         // m_R
-        index[0] = (IndexValueType)( image_it.GetIndex()[0] * std::cos(angle) + image_it.GetIndex()[1] * std::sin(angle) );
+        index[0] = (IndexValueType)( image_it.GetIndex()[0] * m_Cosines[a] + image_it.GetIndex()[1] * m_Sines[a] );
         // m_Theta
-        index[1] = (IndexValueType)( ( m_AngleResolution / 2 ) + m_AngleResolution * angle / ( 2 * nPI ) );
+        index[1] = m_AngleIndices[a];
 
         if ( outputImage->GetBufferedRegion().IsInside(index) )
           {
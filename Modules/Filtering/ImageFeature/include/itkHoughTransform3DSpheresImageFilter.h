@@ -0,0 +1,210 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHoughTransform3DSpheresImageFilter_h
+#define itkHoughTransform3DSpheresImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkEllipseSpatialObject.h"
+#include "itkGaussianDerivativeImageFunction.h"
+#include "itkHoughTransformAccumulators.h"
+
+namespace itk
+{
+/**
+ * \class HoughTransform3DSpheresImageFilter
+ * \brief Performs the Hough Transform to find spheres in a 3D image.
+ *
+ * This filter is the 3D version of HoughTransform2DCirclesImageFilter.
+ * All the pixels of the input above the Threshold, whose gradient is not
+ * flat, vote for the centers of the spheres they may belong to.
+ *
+ * The votes are constrained by the direction of the gradient of the
+ * input, computed with a derivative of Gaussian of scale SigmaGradient:
+ * each pixel votes along its gradient, towards the higher intensities,
+ * at the distances between MinimumRadius and MaximumRadius. The votes of
+ * the border of bright spheres on a dark background, like beads, thus
+ * converge to their centers. This only casts one vote per distance,
+ * instead of one per point of a sphere, which makes the transform
+ * practical on large volumes.
+ *
+ * This filter produces two outputs:
+ *   1) The accumulator array, which represents the probability of centers.
+ *   2) The image of radii, which has the average radius of the votes at
+ *      each point.
+ *
+ * GetSpheres() blurs the accumulator and returns the NumberOfSpheres
+ * strongest spheres, removing a ball of SphereRadiusRatio times the
+ * radius around each sphere found.
+ *
+ * The votes are cast by multiple threads, each one in its own
+ * accumulators for its part of the input, and the accumulators are summed
+ * at the end. The accumulator does not depend on the number of threads,
+ * but the radius image may differ in its last bits when the radii are not
+ * integers, since their sums are rounded in a different order.
+ *
+ * \sa HoughTransform2DCirclesImageFilter
+ *
+ * \ingroup ImageFeatureExtraction
+ * \ingroup ITKImageFeature
+ */
+template< typename TInputPixelType, typename TOutputPixelType >
+class ITK_TEMPLATE_EXPORT HoughTransform3DSpheresImageFilter:
+  public ImageToImageFilter< Image< TInputPixelType, 3 >, Image< TOutputPixelType, 3 > >
+{
+public:
+  /** Standard class typedefs. */
+  typedef HoughTransform3DSpheresImageFilter                  Self;
+  typedef ImageToImageFilter< Image< TInputPixelType, 3 >,
+                              Image< TOutputPixelType, 3 > >  Superclass;
+  typedef SmartPointer< Self >                                Pointer;
+  typedef SmartPointer< const Self >                          ConstPointer;
+
+  /** Input Image typedefs. */
+  typedef Image< TInputPixelType, 3 >           InputImageType;
+  typedef typename InputImageType::Pointer      InputImagePointer;
+  typedef typename InputImageType::ConstPointer InputImageConstPointer;
+
+  /** Output Image typedefs. */
+  typedef Image< TOutputPixelType, 3 >      OutputImageType;
+  typedef typename OutputImageType::Pointer OutputImagePointer;
+
+  /** Image index typedef. */
+  typedef typename InputImageType::IndexType IndexType;
+
+  /** Image pixel value typedef. */
+  typedef typename InputImageType::PixelType PixelType;
+
+  /** Typedef to describe the output image region type. */
+  typedef typename InputImageType::RegionType OutputImageRegionType;
+
+  /** Sphere typedefs. */
+  typedef EllipseSpatialObject< 3 >           SphereType;
+  typedef typename SphereType::Pointer        SpherePointer;
+  typedef std::list< SpherePointer >          SpheresListType;
+  typedef typename SpheresListType::size_type SpheresListSizeType;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(HoughTransform3DSpheresImageFilter, ImageToImageFilter);
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Set both Minimum and Maximum radius values. */
+  void SetRadius(double radius);
+
+  /** Set the minimum radius value the filter should look for. */
+  itkSetMacro(MinimumRadius, double);
+  itkGetConstMacro(MinimumRadius, double);
+
+  /** Set the maximum radius value the filter should look for. */
+  itkSetMacro(MaximumRadius, double);
+  itkGetConstMacro(MaximumRadius, double);
+
+  /** Set the threshold above which the filter should consider
+   * the point as a valid point. */
+  itkSetMacro(Threshold, double);
+  itkGetConstMacro(Threshold, double);
+
+  /** Set the scale of the derivative function (using DoG). */
+  itkSetMacro(SigmaGradient, double);
+  itkGetConstMacro(SigmaGradient, double);
+
+  /** Get the radius image. */
+  itkGetModifiableObjectMacro(RadiusImage, OutputImageType);
+
+  /** Get the list of spheres. This recomputes the spheres when the
+   * filter or its output have been modified. */
+  SpheresListType & GetSpheres();
+
+  /** Set/Get the number of spheres to extract. */
+  itkSetMacro(NumberOfSpheres, SpheresListSizeType);
+  itkGetConstMacro(NumberOfSpheres, SpheresListSizeType);
+
+  /** Set/Get the radius of the ball to remove from the accumulator
+   * for each sphere found, relative to the radius of the sphere. */
+  itkSetMacro(SphereRadiusRatio, float);
+  itkGetConstMacro(SphereRadiusRatio, float);
+
+  /** Set/Get the variance of the Gaussian blurring for the accumulator. */
+  itkSetMacro(Variance, float);
+  itkGetConstMacro(Variance, float);
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  // Begin concept checking
+  itkConceptMacro( IntConvertibleToOutputCheck,
+                   ( Concept::Convertible< int, TOutputPixelType > ) );
+  itkConceptMacro( InputGreaterThanDoubleCheck,
+                   ( Concept::GreaterThanComparable< PixelType, double > ) );
+  itkConceptMacro( OutputPlusIntCheck,
+                   ( Concept::AdditiveOperators< TOutputPixelType, int > ) );
+  // End concept checking
+#endif
+
+protected:
+  HoughTransform3DSpheresImageFilter();
+  virtual ~HoughTransform3DSpheresImageFilter() {}
+
+  void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+  /** HoughTransform3DSpheresImageFilter needs the entire input. */
+  void GenerateInputRequestedRegion() ITK_OVERRIDE;
+
+  /** HoughTransform3DSpheresImageFilter produces all the output. */
+  void EnlargeOutputRequestedRegion( DataObject *output ) ITK_OVERRIDE;
+
+  void GenerateData() ITK_OVERRIDE;
+
+private:
+  ITK_DISALLOW_COPY_AND_ASSIGN(HoughTransform3DSpheresImageFilter);
+
+  typedef GaussianDerivativeImageFunction< InputImageType > DoGFunctionType;
+  typedef HoughTransformAccumulators< OutputImageType >     AccumulatorsType;
+
+  struct VoteThreadStruct
+  {
+    Self                                               *Filter;
+    unsigned int                                       NumberOfPieces;
+    std::vector< typename DoGFunctionType::Pointer >   DoGFunctions;
+    AccumulatorsType                                   Votes;
+    AccumulatorsType                                   Radii;
+  };
+
+  static ITK_THREAD_RETURN_TYPE VoteThreaderCallback(void *arg);
+
+  /** Cast the votes of the pixels of a region. */
+  void ThreadedVote(const OutputImageRegionType & region, DoGFunctionType *DoGFunction,
+                    OutputImageType *votes, OutputImageType *radii, ThreadIdType threadId);
+
+  double              m_MinimumRadius;
+  double              m_MaximumRadius;
+  double              m_Threshold;
+  double              m_SigmaGradient;
+  OutputImagePointer  m_RadiusImage;
+  SpheresListType     m_SpheresList;
+  SpheresListSizeType m_NumberOfSpheres;
+  float               m_SphereRadiusRatio;
+  float               m_Variance;
+  ModifiedTimeType    m_OldModifiedTime;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkHoughTransform3DSpheresImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,309 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHoughTransform3DSpheresImageFilter_hxx
+#define itkHoughTransform3DSpheresImageFilter_hxx
+
+#include "itkHoughTransform3DSpheresImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkMinimumMaximumImageCalculator.h"
+#include "itkProgressReporter.h"
+#include "itkMath.h"
+
+namespace itk
+{
+template< typename TInputPixelType, typename TOutputPixelType >
+HoughTransform3DSpheresImageFilter< TInputPixelType, TOutputPixelType >
+::HoughTransform3DSpheresImageFilter() :
+  m_MinimumRadius( 0.0 ),
+  m_MaximumRadius( 10.0 ),
+  m_Threshold( 0.0 ),
+  m_SigmaGradient( 1.0 ),
+  m_NumberOfSpheres( 1 ),
+  m_SphereRadiusRatio( 1 ),
+  m_Variance( 4 ),
+  m_OldModifiedTime( 0 )
+{
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+void
+HoughTransform3DSpheresImageFilter< TInputPixelType, TOutputPixelType >
+::SetRadius(double radius)
+{
+  this->SetMinimumRadius(radius);
+  this->SetMaximumRadius(radius);
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+void
+HoughTransform3DSpheresImageFilter< TInputPixelType, TOutputPixelType >
+::EnlargeOutputRequestedRegion(DataObject *output)
+{
+  Superclass::EnlargeOutputRequestedRegion(output);
+  output->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+void
+HoughTransform3DSpheresImageFilter< TInputPixelType, TOutputPixelType >
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+  if ( this->GetInput() )
+    {
+    InputImagePointer image =
+      const_cast< InputImageType * >( this->GetInput() );
+    image->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+void
+HoughTransform3DSpheresImageFilter< TInputPixelType, TOutputPixelType >
+::GenerateData()
+{
+  // Get the input and output pointers
+  InputImageConstPointer inputImage = this->GetInput(0);
+  OutputImagePointer     outputImage = this->GetOutput(0);
+
+  // Allocate the output
+  this->AllocateOutputs();
+  outputImage->FillBuffer(0);
+
+  m_RadiusImage = OutputImageType::New();
+  m_RadiusImage->CopyInformation(outputImage);
+  m_RadiusImage->SetRegions( outputImage->GetLargestPossibleRegion() );
+  m_RadiusImage->Allocate( true ); // initialize buffer to zero
+
+  // Each thread votes in its own accumulators, with its own derivative
+  // function since the image functions are not thread safe
+  MultiThreader *multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfThreads( this->GetNumberOfThreads() );
+  const ThreadIdType numberOfThreads = multiThreader->GetNumberOfThreads();
+
+  VoteThreadStruct str;
+  str.Filter = this;
+  str.NumberOfPieces =
+    this->GetImageRegionSplitter()->GetNumberOfSplits( inputImage->GetRequestedRegion(), numberOfThreads );
+  for ( unsigned int i = 0; i < str.NumberOfPieces; ++i )
+    {
+    typename DoGFunctionType::Pointer DoGFunction = DoGFunctionType::New();
+    DoGFunction->SetInputImage(inputImage);
+    DoGFunction->SetSigma(m_SigmaGradient);
+    str.DoGFunctions.push_back(DoGFunction);
+    }
+  str.Votes.Initialize(outputImage, str.NumberOfPieces);
+  str.Radii.Initialize(m_RadiusImage, str.NumberOfPieces);
+
+  multiThreader->SetSingleMethod(this->VoteThreaderCallback, &str);
+  multiThreader->SingleMethodExecute();
+
+  str.Votes.Reduce(multiThreader, numberOfThreads);
+  str.Radii.Reduce(multiThreader, numberOfThreads);
+
+  // Compute the average radius
+  const TOutputPixelType *votes = outputImage->GetBufferPointer();
+  TOutputPixelType *      radii = m_RadiusImage->GetBufferPointer();
+  const SizeValueType     numberOfPixels = outputImage->GetBufferedRegion().GetNumberOfPixels();
+  for ( SizeValueType i = 0; i < numberOfPixels; ++i )
+    {
+    if ( votes[i] > 0 )
+      {
+      radii[i] = radii[i] / votes[i];
+      }
+    }
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+ITK_THREAD_RETURN_TYPE
+HoughTransform3DSpheresImageFilter< TInputPixelType, TOutputPixelType >
+::VoteThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  VoteThreadStruct *str = static_cast< VoteThreadStruct * >( info->UserData );
+  Self *filter = str->Filter;
+
+  const ThreadIdType threadId = info->ThreadID;
+  if ( threadId < str->NumberOfPieces )
+    {
+    OutputImageRegionType region = filter->GetInput()->GetRequestedRegion();
+    filter->GetImageRegionSplitter()->GetSplit(threadId, str->NumberOfPieces, region);
+    filter->ThreadedVote( region, str->DoGFunctions[threadId], str->Votes.GetAccumulator(threadId),
+                          str->Radii.GetAccumulator(threadId), threadId );
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+void
+HoughTransform3DSpheresImageFilter< TInputPixelType, TOutputPixelType >
+::ThreadedVote(const OutputImageRegionType & region, DoGFunctionType *DoGFunction,
+               OutputImageType *votes, OutputImageType *radii, ThreadIdType threadId)
+{
+  const InputImageType *inputImage = this->GetInput();
+  const OutputImageRegionType & accumulatorRegion = votes->GetBufferedRegion();
+
+  ProgressReporter progress( this, threadId, region.GetNumberOfPixels() );
+
+  Index< 3 > index;
+
+  for ( ImageRegionConstIteratorWithIndex< InputImageType > image_it( inputImage, region ); !image_it.IsAtEnd(); ++image_it )
+    {
+    progress.CompletedPixel();
+    if ( !( image_it.Get() > m_Threshold ) )
+      {
+      continue;
+      }
+
+    typename DoGFunctionType::VectorType grad = DoGFunction->EvaluateAtIndex( image_it.GetIndex() );
+
+    // if the gradient is not flat
+    if ( ( std::fabs(grad[0]) <= 1 ) && ( std::fabs(grad[1]) <= 1 ) && ( std::fabs(grad[2]) <= 1 ) )
+      {
+      continue;
+      }
+    const double norm = grad.GetNorm();
+
+    // Vote along the gradient. The derivative of Gaussian function
+    // returns the opposite of the gradient.
+    for ( double radius = m_MinimumRadius; radius <= m_MaximumRadius; radius += 1.0 )
+      {
+      for ( unsigned int d = 0; d < 3; ++d )
+        {
+        index[d] = image_it.GetIndex()[d] - Math::Round< IndexValueType >( radius * grad[d] / norm );
+        }
+      if ( !accumulatorRegion.IsInside(index) )
+        {
+        break;
+        }
+      votes->SetPixel( index, votes->GetPixel(index) + 1 );
+      radii->SetPixel( index, radii->GetPixel(index) + radius );
+      }
+    }
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+typename HoughTransform3DSpheresImageFilter< TInputPixelType, TOutputPixelType >::SpheresListType &
+HoughTransform3DSpheresImageFilter< TInputPixelType, TOutputPixelType >
+::GetSpheres()
+{
+  const ModifiedTimeType modifiedTime = std::max( this->GetMTime(), this->GetOutput()->GetUpdateMTime() );
+  if ( modifiedTime == m_OldModifiedTime )
+    {
+    // If the filter has not been updated
+    return m_SpheresList;
+    }
+
+  m_SpheresList.clear();
+
+  if ( !m_RadiusImage )
+    {
+    itkExceptionMacro("Update() must be called before GetSpheres().");
+    }
+
+  // Blur the accumulator in order to find the maximum
+  typedef Image< float, 3 >                                                 InternalImageType;
+  typedef DiscreteGaussianImageFilter< OutputImageType, InternalImageType > GaussianFilterType;
+  typename GaussianFilterType::Pointer gaussianFilter = GaussianFilterType::New();
+  gaussianFilter->SetInput( this->GetOutput() );
+  gaussianFilter->SetVariance(m_Variance);
+  gaussianFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
+  gaussianFilter->Update();
+  typename InternalImageType::Pointer postProcessImage = gaussianFilter->GetOutput();
+  postProcessImage->DisconnectPipeline();
+
+  typedef MinimumMaximumImageCalculator< InternalImageType > MinMaxCalculatorType;
+  typename MinMaxCalculatorType::Pointer minMaxCalculator = MinMaxCalculatorType::New();
+  minMaxCalculator->SetImage(postProcessImage);
+
+  const typename InternalImageType::RegionType & region = postProcessImage->GetLargestPossibleRegion();
+
+  while ( m_SpheresList.size() < m_NumberOfSpheres )
+    {
+    minMaxCalculator->ComputeMaximum();
+    if ( !( minMaxCalculator->GetMaximum() > 0.0f ) )
+      {
+      break;
+      }
+    const IndexType center = minMaxCalculator->GetIndexOfMaximum();
+
+    // Create a Sphere Spatial Object
+    SpherePointer sphere = SphereType::New();
+    sphere->SetId( static_cast< int >( m_SpheresList.size() ) );
+    sphere->SetRadius( m_RadiusImage->GetPixel(center) );
+
+    typename SphereType::VectorType offset;
+    for ( unsigned int d = 0; d < 3; ++d )
+      {
+      offset[d] = center[d];
+      }
+    sphere->GetObjectToParentTransform()->SetOffset(offset);
+    sphere->ComputeBoundingBox();
+
+    m_SpheresList.push_back(sphere);
+
+    // Remove a ball from the hough space domain
+    const double ballRadius = m_SphereRadiusRatio * sphere->GetRadius()[0];
+    typename InternalImageType::RegionType ballRegion;
+    for ( unsigned int d = 0; d < 3; ++d )
+      {
+      ballRegion.SetIndex( d, center[d] - static_cast< IndexValueType >( ballRadius ) );
+      ballRegion.SetSize( d, 2 * static_cast< SizeValueType >( ballRadius ) + 1 );
+      }
+    ballRegion.Crop(region);
+    for ( ImageRegionIteratorWithIndex< InternalImageType > it( postProcessImage, ballRegion ); !it.IsAtEnd(); ++it )
+      {
+      double distance = 0.0;
+      for ( unsigned int d = 0; d < 3; ++d )
+        {
+        const double x = it.GetIndex()[d] - center[d];
+        distance += x * x;
+        }
+      if ( distance <= ballRadius * ballRadius )
+        {
+        it.Set(0.0f);
+        }
+      }
+    }
+
+  m_OldModifiedTime = modifiedTime;
+  return m_SpheresList;
+}
+
+template< typename TInputPixelType, typename TOutputPixelType >
+void
+HoughTransform3DSpheresImageFilter< TInputPixelType, TOutputPixelType >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Threshold: " << m_Threshold << std::endl;
+  os << indent << "Minimum Radius: " << m_MinimumRadius << std::endl;
+  os << indent << "Maximum Radius: " << m_MaximumRadius << std::endl;
+  os << indent << "Derivative Scale: " << m_SigmaGradient << std::endl;
+  os << indent << "Number Of Spheres: " << m_NumberOfSpheres << std::endl;
+  os << indent << "Sphere Radius Ratio: " << m_SphereRadiusRatio << std::endl;
+  os << indent << "Accumulator blur variance: " << m_Variance << std::endl;
+
+  itkPrintSelfObjectMacro( RadiusImage );
+}
+} // end namespace
+
+#endif
@@ -0,0 +1,96 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHoughTransformAccumulators_h
+#define itkHoughTransformAccumulators_h
+
+#include "itkMultiThreader.h"
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class HoughTransformAccumulators
+ * \brief Per-thread accumulators of the votes of a Hough transform.
+ *
+ * The Hough transform filters vote from the pixels of the input into an
+ * accumulator image. To vote in parallel without locking, each thread
+ * votes into its own accumulator, and the accumulators are summed once
+ * all the votes are cast.
+ *
+ * The first accumulator is an image provided by the filter, usually its
+ * output, and the other ones are allocated with the same buffered region
+ * and filled with zero. Reduce() sums them into the first one, with a
+ * pairwise tree reduction whose pixels are split between the threads, so
+ * the sums do not depend on the number of threads used by the reduction.
+ * They still depend on the number of accumulators, i.e. on how the input
+ * was split between the voting threads: the vote counts are exact, but
+ * floating point sums such as the radius sums may differ in their last
+ * bits.
+ *
+ * This is a helper class of the Hough transform filters, it is not meant
+ * to be used directly.
+ *
+ * \sa HoughTransform2DCirclesImageFilter
+ * \sa HoughTransform2DLinesImageFilter
+ * \sa HoughTransform3DSpheresImageFilter
+ *
+ * \ingroup ITKImageFeature
+ */
+template< typename TImage >
+class ITK_TEMPLATE_EXPORT HoughTransformAccumulators
+{
+public:
+  typedef HoughTransformAccumulators    Self;
+  typedef TImage                        ImageType;
+  typedef typename ImageType::Pointer   ImagePointer;
+  typedef typename ImageType::PixelType PixelType;
+
+  HoughTransformAccumulators() {}
+
+  /** Use first as the first accumulator, and allocate the other ones. The
+   * first accumulator must already be allocated and initialized. */
+  void Initialize(ImageType *first, unsigned int numberOfAccumulators);
+
+  unsigned int GetNumberOfAccumulators() const
+  {
+    return static_cast< unsigned int >( m_Accumulators.size() );
+  }
+
+  ImageType * GetAccumulator(unsigned int i) const
+  {
+    return m_Accumulators[i];
+  }
+
+  /** Sum the accumulators into the first one, and release the other
+   * ones. */
+  void Reduce(MultiThreader *threader, ThreadIdType numberOfThreads);
+
+private:
+  ITK_DISALLOW_COPY_AND_ASSIGN(HoughTransformAccumulators);
+
+  static ITK_THREAD_RETURN_TYPE ReduceThreaderCallback(void *arg);
+
+  std::vector< ImagePointer > m_Accumulators;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkHoughTransformAccumulators.hxx"
+#endif
+
+#endif
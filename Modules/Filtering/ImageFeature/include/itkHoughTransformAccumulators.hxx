@@ -0,0 +1,89 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHoughTransformAccumulators_hxx
+#define itkHoughTransformAccumulators_hxx
+
+#include "itkHoughTransformAccumulators.h"
+
+namespace itk
+{
+template< typename TImage >
+void
+HoughTransformAccumulators< TImage >
+::Initialize(ImageType *first, unsigned int numberOfAccumulators)
+{
+  m_Accumulators.clear();
+  m_Accumulators.push_back(first);
+  for ( unsigned int i = 1; i < numberOfAccumulators; ++i )
+    {
+    ImagePointer accumulator = ImageType::New();
+    accumulator->CopyInformation(first);
+    accumulator->SetRequestedRegion( first->GetBufferedRegion() );
+    accumulator->SetBufferedRegion( first->GetBufferedRegion() );
+    accumulator->Allocate(true);
+    m_Accumulators.push_back(accumulator);
+    }
+}
+
+template< typename TImage >
+void
+HoughTransformAccumulators< TImage >
+::Reduce(MultiThreader *threader, ThreadIdType numberOfThreads)
+{
+  if ( m_Accumulators.size() > 1 )
+    {
+    threader->SetNumberOfThreads(numberOfThreads);
+    threader->SetSingleMethod(Self::ReduceThreaderCallback, this);
+    threader->SingleMethodExecute();
+    }
+  m_Accumulators.resize( std::min( m_Accumulators.size(), static_cast< size_t >( 1 ) ) );
+}
+
+template< typename TImage >
+ITK_THREAD_RETURN_TYPE
+HoughTransformAccumulators< TImage >
+::ReduceThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self *self = static_cast< Self * >( info->UserData );
+
+  // Each thread sums a contiguous range of pixels
+  const std::vector< ImagePointer > & accumulators = self->m_Accumulators;
+  const SizeValueType numberOfPixels = accumulators[0]->GetBufferedRegion().GetNumberOfPixels();
+  const SizeValueType begin = numberOfPixels * info->ThreadID / info->NumberOfThreads;
+  const SizeValueType end = numberOfPixels * ( info->ThreadID + 1 ) / info->NumberOfThreads;
+
+  const size_t numberOfAccumulators = accumulators.size();
+  for ( size_t step = 1; step < numberOfAccumulators; step *= 2 )
+    {
+    for ( size_t i = 0; i + step < numberOfAccumulators; i += 2 * step )
+      {
+      PixelType *      sum = accumulators[i]->GetBufferPointer();
+      const PixelType *other = accumulators[i + step]->GetBufferPointer();
+      for ( SizeValueType p = begin; p < end; ++p )
+        {
+        sum[p] += other[p];
+        }
+      }
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+} // end namespace itk
+
+#endif
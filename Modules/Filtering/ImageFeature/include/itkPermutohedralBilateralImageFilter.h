@@ -0,0 +1,261 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPermutohedralBilateralImageFilter_h
+#define itkPermutohedralBilateralImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkFixedArray.h"
+#include "itkMultiThreader.h"
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class PermutohedralBilateralImageFilter
+ * \brief Fast approximation of the bilateral filter on the permutohedral
+ * lattice.
+ *
+ * This filter computes the same edge preserving smoothing as
+ * BilateralImageFilter, but instead of visiting the spatial neighborhood
+ * of each pixel, each pixel is treated as a point in a feature space made
+ * of its position, divided by the DomainSigma, and of its value, divided
+ * by the RangeSigma. The pixel values are splatted onto the vertices of
+ * the enclosing simplex of the permutohedral lattice of that space, the
+ * lattice is blurred along each of its axes, and the result is sliced
+ * back at the position of each pixel (Adams, Baek and Davis, Fast
+ * High-Dimensional Filtering Using the Permutohedral Lattice, Computer
+ * Graphics Forum 29(2), 2010).
+ *
+ * Only the vertices of the lattice close to a pixel are stored, in a
+ * hash table, so the run time and the memory are linear in the number of
+ * pixels and do not depend on the sigmas. This makes large domain sigmas
+ * practical on 3D images, where BilateralImageFilter becomes very slow.
+ *
+ * The input pixels can be scalars or vectors. For vector images, the
+ * range distance is the Euclidean distance between the pixel values, and
+ * each component is filtered with the same weights. The number of
+ * components of the output pixels must match the input ones.
+ *
+ * The result is an approximation of the bilateral filter. Its accuracy
+ * is controlled by the LatticeResolution: the lattice has
+ * LatticeResolution vertices per standard deviation along each axis, and
+ * is blurred with LatticeResolution * LatticeResolution passes of a
+ * [1 2 1] kernel. The default of 1 is usually enough for denoising;
+ * larger values are closer to the exact filter, at the cost of many more
+ * vertices, since the vertices reached by the blur are added to the
+ * lattice.
+ *
+ * The splatting, blurring and slicing stages are multithreaded. Each
+ * thread splats its part of the image in its own hash table, and the
+ * tables are merged before the blur.
+ *
+ * \sa BilateralImageFilter
+ *
+ * \ingroup ImageEnhancement
+ * \ingroup ImageFeatureExtraction
+ * \ingroup ITKImageFeature
+ */
+template< typename TInputImage, typename TOutputImage >
+class ITK_TEMPLATE_EXPORT PermutohedralBilateralImageFilter:
+  public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard class typedefs. */
+  typedef PermutohedralBilateralImageFilter               Self;
+  typedef ImageToImageFilter< TInputImage, TOutputImage > Superclass;
+  typedef SmartPointer< Self >                            Pointer;
+  typedef SmartPointer< const Self >                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(PermutohedralBilateralImageFilter, ImageToImageFilter);
+
+  /** Image type information. */
+  typedef TInputImage  InputImageType;
+  typedef TOutputImage OutputImageType;
+
+  /** Superclass typedefs. */
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+  typedef typename TOutputImage::PixelType                    OutputPixelType;
+  typedef typename NumericTraits< OutputPixelType >::ValueType OutputPixelValueType;
+  typedef typename TInputImage::PixelType                     InputPixelType;
+
+  /** Extract some information from the image types.  Dimensionality
+   * of the two images is assumed to be the same. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TOutputImage::ImageDimension);
+
+  /** Typedef of double containers */
+  typedef FixedArray< double, itkGetStaticConstMacro(ImageDimension) > ArrayType;
+
+  /** Standard get/set macros for filter parameters.
+   * DomainSigma is specified in the same units as the Image spacing.
+   * RangeSigma is specified in the units of intensity. */
+  itkSetMacro(DomainSigma, ArrayType);
+  itkGetConstMacro(DomainSigma, const ArrayType);
+  itkSetMacro(RangeSigma, double);
+  itkGetConstMacro(RangeSigma, double);
+
+  /** Convenience get/set methods for setting all domain parameters to the
+   * same values.  */
+  void SetDomainSigma(const double v)
+  {
+    m_DomainSigma.Fill(v);
+    this->Modified();
+  }
+
+  /** Set/Get the number of lattice vertices per standard deviation along
+   * each axis of the lattice. Larger values give a better approximation
+   * of the bilateral filter, but the number of vertices grows with the
+   * power of the dimension of the feature space. Defaults to 1. */
+  itkSetClampMacro(LatticeResolution, unsigned int, 1, 8);
+  itkGetConstMacro(LatticeResolution, unsigned int);
+
+  /** Get the number of vertices of the lattice used by the last update. */
+  itkGetConstMacro(NumberOfLatticePoints, SizeValueType);
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  // Begin concept checking
+  itkConceptMacro( OutputHasNumericTraitsCheck,
+                   ( Concept::HasNumericTraits< OutputPixelValueType > ) );
+  // End concept checking
+#endif
+
+protected:
+  PermutohedralBilateralImageFilter();
+  virtual ~PermutohedralBilateralImageFilter() {}
+
+  void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+  /** The whole input is splatted on the lattice, so the whole input is
+   * requested. */
+  virtual void GenerateInputRequestedRegion() ITK_OVERRIDE;
+
+  /** The whole output is produced. */
+  virtual void EnlargeOutputRequestedRegion(DataObject *output) ITK_OVERRIDE;
+
+  void GenerateData() ITK_OVERRIDE;
+
+private:
+  ITK_DISALLOW_COPY_AND_ASSIGN(PermutohedralBilateralImageFilter);
+
+  /** Open addressing hash table mapping the coordinates of the lattice
+   * vertices to consecutive indices. Only the first KeySize coordinates
+   * of a vertex are stored, the last one is implied by the zero sum of
+   * the coordinates. */
+  class HashTable
+  {
+  public:
+    HashTable();
+
+    void Initialize(unsigned int keySize, SizeValueType capacity);
+
+    /** Return the index of a vertex, inserting it if needed. */
+    unsigned int Insert(const int *key);
+
+    /** Return the index of a vertex, or -1 if it is not in the table. */
+    int Find(const int *key) const;
+
+    const int * GetKey(unsigned int i) const
+    {
+      return &m_Keys[static_cast< SizeValueType >( i ) * m_KeySize];
+    }
+
+    unsigned int Size() const
+    {
+      return m_Size;
+    }
+
+  private:
+    SizeValueType Hash(const int *key) const;
+    void Grow();
+
+    unsigned int        m_KeySize;
+    unsigned int        m_Size;
+    std::vector< int >  m_Keys;
+    std::vector< int >  m_Entries;
+  };
+
+  /** Lattice data of the part of the image splatted by a thread. */
+  struct ThreadData
+  {
+    OutputImageRegionType       Region;
+    HashTable                   Table;
+    std::vector< double >       Values;
+    std::vector< unsigned int > Vertices;
+    std::vector< float >        Weights;
+    std::vector< unsigned int > LocalToGlobal;
+  };
+
+  struct ThreadStruct
+  {
+    Self        *Filter;
+    unsigned int Direction;
+  };
+
+  static ITK_THREAD_RETURN_TYPE SplatThreaderCallback(void *arg);
+  static ITK_THREAD_RETURN_TYPE NeighborsThreaderCallback(void *arg);
+  static ITK_THREAD_RETURN_TYPE BlurThreaderCallback(void *arg);
+  static ITK_THREAD_RETURN_TYPE SliceThreaderCallback(void *arg);
+
+  /** Splat the pixels of the region of a thread in its hash table. */
+  void ThreadedSplat(ThreadIdType threadId);
+
+  /** Merge the hash tables of the threads in m_Lattice. */
+  void MergeLattices();
+
+  /** Add the vertices within LatticeResolution steps of the lattice
+   * along an axis. */
+  void ExtendLattice(unsigned int direction);
+
+  /** Find the neighbors of a range of vertices along a lattice axis. */
+  void ThreadedFindNeighbors(unsigned int direction, ThreadIdType threadId, ThreadIdType numberOfThreads);
+
+  /** Apply a [1 2 1] blur to a range of vertices. */
+  void ThreadedBlur(ThreadIdType threadId, ThreadIdType numberOfThreads);
+
+  /** Interpolate the blurred lattice at the pixels of a thread. */
+  void ThreadedSlice(ThreadIdType threadId);
+
+  double       m_RangeSigma;
+  ArrayType    m_DomainSigma;
+  unsigned int m_LatticeResolution;
+
+  /** Dimension of the feature space and number of filtered values per
+   * vertex, i.e. the components and the homogeneous weight. */
+  unsigned int m_FeatureDimension;
+  unsigned int m_NumberOfValues;
+  unsigned int m_NumberOfComponents;
+
+  std::vector< ThreadData >   m_ThreadData;
+  HashTable                   m_Lattice;
+  std::vector< double >       m_Values;
+  std::vector< double >       m_BlurredValues;
+  std::vector< int >          m_Neighbors;
+  SizeValueType               m_NumberOfLatticePoints;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkPermutohedralBilateralImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,692 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPermutohedralBilateralImageFilter_hxx
+#define itkPermutohedralBilateralImageFilter_hxx
+
+#include "itkPermutohedralBilateralImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkProgressReporter.h"
+#include "itkMath.h"
+#include <algorithm>
+
+namespace itk
+{
+template< typename TInputImage, typename TOutputImage >
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::HashTable
+::HashTable() :
+  m_KeySize(0),
+  m_Size(0)
+{
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::HashTable
+::Initialize(unsigned int keySize, SizeValueType capacity)
+{
+  // The table is kept at most half full, with a power of two capacity
+  SizeValueType tableSize = 16;
+  while ( tableSize < 2 * capacity )
+    {
+    tableSize *= 2;
+    }
+  m_KeySize = keySize;
+  m_Size = 0;
+  m_Keys.clear();
+  m_Keys.reserve(capacity * keySize);
+  m_Entries.assign(tableSize, -1);
+}
+
+template< typename TInputImage, typename TOutputImage >
+SizeValueType
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::HashTable
+::Hash(const int *key) const
+{
+  SizeValueType h = 0;
+  for ( unsigned int i = 0; i < m_KeySize; ++i )
+    {
+    h += static_cast< SizeValueType >( key[i] );
+    h *= 2531011;
+    }
+  return h ^ ( h >> 17 );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::HashTable
+::Grow()
+{
+  const SizeValueType tableSize = 2 * m_Entries.size();
+  m_Entries.assign(tableSize, -1);
+  const SizeValueType mask = tableSize - 1;
+  for ( unsigned int i = 0; i < m_Size; ++i )
+    {
+    SizeValueType h = this->Hash( this->GetKey(i) ) & mask;
+    while ( m_Entries[h] != -1 )
+      {
+      h = ( h + 1 ) & mask;
+      }
+    m_Entries[h] = static_cast< int >( i );
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+unsigned int
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::HashTable
+::Insert(const int *key)
+{
+  if ( 2 * static_cast< SizeValueType >( m_Size + 1 ) > m_Entries.size() )
+    {
+    this->Grow();
+    }
+  const SizeValueType mask = m_Entries.size() - 1;
+  SizeValueType h = this->Hash(key) & mask;
+  while ( true )
+    {
+    const int entry = m_Entries[h];
+    if ( entry == -1 )
+      {
+      m_Entries[h] = static_cast< int >( m_Size );
+      m_Keys.insert(m_Keys.end(), key, key + m_KeySize);
+      return m_Size++;
+      }
+    if ( std::equal( key, key + m_KeySize, this->GetKey(entry) ) )
+      {
+      return static_cast< unsigned int >( entry );
+      }
+    h = ( h + 1 ) & mask;
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+int
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::HashTable
+::Find(const int *key) const
+{
+  const SizeValueType mask = m_Entries.size() - 1;
+  SizeValueType h = this->Hash(key) & mask;
+  while ( true )
+    {
+    const int entry = m_Entries[h];
+    if ( entry == -1 || std::equal( key, key + m_KeySize, this->GetKey(entry) ) )
+      {
+      return entry;
+      }
+    h = ( h + 1 ) & mask;
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::PermutohedralBilateralImageFilter() :
+  m_RangeSigma(50.0),
+  m_LatticeResolution(1),
+  m_FeatureDimension(0),
+  m_NumberOfValues(0),
+  m_NumberOfComponents(0),
+  m_NumberOfLatticePoints(0)
+{
+  m_DomainSigma.Fill(4.0);
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType *inputPtr = const_cast< InputImageType * >( this->GetInput() );
+  if ( inputPtr )
+    {
+    inputPtr->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::EnlargeOutputRequestedRegion(DataObject *output)
+{
+  Superclass::EnlargeOutputRequestedRegion(output);
+  output->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::GenerateData()
+{
+  const InputImageType *input = this->GetInput();
+
+  if ( m_RangeSigma <= 0.0 )
+    {
+    itkExceptionMacro("RangeSigma must be positive, got " << m_RangeSigma);
+    }
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    if ( m_DomainSigma[i] <= 0.0 )
+      {
+      itkExceptionMacro("DomainSigma must be positive, got " << m_DomainSigma);
+      }
+    }
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+
+  m_NumberOfComponents = input->GetNumberOfComponentsPerPixel();
+  if ( output->GetNumberOfComponentsPerPixel() != m_NumberOfComponents )
+    {
+    itkExceptionMacro("The output pixels have " << output->GetNumberOfComponentsPerPixel()
+                      << " components, but the input pixels have " << m_NumberOfComponents);
+    }
+  m_FeatureDimension = ImageDimension + m_NumberOfComponents;
+  m_NumberOfValues = m_NumberOfComponents + 1;
+
+  // Split the image between the threads. The same regions are used to
+  // splat and to slice.
+  OutputImageRegionType splitRegion;
+  const ThreadIdType numberOfThreads =
+    this->SplitRequestedRegion(0, this->GetNumberOfThreads(), splitRegion);
+  m_ThreadData.clear();
+  m_ThreadData.resize(numberOfThreads);
+  for ( ThreadIdType t = 0; t < numberOfThreads; ++t )
+    {
+    this->SplitRequestedRegion(t, numberOfThreads, m_ThreadData[t].Region);
+    }
+
+  ThreadStruct str;
+  str.Filter = this;
+  str.Direction = 0;
+
+  MultiThreader *threader = this->GetMultiThreader();
+  threader->SetNumberOfThreads(numberOfThreads);
+  threader->SetSingleMethod(this->SplatThreaderCallback, &str);
+  threader->SingleMethodExecute();
+
+  this->MergeLattices();
+
+  // Blur the lattice along each of its axes. With several passes, the
+  // vertices reached by the blur are added to the lattice first, so that
+  // the blur does not stop at the vertices touched by the pixels.
+  const unsigned int numberOfPasses = m_LatticeResolution * m_LatticeResolution;
+  m_BlurredValues.resize( m_Values.size() );
+  for ( unsigned int direction = 0; direction <= m_FeatureDimension; ++direction )
+    {
+    str.Direction = direction;
+    if ( numberOfPasses > 1 )
+      {
+      this->ExtendLattice(direction);
+      }
+    threader->SetSingleMethod(this->NeighborsThreaderCallback, &str);
+    threader->SingleMethodExecute();
+    for ( unsigned int pass = 0; pass < numberOfPasses; ++pass )
+      {
+      threader->SetSingleMethod(this->BlurThreaderCallback, &str);
+      threader->SingleMethodExecute();
+      m_Values.swap(m_BlurredValues);
+      }
+    }
+  std::vector< int >().swap(m_Neighbors);
+  std::vector< double >().swap(m_BlurredValues);
+
+  threader->SetSingleMethod(this->SliceThreaderCallback, &str);
+  threader->SingleMethodExecute();
+
+  m_ThreadData.clear();
+  std::vector< double >().swap(m_Values);
+  m_Lattice.Initialize(0, 0);
+}
+
+template< typename TInputImage, typename TOutputImage >
+ITK_THREAD_RETURN_TYPE
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::SplatThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ThreadStruct *str = static_cast< ThreadStruct * >( info->UserData );
+  str->Filter->ThreadedSplat(info->ThreadID);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TOutputImage >
+ITK_THREAD_RETURN_TYPE
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::NeighborsThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ThreadStruct *str = static_cast< ThreadStruct * >( info->UserData );
+  str->Filter->ThreadedFindNeighbors(str->Direction, info->ThreadID, info->NumberOfThreads);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TOutputImage >
+ITK_THREAD_RETURN_TYPE
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::BlurThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ThreadStruct *str = static_cast< ThreadStruct * >( info->UserData );
+  str->Filter->ThreadedBlur(info->ThreadID, info->NumberOfThreads);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TOutputImage >
+ITK_THREAD_RETURN_TYPE
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::SliceThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ThreadStruct *str = static_cast< ThreadStruct * >( info->UserData );
+  str->Filter->ThreadedSlice(info->ThreadID);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::ThreadedSplat(ThreadIdType threadId)
+{
+  ThreadData & data = m_ThreadData[threadId];
+  const unsigned int d = m_FeatureDimension;
+  const unsigned int nv = m_NumberOfValues;
+  const SizeValueType numberOfPixels = data.Region.GetNumberOfPixels();
+
+  typedef DefaultConvertPixelTraits< InputPixelType > InputPixelTraits;
+
+  // Scale of the features such that the blur along the d+1 axes of the
+  // lattice is a Gaussian of standard deviation 1. Each [1 2 1] pass has
+  // a variance of 1/2 lattice step, and the splatting and slicing add
+  // about 1/6 (Adams et al. use the value for a single pass).
+  std::vector< double > scaleFactor(d);
+  const double passes = m_LatticeResolution * m_LatticeResolution;
+  const double invStdDev = std::sqrt(0.5 * passes + 1.0 / 6.0) * ( d + 1 );
+  for ( unsigned int i = 0; i < d; ++i )
+    {
+    scaleFactor[i] = invStdDev / std::sqrt( static_cast< double >( ( i + 1 ) * ( i + 2 ) ) );
+    }
+  const typename InputImageType::SpacingType & spacing = this->GetInput()->GetSpacing();
+  ArrayType spatialScale;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    spatialScale[i] = spacing[i] / m_DomainSigma[i];
+    }
+  const double rangeScale = 1.0 / m_RangeSigma;
+
+  // Remainder-k vertices of the canonical simplex
+  std::vector< int > canonical( ( d + 1 ) * ( d + 1 ) );
+  for ( unsigned int i = 0; i <= d; ++i )
+    {
+    for ( unsigned int j = 0; j <= d - i; ++j )
+      {
+      canonical[i * ( d + 1 ) + j] = i;
+      }
+    for ( unsigned int j = d - i + 1; j <= d; ++j )
+      {
+      canonical[i * ( d + 1 ) + j] = static_cast< int >( i ) - static_cast< int >( d + 1 );
+      }
+    }
+
+  std::vector< double > feature(d);
+  std::vector< double > elevated(d + 1);
+  std::vector< int >    greedy(d + 1);
+  std::vector< int >    rank(d + 1);
+  std::vector< double > barycentric(d + 2);
+  std::vector< int >    key(d);
+  std::vector< double > value(nv);
+
+  data.Table.Initialize( d, numberOfPixels );
+  data.Values.clear();
+  data.Vertices.resize( numberOfPixels * ( d + 1 ) );
+  data.Weights.resize( numberOfPixels * ( d + 1 ) );
+
+  ProgressReporter progress(this, threadId, numberOfPixels, 100, 0.0f, 0.45f);
+
+  SizeValueType pixel = 0;
+  for ( ImageRegionConstIteratorWithIndex< InputImageType > it( this->GetInput(), data.Region );
+        !it.IsAtEnd(); ++it, ++pixel )
+    {
+    const typename InputImageType::IndexType & index = it.GetIndex();
+    const InputPixelType p = it.Get();
+    for ( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+      feature[i] = index[i] * spatialScale[i];
+      }
+    for ( unsigned int c = 0; c < m_NumberOfComponents; ++c )
+      {
+      const double v = static_cast< double >( InputPixelTraits::GetNthComponent(c, p) );
+      feature[ImageDimension + c] = v * rangeScale;
+      value[c] = v;
+      }
+    value[m_NumberOfComponents] = 1.0;
+
+    // Elevate the feature to the hyperplane of the lattice
+    double sum = 0.0;
+    for ( unsigned int i = d; i > 0; --i )
+      {
+      const double cf = feature[i - 1] * scaleFactor[i - 1];
+      elevated[i] = sum - i * cf;
+      sum += cf;
+      }
+    elevated[0] = sum;
+
+    // Find the closest remainder-0 point and the ranks of the differential
+    int sumGreedy = 0;
+    for ( unsigned int i = 0; i <= d; ++i )
+      {
+      const double v = elevated[i] / ( d + 1 );
+      const double up = std::ceil(v) * ( d + 1 );
+      const double down = std::floor(v) * ( d + 1 );
+      greedy[i] = static_cast< int >( up - elevated[i] < elevated[i] - down ? up : down );
+      sumGreedy += greedy[i];
+      rank[i] = 0;
+      }
+    sumGreedy /= static_cast< int >( d + 1 );
+    for ( unsigned int i = 0; i < d; ++i )
+      {
+      for ( unsigned int j = i + 1; j <= d; ++j )
+        {
+        if ( elevated[i] - greedy[i] < elevated[j] - greedy[j] )
+          {
+          ++rank[i];
+          }
+        else
+          {
+          ++rank[j];
+          }
+        }
+      }
+    const int dp1 = static_cast< int >( d + 1 );
+    if ( sumGreedy > 0 )
+      {
+      for ( unsigned int i = 0; i <= d; ++i )
+        {
+        if ( rank[i] >= dp1 - sumGreedy )
+          {
+          greedy[i] -= dp1;
+          rank[i] += sumGreedy - dp1;
+          }
+        else
+          {
+          rank[i] += sumGreedy;
+          }
+        }
+      }
+    else if ( sumGreedy < 0 )
+      {
+      for ( unsigned int i = 0; i <= d; ++i )
+        {
+        if ( rank[i] < -sumGreedy )
+          {
+          greedy[i] += dp1;
+          rank[i] += dp1 + sumGreedy;
+          }
+        else
+          {
+          rank[i] += sumGreedy;
+          }
+        }
+      }
+
+    // Barycentric coordinates in the enclosing simplex
+    std::fill(barycentric.begin(), barycentric.end(), 0.0);
+    for ( unsigned int i = 0; i <= d; ++i )
+      {
+      const double delta = ( elevated[i] - greedy[i] ) / ( d + 1 );
+      barycentric[d - rank[i]] += delta;
+      barycentric[d + 1 - rank[i]] -= delta;
+      }
+    barycentric[0] += 1.0 + barycentric[d + 1];
+
+    // Splat on the vertices of the simplex
+    unsigned int *vertices = &data.Vertices[pixel * ( d + 1 )];
+    float *weights = &data.Weights[pixel * ( d + 1 )];
+    for ( unsigned int r = 0; r <= d; ++r )
+      {
+      for ( unsigned int i = 0; i < d; ++i )
+        {
+        key[i] = greedy[i] + canonical[r * ( d + 1 ) + rank[i]];
+        }
+      const unsigned int vertex = data.Table.Insert(&key[0]);
+      if ( vertex * nv == data.Values.size() )
+        {
+        data.Values.resize( data.Values.size() + nv, 0.0 );
+        }
+      double *vertexValues = &data.Values[vertex * nv];
+      for ( unsigned int c = 0; c < nv; ++c )
+        {
+        vertexValues[c] += barycentric[r] * value[c];
+        }
+      vertices[r] = vertex;
+      weights[r] = static_cast< float >( barycentric[r] );
+      }
+    progress.CompletedPixel();
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::MergeLattices()
+{
+  const unsigned int nv = m_NumberOfValues;
+
+  SizeValueType capacity = 0;
+  for ( size_t t = 0; t < m_ThreadData.size(); ++t )
+    {
+    capacity += m_ThreadData[t].Table.Size();
+    }
+  m_Lattice.Initialize(m_FeatureDimension, capacity);
+  m_Values.clear();
+
+  for ( size_t t = 0; t < m_ThreadData.size(); ++t )
+    {
+    ThreadData & data = m_ThreadData[t];
+    data.LocalToGlobal.resize( data.Table.Size() );
+    for ( unsigned int i = 0; i < data.Table.Size(); ++i )
+      {
+      const unsigned int vertex = m_Lattice.Insert( data.Table.GetKey(i) );
+      if ( vertex * nv == m_Values.size() )
+        {
+        m_Values.resize( m_Values.size() + nv, 0.0 );
+        }
+      for ( unsigned int c = 0; c < nv; ++c )
+        {
+        m_Values[vertex * nv + c] += data.Values[i * nv + c];
+        }
+      data.LocalToGlobal[i] = vertex;
+      }
+    data.Table.Initialize(0, 0);
+    std::vector< double >().swap(data.Values);
+    }
+  m_NumberOfLatticePoints = m_Lattice.Size();
+  m_Neighbors.resize( 2 * static_cast< SizeValueType >( m_NumberOfLatticePoints ) );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::ExtendLattice(unsigned int direction)
+{
+  const unsigned int d = m_FeatureDimension;
+  const unsigned int nv = m_NumberOfValues;
+  const unsigned int numberOfVertices = m_Lattice.Size();
+
+  std::vector< int > key(d);
+  for ( unsigned int i = 0; i < numberOfVertices; ++i )
+    {
+    for ( int sign = -1; sign <= 1; sign += 2 )
+      {
+      std::copy( m_Lattice.GetKey(i), m_Lattice.GetKey(i) + d, key.begin() );
+      for ( unsigned int step = 0; step < m_LatticeResolution; ++step )
+        {
+        for ( unsigned int k = 0; k < d; ++k )
+          {
+          key[k] += sign;
+          }
+        if ( direction < d )
+          {
+          key[direction] -= sign * static_cast< int >( d + 1 );
+          }
+        const unsigned int vertex = m_Lattice.Insert(&key[0]);
+        if ( vertex * nv == m_Values.size() )
+          {
+          m_Values.resize( m_Values.size() + nv, 0.0 );
+          }
+        }
+      }
+    }
+  m_NumberOfLatticePoints = m_Lattice.Size();
+  m_Neighbors.resize( 2 * m_NumberOfLatticePoints );
+  m_BlurredValues.resize( m_Values.size() );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::ThreadedFindNeighbors(unsigned int direction, ThreadIdType threadId, ThreadIdType numberOfThreads)
+{
+  const unsigned int d = m_FeatureDimension;
+  const SizeValueType begin = m_NumberOfLatticePoints * threadId / numberOfThreads;
+  const SizeValueType end = m_NumberOfLatticePoints * ( threadId + 1 ) / numberOfThreads;
+
+  // The neighbors along an axis differ by +-1 on all the coordinates but
+  // the one of the axis, which differs by -+d.
+  std::vector< int > plus(d);
+  std::vector< int > minus(d);
+  for ( SizeValueType i = begin; i < end; ++i )
+    {
+    const int *key = m_Lattice.GetKey( static_cast< unsigned int >( i ) );
+    for ( unsigned int k = 0; k < d; ++k )
+      {
+      plus[k] = key[k] + 1;
+      minus[k] = key[k] - 1;
+      }
+    if ( direction < d )
+      {
+      plus[direction] = key[direction] - static_cast< int >( d );
+      minus[direction] = key[direction] + static_cast< int >( d );
+      }
+    m_Neighbors[2 * i] = m_Lattice.Find(&plus[0]);
+    m_Neighbors[2 * i + 1] = m_Lattice.Find(&minus[0]);
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::ThreadedBlur(ThreadIdType threadId, ThreadIdType numberOfThreads)
+{
+  const unsigned int nv = m_NumberOfValues;
+  const SizeValueType begin = m_NumberOfLatticePoints * threadId / numberOfThreads;
+  const SizeValueType end = m_NumberOfLatticePoints * ( threadId + 1 ) / numberOfThreads;
+
+  const double *values = &m_Values[0];
+  double *blurred = &m_BlurredValues[0];
+  for ( SizeValueType i = begin; i < end; ++i )
+    {
+    const double *center = values + i * nv;
+    double *out = blurred + i * nv;
+    for ( unsigned int c = 0; c < nv; ++c )
+      {
+      out[c] = 0.5 * center[c];
+      }
+    for ( unsigned int n = 0; n < 2; ++n )
+      {
+      const int neighbor = m_Neighbors[2 * i + n];
+      if ( neighbor >= 0 )
+        {
+        const double *neighborValues = values + static_cast< SizeValueType >( neighbor ) * nv;
+        for ( unsigned int c = 0; c < nv; ++c )
+          {
+          out[c] += 0.25 * neighborValues[c];
+          }
+        }
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::ThreadedSlice(ThreadIdType threadId)
+{
+  ThreadData & data = m_ThreadData[threadId];
+  const unsigned int d = m_FeatureDimension;
+  const unsigned int nv = m_NumberOfValues;
+  const unsigned int nc = m_NumberOfComponents;
+
+  typedef DefaultConvertPixelTraits< OutputPixelType > OutputPixelTraits;
+
+  ProgressReporter progress(this, threadId, data.Region.GetNumberOfPixels(), 100, 0.55f, 0.45f);
+
+  std::vector< double > value(nv);
+  OutputPixelType outputPixel;
+  NumericTraits< OutputPixelType >::SetLength(outputPixel, nc);
+
+  SizeValueType pixel = 0;
+  for ( ImageRegionIterator< OutputImageType > it( this->GetOutput(), data.Region );
+        !it.IsAtEnd(); ++it, ++pixel )
+    {
+    std::fill(value.begin(), value.end(), 0.0);
+    const unsigned int *vertices = &data.Vertices[pixel * ( d + 1 )];
+    const float *weights = &data.Weights[pixel * ( d + 1 )];
+    for ( unsigned int r = 0; r <= d; ++r )
+      {
+      const double *vertexValues = &m_Values[data.LocalToGlobal[vertices[r]] * nv];
+      for ( unsigned int c = 0; c < nv; ++c )
+        {
+        value[c] += weights[r] * vertexValues[c];
+        }
+      }
+    // The pixel always contributes to its own vertices, so the
+    // homogeneous weight is positive.
+    const double norm = 1.0 / value[nc];
+    for ( unsigned int c = 0; c < nc; ++c )
+      {
+      OutputPixelTraits::SetNthComponent( c, outputPixel,
+                                          static_cast< OutputPixelValueType >( value[c] * norm ) );
+      }
+    it.Set(outputPixel);
+    progress.CompletedPixel();
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+PermutohedralBilateralImageFilter< TInputImage, TOutputImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "DomainSigma: " << m_DomainSigma << std::endl;
+  os << indent << "RangeSigma: " << m_RangeSigma << std::endl;
+  os << indent << "LatticeResolution: " << m_LatticeResolution << std::endl;
+  os << indent << "NumberOfLatticePoints: " << m_NumberOfLatticePoints << std::endl;
+}
+} // end namespace itk
+
+#endif
@@ -1,6 +1,6 @@
 set(DOCUMENTATION "This module contains classes that compute image features. In
 particular you will find here: Canny edge detection, Sobel, ZeroCrossings,
-Hough transform for lines and circles, Hessian filters, Vesselness, and
+Hough transform for lines, circles and spheres, Hessian filters, Vesselness, and
 Fractional anisotropy for tensor images.")
 
 itk_module(ITKImageFeature
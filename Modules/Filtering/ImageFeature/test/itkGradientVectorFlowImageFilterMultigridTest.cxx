@@ -0,0 +1,255 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkGradientImageFilter.h"
+#include "itkGradientVectorFlowImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+// Relative residual of b v - mu Laplacian(v) = b f, with zero flux
+// boundaries and the Laplacian in physical units, computed independently
+// of the filter
+template< typename TGradientImage >
+double
+GVFRelativeResidual(const TGradientImage *input, const TGradientImage *gvf, double noiseLevel)
+{
+  const unsigned int Dimension = TGradientImage::ImageDimension;
+  typedef typename TGradientImage::IndexType IndexType;
+
+  const typename TGradientImage::RegionType  region = input->GetLargestPossibleRegion();
+  const typename TGradientImage::SpacingType spacing = input->GetSpacing();
+
+  double residualNorm = 0.0;
+  double rhsNorm = 0.0;
+  for ( itk::ImageRegionConstIteratorWithIndex< TGradientImage > it( input, region ); !it.IsAtEnd(); ++it )
+    {
+    const IndexType index = it.GetIndex();
+    const typename TGradientImage::PixelType f = it.Get();
+    const typename TGradientImage::PixelType v = gvf->GetPixel(index);
+    const double b = f.GetSquaredNorm();
+    for ( unsigned int i = 0; i < Dimension; ++i )
+      {
+      double laplacian = 0.0;
+      for ( unsigned int d = 0; d < Dimension; ++d )
+        {
+        for ( int side = -1; side <= 1; side += 2 )
+          {
+          IndexType neighbor = index;
+          neighbor[d] += side;
+          if ( region.IsInside(neighbor) )
+            {
+            laplacian += ( gvf->GetPixel(neighbor)[i] - v[i] ) / ( spacing[d] * spacing[d] );
+            }
+          }
+        }
+      const double residual = b * f[i] - b * v[i] + noiseLevel * laplacian;
+      residualNorm += residual * residual;
+      rhsNorm += b * f[i] * b * f[i];
+      }
+    }
+  return std::sqrt(residualNorm / rhsNorm);
+}
+
+template< unsigned int VDimension >
+int
+GVFMultigridTest(const itk::Size< VDimension > & size, const itk::Vector< double, VDimension > & spacing)
+{
+  typedef itk::Image< double, VDimension >                                  ImageType;
+  typedef itk::CovariantVector< double, VDimension >                        GradientType;
+  typedef itk::Image< GradientType, VDimension >                            GradientImageType;
+  typedef itk::GradientImageFilter< ImageType, double, double >             GradientFilterType;
+  typedef itk::GradientVectorFlowImageFilter< GradientImageType, GradientImageType > GVFFilterType;
+
+  // A bright box, off the center of the image
+  typename ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->SetSpacing(spacing);
+  image->Allocate();
+  for ( itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    bool inside = true;
+    for ( unsigned int d = 0; d < VDimension; ++d )
+      {
+      inside = inside && it.GetIndex()[d] >= static_cast< itk::IndexValueType >( size[d] / 4 )
+               && it.GetIndex()[d] < static_cast< itk::IndexValueType >( size[d] / 2 + 1 );
+      }
+    it.Set(inside ? 100.0 : 10.0);
+    }
+
+  typename GradientFilterType::Pointer gradient = GradientFilterType::New();
+  gradient->SetInput(image);
+  gradient->Update();
+
+  typename GVFFilterType::Pointer gvf = GVFFilterType::New();
+  gvf->SetInput( gradient->GetOutput() );
+  gvf->SetNoiseLevel(200);
+  gvf->UseMultigridSolverOn();
+  gvf->SetMaximumNumberOfVCycles(30);
+  gvf->SetTolerance(1e-7);
+  TEST_SET_GET_VALUE( true, gvf->GetUseMultigridSolver() );
+  TEST_SET_GET_VALUE( 30u, gvf->GetMaximumNumberOfVCycles() );
+
+  typename GradientImageType::Pointer singleThreaded;
+  const itk::ThreadIdType numberOfThreads[2] = { 1, 3 };
+  for ( unsigned int t = 0; t < 2; ++t )
+    {
+    gvf->SetNumberOfThreads(numberOfThreads[t]);
+    TRY_EXPECT_NO_EXCEPTION( gvf->Update() );
+
+    std::cout << VDimension << "D, spacing " << spacing << ", " << numberOfThreads[t] << " threads: " << gvf->GetElapsedVCycles()
+              << " V-cycles, relative residual " << gvf->GetRelativeResidual() << std::endl;
+
+    // The solver converges in a few V-cycles
+    if ( gvf->GetRelativeResidual() > 1e-7 || gvf->GetElapsedVCycles() > 15 )
+      {
+      std::cerr << "Test failed: the multigrid solver did not converge." << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    const double residual = GVFRelativeResidual< GradientImageType >( gradient->GetOutput(), gvf->GetOutput(), 200.0 );
+    if ( residual > 1e-6 )
+      {
+      std::cerr << "Test failed: the relative residual of the output is " << residual << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    if ( t == 0 )
+      {
+      singleThreaded = gvf->GetOutput();
+      singleThreaded->DisconnectPipeline();
+      }
+    }
+
+  itk::ImageRegionConstIterator< GradientImageType > it0( singleThreaded, singleThreaded->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< GradientImageType > it1( gvf->GetOutput(), singleThreaded->GetLargestPossibleRegion() );
+  for (; !it0.IsAtEnd(); ++it0, ++it1 )
+    {
+    if ( ( it0.Get() - it1.Get() ).GetNorm() > 1e-9 * ( 1.0 + it0.Get().GetNorm() ) )
+      {
+      std::cerr << "Test failed: the flow depends on the number of threads." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
+
+// The explicit iterations, which assume a unit spacing, converge to the
+// flow of the multigrid solver for an image with a unit spacing. The edge
+// map is weak enough for the explicit scheme to be stable.
+int
+GVFExplicitTest(const itk::Size< 2 > & size)
+{
+  typedef itk::Image< itk::CovariantVector< double, 2 >, 2 >                          GradientImageType;
+  typedef itk::GradientVectorFlowImageFilter< GradientImageType, GradientImageType >  GVFFilterType;
+
+  GradientImageType::Pointer edges = GradientImageType::New();
+  edges->SetRegions(size);
+  edges->Allocate();
+  for ( itk::ImageRegionIteratorWithIndex< GradientImageType > it( edges, edges->GetLargestPossibleRegion() );
+        !it.IsAtEnd(); ++it )
+    {
+    GradientImageType::PixelType f;
+    f[0] = it.GetIndex()[0] == 5 ? 2.0 : 0.0;
+    f[1] = it.GetIndex()[1] == 9 ? -1.5 : 0.0;
+    it.Set(f);
+    }
+
+  GVFFilterType::Pointer multigrid = GVFFilterType::New();
+  multigrid->SetInput(edges);
+  multigrid->SetNoiseLevel(200);
+  multigrid->UseMultigridSolverOn();
+  multigrid->SetTolerance(1e-9);
+  TRY_EXPECT_NO_EXCEPTION( multigrid->Update() );
+
+  GVFFilterType::Pointer explicitIterations = GVFFilterType::New();
+  explicitIterations->SetInput(edges);
+  explicitIterations->SetNoiseLevel(200);
+  explicitIterations->SetIterationNum(30000);
+  TRY_EXPECT_NO_EXCEPTION( explicitIterations->Update() );
+
+  double difference = 0.0;
+  double norm = 0.0;
+  itk::ImageRegionConstIterator< GradientImageType > multigridIt( multigrid->GetOutput(),
+                                                                  edges->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< GradientImageType > explicitIt( explicitIterations->GetOutput(),
+                                                                 edges->GetLargestPossibleRegion() );
+  for (; !multigridIt.IsAtEnd(); ++multigridIt, ++explicitIt )
+    {
+    difference += ( multigridIt.Get() - explicitIt.Get() ).GetSquaredNorm();
+    norm += multigridIt.Get().GetSquaredNorm();
+    }
+  const double relativeDifference = std::sqrt(difference / norm);
+  std::cout << "2D: relative difference between the multigrid and explicit solutions "
+            << relativeDifference << std::endl;
+  if ( !( relativeDifference <= 1e-4 ) )
+    {
+    std::cerr << "Test failed: the multigrid and explicit solutions differ." << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int itkGradientVectorFlowImageFilterMultigridTest(int, char *[])
+{
+  itk::Size< 2 > size2D;
+  size2D[0] = 64;
+  size2D[1] = 45;
+  itk::Vector< double, 2 > spacing2D;
+  spacing2D.Fill(1.0);
+  if ( GVFMultigridTest< 2 >(size2D, spacing2D) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Anisotropic spacing
+  size2D[0] = 33;
+  size2D[1] = 20;
+  spacing2D[0] = 0.8;
+  spacing2D[1] = 1.7;
+  if ( GVFMultigridTest< 2 >(size2D, spacing2D) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  size2D[0] = 20;
+  size2D[1] = 14;
+  if ( GVFExplicitTest(size2D) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  itk::Size< 3 > size3D;
+  size3D[0] = 21;
+  size3D[1] = 16;
+  size3D[2] = 7;
+  itk::Vector< double, 3 > spacing3D;
+  spacing3D[0] = 1.0;
+  spacing3D[1] = 0.5;
+  spacing3D[2] = 2.5;
+  if ( GVFMultigridTest< 3 >(size3D, spacing3D) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
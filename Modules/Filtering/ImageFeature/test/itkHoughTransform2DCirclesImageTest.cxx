@@ -142,7 +142,44 @@ int itkHoughTransform2DCirclesImageTest(int, char* [])
   houghFilter->SetMinimumRadius(0);
   houghFilter->SetMaximumRadius(20);
   houghFilter->SetSigmaGradient(1);
+  houghFilter->SetNumberOfThreads(4);
   houghFilter->Update();
+
+  // The accumulator must not depend on the number of threads
+  HoughTransformFilterType::Pointer singleThreadedFilter = HoughTransformFilterType::New();
+  singleThreadedFilter->SetInput(threshFilter->GetOutput());
+  singleThreadedFilter->SetMinimumRadius(0);
+  singleThreadedFilter->SetMaximumRadius(20);
+  singleThreadedFilter->SetSigmaGradient(1);
+  singleThreadedFilter->SetNumberOfThreads(1);
+  singleThreadedFilter->Update();
+  itk::ImageRegionConstIterator<HoughImageType> it_single(singleThreadedFilter->GetOutput(),
+                                                          singleThreadedFilter->GetOutput()->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<HoughImageType> it_multi(houghFilter->GetOutput(),
+                                                         houghFilter->GetOutput()->GetLargestPossibleRegion());
+  for(; !it_single.IsAtEnd(); ++it_single, ++it_multi)
+    {
+    if( itk::Math::NotExactlyEquals(it_single.Get(), it_multi.Get()) )
+      {
+      std::cout << "Failure: the accumulator depends on the number of threads" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  // The radii are sums of non-integer distances, whose rounding depends
+  // on the order of the votes
+  itk::ImageRegionConstIterator<HoughImageType> radius_single(singleThreadedFilter->GetRadiusImage(),
+                                                              singleThreadedFilter->GetRadiusImage()->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<HoughImageType> radius_multi(houghFilter->GetRadiusImage(),
+                                                             houghFilter->GetRadiusImage()->GetLargestPossibleRegion());
+  for(; !radius_single.IsAtEnd(); ++radius_single, ++radius_multi)
+    {
+    if( itk::Math::abs(radius_single.Get() - radius_multi.Get()) > 1e-12 * itk::Math::abs(radius_single.Get()) )
+      {
+      std::cout << "Failure: the radius image depends on the number of threads: "
+                << radius_single.Get() << " != " << radius_multi.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
   HoughImageType::Pointer m_Accumulator= houghFilter->GetOutput();
 
   HoughImageType::ConstPointer m_RadiusImage= houghFilter->GetRadiusImage();
@@ -153,7 +153,29 @@ int itkHoughTransform2DLinesImageTest(int, char* [])
     return EXIT_FAILURE;
   }
 
+  houghFilter->SetNumberOfThreads(4);
   houghFilter->Update();
+
+  // The accumulator must not depend on the number of threads
+  HoughTransformFilterType::Pointer singleThreadedFilter = HoughTransformFilterType::New();
+  singleThreadedFilter->SetInput(threshFilter->GetOutput());
+  singleThreadedFilter->SetThreshold(0.0f);
+  singleThreadedFilter->SetAngleResolution(500.0f);
+  singleThreadedFilter->SetNumberOfThreads(1);
+  singleThreadedFilter->Update();
+  itk::ImageRegionConstIterator<HoughImageType> it_single(singleThreadedFilter->GetOutput(),
+                                                          singleThreadedFilter->GetOutput()->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<HoughImageType> it_multi(houghFilter->GetOutput(),
+                                                         houghFilter->GetOutput()->GetLargestPossibleRegion());
+  for(; !it_single.IsAtEnd(); ++it_single, ++it_multi)
+    {
+    if( itk::Math::NotExactlyEquals(it_single.Get(), it_multi.Get()) )
+      {
+      std::cout << "Failure: the accumulator depends on the number of threads" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
   houghFilter->Simplify();
 
   HoughImageType::ConstPointer SimplifyAccumulator = houghFilter->GetSimplifyAccumulator();
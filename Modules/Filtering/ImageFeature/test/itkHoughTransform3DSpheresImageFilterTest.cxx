@@ -0,0 +1,166 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <iostream>
+#include "itkHoughTransform3DSpheresImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+int itkHoughTransform3DSpheresImageFilterTest(int, char *[])
+{
+  typedef itk::Image< float, 3 >                                      ImageType;
+  typedef itk::HoughTransform3DSpheresImageFilter< float, double >    FilterType;
+  typedef FilterType::OutputImageType                                 AccumulatorImageType;
+
+  FilterType::Pointer filter = FilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( filter, HoughTransform3DSpheresImageFilter, ImageToImageFilter );
+
+  TRY_EXPECT_EXCEPTION( filter->GetSpheres() );
+
+  // Bright beads on a dark background
+  const unsigned int numberOfSpheres = 3;
+  const double       centers[numberOfSpheres][3] = { { 20, 22, 18 }, { 45, 40, 30 }, { 22, 48, 40 } };
+  const double       radii[numberOfSpheres] = { 9, 12, 7 };
+
+  ImageType::SizeType size;
+  size[0] = 64;
+  size[1] = 60;
+  size[2] = 52;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate(true);
+  for ( itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    for ( unsigned int s = 0; s < numberOfSpheres; ++s )
+      {
+      double distance = 0.0;
+      for ( unsigned int d = 0; d < 3; ++d )
+        {
+        distance += ( it.GetIndex()[d] - centers[s][d] ) * ( it.GetIndex()[d] - centers[s][d] );
+        }
+      if ( std::sqrt(distance) <= radii[s] )
+        {
+        it.Set(100.0f);
+        }
+      }
+    }
+
+  filter->SetInput(image);
+  // Non-integer radii, whose sums in the radius image depend on the order
+  // of the votes
+  filter->SetMinimumRadius(4.7);
+  filter->SetMaximumRadius(15);
+  filter->SetThreshold(50.0);
+  filter->SetSigmaGradient(1.0);
+  filter->SetNumberOfSpheres(numberOfSpheres);
+  filter->SetSphereRadiusRatio(1.0);
+  filter->SetVariance(1.0);
+  TEST_SET_GET_VALUE( 15.0, filter->GetMaximumRadius() );
+  TEST_SET_GET_VALUE( numberOfSpheres, filter->GetNumberOfSpheres() );
+
+  // The votes must not depend on the number of threads, and the radii
+  // only up to the rounding of their sums. A new radius image is
+  // allocated by each update.
+  AccumulatorImageType::Pointer singleThreaded;
+  AccumulatorImageType::Pointer singleThreadedRadius;
+  const itk::ThreadIdType numberOfThreads[2] = { 1, 3 };
+  for ( unsigned int t = 0; t < 2; ++t )
+    {
+    filter->SetNumberOfThreads(numberOfThreads[t]);
+    TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+    if ( t == 0 )
+      {
+      singleThreaded = filter->GetOutput();
+      singleThreaded->DisconnectPipeline();
+      singleThreadedRadius = filter->GetRadiusImage();
+      }
+    }
+  TEST_EXPECT_TRUE( filter->GetRadiusImage() != singleThreadedRadius.GetPointer() );
+
+  const AccumulatorImageType *singleThreadedImages[2] = { singleThreaded, singleThreadedRadius };
+  const AccumulatorImageType *multiThreadedImages[2] = { filter->GetOutput(), filter->GetRadiusImage() };
+  const char *                imageNames[2] = { "accumulator", "radius image" };
+  const double                tolerances[2] = { 0.0, 1e-12 };
+  for ( unsigned int k = 0; k < 2; ++k )
+    {
+    itk::ImageRegionConstIterator< AccumulatorImageType > it0( singleThreadedImages[k],
+                                                               singleThreaded->GetLargestPossibleRegion() );
+    itk::ImageRegionConstIterator< AccumulatorImageType > it1( multiThreadedImages[k],
+                                                               singleThreaded->GetLargestPossibleRegion() );
+    for (; !it0.IsAtEnd(); ++it0, ++it1 )
+      {
+      if ( itk::Math::abs( it0.Get() - it1.Get() ) > tolerances[k] * itk::Math::abs( it0.Get() ) )
+        {
+        std::cerr << "Test failed: the " << imageNames[k] << " depends on the number of threads." << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  FilterType::SpheresListType & spheres = filter->GetSpheres();
+  TEST_EXPECT_EQUAL( spheres.size(), numberOfSpheres );
+
+  // Each sphere must be found, in any order
+  for ( FilterType::SpheresListType::const_iterator sphere = spheres.begin(); sphere != spheres.end(); ++sphere )
+    {
+    const FilterType::SphereType::VectorType center = ( *sphere )->GetObjectToParentTransform()->GetOffset();
+    const double radius = ( *sphere )->GetRadius()[0];
+    std::cout << "Sphere " << ( *sphere )->GetId() << " at " << center << ", radius " << radius << std::endl;
+
+    bool found = false;
+    for ( unsigned int s = 0; s < numberOfSpheres; ++s )
+      {
+      double distance = 0.0;
+      for ( unsigned int d = 0; d < 3; ++d )
+        {
+        distance += ( center[d] - centers[s][d] ) * ( center[d] - centers[s][d] );
+        }
+      if ( std::sqrt(distance) <= 1.5 && itk::Math::abs( radius - radii[s] ) <= 1.5 )
+        {
+        found = true;
+        }
+      }
+    if ( !found )
+      {
+      std::cerr << "Test failed: the sphere at " << center << " with radius " << radius
+                << " is not one of the expected spheres." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // The spheres are cached until the filter is modified: the same sphere
+  // objects are returned, while a new search creates new ones.
+  const FilterType::SpheresListType cachedSpheres = spheres;
+  const FilterType::SpheresListType & spheresAgain = filter->GetSpheres();
+  TEST_EXPECT_EQUAL( spheresAgain.size(), cachedSpheres.size() );
+  FilterType::SpheresListType::const_iterator cached = cachedSpheres.begin();
+  for ( FilterType::SpheresListType::const_iterator sphere = spheresAgain.begin(); sphere != spheresAgain.end();
+        ++sphere, ++cached )
+    {
+    TEST_EXPECT_TRUE( sphere->GetPointer() == cached->GetPointer() );
+    }
+
+  filter->SetNumberOfSpheres(1);
+  const FilterType::SpheresListType & oneSphere = filter->GetSpheres();
+  TEST_EXPECT_EQUAL( oneSphere.size(), 1 );
+  TEST_EXPECT_TRUE( oneSphere.front().GetPointer() != cachedSpheres.front().GetPointer() );
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,231 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <iostream>
+#include "itkPermutohedralBilateralImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkRandomImageSource.h"
+#include "itkVector.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+// Exact bilateral filter, with Gaussians evaluated without truncation
+template< typename TImage >
+double
+PermutohedralBilateralImageFilterTestExact(const TImage *image,
+                                           const typename TImage::IndexType & index,
+                                           unsigned int component,
+                                           double domainSigma,
+                                           double rangeSigma)
+{
+  typedef itk::DefaultConvertPixelTraits< typename TImage::PixelType > PixelTraits;
+
+  const typename TImage::PixelType center = image->GetPixel(index);
+  const unsigned int numberOfComponents = image->GetNumberOfComponentsPerPixel();
+  double sum = 0.0;
+  double weightSum = 0.0;
+  for ( itk::ImageRegionConstIteratorWithIndex< TImage > it( image, image->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    double distance = 0.0;
+    for ( unsigned int i = 0; i < TImage::ImageDimension; ++i )
+      {
+      const double x = ( it.GetIndex()[i] - index[i] ) / domainSigma;
+      distance += x * x;
+      }
+    for ( unsigned int c = 0; c < numberOfComponents; ++c )
+      {
+      const double x = ( static_cast< double >( PixelTraits::GetNthComponent(c, it.Get()) )
+                         - static_cast< double >( PixelTraits::GetNthComponent(c, center) ) ) / rangeSigma;
+      distance += x * x;
+      }
+    const double weight = std::exp(-0.5 * distance);
+    sum += weight * static_cast< double >( PixelTraits::GetNthComponent(component, it.Get()) );
+    weightSum += weight;
+    }
+  return sum / weightSum;
+}
+
+// Mean absolute difference between the fast and the exact filter
+template< typename TImage >
+double
+PermutohedralBilateralImageFilterTestError(const TImage *input,
+                                           const TImage *output,
+                                           double domainSigma,
+                                           double rangeSigma)
+{
+  typedef itk::DefaultConvertPixelTraits< typename TImage::PixelType > PixelTraits;
+
+  double error = 0.0;
+  unsigned int count = 0;
+  for ( itk::ImageRegionConstIteratorWithIndex< TImage > it( output, output->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    for ( unsigned int c = 0; c < input->GetNumberOfComponentsPerPixel(); ++c )
+      {
+      const double exact =
+        PermutohedralBilateralImageFilterTestExact(input, it.GetIndex(), c, domainSigma, rangeSigma);
+      error += itk::Math::abs( exact - static_cast< double >( PixelTraits::GetNthComponent(c, it.Get()) ) );
+      ++count;
+      }
+    }
+  return error / count;
+}
+
+// Run the filter on a noisy image made of two constant regions separated
+// by a sphere, with a different contrast in each component, and compare
+// with the exact filter. The result must not depend on the number of
+// threads.
+template< typename TImage >
+int
+PermutohedralBilateralImageFilterTestCompare(const typename TImage::SizeType & size,
+                                             double domainSigma,
+                                             double rangeSigma,
+                                             unsigned int latticeResolution,
+                                             double tolerance)
+{
+  typedef itk::PermutohedralBilateralImageFilter< TImage, TImage > FilterType;
+  typedef typename TImage::PixelType                               PixelType;
+  typedef itk::DefaultConvertPixelTraits< PixelType >              PixelTraits;
+  typedef typename PixelTraits::ComponentType                      ComponentType;
+
+  typename TImage::Pointer input = TImage::New();
+  input->SetRegions(size);
+  input->Allocate();
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1 );
+
+  for ( itk::ImageRegionIteratorWithIndex< TImage > it( input, input->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    double radius = 0.0;
+    for ( unsigned int i = 0; i < TImage::ImageDimension; ++i )
+      {
+      const double x = it.GetIndex()[i] - 0.5 * size[i];
+      radius += x * x;
+      }
+    const bool inside = radius < 0.1 * size[0] * size[0];
+    PixelType pixel = it.Get();
+    for ( unsigned int c = 0; c < input->GetNumberOfComponentsPerPixel(); ++c )
+      {
+      const double noise = generator->GetUniformVariate( -10.0, 10.0 );
+      PixelTraits::SetNthComponent( c, pixel,
+                                    static_cast< ComponentType >( ( inside ? 100.0 / ( c + 1 ) : 0.0 ) + noise ) );
+      }
+    it.Set(pixel);
+    }
+
+  typename TImage::Pointer outputs[2];
+  const itk::ThreadIdType numberOfThreads[2] = { 1, 3 };
+  for ( unsigned int t = 0; t < 2; ++t )
+    {
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(input);
+    filter->SetDomainSigma(domainSigma);
+    filter->SetRangeSigma(rangeSigma);
+    filter->SetLatticeResolution(latticeResolution);
+    filter->SetNumberOfThreads(numberOfThreads[t]);
+    TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+    outputs[t] = filter->GetOutput();
+    outputs[t]->DisconnectPipeline();
+    }
+
+  itk::ImageRegionConstIteratorWithIndex< TImage > it0( outputs[0], outputs[0]->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIteratorWithIndex< TImage > it1( outputs[1], outputs[1]->GetLargestPossibleRegion() );
+  for (; !it0.IsAtEnd(); ++it0, ++it1 )
+    {
+    for ( unsigned int c = 0; c < input->GetNumberOfComponentsPerPixel(); ++c )
+      {
+      if ( itk::Math::abs( static_cast< double >( PixelTraits::GetNthComponent(c, it0.Get()) )
+                           - static_cast< double >( PixelTraits::GetNthComponent(c, it1.Get()) ) ) > 1e-3 )
+        {
+        std::cerr << "Test failed: the result depends on the number of threads at "
+                  << it0.GetIndex() << ": " << it0.Get() << " != " << it1.Get() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  const double error = PermutohedralBilateralImageFilterTestError(input.GetPointer(), outputs[0].GetPointer(),
+                                                                  domainSigma, rangeSigma);
+  std::cout << "Size " << size << ", " << input->GetNumberOfComponentsPerPixel() << " components, lattice resolution "
+            << latticeResolution << ": mean absolute error " << error << std::endl;
+  if ( error > tolerance )
+    {
+    std::cerr << "Test failed: the mean absolute error " << error << " exceeds " << tolerance << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int itkPermutohedralBilateralImageFilterTest(int, char *[])
+{
+  typedef itk::Image< float, 2 >                                       ImageType;
+  typedef itk::PermutohedralBilateralImageFilter< ImageType, ImageType > FilterType;
+
+  FilterType::Pointer filter = FilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( filter, PermutohedralBilateralImageFilter, ImageToImageFilter );
+
+  TEST_SET_GET_VALUE( 50.0, filter->GetRangeSigma() );
+  filter->SetRangeSigma(20.0);
+  TEST_SET_GET_VALUE( 20.0, filter->GetRangeSigma() );
+  filter->SetDomainSigma(2.0);
+  TEST_SET_GET_VALUE( 2.0, filter->GetDomainSigma()[1] );
+  TEST_SET_GET_VALUE( 1, filter->GetLatticeResolution() );
+  filter->SetLatticeResolution(0);
+  TEST_SET_GET_VALUE( 1, filter->GetLatticeResolution() );
+
+  ImageType::SizeType size2;
+  size2.Fill(8);
+  typedef itk::RandomImageSource< ImageType > SourceType;
+  SourceType::Pointer source = SourceType::New();
+  source->SetSize(size2);
+  filter->SetInput( source->GetOutput() );
+  filter->SetRangeSigma(0.0);
+  TRY_EXPECT_EXCEPTION( filter->Update() );
+  filter->SetRangeSigma(20.0);
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+  int status = EXIT_SUCCESS;
+
+  size2[0] = 41;
+  size2[1] = 37;
+  status |= PermutohedralBilateralImageFilterTestCompare< ImageType >(size2, 3.0, 20.0, 1, 0.5);
+  status |= PermutohedralBilateralImageFilterTestCompare< ImageType >(size2, 3.0, 20.0, 2, 0.1);
+
+  typedef itk::Image< float, 3 > Image3DType;
+  Image3DType::SizeType size3;
+  size3[0] = 17;
+  size3[1] = 15;
+  size3[2] = 13;
+  status |= PermutohedralBilateralImageFilterTestCompare< Image3DType >(size3, 2.0, 20.0, 1, 0.5);
+
+  typedef itk::Image< itk::Vector< float, 2 >, 2 > VectorImageType;
+  status |= PermutohedralBilateralImageFilterTestCompare< VectorImageType >(size2, 3.0, 20.0, 1, 0.5);
+
+  if ( status == EXIT_SUCCESS )
+    {
+    std::cout << "Test passed." << std::endl;
+    }
+  return status;
+}
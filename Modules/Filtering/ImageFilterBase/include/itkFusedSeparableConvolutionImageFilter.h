@@ -0,0 +1,164 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFusedSeparableConvolutionImageFilter_h
+#define itkFusedSeparableConvolutionImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkNeighborhoodOperator.h"
+#include <vector>
+
+namespace itk
+{
+/** \class FusedSeparableConvolutionImageFilter
+ * \brief Convolves an image with a separable kernel, filtering all the
+ * directions in a single pass over the image.
+ *
+ * A separable filter is usually implemented as a chain of one
+ * dimensional NeighborhoodOperatorImageFilter, one per direction, each
+ * of them writing a full intermediate image. This filter instead splits
+ * the output region of each thread in tiles. For each tile, the input
+ * tile padded by the kernel radius is copied in a buffer of
+ * TOperatorValueType, and the one dimensional kernels are applied in
+ * turn, each pass reading one buffer and writing to the other, before the
+ * result is written to the output. Only the output image is allocated,
+ * and the tiles are small enough to stay in cache while they are
+ * filtered.
+ *
+ * The buffers store the pixel components contiguously, and along every
+ * direction, including the strided ones, the convolution is computed as
+ * weighted sums of contiguous blocks of the buffer, so all the inner
+ * loops run over contiguous memory and can be vectorized by the compiler.
+ *
+ * The image is extended with a zero flux Neumann boundary condition, the
+ * default of NeighborhoodOperatorImageFilter. The results differ from a
+ * chain of NeighborhoodOperatorImageFilter only because no intermediate
+ * result is rounded to the output pixel type.
+ *
+ * The kernel of a direction is set either directly, with SetKernel(), or
+ * from a directional NeighborhoodOperator, with SetOperator(). The
+ * directions without a kernel are not filtered.
+ *
+ * \sa NeighborhoodOperatorImageFilter
+ * \sa DiscreteGaussianImageFilter
+ * \ingroup ImageFilters
+ * \ingroup ITKImageFilterBase
+ */
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType = double >
+class ITK_TEMPLATE_EXPORT FusedSeparableConvolutionImageFilter:
+  public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard class typedefs. */
+  typedef FusedSeparableConvolutionImageFilter            Self;
+  typedef ImageToImageFilter< TInputImage, TOutputImage > Superclass;
+  typedef SmartPointer< Self >                            Pointer;
+  typedef SmartPointer< const Self >                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(FusedSeparableConvolutionImageFilter, ImageToImageFilter);
+
+  /** Image typedef support. */
+  typedef TInputImage                              InputImageType;
+  typedef TOutputImage                             OutputImageType;
+  typedef typename InputImageType::Pointer         InputImagePointer;
+  typedef typename InputImageType::PixelType       InputPixelType;
+  typedef typename OutputImageType::PixelType      OutputPixelType;
+  typedef typename OutputImageType::RegionType     OutputImageRegionType;
+  typedef TOperatorValueType                       OperatorValueType;
+
+  typedef typename NumericTraits< OutputPixelType >::ValueType OutputPixelValueType;
+
+  /** Extract some information from the image types.  Dimensionality
+   * of the two images is assumed to be the same. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TOutputImage::ImageDimension);
+  itkStaticConstMacro(InputImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+
+  /** One dimensional kernel. Its size must be odd, and its center
+   * coefficient is applied to the current pixel. */
+  typedef std::vector< OperatorValueType > KernelType;
+
+  /** Type of the directional operators accepted by SetOperator(). */
+  typedef NeighborhoodOperator< OperatorValueType,
+                                itkGetStaticConstMacro(ImageDimension) > OperatorType;
+
+  /** Set the kernel applied along a direction. An empty kernel disables
+   * the filtering along that direction. */
+  void SetKernel(unsigned int direction, const KernelType & kernel);
+
+  /** Get the kernel applied along a direction. */
+  const KernelType & GetKernel(unsigned int direction) const;
+
+  /** Set the kernel of the direction of a directional operator, i.e. an
+   * operator created with CreateDirectional(), from its coefficients. */
+  void SetOperator(const OperatorType & op);
+
+  /** Remove the kernels of all the directions. */
+  void ClearKernels();
+
+  /** Set/Get the maximum number of output pixels filtered at once by a
+   * thread. The buffers of a thread hold the tile padded by the kernel
+   * radius, so this should be chosen so that they fit in the cache.
+   * Defaults to 32768. */
+  itkSetClampMacro(TileSize, SizeValueType, 1, NumericTraits< SizeValueType >::max());
+  itkGetConstMacro(TileSize, SizeValueType);
+
+  /** The input requested region is the output requested region padded
+   * by the kernel radius. */
+  virtual void GenerateInputRequestedRegion() ITK_OVERRIDE;
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  // Begin concept checking
+  itkConceptMacro( SameDimensionCheck,
+                   ( Concept::SameDimension< InputImageDimension, ImageDimension > ) );
+  itkConceptMacro( OperatorConvertibleToOutputCheck,
+                   ( Concept::Convertible< OperatorValueType, OutputPixelValueType > ) );
+  // End concept checking
+#endif
+
+protected:
+  FusedSeparableConvolutionImageFilter();
+  virtual ~FusedSeparableConvolutionImageFilter() {}
+
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId) ITK_OVERRIDE;
+
+  /** Filter one tile of the output, using the two given buffers. */
+  void FilterTile(const OutputImageRegionType & tile,
+                  std::vector< OperatorValueType > & buffer,
+                  std::vector< OperatorValueType > & otherBuffer);
+
+  void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+private:
+  ITK_DISALLOW_COPY_AND_ASSIGN(FusedSeparableConvolutionImageFilter);
+
+  std::vector< KernelType > m_Kernels;
+  SizeValueType             m_TileSize;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkFusedSeparableConvolutionImageFilter.hxx"
+#endif
+
+#endif
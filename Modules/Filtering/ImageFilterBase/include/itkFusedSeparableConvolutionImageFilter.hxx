@@ -0,0 +1,363 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFusedSeparableConvolutionImageFilter_hxx
+#define itkFusedSeparableConvolutionImageFilter_hxx
+
+#include "itkFusedSeparableConvolutionImageFilter.h"
+
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionSplitterMultidimensional.h"
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkProgressReporter.h"
+
+namespace itk
+{
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+FusedSeparableConvolutionImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::FusedSeparableConvolutionImageFilter() :
+  m_Kernels( ImageDimension ),
+  m_TileSize( 32768 )
+{
+}
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+void
+FusedSeparableConvolutionImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::SetKernel(unsigned int direction, const KernelType & kernel)
+{
+  if ( direction >= ImageDimension )
+    {
+    itkExceptionMacro(<< "Direction " << direction << " is not smaller than the image dimension "
+                      << ImageDimension);
+    }
+  if ( kernel.size() % 2 == 0 && !kernel.empty() )
+    {
+    itkExceptionMacro(<< "The kernel size must be odd, got " << kernel.size());
+    }
+  m_Kernels[direction] = kernel;
+  this->Modified();
+}
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+const typename FusedSeparableConvolutionImageFilter< TInputImage, TOutputImage, TOperatorValueType >::KernelType &
+FusedSeparableConvolutionImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::GetKernel(unsigned int direction) const
+{
+  if ( direction >= ImageDimension )
+    {
+    itkExceptionMacro(<< "Direction " << direction << " is not smaller than the image dimension "
+                      << ImageDimension);
+    }
+  return m_Kernels[direction];
+}
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+void
+FusedSeparableConvolutionImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::SetOperator(const OperatorType & op)
+{
+  const unsigned long direction = op.GetDirection();
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    if ( i != direction && op.GetRadius(i) != 0 )
+      {
+      itkExceptionMacro(<< "The operator is not directional: its radius is " << op.GetRadius());
+      }
+    }
+
+  KernelType kernel( op.Size() );
+  for ( unsigned int i = 0; i < op.Size(); ++i )
+    {
+    kernel[i] = op[i];
+    }
+  this->SetKernel(direction, kernel);
+}
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+void
+FusedSeparableConvolutionImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::ClearKernels()
+{
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    m_Kernels[i].clear();
+    }
+  this->Modified();
+}
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+void
+FusedSeparableConvolutionImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::GenerateInputRequestedRegion()
+{
+  // call the superclass' implementation of this method. this should
+  // copy the output requested region to the input requested region
+  Superclass::GenerateInputRequestedRegion();
+
+  // get pointers to the input and output
+  InputImagePointer inputPtr =
+    const_cast< TInputImage * >( this->GetInput() );
+
+  if ( !inputPtr )
+    {
+    return;
+    }
+
+  typename TInputImage::SizeType radius;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    radius[i] = m_Kernels[i].size() / 2;
+    }
+
+  // pad the input requested region by the kernel radius
+  typename TInputImage::RegionType inputRequestedRegion = inputPtr->GetRequestedRegion();
+  inputRequestedRegion.PadByRadius(radius);
+
+  // crop the input requested region at the input's largest possible region
+  if ( inputRequestedRegion.Crop( inputPtr->GetLargestPossibleRegion() ) )
+    {
+    inputPtr->SetRequestedRegion(inputRequestedRegion);
+    return;
+    }
+  else
+    {
+    // Couldn't crop the region (requested region is outside the largest
+    // possible region).  Throw an exception.
+
+    // store what we tried to request (prior to trying to crop)
+    inputPtr->SetRequestedRegion(inputRequestedRegion);
+
+    // build an exception
+    InvalidRequestedRegionError e(__FILE__, __LINE__);
+    e.SetLocation(ITK_LOCATION);
+    e.SetDescription("Requested region is (at least partially) outside the largest possible region.");
+    e.SetDataObject(inputPtr);
+    throw e;
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+void
+FusedSeparableConvolutionImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  ImageRegionSplitterMultidimensional::Pointer splitter = ImageRegionSplitterMultidimensional::New();
+  const SizeValueType requestedNumberOfTiles =
+    ( outputRegionForThread.GetNumberOfPixels() + m_TileSize - 1 ) / m_TileSize;
+  const unsigned int numberOfTiles = splitter->GetNumberOfSplits( outputRegionForThread,
+    static_cast< unsigned int >( std::min( requestedNumberOfTiles,
+                                           static_cast< SizeValueType >( NumericTraits< unsigned int >::max() ) ) ) );
+
+  // The buffers are reused by all the tiles of the thread
+  std::vector< OperatorValueType > buffer;
+  std::vector< OperatorValueType > otherBuffer;
+
+  for ( unsigned int i = 0; i < numberOfTiles; ++i )
+    {
+    OutputImageRegionType tile = outputRegionForThread;
+    splitter->GetSplit(i, numberOfTiles, tile);
+
+    this->FilterTile(tile, buffer, otherBuffer);
+
+    for ( SizeValueType n = 0; n < tile.GetNumberOfPixels(); ++n )
+      {
+      progress.CompletedPixel();
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+void
+FusedSeparableConvolutionImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::FilterTile(const OutputImageRegionType & tile,
+             std::vector< OperatorValueType > & buffer,
+             std::vector< OperatorValueType > & otherBuffer)
+{
+  typedef DefaultConvertPixelTraits< InputPixelType >  InputPixelTraits;
+  typedef DefaultConvertPixelTraits< OutputPixelType > OutputPixelTraits;
+  typedef typename InputImageType::RegionType          InputRegionType;
+  typedef typename InputImageType::IndexType           InputIndexType;
+  typedef typename InputImageType::SizeType            InputSizeType;
+
+  const InputImageType * input = this->GetInput();
+  OutputImageType *      output = this->GetOutput();
+
+  const unsigned int     numberOfComponents = input->GetNumberOfComponentsPerPixel();
+  const InputRegionType  bufferedRegion = input->GetBufferedRegion();
+  const InputIndexType   bufferedStart = bufferedRegion.GetIndex();
+  const InputIndexType   bufferedEnd = bufferedRegion.GetUpperIndex();
+
+  // Extent of the buffer, starting with the tile padded by the kernel radius
+  InputRegionType paddedTile;
+  InputSizeType   radius;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    radius[d] = m_Kernels[d].size() / 2;
+    }
+  paddedTile.SetIndex( tile.GetIndex() );
+  paddedTile.SetSize( tile.GetSize() );
+  paddedTile.PadByRadius(radius);
+
+  SizeValueType extent[ImageDimension];
+  SizeValueType numberOfRows = 1;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    extent[d] = paddedTile.GetSize()[d];
+    if ( d > 0 )
+      {
+      numberOfRows *= extent[d];
+      }
+    }
+  buffer.resize( numberOfComponents * extent[0] * numberOfRows );
+
+  // Copy the padded tile in the buffer, one row along the first direction
+  // at a time. The indices outside the buffered region are clamped to it.
+  const OffsetValueType rowBegin = paddedTile.GetIndex()[0];
+  const OffsetValueType rowEnd = rowBegin + static_cast< OffsetValueType >( extent[0] );
+  const OffsetValueType inBegin = std::min( std::max( rowBegin, bufferedStart[0] ), bufferedEnd[0] );
+  const OffsetValueType inEnd = std::max( std::min( rowEnd, bufferedEnd[0] + 1 ), inBegin + 1 );
+
+  OperatorValueType * value = &buffer[0];
+  for ( SizeValueType row = 0; row < numberOfRows; ++row )
+    {
+    InputIndexType rowIndex;
+    rowIndex[0] = inBegin;
+    SizeValueType r = row;
+    for ( unsigned int d = 1; d < ImageDimension; ++d )
+      {
+      const OffsetValueType index = paddedTile.GetIndex()[d] + static_cast< OffsetValueType >( r % extent[d] );
+      r /= extent[d];
+      rowIndex[d] = std::min( std::max( index, bufferedStart[d] ), bufferedEnd[d] );
+      }
+    InputSizeType rowSize;
+    rowSize.Fill(1);
+    rowSize[0] = static_cast< SizeValueType >( inEnd - inBegin );
+
+    OperatorValueType * const rowStart = value;
+    value += numberOfComponents * ( inBegin - rowBegin );
+    for ( ImageRegionConstIterator< InputImageType > it( input, InputRegionType(rowIndex, rowSize) );
+          !it.IsAtEnd(); ++it )
+      {
+      const InputPixelType pixel = it.Get();
+      for ( unsigned int c = 0; c < numberOfComponents; ++c )
+        {
+        *value++ = static_cast< OperatorValueType >( InputPixelTraits::GetNthComponent(c, pixel) );
+        }
+      }
+
+    // Replicate the first and last pixel of the row in its padding
+    const OperatorValueType * first = rowStart + numberOfComponents * ( inBegin - rowBegin );
+    for ( OperatorValueType * p = rowStart; p < first; p += numberOfComponents )
+      {
+      std::copy(first, first + numberOfComponents, p);
+      }
+    const OperatorValueType * last = value - numberOfComponents;
+    for ( OffsetValueType i = inEnd; i < rowEnd; ++i )
+      {
+      std::copy(last, last + numberOfComponents, value);
+      value += numberOfComponents;
+      }
+    }
+
+  // Filter along each direction. Along direction d, the buffer is a
+  // sequence of blocks of extent[d] contiguous slices of stride values,
+  // one for each index in the directions after d, and each slice of the
+  // result is a weighted sum of 2 * radius + 1 consecutive slices.
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    const KernelType & kernel = m_Kernels[d];
+    if ( kernel.empty() )
+      {
+      continue;
+      }
+
+    SizeValueType stride = numberOfComponents;
+    for ( unsigned int e = 0; e < d; ++e )
+      {
+      stride *= extent[e];
+      }
+    SizeValueType numberOfBlocks = 1;
+    for ( unsigned int e = d + 1; e < ImageDimension; ++e )
+      {
+      numberOfBlocks *= extent[e];
+      }
+    const SizeValueType outputExtent = extent[d] - 2 * radius[d];
+    const SizeValueType inputBlockSize = extent[d] * stride;
+    const SizeValueType outputBlockSize = outputExtent * stride;
+
+    otherBuffer.resize( numberOfBlocks * outputBlockSize );
+
+    for ( SizeValueType b = 0; b < numberOfBlocks; ++b )
+      {
+      const OperatorValueType * in = &buffer[b * inputBlockSize];
+      OperatorValueType *       out = &otherBuffer[b * outputBlockSize];
+
+      const OperatorValueType w0 = kernel[0];
+      for ( SizeValueType i = 0; i < outputBlockSize; ++i )
+        {
+        out[i] = w0 * in[i];
+        }
+      for ( SizeValueType k = 1; k < kernel.size(); ++k )
+        {
+        const OperatorValueType   w = kernel[k];
+        const OperatorValueType * shifted = in + k * stride;
+        for ( SizeValueType i = 0; i < outputBlockSize; ++i )
+          {
+          out[i] += w * shifted[i];
+          }
+        }
+      }
+
+    extent[d] = outputExtent;
+    buffer.swap(otherBuffer);
+    }
+
+  // Write the result, in the same order as the buffer
+  OutputPixelType outputPixel;
+  NumericTraits< OutputPixelType >::SetLength(outputPixel, numberOfComponents);
+
+  value = &buffer[0];
+  for ( ImageRegionIterator< OutputImageType > it(output, tile); !it.IsAtEnd(); ++it )
+    {
+    for ( unsigned int c = 0; c < numberOfComponents; ++c )
+      {
+      OutputPixelTraits::SetNthComponent( c, outputPixel, static_cast< OutputPixelValueType >( *value++ ) );
+      }
+    it.Set(outputPixel);
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+void
+FusedSeparableConvolutionImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    os << indent << "Kernel[" << i << "] size: " << m_Kernels[i].size() << std::endl;
+    }
+  os << indent << "TileSize: " << m_TileSize << std::endl;
+}
+} // end namespace itk
+
+#endif
@@ -45,6 +45,14 @@ namespace itk
  * G. Farneback & C.-F. Westin, "On Implementation of Recursive Gaussian
  * Filters", so far unpublished.
  *
+ * Along the first direction the image is filtered one line at a time.
+ * Along the other directions, lines adjacent in the first direction are
+ * filtered together, by blocks of up to MultiLineBlockSize lines: the
+ * pixels of the block are interleaved, so they are read and written
+ * contiguously instead of with the stride of the direction, and the
+ * recursions of all the lines and components of the block run in the
+ * same inner loop, which the compiler can vectorize.
+ *
  * \ingroup ImageFilters
  * \ingroup ITKImageFilterBase
  */
@@ -133,6 +141,22 @@ protected:
   void FilterDataArray(RealType *outs, const RealType *data, RealType *scratch,
                        SizeValueType ln);
 
+  /** Apply the Recursive Filter to a block of interleaved lines. The
+   * arrays hold ln rows of numberOfValues values, the components of the
+   * pixels of all the lines at the same position, and each of the
+   * numberOfValues columns is filtered as by FilterDataArray(). */
+  void FilterDataArrayMultiLine(ScalarRealType *outs, const ScalarRealType *data,
+                                ScalarRealType *scratch, SizeValueType ln,
+                                SizeValueType numberOfValues);
+
+  /** Filter the lines of a region by blocks of adjacent lines. */
+  void ThreadedGenerateDataMultiLine(const OutputImageRegionType & outputRegionForThread,
+                                     ThreadIdType threadId);
+
+  /** Maximum number of lines filtered together by
+   * ThreadedGenerateDataMultiLine(). */
+  itkStaticConstMacro(MultiLineBlockSize, unsigned int, 8);
+
 protected:
   /** Causal coefficients that multiply the input data. */
   ScalarRealType m_N0;
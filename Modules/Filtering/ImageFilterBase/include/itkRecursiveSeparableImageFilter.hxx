@@ -21,6 +21,8 @@
 #include "itkRecursiveSeparableImageFilter.h"
 #include "itkObjectFactory.h"
 #include "itkImageLinearIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkDefaultConvertPixelTraits.h"
 #include "itkProgressReporter.h"
 #include <new>
 
@@ -170,6 +172,111 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
     }
 }
 
+/**
+ * Apply Recursive Filter to interleaved lines
+ */
+template< typename TInputImage, typename TOutputImage >
+void
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::FilterDataArrayMultiLine(ScalarRealType *outs, const ScalarRealType *data,
+                           ScalarRealType *scratch, SizeValueType ln,
+                           SizeValueType numberOfValues)
+{
+  // The same operations as FilterDataArray(), applied to the columns of
+  // rows of numberOfValues values
+  const SizeValueType n = numberOfValues;
+
+  ScalarRealType * scratch1 = outs;
+  ScalarRealType * scratch2 = scratch;
+
+  /**
+   * Causal direction pass
+   */
+  const ScalarRealType * outV1 = data;
+  for ( SizeValueType j = 0; j < n; j++ )
+    {
+    const ScalarRealType v = outV1[j];
+    scratch1[j]         = v * m_N0 + v * m_N1 + v * m_N2 + v * m_N3;
+    scratch1[n + j]     = data[n + j] * m_N0 + v * m_N1 + v * m_N2 + v * m_N3;
+    scratch1[2 * n + j] = data[2 * n + j] * m_N0 + data[n + j] * m_N1 + v * m_N2 + v * m_N3;
+    scratch1[3 * n + j] = data[3 * n + j] * m_N0 + data[2 * n + j] * m_N1 + data[n + j] * m_N2 + v * m_N3;
+
+    scratch1[j]         -= v * m_BN1 + v * m_BN2 + v * m_BN3 + v * m_BN4;
+    scratch1[n + j]     -= scratch1[j] * m_D1 + v * m_BN2 + v * m_BN3 + v * m_BN4;
+    scratch1[2 * n + j] -= scratch1[n + j] * m_D1 + scratch1[j] * m_D2 + v * m_BN3 + v * m_BN4;
+    scratch1[3 * n + j] -= scratch1[2 * n + j] * m_D1 + scratch1[n + j] * m_D2 + scratch1[j] * m_D3 + v * m_BN4;
+    }
+
+  for ( SizeValueType i = 4; i < ln; i++ )
+    {
+    ScalarRealType *       s0 = scratch1 + i * n;
+    const ScalarRealType * s1 = s0 - n;
+    const ScalarRealType * s2 = s1 - n;
+    const ScalarRealType * s3 = s2 - n;
+    const ScalarRealType * s4 = s3 - n;
+    const ScalarRealType * d0 = data + i * n;
+    const ScalarRealType * d1 = d0 - n;
+    const ScalarRealType * d2 = d1 - n;
+    const ScalarRealType * d3 = d2 - n;
+    for ( SizeValueType j = 0; j < n; j++ )
+      {
+      s0[j] = d0[j] * m_N0 + d1[j] * m_N1 + d2[j] * m_N2 + d3[j] * m_N3;
+      s0[j] -= s1[j] * m_D1 + s2[j] * m_D2 + s3[j] * m_D3 + s4[j] * m_D4;
+      }
+    }
+
+  /**
+   * AntiCausal direction pass
+   */
+  const ScalarRealType * outV2 = data + ( ln - 1 ) * n;
+  ScalarRealType *       e0 = scratch2 + ( ln - 1 ) * n;
+  ScalarRealType *       e1 = e0 - n;
+  ScalarRealType *       e2 = e1 - n;
+  ScalarRealType *       e3 = e2 - n;
+  const ScalarRealType * de0 = outV2;
+  const ScalarRealType * de1 = de0 - n;
+  const ScalarRealType * de2 = de1 - n;
+  for ( SizeValueType j = 0; j < n; j++ )
+    {
+    const ScalarRealType v = outV2[j];
+    e0[j] = v * m_M1 + v * m_M2 + v * m_M3 + v * m_M4;
+    e1[j] = de0[j] * m_M1 + v * m_M2 + v * m_M3 + v * m_M4;
+    e2[j] = de1[j] * m_M1 + de0[j] * m_M2 + v * m_M3 + v * m_M4;
+    e3[j] = de2[j] * m_M1 + de1[j] * m_M2 + de0[j] * m_M3 + v * m_M4;
+
+    e0[j] -= v * m_BM1 + v * m_BM2 + v * m_BM3 + v * m_BM4;
+    e1[j] -= e0[j] * m_D1 + v * m_BM2 + v * m_BM3 + v * m_BM4;
+    e2[j] -= e1[j] * m_D1 + e0[j] * m_D2 + v * m_BM3 + v * m_BM4;
+    e3[j] -= e2[j] * m_D1 + e1[j] * m_D2 + e0[j] * m_D3 + v * m_BM4;
+    }
+
+  for ( SizeValueType i = ln - 4; i > 0; i-- )
+    {
+    ScalarRealType *       s0 = scratch2 + ( i - 1 ) * n;
+    const ScalarRealType * s1 = s0 + n;
+    const ScalarRealType * s2 = s1 + n;
+    const ScalarRealType * s3 = s2 + n;
+    const ScalarRealType * s4 = s3 + n;
+    const ScalarRealType * d0 = data + i * n;
+    const ScalarRealType * d1 = d0 + n;
+    const ScalarRealType * d2 = d1 + n;
+    const ScalarRealType * d3 = d2 + n;
+    for ( SizeValueType j = 0; j < n; j++ )
+      {
+      s0[j] = d0[j] * m_M1 + d1[j] * m_M2 + d2[j] * m_M3 + d3[j] * m_M4;
+      s0[j] -= s1[j] * m_D1 + s2[j] * m_D2 + s3[j] * m_D3 + s4[j] * m_D4;
+      }
+    }
+
+  /**
+   * Roll the antiCausal part into the output
+   */
+  for ( SizeValueType i = 0; i < ln * n; i++ )
+    {
+    outs[i] += scratch2[i];
+    }
+}
+
 //
 // we need all of the image in just the "Direction" we are separated into
 //
@@ -262,6 +369,12 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
 
   typedef ImageRegion< TInputImage::ImageDimension > RegionType;
 
+  if ( this->m_Direction != 0 )
+    {
+    this->ThreadedGenerateDataMultiLine(outputRegionForThread, threadId);
+    return;
+    }
+
   typename TInputImage::ConstPointer inputImage( this->GetInputImage () );
   typename TOutputImage::Pointer     outputImage( this->GetOutput() );
 
@@ -337,6 +450,111 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
   delete[] scratch;
 }
 
+/**
+ * Compute Recursive filter
+ * by blocks of lines adjacent in the first dimension
+ */
+template< typename TInputImage, typename TOutputImage >
+void
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataMultiLine(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId)
+{
+  typedef typename TOutputImage::PixelType            OutputPixelType;
+  typedef DefaultConvertPixelTraits< InputPixelType >  InputPixelTraits;
+  typedef DefaultConvertPixelTraits< OutputPixelType > OutputPixelTraits;
+  typedef typename OutputPixelTraits::ComponentType    OutputComponentType;
+
+  typedef ImageRegionConstIterator< TInputImage > InputConstIteratorType;
+  typedef ImageRegionIterator< TOutputImage >     OutputIteratorType;
+
+  const unsigned int imageDimension = TInputImage::ImageDimension;
+
+  typename TInputImage::ConstPointer inputImage( this->GetInputImage () );
+  typename TOutputImage::Pointer     outputImage( this->GetOutput() );
+
+  const SizeValueType ln = outputRegionForThread.GetSize(this->m_Direction);
+  const SizeValueType width = outputRegionForThread.GetSize(0);
+  const SizeValueType numberOfBlocksPerRow = ( width + MultiLineBlockSize - 1 ) / MultiLineBlockSize;
+
+  // The blocks are indexed by their position along the first dimension
+  // and their index in the dimensions other than the first and the
+  // filtering direction
+  SizeValueType numberOfRows = 1;
+  for ( unsigned int d = 1; d < imageDimension; d++ )
+    {
+    if ( d != this->m_Direction )
+      {
+      numberOfRows *= outputRegionForThread.GetSize(d);
+      }
+    }
+
+  ProgressReporter progress(this, threadId, numberOfRows * numberOfBlocksPerRow, 10);
+
+  std::vector< ScalarRealType > inps;
+  std::vector< ScalarRealType > outs;
+  std::vector< ScalarRealType > scratch;
+  OutputPixelType               outputPixel;
+  unsigned int                  numberOfComponents = 0;
+
+  for ( SizeValueType row = 0; row < numberOfRows; row++ )
+    {
+    OutputImageRegionType block = outputRegionForThread;
+    SizeValueType         r = row;
+    for ( unsigned int d = 1; d < imageDimension; d++ )
+      {
+      if ( d != this->m_Direction )
+        {
+        block.SetIndex( d, outputRegionForThread.GetIndex(d) + static_cast< IndexValueType >( r % outputRegionForThread.GetSize(d) ) );
+        block.SetSize( d, 1 );
+        r /= outputRegionForThread.GetSize(d);
+        }
+      }
+
+    for ( SizeValueType x = 0; x < width; x += MultiLineBlockSize )
+      {
+      const SizeValueType numberOfLines = std::min( width - x, static_cast< SizeValueType >( MultiLineBlockSize ) );
+      block.SetIndex( 0, outputRegionForThread.GetIndex(0) + static_cast< IndexValueType >( x ) );
+      block.SetSize( 0, numberOfLines );
+
+      // The region iterator visits the first dimension fastest, so the
+      // pixels of the lines are interleaved
+      InputConstIteratorType inputIterator(inputImage, block);
+      if ( numberOfComponents == 0 )
+        {
+        numberOfComponents = NumericTraits< InputPixelType >::GetLength( inputIterator.Get() );
+        inps.resize( ln * MultiLineBlockSize * numberOfComponents );
+        outs.resize( inps.size() );
+        scratch.resize( inps.size() );
+        NumericTraits< OutputPixelType >::SetLength( outputPixel, numberOfComponents );
+        }
+
+      ScalarRealType * value = &inps[0];
+      for (; !inputIterator.IsAtEnd(); ++inputIterator )
+        {
+        const InputPixelType pixel = inputIterator.Get();
+        for ( unsigned int c = 0; c < numberOfComponents; c++ )
+          {
+          *value++ = static_cast< ScalarRealType >( InputPixelTraits::GetNthComponent(c, pixel) );
+          }
+        }
+
+      this->FilterDataArrayMultiLine(&outs[0], &inps[0], &scratch[0], ln, numberOfLines * numberOfComponents);
+
+      value = &outs[0];
+      for ( OutputIteratorType outputIterator(outputImage, block); !outputIterator.IsAtEnd(); ++outputIterator )
+        {
+        for ( unsigned int c = 0; c < numberOfComponents; c++ )
+          {
+          OutputPixelTraits::SetNthComponent( c, outputPixel, static_cast< OutputComponentType >( *value++ ) );
+          }
+        outputIterator.Set(outputPixel);
+        }
+
+      progress.CompletedPixel();
+      }
+    }
+}
+
 template< typename TInputImage, typename TOutputImage >
 void
 RecursiveSeparableImageFilter< TInputImage, TOutputImage >
@@ -0,0 +1,233 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <iostream>
+#include "itkFusedSeparableConvolutionImageFilter.h"
+#include "itkNeighborhoodOperatorImageFilter.h"
+#include "itkGaussianOperator.h"
+#include "itkDerivativeOperator.h"
+#include "itkRandomImageSource.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+// Compare the fused filter with a chain of NeighborhoodOperatorImageFilter
+template< unsigned int VDimension >
+int
+FusedSeparableConvolutionImageFilterTestCompare(const itk::Size< VDimension > & size,
+                                                itk::SizeValueType tileSize,
+                                                itk::ThreadIdType numberOfThreads)
+{
+  typedef itk::Image< double, VDimension >                                        ImageType;
+  typedef itk::FusedSeparableConvolutionImageFilter< ImageType, ImageType >       FusedFilterType;
+  typedef itk::NeighborhoodOperatorImageFilter< ImageType, ImageType, double >    ReferenceFilterType;
+
+  typedef itk::RandomImageSource< ImageType > SourceType;
+  typename SourceType::Pointer source = SourceType::New();
+  source->SetSize(size);
+  source->SetMin(0.0);
+  source->SetMax(100.0);
+  TRY_EXPECT_NO_EXCEPTION( source->Update() );
+  typename ImageType::Pointer input = source->GetOutput();
+
+  typename FusedFilterType::Pointer fused = FusedFilterType::New();
+  fused->SetInput(input);
+  fused->SetTileSize(tileSize);
+  fused->SetNumberOfThreads(numberOfThreads);
+
+  typename ImageType::Pointer expected = input;
+  for ( unsigned int d = 0; d < VDimension; ++d )
+    {
+    // Alternate symmetric and antisymmetric kernels of various sizes,
+    // leaving the last direction unfiltered
+    if ( d + 1 == VDimension && d > 0 )
+      {
+      break;
+      }
+    typename ReferenceFilterType::OutputNeighborhoodType::RadiusType radius;
+    radius.Fill(0);
+    if ( d % 2 == 0 )
+      {
+      itk::GaussianOperator< double, VDimension > oper;
+      oper.SetDirection(d);
+      oper.SetVariance(2.0 + d);
+      oper.CreateDirectional();
+      fused->SetOperator(oper);
+
+      typename ReferenceFilterType::Pointer reference = ReferenceFilterType::New();
+      reference->SetOperator(oper);
+      reference->SetInput(expected);
+      reference->Update();
+      expected = reference->GetOutput();
+      expected->DisconnectPipeline();
+      }
+    else
+      {
+      itk::DerivativeOperator< double, VDimension > oper;
+      oper.SetDirection(d);
+      oper.SetOrder(1);
+      oper.CreateDirectional();
+      fused->SetOperator(oper);
+
+      typename ReferenceFilterType::Pointer reference = ReferenceFilterType::New();
+      reference->SetOperator(oper);
+      reference->SetInput(expected);
+      reference->Update();
+      expected = reference->GetOutput();
+      expected->DisconnectPipeline();
+      }
+    }
+
+  TRY_EXPECT_NO_EXCEPTION( fused->Update() );
+
+  itk::ImageRegionConstIterator< ImageType > expectedIt( expected, expected->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< ImageType > fusedIt( fused->GetOutput(), expected->GetLargestPossibleRegion() );
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++fusedIt )
+    {
+    if ( itk::Math::abs( expectedIt.Get() - fusedIt.Get() ) > 1e-9 )
+      {
+      std::cerr << "Test failed for size " << size << ", tile size " << tileSize
+                << " and " << numberOfThreads << " threads at index " << expectedIt.GetIndex()
+                << ": expected " << expectedIt.Get() << ", got " << fusedIt.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int itkFusedSeparableConvolutionImageFilterTest(int , char *[] )
+{
+  typedef itk::Image< float, 2 >                                                      ImageType;
+  typedef itk::FusedSeparableConvolutionImageFilter< ImageType, ImageType, double >   FilterType;
+
+  FilterType::Pointer filter = FilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( filter, FusedSeparableConvolutionImageFilter, ImageToImageFilter );
+
+  TEST_SET_GET_VALUE( 32768, filter->GetTileSize() );
+  filter->SetTileSize( 100 );
+  TEST_SET_GET_VALUE( 100, filter->GetTileSize() );
+
+  FilterType::KernelType kernel(3, 1.0 / 3.0);
+  filter->SetKernel(1, kernel);
+  TEST_EXPECT_EQUAL( filter->GetKernel(1).size(), 3 );
+  TEST_EXPECT_TRUE( filter->GetKernel(0).empty() );
+
+  FilterType::KernelType evenKernel(4, 0.25);
+  TRY_EXPECT_EXCEPTION( filter->SetKernel(0, evenKernel) );
+  TRY_EXPECT_EXCEPTION( filter->SetKernel(2, kernel) );
+
+  itk::GaussianOperator< double, 2 > nonDirectional;
+  nonDirectional.SetVariance(1.0);
+  nonDirectional.CreateToRadius(1);
+  TRY_EXPECT_EXCEPTION( filter->SetOperator(nonDirectional) );
+
+  filter->ClearKernels();
+  TEST_EXPECT_TRUE( filter->GetKernel(1).empty() );
+
+  int status = EXIT_SUCCESS;
+
+  itk::Size< 1 > size1;
+  size1[0] = 50;
+  status |= FusedSeparableConvolutionImageFilterTestCompare< 1 >(size1, 7, 2);
+
+  itk::Size< 2 > size2;
+  size2[0] = 67;
+  size2[1] = 41;
+  status |= FusedSeparableConvolutionImageFilterTestCompare< 2 >(size2, 32768, 1);
+  status |= FusedSeparableConvolutionImageFilterTestCompare< 2 >(size2, 100, 3);
+
+  itk::Size< 3 > size3;
+  size3[0] = 33;
+  size3[1] = 29;
+  size3[2] = 17;
+  status |= FusedSeparableConvolutionImageFilterTestCompare< 3 >(size3, 32768, 4);
+  status |= FusedSeparableConvolutionImageFilterTestCompare< 3 >(size3, 500, 4);
+
+  // Kernels larger than the image
+  size3[0] = 5;
+  size3[1] = 3;
+  size3[2] = 2;
+  status |= FusedSeparableConvolutionImageFilterTestCompare< 3 >(size3, 7, 2);
+
+  // Multi-component pixels are filtered component by component
+  typedef itk::Image< itk::Vector< float, 2 >, 2 >                                         VectorImageType;
+  typedef itk::FusedSeparableConvolutionImageFilter< VectorImageType, VectorImageType >   VectorFilterType;
+  typedef itk::FusedSeparableConvolutionImageFilter< ImageType, ImageType >               ScalarFilterType;
+
+  typedef itk::RandomImageSource< ImageType > SourceType;
+  SourceType::Pointer source = SourceType::New();
+  source->SetSize(size2);
+  source->SetMin(0.0);
+  source->SetMax(100.0);
+  TRY_EXPECT_NO_EXCEPTION( source->Update() );
+  ImageType::Pointer scalarImage = source->GetOutput();
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions( scalarImage->GetLargestPossibleRegion() );
+  vectorImage->Allocate();
+  itk::ImageRegionConstIterator< ImageType > scalarIt( scalarImage, scalarImage->GetLargestPossibleRegion() );
+  itk::ImageRegionIterator< VectorImageType > vectorIt( vectorImage, vectorImage->GetLargestPossibleRegion() );
+  for (; !scalarIt.IsAtEnd(); ++scalarIt, ++vectorIt )
+    {
+    VectorImageType::PixelType v;
+    v[0] = scalarIt.Get();
+    v[1] = -2.0f * scalarIt.Get();
+    vectorIt.Set(v);
+    }
+
+  itk::GaussianOperator< double, 2 > gaussian;
+  gaussian.SetVariance(3.0);
+  gaussian.SetDirection(1);
+  gaussian.CreateDirectional();
+
+  ScalarFilterType::Pointer scalarFilter = ScalarFilterType::New();
+  scalarFilter->SetInput(scalarImage);
+  scalarFilter->SetOperator(gaussian);
+  scalarFilter->SetTileSize(64);
+  scalarFilter->Update();
+
+  VectorFilterType::Pointer vectorFilter = VectorFilterType::New();
+  vectorFilter->SetInput(vectorImage);
+  vectorFilter->SetOperator(gaussian);
+  vectorFilter->SetTileSize(64);
+  vectorFilter->Update();
+
+  itk::ImageRegionConstIterator< ImageType > scalarOutIt( scalarFilter->GetOutput(),
+                                                         scalarImage->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< VectorImageType > vectorOutIt( vectorFilter->GetOutput(),
+                                                               vectorImage->GetLargestPossibleRegion() );
+  for (; !scalarOutIt.IsAtEnd(); ++scalarOutIt, ++vectorOutIt )
+    {
+    if ( itk::Math::abs( scalarOutIt.Get() - vectorOutIt.Get()[0] ) > 1e-4
+         || itk::Math::abs( -2.0f * scalarOutIt.Get() - vectorOutIt.Get()[1] ) > 1e-4 )
+      {
+      std::cerr << "Test failed for vector pixels at index " << scalarOutIt.GetIndex() << ": "
+                << scalarOutIt.Get() << " vs " << vectorOutIt.Get() << std::endl;
+      status = EXIT_FAILURE;
+      break;
+      }
+    }
+
+  if ( status == EXIT_SUCCESS )
+    {
+    std::cout << "Test passed." << std::endl;
+    }
+  return status;
+}
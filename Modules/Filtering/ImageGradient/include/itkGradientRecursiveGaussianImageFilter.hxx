@@ -144,17 +144,20 @@ void
 GradientRecursiveGaussianImageFilter< TInputImage, TOutputImage >
 ::SetNormalizeAcrossScale(bool normalize)
 {
-  m_NormalizeAcrossScale = normalize;
-
-  itkStaticAssert(ImageDimension > 0, "Images shall have one dimension at least");
-  const unsigned int imageDimensionMinus1 = ImageDimension - 1;
-  for ( unsigned int i = 0; i != imageDimensionMinus1; i++ )
+  if ( this->m_NormalizeAcrossScale != normalize )
     {
-    m_SmoothingFilters[i]->SetNormalizeAcrossScale(normalize);
-    }
-  m_DerivativeFilter->SetNormalizeAcrossScale(normalize);
+    this->m_NormalizeAcrossScale = normalize;
 
-  this->Modified();
+    itkStaticAssert(ImageDimension > 0, "Images shall have one dimension at least");
+    const unsigned int imageDimensionMinus1 = ImageDimension - 1;
+    for ( unsigned int i = 0; i != imageDimensionMinus1; i++ )
+      {
+      m_SmoothingFilters[i]->SetNormalizeAcrossScale(normalize);
+      }
+    m_DerivativeFilter->SetNormalizeAcrossScale(normalize);
+
+    this->Modified();
+    }
 }
 
 //
@@ -104,6 +104,17 @@ namespace itk
  * pointSet->SetPointData( 1, p1 );
  * \endcode
  *
+ * When the scattered data are samples of an image (e.g. a bias field estimate
+ * or a displacement field), the data can instead be given directly as an image
+ * through SetScatteredDataImage() with optional per-voxel weights specified by
+ * SetConfidenceImage().  In that case no point set is needed.  Each voxel is
+ * located in the parametric domain from its index, the image origin and the
+ * image spacing (the image direction is ignored, as is customary for
+ * parametric points).  The B-spline weights are separable over the image grid
+ * so they are tabulated once per grid line in each dimension and the fitting
+ * only requires O(1) additional memory per voxel.  Voxels with a confidence
+ * value of zero do not contribute to the fit.
+ *
  * \author Nicholas J. Tustison
  *
  * This code was contributed in the Insight Journal paper:
@@ -272,6 +283,18 @@ public:
   itkGetConstReferenceMacro( GenerateOutputImage, bool );
   itkBooleanMacro( GenerateOutputImage );
 
+  /** Set/Get the image holding the scattered data on a regular grid.  This is
+   * an alternative to specifying the input point set with one point per voxel
+   * and avoids the memory overhead of the point containers. */
+  itkSetInputMacro( ScatteredDataImage, PointDataImageType );
+  itkGetInputMacro( ScatteredDataImage, PointDataImageType );
+
+  /** Set/Get the optional confidence (weight) image associated with the
+   * scattered data image.  It must have the same buffered region as the
+   * scattered data image. */
+  itkSetInputMacro( ConfidenceImage, RealImageType );
+  itkGetInputMacro( ConfidenceImage, RealImageType );
+
   /** Get the control point lattice produced by the fitting process. */
   PointDataImagePointer GetPhiLattice()
     {
@@ -294,6 +317,10 @@ protected:
 
   void GenerateData() ITK_OVERRIDE;
 
+  /** The input point set is not required when the scattered data image is
+   * specified. */
+  void VerifyPreconditions() ITK_OVERRIDE;
+
 private:
 
   ITK_DISALLOW_COPY_AND_ASSIGN(BSplineScatteredDataPointSetToImageFilter);
@@ -312,9 +339,24 @@ private:
   /** Function used to generate the sampled B-spline object quickly. */
   void ThreadedGenerateDataForFitting( const RegionType &, ThreadIdType );
 
+  /** Function used to accumulate the scattered data image directly on its
+   * grid using separable B-spline weights. */
+  void ThreadedGenerateDataForImageFitting( ThreadIdType );
+
   /** Function used to generate the sampled B-spline object quickly. */
   void ThreadedGenerateDataForReconstruction( const RegionType &, ThreadIdType );
 
+  /** Sum a portion of the per-thread omega and delta lattices and compute the
+   * corresponding part of the control point lattice. */
+  void ThreadedReduceLattices( ThreadIdType, ThreadIdType );
+
+  /** Static function used as a "callback" by the MultiThreader to reduce the
+   * per-thread lattices in parallel. */
+  static ITK_THREAD_RETURN_TYPE ReduceLatticesThreaderCallback( void *arg );
+
+  /** Evaluate the univariate B-spline kernel of the given dimension. */
+  RealType EvaluateKernel( const unsigned int, const RealType ) const;
+
   /** Sub-function used by GenerateOutputImageFast() to generate the sampled
    * B-spline object quickly. */
   void CollapsePhiLattice( PointDataImageType *, PointDataImageType *,
@@ -331,6 +373,7 @@ private:
   bool                                         m_DoMultilevel;
   bool                                         m_GenerateOutputImage;
   bool                                         m_UsePointWeights;
+  bool                                         m_UseScatteredDataImage;
   unsigned int                                 m_MaximumNumberOfLevels;
   unsigned int                                 m_CurrentLevel;
   ArrayType                                    m_NumberOfControlPoints;
@@ -21,6 +21,8 @@
 #include "itkBSplineScatteredDataPointSetToImageFilter.h"
 #include "itkImageRegionIterator.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionSplitterSlowDimension.h"
+#include "itkImageScanlineConstIterator.h"
 #include "itkImageDuplicator.h"
 #include "itkCastImageFilter.h"
 #include "itkNumericTraits.h"
@@ -39,6 +41,7 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
   m_DoMultilevel( false ),
   m_GenerateOutputImage( true ),
   m_UsePointWeights( false ),
+  m_UseScatteredDataImage( false ),
   m_MaximumNumberOfLevels( 1 ),
   m_CurrentLevel( 0 ),
   m_BSplineEpsilon( 1e-3 ),
@@ -203,6 +206,17 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
   this->Modified();
 }
 
+template<typename TInputPointSet, typename TOutputImage>
+void
+BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
+::VerifyPreconditions()
+{
+  if( this->GetScatteredDataImage() == ITK_NULLPTR )
+    {
+    Superclass::VerifyPreconditions();
+    }
+}
+
 template<typename TInputPointSet, typename TOutputImage>
 void
 BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
@@ -235,7 +249,26 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
 
   // Perform some error checking on the input
 
-  if( this->m_UsePointWeights &&
+  const PointDataImageType *scatteredDataImage = this->GetScatteredDataImage();
+  const RealImageType *confidenceImage = this->GetConfidenceImage();
+
+  this->m_UseScatteredDataImage = ( scatteredDataImage != ITK_NULLPTR );
+
+  if( this->m_UseScatteredDataImage )
+    {
+    if( inputPointSet != ITK_NULLPTR )
+      {
+      itkExceptionMacro(
+        "Only one of the input point set and the scattered data image can be specified." );
+      }
+    if( confidenceImage != ITK_NULLPTR &&
+      confidenceImage->GetBufferedRegion() != scatteredDataImage->GetBufferedRegion() )
+      {
+      itkExceptionMacro(
+        "The confidence image and the scattered data image must have the same buffered region." );
+      }
+    }
+  else if( this->m_UsePointWeights &&
     ( this->m_PointWeights->Size() != inputPointSet->GetNumberOfPoints() ) )
     {
     itkExceptionMacro(
@@ -265,7 +298,7 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
 
   this->m_InputPointData->Initialize();
   this->m_OutputPointData->Initialize();
-  if( inputPointSet->GetNumberOfPoints() > 0 )
+  if( !this->m_UseScatteredDataImage && inputPointSet->GetNumberOfPoints() > 0 )
     {
     typename PointDataContainerType::ConstIterator It =
       inputPointSet->GetPointData()->Begin();
@@ -300,7 +333,10 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
   this->GetMultiThreader()->SingleMethodExecute();
   this->AfterThreadedGenerateData();
 
-  this->UpdatePointSet();
+  if( !this->m_UseScatteredDataImage )
+    {
+    this->UpdatePointSet();
+    }
 
   if( this->m_DoMultilevel )
     {
@@ -382,7 +418,10 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
     this->GetMultiThreader()->SingleMethodExecute();
     this->AfterThreadedGenerateData();
 
-    this->UpdatePointSet();
+    if( !this->m_UseScatteredDataImage )
+      {
+      this->UpdatePointSet();
+      }
     }
 
   if( this->m_DoMultilevel )
@@ -403,7 +442,10 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
     duplicator->Update();
     this->m_PhiLattice = duplicator->GetModifiableOutput();
 
-    this->UpdatePointSet();
+    if( !this->m_UseScatteredDataImage )
+      {
+      this->UpdatePointSet();
+      }
     }
 
   this->m_IsFittingComplete = true;
@@ -531,7 +573,14 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
 {
   if( !this->m_IsFittingComplete )
     {
-    this->ThreadedGenerateDataForFitting( region, threadId );
+    if( this->m_UseScatteredDataImage )
+      {
+      this->ThreadedGenerateDataForImageFitting( threadId );
+      }
+    else
+      {
+      this->ThreadedGenerateDataForFitting( region, threadId );
+      }
     }
   else
     {
@@ -666,6 +715,9 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
     RealImageType * currentThreadOmegaLattice = this->m_OmegaLatticePerThread[threadId];
     PointDataImageType * currentThreadDeltaLattice = this->m_DeltaLatticePerThread[threadId];
 
+    const typename RealImageType::SizeType latticeSize =
+      currentThreadOmegaLattice->GetLargestPossibleRegion().GetSize();
+
     for( ItW.GoToBegin(); !ItW.IsAtEnd(); ++ItW )
       {
       typename RealImageType::IndexType idx = ItW.GetIndex();
@@ -674,7 +726,7 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
         idx[i] += static_cast<unsigned>( p[i] );
         if( this->m_CloseDimension[i] )
           {
-          idx[i] %= size[i];
+          idx[i] %= latticeSize[i];
           }
         }
       RealType wc = this->m_PointWeights->GetElement(n);
@@ -689,6 +741,228 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
     }
 }
 
+template<typename TInputPointSet, typename TOutputImage>
+void
+BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
+::ThreadedGenerateDataForImageFitting( ThreadIdType threadId )
+{
+  const PointDataImageType *input = this->GetScatteredDataImage();
+  const RealImageType *confidenceImage = this->GetConfidenceImage();
+
+  // Divide the scattered data image among the threads along its slowest
+  // varying dimension.
+
+  typename PointDataImageType::RegionType region = input->GetBufferedRegion();
+
+  ImageRegionSplitterSlowDimension::Pointer splitter =
+    ImageRegionSplitterSlowDimension::New();
+  const unsigned int numberOfPieces =
+    splitter->GetNumberOfSplits( region, this->GetNumberOfThreads() );
+  if( threadId >= numberOfPieces )
+    {
+    return;
+    }
+  splitter->GetSplit( threadId, numberOfPieces, region );
+
+  RealImageType * currentThreadOmegaLattice = this->m_OmegaLatticePerThread[threadId];
+  PointDataImageType * currentThreadDeltaLattice = this->m_DeltaLatticePerThread[threadId];
+
+  const typename RealImageType::SizeType latticeSize =
+    currentThreadOmegaLattice->GetLargestPossibleRegion().GetSize();
+
+  // The B-spline weights are separable so, for each dimension, we tabulate the
+  // weights, the lattice offsets and the sum of the squared weights of every
+  // grid line of the region.  The weight of a voxel for a given control point
+  // is then the product of the tabulated weights along each dimension.
+
+  const typename PointDataImageType::PointType & inputOrigin = input->GetOrigin();
+  const typename PointDataImageType::SpacingType & inputSpacing = input->GetSpacing();
+
+  std::vector<RealType> weights[ImageDimension];
+  std::vector<RealType> squaredWeightSums[ImageDimension];
+  std::vector<OffsetValueType> latticeOffsets[ImageDimension];
+
+  OffsetValueType latticeStride = 1;
+  for( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    const unsigned int totalNumberOfSpans =
+      this->m_CurrentNumberOfControlPoints[i] - this->m_SplineOrder[i];
+    const RealType r = static_cast<RealType>( totalNumberOfSpans ) /
+      ( static_cast<RealType>( this->m_Size[i] - 1 ) * this->m_Spacing[i] );
+    const RealType epsilon = r * this->m_Spacing[i] * this->m_BSplineEpsilon;
+
+    const unsigned int numberOfWeights = this->m_SplineOrder[i] + 1;
+    const SizeValueType numberOfGridLines = region.GetSize()[i];
+
+    weights[i].resize( numberOfGridLines * numberOfWeights );
+    latticeOffsets[i].resize( numberOfGridLines * numberOfWeights );
+    squaredWeightSums[i].resize( numberOfGridLines );
+
+    for( SizeValueType j = 0; j < numberOfGridLines; j++ )
+      {
+      const IndexValueType index = region.GetIndex()[i] +
+        static_cast<IndexValueType>( j );
+
+      RealType p = ( inputOrigin[i] + inputSpacing[i] * index -
+        this->m_Origin[i] ) * r;
+      if( std::abs( p - static_cast<RealType>( totalNumberOfSpans ) ) <= epsilon )
+        {
+        p = static_cast<RealType>( totalNumberOfSpans ) - epsilon;
+        }
+      if( p < NumericTraits<RealType>::ZeroValue() && std::abs( p ) <= epsilon )
+        {
+        p = NumericTraits<RealType>::ZeroValue();
+        }
+
+      if( p < NumericTraits<RealType>::ZeroValue() ||
+          p >= static_cast<RealType>( totalNumberOfSpans ) )
+        {
+        itkExceptionMacro( "The reparameterized point component " << p
+          << " is outside the corresponding parametric domain of [0, "
+          << totalNumberOfSpans << ")." );
+        }
+
+      RealType w2Sum = 0.0;
+      for( unsigned int k = 0; k < numberOfWeights; k++ )
+        {
+        RealType u = static_cast<RealType>( p - static_cast<unsigned>( p ) -
+          static_cast<IndexValueType>( k ) ) + 0.5 *
+          static_cast<RealType>( this->m_SplineOrder[i] - 1 );
+        RealType B = this->EvaluateKernel( i, u );
+        weights[i][j * numberOfWeights + k] = B;
+        w2Sum += B * B;
+
+        OffsetValueType latticeIndex = static_cast<unsigned>( p ) + k;
+        if( this->m_CloseDimension[i] )
+          {
+          latticeIndex %= latticeSize[i];
+          }
+        latticeOffsets[i][j * numberOfWeights + k] = latticeIndex * latticeStride;
+        }
+      squaredWeightSums[i][j] = w2Sum;
+      }
+    latticeStride *= latticeSize[i];
+    }
+
+  RealType * omega = currentThreadOmegaLattice->GetBufferPointer();
+  PointDataType * delta = currentThreadDeltaLattice->GetBufferPointer();
+
+  // After the first level, the data are fitted to the residuals of the
+  // previous levels whose control points are accumulated in the (refined)
+  // psi lattice.  The residuals are computed on the fly rather than stored.
+
+  const PointDataType * psi = ITK_NULLPTR;
+  if( this->m_CurrentLevel > 0 )
+    {
+    psi = this->m_PsiLattice->GetBufferPointer();
+    }
+
+  const unsigned int numberOfWeights0 = this->m_SplineOrder[0] + 1;
+
+  std::vector<RealType> lineWeights;
+  std::vector<OffsetValueType> lineOffsets;
+  std::vector<RealType> expandedLineWeights;
+  std::vector<OffsetValueType> expandedLineOffsets;
+
+  ImageScanlineConstIterator<PointDataImageType> It( input, region );
+  ImageScanlineConstIterator<RealImageType> ItC;
+  if( confidenceImage )
+    {
+    ItC = ImageScanlineConstIterator<RealImageType>( confidenceImage, region );
+    }
+
+  while( !It.IsAtEnd() )
+    {
+    // The weights along the dimensions other than the first one are constant
+    // on a scan line so their products are only updated once per line.
+
+    const typename PointDataImageType::IndexType lineIndex = It.GetIndex();
+
+    lineWeights.assign( 1, NumericTraits<RealType>::OneValue() );
+    lineOffsets.assign( 1, 0 );
+    RealType lineSquaredWeightSum = NumericTraits<RealType>::OneValue();
+
+    for( unsigned int i = 1; i < ImageDimension; i++ )
+      {
+      const SizeValueType j = lineIndex[i] - region.GetIndex()[i];
+      const unsigned int numberOfWeights = this->m_SplineOrder[i] + 1;
+
+      expandedLineWeights.resize( lineWeights.size() * numberOfWeights );
+      expandedLineOffsets.resize( lineOffsets.size() * numberOfWeights );
+      for( unsigned int k = 0; k < numberOfWeights; k++ )
+        {
+        for( std::size_t m = 0; m < lineWeights.size(); m++ )
+          {
+          expandedLineWeights[k * lineWeights.size() + m] =
+            lineWeights[m] * weights[i][j * numberOfWeights + k];
+          expandedLineOffsets[k * lineOffsets.size() + m] =
+            lineOffsets[m] + latticeOffsets[i][j * numberOfWeights + k];
+          }
+        }
+      lineWeights.swap( expandedLineWeights );
+      lineOffsets.swap( expandedLineOffsets );
+      lineSquaredWeightSum *= squaredWeightSums[i][j];
+      }
+
+    SizeValueType j = lineIndex[0] - region.GetIndex()[0];
+    while( !It.IsAtEndOfLine() )
+      {
+      RealType wc = NumericTraits<RealType>::OneValue();
+      if( confidenceImage )
+        {
+        wc = ItC.Get();
+        }
+
+      if( Math::NotExactlyEquals( wc, NumericTraits<RealType>::ZeroValue() ) )
+        {
+        const RealType * w0 = &weights[0][j * numberOfWeights0];
+        const OffsetValueType * o0 = &latticeOffsets[0][j * numberOfWeights0];
+        const RealType w2Sum = squaredWeightSums[0][j] * lineSquaredWeightSum;
+
+        PointDataType data = It.Get();
+        if( psi )
+          {
+          for( std::size_t m = 0; m < lineWeights.size(); m++ )
+            {
+            for( unsigned int k = 0; k < numberOfWeights0; k++ )
+              {
+              PointDataType val = psi[o0[k] + lineOffsets[m]];
+              val *= ( w0[k] * lineWeights[m] );
+              data -= val;
+              }
+            }
+          }
+
+        for( std::size_t m = 0; m < lineWeights.size(); m++ )
+          {
+          for( unsigned int k = 0; k < numberOfWeights0; k++ )
+            {
+            const RealType t = w0[k] * lineWeights[m];
+            const OffsetValueType offset = o0[k] + lineOffsets[m];
+
+            omega[offset] += wc * t * t;
+            PointDataType val = data;
+            val *= ( t * t * t * wc / w2Sum );
+            delta[offset] += val;
+            }
+          }
+        }
+
+      ++It;
+      ++j;
+      if( confidenceImage )
+        {
+        ++ItC;
+        }
+      }
+    It.NextLine();
+    if( confidenceImage )
+      {
+      ItC.NextLine();
+      }
+    }
+}
+
 template<typename TInputPointSet, typename TOutputImage>
 void
 BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
@@ -806,41 +1080,6 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
 {
   if( !this->m_IsFittingComplete )
     {
-    // Accumulate all the delta lattice and omega lattice values to
-    // calculate the final phi lattice.
-
-    ImageRegionIterator< PointDataImageType > ItD(
-      this->m_DeltaLatticePerThread[0],
-      this->m_DeltaLatticePerThread[0]->GetLargestPossibleRegion() );
-    ImageRegionIterator< RealImageType > ItO(
-      this->m_OmegaLatticePerThread[0],
-      this->m_OmegaLatticePerThread[0]->GetLargestPossibleRegion() );
-
-    for( ThreadIdType n = 1; n < this->GetNumberOfThreads(); n++ )
-      {
-      ImageRegionIterator< PointDataImageType > Itd(
-        this->m_DeltaLatticePerThread[n],
-        this->m_DeltaLatticePerThread[n]->GetLargestPossibleRegion() );
-      ImageRegionIterator< RealImageType > Ito(
-        this->m_OmegaLatticePerThread[n],
-        this->m_OmegaLatticePerThread[n]->GetLargestPossibleRegion() );
-
-      ItD.GoToBegin();
-      ItO.GoToBegin();
-      Itd.GoToBegin();
-      Ito.GoToBegin();
-      while( !ItD.IsAtEnd() )
-        {
-        ItD.Set( ItD.Get() + Itd.Get() );
-        ItO.Set( ItO.Get() + Ito.Get() );
-
-        ++ItD;
-        ++ItO;
-        ++Itd;
-        ++Ito;
-        }
-      }
-
     // Generate the control point lattice
 
     typename RealImageType::SizeType size;
@@ -860,26 +1099,85 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
     this->m_PhiLattice->Allocate();
     this->m_PhiLattice->FillBuffer( NumericTraits<PointDataType>::ZeroValue() );
 
-    ImageRegionIterator<PointDataImageType> ItP(
-      this->m_PhiLattice, this->m_PhiLattice->GetLargestPossibleRegion() );
+    // Accumulate all the delta lattice and omega lattice values to
+    // calculate the final phi lattice.  The lattices are partitioned
+    // among the threads so that the reduction is done in parallel.
+
+    typename ImageSource<ImageType>::ThreadStruct str;
+    str.Filter = this;
 
-    for( ItP.GoToBegin(), ItO.GoToBegin(), ItD.GoToBegin(); !ItP.IsAtEnd();
-      ++ItP, ++ItO, ++ItD )
+    this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+    this->GetMultiThreader()->SetSingleMethod(
+      this->ReduceLatticesThreaderCallback, &str );
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
+}
+
+template<typename TInputPointSet, typename TOutputImage>
+ITK_THREAD_RETURN_TYPE
+BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
+::ReduceLatticesThreaderCallback( void *arg )
+{
+  MultiThreader::ThreadInfoStruct *threadInfo =
+    static_cast<MultiThreader::ThreadInfoStruct *>( arg );
+
+  typename ImageSource<ImageType>::ThreadStruct *str =
+    static_cast<typename ImageSource<ImageType>::ThreadStruct *>( threadInfo->UserData );
+
+  Self *filter = static_cast<Self *>( str->Filter.GetPointer() );
+  filter->ThreadedReduceLattices( threadInfo->ThreadID, threadInfo->NumberOfThreads );
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template<typename TInputPointSet, typename TOutputImage>
+void
+BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
+::ThreadedReduceLattices( ThreadIdType threadId, ThreadIdType numberOfThreads )
+{
+  const SizeValueType numberOfLatticePoints =
+    this->m_PhiLattice->GetLargestPossibleRegion().GetNumberOfPixels();
+  const SizeValueType numberOfLatticePointsPerThread =
+    numberOfLatticePoints / numberOfThreads;
+
+  const SizeValueType start = threadId * numberOfLatticePointsPerThread;
+  SizeValueType end = start + numberOfLatticePointsPerThread;
+  if( threadId == numberOfThreads - 1 )
+    {
+    end = numberOfLatticePoints;
+    }
+
+  PointDataType * delta = this->m_DeltaLatticePerThread[0]->GetBufferPointer();
+  RealType * omega = this->m_OmegaLatticePerThread[0]->GetBufferPointer();
+
+  for( std::size_t n = 1; n < this->m_DeltaLatticePerThread.size(); n++ )
+    {
+    const PointDataType * threadDelta =
+      this->m_DeltaLatticePerThread[n]->GetBufferPointer();
+    const RealType * threadOmega =
+      this->m_OmegaLatticePerThread[n]->GetBufferPointer();
+
+    for( SizeValueType k = start; k < end; k++ )
+      {
+      delta[k] += threadDelta[k];
+      omega[k] += threadOmega[k];
+      }
+    }
+
+  PointDataType * phi = this->m_PhiLattice->GetBufferPointer();
+  for( SizeValueType k = start; k < end; k++ )
+    {
+    if( Math::NotAlmostEquals( omega[k], NumericTraits< typename PointDataType::ValueType >::ZeroValue() ) )
       {
-      PointDataType P;
-      P.Fill( 0 );
-      if( Math::NotAlmostEquals( ItO.Get(), NumericTraits< typename PointDataType::ValueType >::ZeroValue() ) )
+      PointDataType P = delta[k] / omega[k];
+      for( unsigned int i = 0; i < P.Size(); i++ )
         {
-        P = ItD.Get() / ItO.Get();
-        for( unsigned int i = 0; i < P.Size(); i++ )
+        if( itk::Math::isnan( P[i] ) || itk::Math::isinf( P[i] ) )
           {
-          if( itk::Math::isnan( P[i] ) || itk::Math::isinf( P[i] ) )
-            {
-            P[i] = 0;
-            }
+          P[i] = 0;
           }
-        ItP.Set( P );
         }
+      phi[k] = P;
       }
     }
 }
@@ -1213,6 +1511,37 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
     }
 }
 
+template<typename TInputPointSet, typename TOutputImage>
+typename BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
+::RealType
+BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
+::EvaluateKernel( const unsigned int dimension, const RealType u ) const
+{
+  switch( this->m_SplineOrder[dimension] )
+    {
+    case 0:
+      {
+      return static_cast<RealType>( this->m_KernelOrder0->Evaluate( u ) );
+      }
+    case 1:
+      {
+      return static_cast<RealType>( this->m_KernelOrder1->Evaluate( u ) );
+      }
+    case 2:
+      {
+      return static_cast<RealType>( this->m_KernelOrder2->Evaluate( u ) );
+      }
+    case 3:
+      {
+      return static_cast<RealType>( this->m_KernelOrder3->Evaluate( u ) );
+      }
+    default:
+      {
+      return static_cast<RealType>( this->m_Kernel[dimension]->Evaluate( u ) );
+      }
+    }
+}
+
 template<typename TInputPointSet, typename TOutputImage>
 void
 BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
@@ -1287,6 +1616,7 @@ BSplineScatteredDataPointSetToImageFilter<TInputPointSet, TOutputImage>
   os << indent << "Do multi level: " << this->m_DoMultilevel << std::endl;
   os << indent << "Generate output image: " << this->m_GenerateOutputImage << std::endl;
   os << indent << "Use point weights: " << this->m_UsePointWeights << std::endl;
+  os << indent << "Use scattered data image: " << this->m_UseScatteredDataImage << std::endl;
   os << indent << "Maximum number of levels: " << this->m_MaximumNumberOfLevels << std::endl;
   os << indent << "Current level: " << this->m_CurrentLevel << std::endl;
   os << indent << "Number of control points: "
@@ -0,0 +1,220 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkPointSet.h"
+#include "itkBSplineScatteredDataPointSetToImageFilter.h"
+#include "itkTestingMacros.h"
+
+
+/**
+ * In this test, we fit the same scalar field sampled on an image grid
+ * once through a point set holding one point per voxel and once through
+ * the scattered data image input.  Both fits must produce the same
+ * control point lattice and output image.
+ */
+int itkBSplineScatteredDataPointSetToImageFilterTest6( int, char * [] )
+{
+  const unsigned int ParametricDimension = 2;
+  const unsigned int DataDimension = 1;
+
+  typedef float                                          RealType;
+  typedef itk::Vector<RealType, DataDimension>           VectorType;
+  typedef itk::Image<VectorType, ParametricDimension>    ImageType;
+  typedef itk::Image<RealType, ParametricDimension>      RealImageType;
+  typedef itk::PointSet<VectorType, ParametricDimension> PointSetType;
+
+  typedef itk::BSplineScatteredDataPointSetToImageFilter
+    <PointSetType, ImageType> FilterType;
+
+  // Create the scattered data and confidence images.  The data image does not
+  // start at the zero index to exercise the mapping to the parametric domain.
+
+  ImageType::IndexType start;
+  start[0] = 3;
+  start[1] = -2;
+
+  ImageType::SizeType size;
+  size[0] = 61;
+  size[1] = 47;
+
+  ImageType::RegionType region( start, size );
+
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.8;
+  spacing[1] = 1.3;
+
+  ImageType::PointType origin;
+  origin[0] = -10.0;
+  origin[1] = 5.0;
+
+  ImageType::Pointer dataImage = ImageType::New();
+  dataImage->SetRegions( region );
+  dataImage->SetSpacing( spacing );
+  dataImage->SetOrigin( origin );
+  dataImage->Allocate();
+
+  RealImageType::Pointer confidenceImage = RealImageType::New();
+  confidenceImage->CopyInformation( dataImage );
+  confidenceImage->SetRegions( region );
+  confidenceImage->Allocate();
+
+  PointSetType::Pointer pointSet = PointSetType::New();
+  FilterType::WeightsContainerType::Pointer weights =
+    FilterType::WeightsContainerType::New();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> It( dataImage, region );
+  itk::ImageRegionIteratorWithIndex<RealImageType> ItC( confidenceImage, region );
+
+  unsigned int index = 0;
+  for( It.GoToBegin(), ItC.GoToBegin(); !It.IsAtEnd(); ++It, ++ItC )
+    {
+    const ImageType::IndexType idx = It.GetIndex();
+
+    VectorType V;
+    V[0] = std::sin( 0.15 * idx[0] ) * std::cos( 0.1 * idx[1] ) + 0.01 * idx[0];
+    It.Set( V );
+
+    // Leave out a block of voxels and weight the others unevenly.
+    RealType confidence = 0.5 + 0.5 * ( ( idx[0] + idx[1] ) % 3 );
+    if( idx[0] > 20 && idx[0] < 30 && idx[1] > 10 && idx[1] < 20 )
+      {
+      confidence = 0.0;
+      }
+    ItC.Set( confidence );
+
+    if( confidence > 0.0 )
+      {
+      PointSetType::PointType point;
+      dataImage->TransformIndexToPhysicalPoint( idx, point );
+      pointSet->SetPoint( index, point );
+      pointSet->SetPointData( index, V );
+      weights->InsertElement( index, confidence );
+      index++;
+      }
+    }
+
+  ImageType::PointType parametricOrigin = origin;
+  for( unsigned int d = 0; d < ParametricDimension; d++ )
+    {
+    parametricOrigin[d] += spacing[d] * start[d];
+    }
+
+  FilterType::ArrayType numberOfControlPoints;
+  numberOfControlPoints[0] = 5;
+  numberOfControlPoints[1] = 6;
+
+  for( unsigned int closeDimension = 0; closeDimension < 2; closeDimension++ )
+    {
+    FilterType::ArrayType close;
+    close.Fill( 0 );
+    close[1] = closeDimension;
+
+    FilterType::Pointer pointSetFilter = FilterType::New();
+    pointSetFilter->SetOrigin( parametricOrigin );
+    pointSetFilter->SetSpacing( spacing );
+    pointSetFilter->SetSize( size );
+    pointSetFilter->SetSplineOrder( 3 );
+    pointSetFilter->SetNumberOfControlPoints( numberOfControlPoints );
+    pointSetFilter->SetNumberOfLevels( 3 );
+    pointSetFilter->SetCloseDimension( close );
+    pointSetFilter->SetNumberOfThreads( 3 );
+    pointSetFilter->SetInput( pointSet );
+    pointSetFilter->SetPointWeights( weights );
+
+    TRY_EXPECT_NO_EXCEPTION( pointSetFilter->Update() );
+
+    FilterType::Pointer imageFilter = FilterType::New();
+
+    EXERCISE_BASIC_OBJECT_METHODS( imageFilter, BSplineScatteredDataPointSetToImageFilter,
+      PointSetToImageFilter );
+
+    imageFilter->SetOrigin( parametricOrigin );
+    imageFilter->SetSpacing( spacing );
+    imageFilter->SetSize( size );
+    imageFilter->SetSplineOrder( 3 );
+    imageFilter->SetNumberOfControlPoints( numberOfControlPoints );
+    imageFilter->SetNumberOfLevels( 3 );
+    imageFilter->SetCloseDimension( close );
+    imageFilter->SetNumberOfThreads( 3 );
+    imageFilter->SetScatteredDataImage( dataImage );
+    imageFilter->SetConfidenceImage( confidenceImage );
+
+    TEST_SET_GET_VALUE( dataImage.GetPointer(), imageFilter->GetScatteredDataImage() );
+    TEST_SET_GET_VALUE( confidenceImage.GetPointer(), imageFilter->GetConfidenceImage() );
+
+    TRY_EXPECT_NO_EXCEPTION( imageFilter->Update() );
+
+    const RealType tolerance = 1e-4;
+
+    FilterType::PointDataImagePointer pointSetLattice = pointSetFilter->GetPhiLattice();
+    FilterType::PointDataImagePointer imageLattice = imageFilter->GetPhiLattice();
+
+    if( pointSetLattice->GetLargestPossibleRegion() !=
+      imageLattice->GetLargestPossibleRegion() )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "The control point lattices have different regions." << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    itk::ImageRegionConstIterator<ImageType> ItP( pointSetLattice,
+      pointSetLattice->GetLargestPossibleRegion() );
+    itk::ImageRegionConstIterator<ImageType> ItI( imageLattice,
+      imageLattice->GetLargestPossibleRegion() );
+    for( ItP.GoToBegin(), ItI.GoToBegin(); !ItP.IsAtEnd(); ++ItP, ++ItI )
+      {
+      if( ( ItP.Get() - ItI.Get() ).GetNorm() > tolerance )
+        {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << "Control point mismatch: " << ItP.Get() << " != "
+          << ItI.Get() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+
+    itk::ImageRegionConstIterator<ImageType> ItOP( pointSetFilter->GetOutput(),
+      pointSetFilter->GetOutput()->GetLargestPossibleRegion() );
+    itk::ImageRegionConstIterator<ImageType> ItOI( imageFilter->GetOutput(),
+      imageFilter->GetOutput()->GetLargestPossibleRegion() );
+    for( ItOP.GoToBegin(), ItOI.GoToBegin(); !ItOP.IsAtEnd(); ++ItOP, ++ItOI )
+      {
+      if( ( ItOP.Get() - ItOI.Get() ).GetNorm() > tolerance )
+        {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << "Output mismatch: " << ItOP.Get() << " != "
+          << ItOI.Get() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // Specifying both inputs is an error.
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetOrigin( parametricOrigin );
+  filter->SetSpacing( spacing );
+  filter->SetSize( size );
+  filter->SetInput( pointSet );
+  filter->SetScatteredDataImage( dataImage );
+
+  TRY_EXPECT_EXCEPTION( filter->Update() );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
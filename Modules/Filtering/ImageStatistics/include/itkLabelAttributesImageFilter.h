@@ -0,0 +1,343 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLabelAttributesImageFilter_h
+#define itkLabelAttributesImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkNumericTraits.h"
+#include "itkHistogram.h"
+#include "itksys/hash_map.hxx"
+#include <map>
+#include <vector>
+
+namespace itk
+{
+/** \class LabelAttributesImageFilter
+ * \brief Compute the shape, intensity and overlap attributes of the labels of an image in a single pass
+ *
+ * LabelAttributesImageFilter computes in one multithreaded pass over its
+ * inputs the attributes which are otherwise computed by several filters,
+ * like LabelStatisticsImageFilter, LabelOverlapMeasuresImageFilter and the
+ * shape label map filters. The attributes computed are selected by the
+ * inputs and the options of the filter:
+ *   - the number of pixels of the labels are always computed;
+ *   - the physical size, the centroid, the principal moments and the
+ *     elongation when ComputeShape is on (the default);
+ *   - the bounding box when ComputeBoundingBox is on (the default);
+ *   - the minimum, maximum, sum, mean, variance and sigma of the intensities
+ *     when an intensity image is given;
+ *   - a histogram of the intensities and the median when UseHistograms is on.
+ *     The median is the center of the bin of the median, like in
+ *     LabelStatisticsImageFilter;
+ *   - the Dice and Jaccard coefficients of each label with the same label in
+ *     a target label image, when the target image is given.
+ *
+ * The label image is the primary input, and is passed through unmodified.
+ * The attributes of the labels found in the label image or in the target
+ * image are available with GetLabelAttributes() after the update.
+ *
+ * The pixels are processed by runs of the same label along the first
+ * dimension, so the shape attributes and the accumulators of a label are
+ * updated once per run. Each thread accumulates the attributes of its part of
+ * the image: the labels in [0, DenseLabelRange) are accumulated in arrays
+ * indexed by the label, and the others in hash maps. The accumulators of the
+ * threads are merged at the end.
+ *
+ * \sa LabelStatisticsImageFilter, LabelOverlapMeasuresImageFilter
+ *
+ * \ingroup MathematicalStatisticsImageFilters
+ * \ingroup ITKImageStatistics
+ */
+template< typename TLabelImage, typename TIntensityImage = TLabelImage >
+class ITK_TEMPLATE_EXPORT LabelAttributesImageFilter:
+  public ImageToImageFilter< TLabelImage, TLabelImage >
+{
+public:
+  /** Standard Self typedef */
+  typedef LabelAttributesImageFilter                     Self;
+  typedef ImageToImageFilter< TLabelImage, TLabelImage > Superclass;
+  typedef SmartPointer< Self >                           Pointer;
+  typedef SmartPointer< const Self >                     ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(LabelAttributesImageFilter, ImageToImageFilter);
+
+  /** Label image related typedefs. */
+  typedef TLabelImage                       LabelImageType;
+  typedef typename TLabelImage::Pointer     LabelImagePointer;
+  typedef typename TLabelImage::RegionType  RegionType;
+  typedef typename TLabelImage::SizeType    SizeType;
+  typedef typename TLabelImage::IndexType   IndexType;
+  typedef typename TLabelImage::PointType   PointType;
+  typedef typename TLabelImage::PixelType   LabelPixelType;
+
+  /** Intensity image related typedefs. */
+  typedef TIntensityImage                      IntensityImageType;
+  typedef typename TIntensityImage::PixelType  IntensityPixelType;
+
+  /** Image related typedefs. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TLabelImage::ImageDimension);
+
+  /** Type to use for the intensity computations. */
+  typedef typename NumericTraits< IntensityPixelType >::RealType RealType;
+
+  /** Type of the principal moments. */
+  typedef Vector< double, itkGetStaticConstMacro(ImageDimension) > VectorType;
+
+  /** Histogram-related typedefs */
+  typedef itk::Statistics::Histogram< RealType > HistogramType;
+  typedef typename HistogramType::Pointer        HistogramPointer;
+
+  /** \class LabelAttributes
+   * \brief Attributes computed for a label
+   * \ingroup ITKImageStatistics
+   */
+  class LabelAttributes
+  {
+public:
+    LabelAttributes():
+      m_NumberOfPixels( 0 ),
+      m_PhysicalSize( 0.0 ),
+      m_Elongation( 0.0 ),
+      m_Minimum( NumericTraits< RealType >::max() ),
+      m_Maximum( NumericTraits< RealType >::NonpositiveMin() ),
+      m_Sum( NumericTraits< RealType >::ZeroValue() ),
+      m_Mean( NumericTraits< RealType >::ZeroValue() ),
+      m_Variance( NumericTraits< RealType >::ZeroValue() ),
+      m_Sigma( NumericTraits< RealType >::ZeroValue() ),
+      m_Median( NumericTraits< RealType >::ZeroValue() ),
+      m_TargetNumberOfPixels( 0 ),
+      m_Intersection( 0 ),
+      m_DiceCoefficient( 0.0 ),
+      m_JaccardCoefficient( 0.0 )
+    {
+      m_Centroid.Fill(0.0);
+      m_PrincipalMoments.Fill(0.0);
+    }
+
+    // shape
+    SizeValueType    m_NumberOfPixels;
+    double           m_PhysicalSize;
+    PointType        m_Centroid;
+    VectorType       m_PrincipalMoments;
+    double           m_Elongation;
+    RegionType       m_BoundingBox;
+
+    // intensity
+    RealType         m_Minimum;
+    RealType         m_Maximum;
+    RealType         m_Sum;
+    RealType         m_Mean;
+    RealType         m_Variance;
+    RealType         m_Sigma;
+    RealType         m_Median;
+    HistogramPointer m_Histogram;
+
+    // overlap
+    SizeValueType    m_TargetNumberOfPixels;
+    SizeValueType    m_Intersection;
+    double           m_DiceCoefficient;
+    double           m_JaccardCoefficient;
+  };
+
+  /** Type of the container of the labels found */
+  typedef std::vector< LabelPixelType > LabelVectorType;
+
+  /** Set/Get the label image. This is the primary input of the filter. */
+  void SetLabelImage(const LabelImageType *input)
+  {
+    this->SetInput(input);
+  }
+  const LabelImageType * GetLabelImage() const
+  {
+    return this->GetInput();
+  }
+
+  /** Set/Get the intensity image. The intensity attributes are only computed
+   * when the intensity image is set. */
+  itkSetInputMacro(IntensityImage, IntensityImageType);
+  itkGetInputMacro(IntensityImage, IntensityImageType);
+
+  /** Set/Get the target label image. The overlap attributes are only
+   * computed when the target image is set. */
+  itkSetInputMacro(TargetImage, LabelImageType);
+  itkGetInputMacro(TargetImage, LabelImageType);
+
+  /** Set/Get whether the physical size, the centroid, the principal moments
+   * and the elongation are computed. Defaults to true. */
+  itkSetMacro(ComputeShape, bool);
+  itkGetConstMacro(ComputeShape, bool);
+  itkBooleanMacro(ComputeShape);
+
+  /** Set/Get whether the bounding boxes are computed. Defaults to true. */
+  itkSetMacro(ComputeBoundingBox, bool);
+  itkGetConstMacro(ComputeBoundingBox, bool);
+  itkBooleanMacro(ComputeBoundingBox);
+
+  /** Set/Get whether the histograms of the intensities and the medians are
+   * computed. This requires an intensity image. Defaults to false. Unless
+   * SetHistogramParameters() is called, the histograms have 20 bins between
+   * the minimum and the maximum of the intensity image, found by an
+   * additional pass over the image. */
+  itkSetMacro(UseHistograms, bool);
+  itkGetConstMacro(UseHistograms, bool);
+  itkBooleanMacro(UseHistograms);
+
+  /** Specify the histogram parameters, and enable the histograms. The values
+   * outside of the bounds are counted in the first and last bins. */
+  void SetHistogramParameters(unsigned int numberOfBins, RealType lowerBound, RealType upperBound);
+
+  /** Get the histogram parameters. When they were not specified, the bounds
+   * are the ones computed from the intensity image at the last update. */
+  itkGetConstMacro(NumberOfBins, unsigned int);
+  itkGetConstMacro(HistogramLowerBound, RealType);
+  itkGetConstMacro(HistogramUpperBound, RealType);
+
+  /** Set/Get the number of labels, starting at 0, which are accumulated in
+   * arrays indexed by the label instead of hash maps. The arrays only grow
+   * up to the largest label found. Defaults to 16384. */
+  itkSetMacro(DenseLabelRange, SizeValueType);
+  itkGetConstMacro(DenseLabelRange, SizeValueType);
+
+  /** Get the labels found in the label image or in the target image, in
+   * increasing order. */
+  const LabelVectorType & GetLabels() const
+  {
+    return m_Labels;
+  }
+
+  /** Get the number of labels found. */
+  SizeValueType GetNumberOfLabels() const
+  {
+    return static_cast< SizeValueType >( m_Labels.size() );
+  }
+
+  /** Does the specified label exist? Can only be called after a call to
+   * Update(). */
+  bool HasLabel(LabelPixelType label) const
+  {
+    return m_LabelAttributes.find(label) != m_LabelAttributes.end();
+  }
+
+  /** Get the attributes of a label. An exception is thrown if the label
+   * does not exist. */
+  const LabelAttributes & GetLabelAttributes(LabelPixelType label) const;
+
+  /** Get the Dice and Jaccard coefficients over all the labels but the
+   * background, 0, like LabelOverlapMeasuresImageFilter. */
+  double GetDiceCoefficient() const;
+  double GetJaccardCoefficient() const;
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  // Begin concept checking
+  itkConceptMacro( IntensityHasNumericTraitsCheck,
+                   ( Concept::HasNumericTraits< IntensityPixelType > ) );
+  itkConceptMacro( SameDimensionCheck,
+                   ( Concept::SameDimension< TLabelImage::ImageDimension, TIntensityImage::ImageDimension > ) );
+  // End concept checking
+#endif
+
+protected:
+  LabelAttributesImageFilter();
+  ~LabelAttributesImageFilter() {}
+  void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+  /** Pass the input through unmodified. Do this by Grafting in the
+    AllocateOutputs method. */
+  void AllocateOutputs() ITK_OVERRIDE;
+
+  /** Initialize the accumulators of the threads. */
+  void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+  /** Merge the accumulators of the threads and compute the attributes. */
+  void AfterThreadedGenerateData() ITK_OVERRIDE;
+
+  /** Accumulate the runs of the labels of a region. */
+  void ThreadedGenerateData(const RegionType & outputRegionForThread,
+                            ThreadIdType threadId) ITK_OVERRIDE;
+
+  // Override since the filter produces all of its output
+  void EnlargeOutputRequestedRegion(DataObject *data) ITK_OVERRIDE;
+
+private:
+  ITK_DISALLOW_COPY_AND_ASSIGN(LabelAttributesImageFilter);
+
+  typedef Matrix< double, itkGetStaticConstMacro(ImageDimension), itkGetStaticConstMacro(ImageDimension) > MatrixType;
+
+  /** The sums accumulated for a label. */
+  struct LabelAccumulator
+  {
+    LabelAccumulator();
+
+    /** Add the sums of another accumulator. */
+    void Merge(const LabelAccumulator & other);
+
+    SizeValueType                 m_Count;
+    SizeValueType                 m_TargetCount;
+    SizeValueType                 m_Intersection;
+    IndexType                     m_Minimum;
+    IndexType                     m_Maximum;
+    VectorType                    m_IndexSum;
+    MatrixType                    m_IndexProductSum;
+    RealType                      m_IntensityMinimum;
+    RealType                      m_IntensityMaximum;
+    RealType                      m_IntensitySum;
+    RealType                      m_IntensitySumOfSquares;
+    std::vector< SizeValueType >  m_Histogram;
+  };
+
+  typedef itksys::hash_map< LabelPixelType, LabelAccumulator > AccumulatorMapType;
+
+  /** The accumulators of a thread. */
+  struct ThreadAccumulators
+  {
+    std::vector< LabelAccumulator > m_Dense;
+    AccumulatorMapType              m_Sparse;
+  };
+
+  /** Get the accumulator of a label, creating it if needed. The references to
+   * the accumulators are invalidated by the creation of a new accumulator. */
+  LabelAccumulator & GetAccumulator(ThreadAccumulators & accumulators, LabelPixelType label) const;
+
+  /** Compute the attributes of a label from its accumulator. */
+  void ComputeAttributes(const LabelAccumulator & accumulator, LabelAttributes & attributes) const;
+
+  bool          m_ComputeShape;
+  bool          m_ComputeBoundingBox;
+  bool          m_UseHistograms;
+  unsigned int  m_NumberOfBins;
+  RealType      m_HistogramLowerBound;
+  RealType      m_HistogramUpperBound;
+  bool          m_HistogramParametersSet;
+  SizeValueType m_DenseLabelRange;
+
+  std::vector< ThreadAccumulators >            m_ThreadAccumulators;
+  std::map< LabelPixelType, LabelAttributes > m_LabelAttributes;
+  LabelVectorType                              m_Labels;
+}; // end of class
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkLabelAttributesImageFilter.hxx"
+#endif
+
+#endif
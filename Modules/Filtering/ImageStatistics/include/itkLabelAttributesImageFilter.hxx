@@ -0,0 +1,600 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLabelAttributesImageFilter_hxx
+#define itkLabelAttributesImageFilter_hxx
+#include "itkLabelAttributesImageFilter.h"
+
+#include "itkImageScanlineConstIterator.h"
+#include "itkMinimumMaximumImageCalculator.h"
+#include "itkProgressReporter.h"
+#include "vnl/algo/vnl_symmetric_eigensystem.h"
+
+namespace itk
+{
+template< typename TLabelImage, typename TIntensityImage >
+LabelAttributesImageFilter< TLabelImage, TIntensityImage >
+::LabelAttributesImageFilter():
+  m_ComputeShape( true ),
+  m_ComputeBoundingBox( true ),
+  m_UseHistograms( false ),
+  m_NumberOfBins( 20 ),
+  m_HistogramLowerBound( NumericTraits< RealType >::ZeroValue() ),
+  m_HistogramUpperBound( NumericTraits< RealType >::ZeroValue() ),
+  m_HistogramParametersSet( false ),
+  m_DenseLabelRange( 16384 )
+{
+}
+
+template< typename TLabelImage, typename TIntensityImage >
+LabelAttributesImageFilter< TLabelImage, TIntensityImage >
+::LabelAccumulator::LabelAccumulator():
+  m_Count( 0 ),
+  m_TargetCount( 0 ),
+  m_Intersection( 0 ),
+  m_IntensityMinimum( NumericTraits< RealType >::max() ),
+  m_IntensityMaximum( NumericTraits< RealType >::NonpositiveMin() ),
+  m_IntensitySum( NumericTraits< RealType >::ZeroValue() ),
+  m_IntensitySumOfSquares( NumericTraits< RealType >::ZeroValue() )
+{
+  m_Minimum.Fill( NumericTraits< IndexValueType >::max() );
+  m_Maximum.Fill( NumericTraits< IndexValueType >::NonpositiveMin() );
+  m_IndexSum.Fill(0.0);
+  m_IndexProductSum.Fill(0.0);
+}
+
+template< typename TLabelImage, typename TIntensityImage >
+void
+LabelAttributesImageFilter< TLabelImage, TIntensityImage >
+::LabelAccumulator::Merge(const LabelAccumulator & other)
+{
+  m_Count += other.m_Count;
+  m_TargetCount += other.m_TargetCount;
+  m_Intersection += other.m_Intersection;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    m_Minimum[i] = std::min( m_Minimum[i], other.m_Minimum[i] );
+    m_Maximum[i] = std::max( m_Maximum[i], other.m_Maximum[i] );
+    }
+  m_IndexSum += other.m_IndexSum;
+  m_IndexProductSum += other.m_IndexProductSum;
+  m_IntensityMinimum = std::min( m_IntensityMinimum, other.m_IntensityMinimum );
+  m_IntensityMaximum = std::max( m_IntensityMaximum, other.m_IntensityMaximum );
+  m_IntensitySum += other.m_IntensitySum;
+  m_IntensitySumOfSquares += other.m_IntensitySumOfSquares;
+  if ( m_Histogram.empty() )
+    {
+    m_Histogram = other.m_Histogram;
+    }
+  else
+    {
+    for ( SizeValueType bin = 0; bin < other.m_Histogram.size(); ++bin )
+      {
+      m_Histogram[bin] += other.m_Histogram[bin];
+      }
+    }
+}
+
+template< typename TLabelImage, typename TIntensityImage >
+void
+LabelAttributesImageFilter< TLabelImage, TIntensityImage >
+::SetHistogramParameters(unsigned int numberOfBins, RealType lowerBound, RealType upperBound)
+{
+  if ( numberOfBins != m_NumberOfBins || Math::NotExactlyEquals(lowerBound, m_HistogramLowerBound)
+       || Math::NotExactlyEquals(upperBound, m_HistogramUpperBound) || !m_UseHistograms
+       || !m_HistogramParametersSet )
+    {
+    m_NumberOfBins = numberOfBins;
+    m_HistogramLowerBound = lowerBound;
+    m_HistogramUpperBound = upperBound;
+    m_HistogramParametersSet = true;
+    m_UseHistograms = true;
+    this->Modified();
+    }
+}
+
+template< typename TLabelImage, typename TIntensityImage >
+void
+LabelAttributesImageFilter< TLabelImage, TIntensityImage >
+::EnlargeOutputRequestedRegion(DataObject *data)
+{
+  Superclass::EnlargeOutputRequestedRegion(data);
+  data->SetRequestedRegionToLargestPossibleRegion();
+}
+
+template< typename TLabelImage, typename TIntensityImage >
+void
+LabelAttributesImageFilter< TLabelImage, TIntensityImage >
+::AllocateOutputs()
+{
+  // Pass the input through as the output
+  LabelImagePointer image = const_cast< LabelImageType * >( this->GetInput() );
+
+  this->GraftOutput(image);
+}
+
+template< typename TLabelImage, typename TIntensityImage >
+void
+LabelAttributesImageFilter< TLabelImage, TIntensityImage >
+::BeforeThreadedGenerateData()
+{
+  if ( m_UseHistograms )
+    {
+    if ( !this->GetIntensityImage() )
+      {
+      itkExceptionMacro("The histograms require an intensity image.");
+      }
+    if ( !m_HistogramParametersSet )
+      {
+      // The range of the pixel type is not usable as default bounds: its
+      // width overflows for the real types.
+      typedef MinimumMaximumImageCalculator< IntensityImageType > CalculatorType;
+      typename CalculatorType::Pointer calculator = CalculatorType::New();
+      calculator->SetImage( this->GetIntensityImage() );
+      calculator->SetRegion( this->GetOutput()->GetRequestedRegion() );
+      calculator->Compute();
+      m_HistogramLowerBound = static_cast< RealType >( calculator->GetMinimum() );
+      m_HistogramUpperBound = static_cast< RealType >( calculator->GetMaximum() );
+      if ( !( m_HistogramLowerBound < m_HistogramUpperBound ) )
+        {
+        // the first bin holds all the values of a constant image
+        m_HistogramUpperBound = m_HistogramLowerBound
+                                + std::max( NumericTraits< RealType >::OneValue(), Math::abs(m_HistogramLowerBound) );
+        }
+      }
+    if ( m_NumberOfBins == 0 || !( m_HistogramLowerBound < m_HistogramUpperBound ) )
+      {
+      itkExceptionMacro("Invalid histogram parameters: " << m_NumberOfBins << " bins in ["
+                        << m_HistogramLowerBound << ", " << m_HistogramUpperBound << "].");
+      }
+    }
+
+  m_ThreadAccumulators.clear();
+  m_ThreadAccumulators.resize( this->GetNumberOfThreads() );
+  m_LabelAttributes.clear();
+  m_Labels.clear();
+}
+
+template< typename TLabelImage, typename TIntensityImage >
+typename LabelAttributesImageFilter< TLabelImage, TIntensityImage >::LabelAccumulator &
+LabelAttributesImageFilter< TLabelImage, TIntensityImage >
+::GetAccumulator(ThreadAccumulators & accumulators, LabelPixelType label) const
+{
+  if ( !( label < NumericTraits< LabelPixelType >::ZeroValue() )
+       && static_cast< SizeValueType >( label ) < m_DenseLabelRange )
+    {
+    std::vector< LabelAccumulator > & dense = accumulators.m_Dense;
+    const SizeValueType               position = static_cast< SizeValueType >( label );
+    if ( position >= dense.size() )
+      {
+      // grow geometrically, up to the range of the dense labels
+      dense.resize( std::min( std::max( 2 * dense.size(), position + 1 ), m_DenseLabelRange ) );
+      }
+    return dense[position];
+    }
+  return accumulators.m_Sparse[label];
+}
+
+template< typename TLabelImage, typename TIntensityImage >
+void
+LabelAttributesImageFilter< TLabelImage, TIntensityImage >
+::ThreadedGenerateData(const RegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  const SizeValueType size0 = outputRegionForThread.GetSize(0);
+  if ( size0 == 0 )
+    {
+    return;
+    }
+
+  const IntensityImageType *intensityImage = this->GetIntensityImage();
+  const LabelImageType     *targetImage = this->GetTargetImage();
+  ThreadAccumulators &      accumulators = m_ThreadAccumulators[threadId];
+
+  ImageScanlineConstIterator< LabelImageType >     labelIt( this->GetInput(), outputRegionForThread );
+  ImageScanlineConstIterator< IntensityImageType > intensityIt;
+  ImageScanlineConstIterator< LabelImageType >     targetIt;
+  if ( intensityImage )
+    {
+    intensityIt = ImageScanlineConstIterator< IntensityImageType >( intensityImage, outputRegionForThread );
+    }
+  if ( targetImage )
+    {
+    targetIt = ImageScanlineConstIterator< LabelImageType >( targetImage, outputRegionForThread );
+    }
+
+  const bool   useHistograms = m_UseHistograms;
+  const double binsPerIntensity = m_NumberOfBins / static_cast< double >( m_HistogramUpperBound - m_HistogramLowerBound );
+
+  // the runs of the target labels in the current line. They are added to the
+  // accumulators at the end of the line, so the accumulator of the current
+  // run of the label image stays valid.
+  std::vector< std::pair< LabelPixelType, SizeValueType > > targetRuns;
+
+  // support progress methods/callbacks
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() / size0 );
+
+  while ( !labelIt.IsAtEnd() )
+    {
+    IndexType index = labelIt.GetIndex();
+    targetRuns.clear();
+
+    while ( !labelIt.IsAtEndOfLine() )
+      {
+      const LabelPixelType label = labelIt.Get();
+      LabelAccumulator &   accumulator = this->GetAccumulator(accumulators, label);
+      const IndexValueType runBegin = index[0];
+
+      // process the pixels of the run
+      SizeValueType length = 0;
+      do
+        {
+        if ( intensityImage )
+          {
+          const RealType value = static_cast< RealType >( intensityIt.Get() );
+          accumulator.m_IntensityMinimum = std::min( accumulator.m_IntensityMinimum, value );
+          accumulator.m_IntensityMaximum = std::max( accumulator.m_IntensityMaximum, value );
+          accumulator.m_IntensitySum += value;
+          accumulator.m_IntensitySumOfSquares += value * value;
+          if ( useHistograms )
+            {
+            if ( accumulator.m_Histogram.empty() )
+              {
+              accumulator.m_Histogram.resize(m_NumberOfBins, 0);
+              }
+            const double  position = ( value - m_HistogramLowerBound ) * binsPerIntensity;
+            SizeValueType bin = 0;
+            if ( position >= m_NumberOfBins )
+              {
+              bin = m_NumberOfBins - 1;
+              }
+            else if ( position > 0.0 )
+              {
+              bin = static_cast< SizeValueType >( position );
+              }
+            ++accumulator.m_Histogram[bin];
+            }
+          ++intensityIt;
+          }
+        if ( targetImage )
+          {
+          const LabelPixelType target = targetIt.Get();
+          if ( target == label )
+            {
+            ++accumulator.m_Intersection;
+            }
+          if ( targetRuns.empty() || targetRuns.back().first != target )
+            {
+            targetRuns.push_back( std::make_pair(target, 0) );
+            }
+          ++targetRuns.back().second;
+          ++targetIt;
+          }
+        ++length;
+        ++labelIt;
+        }
+      while ( !labelIt.IsAtEndOfLine() && labelIt.Get() == label );
+
+      accumulator.m_Count += length;
+
+      if ( m_ComputeBoundingBox )
+        {
+        accumulator.m_Minimum[0] = std::min( accumulator.m_Minimum[0], runBegin );
+        accumulator.m_Maximum[0] = std::max( accumulator.m_Maximum[0], static_cast< IndexValueType >( runBegin + length - 1 ) );
+        for ( unsigned int i = 1; i < ImageDimension; ++i )
+          {
+          accumulator.m_Minimum[i] = std::min( accumulator.m_Minimum[i], index[i] );
+          accumulator.m_Maximum[i] = std::max( accumulator.m_Maximum[i], index[i] );
+          }
+        }
+
+      if ( m_ComputeShape )
+        {
+        // the sums of the indices and of their products over the run, in
+        // closed form along the first dimension
+        const double n = static_cast< double >( length );
+        const double x = static_cast< double >( runBegin );
+        const double sumX = n * x + n * ( n - 1.0 ) / 2.0;
+        accumulator.m_IndexSum[0] += sumX;
+        accumulator.m_IndexProductSum[0][0] += n * x * x + x * n * ( n - 1.0 ) + ( n - 1.0 ) * n * ( 2.0 * n - 1.0 ) / 6.0;
+        for ( unsigned int i = 1; i < ImageDimension; ++i )
+          {
+          const double y = static_cast< double >( index[i] );
+          accumulator.m_IndexSum[i] += n * y;
+          accumulator.m_IndexProductSum[0][i] += sumX * y;
+          for ( unsigned int j = i; j < ImageDimension; ++j )
+            {
+            accumulator.m_IndexProductSum[i][j] += n * y * index[j];
+            }
+          }
+        }
+
+      index[0] += length;
+      }
+
+    for ( SizeValueType r = 0; r < targetRuns.size(); ++r )
+      {
+      this->GetAccumulator(accumulators, targetRuns[r].first).m_TargetCount += targetRuns[r].second;
+      }
+
+    labelIt.NextLine();
+    if ( intensityImage )
+      {
+      intensityIt.NextLine();
+      }
+    if ( targetImage )
+      {
+      targetIt.NextLine();
+      }
+    progress.CompletedPixel();
+    }
+}
+
+template< typename TLabelImage, typename TIntensityImage >
+void
+LabelAttributesImageFilter< TLabelImage, TIntensityImage >
+::AfterThreadedGenerateData()
+{
+  // merge the accumulators of the threads in the ones of the first thread
+  ThreadAccumulators & merged = m_ThreadAccumulators[0];
+  for ( ThreadIdType t = 1; t < m_ThreadAccumulators.size(); ++t )
+    {
+    const ThreadAccumulators & accumulators = m_ThreadAccumulators[t];
+    if ( accumulators.m_Dense.size() > merged.m_Dense.size() )
+      {
+      merged.m_Dense.resize( accumulators.m_Dense.size() );
+      }
+    for ( SizeValueType i = 0; i < accumulators.m_Dense.size(); ++i )
+      {
+      if ( accumulators.m_Dense[i].m_Count > 0 || accumulators.m_Dense[i].m_TargetCount > 0 )
+        {
+        merged.m_Dense[i].Merge( accumulators.m_Dense[i] );
+        }
+      }
+    for ( typename AccumulatorMapType::const_iterator it = accumulators.m_Sparse.begin();
+          it != accumulators.m_Sparse.end(); ++it )
+      {
+      merged.m_Sparse[it->first].Merge(it->second);
+      }
+    }
+
+  // compute the attributes of the labels found
+  for ( SizeValueType i = 0; i < merged.m_Dense.size(); ++i )
+    {
+    if ( merged.m_Dense[i].m_Count > 0 || merged.m_Dense[i].m_TargetCount > 0 )
+      {
+      this->ComputeAttributes( merged.m_Dense[i], m_LabelAttributes[static_cast< LabelPixelType >( i )] );
+      }
+    }
+  for ( typename AccumulatorMapType::const_iterator it = merged.m_Sparse.begin();
+        it != merged.m_Sparse.end(); ++it )
+    {
+    this->ComputeAttributes( it->second, m_LabelAttributes[it->first] );
+    }
+
+  m_Labels.reserve( m_LabelAttributes.size() );
+  for ( typename std::map< LabelPixelType, LabelAttributes >::const_iterator it = m_LabelAttributes.begin();
+        it != m_LabelAttributes.end(); ++it )
+    {
+    m_Labels.push_back(it->first);
+    }
+
+  // release the accumulators
+  m_ThreadAccumulators.clear();
+}
+
+template< typename TLabelImage, typename TIntensityImage >
+void
+LabelAttributesImageFilter< TLabelImage, TIntensityImage >
+::ComputeAttributes(const LabelAccumulator & accumulator, LabelAttributes & attributes) const
+{
+  const LabelImageType *image = this->GetInput();
+  const SizeValueType   count = accumulator.m_Count;
+
+  attributes.m_NumberOfPixels = count;
+
+  if ( count > 0 && m_ComputeShape )
+    {
+    double sizePerPixel = 1.0;
+    for ( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+      sizePerPixel *= image->GetSpacing()[i];
+      }
+    attributes.m_PhysicalSize = count * sizePerPixel;
+
+    // the centroid, and the central moments in the index space
+    ContinuousIndex< double, ImageDimension > centroid;
+    MatrixType                                 indexMoments;
+    for ( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+      centroid[i] = accumulator.m_IndexSum[i] / count;
+      }
+    for ( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+      for ( unsigned int j = i; j < ImageDimension; ++j )
+        {
+        indexMoments[i][j] = accumulator.m_IndexProductSum[i][j] / count - centroid[i] * centroid[j];
+        indexMoments[j][i] = indexMoments[i][j];
+        }
+      }
+    image->TransformContinuousIndexToPhysicalPoint(centroid, attributes.m_Centroid);
+
+    // the central moments in the physical space
+    MatrixType indexToPhysical = image->GetDirection();
+    for ( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+      for ( unsigned int j = 0; j < ImageDimension; ++j )
+        {
+        indexToPhysical[i][j] *= image->GetSpacing()[j];
+        }
+      }
+    const MatrixType centralMoments( indexToPhysical.GetVnlMatrix() * indexMoments.GetVnlMatrix()
+                                     * indexToPhysical.GetVnlMatrix().transpose() );
+
+    vnl_symmetric_eigensystem< double > eigen( centralMoments.GetVnlMatrix() );
+    for ( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+      attributes.m_PrincipalMoments[i] = eigen.D(i, i);
+      }
+
+    // like in ShapeLabelMapFilter
+    if ( ImageDimension < 2 )
+      {
+      attributes.m_Elongation = 1.0;
+      }
+    else if ( Math::NotAlmostEquals( attributes.m_PrincipalMoments[0], 0.0 ) )
+      {
+      attributes.m_Elongation = std::sqrt( attributes.m_PrincipalMoments[ImageDimension - 1]
+                                           / attributes.m_PrincipalMoments[ImageDimension - 2] );
+      }
+    }
+
+  if ( count > 0 && m_ComputeBoundingBox )
+    {
+    SizeType size;
+    for ( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+      size[i] = static_cast< SizeValueType >( accumulator.m_Maximum[i] - accumulator.m_Minimum[i] + 1 );
+      }
+    attributes.m_BoundingBox = RegionType(accumulator.m_Minimum, size);
+    }
+
+  if ( count > 0 && this->GetIntensityImage() )
+    {
+    attributes.m_Minimum = accumulator.m_IntensityMinimum;
+    attributes.m_Maximum = accumulator.m_IntensityMaximum;
+    attributes.m_Sum = accumulator.m_IntensitySum;
+    attributes.m_Mean = accumulator.m_IntensitySum / static_cast< RealType >( count );
+    if ( count > 1 )
+      {
+      // unbiased estimate of variance
+      attributes.m_Variance = ( accumulator.m_IntensitySumOfSquares
+                                - accumulator.m_IntensitySum * accumulator.m_IntensitySum / static_cast< RealType >( count ) )
+                              / static_cast< RealType >( count - 1 );
+      }
+    attributes.m_Sigma = std::sqrt( attributes.m_Variance );
+
+    if ( m_UseHistograms )
+      {
+      typename HistogramType::SizeType              size(1);
+      typename HistogramType::MeasurementVectorType lowerBound(1);
+      typename HistogramType::MeasurementVectorType upperBound(1);
+      size[0] = m_NumberOfBins;
+      lowerBound[0] = m_HistogramLowerBound;
+      upperBound[0] = m_HistogramUpperBound;
+      attributes.m_Histogram = HistogramType::New();
+      attributes.m_Histogram->SetMeasurementVectorSize(1);
+      attributes.m_Histogram->Initialize(size, lowerBound, upperBound);
+
+      // count bins until just over half the distribution is counted, and use
+      // the center of that bin as the median
+      SizeValueType total = 0;
+      SizeValueType medianBin = m_NumberOfBins;
+      for ( unsigned int bin = 0; bin < m_NumberOfBins; ++bin )
+        {
+        attributes.m_Histogram->IncreaseFrequency( bin, accumulator.m_Histogram[bin] );
+        total += accumulator.m_Histogram[bin];
+        if ( medianBin == m_NumberOfBins && total > count / 2 )
+          {
+          medianBin = bin;
+          }
+        }
+      attributes.m_Median = ( attributes.m_Histogram->GetBinMin(0, medianBin)
+                              + attributes.m_Histogram->GetBinMax(0, medianBin) ) / 2;
+      }
+    }
+
+  if ( this->GetTargetImage() )
+    {
+    attributes.m_TargetNumberOfPixels = accumulator.m_TargetCount;
+    attributes.m_Intersection = accumulator.m_Intersection;
+    const SizeValueType sum = count + accumulator.m_TargetCount;
+    attributes.m_DiceCoefficient = 2.0 * accumulator.m_Intersection / sum;
+    attributes.m_JaccardCoefficient = static_cast< double >( accumulator.m_Intersection )
+                                      / ( sum - accumulator.m_Intersection );
+    }
+}
+
+template< typename TLabelImage, typename TIntensityImage >
+const typename LabelAttributesImageFilter< TLabelImage, TIntensityImage >::LabelAttributes &
+LabelAttributesImageFilter< TLabelImage, TIntensityImage >
+::GetLabelAttributes(LabelPixelType label) const
+{
+  typename std::map< LabelPixelType, LabelAttributes >::const_iterator it = m_LabelAttributes.find(label);
+  if ( it == m_LabelAttributes.end() )
+    {
+    itkExceptionMacro( "Label "
+                       << static_cast< typename NumericTraits< LabelPixelType >::PrintType >( label )
+                       << " not found." );
+    }
+  return it->second;
+}
+
+template< typename TLabelImage, typename TIntensityImage >
+double
+LabelAttributesImageFilter< TLabelImage, TIntensityImage >
+::GetJaccardCoefficient() const
+{
+  double intersection = 0.0;
+  double unionSize = 0.0;
+  for ( typename std::map< LabelPixelType, LabelAttributes >::const_iterator it = m_LabelAttributes.begin();
+        it != m_LabelAttributes.end(); ++it )
+    {
+    // Do not include the background in the final value.
+    if ( it->first == NumericTraits< LabelPixelType >::ZeroValue() )
+      {
+      continue;
+      }
+    intersection += it->second.m_Intersection;
+    unionSize += it->second.m_NumberOfPixels + it->second.m_TargetNumberOfPixels - it->second.m_Intersection;
+    }
+
+  if ( Math::ExactlyEquals(unionSize, 0.0) )
+    {
+    return NumericTraits< double >::max();
+    }
+  return intersection / unionSize;
+}
+
+template< typename TLabelImage, typename TIntensityImage >
+double
+LabelAttributesImageFilter< TLabelImage, TIntensityImage >
+::GetDiceCoefficient() const
+{
+  const double jaccard = this->GetJaccardCoefficient();
+  return 2.0 * jaccard / ( 1.0 + jaccard );
+}
+
+template< typename TLabelImage, typename TIntensityImage >
+void
+LabelAttributesImageFilter< TLabelImage, TIntensityImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "ComputeShape: " << m_ComputeShape << std::endl;
+  os << indent << "ComputeBoundingBox: " << m_ComputeBoundingBox << std::endl;
+  os << indent << "UseHistograms: " << m_UseHistograms << std::endl;
+  os << indent << "NumberOfBins: " << m_NumberOfBins << std::endl;
+  os << indent << "HistogramLowerBound: " << m_HistogramLowerBound << std::endl;
+  os << indent << "HistogramUpperBound: " << m_HistogramUpperBound << std::endl;
+  os << indent << "HistogramParametersSet: " << m_HistogramParametersSet << std::endl;
+  os << indent << "DenseLabelRange: " << m_DenseLabelRange << std::endl;
+  os << indent << "NumberOfLabels: " << m_Labels.size() << std::endl;
+}
+} // end namespace itk
+#endif
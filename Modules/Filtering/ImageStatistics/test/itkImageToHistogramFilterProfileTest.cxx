@@ -0,0 +1,213 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageToHistogramFilter.h"
+#include "itkMaskedImageToHistogramFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTimeProbesCollectorBase.h"
+#include "itkTestingMacros.h"
+
+// Compare the computation of the bins of regularly spaced histograms with
+// the search of the bins, and profile ImageToHistogramFilter and
+// MaskedImageToHistogramFilter.
+int itkImageToHistogramFilterProfileTest(int, char *[])
+{
+  typedef itk::Image< float, 3 >                                                  ImageType;
+  typedef itk::Image< unsigned char, 3 >                                          MaskImageType;
+  typedef itk::Statistics::ImageToHistogramFilter< ImageType >                    FilterType;
+  typedef itk::Statistics::MaskedImageToHistogramFilter< ImageType, MaskImageType > MaskedFilterType;
+  typedef FilterType::HistogramType                                               HistogramType;
+
+  itk::TimeProbesCollectorBase chronometer;
+
+  // The bins of a regularly spaced histogram, and the same bins set one by
+  // one, which must be searched
+  const unsigned int numberOfBins = 1000;
+  HistogramType::SizeType size(1);
+  size[0] = numberOfBins;
+  HistogramType::MeasurementVectorType lowerBound(1);
+  HistogramType::MeasurementVectorType upperBound(1);
+  lowerBound[0] = -12.3;
+  upperBound[0] = 987.6;
+
+  HistogramType::Pointer regular = HistogramType::New();
+  regular->SetMeasurementVectorSize(1);
+  regular->Initialize(size, lowerBound, upperBound);
+
+  HistogramType::Pointer searched = HistogramType::New();
+  searched->SetMeasurementVectorSize(1);
+  searched->Initialize(size);
+  for ( unsigned int bin = 0; bin < numberOfBins; ++bin )
+    {
+    searched->SetBinMin( 0, bin, regular->GetBinMin(0, bin) );
+    searched->SetBinMax( 0, bin, regular->GetBinMax(0, bin) );
+    }
+
+  // Measurements inside and outside of the histogram, and on the bounds of
+  // the bins
+  std::vector< HistogramType::MeasurementType > measurements;
+  for ( unsigned int bin = 0; bin < numberOfBins; ++bin )
+    {
+    measurements.push_back( regular->GetBinMin(0, bin) );
+    measurements.push_back( regular->GetBinMax(0, bin) );
+    }
+  for ( unsigned int i = 0; i < 1000000; ++i )
+    {
+    measurements.push_back( -20.0f + 1010.0f * ( ( i * 7919u ) % 1000000u ) / 1000000.0f );
+    }
+
+  HistogramType::MeasurementVectorType measurement(1);
+  HistogramType::IndexType             regularIndex(1);
+  HistogramType::IndexType             searchedIndex(1);
+  for ( int clip = 0; clip < 2; ++clip )
+    {
+    regular->SetClipBinsAtEnds( clip != 0 );
+    searched->SetClipBinsAtEnds( clip != 0 );
+    for ( unsigned int i = 0; i < measurements.size(); ++i )
+      {
+      measurement[0] = measurements[i];
+      const bool regularInside = regular->GetIndex(measurement, regularIndex);
+      const bool searchedInside = searched->GetIndex(measurement, searchedIndex);
+      if ( regularInside != searchedInside || regularIndex[0] != searchedIndex[0] )
+        {
+        std::cerr << "Test failed: the bin of " << measurements[i] << " is " << regularIndex[0]
+                  << " instead of " << searchedIndex[0] << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // Profile the computation and the search of the bins
+  {
+  itk::SizeValueType regularSum = 0;
+  itk::SizeValueType searchedSum = 0;
+  chronometer.Start("GetIndex, computed");
+  for ( unsigned int i = 0; i < measurements.size(); ++i )
+    {
+    measurement[0] = measurements[i];
+    regular->GetIndex(measurement, regularIndex);
+    regularSum += regularIndex[0];
+    }
+  chronometer.Stop("GetIndex, computed");
+  chronometer.Start("GetIndex, searched");
+  for ( unsigned int i = 0; i < measurements.size(); ++i )
+    {
+    measurement[0] = measurements[i];
+    searched->GetIndex(measurement, searchedIndex);
+    searchedSum += searchedIndex[0];
+    }
+  chronometer.Stop("GetIndex, searched");
+  TEST_EXPECT_EQUAL( regularSum, searchedSum );
+  }
+
+  // The histograms of an image do not depend on the number of threads
+  ImageType::SizeType imageSize;
+  imageSize[0] = 97;
+  imageSize[1] = 83;
+  imageSize[2] = 71;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(imageSize);
+  image->Allocate();
+  MaskImageType::Pointer mask = MaskImageType::New();
+  mask->SetRegions(imageSize);
+  mask->Allocate();
+  for ( itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType idx = it.GetIndex();
+    it.Set( static_cast< float >( ( 7 * idx[0] + 3 * idx[1] + 11 * idx[2] ) % 1000 ) + 0.25f );
+    mask->SetPixel( idx, ( idx[0] + idx[1] ) % 3 == 0 ? 1 : 0 );
+    }
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetHistogramSize(size);
+  filter->SetAutoMinimumMaximum(true);
+
+  MaskedFilterType::Pointer maskedFilter = MaskedFilterType::New();
+  maskedFilter->SetInput(image);
+  maskedFilter->SetMaskImage(mask);
+  maskedFilter->SetMaskValue(1);
+  maskedFilter->SetHistogramSize(size);
+  maskedFilter->SetAutoMinimumMaximum(true);
+
+  HistogramType::Pointer reference;
+  HistogramType::Pointer maskedReference;
+  const itk::ThreadIdType numberOfThreads[3] = { 1, 3, 8 };
+  for ( unsigned int t = 0; t < 3; ++t )
+    {
+    std::ostringstream name;
+    name << numberOfThreads[t] << " threads";
+
+    filter->SetNumberOfThreads(numberOfThreads[t]);
+    filter->Modified();
+    chronometer.Start( ( "Image, " + name.str() ).c_str() );
+    TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+    chronometer.Stop( ( "Image, " + name.str() ).c_str() );
+
+    maskedFilter->SetNumberOfThreads(numberOfThreads[t]);
+    maskedFilter->Modified();
+    chronometer.Start( ( "Masked image, " + name.str() ).c_str() );
+    TRY_EXPECT_NO_EXCEPTION( maskedFilter->Update() );
+    chronometer.Stop( ( "Masked image, " + name.str() ).c_str() );
+
+    TEST_EXPECT_EQUAL( filter->GetOutput()->GetTotalFrequency(), image->GetLargestPossibleRegion().GetNumberOfPixels() );
+    if ( t == 0 )
+      {
+      reference = filter->GetOutput();
+      reference->DisconnectPipeline();
+      maskedReference = maskedFilter->GetOutput();
+      maskedReference->DisconnectPipeline();
+      continue;
+      }
+    for ( unsigned int bin = 0; bin < numberOfBins; ++bin )
+      {
+      if ( filter->GetOutput()->GetFrequency(bin) != reference->GetFrequency(bin)
+           || maskedFilter->GetOutput()->GetFrequency(bin) != maskedReference->GetFrequency(bin) )
+        {
+        std::cerr << "Test failed: the frequency of the bin " << bin << " depends on the number of threads." << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // The histogram filled with the searched bins is the same
+  searched->Initialize(size);
+  for ( unsigned int bin = 0; bin < numberOfBins; ++bin )
+    {
+    searched->SetBinMin( 0, bin, reference->GetBinMin(0, bin) );
+    searched->SetBinMax( 0, bin, reference->GetBinMax(0, bin) );
+    }
+  searched->SetClipBinsAtEnds( reference->GetClipBinsAtEnds() );
+  chronometer.Start("Histogram with searched bins");
+  for ( itk::ImageRegionConstIterator< ImageType > it( image, image->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    measurement[0] = it.Get();
+    searched->GetIndex(measurement, searchedIndex);
+    searched->IncreaseFrequencyOfIndex(searchedIndex, 1);
+    }
+  chronometer.Stop("Histogram with searched bins");
+  for ( unsigned int bin = 0; bin < numberOfBins; ++bin )
+    {
+    TEST_EXPECT_EQUAL( searched->GetFrequency(bin), reference->GetFrequency(bin) );
+    }
+
+  chronometer.Report( std::cout );
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
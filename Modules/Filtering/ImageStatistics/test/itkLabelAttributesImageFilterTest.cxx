@@ -0,0 +1,268 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkLabelAttributesImageFilter.h"
+#include "itkLabelStatisticsImageFilter.h"
+#include "itkLabelOverlapMeasuresImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+bool
+LabelAttributesClose(double value, double expected, const char *name, unsigned long label)
+{
+  if ( itk::Math::abs(value - expected) > 1e-9 * ( 1.0 + itk::Math::abs(expected) ) )
+    {
+    std::cerr << "Test failed: the " << name << " of the label " << label << " is " << value
+              << " instead of " << expected << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+int itkLabelAttributesImageFilterTest(int, char *[])
+{
+  const unsigned int Dimension = 2;
+
+  typedef itk::Image< unsigned short, Dimension >                            LabelImageType;
+  typedef itk::Image< float, Dimension >                                     IntensityImageType;
+  typedef itk::LabelAttributesImageFilter< LabelImageType, IntensityImageType > FilterType;
+  typedef FilterType::LabelAttributes                                        LabelAttributesType;
+
+  FilterType::Pointer filter = FilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( filter, LabelAttributesImageFilter, ImageToImageFilter );
+
+  // A box, a disc and a large label, whose accumulators are in a hash map,
+  // shifted in the target image, which also has a label of its own.
+  LabelImageType::SizeType size;
+  size[0] = 61;
+  size[1] = 47;
+  LabelImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 2.0;
+  LabelImageType::PointType origin;
+  origin[0] = -3.0;
+  origin[1] = 10.0;
+
+  LabelImageType::Pointer labels = LabelImageType::New();
+  labels->SetRegions(size);
+  labels->SetSpacing(spacing);
+  labels->SetOrigin(origin);
+  labels->Allocate(true);
+  LabelImageType::Pointer target = LabelImageType::New();
+  target->CopyInformation(labels);
+  target->SetRegions(size);
+  target->Allocate(true);
+  IntensityImageType::Pointer intensities = IntensityImageType::New();
+  intensities->CopyInformation(labels);
+  intensities->SetRegions(size);
+  intensities->Allocate();
+
+  for ( itk::ImageRegionIteratorWithIndex< LabelImageType > it( labels, labels->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    const LabelImageType::IndexType idx = it.GetIndex();
+    LabelImageType::IndexType       shifted = idx;
+    shifted[0] += 2;
+    unsigned short label = 0;
+    if ( idx[0] >= 5 && idx[0] < 25 && idx[1] >= 6 && idx[1] < 16 )
+      {
+      label = 1;
+      }
+    else if ( ( idx[0] - 40 ) * ( idx[0] - 40 ) + ( idx[1] - 30 ) * ( idx[1] - 30 ) < 100 )
+      {
+      label = 2;
+      }
+    else if ( idx[1] > 20 && idx[0] + idx[1] > 70 )
+      {
+      label = 40000;
+      }
+    it.Set(label);
+    if ( labels->GetLargestPossibleRegion().IsInside(shifted) )
+      {
+      target->SetPixel(shifted, label);
+      }
+    if ( idx[0] < 4 && idx[1] < 4 )
+      {
+      target->SetPixel(idx, 7);
+      }
+    intensities->SetPixel( idx, static_cast< float >( ( 7 * idx[0] + 13 * idx[1] ) % 100 ) );
+    }
+
+  filter->SetInput(labels);
+  filter->SetIntensityImage(intensities);
+  filter->SetTargetImage(target);
+  filter->SetHistogramParameters(20, 0.0, 100.0);
+  TEST_SET_GET_VALUE( true, filter->GetUseHistograms() );
+  TEST_SET_GET_VALUE( 20u, filter->GetNumberOfBins() );
+  TEST_SET_GET_BOOLEAN( filter, ComputeShape, true );
+  TEST_SET_GET_BOOLEAN( filter, ComputeBoundingBox, true );
+  TEST_SET_GET_VALUE( 16384u, filter->GetDenseLabelRange() );
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+  // The labels of both images are found
+  TEST_EXPECT_EQUAL( filter->GetNumberOfLabels(), 5 );
+  TEST_EXPECT_TRUE( filter->HasLabel(40000) );
+  TEST_EXPECT_TRUE( filter->HasLabel(7) );
+  TEST_EXPECT_TRUE( !filter->HasLabel(3) );
+  TRY_EXPECT_EXCEPTION( filter->GetLabelAttributes(3) );
+  TEST_EXPECT_EQUAL( filter->GetLabels().back(), 40000 );
+  TEST_EXPECT_EQUAL( filter->GetLabelAttributes(7).m_NumberOfPixels, 0 );
+  TEST_EXPECT_EQUAL( filter->GetLabelAttributes(7).m_TargetNumberOfPixels, 16 );
+
+  // The shape of the box
+  const LabelAttributesType & box = filter->GetLabelAttributes(1);
+  TEST_EXPECT_EQUAL( box.m_NumberOfPixels, 200 );
+  TEST_EXPECT_TRUE( LabelAttributesClose( box.m_PhysicalSize, 200.0, "physical size", 1 ) );
+  TEST_EXPECT_TRUE( LabelAttributesClose( box.m_Centroid[0], -3.0 + 14.5 * 0.5, "centroid", 1 ) );
+  TEST_EXPECT_TRUE( LabelAttributesClose( box.m_Centroid[1], 10.0 + 10.5 * 2.0, "centroid", 1 ) );
+  TEST_EXPECT_TRUE( LabelAttributesClose( box.m_PrincipalMoments[0], 0.25 * ( 20 * 20 - 1 ) / 12.0, "principal moment", 1 ) );
+  TEST_EXPECT_TRUE( LabelAttributesClose( box.m_PrincipalMoments[1], 4.0 * ( 10 * 10 - 1 ) / 12.0, "principal moment", 1 ) );
+  TEST_EXPECT_TRUE( LabelAttributesClose( box.m_Elongation, std::sqrt( box.m_PrincipalMoments[1] / box.m_PrincipalMoments[0] ),
+                                          "elongation", 1 ) );
+  LabelImageType::IndexType boxIndex;
+  boxIndex[0] = 5;
+  boxIndex[1] = 6;
+  LabelImageType::SizeType boxSize;
+  boxSize[0] = 20;
+  boxSize[1] = 10;
+  TEST_EXPECT_EQUAL( box.m_BoundingBox, LabelImageType::RegionType(boxIndex, boxSize) );
+
+  // The intensity attributes match the ones of LabelStatisticsImageFilter
+  typedef itk::LabelStatisticsImageFilter< IntensityImageType, LabelImageType > StatisticsFilterType;
+  StatisticsFilterType::Pointer statistics = StatisticsFilterType::New();
+  statistics->SetInput(intensities);
+  statistics->SetLabelInput(labels);
+  statistics->SetHistogramParameters(20, 0.0, 100.0);
+  statistics->Update();
+
+  // The overlap attributes match the ones of LabelOverlapMeasuresImageFilter
+  typedef itk::LabelOverlapMeasuresImageFilter< LabelImageType > OverlapFilterType;
+  OverlapFilterType::Pointer overlap = OverlapFilterType::New();
+  overlap->SetSourceImage(labels);
+  overlap->SetTargetImage(target);
+  overlap->Update();
+
+  for ( unsigned int l = 0; l < filter->GetNumberOfLabels(); ++l )
+    {
+    const unsigned short        label = filter->GetLabels()[l];
+    const LabelAttributesType & attributes = filter->GetLabelAttributes(label);
+    if ( attributes.m_NumberOfPixels > 0 )
+      {
+      TEST_EXPECT_EQUAL( attributes.m_NumberOfPixels, statistics->GetCount(label) );
+      TEST_EXPECT_EQUAL( attributes.m_BoundingBox, statistics->GetRegion(label) );
+      if ( !LabelAttributesClose( attributes.m_Minimum, statistics->GetMinimum(label), "minimum", label )
+           || !LabelAttributesClose( attributes.m_Maximum, statistics->GetMaximum(label), "maximum", label )
+           || !LabelAttributesClose( attributes.m_Sum, statistics->GetSum(label), "sum", label )
+           || !LabelAttributesClose( attributes.m_Mean, statistics->GetMean(label), "mean", label )
+           || !LabelAttributesClose( attributes.m_Variance, statistics->GetVariance(label), "variance", label )
+           || !LabelAttributesClose( attributes.m_Median, statistics->GetMedian(label), "median", label ) )
+        {
+        return EXIT_FAILURE;
+        }
+      for ( unsigned int bin = 0; bin < 20; ++bin )
+        {
+        TEST_EXPECT_EQUAL( attributes.m_Histogram->GetFrequency(bin), statistics->GetHistogram(label)->GetFrequency(bin) );
+        }
+      }
+    if ( !LabelAttributesClose( attributes.m_JaccardCoefficient, overlap->GetUnionOverlap(label), "Jaccard coefficient", label )
+         || !LabelAttributesClose( attributes.m_DiceCoefficient, overlap->GetMeanOverlap(label), "Dice coefficient", label ) )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+  TEST_EXPECT_TRUE( LabelAttributesClose( filter->GetJaccardCoefficient(), overlap->GetUnionOverlap(), "Jaccard coefficient", 0 ) );
+  TEST_EXPECT_TRUE( LabelAttributesClose( filter->GetDiceCoefficient(), overlap->GetMeanOverlap(), "Dice coefficient", 0 ) );
+
+  // The attributes do not depend on the number of threads, nor on the
+  // accumulators used for the labels
+  std::vector< LabelAttributesType > reference;
+  for ( unsigned int l = 0; l < filter->GetNumberOfLabels(); ++l )
+    {
+    reference.push_back( filter->GetLabelAttributes( filter->GetLabels()[l] ) );
+    }
+  const itk::ThreadIdType   numberOfThreads[3] = { 1, 3, 4 };
+  const itk::SizeValueType denseLabelRanges[3] = { 16384, 0, 2 };
+  for ( unsigned int t = 0; t < 3; ++t )
+    {
+    filter->SetNumberOfThreads(numberOfThreads[t]);
+    filter->SetDenseLabelRange(denseLabelRanges[t]);
+    TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+    TEST_EXPECT_EQUAL( filter->GetNumberOfLabels(), reference.size() );
+    for ( unsigned int l = 0; l < filter->GetNumberOfLabels(); ++l )
+      {
+      const unsigned short        label = filter->GetLabels()[l];
+      const LabelAttributesType & attributes = filter->GetLabelAttributes(label);
+      TEST_EXPECT_EQUAL( attributes.m_NumberOfPixels, reference[l].m_NumberOfPixels );
+      TEST_EXPECT_EQUAL( attributes.m_Intersection, reference[l].m_Intersection );
+      TEST_EXPECT_EQUAL( attributes.m_BoundingBox, reference[l].m_BoundingBox );
+      for ( unsigned int i = 0; i < Dimension; ++i )
+        {
+        if ( !LabelAttributesClose( attributes.m_Centroid[i], reference[l].m_Centroid[i], "centroid", label )
+             || !LabelAttributesClose( attributes.m_PrincipalMoments[i], reference[l].m_PrincipalMoments[i], "principal moment", label ) )
+          {
+          return EXIT_FAILURE;
+          }
+        }
+      if ( !LabelAttributesClose( attributes.m_Variance, reference[l].m_Variance, "variance", label )
+           || !LabelAttributesClose( attributes.m_Median, reference[l].m_Median, "median", label ) )
+        {
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // Without histogram parameters, the bounds of the histograms are the
+  // extrema of the float intensities, not the range of the pixel type
+  FilterType::Pointer defaultBounds = FilterType::New();
+  defaultBounds->SetInput(labels);
+  defaultBounds->SetIntensityImage(intensities);
+  defaultBounds->UseHistogramsOn();
+  TRY_EXPECT_NO_EXCEPTION( defaultBounds->Update() );
+  TEST_EXPECT_EQUAL( defaultBounds->GetHistogramLowerBound(), 0.0 );
+  TEST_EXPECT_EQUAL( defaultBounds->GetHistogramUpperBound(), 99.0 );
+  filter->SetIntensityImage(intensities);
+  filter->SetHistogramParameters(20, 0.0, 99.0);
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  for ( unsigned int l = 0; l < defaultBounds->GetNumberOfLabels(); ++l )
+    {
+    const unsigned short        label = defaultBounds->GetLabels()[l];
+    const LabelAttributesType & attributes = defaultBounds->GetLabelAttributes(label);
+    const LabelAttributesType & expected = filter->GetLabelAttributes(label);
+    TEST_EXPECT_TRUE( attributes.m_Median >= 0.0 && attributes.m_Median <= 99.0 );
+    TEST_EXPECT_EQUAL( attributes.m_Median, expected.m_Median );
+    for ( unsigned int bin = 0; bin < 20; ++bin )
+      {
+      TEST_EXPECT_EQUAL( attributes.m_Histogram->GetFrequency(bin), expected.m_Histogram->GetFrequency(bin) );
+      }
+    }
+
+  // The histograms require an intensity image
+  filter->SetIntensityImage(ITK_NULLPTR);
+  TRY_EXPECT_EXCEPTION( filter->Update() );
+  filter->UseHistogramsOff();
+  filter->ComputeShapeOff();
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  TEST_EXPECT_EQUAL( filter->GetLabelAttributes(2).m_NumberOfPixels, reference[2].m_NumberOfPixels );
+  TEST_EXPECT_EQUAL( filter->GetLabelAttributes(2).m_PhysicalSize, 0.0 );
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -30,6 +30,12 @@ namespace itk
  * LabelImageToLabelMapFilter converts a label image to a label collection image.
  * The labels are the same in the input and the output image.
  *
+ * Each thread collects the lines of its part of the image in its own label
+ * map. The label maps of the threads are then merged in parallel: the range
+ * of the labels is split in as many parts as there are threads, and each
+ * thread merges the objects of its labels. The output does not depend on
+ * the number of threads.
+ *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
  * This implementation was taken from the Insight Journal paper:
@@ -71,6 +77,7 @@ public:
   typedef typename OutputImageType::RegionType      OutputImageRegionType;
   typedef typename OutputImageType::PixelType       OutputImagePixelType;
   typedef typename OutputImageType::LabelObjectType LabelObjectType;
+  typedef typename LabelObjectType::LabelType       LabelType;
   typedef typename LabelObjectType::LengthType      LengthType;
 
   /** ImageDimension constants */
@@ -120,6 +127,28 @@ protected:
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(LabelImageToLabelMapFilter);
 
+  typedef std::vector< LabelObjectType * > LabelObjectVectorType;
+
+  struct MergeThreadStruct
+  {
+    Self                                 *Filter;
+    std::vector< LabelObjectVectorType > LabelObjects;
+    std::vector< LabelType >             LabelRangeBegins;
+    std::vector< LabelObjectVectorType > MovedLabelObjects;
+  };
+
+  static bool LabelLessThan(const LabelObjectType *labelObject, const LabelType & label)
+  {
+    return labelObject->GetLabel() < label;
+  }
+
+  /** Collect the objects of the label map of a thread, sorted by label. */
+  static ITK_THREAD_RETURN_TYPE CollectThreaderCallback(void *arg);
+
+  /** Merge the objects in a range of labels, and keep the objects which must
+   * be moved to the output. */
+  static ITK_THREAD_RETURN_TYPE MergeThreaderCallback(void *arg);
+
   OutputImagePixelType m_BackgroundValue;
 
   typename std::vector< OutputImagePointer > m_TemporaryImages;
@@ -22,6 +22,7 @@
 #include "itkNumericTraits.h"
 #include "itkProgressReporter.h"
 #include "itkImageLinearConstIteratorWithIndex.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -132,31 +133,68 @@ LabelImageToLabelMapFilter< TInputImage, TOutputImage >
 ::AfterThreadedGenerateData()
 {
   OutputImageType *output = this->GetOutput();
+  const ThreadIdType numberOfMaps = static_cast< ThreadIdType >( m_TemporaryImages.size() );
 
-  // merge the lines from the temporary images in the output image
-  // don't use the first image - that's the output image
-  for ( ThreadIdType i = 1; i < this->GetNumberOfThreads(); i++ )
+  if ( numberOfMaps > 1 )
     {
-    for ( typename OutputImageType::Iterator it( m_TemporaryImages[i] );
-          ! it.IsAtEnd();
-          ++it )
+    MultiThreader *multiThreader = this->GetMultiThreader();
+    multiThreader->SetNumberOfThreads( numberOfMaps );
+    const ThreadIdType numberOfThreads = multiThreader->GetNumberOfThreads();
+
+    MergeThreadStruct str;
+    str.Filter = this;
+    str.LabelObjects.resize(numberOfMaps);
+
+    // collect the objects of each map, sorted by label
+    multiThreader->SetSingleMethod(this->CollectThreaderCallback, &str);
+    multiThreader->SingleMethodExecute();
+    if ( numberOfThreads < numberOfMaps )
       {
-      LabelObjectType *labelObject = it.GetLabelObject();
-      if ( output->HasLabel( labelObject->GetLabel() ) )
+      for ( ThreadIdType i = numberOfThreads; i < numberOfMaps; i++ )
         {
-        // merge the lines in the output's object
-        LabelObjectType * lo = output->GetLabelObject( labelObject->GetLabel() );
-        typename LabelObjectType::ConstLineIterator lit( labelObject );
-        while( ! lit.IsAtEnd() )
+        for ( typename OutputImageType::Iterator it( m_TemporaryImages[i] ); !it.IsAtEnd(); ++it )
           {
-          lo->AddLine( lit.GetLine() );
-          ++lit;
+          str.LabelObjects[i].push_back( it.GetLabelObject() );
           }
         }
-      else
+      }
+
+    // split the labels in ranges of about the same number of objects, using
+    // the labels of the largest map. The first range also includes the
+    // labels lower than its first label in the other maps.
+    ThreadIdType largest = 0;
+    for ( ThreadIdType i = 1; i < numberOfMaps; i++ )
+      {
+      if ( str.LabelObjects[i].size() > str.LabelObjects[largest].size() )
+        {
+        largest = i;
+        }
+      }
+    const LabelObjectVectorType & largestObjects = str.LabelObjects[largest];
+    for ( ThreadIdType r = 0; r < numberOfThreads; r++ )
+      {
+      const SizeValueType position = largestObjects.size() * r / numberOfThreads;
+      if ( position < largestObjects.size()
+           && ( str.LabelRangeBegins.empty() || largestObjects[position]->GetLabel() != str.LabelRangeBegins.back() ) )
+        {
+        str.LabelRangeBegins.push_back( largestObjects[position]->GetLabel() );
+        }
+      }
+    str.MovedLabelObjects.resize( str.LabelRangeBegins.size() );
+
+    // merge the objects of each range of labels in the objects of the
+    // lowest map where the label is present
+    multiThreader->SetSingleMethod(this->MergeThreaderCallback, &str);
+    multiThreader->SingleMethodExecute();
+
+    // and move the objects which are not already in the output. Only the
+    // pointers to the objects are inserted here.
+    for ( SizeValueType r = 0; r < str.MovedLabelObjects.size(); r++ )
+      {
+      const LabelObjectVectorType & moved = str.MovedLabelObjects[r];
+      for ( typename LabelObjectVectorType::const_iterator it = moved.begin(); it != moved.end(); ++it )
         {
-        // simply take the object
-        output->AddLabelObject(labelObject);
+        output->AddLabelObject(*it);
         }
       }
     }
@@ -165,6 +203,108 @@ LabelImageToLabelMapFilter< TInputImage, TOutputImage >
   m_TemporaryImages.clear();
 }
 
+template< typename TInputImage, typename TOutputImage >
+ITK_THREAD_RETURN_TYPE
+LabelImageToLabelMapFilter< TInputImage, TOutputImage >
+::CollectThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  MergeThreadStruct *str = static_cast< MergeThreadStruct * >( info->UserData );
+
+  const ThreadIdType threadId = info->ThreadID;
+  if ( threadId < str->LabelObjects.size() )
+    {
+    OutputImageType *map = str->Filter->m_TemporaryImages[threadId];
+    LabelObjectVectorType & labelObjects = str->LabelObjects[threadId];
+    labelObjects.reserve( map->GetNumberOfLabelObjects() );
+    for ( typename OutputImageType::Iterator it( map ); !it.IsAtEnd(); ++it )
+      {
+      labelObjects.push_back( it.GetLabelObject() );
+      }
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TOutputImage >
+ITK_THREAD_RETURN_TYPE
+LabelImageToLabelMapFilter< TInputImage, TOutputImage >
+::MergeThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  MergeThreadStruct *str = static_cast< MergeThreadStruct * >( info->UserData );
+
+  const ThreadIdType range = info->ThreadID;
+  if ( range >= str->LabelRangeBegins.size() )
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+  const bool          lastRange = ( range + 1 == str->LabelRangeBegins.size() );
+  const LabelType     rangeEnd = lastRange ? LabelType() : str->LabelRangeBegins[range + 1];
+  const SizeValueType numberOfMaps = str->LabelObjects.size();
+
+  // the objects of the range in each map
+  typedef typename LabelObjectVectorType::const_iterator LabelObjectIterator;
+  std::vector< LabelObjectIterator > current(numberOfMaps);
+  std::vector< LabelObjectIterator > end(numberOfMaps);
+  for ( SizeValueType m = 0; m < numberOfMaps; m++ )
+    {
+    const LabelObjectVectorType & labelObjects = str->LabelObjects[m];
+    current[m] = labelObjects.begin();
+    end[m] = labelObjects.end();
+    if ( range > 0 )
+      {
+      current[m] = std::lower_bound(current[m], end[m], str->LabelRangeBegins[range], LabelLessThan);
+      }
+    if ( !lastRange )
+      {
+      end[m] = std::lower_bound(current[m], end[m], rangeEnd, LabelLessThan);
+      }
+    }
+
+  // k-way merge of the maps, in the order of the labels
+  LabelObjectVectorType & moved = str->MovedLabelObjects[range];
+  while ( true )
+    {
+    SizeValueType owner = numberOfMaps;
+    for ( SizeValueType m = 0; m < numberOfMaps; m++ )
+      {
+      if ( current[m] != end[m]
+           && ( owner == numberOfMaps || ( *current[m] )->GetLabel() < ( *current[owner] )->GetLabel() ) )
+        {
+        owner = m;
+        }
+      }
+    if ( owner == numberOfMaps )
+      {
+      break;
+      }
+
+    // the object of the lowest map gets the lines of the other maps, in the
+    // order of the maps, like a serial merge would do
+    LabelObjectType *labelObject = *current[owner];
+    const LabelType  label = labelObject->GetLabel();
+    ++current[owner];
+    for ( SizeValueType m = owner + 1; m < numberOfMaps; m++ )
+      {
+      if ( current[m] != end[m] && ( *current[m] )->GetLabel() == label )
+        {
+        for ( typename LabelObjectType::ConstLineIterator lit( *current[m] ); !lit.IsAtEnd(); ++lit )
+          {
+          labelObject->AddLine( lit.GetLine() );
+          }
+        ++current[m];
+        }
+      }
+    if ( owner > 0 )
+      {
+      moved.push_back(labelObject);
+      }
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 template< typename TInputImage, typename TOutputImage >
 void
 LabelImageToLabelMapFilter< TInputImage, TOutputImage >
@@ -21,6 +21,7 @@
 #include "itkImageBase.h"
 #include "itkWeakPointer.h"
 #include <map>
+#include <vector>
 
 namespace itk
 {
@@ -52,6 +53,9 @@ namespace itk
  *   }
  * \endcode
  *
+ * With many small label objects, the lines of the objects and the search of
+ * the labels can use a contiguous storage: see SetContiguousStorage().
+ *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
  * This implementation was taken from the Insight Journal paper:
@@ -274,6 +278,20 @@ public:
     this->PrintLabelObjects(std::cerr);
   }
 
+  /**
+   * Set/Get whether Optimize() stores the label map contiguously: the lines
+   * of all the label objects are copied, in the order of their labels, in a
+   * single LabelObject::LineArena shared by the objects, and the labels are
+   * stored in a sorted array, used by GetLabelObject(), HasLabel() and
+   * GetNthLabelObject(). GetNthLabelObject() then runs in constant time.
+   * A label object gets back its own copy of its lines when they are
+   * modified, and the sorted array is discarded when a label object is added
+   * or removed, until the next call to Optimize(). Off by default.
+   */
+  itkSetMacro(ContiguousStorage, bool);
+  itkGetConstMacro(ContiguousStorage, bool);
+  itkBooleanMacro(ContiguousStorage);
+
   /**
    * Optimize the line representation of all the lable objects referenced in the LabelMap
    */
@@ -461,8 +479,22 @@ private:
   typedef typename LabelObjectContainerType::const_iterator
                                                         LabelObjectContainerConstIterator;
 
+  /** the sorted array of labels of a contiguous storage */
+  typedef std::pair< LabelType, LabelObjectType * > LabelIndexValueType;
+  typedef std::vector< LabelIndexValueType >        LabelIndexType;
+
   LabelObjectContainerType m_LabelObjectContainer;
   LabelType                m_BackgroundValue;
+  bool                     m_ContiguousStorage;
+  LabelIndexType           m_LabelIndex;
+
+  /** Return the label object with the given label, or a null pointer */
+  LabelObjectType * FindLabelObject(const LabelType & label) const;
+
+  static bool LabelIndexLess(const LabelIndexValueType & value, const LabelType & label)
+  {
+    return value.first < label;
+  }
 
   void AddPixel( const LabelObjectContainerIterator& it,
                  const IndexType& idx,
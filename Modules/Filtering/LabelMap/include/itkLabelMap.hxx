@@ -41,6 +41,7 @@ LabelMap< TLabelObject >
 ::LabelMap()
 {
   m_BackgroundValue = NumericTraits< LabelType >::ZeroValue();
+  m_ContiguousStorage = false;
   this->Initialize();
 }
 
@@ -55,6 +56,7 @@ LabelMap< TLabelObject >
   os << indent << "BackgroundValue: "
      << static_cast< typename NumericTraits< LabelType >::PrintType >( m_BackgroundValue ) << std::endl;
   os << indent << "LabelObjectContainer: " << &m_LabelObjectContainer << std::endl;
+  os << indent << "ContiguousStorage: " << m_ContiguousStorage << std::endl;
 }
 
 
@@ -94,8 +96,10 @@ LabelMap< TLabelObject >
     m_LabelObjectContainer.clear();
     LabelObjectContainerType newLabelObjectContainer( imgData->m_LabelObjectContainer );
     std::swap( m_LabelObjectContainer, newLabelObjectContainer );
+    m_LabelIndex = imgData->m_LabelIndex;
     }
   m_BackgroundValue = imgData->m_BackgroundValue;
+  m_ContiguousStorage = imgData->m_ContiguousStorage;
 }
 
 template< typename TLabelObject >
@@ -133,15 +137,15 @@ LabelMap< TLabelObject >
                       << static_cast< typename NumericTraits< LabelType >::PrintType >( label )
                       << " is the background label.");
     }
-  LabelObjectContainerIterator it = m_LabelObjectContainer.find( label );
-  if ( it == m_LabelObjectContainer.end() )
+  LabelObjectType *labelObject = this->FindLabelObject( label );
+  if ( labelObject == ITK_NULLPTR )
     {
     itkExceptionMacro(<< "No label object with label "
                       << static_cast< typename NumericTraits< LabelType >::PrintType >( label )
                       << ".");
     }
 
-  return it->second;
+  return labelObject;
 }
 
 
@@ -156,15 +160,15 @@ LabelMap< TLabelObject >
                       << static_cast< typename NumericTraits< LabelType >::PrintType >( label )
                       << " is the background label.");
     }
-  LabelObjectContainerConstIterator it = m_LabelObjectContainer.find( label );
-  if ( it == m_LabelObjectContainer.end() )
+  LabelObjectType *labelObject = this->FindLabelObject( label );
+  if ( labelObject == ITK_NULLPTR )
     {
     itkExceptionMacro(<< "No label object with label "
                       << static_cast< typename NumericTraits< LabelType >::PrintType >( label )
                       << ".");
     }
 
-  return it->second;
+  return labelObject;
 }
 
 
@@ -173,7 +177,32 @@ bool
 LabelMap< TLabelObject >
 ::HasLabel(const LabelType label) const
 {
-  return m_LabelObjectContainer.find(label) != m_LabelObjectContainer.end();
+  return this->FindLabelObject(label) != ITK_NULLPTR;
+}
+
+
+template< typename TLabelObject >
+typename LabelMap< TLabelObject >::LabelObjectType *
+LabelMap< TLabelObject >
+::FindLabelObject(const LabelType & label) const
+{
+  if ( !m_LabelIndex.empty() )
+    {
+    typename LabelIndexType::const_iterator it =
+      std::lower_bound(m_LabelIndex.begin(), m_LabelIndex.end(), label, LabelIndexLess);
+    if ( it != m_LabelIndex.end() && it->first == label )
+      {
+      return it->second;
+      }
+    return ITK_NULLPTR;
+    }
+
+  LabelObjectContainerConstIterator it = m_LabelObjectContainer.find(label);
+  if ( it != m_LabelObjectContainer.end() )
+    {
+    return it->second.GetPointer();
+    }
+  return ITK_NULLPTR;
 }
 
 
@@ -202,6 +231,11 @@ typename LabelMap< TLabelObject >::LabelObjectType *
 LabelMap< TLabelObject >
 ::GetNthLabelObject(const SizeValueType & pos)
 {
+  if ( pos < m_LabelIndex.size() )
+    {
+    return m_LabelIndex[pos].second;
+    }
+
   SizeValueType i = 0;
 
   for ( LabelObjectContainerIterator it = m_LabelObjectContainer.begin();
@@ -227,6 +261,11 @@ const typename LabelMap< TLabelObject >::LabelObjectType *
 LabelMap< TLabelObject >
 ::GetNthLabelObject(const SizeValueType & pos) const
 {
+  if ( pos < m_LabelIndex.size() )
+    {
+    return m_LabelIndex[pos].second;
+    }
+
   SizeValueType i = 0;
 
   for ( LabelObjectContainerConstIterator it = m_LabelObjectContainer.begin();
@@ -431,6 +470,7 @@ LabelMap< TLabelObject >
   itkAssertOrThrowMacro( ( labelObject != ITK_NULLPTR ), "Input LabelObject can't be Null" );
 
   m_LabelObjectContainer[labelObject->GetLabel()] = labelObject;
+  m_LabelIndex.clear();
   this->Modified();
 }
 
@@ -524,6 +564,7 @@ LabelMap< TLabelObject >
                       << " is the background label.");
     }
   m_LabelObjectContainer.erase(label);
+  m_LabelIndex.clear();
   this->Modified();
 }
 
@@ -533,6 +574,7 @@ void
 LabelMap< TLabelObject >
 ::ClearLabels()
 {
+  m_LabelIndex.clear();
   if ( !m_LabelObjectContainer.empty() )
     {
     m_LabelObjectContainer.clear();
@@ -614,6 +656,40 @@ LabelMap< TLabelObject >
     assert( ( it->second.IsNotNull() ) );
     it->second->Optimize();
     }
+
+  m_LabelIndex.clear();
+  if ( m_ContiguousStorage )
+    {
+    // copy the lines of all the objects in a single arena, in the order of
+    // the labels. The arena is reserved first, so the objects can use their
+    // lines as soon as they are copied.
+    typedef typename LabelObjectType::LineArena LineArenaType;
+    typename LineArenaType::Pointer arena = LineArenaType::New();
+
+    SizeValueType numberOfLines = 0;
+    for ( LabelObjectContainerConstIterator it = m_LabelObjectContainer.begin();
+          it != m_LabelObjectContainer.end();
+          it++ )
+      {
+      numberOfLines += it->second->GetNumberOfLines();
+      }
+    arena->GetLines().reserve(numberOfLines);
+    m_LabelIndex.reserve( m_LabelObjectContainer.size() );
+
+    for ( LabelObjectContainerConstIterator it = m_LabelObjectContainer.begin();
+          it != m_LabelObjectContainer.end();
+          it++ )
+      {
+      LabelObjectType *labelObject = it->second;
+      const SizeValueType begin = arena->GetLines().size();
+      for ( typename LabelObjectType::ConstLineIterator lit( labelObject ); !lit.IsAtEnd(); ++lit )
+        {
+        arena->GetLines().push_back( lit.GetLine() );
+        }
+      labelObject->SetSharedLines( arena, begin, labelObject->GetNumberOfLines() );
+      m_LabelIndex.push_back( LabelIndexValueType( it->first, labelObject ) );
+      }
+    }
   this->Modified();
 }
 
@@ -30,6 +30,8 @@
 
 #include "itkImageToImageFilter.h"
 #include "itkFastMutexLock.h"
+#include "itkAtomicInt.h"
+#include <vector>
 
 namespace itk
 {
@@ -42,6 +44,12 @@ namespace itk
  * With that class, the developer doesn't need to take care of iterating over all the objects in
  * the image, or to manage by hand the threads.
  *
+ * The label objects are collected before the threads start, and each thread
+ * takes the next object to process with an atomic counter, so the threads
+ * never wait for each other to get an object. The subclasses which add or
+ * remove label objects in ThreadedProcessLabelObject() must protect the
+ * label map with m_LabelObjectContainerLock.
+ *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
  * This implementation was taken from the Insight Journal paper:
@@ -123,9 +131,9 @@ protected:
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(LabelMapFilter);
 
-  typename InputImageType::Iterator m_LabelObjectIterator;
-  float                             m_InverseNumberOfLabelObjects;
-  SizeValueType                     m_NumberOfLabelObjectsProcessed;
+  std::vector< LabelObjectType * > m_LabelObjects;
+  AtomicInt< SizeValueType >       m_NextLabelObject;
+  float                            m_InverseNumberOfLabelObjects;
 };
 } // end namespace itk
 
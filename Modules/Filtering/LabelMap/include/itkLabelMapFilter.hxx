@@ -28,15 +28,14 @@
 #ifndef itkLabelMapFilter_hxx
 #define itkLabelMapFilter_hxx
 #include "itkLabelMapFilter.h"
-#include "itkMutexLockHolder.h"
 
 namespace itk
 {
 template< typename TInputImage, typename TOutputImage >
 LabelMapFilter< TInputImage, TOutputImage >
 ::LabelMapFilter():
-  m_InverseNumberOfLabelObjects( 1.0f ),
-  m_NumberOfLabelObjectsProcessed( 1 )
+  m_NextLabelObject( 0 ),
+  m_InverseNumberOfLabelObjects( 1.0f )
 {
 }
 
@@ -76,9 +75,15 @@ void
 LabelMapFilter< TInputImage, TOutputImage >
 ::BeforeThreadedGenerateData()
 {
-  // initialize the iterator
-  m_LabelObjectIterator =  typename InputImageType::Iterator(this->GetLabelMap());
-//  m_LabelObjectIterator = typename InputImageType::Iterator(this->GetLabelMap());
+  // collect the objects to be processed by the threads
+  InputImageType *labelMap = this->GetLabelMap();
+  m_LabelObjects.clear();
+  m_LabelObjects.reserve( labelMap->GetNumberOfLabelObjects() );
+  for ( typename InputImageType::Iterator it( labelMap ); !it.IsAtEnd(); ++it )
+    {
+    m_LabelObjects.push_back( it.GetLabelObject() );
+    }
+  m_NextLabelObject = 0;
 
   // and the mutex
   m_LabelObjectContainerLock = FastMutexLock::New();
@@ -92,7 +97,6 @@ LabelMapFilter< TInputImage, TOutputImage >
     m_InverseNumberOfLabelObjects = 1.0f/this->GetLabelMap()->GetNumberOfLabelObjects();
     }
 
-  m_NumberOfLabelObjectsProcessed = 0;
 }
 
 template< typename TInputImage, typename TOutputImage >
@@ -100,6 +104,7 @@ void
 LabelMapFilter< TInputImage, TOutputImage >
 ::AfterThreadedGenerateData()
 {
+  m_LabelObjects.clear();
   this->UpdateProgress(1.0);
 }
 
@@ -110,36 +115,22 @@ LabelMapFilter< TInputImage, TOutputImage >
 {
   while ( true )
     {
-    LabelObjectType *labelObject;
-    // begin mutex lock
-    {
-    MutexLockHolder< FastMutexLock > lock(*m_LabelObjectContainerLock );
-
-    if ( m_LabelObjectIterator.IsAtEnd() )
+    // get the next object. The objects are collected before the threads
+    // start, so an object may be destroyed by the thread processing it
+    // without affecting the other threads.
+    const SizeValueType labelObjectIndex = m_NextLabelObject++;
+    if ( labelObjectIndex >= m_LabelObjects.size() )
       {
-      // mutex lock holder deleted
       return;
       }
-
-    // get the label object
-    labelObject = m_LabelObjectIterator.GetLabelObject();
-
-    // increment the iterator now, so it will not be invalidated if the object
-    // is destroyed
-    ++m_LabelObjectIterator;
-    ++m_NumberOfLabelObjectsProcessed;
-
-    // unlock the mutex, so the other threads can get an object
-    }
-    // end mutex lock
-
+    LabelObjectType *labelObject = m_LabelObjects[labelObjectIndex];
 
     // and run the user defined method for that object
     this->ThreadedProcessLabelObject(labelObject);
 
     if (threadId==0)
       {
-      const float progress = m_InverseNumberOfLabelObjects*m_NumberOfLabelObjectsProcessed;
+      const float progress = m_InverseNumberOfLabelObjects * ( labelObjectIndex + 1 );
       this->UpdateProgress(progress);
       }
 
@@ -18,7 +18,7 @@
 #ifndef itkLabelObject_h
 #define itkLabelObject_h
 
-#include <deque>
+#include <vector>
 #include "itkLightObject.h"
 #include "itkLabelObjectLine.h"
 #include "itkWeakPointer.h"
@@ -33,7 +33,12 @@ namespace itk
  * It should be used associated with the LabelMap.
  *
  * LabelObject store mainly 2 things: the label of the object, and a set of lines
- * which are part of the object.
+ * which are part of the object. The lines are stored contiguously, so the
+ * line and index iterators walk through a single block of memory, and an
+ * object which is not empty only uses the memory of its lines once it has
+ * been optimized. The lines may also be shared with other label objects, in
+ * a LineArena filled by a LabelMap with a contiguous storage: the object gets
+ * back its own copy of its lines as soon as they are modified.
  * No attribute is available in that class, so this class can be used as a base class
  * to implement a label object with attribute, or when no attribute is needed (see the
  * reconstruction filters for an example. If a simple attribute is needed,
@@ -179,6 +184,59 @@ public:
   /** Shift the object position */
   void Shift( OffsetType offset );
 
+  /** \class LineArena
+   * \brief A block of lines shared by several label objects.
+   *
+   * LabelMap fills a LineArena with the lines of all its label objects in
+   * Optimize(), when its storage is contiguous.
+   *
+   * \sa LabelMap::SetContiguousStorage()
+   * \ingroup ITKLabelMap
+   */
+  class LineArena:public LightObject
+  {
+  public:
+    typedef LineArena                  Self;
+    typedef LightObject                Superclass;
+    typedef SmartPointer< Self >       Pointer;
+    typedef SmartPointer< const Self > ConstPointer;
+    typedef std::vector< LineType >    LineContainerType;
+
+    itkNewMacro(Self);
+
+    itkTypeMacro(LineArena, LightObject);
+
+    LineContainerType & GetLines()
+    {
+      return m_Lines;
+    }
+
+    const LineContainerType & GetLines() const
+    {
+      return m_Lines;
+    }
+
+  protected:
+    LineArena() {}
+
+  private:
+    ITK_DISALLOW_COPY_AND_ASSIGN(LineArena);
+
+    LineContainerType m_Lines;
+  };
+
+  /**
+   * Use the lines of the arena from the position begin, instead of the
+   * lines of the object. The lines must be optimized, and the arena must not
+   * be modified while the object uses it.
+   */
+  void SetSharedLines(LineArena *arena, SizeValueType begin, SizeValueType numberOfLines);
+
+  /**
+   * Return true if the lines of the object are the lines of a LineArena.
+   */
+  bool HasSharedLines() const;
+
   /** \class ConstLineIterator
    * \brief A forward iterator over the lines of a LabelObject
    * \ingroup ITKLabelMap
@@ -187,12 +245,16 @@ public:
   {
   public:
 
-    ConstLineIterator() {}
+    ConstLineIterator():
+      m_Iterator(ITK_NULLPTR),
+      m_Begin(ITK_NULLPTR),
+      m_End(ITK_NULLPTR)
+    {}
 
     ConstLineIterator(const Self *lo)
     {
-      m_Begin = lo->m_LineContainer.begin();
-      m_End = lo->m_LineContainer.end();
+      m_Begin = lo->LinesBegin();
+      m_End = lo->LinesEnd();
       m_Iterator = m_Begin;
     }
 
@@ -250,8 +312,7 @@ public:
     }
 
   private:
-    typedef typename std::deque< LineType >            LineContainerType;
-    typedef typename LineContainerType::const_iterator InternalIteratorType;
+    typedef const LineType * InternalIteratorType;
     InternalIteratorType m_Iterator;
     InternalIteratorType m_Begin;
     InternalIteratorType m_End;
@@ -266,17 +327,17 @@ public:
   public:
 
     ConstIndexIterator():
-      m_Iterator(),
-      m_Begin(),
-      m_End()
+      m_Iterator(ITK_NULLPTR),
+      m_Begin(ITK_NULLPTR),
+      m_End(ITK_NULLPTR)
         {
         m_Index.Fill(0);
         }
 
     ConstIndexIterator(const Self *lo)
     {
-      m_Begin = lo->m_LineContainer.begin();
-      m_End = lo->m_LineContainer.end();
+      m_Begin = lo->LinesBegin();
+      m_End = lo->LinesEnd();
       GoToBegin();
     }
 
@@ -345,8 +406,7 @@ public:
 
   private:
 
-    typedef typename std::deque< LineType >            LineContainerType;
-    typedef typename LineContainerType::const_iterator InternalIteratorType;
+    typedef const LineType * InternalIteratorType;
     void NextValidLine()
     {
       // search for the next valid position
@@ -373,10 +433,32 @@ protected:
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(LabelObject);
 
-  typedef typename std::deque< LineType >    LineContainerType;
+  typedef typename std::vector< LineType >    LineContainerType;
+
+  /** The lines of the object, either in the line container or in the
+   * shared lines */
+  const LineType * LinesBegin() const
+  {
+    if ( m_SharedLines.IsNotNull() )
+      {
+      return m_SharedLinesBegin;
+      }
+    return m_LineContainer.empty() ? ITK_NULLPTR : &m_LineContainer[0];
+  }
+
+  const LineType * LinesEnd() const
+  {
+    return this->LinesBegin() + this->GetNumberOfLines();
+  }
+
+  /** Copy the shared lines in the line container, before modifying them */
+  void UnshareLines();
 
-  LineContainerType m_LineContainer;
-  LabelType         m_Label;
+  LineContainerType             m_LineContainer;
+  typename LineArena::Pointer   m_SharedLines;
+  const LineType *              m_SharedLinesBegin;
+  SizeValueType                 m_NumberOfSharedLines;
+  LabelType                     m_Label;
 };
 } // end namespace itk
 
@@ -30,6 +30,8 @@ LabelObject< TLabel, VImageDimension >::LabelObject()
 {
   m_Label = NumericTraits< LabelType >::ZeroValue();
   m_LineContainer.clear();
+  m_SharedLinesBegin = ITK_NULLPTR;
+  m_NumberOfSharedLines = 0;
 }
 
 template< typename TLabel, unsigned int VImageDimension >
@@ -86,10 +88,9 @@ bool
 LabelObject< TLabel, VImageDimension >
 ::HasIndex(const IndexType & idx) const
 {
-  typedef typename LineContainerType::const_iterator LineContainerConstIteratorType;
-  LineContainerConstIteratorType end = m_LineContainer.end();
+  const LineType *end = this->LinesEnd();
 
-  for ( LineContainerConstIteratorType it = m_LineContainer.begin();
+  for ( const LineType *it = this->LinesBegin();
         it != end;
         ++it )
     {
@@ -107,6 +108,8 @@ bool
 LabelObject< TLabel, VImageDimension >
 ::RemoveIndex(const IndexType & idx)
 {
+  this->UnshareLines();
+
   typename LineContainerType::iterator it = m_LineContainer.begin();
 
   while( it != m_LineContainer.end() )
@@ -162,6 +165,7 @@ void
 LabelObject< TLabel, VImageDimension >
 ::AddIndex(const IndexType & idx)
 {
+  this->UnshareLines();
   if ( !m_LineContainer.empty() )
     {
     // can we use the last line to add that index ?
@@ -197,6 +201,7 @@ void
 LabelObject< TLabel, VImageDimension >
 ::AddLine(const LineType & line)
 {
+  this->UnshareLines();
   m_LineContainer.push_back(line);
 }
 
@@ -205,6 +210,10 @@ typename LabelObject< TLabel, VImageDimension >::SizeValueType
 LabelObject< TLabel, VImageDimension >
 ::GetNumberOfLines() const
 {
+  if ( m_SharedLines.IsNotNull() )
+    {
+    return m_NumberOfSharedLines;
+    }
   return static_cast<typename LabelObject< TLabel, VImageDimension >::SizeValueType>( m_LineContainer.size());
 }
 
@@ -214,7 +223,7 @@ typename LabelObject< TLabel, VImageDimension >::LineType &
 LabelObject< TLabel, VImageDimension >
 ::GetLine(SizeValueType i) const
 {
-  return m_LineContainer[i];
+  return this->LinesBegin()[i];
 }
 
 template< typename TLabel, unsigned int VImageDimension >
@@ -222,6 +231,7 @@ typename LabelObject< TLabel, VImageDimension >::LineType &
 LabelObject< TLabel, VImageDimension >
 ::GetLine(SizeValueType i)
 {
+  this->UnshareLines();
   return m_LineContainer[i];
 }
 
@@ -232,8 +242,9 @@ LabelObject< TLabel, VImageDimension >
 {
   int size = 0;
 
-  for ( typename LineContainerType::const_iterator it = m_LineContainer.begin();
-        it != m_LineContainer.end();
+  const LineType *end = this->LinesEnd();
+  for ( const LineType *it = this->LinesBegin();
+        it != end;
         it++ )
     {
     size += it->GetLength();
@@ -246,7 +257,7 @@ bool
 LabelObject< TLabel, VImageDimension >
 ::Empty() const
 {
-  return this->m_LineContainer.empty();
+  return this->GetNumberOfLines() == 0;
 }
 
 template< typename TLabel, unsigned int VImageDimension >
@@ -256,9 +267,10 @@ LabelObject< TLabel, VImageDimension >
 {
   SizeValueType o = offset;
 
-  typename LineContainerType::const_iterator it = this->m_LineContainer.begin();
+  const LineType *it = this->LinesBegin();
+  const LineType *end = this->LinesEnd();
 
-  while ( it != m_LineContainer.end() )
+  while ( it != end )
     {
     SizeValueType size = it->GetLength();
 
@@ -287,7 +299,8 @@ LabelObject< TLabel, VImageDimension >
 {
   itkAssertOrThrowMacro ( ( src != ITK_NULLPTR ), "Null Pointer" );
   // clear original lines and copy lines
-  m_LineContainer.clear();
+  this->Clear();
+  m_LineContainer.reserve( src->GetNumberOfLines() );
   for( size_t i = 0; i < src->GetNumberOfLines(); ++i )
     {
     this->AddLine( src->GetLine( static_cast< SizeValueType >( i ) ) );
@@ -328,28 +341,21 @@ void
 LabelObject< TLabel, VImageDimension >
 ::Optimize()
 {
-  if ( !m_LineContainer.empty() )
+  // the shared lines are already optimized
+  if ( m_SharedLines.IsNull() && !m_LineContainer.empty() )
     {
-    // first copy the lines in another container and clear the current one
-    LineContainerType lineContainer = m_LineContainer;
-    m_LineContainer.clear();
-
     // reorder the lines
     typename Functor::LabelObjectLineComparator< LineType > comparator;
-    std::sort(lineContainer.begin(), lineContainer.end(), comparator);
-
-    // then check the lines consistancy
-    // we'll proceed line index by line index
-    IndexType currentIdx = lineContainer.begin()->GetIndex();
-    LengthType  currentLength = lineContainer.begin()->GetLength();
+    std::sort(m_LineContainer.begin(), m_LineContainer.end(), comparator);
 
-    typename LineContainerType::const_iterator it = lineContainer.begin();
-
-    while ( it != lineContainer.end() )
+    // then merge the lines in place, line index by line index: out is the
+    // line being extended, the lines after it are either merged in it or
+    // become the next line
+    typename LineContainerType::iterator out = m_LineContainer.begin();
+    for ( typename LineContainerType::iterator it = out + 1; it != m_LineContainer.end(); ++it )
       {
-      const LineType & line = *it;
-      IndexType        idx = line.GetIndex();
-      LengthType    length = line.GetLength();
+      const IndexType & currentIdx = out->GetIndex();
+      const IndexType & idx = it->GetIndex();
 
       // check the index to be sure that we are still in the same line idx
       bool sameIdx = true;
@@ -361,27 +367,26 @@ LabelObject< TLabel, VImageDimension >
           }
         }
 
-      // try to extend the current line idx, or create a new line
-      if ( sameIdx && currentIdx[0] + (OffsetValueType)currentLength >= idx[0] )
+      // try to extend the current line idx, or start a new line
+      if ( sameIdx && currentIdx[0] + (OffsetValueType)out->GetLength() >= idx[0] )
         {
         // we may expand the line
-        LengthType newLength = idx[0] + (OffsetValueType)length - currentIdx[0];
-        currentLength = std::max(newLength, currentLength);
+        LengthType newLength = idx[0] + (OffsetValueType)it->GetLength() - currentIdx[0];
+        out->SetLength( std::max(newLength, out->GetLength()) );
         }
       else
         {
-        // add the previous line to the new line container and use the new line
-        // index and size
-        this->AddLine(currentIdx, currentLength);
-        currentIdx = idx;
-        currentLength = length;
+        ++out;
+        *out = *it;
         }
-
-      it++;
       }
+    m_LineContainer.erase(out + 1, m_LineContainer.end());
 
-    // complete the last line
-    this->AddLine(currentIdx, currentLength);
+    // release the memory of the lines merged or removed
+    if ( m_LineContainer.capacity() > m_LineContainer.size() )
+      {
+      LineContainerType( m_LineContainer ).swap(m_LineContainer);
+      }
     }
 }
 
@@ -390,6 +395,7 @@ void
 LabelObject< TLabel, VImageDimension >
 ::Shift( OffsetType offset )
 {
+  this->UnshareLines();
   for( typename LineContainerType::iterator it = m_LineContainer.begin();
        it != m_LineContainer.end();
        it++ )
@@ -404,15 +410,61 @@ void
 LabelObject< TLabel, VImageDimension >
 ::Clear()
 {
+  m_SharedLines = ITK_NULLPTR;
+  m_SharedLinesBegin = ITK_NULLPTR;
+  m_NumberOfSharedLines = 0;
   m_LineContainer.clear();
 }
 
+template< typename TLabel, unsigned int VImageDimension >
+void
+LabelObject< TLabel, VImageDimension >
+::SetSharedLines(LineArena *arena, SizeValueType begin, SizeValueType numberOfLines)
+{
+  itkAssertOrThrowMacro( ( arena != ITK_NULLPTR ), "Null Pointer" );
+  itkAssertOrThrowMacro( ( begin + numberOfLines <= arena->GetLines().size() ),
+                         "The lines are outside of the arena" );
+
+  LineContainerType().swap(m_LineContainer);
+  if ( numberOfLines == 0 )
+    {
+    this->Clear();
+    return;
+    }
+  m_SharedLines = arena;
+  m_SharedLinesBegin = &arena->GetLines()[begin];
+  m_NumberOfSharedLines = numberOfLines;
+}
+
+template< typename TLabel, unsigned int VImageDimension >
+bool
+LabelObject< TLabel, VImageDimension >
+::HasSharedLines() const
+{
+  return m_SharedLines.IsNotNull();
+}
+
+template< typename TLabel, unsigned int VImageDimension >
+void
+LabelObject< TLabel, VImageDimension >
+::UnshareLines()
+{
+  if ( m_SharedLines.IsNotNull() )
+    {
+    m_LineContainer.assign( m_SharedLinesBegin, m_SharedLinesBegin + m_NumberOfSharedLines );
+    m_SharedLines = ITK_NULLPTR;
+    m_SharedLinesBegin = ITK_NULLPTR;
+    m_NumberOfSharedLines = 0;
+    }
+}
+
 template< typename TLabel, unsigned int VImageDimension >
 void
 LabelObject< TLabel, VImageDimension >::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "LineContainer: " << &m_LineContainer << std::endl;
+  os << indent << "SharedLines: " << m_SharedLines.GetPointer() << std::endl;
   os << indent << "Label: " << static_cast< typename NumericTraits< LabelType >::PrintType >( m_Label ) << std::endl;
 }
 } // end namespace itk
@@ -29,7 +29,7 @@
 #include "vnl/algo/vnl_real_eigensystem.h"
 #include "vnl/algo/vnl_symmetric_eigensystem.h"
 #include "itkMath.h"
-#include <deque>
+#include <vector>
 #include <map>
 
 namespace itk
@@ -389,7 +389,7 @@ ShapeLabelMapFilter< TImage, TLabelImage >
 {
   const LabelPixelType & label = labelObject->GetLabel();
 
-  typedef typename std::deque< IndexType > IndexListType;
+  typedef typename std::vector< IndexType > IndexListType;
   IndexListType idxList;
 
   typedef typename itk::ConstNeighborhoodIterator< LabelImageType > NeighborIteratorType;
@@ -462,7 +462,7 @@ ShapeLabelMapFilter< TImage, TLabelImage >
 ::ComputePerimeter(LabelObjectType *labelObject)
 {
   // store the lines in a N-1D image of vectors
-  typedef std::deque< typename LabelObjectType::LineType > VectorLineType;
+  typedef std::vector< typename LabelObjectType::LineType > VectorLineType;
   typedef itk::Image< VectorLineType, ImageDimension - 1 > LineImageType;
   typename LineImageType::Pointer lineImage = LineImageType::New();
   typename LineImageType::IndexType lIdx;
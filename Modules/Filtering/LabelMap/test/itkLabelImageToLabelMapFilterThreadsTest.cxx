@@ -0,0 +1,109 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <iostream>
+#include "itkLabelImageToLabelMapFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+// The label map must not depend on the number of threads, even when the
+// labels are spread over the parts of the image of all the threads.
+int itkLabelImageToLabelMapFilterThreadsTest(int, char *[])
+{
+  const unsigned int Dimension = 3;
+
+  typedef itk::Image< unsigned short, Dimension >                     ImageType;
+  typedef itk::LabelObject< unsigned short, Dimension >               LabelObjectType;
+  typedef itk::LabelMap< LabelObjectType >                            LabelMapType;
+  typedef itk::LabelImageToLabelMapFilter< ImageType, LabelMapType > FilterType;
+
+  ImageType::SizeType size;
+  size[0] = 37;
+  size[1] = 29;
+  size[2] = 23;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+
+  // The lines are merged in the order of the threads, so the objects must be
+  // exactly the same as the ones of a single thread.
+
+  // Many labels, some of them in a single slice, some in all the slices,
+  // with background between them
+  for ( itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType idx = it.GetIndex();
+    if ( ( idx[0] + idx[1] + idx[2] ) % 7 == 0 )
+      {
+      it.Set(0);
+      }
+    else if ( idx[0] < 5 )
+      {
+      it.Set( static_cast< unsigned short >( 1 + idx[1] ) );
+      }
+    else
+      {
+      it.Set( static_cast< unsigned short >( 100 + ( idx[0] / 3 ) * 1000 + idx[2] * 31 + idx[1] % 3 ) );
+      }
+    }
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetBackgroundValue(0);
+
+  filter->SetNumberOfThreads(1);
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  LabelMapType::Pointer reference = filter->GetOutput();
+  reference->DisconnectPipeline();
+
+  const itk::ThreadIdType numberOfThreads[4] = { 2, 3, 7, 16 };
+  for ( unsigned int t = 0; t < 4; ++t )
+    {
+    filter->SetNumberOfThreads(numberOfThreads[t]);
+    TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+    LabelMapType *output = filter->GetOutput();
+
+    TEST_EXPECT_EQUAL( output->GetNumberOfLabelObjects(), reference->GetNumberOfLabelObjects() );
+    for ( LabelMapType::ConstIterator it( reference ); !it.IsAtEnd(); ++it )
+      {
+      const LabelObjectType *expected = it.GetLabelObject();
+      TEST_EXPECT_TRUE( output->HasLabel( expected->GetLabel() ) );
+      const LabelObjectType *labelObject = output->GetLabelObject( expected->GetLabel() );
+      if ( labelObject->GetNumberOfLines() != expected->GetNumberOfLines() )
+        {
+        std::cerr << "Test failed: the object " << expected->GetLabel() << " has "
+                  << labelObject->GetNumberOfLines() << " lines with " << numberOfThreads[t]
+                  << " threads instead of " << expected->GetNumberOfLines() << std::endl;
+        return EXIT_FAILURE;
+        }
+      for ( itk::SizeValueType i = 0; i < expected->GetNumberOfLines(); ++i )
+        {
+        if ( labelObject->GetLine(i).GetIndex() != expected->GetLine(i).GetIndex()
+             || labelObject->GetLine(i).GetLength() != expected->GetLine(i).GetLength() )
+          {
+          std::cerr << "Test failed: the line " << i << " of the object " << expected->GetLabel()
+                    << " is different with " << numberOfThreads[t] << " threads." << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,195 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkLabelImageToLabelMapFilter.h"
+#include "itkLabelMapToLabelImageFilter.h"
+#include "itkShapeLabelMapFilter.h"
+#include "itkShapeLabelObject.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingComparisonImageFilter.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+template< typename TLabelObject >
+bool
+SameLines( const TLabelObject *labelObject, const TLabelObject *expected )
+{
+  if ( labelObject->GetNumberOfLines() != expected->GetNumberOfLines() )
+    {
+    return false;
+    }
+  for ( itk::SizeValueType i = 0; i < expected->GetNumberOfLines(); ++i )
+    {
+    if ( labelObject->GetLine(i).GetIndex() != expected->GetLine(i).GetIndex()
+         || labelObject->GetLine(i).GetLength() != expected->GetLine(i).GetLength() )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+// The label objects of a label map with a contiguous storage share a single
+// block of lines, and the filters must give the same results as with the
+// lines stored in each object.
+int itkLabelMapContiguousStorageTest(int, char *[])
+{
+  const unsigned int Dimension = 2;
+
+  typedef itk::Image< unsigned short, Dimension >                    ImageType;
+  typedef itk::ShapeLabelObject< unsigned short, Dimension >         LabelObjectType;
+  typedef itk::LabelMap< LabelObjectType >                           LabelMapType;
+  typedef itk::LabelImageToLabelMapFilter< ImageType, LabelMapType > ToLabelMapType;
+  typedef itk::ShapeLabelMapFilter< LabelMapType >                   ShapeType;
+  typedef itk::LabelMapToLabelImageFilter< LabelMapType, ImageType > ToLabelImageType;
+
+  ImageType::SizeType size;
+  size[0] = 61;
+  size[1] = 47;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+
+  // blocks of 5x4 pixels with a random label, so most objects are made of
+  // several blocks, with some background between them
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(5);
+  std::vector< unsigned short > blockLabels( ( size[0] / 5 + 1 ) * ( size[1] / 4 + 1 ) );
+  for ( unsigned int i = 0; i < blockLabels.size(); ++i )
+    {
+    blockLabels[i] = static_cast< unsigned short >( generator->GetIntegerVariate(40) );
+    }
+  for ( itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType idx = it.GetIndex();
+    it.Set( blockLabels[( idx[1] / 4 ) * ( size[0] / 5 + 1 ) + idx[0] / 5] );
+    }
+
+  ToLabelMapType::Pointer referenceConverter = ToLabelMapType::New();
+  referenceConverter->SetInput(image);
+  TRY_EXPECT_NO_EXCEPTION( referenceConverter->Update() );
+  LabelMapType::Pointer reference = referenceConverter->GetOutput();
+  reference->DisconnectPipeline();
+
+  ToLabelMapType::Pointer converter = ToLabelMapType::New();
+  converter->SetInput(image);
+  TRY_EXPECT_NO_EXCEPTION( converter->Update() );
+  LabelMapType::Pointer labelMap = converter->GetOutput();
+  labelMap->DisconnectPipeline();
+
+  TEST_SET_GET_BOOLEAN( labelMap, ContiguousStorage, true );
+  labelMap->Optimize();
+
+  // the lines of the objects follow each other, in the order of the labels
+  TEST_EXPECT_EQUAL( labelMap->GetNumberOfLabelObjects(), reference->GetNumberOfLabelObjects() );
+  const LabelObjectType *previous = ITK_NULLPTR;
+  itk::SizeValueType     position = 0;
+  for ( LabelMapType::ConstIterator it( labelMap ); !it.IsAtEnd(); ++it, ++position )
+    {
+    const LabelObjectType *labelObject = it.GetLabelObject();
+    TEST_EXPECT_TRUE( labelObject->HasSharedLines() );
+    TEST_EXPECT_TRUE( SameLines( labelObject, reference->GetLabelObject( it.GetLabel() ) ) );
+    TEST_EXPECT_TRUE( labelMap->GetNthLabelObject(position) == labelObject );
+    if ( previous != ITK_NULLPTR )
+      {
+      TEST_EXPECT_TRUE( &labelObject->GetLine(0) == &previous->GetLine( previous->GetNumberOfLines() - 1 ) + 1 );
+      }
+    previous = labelObject;
+    }
+  for ( unsigned short label = 0; label < 45; ++label )
+    {
+    TEST_EXPECT_EQUAL( labelMap->HasLabel(label), reference->HasLabel(label) );
+    if ( label != labelMap->GetBackgroundValue() && labelMap->HasLabel(label) )
+      {
+      TEST_EXPECT_EQUAL( labelMap->GetLabelObject(label)->GetLabel(), label );
+      }
+    }
+  TRY_EXPECT_EXCEPTION( labelMap->GetLabelObject(44) );
+  TRY_EXPECT_EXCEPTION( labelMap->GetNthLabelObject( labelMap->GetNumberOfLabelObjects() ) );
+
+  // the filters use the shared lines
+  ShapeType::Pointer referenceShape = ShapeType::New();
+  referenceShape->SetInput(reference);
+  referenceShape->ComputePerimeterOn();
+  referenceShape->ComputeFeretDiameterOn();
+  TRY_EXPECT_NO_EXCEPTION( referenceShape->Update() );
+
+  ShapeType::Pointer shape = ShapeType::New();
+  shape->SetInput(labelMap);
+  shape->ComputePerimeterOn();
+  shape->ComputeFeretDiameterOn();
+  TRY_EXPECT_NO_EXCEPTION( shape->Update() );
+  TEST_EXPECT_TRUE( shape->GetOutput()->GetContiguousStorage() );
+
+  for ( LabelMapType::ConstIterator it( referenceShape->GetOutput() ); !it.IsAtEnd(); ++it )
+    {
+    const LabelObjectType *expected = it.GetLabelObject();
+    const LabelObjectType *labelObject = shape->GetOutput()->GetLabelObject( it.GetLabel() );
+    TEST_EXPECT_TRUE( labelObject->HasSharedLines() );
+    TEST_EXPECT_EQUAL( labelObject->GetNumberOfPixels(), expected->GetNumberOfPixels() );
+    TEST_EXPECT_TRUE( itk::Math::FloatAlmostEqual( labelObject->GetPerimeter(), expected->GetPerimeter() ) );
+    TEST_EXPECT_TRUE( itk::Math::FloatAlmostEqual( labelObject->GetFeretDiameter(), expected->GetFeretDiameter() ) );
+    TEST_EXPECT_EQUAL( labelObject->GetCentroid(), expected->GetCentroid() );
+    }
+
+  ToLabelImageType::Pointer toLabelImage = ToLabelImageType::New();
+  toLabelImage->SetInput( shape->GetOutput() );
+  TRY_EXPECT_NO_EXCEPTION( toLabelImage->Update() );
+
+  typedef itk::Testing::ComparisonImageFilter< ImageType, ImageType > ComparisonType;
+  ComparisonType::Pointer comparison = ComparisonType::New();
+  comparison->SetValidInput(image);
+  comparison->SetTestInput( toLabelImage->GetOutput() );
+  TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+  TEST_EXPECT_EQUAL( comparison->GetNumberOfPixelsWithDifferences(), 0 );
+
+  // a modified object gets its own lines, and the other objects keep the
+  // shared ones
+  const LabelMapType::LabelVectorType labels = labelMap->GetLabels();
+  LabelObjectType *modified = labelMap->GetLabelObject( labels[labels.size() / 2] );
+  LabelObjectType *next = labelMap->GetLabelObject( labels[labels.size() / 2 + 1] );
+  const itk::SizeValueType numberOfLines = modified->GetNumberOfLines();
+  ImageType::IndexType outside;
+  outside[0] = -10;
+  outside[1] = -10;
+  modified->AddIndex(outside);
+  TEST_EXPECT_TRUE( !modified->HasSharedLines() );
+  TEST_EXPECT_EQUAL( modified->GetNumberOfLines(), numberOfLines + 1 );
+  TEST_EXPECT_TRUE( next->HasSharedLines() );
+  TEST_EXPECT_TRUE( SameLines( next, reference->GetLabelObject( next->GetLabel() ) ) );
+  TEST_EXPECT_TRUE( modified->RemoveIndex(outside) );
+  TEST_EXPECT_TRUE( SameLines( modified, reference->GetLabelObject( modified->GetLabel() ) ) );
+
+  // the sorted labels are discarded when an object is removed
+  labelMap->RemoveLabel( labels[0] );
+  TEST_EXPECT_TRUE( !labelMap->HasLabel( labels[0] ) );
+  TEST_EXPECT_TRUE( labelMap->GetNthLabelObject(0) == labelMap->GetLabelObject( labels[1] ) );
+  TEST_EXPECT_TRUE( labelMap->GetLabelObject( labels[1] )->HasSharedLines() );
+
+  labelMap->Optimize();
+  TEST_EXPECT_TRUE( modified->HasSharedLines() );
+  TEST_EXPECT_TRUE( SameLines( modified, reference->GetLabelObject( modified->GetLabel() ) ) );
+  TEST_EXPECT_TRUE( labelMap->GetNthLabelObject(0) == labelMap->GetLabelObject( labels[1] ) );
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
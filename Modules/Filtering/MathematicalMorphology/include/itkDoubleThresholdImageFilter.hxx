@@ -102,6 +102,7 @@ DoubleThresholdImageFilter< TInputImage, TOutputImage >
   dilate->SetMarkerImage( narrowThreshold->GetOutput() );
   dilate->SetMaskImage( wideThreshold->GetOutput() );
   dilate->SetFullyConnected(m_FullyConnected);
+  dilate->SetNumberOfThreads( this->GetNumberOfThreads() );
   //dilate->RunOneIterationOff();   // run to convergence
 
   progress->RegisterInternalFilter(narrowThreshold, .1f);
@@ -130,6 +130,7 @@ GrayscaleConnectedClosingImageFilter< TInputImage, TOutputImage >
   erode->SetMarkerImage(markerPtr);
   erode->SetMaskImage( inputImage );
   erode->SetFullyConnected(m_FullyConnected);
+  erode->SetNumberOfThreads( this->GetNumberOfThreads() );
 
   // graft our output to the erode filter to force the proper regions
   // to be generated
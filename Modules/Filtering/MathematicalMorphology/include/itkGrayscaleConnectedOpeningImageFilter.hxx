@@ -129,6 +129,7 @@ GrayscaleConnectedOpeningImageFilter< TInputImage, TOutputImage >
   dilate->SetMarkerImage(markerPtr);
   dilate->SetMaskImage( inputImage );
   dilate->SetFullyConnected(m_FullyConnected);
+  dilate->SetNumberOfThreads( this->GetNumberOfThreads() );
 
   // graft our output to the dilate filter to force the proper regions
   // to be generated
@@ -22,6 +22,7 @@
 #include "itkShapedNeighborhoodIterator.h"
 #include "itkImageRegionIterator.h"
 #include "itkProgressReporter.h"
+#include "itkMultiThreader.h"
 #include <queue>
 
 //#define BASIC
@@ -43,6 +44,15 @@ namespace itk
  * applications and efficient algorithms" -- IEEE Transactions on
  * Image processing, Vol 2, No 2, pp 176-201, April 1993
  *
+ * When several threads are used, the image is split in slabs along its
+ * last dimension, and each thread runs the raster, antiraster and FIFO
+ * steps in its own slab. The values on the faces of the slabs are then
+ * exchanged, and propagated again in each slab from the modified pixels,
+ * until no value changes. The reconstruction is the unique stable state
+ * of the propagation, so the output is identical to the one computed
+ * with a single thread. The multithreaded version always works on padded
+ * copies of the images, whatever the value of UseInternalCopy.
+ *
  * \author Richard Beare. Department of Medicine, Monash University,
  * Melbourne, Australia.
  *
@@ -174,6 +184,60 @@ private:
   typedef typename InputImageType::IndexType                InIndexType;
   typedef ConstShapedNeighborhoodIterator< InputImageType > CNInputIterator;
   typedef ShapedNeighborhoodIterator< OutputImageType >     NOutputIterator;
+
+  /** Part of the padded images processed by a thread. The faces of the
+   * slab are saved in two alternating buffers, so that the neighbor
+   * slabs can read them while the slab is updated. */
+  struct Slab
+  {
+    MarkerImageRegionType              Region;
+    OffsetValueType                    Begin;
+    OffsetValueType                    End;
+    std::vector< OffsetValueType >     Rows;
+    std::queue< OffsetValueType >      Fifo;
+    std::vector< InputImagePixelType > LowerFace[2];
+    std::vector< InputImagePixelType > UpperFace[2];
+    bool                               Changed;
+    bool                               InvalidMarker;
+  };
+
+  struct SlabThreadStruct
+  {
+    Self        *Filter;
+    unsigned int Iteration;
+  };
+
+  /** Multithreaded reconstruction, on slabs of the image. */
+  void GenerateDataBySlabs(ThreadIdType numberOfSlabs);
+
+  static ITK_THREAD_RETURN_TYPE InitializeSlabsThreaderCallback(void *arg);
+  static ITK_THREAD_RETURN_TYPE ExchangeSlabsThreaderCallback(void *arg);
+  static ITK_THREAD_RETURN_TYPE CopySlabsThreaderCallback(void *arg);
+
+  /** Copy the images in a slab, and run the raster, antiraster and FIFO
+   * steps in it. */
+  void ThreadedInitializeSlab(ThreadIdType slabId);
+
+  /** Update the faces of a slab from the saved faces of its neighbors,
+   * and propagate the changes in the slab. */
+  void ThreadedExchangeSlab(ThreadIdType slabId, unsigned int iteration);
+
+  /** Process the FIFO of a slab, then save its faces. */
+  void ThreadedPropagateInSlab(ThreadIdType slabId, unsigned int faceBuffer);
+
+  /** Copy a slab of the result to the output. */
+  void ThreadedCopySlabToOutput(ThreadIdType slabId);
+
+  std::vector< Slab >                m_Slabs;
+  typename InputImageType::Pointer   m_PaddedMarker;
+  typename InputImageType::Pointer   m_PaddedMask;
+  OffsetValueType                    m_PaddedStrides[MarkerImageDimension];
+  OffsetValueType                    m_SliceSize;
+  std::vector< OffsetValueType >     m_PreviousOffsets;
+  std::vector< OffsetValueType >     m_LaterOffsets;
+  std::vector< OffsetValueType >     m_NeighborOffsets;
+  std::vector< OffsetValueType >     m_LowerFaceOffsets;
+  std::vector< OffsetValueType >     m_UpperFaceOffsets;
 }; // end of class
 } // end namespace itk
 
@@ -25,6 +25,7 @@
 
 #include "itkConstantPadImageFilter.h"
 #include "itkCropImageFilter.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -107,6 +108,25 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
 {
   // Allocate the output
   this->AllocateOutputs();
+
+  // mask and marker must have the same size
+  if ( this->GetMarkerImage()->GetRequestedRegion().GetSize() != this->GetMaskImage()->GetRequestedRegion().GetSize() )
+    {
+    itkExceptionMacro(<< "Marker and mask must have the same size.");
+    }
+
+  // split the image in slabs along the last dimension when several
+  // threads are available
+  const SizeValueType numberOfSlices =
+    this->GetOutput()->GetRequestedRegion().GetSize(OutputImageDimension - 1);
+  const ThreadIdType numberOfSlabs = static_cast< ThreadIdType >(
+    std::min( static_cast< SizeValueType >( this->GetNumberOfThreads() ), numberOfSlices ) );
+  if ( numberOfSlabs > 1 && this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() > 0 )
+    {
+    this->GenerateDataBySlabs(numberOfSlabs);
+    return;
+    }
+
   // there are 2 passes that use all pixels and a 3rd that uses some
   // subset of the pixels. We'll just pretend that the third pass
   // takes the same as each of the others. Is it OK to update more
@@ -119,12 +139,6 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
   MaskImageConstPointer   maskImage = this->GetMaskImage();
   OutputImagePointer      output = this->GetOutput();
 
-  // mask and marker must have the same size
-  if ( this->GetMarkerImage()->GetRequestedRegion().GetSize() != this->GetMaskImage()->GetRequestedRegion().GetSize() )
-    {
-    itkExceptionMacro(<< "Marker and mask must have the same size.");
-    }
-
   // create padded versions of the marker image and the mask image
   typedef typename itk::ConstantPadImageFilter< InputImageType, InputImageType > PadType;
 
@@ -388,6 +402,460 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
     }
 }
 
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+void
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::GenerateDataBySlabs(ThreadIdType numberOfSlabs)
+{
+  const OutputImageRegionType region = this->GetOutput()->GetRequestedRegion();
+  const ISizeType             size = region.GetSize();
+  const unsigned int          lastDimension = OutputImageDimension - 1;
+
+  // strides of the images padded by one pixel on each side
+  ISizeType paddedSize;
+  m_PaddedStrides[0] = 1;
+  for ( unsigned int i = 0; i < OutputImageDimension; ++i )
+    {
+    paddedSize[i] = size[i] + 2;
+    if ( i > 0 )
+      {
+      m_PaddedStrides[i] = m_PaddedStrides[i - 1] * paddedSize[i - 1];
+      }
+    }
+  m_SliceSize = m_PaddedStrides[lastDimension];
+
+  typename InputImageType::RegionType paddedRegion;
+  paddedRegion.SetSize(paddedSize);
+  typename InputImageType::Pointer paddedMarker = InputImageType::New();
+  paddedMarker->SetRegions(paddedRegion);
+  paddedMarker->Allocate();
+  typename InputImageType::Pointer paddedMask = InputImageType::New();
+  paddedMask->SetRegions(paddedRegion);
+  paddedMask->Allocate();
+  m_PaddedMarker = paddedMarker;
+  m_PaddedMask = paddedMask;
+
+  // neighbor offsets in the padded images
+  m_PreviousOffsets.clear();
+  m_LaterOffsets.clear();
+  m_NeighborOffsets.clear();
+  m_LowerFaceOffsets.clear();
+  m_UpperFaceOffsets.clear();
+  OffsetValueType numberOfOffsets = 1;
+  for ( unsigned int i = 0; i < OutputImageDimension; ++i )
+    {
+    numberOfOffsets *= 3;
+    }
+  for ( OffsetValueType n = 0; n < numberOfOffsets; ++n )
+    {
+    OffsetValueType offset = 0;
+    unsigned int    numberOfNonZero = 0;
+    OffsetValueType code = n;
+    int             lastComponent = 0;
+    for ( unsigned int i = 0; i < OutputImageDimension; ++i )
+      {
+      const int component = static_cast< int >( code % 3 ) - 1;
+      code /= 3;
+      offset += component * m_PaddedStrides[i];
+      if ( component != 0 )
+        {
+        ++numberOfNonZero;
+        }
+      lastComponent = component;
+      }
+    if ( numberOfNonZero == 0 || ( !m_FullyConnected && numberOfNonZero > 1 ) )
+      {
+      continue;
+      }
+    m_NeighborOffsets.push_back(offset);
+    if ( offset < 0 )
+      {
+      m_PreviousOffsets.push_back(offset);
+      }
+    else
+      {
+      m_LaterOffsets.push_back(offset);
+      }
+    // offsets of the neighbors in the faces of the adjacent slabs,
+    // relative to the face
+    if ( lastComponent < 0 )
+      {
+      m_LowerFaceOffsets.push_back(offset + m_SliceSize);
+      }
+    else if ( lastComponent > 0 )
+      {
+      m_UpperFaceOffsets.push_back(offset - m_SliceSize);
+      }
+    }
+
+  // the slabs
+  m_Slabs.clear();
+  m_Slabs.resize(numberOfSlabs);
+  for ( ThreadIdType t = 0; t < numberOfSlabs; ++t )
+    {
+    Slab &              slab = m_Slabs[t];
+    const SizeValueType first = size[lastDimension] * t / numberOfSlabs;
+    const SizeValueType last = size[lastDimension] * ( t + 1 ) / numberOfSlabs;
+
+    slab.Region = region;
+    slab.Region.SetIndex( lastDimension, region.GetIndex(lastDimension) + first );
+    slab.Region.SetSize( lastDimension, last - first );
+    slab.Begin = ( first + 1 ) * m_SliceSize;
+    slab.End = ( last + 1 ) * m_SliceSize;
+    slab.Changed = false;
+    slab.InvalidMarker = false;
+
+    // start of the rows of the slab, in raster order
+    const SizeValueType numberOfRows = slab.Region.GetNumberOfPixels() / slab.Region.GetSize(0);
+    slab.Rows.resize(numberOfRows);
+    ISizeType counter;
+    counter.Fill(0);
+    for ( SizeValueType r = 0; r < numberOfRows; ++r )
+      {
+      OffsetValueType offset = ( slab.Region.GetIndex(0) - region.GetIndex(0) + 1 ) * m_PaddedStrides[0];
+      for ( unsigned int i = 1; i < OutputImageDimension; ++i )
+        {
+        offset += ( slab.Region.GetIndex(i) - region.GetIndex(i) + counter[i] + 1 ) * m_PaddedStrides[i];
+        }
+      slab.Rows[r] = offset;
+      for ( unsigned int i = 1; i < OutputImageDimension; ++i )
+        {
+        if ( ++counter[i] < slab.Region.GetSize(i) )
+          {
+          break;
+          }
+        counter[i] = 0;
+        }
+      }
+    for ( unsigned int b = 0; b < 2; ++b )
+      {
+      slab.LowerFace[b].resize(m_SliceSize);
+      slab.UpperFace[b].resize(m_SliceSize);
+      }
+    }
+
+  SlabThreadStruct str;
+  str.Filter = this;
+  str.Iteration = 0;
+
+  MultiThreader *threader = this->GetMultiThreader();
+  threader->SetNumberOfThreads(numberOfSlabs);
+  threader->SetSingleMethod(this->InitializeSlabsThreaderCallback, &str);
+  threader->SingleMethodExecute();
+
+  for ( ThreadIdType t = 0; t < numberOfSlabs; ++t )
+    {
+    if ( m_Slabs[t].InvalidMarker )
+      {
+      m_Slabs.clear();
+      m_PaddedMarker = ITK_NULLPTR;
+      m_PaddedMask = ITK_NULLPTR;
+      TCompare compare;
+      if ( compare(0, 1) )
+        {
+        itkExceptionMacro(<< "Marker pixels must be <= mask pixels.");
+        }
+      else
+        {
+        itkExceptionMacro(<< "Marker pixels must be >= mask pixels.");
+        }
+      }
+    }
+
+  // exchange the faces of the slabs until they are stable
+  bool changed = true;
+  while ( changed )
+    {
+    threader->SetSingleMethod(this->ExchangeSlabsThreaderCallback, &str);
+    threader->SingleMethodExecute();
+    ++str.Iteration;
+
+    changed = false;
+    for ( ThreadIdType t = 0; t < numberOfSlabs; ++t )
+      {
+      changed = changed || m_Slabs[t].Changed;
+      }
+    }
+
+  threader->SetSingleMethod(this->CopySlabsThreaderCallback, &str);
+  threader->SingleMethodExecute();
+
+  m_Slabs.clear();
+  m_PaddedMarker = ITK_NULLPTR;
+  m_PaddedMask = ITK_NULLPTR;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+ITK_THREAD_RETURN_TYPE
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::InitializeSlabsThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  SlabThreadStruct *str = static_cast< SlabThreadStruct * >( info->UserData );
+  str->Filter->ThreadedInitializeSlab(info->ThreadID);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+ITK_THREAD_RETURN_TYPE
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::ExchangeSlabsThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  SlabThreadStruct *str = static_cast< SlabThreadStruct * >( info->UserData );
+  str->Filter->ThreadedExchangeSlab(info->ThreadID, str->Iteration);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+ITK_THREAD_RETURN_TYPE
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::CopySlabsThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  SlabThreadStruct *str = static_cast< SlabThreadStruct * >( info->UserData );
+  str->Filter->ThreadedCopySlabToOutput(info->ThreadID);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+void
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::ThreadedInitializeSlab(ThreadIdType slabId)
+{
+  Slab &                    slab = m_Slabs[slabId];
+  InputImagePixelType *     out = m_PaddedMarker->GetBufferPointer();
+  InputImagePixelType *     msk = m_PaddedMask->GetBufferPointer();
+  const OffsetValueType     rowLength = slab.Region.GetSize(0);
+  const SizeValueType       numberOfRows = slab.Rows.size();
+  TCompare                  compare;
+
+  ProgressReporter progress(this, slabId, slab.Region.GetNumberOfPixels() * 2);
+
+  // fill the slab with the border value, including the padding slices
+  // before the first slab and after the last one
+  const OffsetValueType begin = ( slabId == 0 ) ? 0 : slab.Begin;
+  const OffsetValueType end = ( slabId + 1 == m_Slabs.size() ) ? slab.End + m_SliceSize : slab.End;
+  std::fill(out + begin, out + end, m_MarkerValue);
+  std::fill(msk + begin, msk + end, m_MarkerValue);
+
+  // copy the marker and the mask
+  InputIteratorType markerIt(this->GetMarkerImage(), slab.Region);
+  InputIteratorType maskIt(this->GetMaskImage(), slab.Region);
+  for ( SizeValueType r = 0; r < numberOfRows; ++r )
+    {
+    InputImagePixelType *outRow = out + slab.Rows[r];
+    InputImagePixelType *mskRow = msk + slab.Rows[r];
+    for ( OffsetValueType x = 0; x < rowLength; ++x, ++markerIt, ++maskIt )
+      {
+      outRow[x] = markerIt.Get();
+      mskRow[x] = maskIt.Get();
+      if ( compare(outRow[x], mskRow[x]) )
+        {
+        slab.InvalidMarker = true;
+        }
+      }
+    }
+  if ( slab.InvalidMarker )
+    {
+    return;
+    }
+
+  // scan in forward raster order, ignoring the neighbors in the other
+  // slabs
+  const size_t numberOfPrevious = m_PreviousOffsets.size();
+  const size_t numberOfLater = m_LaterOffsets.size();
+  for ( SizeValueType r = 0; r < numberOfRows; ++r )
+    {
+    for ( OffsetValueType p = slab.Rows[r]; p < slab.Rows[r] + rowLength; ++p )
+      {
+      InputImagePixelType V = out[p];
+      for ( size_t k = 0; k < numberOfPrevious; ++k )
+        {
+        const OffsetValueType n = p + m_PreviousOffsets[k];
+        if ( n >= slab.Begin && compare(out[n], V) )
+          {
+          V = out[n];
+          }
+        }
+      if ( compare(V, msk[p]) )
+        {
+        V = msk[p];
+        }
+      out[p] = V;
+      progress.CompletedPixel();
+      }
+    }
+
+  // reverse raster order pass, which also fills the FIFO
+  for ( SizeValueType r = numberOfRows; r > 0; --r )
+    {
+    for ( OffsetValueType p = slab.Rows[r - 1] + rowLength - 1; p >= slab.Rows[r - 1]; --p )
+      {
+      InputImagePixelType V = out[p];
+      for ( size_t k = 0; k < numberOfLater; ++k )
+        {
+        const OffsetValueType n = p + m_LaterOffsets[k];
+        if ( n < slab.End && compare(out[n], V) )
+          {
+          V = out[n];
+          }
+        }
+      if ( compare(V, msk[p]) )
+        {
+        V = msk[p];
+        }
+      out[p] = V;
+
+      for ( size_t k = 0; k < numberOfLater; ++k )
+        {
+        const OffsetValueType n = p + m_LaterOffsets[k];
+        if ( n < slab.End && compare(V, out[n]) && compare(msk[n], out[n]) )
+          {
+          slab.Fifo.push(p);
+          break;
+          }
+        }
+      progress.CompletedPixel();
+      }
+    }
+
+  this->ThreadedPropagateInSlab(slabId, 0);
+}
+
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+void
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::ThreadedExchangeSlab(ThreadIdType slabId, unsigned int iteration)
+{
+  Slab &                     slab = m_Slabs[slabId];
+  InputImagePixelType *      out = m_PaddedMarker->GetBufferPointer();
+  const InputImagePixelType *msk = m_PaddedMask->GetBufferPointer();
+  const unsigned int         faceBuffer = iteration % 2;
+  TCompare                   compare;
+
+  slab.Changed = false;
+  for ( unsigned int side = 0; side < 2; ++side )
+    {
+    const Slab *neighbor;
+    const std::vector< OffsetValueType > *offsets;
+    OffsetValueType faceBegin;
+    const InputImagePixelType *neighborFace;
+    if ( side == 0 )
+      {
+      if ( slabId == 0 )
+        {
+        continue;
+        }
+      neighbor = &m_Slabs[slabId - 1];
+      neighborFace = &neighbor->UpperFace[faceBuffer][0];
+      offsets = &m_LowerFaceOffsets;
+      faceBegin = slab.Begin;
+      }
+    else
+      {
+      if ( slabId + 1 == m_Slabs.size() )
+        {
+        continue;
+        }
+      neighbor = &m_Slabs[slabId + 1];
+      neighborFace = &neighbor->LowerFace[faceBuffer][0];
+      offsets = &m_UpperFaceOffsets;
+      faceBegin = slab.End - m_SliceSize;
+      }
+
+    // pull the values of the neighbor slab, with the propagation rule
+    // of the FIFO step
+    for ( OffsetValueType k = 0; k < m_SliceSize; ++k )
+      {
+      const OffsetValueType p = faceBegin + k;
+      const InputImagePixelType V = out[p];
+      const InputImagePixelType iV = msk[p];
+      if ( !Math::NotAlmostEquals(iV, V) )
+        {
+        // the pixel is clamped by the mask, or is in the padding
+        continue;
+        }
+      InputImagePixelType VN = V;
+      for ( size_t j = 0; j < offsets->size(); ++j )
+        {
+        const InputImagePixelType value = neighborFace[k + ( *offsets )[j]];
+        if ( compare(value, VN) )
+          {
+          VN = value;
+          }
+        }
+      if ( compare(VN, V) )
+        {
+        out[p] = compare(iV, VN) ? VN : iV;
+        slab.Fifo.push(p);
+        slab.Changed = true;
+        }
+      }
+    }
+
+  this->ThreadedPropagateInSlab(slabId, 1 - faceBuffer);
+}
+
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+void
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::ThreadedPropagateInSlab(ThreadIdType slabId, unsigned int faceBuffer)
+{
+  Slab &                     slab = m_Slabs[slabId];
+  InputImagePixelType *      out = m_PaddedMarker->GetBufferPointer();
+  const InputImagePixelType *msk = m_PaddedMask->GetBufferPointer();
+  const size_t               numberOfNeighbors = m_NeighborOffsets.size();
+  TCompare                   compare;
+
+  while ( !slab.Fifo.empty() )
+    {
+    const OffsetValueType p = slab.Fifo.front();
+    slab.Fifo.pop();
+    const InputImagePixelType V = out[p];
+    for ( size_t k = 0; k < numberOfNeighbors; ++k )
+      {
+      const OffsetValueType n = p + m_NeighborOffsets[k];
+      if ( n < slab.Begin || n >= slab.End )
+        {
+        continue;
+        }
+      const InputImagePixelType VN = out[n];
+      const InputImagePixelType iN = msk[n];
+      // candidate for dilation via flooding
+      if ( compare(V, VN) && Math::NotAlmostEquals(iN, VN) )
+        {
+        out[n] = compare(iN, V) ? V : iN;
+        slab.Fifo.push(n);
+        }
+      }
+    }
+
+  // save the faces for the neighbor slabs
+  std::copy( out + slab.Begin, out + slab.Begin + m_SliceSize, slab.LowerFace[faceBuffer].begin() );
+  std::copy( out + slab.End - m_SliceSize, out + slab.End, slab.UpperFace[faceBuffer].begin() );
+}
+
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+void
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::ThreadedCopySlabToOutput(ThreadIdType slabId)
+{
+  const Slab &               slab = m_Slabs[slabId];
+  const InputImagePixelType *out = m_PaddedMarker->GetBufferPointer();
+  const OffsetValueType      rowLength = slab.Region.GetSize(0);
+
+  OutputIteratorType outIt(this->GetOutput(), slab.Region);
+  for ( SizeValueType r = 0; r < slab.Rows.size(); ++r )
+    {
+    const InputImagePixelType *row = out + slab.Rows[r];
+    for ( OffsetValueType x = 0; x < rowLength; ++x, ++outIt )
+      {
+      outIt.Set( static_cast< OutputImagePixelType >( row[x] ) );
+      }
+    }
+}
+
 template< typename TInputImage, typename TOutputImage, typename TCompare >
 void
 ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
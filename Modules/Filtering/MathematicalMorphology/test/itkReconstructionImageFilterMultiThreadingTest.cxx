@@ -0,0 +1,198 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Compare the multithreaded reconstruction with the single threaded one.
+// The outputs must be identical.
+
+#include "itkReconstructionByDilationImageFilter.h"
+#include "itkReconstructionByErosionImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingComparisonImageFilter.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+template< typename TFilter >
+int
+ReconstructionImageFilterMultiThreadingTestCompare(typename TFilter::InputImageType *marker,
+                                                   typename TFilter::InputImageType *mask,
+                                                   bool fullyConnected,
+                                                   bool useInternalCopy,
+                                                   itk::ThreadIdType numberOfThreads,
+                                                   const char *name)
+{
+  typedef typename TFilter::OutputImageType OutputImageType;
+
+  typename OutputImageType::Pointer outputs[2];
+  const itk::ThreadIdType           threads[2] = { 1, numberOfThreads };
+  for ( unsigned int t = 0; t < 2; ++t )
+    {
+    typename TFilter::Pointer filter = TFilter::New();
+    filter->SetMarkerImage(marker);
+    filter->SetMaskImage(mask);
+    filter->SetFullyConnected(fullyConnected);
+    filter->SetUseInternalCopy(useInternalCopy);
+    filter->SetNumberOfThreads(threads[t]);
+    TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+    outputs[t] = filter->GetOutput();
+    outputs[t]->DisconnectPipeline();
+    }
+
+  typedef itk::Testing::ComparisonImageFilter< OutputImageType, OutputImageType > ComparisonType;
+  typename ComparisonType::Pointer comparison = ComparisonType::New();
+  comparison->SetValidInput(outputs[0]);
+  comparison->SetTestInput(outputs[1]);
+  TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+  if ( comparison->GetNumberOfPixelsWithDifferences() > 0 )
+    {
+    std::cerr << "Test failed: " << name << ", size " << mask->GetLargestPossibleRegion().GetSize()
+              << ", FullyConnected " << fullyConnected << ", UseInternalCopy " << useInternalCopy
+              << ": " << comparison->GetNumberOfPixelsWithDifferences()
+              << " pixels differ with " << numberOfThreads << " threads." << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+
+template< unsigned int VDimension >
+int
+ReconstructionImageFilterMultiThreadingTestRun(const itk::Size< VDimension > & size,
+                                               itk::ThreadIdType numberOfThreads)
+{
+  typedef itk::Image< short, VDimension >                                      ImageType;
+  typedef itk::ReconstructionByDilationImageFilter< ImageType, ImageType >     DilationType;
+  typedef itk::ReconstructionByErosionImageFilter< ImageType, ImageType >      ErosionType;
+  typedef itk::ImageRegionIteratorWithIndex< ImageType >                       IteratorType;
+
+  // A smooth random landscape with many regional extrema, and markers
+  // lowered for the dilation and raised for the erosion by a constant,
+  // as in the h-maxima and h-minima transforms.
+  typename ImageType::Pointer mask = ImageType::New();
+  mask->SetRegions(size);
+  mask->Allocate();
+  typename ImageType::Pointer dilationMarker = ImageType::New();
+  dilationMarker->SetRegions(size);
+  dilationMarker->Allocate();
+  typename ImageType::Pointer erosionMarker = ImageType::New();
+  erosionMarker->SetRegions(size);
+  erosionMarker->Allocate();
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 7 );
+
+  IteratorType maskIt( mask, mask->GetLargestPossibleRegion() );
+  IteratorType dilationIt( dilationMarker, dilationMarker->GetLargestPossibleRegion() );
+  IteratorType erosionIt( erosionMarker, erosionMarker->GetLargestPossibleRegion() );
+  for (; !maskIt.IsAtEnd(); ++maskIt, ++dilationIt, ++erosionIt )
+    {
+    double value = 0.0;
+    for ( unsigned int i = 0; i < VDimension; ++i )
+      {
+      value += 40.0 * std::sin( 0.21 * ( i + 1 ) * maskIt.GetIndex()[i] + i );
+      }
+    value += generator->GetIntegerVariate( 29 );
+    const short maskValue = static_cast< short >( value );
+    maskIt.Set(maskValue);
+    dilationIt.Set(maskValue - 20);
+    erosionIt.Set(maskValue + 20);
+    }
+
+  // A serpentine corridor crossing the image along the last dimension
+  // many times, filled from one end: the values must cross the slabs of
+  // the threads back and forth. The lanes are connected alternately at
+  // the top and at the bottom.
+  typename ImageType::Pointer maze = ImageType::New();
+  maze->SetRegions(size);
+  maze->Allocate();
+  maze->FillBuffer(0);
+  typename ImageType::Pointer mazeMarker = ImageType::New();
+  mazeMarker->SetRegions(size);
+  mazeMarker->Allocate();
+  mazeMarker->FillBuffer(0);
+
+  const unsigned int last = VDimension - 1;
+  for ( IteratorType it( maze, maze->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    const typename ImageType::IndexType & index = it.GetIndex();
+    const itk::IndexValueType lane = index[0] / 2;
+    bool inMaze = ( index[0] % 2 == 0 );
+    if ( !inMaze )
+      {
+      const itk::IndexValueType end = ( lane % 2 == 0 ) ? static_cast< itk::IndexValueType >( size[last] ) - 1 : 0;
+      inMaze = ( index[last] == end );
+      }
+    if ( inMaze )
+      {
+      it.Set( static_cast< short >( 100 + lane % 7 ) );
+      }
+    }
+  typename ImageType::IndexType start;
+  start.Fill(0);
+  mazeMarker->SetPixel( start, maze->GetPixel(start) );
+
+  int status = EXIT_SUCCESS;
+  for ( unsigned int fullyConnected = 0; fullyConnected < 2; ++fullyConnected )
+    {
+    status |= ReconstructionImageFilterMultiThreadingTestCompare< DilationType >(
+      dilationMarker, mask, fullyConnected, true, numberOfThreads, "Dilation");
+    status |= ReconstructionImageFilterMultiThreadingTestCompare< DilationType >(
+      dilationMarker, mask, fullyConnected, false, numberOfThreads, "Dilation");
+    status |= ReconstructionImageFilterMultiThreadingTestCompare< ErosionType >(
+      erosionMarker, mask, fullyConnected, true, numberOfThreads, "Erosion");
+    status |= ReconstructionImageFilterMultiThreadingTestCompare< DilationType >(
+      mazeMarker, maze, fullyConnected, true, numberOfThreads, "Maze");
+    }
+
+  // the precondition on the marker is checked by all threads
+  typename DilationType::Pointer dilation = DilationType::New();
+  dilation->SetMarkerImage(erosionMarker);
+  dilation->SetMaskImage(mask);
+  dilation->SetNumberOfThreads(numberOfThreads);
+  TRY_EXPECT_EXCEPTION( dilation->Update() );
+
+  return status;
+}
+}
+
+int itkReconstructionImageFilterMultiThreadingTest(int, char *[])
+{
+  int status = EXIT_SUCCESS;
+
+  itk::Size< 2 > size2;
+  size2[0] = 61;
+  size2[1] = 47;
+  status |= ReconstructionImageFilterMultiThreadingTestRun< 2 >(size2, 2);
+  status |= ReconstructionImageFilterMultiThreadingTestRun< 2 >(size2, 5);
+
+  itk::Size< 3 > size3;
+  size3[0] = 31;
+  size3[1] = 23;
+  size3[2] = 19;
+  status |= ReconstructionImageFilterMultiThreadingTestRun< 3 >(size3, 3);
+  // more threads than slices
+  size3[2] = 3;
+  status |= ReconstructionImageFilterMultiThreadingTestRun< 3 >(size3, 8);
+
+  if ( status == EXIT_SUCCESS )
+    {
+    std::cout << "Test passed." << std::endl;
+    }
+  return status;
+}
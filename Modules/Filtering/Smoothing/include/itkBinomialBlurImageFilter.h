@@ -32,6 +32,17 @@ namespace itk
  * image dimension. The net result after n-iterations approaches
  * convultion with a gaussian.
  *
+ * When UseFusedSeparableConvolution is on, the repetitions are replaced by
+ * a single convolution with the equivalent binomial kernel of radius
+ * Repetitions, computed for all the dimensions at once by a
+ * FusedSeparableConvolutionImageFilter. This is much faster for many
+ * repetitions. The image is then extended with a zero flux Neumann
+ * boundary condition, so the pixels within Repetitions of the image
+ * boundary differ from the repeated averaging, whose boundary handling is
+ * not symmetric.
+ *
+ * \sa FusedSeparableConvolutionImageFilter
+ *
  * \ingroup ImageEnhancement
  * \ingroup ITKSmoothing
  *
@@ -83,6 +94,12 @@ public:
   itkSetMacro(Repetitions, unsigned int);
   itkGetConstMacro(Repetitions, unsigned int);
 
+  /** Set/Get whether the repetitions are computed as a single fused
+   * separable convolution. Defaults to false. */
+  itkSetMacro(UseFusedSeparableConvolution, bool);
+  itkGetConstMacro(UseFusedSeparableConvolution, bool);
+  itkBooleanMacro(UseFusedSeparableConvolution);
+
   /** This filter needs to request a larger input than its requested output.
    * If this filter runs "Repetitions" iterations, then it needs an input
    * that is 2*Repetitions larger than the output. In other words, this
@@ -114,6 +131,9 @@ private:
 
   /** How many times should we apply the blur? */
   unsigned int m_Repetitions;
+
+  /** Compute the blur with a FusedSeparableConvolutionImageFilter? */
+  bool m_UseFusedSeparableConvolution;
 };
 } // end namespace itk
 
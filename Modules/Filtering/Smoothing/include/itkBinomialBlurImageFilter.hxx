@@ -20,6 +20,8 @@
 
 #include "vnl/vnl_vector_fixed.h"
 #include "itkProgressReporter.h"
+#include "itkProgressAccumulator.h"
+#include "itkFusedSeparableConvolutionImageFilter.h"
 #include "itkImageRegion.h"
 #include "itkImageRegionConstIterator.h"
 #include "itkImageRegionReverseIterator.h"
@@ -35,6 +37,8 @@ BinomialBlurImageFilter< TInputImage, TOutputImage >
 
   // The default is to just do one repetition
   m_Repetitions = 1;
+
+  m_UseFusedSeparableConvolution = false;
 }
 
 template< typename TInputImage, typename TOutputImage >
@@ -62,6 +66,16 @@ BinomialBlurImageFilter< TInputImage, TOutputImage >
 
   outputRegion = outputPtr->GetRequestedRegion();
 
+  if ( m_UseFusedSeparableConvolution )
+    {
+    // The binomial kernel has a radius of m_Repetitions in all directions
+    inputRegion = outputRegion;
+    inputRegion.PadByRadius(m_Repetitions);
+    inputRegion.Crop( inputPtr->GetLargestPossibleRegion() );
+    inputPtr->SetRequestedRegion(inputRegion);
+    return;
+    }
+
   // This filter needs a m_Repetitions pixel border about the output
   // (clamped of course at the true boundaries of the input image)
   inputRegion = outputRegion;
@@ -106,6 +120,46 @@ BinomialBlurImageFilter< TInputImage, TOutputImage >
   InputImageConstPointer inputPtr  = this->GetInput(0);
   OutputImagePointer     outputPtr = this->GetOutput(0);
 
+  if ( m_UseFusedSeparableConvolution )
+    {
+    // m_Repetitions averagings with the neighbors on each side are a
+    // convolution with the binomial kernel of size 2 * m_Repetitions + 1
+    typedef FusedSeparableConvolutionImageFilter< InputImageType, OutputImageType, double > FusedFilterType;
+    typename FusedFilterType::KernelType kernel(1, 1.0);
+    for ( unsigned int rep = 0; rep < m_Repetitions; rep++ )
+      {
+      typename FusedFilterType::KernelType next(kernel.size() + 2, 0.0);
+      for ( unsigned int k = 0; k < kernel.size(); k++ )
+        {
+        next[k] += 0.25 * kernel[k];
+        next[k + 1] += 0.5 * kernel[k];
+        next[k + 2] += 0.25 * kernel[k];
+        }
+      kernel.swap(next);
+      }
+
+    typename FusedFilterType::Pointer fusedFilter = FusedFilterType::New();
+    for ( unsigned int dim = 0; dim < NDimensions; dim++ )
+      {
+      fusedFilter->SetKernel(dim, kernel);
+      }
+
+    // Create an internal image to protect the input image's metadata
+    InputImagePointer localInput = InputImageType::New();
+    localInput->Graft(inputPtr);
+    fusedFilter->SetInput(localInput);
+    fusedFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
+
+    ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
+    progress->SetMiniPipelineFilter(this);
+    progress->RegisterInternalFilter(fusedFilter, 1.0f);
+
+    fusedFilter->GraftOutput(outputPtr);
+    fusedFilter->Update();
+    this->GraftOutput( fusedFilter->GetOutput() );
+    return;
+    }
+
   // Allocate the output
   outputPtr->SetBufferedRegion( outputPtr->GetRequestedRegion() );
   outputPtr->Allocate();
@@ -279,6 +333,7 @@ BinomialBlurImageFilter< TInputImage, TOutputImage >
   Superclass::PrintSelf(os, indent);
 
   os << indent << "Number of repetitions: " << m_Repetitions << std::endl;
+  os << indent << "UseFusedSeparableConvolution: " << m_UseFusedSeparableConvolution << std::endl;
 }
 } // end namespace
 
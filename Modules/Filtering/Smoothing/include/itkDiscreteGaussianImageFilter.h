@@ -43,11 +43,20 @@ namespace itk
  * When the Gaussian kernel is small, this filter tends to run faster than
  * itk::RecursiveGaussianImageFilter.
  *
+ * By default the image is convolved by a streamed chain of
+ * NeighborhoodOperatorImageFilter, one per direction. When
+ * UseFusedSeparableConvolution is on, a FusedSeparableConvolutionImageFilter
+ * filters all the directions tile by tile instead, without intermediate
+ * images, which is faster and uses less memory. The intermediate results
+ * are then not rounded to the output pixel type, so the output may differ
+ * slightly for integer pixel types.
+ *
  * \sa GaussianOperator
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
  * \sa RecursiveGaussianImageFilter
+ * \sa FusedSeparableConvolutionImageFilter
  *
  * \ingroup ImageEnhancement
  * \ingroup ImageFeatureExtraction
@@ -212,6 +221,14 @@ public:
   itkSetMacro(InternalNumberOfStreamDivisions, unsigned int);
   itkGetConstReferenceMacro(InternalNumberOfStreamDivisions, unsigned int);
 
+  /** Set/Get whether all the directions are filtered in a single pass by
+   * a FusedSeparableConvolutionImageFilter, instead of a chain of
+   * NeighborhoodOperatorImageFilter. InternalNumberOfStreamDivisions is
+   * not used in that case. Defaults to false. */
+  itkSetMacro(UseFusedSeparableConvolution, bool);
+  itkGetConstMacro(UseFusedSeparableConvolution, bool);
+  itkBooleanMacro(UseFusedSeparableConvolution);
+
   /** DiscreteGaussianImageFilter needs a larger input requested region
    * than the output requested region (larger by the size of the
    * Gaussian kernel).  As such, DiscreteGaussianImageFilter needs to
@@ -238,6 +255,7 @@ protected:
     m_UseImageSpacing = true;
     m_FilterDimensionality = ImageDimension;
     m_InternalNumberOfStreamDivisions = ImageDimension * ImageDimension;
+    m_UseFusedSeparableConvolution = false;
   }
 
   virtual ~DiscreteGaussianImageFilter() {}
@@ -275,6 +293,9 @@ private:
   /** Number of pieces to divide the input on the internal composite
   pipeline. The upstream pipeline will not be effected. */
   unsigned int m_InternalNumberOfStreamDivisions;
+
+  /** Flag to indicate whether to filter all the directions in one pass */
+  bool m_UseFusedSeparableConvolution;
 };
 } // end namespace itk
 
@@ -20,6 +20,7 @@
 
 #include "itkDiscreteGaussianImageFilter.h"
 #include "itkNeighborhoodOperatorImageFilter.h"
+#include "itkFusedSeparableConvolutionImageFilter.h"
 #include "itkGaussianOperator.h"
 #include "itkImageRegionIterator.h"
 #include "itkProgressAccumulator.h"
@@ -228,6 +229,27 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
     oper[reverse_i].CreateDirectional();
     }
 
+  if ( m_UseFusedSeparableConvolution )
+    {
+    // Filter all the directions at once, without intermediate images
+    typedef FusedSeparableConvolutionImageFilter< InputImageType,
+                                                  OutputImageType, RealOutputPixelValueType > FusedFilterType;
+
+    typename FusedFilterType::Pointer fusedFilter = FusedFilterType::New();
+    for ( i = 0; i < filterDimensionality; ++i )
+      {
+      fusedFilter->SetOperator(oper[i]);
+      }
+    fusedFilter->SetInput(localInput);
+    fusedFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
+    progress->RegisterInternalFilter(fusedFilter, 1.0f);
+
+    fusedFilter->GraftOutput(output);
+    fusedFilter->Update();
+    this->GraftOutput( fusedFilter->GetOutput() );
+    return;
+    }
+
   // Create a chain of filters
   //
   //
@@ -340,6 +362,7 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
   os << indent << "FilterDimensionality: " << m_FilterDimensionality << std::endl;
   os << indent << "UseImageSpacing: " << m_UseImageSpacing << std::endl;
   os << indent << "InternalNumberOfStreamDivisions: " << m_InternalNumberOfStreamDivisions << std::endl;
+  os << indent << "UseFusedSeparableConvolution: " << m_UseFusedSeparableConvolution << std::endl;
 }
 } // end namespace itk
 
@@ -0,0 +1,106 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBinomialBlurImageFilter.h"
+#include "itkRandomImageSource.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+// The fused separable convolution must give the result of the repeated
+// averagings, except within Repetitions pixels of the image boundary where
+// the two use different boundary conditions.
+int itkBinomialBlurImageFilterTest(int, char* [] )
+{
+  const unsigned int Dimension = 3;
+
+  typedef itk::Image< float, Dimension >                           ImageType;
+  typedef itk::BinomialBlurImageFilter< ImageType, ImageType >     FilterType;
+  typedef itk::RandomImageSource< ImageType >                      SourceType;
+
+  SourceType::Pointer source = SourceType::New();
+  ImageType::SizeValueType size[Dimension] = { 31, 24, 13 };
+  source->SetSize( size );
+  source->SetMin( 0.0 );
+  source->SetMax( 100.0 );
+  TRY_EXPECT_NO_EXCEPTION( source->Update() );
+
+  const unsigned int repetitions = 3;
+
+  FilterType::Pointer filter = FilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( filter, BinomialBlurImageFilter, ImageToImageFilter );
+
+  filter->SetInput( source->GetOutput() );
+  filter->SetRepetitions( repetitions );
+  TEST_SET_GET_VALUE( repetitions, filter->GetRepetitions() );
+  TEST_SET_GET_VALUE( false, filter->GetUseFusedSeparableConvolution() );
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+  ImageType::Pointer expected = filter->GetOutput();
+  expected->DisconnectPipeline();
+
+  filter->UseFusedSeparableConvolutionOn();
+  TEST_SET_GET_VALUE( true, filter->GetUseFusedSeparableConvolution() );
+
+  ImageType::Pointer singleThreaded;
+  const itk::ThreadIdType numberOfThreads[2] = { 1, 3 };
+  for ( unsigned int t = 0; t < 2; ++t )
+    {
+    filter->SetNumberOfThreads( numberOfThreads[t] );
+    TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+    ImageType::RegionType interior = expected->GetLargestPossibleRegion();
+    interior.ShrinkByRadius( repetitions );
+
+    itk::ImageRegionConstIteratorWithIndex< ImageType > expectedIt( expected, interior );
+    itk::ImageRegionConstIterator< ImageType >          fusedIt( filter->GetOutput(), interior );
+    for (; !expectedIt.IsAtEnd(); ++expectedIt, ++fusedIt )
+      {
+      if ( itk::Math::abs( expectedIt.Get() - fusedIt.Get() ) > 1e-4 )
+        {
+        std::cerr << "Test failed with " << numberOfThreads[t] << " threads at index "
+                  << expectedIt.GetIndex() << ": expected " << expectedIt.Get()
+                  << ", got " << fusedIt.Get() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+
+    // The split of the output among the threads must not change the result
+    if ( t == 0 )
+      {
+      singleThreaded = filter->GetOutput();
+      singleThreaded->DisconnectPipeline();
+      continue;
+      }
+    itk::ImageRegionConstIteratorWithIndex< ImageType > singleIt( singleThreaded,
+      singleThreaded->GetLargestPossibleRegion() );
+    itk::ImageRegionConstIterator< ImageType > multiIt( filter->GetOutput(),
+      singleThreaded->GetLargestPossibleRegion() );
+    for (; !singleIt.IsAtEnd(); ++singleIt, ++multiIt )
+      {
+      if ( singleIt.Get() != multiIt.Get() )
+        {
+        std::cerr << "Test failed: " << numberOfThreads[t] << " threads differ from 1 thread at index "
+                  << singleIt.GetIndex() << ": " << singleIt.Get() << " != " << multiIt.Get() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -20,6 +20,7 @@
 #include "itkDiscreteGaussianImageFilter.h"
 #include "itkNullImageToImageFilterDriver.hxx"
 #include "itkFilterWatcher.h"
+#include "itkImageRegionIterator.h"
 
 int itkDiscreteGaussianImageFilterTest(int , char * [] )
 {
@@ -112,6 +113,75 @@ int itkDiscreteGaussianImageFilterTest(int , char * [] )
       test1.SetImageSize(sz);
       test1.SetFilter(filter.GetPointer());
       test1.Execute();
+
+      // The fused separable convolution must give the same result as the
+      // chain of neighborhood operator filters
+      ImageType::Pointer input = ImageType::New();
+      ImageType::RegionType region;
+      sz[0] = 37;
+      sz[1] = 23;
+      sz[2] = 11;
+      region.SetSize( sz );
+      input->SetRegions( region );
+      input->Allocate();
+      unsigned int value = 0;
+      for ( itk::ImageRegionIterator< ImageType > it( input, region ); !it.IsAtEnd(); ++it )
+        {
+        value = ( value * 7 + 3 ) % 101;
+        it.Set( value );
+        }
+
+      FilterType::Pointer chainFilter = FilterType::New();
+      chainFilter->SetInput( input );
+      chainFilter->SetVariance( 2.0 );
+      chainFilter->SetFilterDimensionality( 2 );
+      chainFilter->Update();
+      ImageType::Pointer expected = chainFilter->GetOutput();
+
+      FilterType::Pointer fusedFilter = FilterType::New();
+      if ( fusedFilter->GetUseFusedSeparableConvolution() != false )
+        {
+        std::cout << "GetUseFusedSeparableConvolution failed. Expected: false" << std::endl;
+        return EXIT_FAILURE;
+        }
+      fusedFilter->SetInput( input );
+      fusedFilter->SetVariance( 2.0 );
+      fusedFilter->SetFilterDimensionality( 2 );
+      fusedFilter->UseFusedSeparableConvolutionOn();
+      fusedFilter->SetNumberOfThreads( 1 );
+      fusedFilter->Update();
+
+      ImageType::Pointer singleThreaded = fusedFilter->GetOutput();
+      singleThreaded->DisconnectPipeline();
+
+      fusedFilter->SetNumberOfThreads( 3 );
+      fusedFilter->Update();
+
+      itk::ImageRegionIterator< ImageType > expectedIt( expected, region );
+      itk::ImageRegionIterator< ImageType > fusedIt( fusedFilter->GetOutput(), region );
+      for (; !expectedIt.IsAtEnd(); ++expectedIt, ++fusedIt )
+        {
+        if ( itk::Math::abs( expectedIt.Get() - fusedIt.Get() ) > 1e-4 )
+          {
+          std::cout << "Fused separable convolution failed at " << expectedIt.GetIndex()
+            << ". Expected: " << expectedIt.Get()
+            << " but got: " << fusedIt.Get() << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+
+      // The split of the output among the threads must not change the result
+      itk::ImageRegionIterator< ImageType > singleIt( singleThreaded, region );
+      for ( fusedIt.GoToBegin(); !singleIt.IsAtEnd(); ++singleIt, ++fusedIt )
+        {
+        if ( singleIt.Get() != fusedIt.Get() )
+          {
+          std::cout << "Fused separable convolution on 3 threads differs from 1 thread at "
+            << singleIt.GetIndex() << ": " << singleIt.Get()
+            << " != " << fusedIt.Get() << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
     }
   catch(itk::ExceptionObject &err)
     {
@@ -518,6 +518,94 @@ int itkRecursiveGaussianImageFiltersTest(int, char* [] )
 
   }
 
+  { // Test the filtering of blocks of lines along the slow directions
+
+  // Filtering a direction other than the first one of an image must give
+  // the same result as filtering the first direction of the image with the
+  // axes swapped, which is computed one line at a time.
+  const unsigned int Dimension = 3;
+  typedef itk::Vector< float, 2 >                                   PixelType;
+  typedef itk::Image< PixelType, Dimension >                        ImageType;
+  typedef itk::RecursiveGaussianImageFilter< ImageType, ImageType > FilterType;
+
+  ImageType::SizeType size;
+  size[0] = 13;
+  size[1] = 11;
+  size[2] = 7;
+  ImageType::RegionType region;
+  region.SetSize( size );
+
+  ImageType::Pointer inputImage = ImageType::New();
+  inputImage->SetRegions( region );
+  inputImage->Allocate();
+
+  unsigned int seed = 17;
+  itk::ImageRegionIteratorWithIndex< ImageType > it( inputImage, region );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    PixelType value;
+    seed = ( seed * 75 + 74 ) % 65537;
+    value[0] = static_cast< float >( seed % 100 );
+    value[1] = static_cast< float >( it.GetIndex()[1] * it.GetIndex()[2] );
+    it.Set( value );
+    }
+
+  for( unsigned int direction = 1; direction < Dimension; ++direction )
+    {
+    // Swap the axes 0 and direction
+    ImageType::SizeType swappedSize = size;
+    std::swap( swappedSize[0], swappedSize[direction] );
+    ImageType::RegionType swappedRegion;
+    swappedRegion.SetSize( swappedSize );
+
+    ImageType::Pointer swappedImage = ImageType::New();
+    swappedImage->SetRegions( swappedRegion );
+    swappedImage->Allocate();
+    for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      ImageType::IndexType swappedIndex = it.GetIndex();
+      std::swap( swappedIndex[0], swappedIndex[direction] );
+      swappedImage->SetPixel( swappedIndex, it.Get() );
+      }
+
+    for( unsigned int order = 0; order < 3; ++order )
+      {
+      FilterType::Pointer filter = FilterType::New();
+      filter->SetInput( inputImage );
+      filter->SetDirection( direction );
+      filter->SetSigma( 1.5 );
+      filter->SetOrder( static_cast< FilterType::OrderEnumType >( order ) );
+      filter->SetNumberOfThreads( 3 );
+      filter->Update();
+
+      FilterType::Pointer lineFilter = FilterType::New();
+      lineFilter->SetInput( swappedImage );
+      lineFilter->SetDirection( 0 );
+      lineFilter->SetSigma( 1.5 );
+      lineFilter->SetOrder( static_cast< FilterType::OrderEnumType >( order ) );
+      lineFilter->Update();
+
+      itk::ImageRegionIteratorWithIndex< ImageType > outIt( filter->GetOutput(), region );
+      for( outIt.GoToBegin(); !outIt.IsAtEnd(); ++outIt )
+        {
+        ImageType::IndexType swappedIndex = outIt.GetIndex();
+        std::swap( swappedIndex[0], swappedIndex[direction] );
+        const PixelType expected = lineFilter->GetOutput()->GetPixel( swappedIndex );
+        for( unsigned int c = 0; c < 2; ++c )
+          {
+          if( itk::Math::abs( outIt.Get()[c] - expected[c] ) > 1e-4 )
+            {
+            std::cerr << "Failure along direction " << direction << " for order " << order
+                      << " at index " << outIt.GetIndex() << ": expected " << expected
+                      << " but got " << outIt.Get() << std::endl;
+            return EXIT_FAILURE;
+            }
+          }
+        }
+      }
+    }
+
+  }
 
   // All objects should be automatically destroyed at this point
   return EXIT_SUCCESS;
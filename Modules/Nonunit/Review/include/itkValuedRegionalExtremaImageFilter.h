@@ -21,6 +21,7 @@
 #include "itkImageToImageFilter.h"
 #include "itkShapedNeighborhoodIterator.h"
 #include "itkConstantBoundaryCondition.h"
+#include "itkMultiThreader.h"
 #include <stack>
 
 namespace itk
@@ -56,6 +57,15 @@ namespace itk
  *
  * The implementation uses the functor model from itkMaximumImageFilter.
  *
+ * When several threads are used, the image is split in regions along its
+ * last dimension, and each thread copies its region to the output and
+ * marks the pixels that have a neighbor greater than themselves (for
+ * regional minima). The flat regions containing a marked pixel are then
+ * flooded by a single thread, since a flat region may span the whole
+ * image. A flat region is flooded if and only if it contains a marked
+ * pixel, whatever the order of the visits, so the output is identical to
+ * the one computed with a single thread.
+ *
  *
  * This code was contributed in the Insight Journal paper:
  * "Finding regional extrema - methods and performance"
@@ -171,6 +181,25 @@ private:
   typedef ConstShapedNeighborhoodIterator< InputImageType > ConstInputIterator;
   typedef ShapedNeighborhoodIterator< OutputImageType >     NOutputIterator;
   typedef std::stack< OutIndexType >                        IndexStack;
+
+  struct SeedsThreadStruct
+  {
+    Self *Filter;
+  };
+
+  /** Multithreaded version: the seeds of the flooding are found by all
+   * the threads, then the flooding is done by a single thread. */
+  void GenerateDataFromSeeds();
+
+  static ITK_THREAD_RETURN_TYPE FindSeedsThreaderCallback(void *arg);
+
+  /** Copy a region of the input to the output, and mark the pixels of
+   * the region which are not extrema because of one of their neighbors. */
+  void ThreadedFindSeeds(ThreadIdType threadId, ThreadIdType numberOfThreads);
+
+  std::vector< unsigned char > m_Seeds;
+  std::vector< unsigned char > m_FlatPerThread;
+  InputImagePixelType          m_FirstValue;
 }; // end of class
 } // end namespace itk
 
@@ -40,7 +40,8 @@ template< typename TInputImage, typename TOutputImage, typename TFunction1,
           typename TFunction2 >
 ValuedRegionalExtremaImageFilter< TInputImage, TOutputImage, TFunction1,
                                   TFunction2 >
-::ValuedRegionalExtremaImageFilter():m_MarkerValue(0)
+::ValuedRegionalExtremaImageFilter():m_MarkerValue(0),
+  m_FirstValue(NumericTraits< InputImagePixelType >::ZeroValue())
 {
   m_FullyConnected = false;
 
@@ -90,6 +91,12 @@ ValuedRegionalExtremaImageFilter< TInputImage, TOutputImage, TFunction1,
   // Allocate the output
   this->AllocateOutputs();
 
+  if ( this->GetNumberOfThreads() > 1 && this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() > 0 )
+    {
+    this->GenerateDataFromSeeds();
+    return;
+    }
+
   // 2 phases
   ProgressReporter progress(this, 0,
                             this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() * 2);
@@ -234,6 +241,171 @@ ValuedRegionalExtremaImageFilter< TInputImage, TOutputImage, TFunction1,
     }
 }
 
+template< typename TInputImage, typename TOutputImage, typename TFunction1,
+          typename TFunction2 >
+void
+ValuedRegionalExtremaImageFilter< TInputImage, TOutputImage, TFunction1,
+                                  TFunction2 >
+::GenerateDataFromSeeds()
+{
+  OutputImageType *output = this->GetOutput();
+  const OutputImageRegionType region = output->GetRequestedRegion();
+
+  m_FirstValue = this->GetInput()->GetPixel( region.GetIndex() );
+  m_Seeds.assign(region.GetNumberOfPixels(), 0);
+  m_FlatPerThread.assign(this->GetNumberOfThreads(), 1);
+
+  SeedsThreadStruct str;
+  str.Filter = this;
+
+  MultiThreader *threader = this->GetMultiThreader();
+  threader->SetNumberOfThreads( this->GetNumberOfThreads() );
+  threader->SetSingleMethod(this->FindSeedsThreaderCallback, &str);
+  threader->SingleMethodExecute();
+
+  this->m_Flat = true;
+  for ( ThreadIdType t = 0; t < m_FlatPerThread.size(); ++t )
+    {
+    if ( !m_FlatPerThread[t] )
+      {
+      this->m_Flat = false;
+      }
+    }
+
+  // if the image is flat, there is no need to do the work:
+  // the image will be unchanged
+  if ( !this->m_Flat )
+    {
+    ProgressReporter progress(this, 0, region.GetNumberOfPixels(), 100, 0.5f, 0.5f);
+
+    ISizeType kernelRadius;
+    kernelRadius.Fill(1);
+    NOutputIterator outNIt(kernelRadius, output, region);
+    setConnectivity(&outNIt, m_FullyConnected);
+
+    ConstantBoundaryCondition< OutputImageType > oBC;
+    oBC.SetConstant(m_MarkerValue);
+    outNIt.OverrideBoundaryCondition(&oBC);
+
+    TFunction2 compareOut;
+
+    IndexStack IS;
+    const typename NOutputIterator::IndexListType IndexList = outNIt.GetActiveIndexList();
+
+    // flood the flat regions containing a seed, as in the single
+    // threaded version
+    ImageRegionIterator< OutputImageType > outIt(output, region);
+    std::vector< unsigned char >::const_iterator seedIt = m_Seeds.begin();
+    for (; !outIt.IsAtEnd(); ++outIt, ++seedIt )
+      {
+      const OutputImagePixelType V = outIt.Get();
+      if ( *seedIt && compareOut(V, m_MarkerValue) )
+        {
+        outNIt += outIt.GetIndex() - outNIt.GetIndex();
+        IS.push( outNIt.GetIndex() );
+        outNIt.SetCenterPixel(m_MarkerValue);
+
+        while ( !IS.empty() )
+          {
+          const OutIndexType idx = IS.top();
+          IS.pop();
+          outNIt += idx - outNIt.GetIndex();
+          for ( typename NOutputIterator::IndexListType::const_iterator LIt = IndexList.begin();
+                LIt != IndexList.end(); ++LIt )
+            {
+            if ( outNIt.GetPixel(*LIt) == V )
+              {
+              IS.push( outNIt.GetIndex(*LIt) );
+              outNIt.SetPixel(*LIt, m_MarkerValue);
+              }
+            }
+          }
+        }
+      progress.CompletedPixel();
+      }
+    }
+
+  m_Seeds.clear();
+  m_FlatPerThread.clear();
+}
+
+template< typename TInputImage, typename TOutputImage, typename TFunction1,
+          typename TFunction2 >
+ITK_THREAD_RETURN_TYPE
+ValuedRegionalExtremaImageFilter< TInputImage, TOutputImage, TFunction1,
+                                  TFunction2 >
+::FindSeedsThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  SeedsThreadStruct *str = static_cast< SeedsThreadStruct * >( info->UserData );
+  str->Filter->ThreadedFindSeeds(info->ThreadID, info->NumberOfThreads);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TFunction1,
+          typename TFunction2 >
+void
+ValuedRegionalExtremaImageFilter< TInputImage, TOutputImage, TFunction1,
+                                  TFunction2 >
+::ThreadedFindSeeds(ThreadIdType threadId, ThreadIdType numberOfThreads)
+{
+  OutputImageRegionType splitRegion;
+  const ThreadIdType total = this->SplitRequestedRegion(threadId, numberOfThreads, splitRegion);
+  if ( threadId >= total )
+    {
+    return;
+    }
+
+  const InputImageType *input = this->GetInput();
+  OutputImageType      *output = this->GetOutput();
+  const OutIndexType    start = output->GetRequestedRegion().GetIndex();
+
+  ProgressReporter progress(this, threadId, splitRegion.GetNumberOfPixels(), 100, 0.0f, 0.5f);
+
+  ISizeType kernelRadius;
+  kernelRadius.Fill(1);
+  ConstInputIterator inNIt(kernelRadius, input, splitRegion);
+  setConnectivity(&inNIt, m_FullyConnected);
+
+  ConstantBoundaryCondition< InputImageType > iBC;
+  iBC.SetConstant(m_MarkerValue);
+  inNIt.OverrideBoundaryCondition(&iBC);
+
+  TFunction1 compareIn;
+  TFunction2 compareOut;
+
+  ImageRegionIterator< OutputImageType > outIt(output, splitRegion);
+  // the split regions are contiguous in the requested region
+  std::vector< unsigned char >::iterator seedIt =
+    m_Seeds.begin() + ( output->ComputeOffset( splitRegion.GetIndex() ) - output->ComputeOffset(start) );
+  bool flat = true;
+  for ( inNIt.GoToBegin(); !outIt.IsAtEnd(); ++inNIt, ++outIt, ++seedIt )
+    {
+    const InputImagePixelType currentValue = inNIt.GetCenterPixel();
+    const OutputImagePixelType V = static_cast< OutputImagePixelType >( currentValue );
+    outIt.Set(V);
+    if ( currentValue != m_FirstValue )
+      {
+      flat = false;
+      }
+
+    if ( compareOut(V, m_MarkerValue) )
+      {
+      const InputImagePixelType Cent = static_cast< InputImagePixelType >( V );
+      for ( typename ConstInputIterator::ConstIterator sIt = inNIt.Begin(); !sIt.IsAtEnd(); ++sIt )
+        {
+        if ( compareIn(sIt.Get(), Cent) )
+          {
+          *seedIt = 1;
+          break;
+          }
+        }
+      }
+    progress.CompletedPixel();
+    }
+  m_FlatPerThread[threadId] = flat;
+}
+
 template< typename TInputImage, typename TOutputImage, typename TFunction1,
           typename TFunction2 >
 void
@@ -0,0 +1,108 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Compare the multithreaded regional extrema with the single threaded
+// ones. The outputs must be identical.
+
+#include "itkValuedRegionalMaximaImageFilter.h"
+#include "itkValuedRegionalMinimaImageFilter.h"
+#include "itkRandomImageSource.h"
+#include "itkTestingComparisonImageFilter.h"
+#include "itkTestingMacros.h"
+
+int itkValuedRegionalExtremaImageFilterMultiThreadingTest(int, char* [] )
+{
+  const unsigned int Dimension = 2;
+
+  typedef itk::Image< unsigned char, Dimension >                              ImageType;
+  typedef itk::ValuedRegionalMaximaImageFilter< ImageType, ImageType >        MaximaType;
+  typedef itk::ValuedRegionalMinimaImageFilter< ImageType, ImageType >        MinimaType;
+  typedef itk::Testing::ComparisonImageFilter< ImageType, ImageType >         ComparisonType;
+
+  // few gray levels, so that the flat regions cross the regions of the
+  // threads
+  typedef itk::RandomImageSource< ImageType > SourceType;
+  SourceType::Pointer source = SourceType::New();
+  ImageType::SizeValueType size[Dimension] = { 61, 47 };
+  source->SetSize( size );
+  source->SetMin( 0 );
+  source->SetMax( 3 );
+  source->SetNumberOfThreads( 1 );
+  TRY_EXPECT_NO_EXCEPTION( source->Update() );
+
+  MaximaType::Pointer maxima = MaximaType::New();
+  maxima->SetInput( source->GetOutput() );
+  MinimaType::Pointer minima = MinimaType::New();
+  minima->SetInput( source->GetOutput() );
+
+  const itk::ThreadIdType numberOfThreads[3] = { 1, 3, 8 };
+  for ( unsigned int fullyConnected = 0; fullyConnected < 2; ++fullyConnected )
+    {
+    maxima->SetFullyConnected( fullyConnected );
+    minima->SetFullyConnected( fullyConnected );
+
+    ImageType::Pointer expectedMaxima;
+    ImageType::Pointer expectedMinima;
+    for ( unsigned int t = 0; t < 3; ++t )
+      {
+      maxima->SetNumberOfThreads( numberOfThreads[t] );
+      minima->SetNumberOfThreads( numberOfThreads[t] );
+      TRY_EXPECT_NO_EXCEPTION( maxima->Update() );
+      TRY_EXPECT_NO_EXCEPTION( minima->Update() );
+      TEST_EXPECT_TRUE( !maxima->GetFlat() );
+      TEST_EXPECT_TRUE( !minima->GetFlat() );
+      if ( t == 0 )
+        {
+        expectedMaxima = maxima->GetOutput();
+        expectedMaxima->DisconnectPipeline();
+        expectedMinima = minima->GetOutput();
+        expectedMinima->DisconnectPipeline();
+        continue;
+        }
+
+      ComparisonType::Pointer comparison = ComparisonType::New();
+      comparison->SetValidInput( expectedMaxima );
+      comparison->SetTestInput( maxima->GetOutput() );
+      TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+      TEST_EXPECT_EQUAL( comparison->GetNumberOfPixelsWithDifferences(), 0 );
+
+      comparison->SetValidInput( expectedMinima );
+      comparison->SetTestInput( minima->GetOutput() );
+      TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+      TEST_EXPECT_EQUAL( comparison->GetNumberOfPixelsWithDifferences(), 0 );
+      }
+    }
+
+  // a flat image is left unchanged
+  ImageType::Pointer flat = ImageType::New();
+  flat->SetRegions( source->GetOutput()->GetLargestPossibleRegion() );
+  flat->Allocate();
+  flat->FillBuffer( 7 );
+  maxima->SetInput( flat );
+  maxima->SetNumberOfThreads( 3 );
+  TRY_EXPECT_NO_EXCEPTION( maxima->Update() );
+  TEST_EXPECT_TRUE( maxima->GetFlat() );
+  ComparisonType::Pointer comparison = ComparisonType::New();
+  comparison->SetValidInput( flat );
+  comparison->SetTestInput( maxima->GetOutput() );
+  TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+  TEST_EXPECT_EQUAL( comparison->GetNumberOfPixelsWithDifferences(), 0 );
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,192 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLimitedMemoryBFGSOptimizerv4_h
+#define itkLimitedMemoryBFGSOptimizerv4_h
+
+#include "itkGradientDescentOptimizerv4.h"
+#include "itkLimitedMemoryBFGSOptimizerv4VectorThreader.h"
+
+namespace itk
+{
+/** \class LimitedMemoryBFGSOptimizerv4Template
+ * \brief Limited memory BFGS optimizer with multithreaded vector operations.
+ *
+ * The search direction is computed with the L-BFGS two-loop recursion
+ * from the last NumberOfCorrections position and gradient differences,
+ * and a backtracking line search finds a step satisfying the sufficient
+ * decrease (Armijo) condition along it. Unlike LBFGSOptimizerv4, which
+ * wraps vnl_lbfgs, the optimizer works directly on the metric parameters
+ * and derivative arrays, and for more than
+ * MinimumNumberOfParametersForThreading parameters the dot products and
+ * vector updates are split over threads. The dot products are summed
+ * over blocks of parameters of a fixed size in index order, so the
+ * results do not depend on the number of threads. This keeps the
+ * optimizer overhead small for transforms with millions of parameters,
+ * such as dense BSpline transforms.
+ *
+ * The parameter scales and weights are used as a diagonal
+ * preconditioner: the initial inverse Hessian of the recursion is the
+ * diagonal applied by ModifyGradientByScales(), multiplied by the usual
+ * s'y / y'Dy factor. The first step, taken before any curvature
+ * information is available, is the scaled gradient multiplied by the
+ * learning rate, estimated by the ScalesEstimator if one is set.
+ *
+ * The optimization stops when the maximum number of iterations is
+ * reached, the derivative magnitude falls below
+ * GradientConvergenceTolerance, the convergence monitoring passes, or
+ * the line search fails to decrease the metric value.
+ *
+ * \sa LBFGSOptimizerv4, QuasiNewtonOptimizerv4Template
+ * \ingroup ITKOptimizersv4
+ */
+template<typename TInternalComputationValueType>
+class ITK_TEMPLATE_EXPORT LimitedMemoryBFGSOptimizerv4Template :
+  public GradientDescentOptimizerv4Template<TInternalComputationValueType>
+{
+public:
+  /** Standard class typedefs. */
+  typedef LimitedMemoryBFGSOptimizerv4Template                              Self;
+  typedef GradientDescentOptimizerv4Template<TInternalComputationValueType> Superclass;
+  typedef SmartPointer< Self >                                              Pointer;
+  typedef SmartPointer< const Self >                                        ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(LimitedMemoryBFGSOptimizerv4Template, Superclass);
+
+  /** It should be possible to derive the internal computation type from the class object. */
+  typedef TInternalComputationValueType          InternalComputationValueType;
+
+  typedef typename Superclass::ParametersType    ParametersType;
+  typedef typename Superclass::MeasureType       MeasureType;
+  typedef typename Superclass::DerivativeType    DerivativeType;
+  typedef typename Superclass::ScalesType        ScalesType;
+  typedef typename Superclass::IndexRangeType    IndexRangeType;
+  typedef typename Superclass::StopConditionType StopConditionType;
+
+  /** Set/Get the number of corrections, i.e. of position and gradient
+   * differences, kept to approximate the inverse Hessian. Defaults to 5. */
+  itkSetClampMacro(NumberOfCorrections, SizeValueType, 1, NumericTraits<SizeValueType>::max());
+  itkGetConstMacro(NumberOfCorrections, SizeValueType);
+
+  /** Set/Get the derivative magnitude below which the optimization
+   * stops. Defaults to 1e-5. */
+  itkSetMacro(GradientConvergenceTolerance, TInternalComputationValueType);
+  itkGetConstMacro(GradientConvergenceTolerance, TInternalComputationValueType);
+
+  /** Set/Get the maximum number of metric evaluations in one line
+   * search. Defaults to 20. */
+  itkSetClampMacro(MaximumNumberOfLineSearchEvaluations, SizeValueType, 1, NumericTraits<SizeValueType>::max());
+  itkGetConstMacro(MaximumNumberOfLineSearchEvaluations, SizeValueType);
+
+  /** Set/Get the number of parameters above which the vector operations
+   * are split over threads. Smaller vectors are processed in the calling
+   * thread, where the cost of starting the threads would dominate.
+   * Defaults to 10000. */
+  itkSetMacro(MinimumNumberOfParametersForThreading, SizeValueType);
+  itkGetConstMacro(MinimumNumberOfParametersForThreading, SizeValueType);
+
+  /** Get the number of corrections currently stored. */
+  itkGetConstMacro(NumberOfStoredCorrections, SizeValueType);
+
+  /** Start and run the optimization */
+  virtual void StartOptimization( bool doOnlyInitialization = false ) ITK_OVERRIDE;
+
+  /** Resume the optimization. */
+  virtual void ResumeOptimization() ITK_OVERRIDE;
+
+  /** Compute y += alpha * x, or y = alpha * x if \c overwrite is true,
+   * over a given index range, and return the dot product of the updated y
+   * with z, weighted by \c factors if it is not null, or zero if z is
+   * null. \c x may be null to only compute the dot product. \c factors
+   * holds one value per local parameter.
+   * This function is used in LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate. */
+  virtual InternalComputationValueType AxpyDotOverSubRange( const IndexRangeType & subrange,
+                                                            InternalComputationValueType alpha,
+                                                            const DerivativeType * x,
+                                                            DerivativeType * y,
+                                                            const DerivativeType * z,
+                                                            const ScalesType * factors,
+                                                            bool overwrite ) const;
+
+protected:
+  LimitedMemoryBFGSOptimizerv4Template();
+  virtual ~LimitedMemoryBFGSOptimizerv4Template();
+
+  virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+  /** Compute a search direction, search along it and update the metric
+   * value and derivative at the new position. */
+  virtual void AdvanceOneStep(void) ITK_OVERRIDE;
+
+  /** Set m_Gradient to the L-BFGS search direction of the derivative
+   * held in m_PreviousGradient. */
+  virtual void ComputeSearchDirection();
+
+  /** Threaded vector kernel, see AxpyDotOverSubRange(). */
+  InternalComputationValueType AxpyDot( InternalComputationValueType alpha,
+                                        const DerivativeType * x,
+                                        DerivativeType * y,
+                                        const DerivativeType * z,
+                                        const ScalesType * factors = ITK_NULLPTR,
+                                        bool overwrite = false );
+
+  /** Discard the stored corrections. */
+  void ResetCorrections();
+
+  SizeValueType                 m_NumberOfCorrections;
+  TInternalComputationValueType m_GradientConvergenceTolerance;
+  SizeValueType                 m_MaximumNumberOfLineSearchEvaluations;
+  SizeValueType                 m_MinimumNumberOfParametersForThreading;
+
+  /** Ring buffer of the position differences s and derivative
+   * differences y, with rho = 1 / s'y. */
+  std::vector<DerivativeType>                m_PositionDifferences;
+  std::vector<DerivativeType>                m_GradientDifferences;
+  std::vector<TInternalComputationValueType> m_Rho;
+  std::vector<TInternalComputationValueType> m_TwoLoopAlpha;
+  SizeValueType                              m_OldestCorrection;
+  SizeValueType                              m_NumberOfStoredCorrections;
+
+  /** Scaling s'y / y'Dy of the initial inverse Hessian. */
+  TInternalComputationValueType m_InitialHessianScale;
+
+  /** Search direction of the current line search. */
+  DerivativeType m_SearchDirection;
+
+  /** Factors applied by ModifyGradientByScales, per local parameter. */
+  ScalesType m_ScalesFactors;
+
+private:
+  ITK_DISALLOW_COPY_AND_ASSIGN(LimitedMemoryBFGSOptimizerv4Template);
+
+  typename LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate<TInternalComputationValueType>::Pointer m_VectorThreader;
+};
+
+/** This helps to meet backward compatibility */
+typedef LimitedMemoryBFGSOptimizerv4Template<double> LimitedMemoryBFGSOptimizerv4;
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkLimitedMemoryBFGSOptimizerv4.hxx"
+#endif
+
+#endif
@@ -0,0 +1,491 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLimitedMemoryBFGSOptimizerv4_hxx
+#define itkLimitedMemoryBFGSOptimizerv4_hxx
+
+#include "itkLimitedMemoryBFGSOptimizerv4.h"
+
+namespace itk
+{
+
+template<typename TInternalComputationValueType>
+LimitedMemoryBFGSOptimizerv4Template<TInternalComputationValueType>
+::LimitedMemoryBFGSOptimizerv4Template():
+  m_NumberOfCorrections(5),
+  m_GradientConvergenceTolerance(1e-5),
+  m_MaximumNumberOfLineSearchEvaluations(20),
+  m_MinimumNumberOfParametersForThreading(10000),
+  m_OldestCorrection(0),
+  m_NumberOfStoredCorrections(0),
+  m_InitialHessianScale(NumericTraits<TInternalComputationValueType>::OneValue())
+{
+  this->m_VectorThreader = LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate<TInternalComputationValueType>::New();
+}
+
+template<typename TInternalComputationValueType>
+LimitedMemoryBFGSOptimizerv4Template<TInternalComputationValueType>
+::~LimitedMemoryBFGSOptimizerv4Template()
+{
+}
+
+template<typename TInternalComputationValueType>
+void
+LimitedMemoryBFGSOptimizerv4Template<TInternalComputationValueType>
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfCorrections: " << this->m_NumberOfCorrections << std::endl;
+  os << indent << "GradientConvergenceTolerance: " << this->m_GradientConvergenceTolerance << std::endl;
+  os << indent << "MaximumNumberOfLineSearchEvaluations: " << this->m_MaximumNumberOfLineSearchEvaluations << std::endl;
+  os << indent << "MinimumNumberOfParametersForThreading: " << this->m_MinimumNumberOfParametersForThreading << std::endl;
+  os << indent << "NumberOfStoredCorrections: " << this->m_NumberOfStoredCorrections << std::endl;
+}
+
+template<typename TInternalComputationValueType>
+void
+LimitedMemoryBFGSOptimizerv4Template<TInternalComputationValueType>
+::StartOptimization( bool doOnlyInitialization )
+{
+  itkDebugMacro("StartOptimization");
+
+  this->m_VectorThreader->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
+
+  this->m_PositionDifferences.resize( this->m_NumberOfCorrections );
+  this->m_GradientDifferences.resize( this->m_NumberOfCorrections );
+  this->m_Rho.resize( this->m_NumberOfCorrections );
+  this->m_TwoLoopAlpha.resize( this->m_NumberOfCorrections );
+  this->ResetCorrections();
+
+  /* Must call the superclass version for basic validation, setup,
+   * and to start the optimization loop. */
+  Superclass::StartOptimization( doOnlyInitialization );
+}
+
+template<typename TInternalComputationValueType>
+void
+LimitedMemoryBFGSOptimizerv4Template<TInternalComputationValueType>
+::ResetCorrections()
+{
+  this->m_OldestCorrection = 0;
+  this->m_NumberOfStoredCorrections = 0;
+  this->m_InitialHessianScale = NumericTraits<TInternalComputationValueType>::OneValue();
+}
+
+template<typename TInternalComputationValueType>
+void
+LimitedMemoryBFGSOptimizerv4Template<TInternalComputationValueType>
+::ResumeOptimization()
+{
+  this->m_StopConditionDescription.str("");
+  this->m_StopConditionDescription << this->GetNameOfClass() << ": ";
+  this->InvokeEvent( StartEvent() );
+
+  /* The factors applied by ModifyGradientByScales, needed to scale the
+   * initial inverse Hessian. */
+  const ScalesType & scales = this->GetScales();
+  const ScalesType & weights = this->GetWeights();
+  this->m_ScalesFactors.SetSize( scales.Size() );
+  for( SizeValueType i = 0; i < scales.Size(); i++ )
+    {
+    this->m_ScalesFactors[i] = NumericTraits<TInternalComputationValueType>::OneValue() / scales[i];
+    if( !this->GetWeightsAreIdentity() )
+      {
+      this->m_ScalesFactors[i] *= weights[i];
+      }
+    }
+
+  /* The line search evaluates the metric at each new position, so the
+   * value and derivative are only computed here for the start position. */
+  try
+    {
+    this->m_Metric->GetValueAndDerivative( this->m_CurrentMetricValue, this->m_Gradient );
+    }
+  catch ( ExceptionObject & err )
+    {
+    this->m_StopCondition = Superclass::COSTFUNCTION_ERROR;
+    this->m_StopConditionDescription << "Metric error during optimization";
+    this->StopOptimization();
+
+    // Pass exception to caller
+    throw err;
+    }
+
+  this->m_Stop = false;
+  while( ! this->m_Stop )
+    {
+    // Do not run the loop if the maximum number of iterations is reached or its value is zero.
+    if ( this->m_CurrentIteration >= this->m_NumberOfIterations )
+      {
+      this->m_StopConditionDescription << "Maximum number of iterations (" << this->m_NumberOfIterations << ") exceeded.";
+      this->m_StopCondition = Superclass::MAXIMUM_NUMBER_OF_ITERATIONS;
+      this->StopOptimization();
+      break;
+      }
+
+    const TInternalComputationValueType gradientMagnitude = std::sqrt(
+      this->AxpyDot( NumericTraits<TInternalComputationValueType>::ZeroValue(), ITK_NULLPTR, &this->m_Gradient, &this->m_Gradient ) );
+    if ( gradientMagnitude <= this->m_GradientConvergenceTolerance )
+      {
+      this->m_StopConditionDescription << "Gradient magnitude tolerance met after " << this->m_CurrentIteration << " iterations.";
+      this->m_StopCondition = Superclass::GRADIENT_MAGNITUDE_TOLEARANCE;
+      this->StopOptimization();
+      break;
+      }
+
+    /* Check the convergence by WindowConvergenceMonitoringFunction.
+     */
+    if ( this->m_UseConvergenceMonitoring )
+      {
+      this->m_ConvergenceMonitoring->AddEnergyValue( this->m_CurrentMetricValue );
+      try
+        {
+        this->m_ConvergenceValue = this->m_ConvergenceMonitoring->GetConvergenceValue();
+        if (this->m_ConvergenceValue <= this->m_MinimumConvergenceValue)
+          {
+          this->m_StopConditionDescription << "Convergence checker passed at iteration " << this->m_CurrentIteration << ".";
+          this->m_StopCondition = Superclass::CONVERGENCE_CHECKER_PASSED;
+          this->StopOptimization();
+          break;
+          }
+        }
+      catch(std::exception & e)
+        {
+        std::cerr << "GetConvergenceValue() failed with exception: " << e.what() << std::endl;
+        }
+      }
+
+    /* Search along the L-BFGS direction. This updates the transform, and
+     * the metric value and derivative. */
+    this->AdvanceOneStep();
+
+    /* Store best value and position */
+    if ( this->m_ReturnBestParametersAndValue && this->m_CurrentMetricValue < this->m_CurrentBestValue )
+      {
+      this->m_CurrentBestValue = this->m_CurrentMetricValue;
+      this->m_BestParameters = this->GetCurrentPosition( );
+      }
+
+    /* Update and check iteration count */
+    this->m_CurrentIteration++;
+
+    } //while (!m_Stop)
+}
+
+template<typename TInternalComputationValueType>
+void
+LimitedMemoryBFGSOptimizerv4Template<TInternalComputationValueType>
+::AdvanceOneStep(void)
+{
+  itkDebugMacro("AdvanceOneStep");
+
+  const TInternalComputationValueType zero = NumericTraits<TInternalComputationValueType>::ZeroValue();
+  const TInternalComputationValueType one = NumericTraits<TInternalComputationValueType>::OneValue();
+
+  /* Keep the derivative at the current position to form the derivative
+   * difference once the line search is done. The search direction is
+   * written to the other buffer. */
+  swap( this->m_PreviousGradient, this->m_Gradient );
+  this->ComputeSearchDirection();
+
+  /* v4 metric derivatives point downhill, so the slope of the metric
+   * along the search direction p is -d'p. */
+  TInternalComputationValueType slope = -this->AxpyDot( zero, ITK_NULLPTR, &this->m_Gradient, &this->m_PreviousGradient );
+  if( slope >= zero )
+    {
+    // The corrections do not give a descent direction; restart from the gradient.
+    this->ResetCorrections();
+    this->ComputeSearchDirection();
+    slope = -this->AxpyDot( zero, ITK_NULLPTR, &this->m_Gradient, &this->m_PreviousGradient );
+    }
+  swap( this->m_SearchDirection, this->m_Gradient );
+
+  /* Backtracking line search for sufficient decrease. The transform is
+   * moved by the difference between successive trial steps. */
+  const MeasureType initialValue = this->m_CurrentMetricValue;
+  const TInternalComputationValueType sufficientDecrease = 1e-4;
+  TInternalComputationValueType step = one;
+  TInternalComputationValueType appliedStep = zero;
+  MeasureType value = initialValue;
+  bool decreased = false;
+  for( SizeValueType evaluation = 0; evaluation < this->m_MaximumNumberOfLineSearchEvaluations; evaluation++ )
+    {
+    try
+      {
+      this->m_Metric->UpdateTransformParameters( this->m_SearchDirection, step - appliedStep );
+      appliedStep = step;
+      }
+    catch ( ExceptionObject & err )
+      {
+      this->m_StopCondition = Superclass::UPDATE_PARAMETERS_ERROR;
+      this->m_StopConditionDescription << "UpdateTransformParameters error";
+      this->StopOptimization();
+
+      // Pass exception to caller
+      throw err;
+      }
+    try
+      {
+      this->m_Metric->GetValueAndDerivative( value, this->m_Gradient );
+      }
+    catch ( ExceptionObject & err )
+      {
+      this->m_StopCondition = Superclass::COSTFUNCTION_ERROR;
+      this->m_StopConditionDescription << "Metric error during optimization";
+      this->StopOptimization();
+
+      // Pass exception to caller
+      throw err;
+      }
+    if( value <= initialValue + sufficientDecrease * step * slope )
+      {
+      decreased = true;
+      break;
+      }
+    step *= 0.5;
+    }
+
+  if( !decreased )
+    {
+    // Return to the start of the line search.
+    this->m_Metric->UpdateTransformParameters( this->m_SearchDirection, -appliedStep );
+    swap( this->m_Gradient, this->m_PreviousGradient );
+    this->m_CurrentMetricValue = initialValue;
+
+    this->m_StopCondition = Superclass::STEP_TOO_SMALL;
+    this->m_StopConditionDescription << "Line search failed to decrease the metric value in "
+      << this->m_MaximumNumberOfLineSearchEvaluations << " evaluations at iteration "
+      << this->m_CurrentIteration << ".";
+    this->StopOptimization();
+    return;
+    }
+  this->m_CurrentMetricValue = value;
+
+  /* Form the derivative difference y = g_new - g_old = d_old - d_new in
+   * place of the previous derivative, and the position difference
+   * s = step * p in place of the search direction. */
+  const TInternalComputationValueType yy =
+    this->AxpyDot( -one, &this->m_Gradient, &this->m_PreviousGradient, &this->m_PreviousGradient );
+  const TInternalComputationValueType sy =
+    step * this->AxpyDot( zero, ITK_NULLPTR, &this->m_PreviousGradient, &this->m_SearchDirection );
+
+  // Skip corrections that would not keep the inverse Hessian positive definite.
+  if( sy > NumericTraits<TInternalComputationValueType>::epsilon() * yy )
+    {
+    SizeValueType slot;
+    if( this->m_NumberOfStoredCorrections < this->m_NumberOfCorrections )
+      {
+      slot = ( this->m_OldestCorrection + this->m_NumberOfStoredCorrections ) % this->m_NumberOfCorrections;
+      this->m_NumberOfStoredCorrections++;
+      }
+    else
+      {
+      slot = this->m_OldestCorrection;
+      this->m_OldestCorrection = ( this->m_OldestCorrection + 1 ) % this->m_NumberOfCorrections;
+      }
+
+    swap( this->m_PositionDifferences[slot], this->m_SearchDirection );
+    swap( this->m_GradientDifferences[slot], this->m_PreviousGradient );
+    if( step != one )
+      {
+      this->AxpyDot( step - one, &this->m_PositionDifferences[slot], &this->m_PositionDifferences[slot], ITK_NULLPTR );
+      }
+    this->m_Rho[slot] = one / sy;
+
+    TInternalComputationValueType yDy = yy;
+    if( !this->GetScalesAreIdentity() || !this->GetWeightsAreIdentity() )
+      {
+      yDy = this->AxpyDot( zero, ITK_NULLPTR, &this->m_GradientDifferences[slot],
+                           &this->m_GradientDifferences[slot], &this->m_ScalesFactors );
+      }
+    if( yDy > zero )
+      {
+      this->m_InitialHessianScale = sy / yDy;
+      }
+    }
+
+  this->InvokeEvent( IterationEvent() );
+}
+
+template<typename TInternalComputationValueType>
+void
+LimitedMemoryBFGSOptimizerv4Template<TInternalComputationValueType>
+::ComputeSearchDirection()
+{
+  if( this->m_NumberOfStoredCorrections == 0 )
+    {
+    /* Without corrections, take a scaled gradient step. */
+    this->m_Gradient = this->m_PreviousGradient;
+    this->ModifyGradientByScales();
+    this->EstimateLearningRate();
+    this->ModifyGradientByLearningRate();
+    return;
+    }
+
+  const TInternalComputationValueType one = NumericTraits<TInternalComputationValueType>::OneValue();
+  const SizeValueType m = this->m_NumberOfCorrections;
+  const SizeValueType n = this->m_NumberOfStoredCorrections;
+  DerivativeType & q = this->m_Gradient;
+  q.SetSize( this->m_PreviousGradient.GetSize() );
+
+  /* Two-loop recursion. Each vector update is fused with the dot product
+   * needed by the next correction, so that every correction costs one
+   * pass over the parameters in each loop. The first pass copies the
+   * derivative into q. */
+  SizeValueType slot = ( this->m_OldestCorrection + n - 1 ) % m;
+  TInternalComputationValueType dot = this->AxpyDot( one, &this->m_PreviousGradient, &q,
+                                                     &this->m_PositionDifferences[slot], ITK_NULLPTR, true );
+  for( SizeValueType k = n; k > 0; k-- )
+    {
+    slot = ( this->m_OldestCorrection + k - 1 ) % m;
+    this->m_TwoLoopAlpha[slot] = this->m_Rho[slot] * dot;
+    const DerivativeType * next = ITK_NULLPTR;
+    if( k > 1 )
+      {
+      next = &this->m_PositionDifferences[( this->m_OldestCorrection + k - 2 ) % m];
+      }
+    dot = this->AxpyDot( -this->m_TwoLoopAlpha[slot], &this->m_GradientDifferences[slot], &q, next );
+    }
+
+  /* Apply the initial inverse Hessian, gamma * D. */
+  this->ModifyGradientByScales();
+  dot = this->AxpyDot( this->m_InitialHessianScale - one, &q, &q,
+                       &this->m_GradientDifferences[this->m_OldestCorrection] );
+
+  for( SizeValueType k = 0; k < n; k++ )
+    {
+    slot = ( this->m_OldestCorrection + k ) % m;
+    const TInternalComputationValueType beta = this->m_Rho[slot] * dot;
+    const DerivativeType * next = ITK_NULLPTR;
+    if( k + 1 < n )
+      {
+      next = &this->m_GradientDifferences[( this->m_OldestCorrection + k + 1 ) % m];
+      }
+    dot = this->AxpyDot( this->m_TwoLoopAlpha[slot] - beta, &this->m_PositionDifferences[slot], &q, next );
+    }
+}
+
+template<typename TInternalComputationValueType>
+TInternalComputationValueType
+LimitedMemoryBFGSOptimizerv4Template<TInternalComputationValueType>
+::AxpyDot( InternalComputationValueType alpha,
+           const DerivativeType * x,
+           DerivativeType * y,
+           const DerivativeType * z,
+           const ScalesType * factors,
+           bool overwrite )
+{
+  if( y->GetSize() == 0 )
+    {
+    return NumericTraits<TInternalComputationValueType>::ZeroValue();
+    }
+
+  /* Perform the operation either with or without threading */
+  if( y->GetSize() > this->m_MinimumNumberOfParametersForThreading )
+    {
+    /* This ends up calling AxpyDotOverSubRange from each thread, over
+     * blocks of parameters that do not depend on the number of threads. */
+    this->m_VectorThreader->SetOperands( alpha, x, y, z, factors, overwrite );
+    this->m_VectorThreader->Execute( this, this->m_VectorThreader->GetBlockRange() );
+    return this->m_VectorThreader->GetDotProduct();
+    }
+
+  IndexRangeType fullrange;
+  fullrange[0] = 0;
+  fullrange[1] = y->GetSize()-1; //range is inclusive
+  return this->AxpyDotOverSubRange( fullrange, alpha, x, y, z, factors, overwrite );
+}
+
+template<typename TInternalComputationValueType>
+TInternalComputationValueType
+LimitedMemoryBFGSOptimizerv4Template<TInternalComputationValueType>
+::AxpyDotOverSubRange( const IndexRangeType & subrange,
+                       InternalComputationValueType alpha,
+                       const DerivativeType * x,
+                       DerivativeType * y,
+                       const DerivativeType * z,
+                       const ScalesType * factors,
+                       bool overwrite ) const
+{
+  TInternalComputationValueType * yData = y->data_block();
+  const TInternalComputationValueType * xData = ( x != ITK_NULLPTR ) ? x->data_block() : ITK_NULLPTR;
+  const TInternalComputationValueType * zData = ( z != ITK_NULLPTR ) ? z->data_block() : ITK_NULLPTR;
+
+  TInternalComputationValueType dot = NumericTraits<TInternalComputationValueType>::ZeroValue();
+
+  /* Loop over the range. It is inclusive. */
+  if( xData != ITK_NULLPTR && zData != ITK_NULLPTR && factors == ITK_NULLPTR )
+    {
+    if( overwrite )
+      {
+      for ( IndexValueType j = subrange[0]; j <= subrange[1]; j++ )
+        {
+        yData[j] = alpha * xData[j];
+        dot += yData[j] * zData[j];
+        }
+      return dot;
+      }
+    for ( IndexValueType j = subrange[0]; j <= subrange[1]; j++ )
+      {
+      yData[j] += alpha * xData[j];
+      dot += yData[j] * zData[j];
+      }
+    return dot;
+    }
+
+  if( xData != ITK_NULLPTR )
+    {
+    if( overwrite )
+      {
+      for ( IndexValueType j = subrange[0]; j <= subrange[1]; j++ )
+        {
+        yData[j] = alpha * xData[j];
+        }
+      }
+    else
+      {
+      for ( IndexValueType j = subrange[0]; j <= subrange[1]; j++ )
+        {
+        yData[j] += alpha * xData[j];
+        }
+      }
+    }
+  if( zData != ITK_NULLPTR )
+    {
+    if( factors != ITK_NULLPTR )
+      {
+      // The factors are given per local parameter, as the scales.
+      const SizeValueType numberOfFactors = factors->Size();
+      for ( IndexValueType j = subrange[0]; j <= subrange[1]; j++ )
+        {
+        dot += yData[j] * zData[j] * (*factors)[j % numberOfFactors];
+        }
+      }
+    else
+      {
+      for ( IndexValueType j = subrange[0]; j <= subrange[1]; j++ )
+        {
+        dot += yData[j] * zData[j];
+        }
+      }
+    }
+  return dot;
+}
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,125 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLimitedMemoryBFGSOptimizerv4VectorThreader_h
+#define itkLimitedMemoryBFGSOptimizerv4VectorThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+#include "itkOptimizerParameters.h"
+
+namespace itk
+{
+
+template<typename TInternalComputationValueType>
+class LimitedMemoryBFGSOptimizerv4Template;
+
+/** \class LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate
+ * \brief Run the vector kernels of LimitedMemoryBFGSOptimizerv4Template
+ * over a range of blocks of parameters in a thread.
+ *
+ * The operands are set with SetOperands() before each Execute(), over the
+ * range returned by GetBlockRange(). The parameters are split in blocks of
+ * BlockSize parameters whatever the number of threads, and the partial dot
+ * products of the blocks are summed in index order, so the result does not
+ * depend on the number of threads or on their scheduling.
+ *
+ * \ingroup ITKOptimizersv4
+ * */
+template<typename TInternalComputationValueType>
+class ITK_TEMPLATE_EXPORT LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, LimitedMemoryBFGSOptimizerv4Template<TInternalComputationValueType> >
+{
+public:
+  /** Standard class typedefs. */
+  typedef LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate                                        Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, LimitedMemoryBFGSOptimizerv4Template<TInternalComputationValueType> >
+                                                                                                    Superclass;
+  typedef SmartPointer< Self >                                                                      Pointer;
+  typedef SmartPointer< const Self >                                                                ConstPointer;
+
+  itkTypeMacro( LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType     DomainType;
+  typedef typename Superclass::AssociateType  AssociateType;
+  typedef DomainType                          IndexRangeType;
+
+  typedef TInternalComputationValueType                         InternalComputationValueType;
+  typedef Array< TInternalComputationValueType >                DerivativeType;
+  typedef OptimizerParameters< TInternalComputationValueType >  ScalesType;
+
+  /** Number of parameters in a block. */
+  itkStaticConstMacro(BlockSize, SizeValueType, 4096);
+
+  /** Set the operands of AssociateType::AxpyDotOverSubRange(). */
+  void SetOperands( InternalComputationValueType alpha, const DerivativeType * x,
+                    DerivativeType * y, const DerivativeType * z, const ScalesType * factors,
+                    bool overwrite )
+  {
+    this->m_Alpha = alpha;
+    this->m_X = x;
+    this->m_Y = y;
+    this->m_Z = z;
+    this->m_Factors = factors;
+    this->m_Overwrite = overwrite;
+  }
+
+  /** Get the inclusive range of the blocks of the operands. */
+  IndexRangeType GetBlockRange() const;
+
+  /** Get the dot product computed by the last Execute(). */
+  InternalComputationValueType GetDotProduct() const
+  {
+    return this->m_DotProduct;
+  }
+
+protected:
+  virtual void BeforeThreadedExecution() ITK_OVERRIDE;
+
+  virtual void ThreadedExecution( const IndexRangeType & subrange,
+                                  const ThreadIdType threadId ) ITK_OVERRIDE;
+
+  virtual void AfterThreadedExecution() ITK_OVERRIDE;
+
+  LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate();
+  virtual ~LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate() {}
+
+private:
+  ITK_DISALLOW_COPY_AND_ASSIGN(LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate);
+
+  InternalComputationValueType              m_Alpha;
+  const DerivativeType *                    m_X;
+  DerivativeType *                          m_Y;
+  const DerivativeType *                    m_Z;
+  const ScalesType *                        m_Factors;
+  bool                                      m_Overwrite;
+  std::vector<InternalComputationValueType> m_BlockDotProducts;
+  InternalComputationValueType              m_DotProduct;
+};
+
+/** This helps to meet backward compatibility */
+typedef LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate<double> LimitedMemoryBFGSOptimizerv4VectorThreader;
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkLimitedMemoryBFGSOptimizerv4VectorThreader.hxx"
+#endif
+
+#endif
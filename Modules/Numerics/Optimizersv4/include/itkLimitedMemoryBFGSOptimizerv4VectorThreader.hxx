@@ -0,0 +1,91 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLimitedMemoryBFGSOptimizerv4VectorThreader_hxx
+#define itkLimitedMemoryBFGSOptimizerv4VectorThreader_hxx
+
+#include "itkLimitedMemoryBFGSOptimizerv4VectorThreader.h"
+
+namespace itk
+{
+template<typename TInternalComputationValueType>
+LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate<TInternalComputationValueType>
+::LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate() :
+  m_Alpha( NumericTraits<TInternalComputationValueType>::ZeroValue() ),
+  m_X( ITK_NULLPTR ),
+  m_Y( ITK_NULLPTR ),
+  m_Z( ITK_NULLPTR ),
+  m_Factors( ITK_NULLPTR ),
+  m_Overwrite( false ),
+  m_DotProduct( NumericTraits<TInternalComputationValueType>::ZeroValue() )
+{
+}
+
+template<typename TInternalComputationValueType>
+typename LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate<TInternalComputationValueType>::IndexRangeType
+LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate<TInternalComputationValueType>
+::GetBlockRange() const
+{
+  const SizeValueType blockSize = Self::BlockSize;
+  IndexRangeType blocks;
+  blocks[0] = 0;
+  blocks[1] = ( this->m_Y->GetSize() - 1 ) / blockSize; //range is inclusive
+  return blocks;
+}
+
+template<typename TInternalComputationValueType>
+void
+LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate<TInternalComputationValueType>
+::BeforeThreadedExecution()
+{
+  this->m_BlockDotProducts.assign( this->GetBlockRange()[1] + 1,
+                                   NumericTraits<TInternalComputationValueType>::ZeroValue() );
+}
+
+template<typename TInternalComputationValueType>
+void
+LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate<TInternalComputationValueType>
+::ThreadedExecution( const IndexRangeType & subrange,
+                     const ThreadIdType itkNotUsed(threadId) )
+{
+  const SizeValueType blockSize = Self::BlockSize;
+  const IndexValueType lastIndex = this->m_Y->GetSize() - 1;
+  for( IndexValueType block = subrange[0]; block <= subrange[1]; block++ )
+    {
+    IndexRangeType range;
+    range[0] = block * blockSize;
+    range[1] = std::min( range[0] + static_cast<IndexValueType>( blockSize ) - 1, lastIndex );
+    this->m_BlockDotProducts[block] = this->m_Associate->AxpyDotOverSubRange( range,
+      this->m_Alpha, this->m_X, this->m_Y, this->m_Z, this->m_Factors, this->m_Overwrite );
+    }
+}
+
+template<typename TInternalComputationValueType>
+void
+LimitedMemoryBFGSOptimizerv4VectorThreaderTemplate<TInternalComputationValueType>
+::AfterThreadedExecution()
+{
+  this->m_DotProduct = NumericTraits<TInternalComputationValueType>::ZeroValue();
+  for( size_t i = 0; i < this->m_BlockDotProducts.size(); i++ )
+    {
+    this->m_DotProduct += this->m_BlockDotProducts[i];
+    }
+}
+
+} // end namespace itk
+
+#endif
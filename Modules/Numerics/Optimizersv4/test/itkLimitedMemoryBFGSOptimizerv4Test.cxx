@@ -0,0 +1,332 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkLimitedMemoryBFGSOptimizerv4.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+/**
+ *  \class LimitedMemoryBFGSOptimizerv4TestRosenbrockMetric
+ *
+ *  The Rosenbrock function
+ *
+ *    f(x,y) = (1-x)^2 + 100 (y-x^2)^2
+ *
+ *  with its minimum at (1,1).
+ */
+class LimitedMemoryBFGSOptimizerv4TestRosenbrockMetric
+  : public itk::ObjectToObjectMetricBase
+{
+public:
+
+  typedef LimitedMemoryBFGSOptimizerv4TestRosenbrockMetric Self;
+  typedef itk::ObjectToObjectMetricBase                    Superclass;
+  typedef itk::SmartPointer<Self>                          Pointer;
+  typedef itk::SmartPointer<const Self>                    ConstPointer;
+  itkNewMacro( Self );
+  itkTypeMacro( LimitedMemoryBFGSOptimizerv4TestRosenbrockMetric, ObjectToObjectMetricBase );
+
+  typedef Superclass::ParametersType          ParametersType;
+  typedef Superclass::ParametersValueType     ParametersValueType;
+  typedef Superclass::DerivativeType          DerivativeType;
+  typedef Superclass::MeasureType             MeasureType;
+
+  LimitedMemoryBFGSOptimizerv4TestRosenbrockMetric()
+  {
+    m_Parameters.SetSize( 2 );
+    m_Parameters.Fill( 0 );
+  }
+
+  virtual void Initialize(void) throw ( itk::ExceptionObject ) ITK_OVERRIDE {}
+
+  virtual void GetDerivative( DerivativeType & derivative ) const ITK_OVERRIDE
+  {
+    MeasureType value;
+    GetValueAndDerivative( value, derivative );
+  }
+
+  void GetValueAndDerivative( MeasureType & value,
+                              DerivativeType & derivative ) const ITK_OVERRIDE
+  {
+    if( derivative.Size() != 2 )
+      {
+      derivative.SetSize( 2 );
+      }
+    const double x = m_Parameters[0];
+    const double y = m_Parameters[1];
+    value = ( 1 - x ) * ( 1 - x ) + 100 * ( y - x * x ) * ( y - x * x );
+
+    // The v4 optimizers expect the negated gradient.
+    derivative[0] = 2 * ( 1 - x ) + 400 * x * ( y - x * x );
+    derivative[1] = -200 * ( y - x * x );
+  }
+
+  virtual MeasureType GetValue() const ITK_OVERRIDE
+  {
+    MeasureType value;
+    DerivativeType derivative;
+    GetValueAndDerivative( value, derivative );
+    return value;
+  }
+
+  virtual void UpdateTransformParameters( const DerivativeType & update, ParametersValueType factor ) ITK_OVERRIDE
+  {
+    m_Parameters += update * factor;
+  }
+
+  virtual unsigned int GetNumberOfParameters(void) const ITK_OVERRIDE
+  {
+    return 2;
+  }
+
+  virtual bool HasLocalSupport() const ITK_OVERRIDE
+  {
+    return false;
+  }
+
+  virtual unsigned int GetNumberOfLocalParameters() const ITK_OVERRIDE
+  {
+    return 2;
+  }
+
+  virtual void SetParameters( ParametersType & parameters ) ITK_OVERRIDE
+  {
+    m_Parameters = parameters;
+  }
+
+  virtual const ParametersType & GetParameters() const ITK_OVERRIDE
+  {
+    return m_Parameters;
+  }
+
+private:
+
+  ParametersType m_Parameters;
+};
+
+/**
+ *  \class LimitedMemoryBFGSOptimizerv4TestQuadraticMetric
+ *
+ *  A large, badly conditioned quadratic function simulating a metric
+ *  working with a transform with many parameters:
+ *
+ *    f(x) = 1/2 sum_i c_i (x_i - t_i)^2 + 1/2 sum_i (x_{i+1} - x_i)^2
+ */
+class LimitedMemoryBFGSOptimizerv4TestQuadraticMetric
+  : public itk::ObjectToObjectMetricBase
+{
+public:
+
+  typedef LimitedMemoryBFGSOptimizerv4TestQuadraticMetric Self;
+  typedef itk::ObjectToObjectMetricBase                   Superclass;
+  typedef itk::SmartPointer<Self>                         Pointer;
+  typedef itk::SmartPointer<const Self>                   ConstPointer;
+  itkNewMacro( Self );
+  itkTypeMacro( LimitedMemoryBFGSOptimizerv4TestQuadraticMetric, ObjectToObjectMetricBase );
+
+  enum { NumberOfParameters = 30000 };
+
+  typedef Superclass::ParametersType          ParametersType;
+  typedef Superclass::ParametersValueType     ParametersValueType;
+  typedef Superclass::DerivativeType          DerivativeType;
+  typedef Superclass::MeasureType             MeasureType;
+
+  LimitedMemoryBFGSOptimizerv4TestQuadraticMetric()
+  {
+    m_Parameters.SetSize( NumberOfParameters );
+    m_Parameters.Fill( 0 );
+  }
+
+  virtual void Initialize(void) throw ( itk::ExceptionObject ) ITK_OVERRIDE {}
+
+  virtual void GetDerivative( DerivativeType & derivative ) const ITK_OVERRIDE
+  {
+    MeasureType value;
+    GetValueAndDerivative( value, derivative );
+  }
+
+  void GetValueAndDerivative( MeasureType & value,
+                              DerivativeType & derivative ) const ITK_OVERRIDE
+  {
+    if( derivative.Size() != NumberOfParameters )
+      {
+      derivative.SetSize( NumberOfParameters );
+      }
+    value = 0.0;
+    for( unsigned int i = 0; i < NumberOfParameters; i++ )
+      {
+      const double c = 1 + 20 * ( i % 3 );
+      const double r = m_Parameters[i] - std::sin( 0.01 * i );
+      value += 0.5 * c * r * r;
+      derivative[i] = -c * r;
+      }
+    for( unsigned int i = 0; i + 1 < NumberOfParameters; i++ )
+      {
+      const double d = m_Parameters[i + 1] - m_Parameters[i];
+      value += 0.5 * d * d;
+      derivative[i] += d;
+      derivative[i + 1] -= d;
+      }
+  }
+
+  virtual MeasureType GetValue() const ITK_OVERRIDE
+  {
+    MeasureType value;
+    DerivativeType derivative;
+    GetValueAndDerivative( value, derivative );
+    return value;
+  }
+
+  virtual void UpdateTransformParameters( const DerivativeType & update, ParametersValueType factor ) ITK_OVERRIDE
+  {
+    m_Parameters += update * factor;
+  }
+
+  virtual unsigned int GetNumberOfParameters(void) const ITK_OVERRIDE
+  {
+    return NumberOfParameters;
+  }
+
+  virtual bool HasLocalSupport() const ITK_OVERRIDE
+  {
+    return false;
+  }
+
+  virtual unsigned int GetNumberOfLocalParameters() const ITK_OVERRIDE
+  {
+    return 3;
+  }
+
+  virtual void SetParameters( ParametersType & parameters ) ITK_OVERRIDE
+  {
+    m_Parameters = parameters;
+  }
+
+  virtual const ParametersType & GetParameters() const ITK_OVERRIDE
+  {
+    return m_Parameters;
+  }
+
+private:
+
+  ParametersType m_Parameters;
+};
+
+///////////////////////////////////////////////////////////
+int itkLimitedMemoryBFGSOptimizerv4Test(int, char* [] )
+{
+  typedef itk::LimitedMemoryBFGSOptimizerv4 OptimizerType;
+
+  OptimizerType::Pointer optimizer = OptimizerType::New();
+
+  EXERCISE_BASIC_OBJECT_METHODS( optimizer, LimitedMemoryBFGSOptimizerv4Template,
+    GradientDescentOptimizerv4Template );
+
+  TEST_SET_GET_VALUE( 5, optimizer->GetNumberOfCorrections() );
+  optimizer->SetNumberOfCorrections( 7 );
+  TEST_SET_GET_VALUE( 7, optimizer->GetNumberOfCorrections() );
+  optimizer->SetGradientConvergenceTolerance( 1e-8 );
+  TEST_SET_GET_VALUE( 1e-8, optimizer->GetGradientConvergenceTolerance() );
+  optimizer->SetMaximumNumberOfLineSearchEvaluations( 30 );
+  TEST_SET_GET_VALUE( 30, optimizer->GetMaximumNumberOfLineSearchEvaluations() );
+  TEST_SET_GET_VALUE( 10000, optimizer->GetMinimumNumberOfParametersForThreading() );
+
+  // The Rosenbrock function exercises the line search and the corrections.
+  LimitedMemoryBFGSOptimizerv4TestRosenbrockMetric::Pointer rosenbrock =
+    LimitedMemoryBFGSOptimizerv4TestRosenbrockMetric::New();
+  OptimizerType::ParametersType initialPosition( 2 );
+  initialPosition[0] = -1.2;
+  initialPosition[1] = 1.0;
+  rosenbrock->SetParameters( initialPosition );
+
+  optimizer->SetMetric( rosenbrock );
+  optimizer->SetNumberOfIterations( 200 );
+  optimizer->SetLearningRate( 1e-3 );
+
+  TRY_EXPECT_NO_EXCEPTION( optimizer->StartOptimization() );
+
+  std::cout << "Rosenbrock: " << rosenbrock->GetParameters() << " after "
+            << optimizer->GetCurrentIteration() << " iterations. "
+            << optimizer->GetStopConditionDescription() << std::endl;
+
+  TEST_EXPECT_EQUAL( optimizer->GetStopCondition(), OptimizerType::GRADIENT_MAGNITUDE_TOLEARANCE );
+  for( unsigned int i = 0; i < 2; i++ )
+    {
+    if( itk::Math::abs( rosenbrock->GetParameters()[i] - 1.0 ) > 1e-6 )
+      {
+      std::cerr << "Test failed: the Rosenbrock minimum was not found." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // A large problem runs the vector operations over threads. The result
+  // must not depend on the number of threads, with or without scales, down
+  // to the last bit.
+  typedef LimitedMemoryBFGSOptimizerv4TestQuadraticMetric QuadraticMetricType;
+  for( unsigned int useScales = 0; useScales < 2; useScales++ )
+    {
+    QuadraticMetricType::ParametersType results[3];
+    const itk::ThreadIdType numberOfThreads[3] = { 1, 3, 4 };
+    for( unsigned int t = 0; t < 3; t++ )
+      {
+      QuadraticMetricType::Pointer quadratic = QuadraticMetricType::New();
+
+      OptimizerType::Pointer largeOptimizer = OptimizerType::New();
+      largeOptimizer->SetMetric( quadratic );
+      largeOptimizer->SetNumberOfIterations( 500 );
+      largeOptimizer->SetLearningRate( 0.02 );
+      largeOptimizer->SetGradientConvergenceTolerance( 1e-6 );
+      largeOptimizer->SetNumberOfThreads( numberOfThreads[t] );
+      largeOptimizer->SetMinimumNumberOfParametersForThreading( 1000 );
+      TEST_SET_GET_VALUE( 1000, largeOptimizer->GetMinimumNumberOfParametersForThreading() );
+      if( useScales )
+        {
+        OptimizerType::ScalesType scales( quadratic->GetNumberOfLocalParameters() );
+        scales[0] = 1.0;
+        scales[1] = 20.0;
+        scales[2] = 40.0;
+        largeOptimizer->SetScales( scales );
+        }
+
+      TRY_EXPECT_NO_EXCEPTION( largeOptimizer->StartOptimization() );
+
+      std::cout << "Quadratic, " << numberOfThreads[t] << " threads, scales " << useScales
+                << ": " << largeOptimizer->GetCurrentIteration() << " iterations. "
+                << largeOptimizer->GetStopConditionDescription() << std::endl;
+
+      TEST_EXPECT_EQUAL( largeOptimizer->GetStopCondition(), OptimizerType::GRADIENT_MAGNITUDE_TOLEARANCE );
+      results[t] = quadratic->GetParameters();
+      }
+
+    for( unsigned int t = 1; t < 3; t++ )
+      {
+      for( unsigned int i = 0; i < QuadraticMetricType::NumberOfParameters; i++ )
+        {
+        if( itk::Math::NotExactlyEquals( results[0][i], results[t][i] ) )
+          {
+          std::cerr << "Test failed: results differ with " << numberOfThreads[t]
+                    << " threads at parameter " << i << ": " << results[0][i] << " != "
+                    << results[t][i] << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
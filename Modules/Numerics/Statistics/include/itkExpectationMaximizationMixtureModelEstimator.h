@@ -21,6 +21,8 @@
 #include "itkMixtureModelComponentBase.h"
 #include "itkGaussianMembershipFunction.h"
 #include "itkSimpleDataObjectDecorator.h"
+#include "itkMultiThreader.h"
+#include "itkSampleThreadRange.h"
 
 namespace itk
 {
@@ -42,6 +44,14 @@ namespace Statistics
  * required. The EM procedure terminates when the current iteration
  * reaches the maximum iteration or the model parameters converge.
  *
+ * The expectation step splits the measurement vectors among
+ * NumberOfThreads threads. Each thread visits its measurement vectors
+ * through its own SampleRangeConstIterator, so that samples which do not
+ * support concurrent calls of GetMeasurementVector(), like the adaptors
+ * of images, can be estimated too. The threads accumulate the sums of the
+ * weights of the components needed by the proportions. The components
+ * update their parameters with the same number of threads.
+ *
  * <b>Recent API changes:</b>
  * The static const macro to get the length of a measurement vector,
  * \c MeasurementVectorSize  has been removed to allow the length of a measurement
@@ -144,6 +154,12 @@ public:
     return m_CurrentIteration;
   }
 
+  /** Set/Gets the number of threads of the expectation step and of the
+   * updates of the components. Defaults to the global default number of
+   * threads. */
+  itkSetClampMacro(NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfThreads, ThreadIdType);
+
   /** Adds a new component (or class). */
   int AddComponent(ComponentType *component);
 
@@ -184,6 +200,20 @@ protected:
   void GenerateData();
 
 private:
+  struct CalculateDensitiesStruct
+  {
+    Self                                 *Estimator;
+    std::vector< std::vector< double > >  ComponentFrequencies;
+  };
+
+  static ITK_THREAD_RETURN_TYPE CalculateDensitiesThreaderCallback(void *arg);
+
+  /** Computes the weights of the components for the measurement vectors
+   * of a range of instance identifiers, and adds the sums of the weights
+   * multiplied by the frequencies */
+  void CalculateDensities(SizeValueType beginIndex, SizeValueType endIndex,
+                          std::vector< double > & componentFrequencies);
+
   /** Target data sample pointer*/
   const TSample *m_Sample;
 
@@ -195,6 +225,12 @@ private:
   ProportionVectorType m_InitialProportions;
   ProportionVectorType m_Proportions;
 
+  /** Sums of the weights of the components multiplied by the
+   * frequencies, computed by CalculateDensities() */
+  std::vector< double > m_ComponentFrequencies;
+
+  ThreadIdType m_NumberOfThreads;
+
   MembershipFunctionVectorObjectPointer  m_MembershipFunctionsObject;
   MembershipFunctionsWeightsArrayPointer m_MembershipFunctionsWeightArrayObject;
 };  // end of class
@@ -33,6 +33,7 @@ ExpectationMaximizationMixtureModelEstimator< TSample >
   m_MaxIteration(100),
   m_CurrentIteration(0),
   m_TerminationCode(NOT_CONVERGED),
+  m_NumberOfThreads(MultiThreader::GetGlobalDefaultNumberOfThreads()),
   m_MembershipFunctionsObject           (MembershipFunctionVectorObjectType::New()),
   m_MembershipFunctionsWeightArrayObject(MembershipFunctionsWeightsArrayObjectType::New())
 {
@@ -61,6 +62,8 @@ ExpectationMaximizationMixtureModelEstimator< TSample >
      << this->GetInitialProportions() << std::endl;
   os << indent << "Proportions: "
      << this->GetProportions() << std::endl;
+  os << indent << "Number Of Threads: "
+     << this->GetNumberOfThreads() << std::endl;
   os << indent << "Calculated Expectation: " << this->CalculateExpectation() << std::endl;
 }
 
@@ -174,12 +177,79 @@ ExpectationMaximizationMixtureModelEstimator< TSample >
     return false;
     }
 
+  const size_t        numberOfComponents = m_ComponentVector.size();
+  const SizeValueType numberOfMeasurementVectors = m_Sample->Size();
+
+  ThreadIdType numberOfThreads = m_NumberOfThreads;
+  if ( numberOfMeasurementVectors < numberOfThreads )
+    {
+    numberOfThreads = std::max( static_cast< ThreadIdType >( numberOfMeasurementVectors ),
+                                static_cast< ThreadIdType >( 1 ) );
+    }
+
+  CalculateDensitiesStruct str;
+  str.Estimator = this;
+  str.ComponentFrequencies.resize( numberOfThreads, std::vector< double >(numberOfComponents, 0.0) );
+
+  if ( numberOfThreads > 1 )
+    {
+    MultiThreader::Pointer multiThreader = MultiThreader::New();
+    multiThreader->SetNumberOfThreads(numberOfThreads);
+    multiThreader->SetSingleMethod(Self::CalculateDensitiesThreaderCallback, &str);
+    multiThreader->SingleMethodExecute();
+    }
+  else
+    {
+    this->CalculateDensities(0, numberOfMeasurementVectors, str.ComponentFrequencies[0]);
+    }
+
+  // Sum the contributions of the threads in order, for the results to
+  // not depend on their scheduling
+  m_ComponentFrequencies.assign(numberOfComponents, 0.0);
+  for ( ThreadIdType threadId = 0; threadId < numberOfThreads; ++threadId )
+    {
+    for ( size_t componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex )
+      {
+      m_ComponentFrequencies[componentIndex] += str.ComponentFrequencies[threadId][componentIndex];
+      }
+    }
+
+  return true;
+}
+
+template< typename TSample >
+ITK_THREAD_RETURN_TYPE
+ExpectationMaximizationMixtureModelEstimator< TSample >
+::CalculateDensitiesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  CalculateDensitiesStruct *       str = static_cast< CalculateDensitiesStruct * >( info->UserData );
+
+  const ThreadIdType  threadId = info->ThreadID;
+  const ThreadIdType  numberOfThreads = info->NumberOfThreads;
+  const SizeValueType numberOfMeasurementVectors = str->Estimator->m_Sample->Size();
+
+  SizeValueType beginIndex;
+  SizeValueType endIndex;
+  GetThreadRange(numberOfMeasurementVectors, threadId, numberOfThreads, beginIndex, endIndex);
+
+  str->Estimator->CalculateDensities(beginIndex, endIndex, str->ComponentFrequencies[threadId]);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TSample >
+void
+ExpectationMaximizationMixtureModelEstimator< TSample >
+::CalculateDensities(SizeValueType beginIndex, SizeValueType endIndex,
+                     std::vector< double > & componentFrequencies)
+{
   double                temp;
   size_t                numberOfComponents = m_ComponentVector.size();
   std::vector< double > tempWeights(numberOfComponents, 0. );
 
-  typename TSample::ConstIterator iter = m_Sample->Begin();
-  typename TSample::ConstIterator last = m_Sample->End();
+  SampleRangeConstIterator< TSample > iter(m_Sample, beginIndex);
+
   // Note: The data type of componentIndex shoub be unsigned int
   //       because itk::Array only supports 'unsigned int' number of elements.
   unsigned int componentIndex;
@@ -192,9 +262,9 @@ ExpectationMaximizationMixtureModelEstimator< TSample >
   double densitySum;
   double minDouble = NumericTraits<double>::epsilon();
 
-  SizeValueType measurementVectorIndex = 0;
-
-  while ( iter != last )
+  for ( SizeValueType measurementVectorIndex = beginIndex;
+        measurementVectorIndex < endIndex;
+        ++measurementVectorIndex, ++iter )
     {
     mvector = iter.GetMeasurementVector();
     frequency = iter.GetFrequency();
@@ -223,6 +293,7 @@ ExpectationMaximizationMixtureModelEstimator< TSample >
           }
         m_ComponentVector[static_cast<unsigned int>(componentIndex)]->SetWeight(measurementVectorIndex,
                                                      temp);
+        componentFrequencies[componentIndex] += temp * static_cast< double >( frequency );
         }
       }
     else
@@ -234,12 +305,7 @@ ExpectationMaximizationMixtureModelEstimator< TSample >
                                                      minDouble);
         }
       }
-
-    ++iter;
-    ++measurementVectorIndex;
     }
-
-  return true;
 }
 
 template< typename TSample >
@@ -320,25 +386,20 @@ ExpectationMaximizationMixtureModelEstimator< TSample >
 ::UpdateProportions()
 {
   size_t numberOfComponents = m_ComponentVector.size();
-  size_t sampleSize = m_Sample->Size();
   double totalFrequency = static_cast< double >( m_Sample->GetTotalFrequency() );
-  size_t   i, j;
+  size_t i;
   double tempSum;
   bool   updated = false;
 
+  // The sums of the weights multiplied by the frequencies are computed
+  // with the weights by CalculateDensities()
   for ( i = 0; i < numberOfComponents; ++i )
     {
     tempSum = 0.;
 
     if( totalFrequency > NumericTraits<double>::epsilon() )
       {
-      for ( j = 0; j < sampleSize; ++j )
-        {
-        tempSum += ( m_ComponentVector[static_cast<unsigned int>( i )]->GetWeight(static_cast<unsigned int>( j ))
-                     * m_Sample->GetFrequency(static_cast<unsigned int>( j )) );
-        }
-
-      tempSum /= totalFrequency;
+      tempSum = m_ComponentFrequencies[i] / totalFrequency;
       }
 
     if ( Math::NotAlmostEquals( tempSum, m_Proportions[static_cast<unsigned int>( i )] ) )
@@ -358,6 +419,11 @@ ExpectationMaximizationMixtureModelEstimator< TSample >
 {
   m_Proportions = m_InitialProportions;
 
+  for ( size_t componentIndex = 0; componentIndex < m_ComponentVector.size(); ++componentIndex )
+    {
+    m_ComponentVector[componentIndex]->SetNumberOfThreads(m_NumberOfThreads);
+    }
+
   int iteration = 0;
   m_CurrentIteration = 0;
   while ( iteration < m_MaxIteration )
@@ -33,7 +33,10 @@ namespace Statistics
  * ExpectationMaximizationMixtureModelEstimator.
  *
  * On every iteration of EM estimation, this class's GenerateData
- * method is called to compute the new distribution parameters.
+ * method is called to compute the new distribution parameters. The
+ * weighted mean and covariance are computed by a
+ * WeightedCovarianceSampleFilter with the number of threads of the
+ * component.
  *
  * <b>Recent API changes:</b>
  * The static const macro to get the length of a measurement vector,
@@ -108,8 +111,6 @@ private:
 
   typename CovarianceEstimatorType::MatrixType m_Covariance;
 
-  typename MeanEstimatorType::Pointer m_MeanEstimator;
-
   typename CovarianceEstimatorType::Pointer m_CovarianceEstimator;
 };  // end of class
 } // end of namespace Statistics
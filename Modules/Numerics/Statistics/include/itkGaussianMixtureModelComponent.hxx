@@ -31,7 +31,6 @@ template< typename TSample >
 GaussianMixtureModelComponent< TSample >
 ::GaussianMixtureModelComponent()
 {
-  m_MeanEstimator = MeanEstimatorType::New();
   m_CovarianceEstimator = CovarianceEstimatorType::New();
   m_GaussianMembershipFunction = NativeMembershipFunctionType::New();
   this->SetMembershipFunction( (MembershipFunctionType *)
@@ -49,7 +48,6 @@ GaussianMixtureModelComponent< TSample >
 
   os << indent << "Mean: " << m_Mean << std::endl;
   os << indent << "Covariance: " << m_Covariance << std::endl;
-  os << indent << "Mean Estimator: " << m_MeanEstimator << std::endl;
   os << indent << "Covariance Estimator: " << m_CovarianceEstimator << std::endl;
   os << indent << "GaussianMembershipFunction: " << m_GaussianMembershipFunction << std::endl;
 }
@@ -61,7 +59,6 @@ GaussianMixtureModelComponent< TSample >
 {
   Superclass::SetSample(sample);
 
-  m_MeanEstimator->SetInput(sample);
   m_CovarianceEstimator->SetInput(sample);
 
   const MeasurementVectorSizeType measurementVectorLength =
@@ -152,7 +149,7 @@ GaussianMixtureModelComponent< TSample >
   unsigned int i, j;
 
   typename MeanVectorType::MeasurementVectorType meanEstimate =
-    m_MeanEstimator->GetMean();
+    m_CovarianceEstimator->GetMean();
 
   CovarianceMatrixType covEstimateDecoratedObject = m_CovarianceEstimator->GetOutput();
   typename CovarianceMatrixType::MeasurementVectorType covEstimate =  covEstimateDecoratedObject->et();
@@ -194,20 +191,10 @@ GaussianMixtureModelComponent< TSample >
 
   const WeightArrayType & weights = this->GetWeights();
 
-  typename TSample::ConstIterator iter = this->GetSample()->Begin();
-  typename TSample::ConstIterator end =  this->GetSample()->End();
-
-  typename TSample::MeasurementVectorType measurements;
-
-  // why these lines???
-  while ( iter != end )
-    {
-    measurements = iter.GetMeasurementVector();
-    ++iter;
-    }
-
-  m_MeanEstimator->SetWeights(weights);
-  m_MeanEstimator->Update();
+  // The covariance estimator computes the weighted mean too
+  m_CovarianceEstimator->SetWeights(weights);
+  m_CovarianceEstimator->SetNumberOfThreads( this->GetNumberOfThreads() );
+  m_CovarianceEstimator->Update();
 
   MeasurementVectorSizeType   i, j;
   double         temp;
@@ -216,7 +203,7 @@ GaussianMixtureModelComponent< TSample >
   ParametersType parameters = this->GetFullParameters();
   MeasurementVectorSizeType            paramIndex  = 0;
 
-  typename MeanEstimatorType::MeasurementVectorType meanEstimate = m_MeanEstimator->GetMean();
+  typename MeanEstimatorType::MeasurementVectorType meanEstimate = m_CovarianceEstimator->GetMean();
   for ( i = 0; i < measurementVectorSize; i++ )
     {
     changes = itk::Math::abs( m_Mean[i] - meanEstimate[i] );
@@ -242,8 +229,6 @@ GaussianMixtureModelComponent< TSample >
     paramIndex = measurementVectorSize;
     }
 
-  m_CovarianceEstimator->SetWeights(weights);
-  m_CovarianceEstimator->Update();
   typename CovarianceEstimatorType::MatrixType covEstimate =
     m_CovarianceEstimator->GetCovarianceMatrix();
 
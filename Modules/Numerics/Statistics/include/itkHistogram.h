@@ -52,6 +52,10 @@ namespace Statistics
  * for regularly spaced bins to defined.  To define irregularly sized
  * bins, use the SetBinMin()/SetBinMax() methods.
  *
+ * When the bins of a dimension are regularly spaced by Initialize(), the
+ * bin of a measurement is computed in constant time by GetIndex(), instead
+ * of being searched among the bins.
+ *
  * If you do not know the length of the measurement vector at compile time, you
  * should use the VariableDimensionHistogram class, instead of the Histogram
  * class.
@@ -149,7 +153,9 @@ public:
 
   /** Get the index of histogram corresponding to the specified
    *  measurement value. Returns true if index is valid and false if
-   *  the measurement is outside the histogram */
+   *  the measurement is outside the histogram. The bins regularly spaced by
+   *  Initialize() are found in constant time, the other ones with a binary
+   *  search. */
   bool GetIndex(const MeasurementVectorType & measurement,
                 IndexType & index) const;
 
@@ -509,6 +515,10 @@ private:
   // upper bound of each bin
   std::vector< std::vector< MeasurementType > > m_Max;
 
+  // number of bins per unit of measurement in each dimension, when the bins
+  // are regularly spaced by Initialize(), or 0 otherwise
+  std::vector< double > m_UniformBinsScale;
+
   mutable MeasurementVectorType m_TempMeasurementVector;
   mutable IndexType             m_TempIndex;
 
@@ -103,6 +103,7 @@ Histogram< TMeasurement, TFrequencyContainer >
             MeasurementType min)
 {
   m_Min[dimension][nbin] = min;
+  m_UniformBinsScale[dimension] = 0.0;
 }
 
 template< typename TMeasurement, typename TFrequencyContainer >
@@ -112,6 +113,7 @@ Histogram< TMeasurement, TFrequencyContainer >
             MeasurementType max)
 {
   m_Max[dimension][nbin] = max;
+  m_UniformBinsScale[dimension] = 0.0;
 }
 
 template< typename TMeasurement, typename TFrequencyContainer >
@@ -218,6 +220,9 @@ Histogram< TMeasurement, TFrequencyContainer >
     m_Max[dim].resize(m_Size[dim]);
     }
 
+  // the bins are searched until they are regularly spaced
+  m_UniformBinsScale.assign(this->GetMeasurementVectorSize(), 0.0);
+
   // initialize auxiliary variables
   this->m_TempIndex.SetSize( this->GetMeasurementVectorSize() );
   this->m_TempMeasurementVector.SetSize( this->GetMeasurementVectorSize() );
@@ -264,6 +269,13 @@ Histogram< TMeasurement, TFrequencyContainer >
                                           + ( ( (float)size[i] - 1 ) * interval ) ) );
       this->SetBinMax( i, size[i] - 1,
                        (MeasurementType)( upperBound[i] ) );
+
+      // the bins are regularly spaced: GetIndex() can compute them
+      if ( this->GetBinMin(i, 0) < this->GetBinMax(i, size[i] - 1) )
+        {
+        m_UniformBinsScale[i] = size[i] / ( static_cast< double >( this->GetBinMax(i, size[i] - 1) )
+                                            - static_cast< double >( this->GetBinMin(i, 0) ) );
+        }
       }
     }
 }
@@ -327,6 +339,31 @@ bool Histogram< TMeasurement, TFrequencyContainer >
         }
       }
 
+    // Compute the bin of regularly spaced bins, and check it against the
+    // bounds of the bins, which are rounded to MeasurementType
+    if ( m_UniformBinsScale[dim] > 0.0 )
+      {
+      const double position = ( static_cast< double >( tempMeasurement ) - static_cast< double >( m_Min[dim][0] ) )
+                              * m_UniformBinsScale[dim];
+      if ( position >= 0.0 && position < static_cast< double >( end + 1 ) )
+        {
+        mid = static_cast< IndexValueType >( position );
+        while ( mid > 0 && tempMeasurement < m_Min[dim][mid] )
+          {
+          --mid;
+          }
+        while ( mid < end && tempMeasurement >= m_Max[dim][mid] )
+          {
+          ++mid;
+          }
+        if ( tempMeasurement >= m_Min[dim][mid] && tempMeasurement < m_Max[dim][mid] )
+          {
+          index[dim] = mid;
+          continue;
+          }
+        }
+      }
+
     // Binary search for the bin where this measurement could be
     mid = ( end + 1 ) / 2;
     median = m_Min[dim][mid];
@@ -764,6 +801,7 @@ Histogram< TMeasurement, TFrequencyContainer >
     this->m_NumberOfInstances     = that->m_NumberOfInstances;
     this->m_Min                   = that->m_Min;
     this->m_Max                   = that->m_Max;
+    this->m_UniformBinsScale      = that->m_UniformBinsScale;
     this->m_TempMeasurementVector = that->m_TempMeasurementVector;
     this->m_TempIndex             = that->m_TempIndex;
     this->m_ClipBinsAtEnds        = that->m_ClipBinsAtEnds;
@@ -36,6 +36,9 @@ namespace Statistics
  *  an histogram from an image. Internally it creates a List that is feed into
  *  the SampleToHistogramFilter.
  *
+ *  Each thread fills its own histogram, and the histograms of the threads are
+ *  then merged two by two by the threads.
+ *
  * \ingroup ITKStatistics
  */
 
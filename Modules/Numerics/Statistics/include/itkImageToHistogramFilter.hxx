@@ -225,6 +225,30 @@ ImageToHistogramFilter< TImage >
 
   // now fill the histograms
   this->ThreadedComputeHistogram( inputRegionForThread, threadId, progress );
+
+  // and merge them two by two, in parallel: at each step, the histograms
+  // of the threads which are a multiple of twice the step get the
+  // frequencies of the histograms step threads after them. All the
+  // histograms have the same bins, so their frequencies are merged by
+  // instance identifier.
+  const ThreadIdType numberOfHistograms = static_cast< ThreadIdType >( m_Histograms.size() );
+  for ( ThreadIdType step = 1; step < numberOfHistograms; step *= 2 )
+    {
+    m_Barrier->Wait();
+    if ( threadId % ( 2 * step ) == 0 && threadId + step < numberOfHistograms )
+      {
+      const HistogramType *other = m_Histograms[threadId + step];
+      const typename HistogramType::InstanceIdentifier numberOfBins = hist->Size();
+      for ( typename HistogramType::InstanceIdentifier id = 0; id < numberOfBins; ++id )
+        {
+        const typename HistogramType::AbsoluteFrequencyType frequency = other->GetFrequency(id);
+        if ( frequency != 0 )
+          {
+          hist->IncreaseFrequency( id, frequency );
+          }
+        }
+      }
+    }
 }
 
 
@@ -233,24 +257,8 @@ void
 ImageToHistogramFilter< TImage >
 ::AfterThreadedGenerateData()
 {
-  // group the results in the output histogram
-  HistogramType * hist = m_Histograms[0];
-  typename HistogramType::IndexType index;
-  for( unsigned int i=1; i<m_Histograms.size(); i++ )
-    {
-    typedef typename HistogramType::ConstIterator         HistogramIterator;
-
-    HistogramIterator hit = m_Histograms[i]->Begin();
-    HistogramIterator end = m_Histograms[i]->End();
-    while ( hit != end )
-      {
-      hist->GetIndex( hit.GetMeasurementVector(), index);
-      hist->IncreaseFrequencyOfIndex( index, hit.GetFrequency() );
-      ++hit;
-      }
-    }
-
-  // and drop the temporary histograms
+  // the histograms of the threads have been merged in the output
+  // histogram by the threads: drop the temporary histograms
   m_Histograms.clear();
   m_Minimums.clear();
   m_Maximums.clear();
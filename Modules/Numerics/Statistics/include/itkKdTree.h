@@ -29,6 +29,8 @@
 #include "itkSubsample.h"
 
 #include "itkEuclideanDistanceMetric.h"
+#include "itkMultiThreader.h"
+#include "itkAtomicInt.h"
 
 namespace itk
 {
@@ -467,6 +469,16 @@ private:
  * GetSearchResult method returns a pointer to a NearestNeighbors object
  * with k-nearest neighbors.
  *
+ * The searches walk a compact copy of the tree, made when the root or the
+ * sample is set: the nodes are stored in an array, in depth first order,
+ * and the measurement vectors they hold are copied in contiguous memory,
+ * in the same order. The searches thus neither follow the pointers of the
+ * nodes nor call the sample, and several searches can run concurrently,
+ * whatever the sample. The copy doubles the memory used by the
+ * measurements, and goes stale if the sample is modified: the tree must
+ * then be generated again. The Search methods that take a vector of query
+ * points search them with NumberOfThreads threads.
+ *
  * <b>Recent API changes:</b>
  * The static const macro to get the length of a measurement vector,
  * 'MeasurementVectorSize'  has been removed to allow the length of a measurement
@@ -607,7 +619,11 @@ public:
   void SetBucketSize( unsigned int );
 
   /** Sets the input sample that provides the measurement vectors to the k-d
-   * tree */
+   * tree. When the root is already set, the measurement vectors are copied
+   * into the compact tree used by the searches. This copy takes as much
+   * memory as the measurements of the sample, and is not updated when the
+   * sample is modified afterwards: the tree must then be generated again,
+   * or the sample set again. */
   void SetSample( const TSample * );
 
   /** Returns the pointer to the input sample */
@@ -631,7 +647,11 @@ public:
   }
 
   /** Sets the root node of the KdTree that is a result of
-   * KdTreeGenerator or WeightedCentroidKdTreeGenerator. */
+   * KdTreeGenerator or WeightedCentroidKdTreeGenerator. The searches use
+   * a copy of the tree made here, which duplicates the measurement vectors
+   * of the sample. Neither the nodes nor the measurement vectors of the
+   * sample must be modified afterwards, since the copy would not see the
+   * changes. */
   void SetRoot(KdTreeNodeType *root)
   {
     if ( this->m_Root )
@@ -639,6 +659,7 @@ public:
       this->DeleteNode( this->m_Root );
       }
     this->m_Root = root;
+    this->BuildCompactTree();
   }
 
   /** Returns the pointer to the root node. */
@@ -662,7 +683,10 @@ public:
     return m_Sample->GetFrequency( id );
   }
 
-  /** Get the pointer to the distance metric. */
+  /** Get the pointer to the distance metric. The searches compute the
+   * squared Euclidean distance on the compact tree directly, and do not
+   * call this metric: changing its parameters has no effect on them. It
+   * is only used by BallWithinBounds() and BoundsOverlapBall(). */
   DistanceMetricType * GetDistanceMetric()
   {
     return m_DistanceMetric.GetPointer();
@@ -682,6 +706,25 @@ public:
   void Search( const MeasurementVectorType &, double,
     InstanceIdentifierVectorType & ) const;
 
+  /** Searches the k-nearest neighbors of each query point of a batch,
+   * with multiple threads. The neighbors of the i-th query point and
+   * their distances are stored in the i-th elements of the result and
+   * distance vectors, which reuse their memory when they are passed
+   * again. */
+  void Search( const std::vector< MeasurementVectorType > &, unsigned int,
+    std::vector< InstanceIdentifierVectorType > &,
+    std::vector< std::vector< double > > & ) const;
+
+  /** Searches the neighbors fallen into a hypersphere around each query
+   * point of a batch, with multiple threads. */
+  void Search( const std::vector< MeasurementVectorType > &, double,
+    std::vector< InstanceIdentifierVectorType > & ) const;
+
+  /** Set/Get the number of threads of the searches of batches of query
+   * points. Defaults to the global default number of threads. */
+  itkSetClampMacro( NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS );
+  itkGetConstMacro( NumberOfThreads, ThreadIdType );
+
   /** Returns true if the intermediate k-nearest neighbors exist within
    * the the bounding box defined by the lowerBound and the
    * upperBound. Otherwise returns false. Returns false if the ball
@@ -725,19 +768,102 @@ protected:
 
   virtual void PrintSelf( std::ostream & os, Indent indent ) const ITK_OVERRIDE;
 
-  /** search loop */
+#if ! defined ( ITK_FUTURE_LEGACY_REMOVE )
+  /** \deprecated
+   * k-nearest neighbor search loop on the nodes of the tree, with the
+   * distance metric. The searches no longer call it: they walk the
+   * compact copy of the tree. It is kept for the subclasses that call
+   * it. */
   int NearestNeighborSearchLoop( const KdTreeNodeType *,
     const MeasurementVectorType &, MeasurementVectorType &,
     MeasurementVectorType &, NearestNeighbors & ) const;
 
-  /** search loop */
+  /** \deprecated
+   * Hypersphere search loop on the nodes of the tree, with the distance
+   * metric. The searches no longer call it: they walk the compact copy
+   * of the tree. It is kept for the subclasses that call it. */
   int SearchLoop( const KdTreeNodeType *, const MeasurementVectorType &,
     double, MeasurementVectorType &, MeasurementVectorType &,
     InstanceIdentifierVectorType & ) const;
+#endif
 
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(KdTree);
 
+  /** Node of the compact copy of the tree. The left child of a
+   * nonterminal node follows it in the array of nodes. The measurement
+   * vectors of a node, the median of a nonterminal node or the bucket of
+   * a terminal node, are between Begin and End in the compact arrays. */
+  struct CompactNode
+  {
+    bool            IsTerminal;
+    unsigned int    PartitionDimension;
+    MeasurementType PartitionValue;
+    SizeValueType   Begin;
+    SizeValueType   End;
+    SizeValueType   Right;
+  };
+
+  /** State of a search: the bounds of the current node and the neighbors
+   * found. A k-nearest neighbor search keeps the squared distances of
+   * the neighbors, and the squared radius is that of the farthest one.
+   * A hypersphere search appends the neighbors to a vector. */
+  struct SearchState
+  {
+    const MeasurementVectorType  *Query;
+    std::vector< double >         LowerBound;
+    std::vector< double >         UpperBound;
+    double                        SquaredRadius;
+    unsigned int                  NumberOfNeighbors;
+    unsigned int                  FarthestNeighbor;
+    InstanceIdentifier           *Identifiers;
+    double                       *SquaredDistances;
+    InstanceIdentifierVectorType *Neighbors;
+  };
+
+  struct BatchSearchStruct
+  {
+    const Self                                   *Tree;
+    const std::vector< MeasurementVectorType >   *Queries;
+    unsigned int                                  NumberOfNeighbors;
+    double                                        Radius;
+    std::vector< InstanceIdentifierVectorType >  *Results;
+    std::vector< std::vector< double > >         *Distances;
+    AtomicInt< SizeValueType >                    NextQuery;
+  };
+
+  static ITK_THREAD_RETURN_TYPE BatchSearchThreaderCallback( void *arg );
+
+  /** Copies the tree and the measurement vectors of its nodes into the
+   * compact arrays. */
+  void BuildCompactTree();
+
+  void AppendCompactNode( const KdTreeNodeType * );
+
+  /** Starts a search from the root, with infinite bounds. */
+  void ResetSearchState( SearchState &, const MeasurementVectorType & ) const;
+
+  /** Searches the k-nearest neighbors of a query point, and stores their
+   * identifiers and distances in the arrays of size k. */
+  void SearchNearestNeighbors( SearchState &, const MeasurementVectorType &,
+    unsigned int, InstanceIdentifier *, double * ) const;
+
+  /** Searches the neighbors of a query point within a radius, and appends
+   * their identifiers to the result. */
+  void SearchNeighborsWithinRadius( SearchState &, const MeasurementVectorType &,
+    double, InstanceIdentifierVectorType & ) const;
+
+  /** Searches the compact subtree of a node. Returns true when the search
+   * is over. */
+  bool CompactSearchLoop( SizeValueType, SearchState & ) const;
+
+  inline double CompactSquaredDistance( const MeasurementVectorType &,
+    SizeValueType ) const;
+
+  inline bool CompactBallWithinBounds( const SearchState & ) const;
+
+  inline bool CompactBoundsOverlapBall( const SearchState & ) const;
+
   /** Pointer to the input sample */
   const TSample *m_Sample;
 
@@ -755,6 +881,13 @@ private:
 
   /** Measurement vector size */
   MeasurementVectorSizeType m_MeasurementVectorSize;
+
+  /** Compact copy of the tree */
+  std::vector< CompactNode >        m_CompactNodes;
+  std::vector< MeasurementType >    m_CompactMeasurements;
+  std::vector< InstanceIdentifier > m_CompactIdentifiers;
+
+  ThreadIdType m_NumberOfThreads;
 };  // end of class
 } // end of namespace Statistics
 } // end of namespace itk
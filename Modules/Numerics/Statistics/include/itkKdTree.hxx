@@ -86,6 +86,7 @@ KdTree<TSample>
   this->m_Root = ITK_NULLPTR;
   this->m_BucketSize = 16;
   this->m_MeasurementVectorSize = 0;
+  this->m_NumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
 }
 
 template<typename TSample>
@@ -127,6 +128,7 @@ KdTree<TSample>
     }
   os << indent << "MeasurementVectorSize: "
      << this->m_MeasurementVectorSize << std::endl;
+  os << indent << "NumberOfThreads: " << this->m_NumberOfThreads << std::endl;
 }
 
 template<typename TSample>
@@ -169,9 +171,79 @@ KdTree<TSample>
   this->m_MeasurementVectorSize = this->m_Sample->GetMeasurementVectorSize();
   this->m_DistanceMetric->SetMeasurementVectorSize(
     this->m_MeasurementVectorSize );
+  this->BuildCompactTree();
   this->Modified();
 }
 
+template<typename TSample>
+void
+KdTree<TSample>
+::BuildCompactTree()
+{
+  this->m_CompactNodes.clear();
+  this->m_CompactMeasurements.clear();
+  this->m_CompactIdentifiers.clear();
+  if( this->m_Root == ITK_NULLPTR || this->m_Sample == ITK_NULLPTR )
+    {
+    return;
+    }
+
+  this->m_CompactIdentifiers.reserve( this->m_Sample->Size() );
+  this->m_CompactMeasurements.reserve( this->m_Sample->Size() *
+    this->m_MeasurementVectorSize );
+  this->AppendCompactNode( this->m_Root );
+}
+
+template<typename TSample>
+void
+KdTree<TSample>
+::AppendCompactNode( const KdTreeNodeType *node )
+{
+  const SizeValueType nodeIndex = this->m_CompactNodes.size();
+  this->m_CompactNodes.push_back( CompactNode() );
+
+  CompactNode compactNode;
+  compactNode.IsTerminal = ( node == ITK_NULLPTR || node->IsTerminal() );
+  compactNode.PartitionDimension = 0;
+  compactNode.PartitionValue = NumericTraits< MeasurementType >::ZeroValue();
+  compactNode.Begin = this->m_CompactIdentifiers.size();
+  compactNode.Right = 0;
+
+  unsigned int numberOfInstances = 0;
+  if( !compactNode.IsTerminal )
+    {
+    node->GetParameters( compactNode.PartitionDimension,
+      compactNode.PartitionValue );
+    numberOfInstances = 1;
+    }
+  else if( node != ITK_NULLPTR && node != this->m_EmptyTerminalNode )
+    {
+    numberOfInstances = node->Size();
+    }
+
+  for( unsigned int i = 0; i < numberOfInstances; ++i )
+    {
+    const InstanceIdentifier id = node->GetInstanceIdentifier( i );
+    const MeasurementVectorType & measurement =
+      this->m_Sample->GetMeasurementVector( id );
+    this->m_CompactIdentifiers.push_back( id );
+    for( unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d )
+      {
+      this->m_CompactMeasurements.push_back( measurement[d] );
+      }
+    }
+  compactNode.End = this->m_CompactIdentifiers.size();
+
+  if( !compactNode.IsTerminal )
+    {
+    this->AppendCompactNode( node->Left() );
+    compactNode.Right = this->m_CompactNodes.size();
+    this->AppendCompactNode( node->Right() );
+    }
+
+  this->m_CompactNodes[nodeIndex] = compactNode;
+}
+
 template<typename TSample>
 void
 KdTree<TSample>
@@ -206,35 +278,400 @@ KdTree<TSample>
       << "the measurement vectors." );
     }
 
-  /* 'distances' is the storage container used internally for the
-   * NearestNeighbors class.  The 'distances' vector is modified
-   * by the NearestNeighbors class.  By passing in
-   * the 'distances' vector here, we can avoid unnecessary memory
-   * duplications and copy operations.*/
-  NearestNeighbors nearestNeighbors(distances);
-  nearestNeighbors.resize( numberOfNeighborsRequested );
+  // The neighbors are searched directly in the result and distance
+  // vectors, which keep their memory from a search to the next one.
+  result.resize( numberOfNeighborsRequested );
+  distances.resize( numberOfNeighborsRequested );
+  if( numberOfNeighborsRequested == 0 )
+    {
+    return;
+    }
 
-  MeasurementVectorType lowerBound;
-  NumericTraits<MeasurementVectorType>::SetLength( lowerBound,
-    this->m_MeasurementVectorSize );
-  MeasurementVectorType upperBound;
-  NumericTraits<MeasurementVectorType>::SetLength( upperBound,
-    this->m_MeasurementVectorSize );
+  SearchState state;
+  this->SearchNearestNeighbors( state, query, numberOfNeighborsRequested,
+    &result[0], &distances[0] );
+}
 
-  for(  unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d )
+template<typename TSample>
+void
+KdTree<TSample>
+::ResetSearchState( SearchState & state,
+  const MeasurementVectorType & query ) const
+{
+  // The bounds of the root are infinite, which neither a ball within the
+  // bounds nor a ball overlapping them can reach. They are reset for each
+  // search, as a search that ends early does not restore them.
+  state.LowerBound.assign( this->m_MeasurementVectorSize,
+    -std::numeric_limits< double >::infinity() );
+  state.UpperBound.assign( this->m_MeasurementVectorSize,
+    std::numeric_limits< double >::infinity() );
+  state.Query = &query;
+}
+
+template<typename TSample>
+void
+KdTree<TSample>
+::SearchNearestNeighbors( SearchState & state,
+  const MeasurementVectorType & query, unsigned int numberOfNeighbors,
+  InstanceIdentifier *identifiers, double *distances ) const
+{
+  // The distances hold the squared distances during the search, infinite
+  // until k neighbors are found.
+  for( unsigned int i = 0; i < numberOfNeighbors; ++i )
+    {
+    identifiers[i] = NumericTraits< InstanceIdentifier >::max();
+    distances[i] = std::numeric_limits< double >::infinity();
+    }
+  this->ResetSearchState( state, query );
+  state.SquaredRadius = std::numeric_limits< double >::infinity();
+  state.NumberOfNeighbors = numberOfNeighbors;
+  state.FarthestNeighbor = 0;
+  state.Identifiers = identifiers;
+  state.SquaredDistances = distances;
+  state.Neighbors = ITK_NULLPTR;
+
+  if( !this->m_CompactNodes.empty() )
     {
-    lowerBound[d] = static_cast< MeasurementType >( -std::sqrt(
-      -static_cast< double >( NumericTraits< MeasurementType >::
-      NonpositiveMin() ) ) / 2.0 );
-    upperBound[d] = static_cast< MeasurementType >( std::sqrt(
-      static_cast<double >( NumericTraits< MeasurementType >::max() ) / 2.0 ) );
+    this->CompactSearchLoop( 0, state );
     }
-  this->NearestNeighborSearchLoop( this->m_Root, query, lowerBound, upperBound,
-    nearestNeighbors );
 
-  result = nearestNeighbors.GetNeighbors();
+  for( unsigned int i = 0; i < numberOfNeighbors; ++i )
+    {
+    distances[i] = std::sqrt( distances[i] );
+    }
 }
 
+template<typename TSample>
+inline double
+KdTree<TSample>
+::CompactSquaredDistance( const MeasurementVectorType & query,
+  SizeValueType index ) const
+{
+  const MeasurementType *measurement =
+    &this->m_CompactMeasurements[index * this->m_MeasurementVectorSize];
+
+  double sumOfSquares = 0.0;
+  for( unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d )
+    {
+    const double temp = query[d] - measurement[d];
+    sumOfSquares += temp * temp;
+    }
+  return sumOfSquares;
+}
+
+template<typename TSample>
+bool
+KdTree<TSample>
+::CompactSearchLoop( SizeValueType nodeIndex, SearchState & state ) const
+{
+  const CompactNode & node = this->m_CompactNodes[nodeIndex];
+  const MeasurementVectorType & query = *state.Query;
+
+  if( node.IsTerminal && node.Begin == node.End )
+    {
+    // empty node
+    return false;
+    }
+
+  // Check the measurement vectors of the bucket of a terminal node, or
+  // the median of a nonterminal node
+  for( SizeValueType i = node.Begin; i < node.End; ++i )
+    {
+    const double squaredDistance = this->CompactSquaredDistance( query, i );
+    if( state.Neighbors != ITK_NULLPTR )
+      {
+      if( squaredDistance <= state.SquaredRadius )
+        {
+        state.Neighbors->push_back( this->m_CompactIdentifiers[i] );
+        }
+      }
+    else if( squaredDistance < state.SquaredRadius )
+      {
+      // Replace the farthest neighbor, and find the new farthest one
+      state.Identifiers[state.FarthestNeighbor] = this->m_CompactIdentifiers[i];
+      state.SquaredDistances[state.FarthestNeighbor] = squaredDistance;
+      state.FarthestNeighbor = 0;
+      for( unsigned int j = 1; j < state.NumberOfNeighbors; ++j )
+        {
+        if( state.SquaredDistances[j] >
+          state.SquaredDistances[state.FarthestNeighbor] )
+          {
+          state.FarthestNeighbor = j;
+          }
+        }
+      state.SquaredRadius = state.SquaredDistances[state.FarthestNeighbor];
+      }
+    }
+
+  if( !node.IsTerminal )
+    {
+    const unsigned int partitionDimension = node.PartitionDimension;
+    const double       partitionValue = node.PartitionValue;
+    SizeValueType      closerChild = nodeIndex + 1;
+    SizeValueType      fartherChild = node.Right;
+    double *           closerBound = &state.UpperBound[partitionDimension];
+    double *           fartherBound = &state.LowerBound[partitionDimension];
+    if( query[partitionDimension] > node.PartitionValue )
+      {
+      std::swap( closerChild, fartherChild );
+      std::swap( closerBound, fartherBound );
+      }
+
+    // search the closer child node
+    double tempValue = *closerBound;
+    *closerBound = partitionValue;
+    if( this->CompactSearchLoop( closerChild, state ) )
+      {
+      return true;
+      }
+    *closerBound = tempValue;
+
+    // search the other node, if necessary
+    tempValue = *fartherBound;
+    *fartherBound = partitionValue;
+    if( this->CompactBoundsOverlapBall( state ) )
+      {
+      this->CompactSearchLoop( fartherChild, state );
+      }
+    *fartherBound = tempValue;
+    }
+
+  // stop or continue search
+  return this->CompactBallWithinBounds( state );
+}
+
+template<typename TSample>
+inline bool
+KdTree<TSample>
+::CompactBallWithinBounds( const SearchState & state ) const
+{
+  const MeasurementVectorType & query = *state.Query;
+  for( unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d )
+    {
+    if( itk::Math::sqr( query[d] - state.LowerBound[d] ) <= state.SquaredRadius
+      || itk::Math::sqr( query[d] - state.UpperBound[d] ) <= state.SquaredRadius )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+template<typename TSample>
+inline bool
+KdTree<TSample>
+::CompactBoundsOverlapBall( const SearchState & state ) const
+{
+  const MeasurementVectorType & query = *state.Query;
+  double sum = 0.0;
+  for( unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d )
+    {
+    if( query[d] <= state.LowerBound[d] )
+      {
+      sum += itk::Math::sqr( query[d] - state.LowerBound[d] );
+      }
+    else if( query[d] >= state.UpperBound[d] )
+      {
+      sum += itk::Math::sqr( query[d] - state.UpperBound[d] );
+      }
+    }
+  return sum <= state.SquaredRadius;
+}
+
+template<typename TSample>
+void
+KdTree<TSample>
+::Search( const std::vector< MeasurementVectorType > & queries,
+  unsigned int numberOfNeighborsRequested,
+  std::vector< InstanceIdentifierVectorType > & results,
+  std::vector< std::vector< double > > & distances ) const
+{
+  if( numberOfNeighborsRequested > this->Size() )
+    {
+    itkExceptionMacro( "The numberOfNeighborsRequested for the nearest "
+      << "neighbor search should be less than or equal to the number of "
+      << "the measurement vectors." );
+    }
+
+  results.resize( queries.size() );
+  distances.resize( queries.size() );
+
+  BatchSearchStruct str;
+  str.Tree = this;
+  str.Queries = &queries;
+  str.NumberOfNeighbors = numberOfNeighborsRequested;
+  str.Radius = 0.0;
+  str.Results = &results;
+  str.Distances = &distances;
+  str.NextQuery = 0;
+
+  MultiThreader::Pointer multiThreader = MultiThreader::New();
+  multiThreader->SetNumberOfThreads( this->m_NumberOfThreads );
+  multiThreader->SetSingleMethod( Self::BatchSearchThreaderCallback, &str );
+  multiThreader->SingleMethodExecute();
+}
+
+template<typename TSample>
+void
+KdTree<TSample>
+::Search( const std::vector< MeasurementVectorType > & queries, double radius,
+  std::vector< InstanceIdentifierVectorType > & results ) const
+{
+  results.resize( queries.size() );
+
+  BatchSearchStruct str;
+  str.Tree = this;
+  str.Queries = &queries;
+  str.NumberOfNeighbors = 0;
+  str.Radius = radius;
+  str.Results = &results;
+  str.Distances = ITK_NULLPTR;
+  str.NextQuery = 0;
+
+  MultiThreader::Pointer multiThreader = MultiThreader::New();
+  multiThreader->SetNumberOfThreads( this->m_NumberOfThreads );
+  multiThreader->SetSingleMethod( Self::BatchSearchThreaderCallback, &str );
+  multiThreader->SingleMethodExecute();
+}
+
+template<typename TSample>
+ITK_THREAD_RETURN_TYPE
+KdTree<TSample>
+::BatchSearchThreaderCallback( void *arg )
+{
+  MultiThreader::ThreadInfoStruct *info =
+    static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  BatchSearchStruct *str = static_cast< BatchSearchStruct * >( info->UserData );
+  const Self *tree = str->Tree;
+  const SizeValueType numberOfQueries = str->Queries->size();
+
+  // The threads take the query points by blocks, as their searches do not
+  // take the same time
+  const SizeValueType blockSize = 64;
+
+  SearchState state;
+  for(;;)
+    {
+    const SizeValueType begin = ( str->NextQuery += blockSize ) - blockSize;
+    if( begin >= numberOfQueries )
+      {
+      break;
+      }
+    const SizeValueType end = std::min( begin + blockSize, numberOfQueries );
+    for( SizeValueType q = begin; q < end; ++q )
+      {
+      const MeasurementVectorType & query = ( *str->Queries )[q];
+      InstanceIdentifierVectorType & result = ( *str->Results )[q];
+      if( str->Distances != ITK_NULLPTR )
+        {
+        std::vector< double > & distances = ( *str->Distances )[q];
+        result.resize( str->NumberOfNeighbors );
+        distances.resize( str->NumberOfNeighbors );
+        if( str->NumberOfNeighbors > 0 )
+          {
+          tree->SearchNearestNeighbors( state, query, str->NumberOfNeighbors,
+            &result[0], &distances[0] );
+          }
+        }
+      else
+        {
+        result.clear();
+        tree->SearchNeighborsWithinRadius( state, query, str->Radius, result );
+        }
+      }
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template<typename TSample>
+void
+KdTree<TSample>
+::Search( const MeasurementVectorType & query, double radius,
+  InstanceIdentifierVectorType & result ) const
+{
+  result.clear();
+
+  SearchState state;
+  this->SearchNeighborsWithinRadius( state, query, radius, result );
+}
+
+template<typename TSample>
+void
+KdTree<TSample>
+::SearchNeighborsWithinRadius( SearchState & state,
+  const MeasurementVectorType & query, double radius,
+  InstanceIdentifierVectorType & result ) const
+{
+  if( radius < 0.0 )
+    {
+    return;
+    }
+
+  this->ResetSearchState( state, query );
+  state.SquaredRadius = radius * radius;
+  state.NumberOfNeighbors = 0;
+  state.Identifiers = ITK_NULLPTR;
+  state.SquaredDistances = ITK_NULLPTR;
+  state.Neighbors = &result;
+
+  if( !this->m_CompactNodes.empty() )
+    {
+    this->CompactSearchLoop( 0, state );
+    }
+}
+
+template<typename TSample>
+inline bool
+KdTree<TSample>
+::BallWithinBounds( const MeasurementVectorType & query, MeasurementVectorType
+  &lowerBound, MeasurementVectorType & upperBound, double radius ) const
+{
+  for( unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d )
+    {
+    if( ( this->m_DistanceMetric->Evaluate( query[d], lowerBound[d] ) <=
+      radius ) || ( this->m_DistanceMetric->Evaluate( query[d],
+      upperBound[d] ) <= radius ) )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+template<typename TSample>
+inline bool
+KdTree<TSample>
+::BoundsOverlapBall( const MeasurementVectorType &query, MeasurementVectorType
+  &lowerBound, MeasurementVectorType &upperBound, double radius ) const
+{
+  double squaredSearchRadius = itk::Math::sqr( radius );
+
+  double sum = 0.0;
+  for( unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d )
+    {
+    if( query[d] <= lowerBound[d] )
+      {
+      sum += itk::Math::sqr( this->m_DistanceMetric->Evaluate( query[d],
+        lowerBound[d] ) );
+      if( sum < squaredSearchRadius )
+        {
+        return true;
+        }
+      }
+    else if( query[d] >= upperBound[d] )
+      {
+      sum += itk::Math::sqr( this->m_DistanceMetric->Evaluate( query[d],
+        upperBound[d] ) );
+      if( sum < squaredSearchRadius )
+        {
+        return true;
+        }
+      }
+    }
+  return false;
+}
+
+#if ! defined ( ITK_FUTURE_LEGACY_REMOVE )
 template<typename TSample>
 inline int
 KdTree<TSample>
@@ -352,33 +789,6 @@ KdTree<TSample>
   return 0;
 }
 
-template<typename TSample>
-void
-KdTree<TSample>
-::Search( const MeasurementVectorType & query, double radius,
-  InstanceIdentifierVectorType & result ) const
-{
-  MeasurementVectorType lowerBound;
-  MeasurementVectorType upperBound;
-
-  NumericTraits<MeasurementVectorType>::SetLength( lowerBound,
-    this->m_MeasurementVectorSize );
-  NumericTraits<MeasurementVectorType>::SetLength( upperBound,
-    this->m_MeasurementVectorSize );
-
-  for(  unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d )
-    {
-    lowerBound[d] = static_cast<MeasurementType>( -std::sqrt(
-      -static_cast<double>( NumericTraits<MeasurementType>::
-      NonpositiveMin() ) ) / 2.0 );
-    upperBound[d] = static_cast< MeasurementType >( std::sqrt(
-      static_cast<double>( NumericTraits< MeasurementType >::max() ) / 2.0 ) );
-    }
-
-  result.clear();
-  this->SearchLoop( this->m_Root, query, radius, lowerBound, upperBound, result );
-}
-
 template<typename TSample>
 inline int
 KdTree<TSample>
@@ -485,57 +895,7 @@ KdTree<TSample>
 
   return 0;
 }
-
-template<typename TSample>
-inline bool
-KdTree<TSample>
-::BallWithinBounds( const MeasurementVectorType & query, MeasurementVectorType
-  &lowerBound, MeasurementVectorType & upperBound, double radius ) const
-{
-  for( unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d )
-    {
-    if( ( this->m_DistanceMetric->Evaluate( query[d], lowerBound[d] ) <=
-      radius ) || ( this->m_DistanceMetric->Evaluate( query[d],
-      upperBound[d] ) <= radius ) )
-      {
-      return false;
-      }
-    }
-  return true;
-}
-
-template<typename TSample>
-inline bool
-KdTree<TSample>
-::BoundsOverlapBall( const MeasurementVectorType &query, MeasurementVectorType
-  &lowerBound, MeasurementVectorType &upperBound, double radius ) const
-{
-  double squaredSearchRadius = itk::Math::sqr( radius );
-
-  double sum = 0.0;
-  for( unsigned int d = 0; d < this->m_MeasurementVectorSize; ++d )
-    {
-    if( query[d] <= lowerBound[d] )
-      {
-      sum += itk::Math::sqr( this->m_DistanceMetric->Evaluate( query[d],
-        lowerBound[d] ) );
-      if( sum < squaredSearchRadius )
-        {
-        return true;
-        }
-      }
-    else if( query[d] >= upperBound[d] )
-      {
-      sum += itk::Math::sqr( this->m_DistanceMetric->Evaluate( query[d],
-        upperBound[d] ) );
-      if( sum < squaredSearchRadius )
-        {
-        return true;
-        }
-      }
-    }
-  return false;
-}
+#endif
 
 template<typename TSample>
 void
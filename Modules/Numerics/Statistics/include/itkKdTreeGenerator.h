@@ -18,6 +18,7 @@
 #ifndef itkKdTreeGenerator_h
 #define itkKdTreeGenerator_h
 
+#include <map>
 #include <vector>
 
 #include "itkKdTree.h"
@@ -51,6 +52,12 @@ namespace Statistics
  * Update method will run this generator. To get the resulting KdTree
  * object, call the GetOutput method.
  *
+ * The measurement vectors are copied in contiguous memory, where they are
+ * partitioned. The top levels of the tree are partitioned first, then the
+ * subtrees under them, which hold disjoint ranges of measurement vectors,
+ * are generated by NumberOfThreads threads. The tree does not depend on
+ * the number of threads.
+ *
  * <b>Recent API changes:</b>
  * The static const macro to get the length of a measurement vector,
  * 'MeasurementVectorSize'  has been removed to allow the length of a measurement
@@ -85,6 +92,7 @@ public:
   /** typedef alias for the source data container */
   typedef typename TSample::MeasurementVectorType MeasurementVectorType;
   typedef typename TSample::MeasurementType       MeasurementType;
+  typedef typename TSample::InstanceIdentifier    InstanceIdentifier;
 
   /** Typedef for the length of each measurement vector */
   typedef unsigned int MeasurementVectorSizeType;
@@ -133,6 +141,11 @@ public:
    * held in the 'sample' that is passed to this class */
   itkGetConstMacro(MeasurementVectorSize, unsigned int);
 
+  /** Set/Get the number of threads that generate the subtrees. Defaults
+   * to the global default number of threads. */
+  itkSetClampMacro(NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfThreads, ThreadIdType);
+
 protected:
   /** Constructor */
   KdTreeGenerator();
@@ -163,9 +176,91 @@ protected:
                                     MeasurementVectorType & upperBound,
                                     unsigned int level);
 
+  /** Partitions the measurement vectors between beginIndex and endIndex
+   * around the median of the dimension along which they are the most
+   * spread. Returns the index of the median. */
+  unsigned int PartitionMeasurementVectors(unsigned int beginIndex,
+                                           unsigned int endIndex,
+                                           unsigned int & partitionDimension,
+                                           MeasurementType & partitionValue);
+
+  /** Returns the instance identifier of the measurement vector at an
+   * index of the partitioned measurement vectors. */
+  InstanceIdentifier GetPartitionedInstanceIdentifier(unsigned int index) const
+  {
+    return m_InstanceIdentifiers[m_Order[index]];
+  }
+
+  /** Returns the measurement vector at an index of the partitioned
+   * measurement vectors, as an array of MeasurementVectorSize values. */
+  const MeasurementType * GetPartitionedMeasurementVector(unsigned int index) const
+  {
+    return &m_Measurements[static_cast< size_t >( m_Order[index] ) * m_MeasurementVectorSize];
+  }
+
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(KdTreeGenerator);
 
+  /** Partition of a range of measurement vectors. */
+  struct PartitionType
+  {
+    unsigned int    Dimension;
+    MeasurementType Value;
+    unsigned int    Median;
+  };
+
+  /** Subtree under the top levels of the tree, generated by a thread. */
+  struct SubtreeType
+  {
+    unsigned int          BeginIndex;
+    unsigned int          EndIndex;
+    MeasurementVectorType LowerBound;
+    MeasurementVectorType UpperBound;
+    unsigned int          Level;
+    KdTreeNodeType       *Node;
+  };
+
+  typedef std::pair< unsigned int, unsigned int > RangeType;
+
+  struct GenerateSubtreesStruct
+  {
+    Self                        *Generator;
+    std::vector< SubtreeType >  *Subtrees;
+    AtomicInt< SizeValueType >   NextSubtree;
+  };
+
+  static ITK_THREAD_RETURN_TYPE GenerateSubtreesThreaderCallback(void *arg);
+
+  /** Partitions the top levels of the tree, down to a depth, and collects
+   * the subtrees under them. */
+  void PartitionTopLevels(unsigned int beginIndex, unsigned int endIndex,
+                          MeasurementVectorType & lowerBound,
+                          MeasurementVectorType & upperBound,
+                          unsigned int level, unsigned int depth,
+                          std::vector< SubtreeType > & subtrees);
+
+  /** Orders measurement vectors by one of their components. */
+  class MeasurementLessThan
+  {
+  public:
+    MeasurementLessThan(const MeasurementType *measurements,
+                        unsigned int measurementVectorSize,
+                        unsigned int dimension):
+      m_Measurements(measurements + dimension),
+      m_MeasurementVectorSize(measurementVectorSize)
+    {}
+
+    bool operator()(unsigned int a, unsigned int b) const
+    {
+      return m_Measurements[static_cast< size_t >( a ) * m_MeasurementVectorSize]
+             < m_Measurements[static_cast< size_t >( b ) * m_MeasurementVectorSize];
+    }
+
+  private:
+    const MeasurementType *m_Measurements;
+    unsigned int           m_MeasurementVectorSize;
+  };
+
   /** Pointer to the input (source) sample */
   TSample *m_SourceSample;
 
@@ -181,17 +276,22 @@ private:
   /** Pointer to the resulting k-d tree. */
   OutputPointer m_Tree;
 
-  /** Temporary lower bound for the TreeGenerationLoop */
-  MeasurementVectorType m_TempLowerBound;
+  /** Length of a measurement vector */
+  MeasurementVectorSizeType m_MeasurementVectorSize;
 
-  /** Temporary upper bound for the TreeGenerationLoop */
-  MeasurementVectorType m_TempUpperBound;
+  /** Copy of the measurement vectors of the subsample and of their
+   * instance identifiers, during the generation, and their order in the
+   * partitions. */
+  std::vector< MeasurementType >    m_Measurements;
+  std::vector< InstanceIdentifier > m_InstanceIdentifiers;
+  std::vector< unsigned int >       m_Order;
 
-  /** Temporary mean for the TreeGenerationLoop */
-  MeasurementVectorType m_TempMean;
+  /** Partitions of the top levels and subtrees under them, during a
+   * multithreaded generation. */
+  std::map< RangeType, PartitionType >    m_TopLevelPartitions;
+  std::map< RangeType, KdTreeNodeType * > m_Subtrees;
 
-  /** Length of a measurement vector */
-  MeasurementVectorSizeType m_MeasurementVectorSize;
+  ThreadIdType m_NumberOfThreads;
 };  // end of class
 } // end of namespace Statistics
 } // end of namespace itk
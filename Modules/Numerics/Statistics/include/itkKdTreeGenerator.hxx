@@ -20,6 +20,8 @@
 
 #include  "itkKdTreeGenerator.h"
 
+#include <algorithm>
+
 namespace itk
 {
 namespace Statistics
@@ -32,6 +34,7 @@ KdTreeGenerator< TSample >
   m_BucketSize = 16;
   m_Subsample = SubsampleType::New();
   m_MeasurementVectorSize = 0;
+  m_NumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
 }
 
 template< typename TSample >
@@ -54,6 +57,7 @@ KdTreeGenerator< TSample >
   os << indent << "Bucket Size: " << m_BucketSize << std::endl;
   os << indent << "MeasurementVectorSize: "
      << m_MeasurementVectorSize << std::endl;
+  os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
 }
 
 template< typename TSample >
@@ -65,9 +69,6 @@ KdTreeGenerator< TSample >
   m_Subsample->SetSample(sample);
   m_Subsample->InitializeWithAllInstances();
   m_MeasurementVectorSize = sample->GetMeasurementVectorSize();
-  NumericTraits<MeasurementVectorType>::SetLength(m_TempLowerBound, m_MeasurementVectorSize);
-  NumericTraits<MeasurementVectorType>::SetLength(m_TempUpperBound, m_MeasurementVectorSize);
-  NumericTraits<MeasurementVectorType>::SetLength(m_TempMean, m_MeasurementVectorSize);
 }
 
 template< typename TSample >
@@ -104,6 +105,24 @@ KdTreeGenerator< TSample >
     itkExceptionMacro(<< "Measurement Vector Length mismatch");
     }
 
+  // Copy the measurement vectors in contiguous memory, where they are
+  // partitioned without calling the sample, which may not support
+  // concurrent calls.
+  const unsigned int numberOfInstances = static_cast< unsigned int >( subsample->Size() );
+  m_Measurements.resize( static_cast< size_t >( numberOfInstances ) * m_MeasurementVectorSize );
+  m_InstanceIdentifiers.resize(numberOfInstances);
+  m_Order.resize(numberOfInstances);
+  for ( unsigned int i = 0; i < numberOfInstances; i++ )
+    {
+    const MeasurementVectorType & measurement = subsample->GetMeasurementVectorByIndex(i);
+    for ( unsigned int d = 0; d < m_MeasurementVectorSize; d++ )
+      {
+      m_Measurements[static_cast< size_t >( i ) * m_MeasurementVectorSize + d] = measurement[d];
+      }
+    m_InstanceIdentifiers[i] = subsample->GetInstanceIdentifier(i);
+    m_Order[i] = i;
+    }
+
   MeasurementVectorType lowerBound;
   NumericTraits<MeasurementVectorType>::SetLength(lowerBound, m_MeasurementVectorSize);
   MeasurementVectorType upperBound;
@@ -115,62 +134,205 @@ KdTreeGenerator< TSample >
     upperBound[d] = NumericTraits< MeasurementType >::max();
     }
 
+  if ( m_NumberOfThreads > 1 )
+    {
+    // The subtrees under the top levels have the same size. When the
+    // number of threads is not a power of two, there are at least twice
+    // as many subtrees as threads, for the threads to share them evenly.
+    unsigned int depth = 0;
+    while ( ( 1u << depth ) < m_NumberOfThreads )
+      {
+      ++depth;
+      }
+    if ( ( 1u << depth ) != m_NumberOfThreads )
+      {
+      ++depth;
+      }
+
+    std::vector< SubtreeType > subtrees;
+    this->PartitionTopLevels(0, numberOfInstances, lowerBound, upperBound, 0, depth, subtrees);
+
+    GenerateSubtreesStruct str;
+    str.Generator = this;
+    str.Subtrees = &subtrees;
+    str.NextSubtree = 0;
+
+    MultiThreader::Pointer multiThreader = MultiThreader::New();
+    multiThreader->SetNumberOfThreads( std::min( m_NumberOfThreads,
+                                                 static_cast< ThreadIdType >( subtrees.size() ) ) );
+    multiThreader->SetSingleMethod(Self::GenerateSubtreesThreaderCallback, &str);
+    multiThreader->SingleMethodExecute();
+
+    for ( size_t i = 0; i < subtrees.size(); i++ )
+      {
+      m_Subtrees[RangeType(subtrees[i].BeginIndex, subtrees[i].EndIndex)] = subtrees[i].Node;
+      }
+    }
+
+  // Generate the tree, or its top levels from the partitions and the
+  // subtrees already generated.
   KdTreeNodeType *root =
-    this->GenerateTreeLoop(0, m_Subsample->Size(), lowerBound, upperBound, 0);
+    this->GenerateTreeLoop(0, numberOfInstances, lowerBound, upperBound, 0);
+
+  m_TopLevelPartitions.clear();
+  m_Subtrees.clear();
+  std::vector< MeasurementType >().swap(m_Measurements);
+  std::vector< InstanceIdentifier >().swap(m_InstanceIdentifiers);
+  std::vector< unsigned int >().swap(m_Order);
+
   m_Tree->SetRoot(root);
 }
 
 template< typename TSample >
-inline typename KdTreeGenerator< TSample >::KdTreeNodeType *
+void
 KdTreeGenerator< TSample >
-::GenerateNonterminalNode(unsigned int beginIndex,
-                          unsigned int endIndex,
-                          MeasurementVectorType & lowerBound,
-                          MeasurementVectorType & upperBound,
-                          unsigned int level)
+::PartitionTopLevels(unsigned int beginIndex,
+                     unsigned int endIndex,
+                     MeasurementVectorType & lowerBound,
+                     MeasurementVectorType & upperBound,
+                     unsigned int level,
+                     unsigned int depth,
+                     std::vector< SubtreeType > & subtrees)
 {
-  typedef typename KdTreeType::KdTreeNodeType NodeType;
-  MeasurementType dimensionLowerBound;
-  MeasurementType dimensionUpperBound;
-  MeasurementType partitionValue;
-  unsigned int    partitionDimension = 0;
-  unsigned int    i;
-  MeasurementType spread;
-  MeasurementType maxSpread;
-  unsigned int    medianIndex;
+  if ( depth == 0 || endIndex - beginIndex <= m_BucketSize )
+    {
+    SubtreeType subtree;
+    subtree.BeginIndex = beginIndex;
+    subtree.EndIndex = endIndex;
+    subtree.LowerBound = lowerBound;
+    subtree.UpperBound = upperBound;
+    subtree.Level = level;
+    subtree.Node = ITK_NULLPTR;
+    subtrees.push_back(subtree);
+    return;
+    }
 
-  SubsamplePointer subsample = this->GetSubsample();
+  // The levels follow those of GenerateTreeLoop and
+  // GenerateNonterminalNode
+  PartitionType partition;
+  partition.Median = this->PartitionMeasurementVectors(beginIndex, endIndex,
+                                                       partition.Dimension, partition.Value);
+  m_TopLevelPartitions[RangeType(beginIndex, endIndex)] = partition;
+
+  const MeasurementType dimensionUpperBound = upperBound[partition.Dimension];
+  upperBound[partition.Dimension] = partition.Value;
+  this->PartitionTopLevels(beginIndex, partition.Median, lowerBound, upperBound, level + 2, depth - 1, subtrees);
+  upperBound[partition.Dimension] = dimensionUpperBound;
+
+  const MeasurementType dimensionLowerBound = lowerBound[partition.Dimension];
+  lowerBound[partition.Dimension] = partition.Value;
+  this->PartitionTopLevels(partition.Median + 1, endIndex, lowerBound, upperBound, level + 2, depth - 1, subtrees);
+  lowerBound[partition.Dimension] = dimensionLowerBound;
+}
+
+template< typename TSample >
+ITK_THREAD_RETURN_TYPE
+KdTreeGenerator< TSample >
+::GenerateSubtreesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  GenerateSubtreesStruct *         str = static_cast< GenerateSubtreesStruct * >( info->UserData );
+
+  for (;; )
+    {
+    const SizeValueType i = str->NextSubtree++;
+    if ( i >= str->Subtrees->size() )
+      {
+      break;
+      }
+    SubtreeType & subtree = ( *str->Subtrees )[i];
+    subtree.Node = str->Generator->GenerateTreeLoop(subtree.BeginIndex, subtree.EndIndex,
+                                                    subtree.LowerBound, subtree.UpperBound,
+                                                    subtree.Level);
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TSample >
+unsigned int
+KdTreeGenerator< TSample >
+::PartitionMeasurementVectors(unsigned int beginIndex,
+                              unsigned int endIndex,
+                              unsigned int & partitionDimension,
+                              MeasurementType & partitionValue)
+{
+  if ( !m_TopLevelPartitions.empty() )
+    {
+    typename std::map< RangeType, PartitionType >::const_iterator it =
+      m_TopLevelPartitions.find( RangeType(beginIndex, endIndex) );
+    if ( it != m_TopLevelPartitions.end() )
+      {
+      partitionDimension = it->second.Dimension;
+      partitionValue = it->second.Value;
+      return it->second.Median;
+      }
+    }
 
   // find most widely spread dimension
-  Algorithm::FindSampleBoundAndMean< SubsampleType >(subsample,
-                                                     beginIndex, endIndex,
-                                                     m_TempLowerBound, m_TempUpperBound,
-                                                     m_TempMean);
+  std::vector< MeasurementType > lowerBound(m_MeasurementVectorSize);
+  std::vector< MeasurementType > upperBound(m_MeasurementVectorSize);
+  const MeasurementType *        measurement = this->GetPartitionedMeasurementVector(beginIndex);
+  for ( unsigned int d = 0; d < m_MeasurementVectorSize; d++ )
+    {
+    lowerBound[d] = measurement[d];
+    upperBound[d] = measurement[d];
+    }
+  for ( unsigned int i = beginIndex + 1; i < endIndex; i++ )
+    {
+    measurement = this->GetPartitionedMeasurementVector(i);
+    for ( unsigned int d = 0; d < m_MeasurementVectorSize; d++ )
+      {
+      if ( measurement[d] < lowerBound[d] )
+        {
+        lowerBound[d] = measurement[d];
+        }
+      else if ( measurement[d] > upperBound[d] )
+        {
+        upperBound[d] = measurement[d];
+        }
+      }
+    }
 
-  maxSpread = NumericTraits< MeasurementType >::NonpositiveMin();
-  for ( i = 0; i < m_MeasurementVectorSize; i++ )
+  partitionDimension = 0;
+  MeasurementType maxSpread = NumericTraits< MeasurementType >::NonpositiveMin();
+  for ( unsigned int d = 0; d < m_MeasurementVectorSize; d++ )
     {
-    spread = m_TempUpperBound[i] - m_TempLowerBound[i];
+    const MeasurementType spread = upperBound[d] - lowerBound[d];
     if ( spread >= maxSpread )
       {
       maxSpread = spread;
-      partitionDimension = i;
+      partitionDimension = d;
       }
     }
 
-  medianIndex = ( endIndex - beginIndex ) / 2;
+  // Find the median along that dimension with the QuickSelect algorithm
+  // of the STL.
+  const unsigned int medianIndex = beginIndex + ( endIndex - beginIndex ) / 2;
+  unsigned int *     order = &m_Order[0];
+  std::nth_element( order + beginIndex, order + medianIndex, order + endIndex,
+                    MeasurementLessThan(&m_Measurements[0], m_MeasurementVectorSize, partitionDimension) );
+  partitionValue = this->GetPartitionedMeasurementVector(medianIndex)[partitionDimension];
+
+  return medianIndex;
+}
 
-  //
-  // Find the medial element by using the NthElement function
-  // based on the STL implementation of the QuickSelect algorithm.
-  //
-  partitionValue =
-    Algorithm::NthElement< SubsampleType >(m_Subsample,
-                                           partitionDimension,
-                                           beginIndex, endIndex,
-                                           medianIndex);
+template< typename TSample >
+inline typename KdTreeGenerator< TSample >::KdTreeNodeType *
+KdTreeGenerator< TSample >
+::GenerateNonterminalNode(unsigned int beginIndex,
+                          unsigned int endIndex,
+                          MeasurementVectorType & lowerBound,
+                          MeasurementVectorType & upperBound,
+                          unsigned int level)
+{
+  typedef typename KdTreeType::KdTreeNodeType NodeType;
+  MeasurementType dimensionLowerBound;
+  MeasurementType dimensionUpperBound;
+  MeasurementType partitionValue;
+  unsigned int    partitionDimension = 0;
 
-  medianIndex += beginIndex;
+  const unsigned int medianIndex =
+    this->PartitionMeasurementVectors(beginIndex, endIndex, partitionDimension, partitionValue);
 
   // save bounds for cutting dimension
   dimensionLowerBound = lowerBound[partitionDimension];
@@ -197,7 +359,7 @@ KdTreeGenerator< TSample >
                                   right);
 
   nonTerminalNode->AddInstanceIdentifier(
-    subsample->GetInstanceIdentifier(medianIndex) );
+    this->GetPartitionedInstanceIdentifier(medianIndex) );
 
   return nonTerminalNode;
 }
@@ -211,6 +373,16 @@ KdTreeGenerator< TSample >
                    MeasurementVectorType & upperBound,
                    unsigned int level)
 {
+  if ( !m_Subtrees.empty() )
+    {
+    typename std::map< RangeType, KdTreeNodeType * >::const_iterator it =
+      m_Subtrees.find( RangeType(beginIndex, endIndex) );
+    if ( it != m_Subtrees.end() )
+      {
+      return it->second;
+      }
+    }
+
   if ( endIndex - beginIndex <= m_BucketSize )
     {
     // numberOfInstances small, make a terminal node
@@ -227,7 +399,7 @@ KdTreeGenerator< TSample >
       for ( unsigned int j = beginIndex; j < endIndex; j++ )
         {
         ptr->AddInstanceIdentifier(
-          this->GetSubsample()->GetInstanceIdentifier(j) );
+          this->GetPartitionedInstanceIdentifier(j) );
         }
 
       // return a terminal node
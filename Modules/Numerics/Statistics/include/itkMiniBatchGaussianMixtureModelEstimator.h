@@ -0,0 +1,267 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMiniBatchGaussianMixtureModelEstimator_h
+#define itkMiniBatchGaussianMixtureModelEstimator_h
+
+#include "itkGaussianMembershipFunction.h"
+#include "itkSimpleDataObjectDecorator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkMultiThreader.h"
+#include "itkSampleThreadRange.h"
+
+namespace itk
+{
+namespace Statistics
+{
+/** \class MiniBatchGaussianMixtureModelEstimator
+ * \brief Estimates the parameters of a Gaussian mixture model from
+ * random mini-batches of a sample.
+ *
+ * This estimator implements the stepwise expectation maximization
+ * algorithm. Each iteration draws a mini-batch of BatchSize
+ * measurement vectors at random, with replacement, and computes the
+ * expected sufficient statistics of the components over the
+ * mini-batch. The running sufficient statistics are moved towards them
+ * by a step size \f$ \eta_t = (t + 2)^{-\alpha} \f$, where \f$ t \f$ is
+ * the iteration and \f$ \alpha \f$ is the StepSizeExponent, between
+ * 0.5 and 1. The proportions, means and covariances of the components
+ * are then derived from the running statistics.
+ *
+ * Unlike ExpectationMaximizationMixtureModelEstimator, the estimator
+ * does not store a weight per measurement vector and component, nor
+ * visits the whole sample at each iteration: the memory and the time of
+ * an iteration only depend on the batch size. The measurement vectors
+ * are read with GetMeasurementVector(), so that the sample may be an
+ * adaptor, like ImageToListSampleAdaptor, instead of a copy of the
+ * data. The frequencies of the measurement vectors weight them in the
+ * statistics.
+ *
+ * The mini-batch is read by a single thread, since the adaptors do not
+ * support concurrent calls of GetMeasurementVector(). The expectation
+ * step over the mini-batch is split among NumberOfThreads threads, which
+ * accumulate their own statistics.
+ *
+ * The initial proportions (SetInitialProportions), the sample
+ * (SetSample) and the initial parameters of the components
+ * (AddComponent) are required. The parameters of a component are its
+ * mean followed by the rows of its covariance matrix, as for
+ * GaussianMixtureModelComponent. The estimation terminates after
+ * MaximumIteration mini-batches, or when no parameter changes by more
+ * than MinimalParametersChange over an iteration.
+ *
+ * For more information about the algorithm, see O. Cappe and E. Moulines,
+ * "On-line expectation-maximization algorithm for latent data models",
+ * Journal of the Royal Statistical Society B, 71(3):593-613, 2009.
+ *
+ * \sa ExpectationMaximizationMixtureModelEstimator, GaussianMixtureModelComponent
+ * \ingroup ITKStatistics
+ */
+
+template< typename TSample >
+class ITK_TEMPLATE_EXPORT MiniBatchGaussianMixtureModelEstimator:public Object
+{
+public:
+  /** Standard class typedef */
+  typedef MiniBatchGaussianMixtureModelEstimator Self;
+  typedef Object                                 Superclass;
+  typedef SmartPointer< Self >                   Pointer;
+  typedef SmartPointer< const Self >             ConstPointer;
+
+  /** Standard macros */
+  itkTypeMacro(MiniBatchGaussianMixtureModelEstimator, Object);
+  itkNewMacro(Self);
+
+  /** TSample template argument related typedefs */
+  typedef TSample                                     SampleType;
+  typedef typename TSample::MeasurementType           MeasurementType;
+  typedef typename TSample::MeasurementVectorType     MeasurementVectorType;
+  typedef typename TSample::MeasurementVectorSizeType MeasurementVectorSizeType;
+
+  /** Typedef requried to generate dataobject decorated output that can
+    * be plugged into SampleClassifierFilter */
+  typedef GaussianMembershipFunction< MeasurementVectorType >
+  GaussianMembershipFunctionType;
+
+  typedef typename GaussianMembershipFunctionType::Pointer
+  GaussianMembershipFunctionPointer;
+
+  typedef MembershipFunctionBase< MeasurementVectorType > MembershipFunctionType;
+  typedef typename MembershipFunctionType::ConstPointer   MembershipFunctionPointer;
+  typedef std::vector< MembershipFunctionPointer >        MembershipFunctionVectorType;
+  typedef SimpleDataObjectDecorator<
+    MembershipFunctionVectorType >                        MembershipFunctionVectorObjectType;
+  typedef typename
+  MembershipFunctionVectorObjectType::Pointer MembershipFunctionVectorObjectPointer;
+
+  /** Type of the array of the proportion values */
+  typedef Array< double > ProportionVectorType;
+
+  /** Type of the parameters of a component: the mean followed by the
+   * rows of the covariance matrix */
+  typedef Array< double > ParametersType;
+
+  /** typedef for decorated array of proportion */
+  typedef SimpleDataObjectDecorator<
+    ProportionVectorType >                 MembershipFunctionsWeightsArrayObjectType;
+  typedef typename
+  MembershipFunctionsWeightsArrayObjectType::Pointer MembershipFunctionsWeightsArrayPointer;
+
+  /** Type of the seed of the random selection of the mini-batches */
+  typedef MersenneTwisterRandomVariateGenerator::IntegerType SeedType;
+
+  /** Set/Gets the target data */
+  itkSetConstObjectMacro(Sample, SampleType);
+  itkGetConstObjectMacro(Sample, SampleType);
+
+  /** Set/Gets the initial proportion values. The size of proportion
+   * vector should be same as the number of components */
+  void SetInitialProportions(const ProportionVectorType & proportions);
+  itkGetConstReferenceMacro(InitialProportions, ProportionVectorType);
+
+  /** Gets the result proportion values */
+  itkGetConstReferenceMacro(Proportions, ProportionVectorType);
+
+  /** Adds a new component with its initial parameters. Returns the
+   * number of components. */
+  unsigned int AddComponent(const ParametersType & parameters);
+
+  /** Gets the total number of components. */
+  unsigned int GetNumberOfComponents() const;
+
+  /** Gets the estimated parameters of a component, or its initial
+   * parameters before the estimation. */
+  const ParametersType & GetComponentParameters(unsigned int componentIndex) const;
+
+  /** Set/Gets the number of measurement vectors drawn at each iteration.
+   * Defaults to 10000. */
+  itkSetClampMacro(BatchSize, SizeValueType, 1, NumericTraits< SizeValueType >::max());
+  itkGetConstMacro(BatchSize, SizeValueType);
+
+  /** Set/Gets the maximum number of iterations, or mini-batches.
+   * Defaults to 100. */
+  itkSetMacro(MaximumIteration, unsigned int);
+  itkGetConstMacro(MaximumIteration, unsigned int);
+
+  /** Set/Gets the exponent of the decay of the step size, between 0.5
+   * and 1. Smaller exponents forget the first mini-batches sooner.
+   * Defaults to 0.7. */
+  itkSetClampMacro(StepSizeExponent, double, 0.5, 1.0);
+  itkGetConstMacro(StepSizeExponent, double);
+
+  /** Set/Gets the change of the parameters and the proportions over an
+   * iteration below which the estimation has converged. Defaults to
+   * 1e-6. */
+  itkSetMacro(MinimalParametersChange, double);
+  itkGetConstMacro(MinimalParametersChange, double);
+
+  /** Set/Gets the seed of the random selection of the mini-batches. */
+  itkSetMacro(Seed, SeedType);
+  itkGetConstMacro(Seed, SeedType);
+
+  /** Set/Gets the number of threads of the expectation step. Defaults to
+   * the global default number of threads. */
+  itkSetClampMacro(NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfThreads, ThreadIdType);
+
+  /** Gets the current iteration. */
+  itkGetConstMacro(CurrentIteration, unsigned int);
+
+  /** Termination status after running optimization */
+  enum TERMINATION_CODE { CONVERGED = 0, NOT_CONVERGED = 1 };
+
+  /** Gets the termination status */
+  itkGetConstMacro(TerminationCode, TERMINATION_CODE);
+
+  /** Runs the optimization process. */
+  void Update();
+
+  /** Output Membership function vector containing the membership functions with
+    * the final optimized parameters */
+  const MembershipFunctionVectorObjectType * GetOutput() const;
+
+  /** Get method for data decorated Membership functions weights array */
+  const MembershipFunctionsWeightsArrayObjectType * GetMembershipFunctionsWeightsArray() const;
+
+protected:
+  MiniBatchGaussianMixtureModelEstimator();
+  virtual ~MiniBatchGaussianMixtureModelEstimator() {}
+  virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+  /** Starts the estimation process */
+  void GenerateData();
+
+private:
+  ITK_DISALLOW_COPY_AND_ASSIGN(MiniBatchGaussianMixtureModelEstimator);
+
+  struct ExpectationStruct
+  {
+    const Self                               *Estimator;
+    const std::vector< MeasurementVectorType > *Batch;
+    const std::vector< double >              *Frequencies;
+    std::vector< std::vector< double > >      Statistics;
+  };
+
+  static ITK_THREAD_RETURN_TYPE ExpectationThreaderCallback(void *arg);
+
+  /** Adds the statistics of the components over a range of the
+   * mini-batch: for each component, the sum of the weights, the sums of
+   * the weighted differences from the mean, and the sums of their
+   * weighted outer products. */
+  void AccumulateStatistics(const std::vector< MeasurementVectorType > & batch,
+                            const std::vector< double > & frequencies,
+                            size_t beginIndex, size_t endIndex,
+                            std::vector< double > & statistics) const;
+
+  /** Moves the parameters and the proportions towards the statistics of
+   * a mini-batch. Returns the largest change. */
+  double UpdateParameters(const std::vector< double > & statistics,
+                          double totalFrequency, double stepSize);
+
+  /** Sets the mean and the covariance of the membership function of a
+   * component to its parameters */
+  void UpdateMembershipFunction(unsigned int componentIndex);
+
+  typename SampleType::ConstPointer m_Sample;
+
+  ProportionVectorType          m_InitialProportions;
+  ProportionVectorType          m_Proportions;
+  std::vector< ParametersType > m_InitialParameters;
+  std::vector< ParametersType > m_Parameters;
+
+  std::vector< GaussianMembershipFunctionPointer > m_MembershipFunctions;
+
+  SizeValueType    m_BatchSize;
+  unsigned int     m_MaximumIteration;
+  unsigned int     m_CurrentIteration;
+  double           m_StepSizeExponent;
+  double           m_MinimalParametersChange;
+  SeedType         m_Seed;
+  ThreadIdType     m_NumberOfThreads;
+  TERMINATION_CODE m_TerminationCode;
+
+  MembershipFunctionVectorObjectPointer  m_MembershipFunctionsObject;
+  MembershipFunctionsWeightsArrayPointer m_MembershipFunctionsWeightArrayObject;
+};  // end of class
+} // end of namespace Statistics
+} // end of namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkMiniBatchGaussianMixtureModelEstimator.hxx"
+#endif
+
+#endif
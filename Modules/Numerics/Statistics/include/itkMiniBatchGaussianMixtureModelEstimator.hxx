@@ -0,0 +1,483 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMiniBatchGaussianMixtureModelEstimator_hxx
+#define itkMiniBatchGaussianMixtureModelEstimator_hxx
+
+#include <algorithm>
+
+#include "itkMiniBatchGaussianMixtureModelEstimator.h"
+#include "itkNumericTraits.h"
+#include "itkMath.h"
+
+namespace itk
+{
+namespace Statistics
+{
+template< typename TSample >
+MiniBatchGaussianMixtureModelEstimator< TSample >
+::MiniBatchGaussianMixtureModelEstimator() :
+  m_BatchSize(10000),
+  m_MaximumIteration(100),
+  m_CurrentIteration(0),
+  m_StepSizeExponent(0.7),
+  m_MinimalParametersChange(1.0e-6),
+  m_Seed(121212),
+  m_NumberOfThreads(MultiThreader::GetGlobalDefaultNumberOfThreads()),
+  m_TerminationCode(NOT_CONVERGED),
+  m_MembershipFunctionsObject(MembershipFunctionVectorObjectType::New()),
+  m_MembershipFunctionsWeightArrayObject(MembershipFunctionsWeightsArrayObjectType::New())
+{
+}
+
+template< typename TSample >
+void
+MiniBatchGaussianMixtureModelEstimator< TSample >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Sample: " << m_Sample.GetPointer() << std::endl;
+  os << indent << "Number Of Components: " << this->GetNumberOfComponents() << std::endl;
+  for ( unsigned int i = 0; i < this->GetNumberOfComponents(); i++ )
+    {
+    os << indent << "Component Parameters[" << i << "]: " << m_Parameters[i] << std::endl;
+    }
+  os << indent << "Initial Proportions: " << m_InitialProportions << std::endl;
+  os << indent << "Proportions: " << m_Proportions << std::endl;
+  os << indent << "Batch Size: " << m_BatchSize << std::endl;
+  os << indent << "Maximum Iteration: " << m_MaximumIteration << std::endl;
+  os << indent << "Current Iteration: " << m_CurrentIteration << std::endl;
+  os << indent << "Step Size Exponent: " << m_StepSizeExponent << std::endl;
+  os << indent << "Minimal Parameters Change: " << m_MinimalParametersChange << std::endl;
+  os << indent << "Seed: " << m_Seed << std::endl;
+  os << indent << "Number Of Threads: " << m_NumberOfThreads << std::endl;
+  os << indent << "Termination Code: " << m_TerminationCode << std::endl;
+}
+
+template< typename TSample >
+void
+MiniBatchGaussianMixtureModelEstimator< TSample >
+::SetInitialProportions(const ProportionVectorType & proportions)
+{
+  m_InitialProportions = proportions;
+  m_Proportions = proportions;
+  this->Modified();
+}
+
+template< typename TSample >
+unsigned int
+MiniBatchGaussianMixtureModelEstimator< TSample >
+::AddComponent(const ParametersType & parameters)
+{
+  m_InitialParameters.push_back(parameters);
+  m_Parameters.push_back(parameters);
+  this->Modified();
+  return static_cast< unsigned int >( m_InitialParameters.size() );
+}
+
+template< typename TSample >
+unsigned int
+MiniBatchGaussianMixtureModelEstimator< TSample >
+::GetNumberOfComponents() const
+{
+  return static_cast< unsigned int >( m_InitialParameters.size() );
+}
+
+template< typename TSample >
+const typename MiniBatchGaussianMixtureModelEstimator< TSample >::ParametersType &
+MiniBatchGaussianMixtureModelEstimator< TSample >
+::GetComponentParameters(unsigned int componentIndex) const
+{
+  if ( componentIndex >= m_Parameters.size() )
+    {
+    itkExceptionMacro(<< "Component " << componentIndex << " does not exist.");
+    }
+  return m_Parameters[componentIndex];
+}
+
+template< typename TSample >
+void
+MiniBatchGaussianMixtureModelEstimator< TSample >
+::UpdateMembershipFunction(unsigned int componentIndex)
+{
+  const MeasurementVectorSizeType measurementVectorSize = m_Sample->GetMeasurementVectorSize();
+  const ParametersType &          parameters = m_Parameters[componentIndex];
+
+  typename GaussianMembershipFunctionType::MeanVectorType mean;
+  NumericTraits< typename GaussianMembershipFunctionType::MeanVectorType >::SetLength(mean,
+                                                                                     measurementVectorSize);
+  typename GaussianMembershipFunctionType::CovarianceMatrixType covariance;
+  covariance.SetSize(measurementVectorSize, measurementVectorSize);
+
+  unsigned int parameterIndex = 0;
+  for ( unsigned int i = 0; i < measurementVectorSize; i++ )
+    {
+    mean[i] = parameters[parameterIndex++];
+    }
+  for ( unsigned int i = 0; i < measurementVectorSize; i++ )
+    {
+    for ( unsigned int j = 0; j < measurementVectorSize; j++ )
+      {
+      covariance(i, j) = parameters[parameterIndex++];
+      }
+    }
+
+  m_MembershipFunctions[componentIndex]->SetMean(mean);
+  m_MembershipFunctions[componentIndex]->SetCovariance(covariance);
+}
+
+template< typename TSample >
+void
+MiniBatchGaussianMixtureModelEstimator< TSample >
+::GenerateData()
+{
+  if ( m_Sample.IsNull() )
+    {
+    itkExceptionMacro(<< "Sample is not set.");
+    }
+
+  const unsigned int              numberOfComponents = this->GetNumberOfComponents();
+  const MeasurementVectorSizeType measurementVectorSize = m_Sample->GetMeasurementVectorSize();
+  const SizeValueType             sampleSize = m_Sample->Size();
+
+  if ( numberOfComponents == 0 || m_InitialProportions.Size() != numberOfComponents )
+    {
+    itkExceptionMacro(<< "The number of initial proportions, " << m_InitialProportions.Size()
+                      << ", differs from the number of components, " << numberOfComponents << ".");
+    }
+  for ( unsigned int k = 0; k < numberOfComponents; k++ )
+    {
+    if ( m_InitialParameters[k].Size() != measurementVectorSize * ( measurementVectorSize + 1 ) )
+      {
+      itkExceptionMacro(<< "The component " << k << " has " << m_InitialParameters[k].Size()
+                        << " parameters instead of " << measurementVectorSize * ( measurementVectorSize + 1 )
+                        << ".");
+      }
+    }
+  if ( sampleSize == 0 )
+    {
+    itkExceptionMacro(<< "The sample is empty.");
+    }
+
+  m_Proportions = m_InitialProportions;
+  m_Parameters = m_InitialParameters;
+  m_MembershipFunctions.resize(numberOfComponents);
+  for ( unsigned int k = 0; k < numberOfComponents; k++ )
+    {
+    m_MembershipFunctions[k] = GaussianMembershipFunctionType::New();
+    m_MembershipFunctions[k]->SetMeasurementVectorSize(measurementVectorSize);
+    this->UpdateMembershipFunction(k);
+    }
+
+  typedef MersenneTwisterRandomVariateGenerator RandomGeneratorType;
+  RandomGeneratorType::Pointer randomGenerator = RandomGeneratorType::New();
+  randomGenerator->Initialize(m_Seed);
+
+  std::vector< typename SampleType::InstanceIdentifier > identifiers(m_BatchSize);
+  std::vector< MeasurementVectorType >                   batch(m_BatchSize);
+  std::vector< double >                                  frequencies(m_BatchSize);
+
+  ThreadIdType numberOfThreads = m_NumberOfThreads;
+  if ( m_BatchSize < numberOfThreads )
+    {
+    numberOfThreads = static_cast< ThreadIdType >( m_BatchSize );
+    }
+
+  const size_t numberOfStatistics = numberOfComponents
+    * ( 1 + measurementVectorSize + measurementVectorSize * measurementVectorSize );
+
+  ExpectationStruct str;
+  str.Estimator = this;
+  str.Batch = &batch;
+  str.Frequencies = &frequencies;
+
+  MultiThreader::Pointer multiThreader = MultiThreader::New();
+  multiThreader->SetNumberOfThreads(numberOfThreads);
+
+  m_TerminationCode = NOT_CONVERGED;
+  for ( m_CurrentIteration = 0; m_CurrentIteration < m_MaximumIteration; ++m_CurrentIteration )
+    {
+    // Draw the mini-batch, and read it in the order of the sample
+    for ( SizeValueType i = 0; i < m_BatchSize; i++ )
+      {
+      identifiers[i] = static_cast< typename SampleType::InstanceIdentifier >(
+        randomGenerator->GetIntegerVariate( static_cast< RandomGeneratorType::IntegerType >( sampleSize - 1 ) ) );
+      }
+    std::sort( identifiers.begin(), identifiers.end() );
+
+    double totalFrequency = 0.0;
+    for ( SizeValueType i = 0; i < m_BatchSize; i++ )
+      {
+      batch[i] = m_Sample->GetMeasurementVector(identifiers[i]);
+      frequencies[i] = static_cast< double >( m_Sample->GetFrequency(identifiers[i]) );
+      totalFrequency += frequencies[i];
+      }
+
+    str.Statistics.assign( numberOfThreads, std::vector< double >(numberOfStatistics, 0.0) );
+    if ( numberOfThreads > 1 )
+      {
+      multiThreader->SetSingleMethod(Self::ExpectationThreaderCallback, &str);
+      multiThreader->SingleMethodExecute();
+      }
+    else
+      {
+      this->AccumulateStatistics(batch, frequencies, 0, batch.size(), str.Statistics[0]);
+      }
+
+    // Add the statistics of the threads in order
+    std::vector< double > & statistics = str.Statistics[0];
+    for ( ThreadIdType threadId = 1; threadId < numberOfThreads; threadId++ )
+      {
+      for ( size_t s = 0; s < numberOfStatistics; s++ )
+        {
+        statistics[s] += str.Statistics[threadId][s];
+        }
+      }
+
+    if ( totalFrequency <= 0.0 )
+      {
+      continue;
+      }
+
+    const double stepSize = std::pow( static_cast< double >( m_CurrentIteration + 2 ), -m_StepSizeExponent );
+    if ( this->UpdateParameters(statistics, totalFrequency, stepSize) < m_MinimalParametersChange )
+      {
+      m_TerminationCode = CONVERGED;
+      ++m_CurrentIteration;
+      break;
+      }
+    }
+}
+
+template< typename TSample >
+ITK_THREAD_RETURN_TYPE
+MiniBatchGaussianMixtureModelEstimator< TSample >
+::ExpectationThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ExpectationStruct *              str = static_cast< ExpectationStruct * >( info->UserData );
+
+  const ThreadIdType threadId = info->ThreadID;
+  const ThreadIdType numberOfThreads = info->NumberOfThreads;
+  const size_t       batchSize = str->Batch->size();
+
+  size_t beginIndex;
+  size_t endIndex;
+  GetThreadRange(batchSize, threadId, numberOfThreads, beginIndex, endIndex);
+
+  str->Estimator->AccumulateStatistics(*str->Batch, *str->Frequencies, beginIndex, endIndex,
+                                       str->Statistics[threadId]);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TSample >
+void
+MiniBatchGaussianMixtureModelEstimator< TSample >
+::AccumulateStatistics(const std::vector< MeasurementVectorType > & batch,
+                       const std::vector< double > & frequencies,
+                       size_t beginIndex, size_t endIndex,
+                       std::vector< double > & statistics) const
+{
+  const unsigned int              numberOfComponents = this->GetNumberOfComponents();
+  const MeasurementVectorSizeType measurementVectorSize = m_Sample->GetMeasurementVectorSize();
+  const size_t                    componentStatisticsSize =
+    1 + measurementVectorSize + measurementVectorSize * measurementVectorSize;
+
+  std::vector< double > densities(numberOfComponents);
+  std::vector< double > diff(measurementVectorSize);
+
+  for ( size_t n = beginIndex; n < endIndex; n++ )
+    {
+    const MeasurementVectorType & measurement = batch[n];
+
+    double densitySum = 0.0;
+    for ( unsigned int k = 0; k < numberOfComponents; k++ )
+      {
+      densities[k] = m_Proportions[k] * m_MembershipFunctions[k]->Evaluate(measurement);
+      densitySum += densities[k];
+      }
+
+    for ( unsigned int k = 0; k < numberOfComponents; k++ )
+      {
+      double weight = densities[k];
+
+      // just to make sure weight does not blow up!
+      if ( densitySum > NumericTraits< double >::epsilon() )
+        {
+        weight /= densitySum;
+        }
+      weight *= frequencies[n];
+
+      // The differences from the current means keep the sums of the outer
+      // products accurate
+      const ParametersType & parameters = m_Parameters[k];
+      for ( unsigned int i = 0; i < measurementVectorSize; i++ )
+        {
+        diff[i] = static_cast< double >( measurement[i] ) - parameters[i];
+        }
+
+      double *componentStatistics = &statistics[k * componentStatisticsSize];
+      componentStatistics[0] += weight;
+      double *sums = componentStatistics + 1;
+      double *outerProductSums = sums + measurementVectorSize;
+      for ( unsigned int i = 0; i < measurementVectorSize; i++ )
+        {
+        const double weightedDiff = weight * diff[i];
+        sums[i] += weightedDiff;
+        for ( unsigned int j = 0; j <= i; j++ )
+          {
+          outerProductSums[i * measurementVectorSize + j] += weightedDiff * diff[j];
+          }
+        }
+      }
+    }
+}
+
+template< typename TSample >
+double
+MiniBatchGaussianMixtureModelEstimator< TSample >
+::UpdateParameters(const std::vector< double > & statistics,
+                   double totalFrequency, double stepSize)
+{
+  const unsigned int              numberOfComponents = this->GetNumberOfComponents();
+  const MeasurementVectorSizeType measurementVectorSize = m_Sample->GetMeasurementVectorSize();
+  const size_t                    componentStatisticsSize =
+    1 + measurementVectorSize + measurementVectorSize * measurementVectorSize;
+
+  double                maximumChange = 0.0;
+  ProportionVectorType  proportions(numberOfComponents);
+  std::vector< double > batchMean(measurementVectorSize);
+  std::vector< double > shift(measurementVectorSize);
+
+  for ( unsigned int k = 0; k < numberOfComponents; k++ )
+    {
+    const double *componentStatistics = &statistics[k * componentStatisticsSize];
+    const double  weightSum = componentStatistics[0];
+    const double  batchProportion = weightSum / totalFrequency;
+
+    proportions[k] = ( 1.0 - stepSize ) * m_Proportions[k] + stepSize * batchProportion;
+    if ( weightSum <= NumericTraits< double >::epsilon()
+         || proportions[k] <= NumericTraits< double >::epsilon() )
+      {
+      continue;
+      }
+
+    // Mean and covariance of the mini-batch, relative to the current mean
+    const double *sums = componentStatistics + 1;
+    const double *outerProductSums = sums + measurementVectorSize;
+    for ( unsigned int i = 0; i < measurementVectorSize; i++ )
+      {
+      batchMean[i] = sums[i] / weightSum;
+      }
+
+    // The running statistics and those of the mini-batch are combined
+    // with the fractions of the new proportion they contribute
+    const double batchFraction = stepSize * batchProportion / proportions[k];
+    for ( unsigned int i = 0; i < measurementVectorSize; i++ )
+      {
+      shift[i] = batchFraction * batchMean[i];
+      }
+
+    ParametersType & parameters = m_Parameters[k];
+    double *         covariance = parameters.data_block() + measurementVectorSize;
+    for ( unsigned int i = 0; i < measurementVectorSize; i++ )
+      {
+      for ( unsigned int j = 0; j <= i; j++ )
+        {
+        const double batchCovariance = outerProductSums[i * measurementVectorSize + j] / weightSum
+          - batchMean[i] * batchMean[j];
+        const double value =
+          ( 1.0 - batchFraction ) * ( covariance[i * measurementVectorSize + j] + shift[i] * shift[j] )
+          + batchFraction * ( batchCovariance + ( batchMean[i] - shift[i] ) * ( batchMean[j] - shift[j] ) );
+        maximumChange = std::max( maximumChange,
+                                  itk::Math::abs( value - covariance[i * measurementVectorSize + j] ) );
+        covariance[i * measurementVectorSize + j] = value;
+        covariance[j * measurementVectorSize + i] = value;
+        }
+      }
+    for ( unsigned int i = 0; i < measurementVectorSize; i++ )
+      {
+      maximumChange = std::max( maximumChange, itk::Math::abs( shift[i] ) );
+      parameters[i] += shift[i];
+      }
+
+    this->UpdateMembershipFunction(k);
+    }
+
+  // The weights of the measurement vectors far from every component do
+  // not sum to one
+  double proportionSum = 0.0;
+  for ( unsigned int k = 0; k < numberOfComponents; k++ )
+    {
+    proportionSum += proportions[k];
+    }
+  for ( unsigned int k = 0; k < numberOfComponents; k++ )
+    {
+    if ( proportionSum > NumericTraits< double >::epsilon() )
+      {
+      proportions[k] /= proportionSum;
+      }
+    maximumChange = std::max( maximumChange, itk::Math::abs( proportions[k] - m_Proportions[k] ) );
+    }
+  m_Proportions = proportions;
+
+  return maximumChange;
+}
+
+template< typename TSample >
+const typename MiniBatchGaussianMixtureModelEstimator< TSample >::MembershipFunctionVectorObjectType *
+MiniBatchGaussianMixtureModelEstimator< TSample >
+::GetOutput() const
+{
+  MembershipFunctionVectorType & membershipFunctionsVector = m_MembershipFunctionsObject->Get();
+
+  membershipFunctionsVector.clear();
+  for ( size_t k = 0; k < m_MembershipFunctions.size(); ++k )
+    {
+    typename GaussianMembershipFunctionType::Pointer membershipFunction =
+      GaussianMembershipFunctionType::New();
+    membershipFunction->SetMeasurementVectorSize( m_MembershipFunctions[k]->GetMeasurementVectorSize() );
+    membershipFunction->SetMean( m_MembershipFunctions[k]->GetMean() );
+    membershipFunction->SetCovariance( m_MembershipFunctions[k]->GetCovariance() );
+    membershipFunctionsVector.push_back( membershipFunction.GetPointer() );
+    }
+
+  return static_cast< const MembershipFunctionVectorObjectType * >( m_MembershipFunctionsObject );
+}
+
+template< typename TSample >
+const typename MiniBatchGaussianMixtureModelEstimator< TSample >::MembershipFunctionsWeightsArrayObjectType *
+MiniBatchGaussianMixtureModelEstimator< TSample >
+::GetMembershipFunctionsWeightsArray() const
+{
+  m_MembershipFunctionsWeightArrayObject->Set(m_Proportions);
+
+  return static_cast< const MembershipFunctionsWeightsArrayObjectType * >( m_MembershipFunctionsWeightArrayObject );
+}
+
+template< typename TSample >
+void
+MiniBatchGaussianMixtureModelEstimator< TSample >
+::Update()
+{
+  this->GenerateData();
+}
+} // end of namespace Statistics
+} // end of namespace itk
+
+#endif
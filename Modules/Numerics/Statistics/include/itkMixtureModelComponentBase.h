@@ -24,6 +24,7 @@
 #include "itkArray.h"
 #include "itkObject.h"
 #include "itkMembershipFunctionBase.h"
+#include "itkMultiThreader.h"
 
 namespace itk
 {
@@ -126,6 +127,12 @@ public:
   /** returns the pointer to the weights array */
   itkGetConstReferenceMacro(Weights, WeightArrayType);
 
+  /** Set/Get the number of threads the subclasses may use to update the
+   * parameters. ExpectationMaximizationMixtureModelEstimator sets it to
+   * its own number of threads. */
+  itkSetClampMacro(NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfThreads, ThreadIdType);
+
   virtual void Update();
 
 protected:
@@ -156,6 +163,8 @@ private:
 
   /** indicative flag of membership function's parameter changes */
   bool m_ParametersModified;
+
+  ThreadIdType m_NumberOfThreads;
 };  // end of class
 } // end of namespace Statistics
 } // end of namespace itk
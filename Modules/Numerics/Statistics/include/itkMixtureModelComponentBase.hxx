@@ -32,6 +32,7 @@ MixtureModelComponentBase< TSample >
   m_MembershipFunction = ITK_NULLPTR;
   m_MinimalParametersChange = 1.0e-06;
   m_ParametersModified = true;
+  m_NumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
 }
 
 template< typename TSample >
@@ -71,6 +72,8 @@ MixtureModelComponentBase< TSample >
 
   os << indent << "Parameters are modified: " << m_ParametersModified
      << std::endl;
+
+  os << indent << "Number Of Threads: " << m_NumberOfThreads << std::endl;
 }
 
 template< typename TSample >
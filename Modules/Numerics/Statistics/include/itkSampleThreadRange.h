@@ -0,0 +1,142 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSampleThreadRange_h
+#define itkSampleThreadRange_h
+
+#include "itkListSample.h"
+#include "itkIntTypes.h"
+#include <algorithm>
+
+namespace itk
+{
+namespace Statistics
+{
+/** Computes the range [begin, end) of the elements processed by a thread,
+ * when size elements are split in contiguous ranges, one per thread, in
+ * the order of the threads. The first size % numberOfThreads ranges have
+ * one more element. The sums of the ranges can then be merged in the
+ * order of the threads, for the results to not depend on their
+ * scheduling. */
+template< typename TSize >
+inline void
+GetThreadRange(TSize size, ThreadIdType threadId, ThreadIdType numberOfThreads,
+               TSize & begin, TSize & end)
+{
+  const TSize quotient = size / numberOfThreads;
+  const TSize remainder = size % numberOfThreads;
+
+  begin = quotient * threadId + std::min( static_cast< TSize >( threadId ), remainder );
+  end = begin + quotient + ( threadId < remainder ? 1 : 0 );
+}
+
+/** \class SampleRangeConstIterator
+ * \brief Forward iterator over the measurement vectors of a sample, from a
+ * given instance identifier.
+ *
+ * Most samples fill a temporary measurement vector in
+ * GetMeasurementVector(), like the adaptors of images and point sets or
+ * the histograms, so several threads can only read them through their own
+ * iterators. This iterator then advances an iterator of the sample from
+ * Begin() to the first instance identifier, so its construction takes a
+ * time proportional to that identifier: the threads of the last ranges
+ * start after stepping over the ranges of the other threads. Only for a
+ * ListSample, which stores its measurement vectors and is read by
+ * instance identifier, does the construction take constant time.
+ *
+ * \ingroup ITKStatistics
+ */
+template< typename TSample >
+class SampleRangeConstIterator
+{
+public:
+  typedef typename TSample::MeasurementVectorType MeasurementVectorType;
+  typedef typename TSample::AbsoluteFrequencyType AbsoluteFrequencyType;
+  typedef typename TSample::InstanceIdentifier    InstanceIdentifier;
+
+  SampleRangeConstIterator(const TSample *sample, InstanceIdentifier begin):
+    m_Iterator( sample->Begin() )
+  {
+    for ( InstanceIdentifier i = 0; i < begin; ++i )
+      {
+      ++m_Iterator;
+      }
+  }
+
+  const MeasurementVectorType & GetMeasurementVector() const
+  {
+    return m_Iterator.GetMeasurementVector();
+  }
+
+  AbsoluteFrequencyType GetFrequency() const
+  {
+    return m_Iterator.GetFrequency();
+  }
+
+  SampleRangeConstIterator & operator++()
+  {
+    ++m_Iterator;
+    return *this;
+  }
+
+private:
+  typename TSample::ConstIterator m_Iterator;
+};
+
+/** \class SampleRangeConstIterator
+ * \brief Random access specialization of SampleRangeConstIterator for
+ * ListSample.
+ * \ingroup ITKStatistics
+ */
+template< typename TMeasurementVector >
+class SampleRangeConstIterator< ListSample< TMeasurementVector > >
+{
+public:
+  typedef ListSample< TMeasurementVector >          SampleType;
+  typedef typename SampleType::MeasurementVectorType MeasurementVectorType;
+  typedef typename SampleType::AbsoluteFrequencyType AbsoluteFrequencyType;
+  typedef typename SampleType::InstanceIdentifier    InstanceIdentifier;
+
+  SampleRangeConstIterator(const SampleType *sample, InstanceIdentifier begin):
+    m_Sample(sample),
+    m_InstanceIdentifier(begin)
+  {}
+
+  const MeasurementVectorType & GetMeasurementVector() const
+  {
+    return m_Sample->GetMeasurementVector(m_InstanceIdentifier);
+  }
+
+  AbsoluteFrequencyType GetFrequency() const
+  {
+    return m_Sample->GetFrequency(m_InstanceIdentifier);
+  }
+
+  SampleRangeConstIterator & operator++()
+  {
+    ++m_InstanceIdentifier;
+    return *this;
+  }
+
+private:
+  const SampleType  *m_Sample;
+  InstanceIdentifier m_InstanceIdentifier;
+};
+} // end of namespace Statistics
+} // end of namespace itk
+
+#endif
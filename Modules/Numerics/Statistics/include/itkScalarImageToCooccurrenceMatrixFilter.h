@@ -63,6 +63,13 @@ namespace Statistics
  * offset falls outside of the requested region at a particular point, that
  * co-occurrence pair will not be added to the matrix.
  *
+ * The pixels are first mapped to their bins, and the pairs of all the offsets
+ * are then counted in a single pass over the image by multiple threads, each
+ * one in its own dense matrix. The matrices of the threads are summed in the
+ * output histogram at the end. When the matrices would be too large, with a
+ * very large number of bins, the pairs are counted by a single thread,
+ * directly in the output histogram.
+ *
  * The number of histogram bins on each axis can be set (defaults to 256). Also,
  * by default the histogram min and max corresponds to the largest and smallest
  * possible pixel value of that pixel type. To customize the histogram bounds
@@ -194,6 +201,41 @@ private:
 
   void NormalizeHistogram();
 
+  typedef typename HistogramType::AbsoluteFrequencyType AbsoluteFrequencyType;
+
+  /** Image of the bins of the pixels. The pixels out of the bounds of the
+   * histogram, or out of the mask, are in the extra bin
+   * NumberOfBinsPerAxis. */
+  typedef Image< unsigned int, ImageType::ImageDimension > BinImageType;
+
+  struct FillThreadStruct
+  {
+    Self                                                *Filter;
+    const ImageType                                     *MaskImage;
+    typename BinImageType::Pointer                      BinImage;
+    RegionType                                          Region;
+    unsigned int                                        NumberOfPieces;
+    std::vector< std::vector< AbsoluteFrequencyType > > Matrices;
+  };
+
+  static ITK_THREAD_RETURN_TYPE QuantizeThreaderCallback(void *arg);
+
+  static ITK_THREAD_RETURN_TYPE FillThreaderCallback(void *arg);
+
+  /** Fill the histogram with the pairs of the pixels of the region,
+   * using the mask image if it is not null. */
+  void FillHistogramWithBins(const RegionType & region, const ImageType *maskImage);
+
+  /** Compute the bins of the pixels of a region. */
+  void ThreadedQuantize(const RegionType & region, const ImageType *maskImage, BinImageType *binImage);
+
+  /** Count the pairs of the pixels of a region in a matrix of
+   * (NumberOfBinsPerAxis + 1)^2 elements, indexed by the bin of the pixel
+   * and the bin of its neighbor, or directly in the output histogram if
+   * the matrix is null. */
+  void ThreadedFillMatrix(const RegionType & region, const BinImageType *binImage,
+                          AbsoluteFrequencyType *matrix);
+
   OffsetVectorConstPointer m_Offsets;
   PixelType                m_Min;
   PixelType                m_Max;
@@ -20,7 +20,9 @@
 
 #include "itkScalarImageToCooccurrenceMatrixFilter.h"
 
-#include "itkConstNeighborhoodIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionSplitterSlowDimension.h"
+#include "itkImageScanlineConstIterator.h"
 #include "itkMath.h"
 
 namespace itk
@@ -202,147 +204,265 @@ ScalarImageToCooccurrenceMatrixFilter< TImageType,
 template< typename TImageType, typename THistogramFrequencyContainer >
 void
 ScalarImageToCooccurrenceMatrixFilter< TImageType,
-                                       THistogramFrequencyContainer >::FillHistogram(RadiusType radius,
+                                       THistogramFrequencyContainer >::FillHistogram(RadiusType itkNotUsed(radius),
                                                                                      RegionType region)
 {
-  // Iterate over all of those pixels and offsets, adding each
-  // co-occurrence pair to the histogram
+  this->FillHistogramWithBins(region, ITK_NULLPTR);
+}
+
+template< typename TImageType, typename THistogramFrequencyContainer >
+void
+ScalarImageToCooccurrenceMatrixFilter< TImageType,
+                                       THistogramFrequencyContainer >::FillHistogramWithMask(RadiusType itkNotUsed(radius),
+                                                                                             RegionType region,
+                                                                                             const ImageType *maskImage)
+{
+  this->FillHistogramWithBins(region, maskImage);
+}
 
+template< typename TImageType, typename THistogramFrequencyContainer >
+void
+ScalarImageToCooccurrenceMatrixFilter< TImageType,
+                                       THistogramFrequencyContainer >::FillHistogramWithBins(const RegionType & region,
+                                                                                             const ImageType *maskImage)
+{
   const ImageType *input = this->GetInput();
 
   HistogramType *output =
     static_cast< HistogramType * >( this->ProcessObject::GetOutput(0) );
 
-  typedef ConstNeighborhoodIterator< ImageType > NeighborhoodIteratorType;
-  NeighborhoodIteratorType neighborIt;
-  neighborIt = NeighborhoodIteratorType(radius, input, region);
-
-  MeasurementVectorType cooccur( output->GetMeasurementVectorSize() );
+  // The neighbors of the pixels of the region may be anywhere in the
+  // buffered region of the input
+  const RegionType & bufferedRegion = input->GetBufferedRegion();
+
+  FillThreadStruct str;
+  str.Filter = this;
+  str.MaskImage = maskImage;
+  str.BinImage = BinImageType::New();
+  str.BinImage->CopyInformation(input);
+  str.BinImage->SetRegions(bufferedRegion);
+  str.BinImage->Allocate();
+
+  MultiThreader *multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfThreads( this->GetNumberOfThreads() );
+  const ThreadIdType numberOfThreads = multiThreader->GetNumberOfThreads();
+
+  typename ImageRegionSplitterSlowDimension::Pointer splitter = ImageRegionSplitterSlowDimension::New();
+
+  // First map the pixels to their bins
+  str.Region = bufferedRegion;
+  str.NumberOfPieces = splitter->GetNumberOfSplits(str.Region, numberOfThreads);
+  multiThreader->SetSingleMethod(this->QuantizeThreaderCallback, &str);
+  multiThreader->SingleMethodExecute();
+
+  // Then count the pairs, each thread in its own matrix. The pixels out of
+  // the bounds of the histogram or of the mask are counted in the extra
+  // row and column of the matrices, which are ignored.
+  const SizeValueType matrixSize =
+    static_cast< SizeValueType >( m_NumberOfBinsPerAxis + 1 ) * ( m_NumberOfBinsPerAxis + 1 );
+  const SizeValueType maximumMatricesSize = 1 << 24;
+
+  str.Region = region;
+  if ( matrixSize > maximumMatricesSize )
+    {
+    this->ThreadedFillMatrix(region, str.BinImage, ITK_NULLPTR);
+    return;
+    }
 
-  for ( neighborIt.GoToBegin(); !neighborIt.IsAtEnd(); ++neighborIt )
+  str.NumberOfPieces = std::min( splitter->GetNumberOfSplits(str.Region, numberOfThreads),
+                                 static_cast< unsigned int >( maximumMatricesSize / matrixSize ) );
+  str.Matrices.resize(str.NumberOfPieces);
+  for ( unsigned int i = 0; i < str.NumberOfPieces; ++i )
     {
-    const PixelType centerPixelIntensity = neighborIt.GetCenterPixel();
-    if ( centerPixelIntensity < m_Min
-         || centerPixelIntensity > m_Max )
-      {
-      continue; // don't put a pixel in the histogram if the value
-                // is out-of-bounds.
-      }
+    str.Matrices[i].resize(matrixSize, NumericTraits< AbsoluteFrequencyType >::ZeroValue());
+    }
+  multiThreader->SetNumberOfThreads(str.NumberOfPieces);
+  multiThreader->SetSingleMethod(this->FillThreaderCallback, &str);
+  multiThreader->SingleMethodExecute();
 
-    typename OffsetVector::ConstIterator offsets;
-    typename HistogramType::IndexType index;
-    for ( offsets = m_Offsets->Begin(); offsets != m_Offsets->End(); offsets++ )
+  // Each pair is counted in both orders in the histogram
+  typename HistogramType::IndexType index( output->GetMeasurementVectorSize() );
+  for ( unsigned int i = 0; i < m_NumberOfBinsPerAxis; ++i )
+    {
+    for ( unsigned int j = 0; j < m_NumberOfBinsPerAxis; ++j )
       {
-      bool            pixelInBounds;
-      const PixelType pixelIntensity =
-        neighborIt.GetPixel(offsets.Value(), pixelInBounds);
-
-      if ( !pixelInBounds )
+      AbsoluteFrequencyType frequency = NumericTraits< AbsoluteFrequencyType >::ZeroValue();
+      for ( unsigned int t = 0; t < str.NumberOfPieces; ++t )
         {
-        continue; // don't put a pixel in the histogram if it's out-of-bounds.
+        frequency += str.Matrices[t][i * ( m_NumberOfBinsPerAxis + 1 ) + j]
+                     + str.Matrices[t][j * ( m_NumberOfBinsPerAxis + 1 ) + i];
         }
-
-      if ( pixelIntensity < m_Min
-           || pixelIntensity > m_Max )
+      if ( frequency > 0 )
         {
-        continue; // don't put a pixel in the histogram if the value
-                  // is out-of-bounds.
+        index[0] = i;
+        index[1] = j;
+        output->IncreaseFrequencyOfIndex(index, frequency);
         }
+      }
+    }
+}
 
-      // Now make both possible co-occurrence combinations and increment the
-      // histogram with them.
+template< typename TImageType, typename THistogramFrequencyContainer >
+ITK_THREAD_RETURN_TYPE
+ScalarImageToCooccurrenceMatrixFilter< TImageType,
+                                       THistogramFrequencyContainer >::QuantizeThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  FillThreadStruct *str = static_cast< FillThreadStruct * >( info->UserData );
 
-      cooccur[0] = centerPixelIntensity;
-      cooccur[1] = pixelIntensity;
-      output->GetIndex( cooccur, index );
-      output->IncreaseFrequencyOfIndex( index, 1 );
+  const ThreadIdType threadId = info->ThreadID;
+  if ( threadId < str->NumberOfPieces )
+    {
+    typename ImageRegionSplitterSlowDimension::Pointer splitter = ImageRegionSplitterSlowDimension::New();
+    RegionType region = str->Region;
+    splitter->GetSplit(threadId, str->NumberOfPieces, region);
+    str->Filter->ThreadedQuantize(region, str->MaskImage, str->BinImage);
+    }
 
-      cooccur[1] = centerPixelIntensity;
-      cooccur[0] = pixelIntensity;
-      output->GetIndex( cooccur, index );
-      output->IncreaseFrequencyOfIndex( index, 1 );
-      }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TImageType, typename THistogramFrequencyContainer >
+ITK_THREAD_RETURN_TYPE
+ScalarImageToCooccurrenceMatrixFilter< TImageType,
+                                       THistogramFrequencyContainer >::FillThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  FillThreadStruct *str = static_cast< FillThreadStruct * >( info->UserData );
+
+  const ThreadIdType threadId = info->ThreadID;
+  if ( threadId < str->NumberOfPieces )
+    {
+    typename ImageRegionSplitterSlowDimension::Pointer splitter = ImageRegionSplitterSlowDimension::New();
+    RegionType region = str->Region;
+    splitter->GetSplit(threadId, str->NumberOfPieces, region);
+    str->Filter->ThreadedFillMatrix( region, str->BinImage, &str->Matrices[threadId][0] );
     }
+
+  return ITK_THREAD_RETURN_VALUE;
 }
 
 template< typename TImageType, typename THistogramFrequencyContainer >
 void
 ScalarImageToCooccurrenceMatrixFilter< TImageType,
-                                       THistogramFrequencyContainer >::FillHistogramWithMask(RadiusType radius,
-                                                                                             RegionType region,
-                                                                                             const ImageType *maskImage)
+                                       THistogramFrequencyContainer >::ThreadedQuantize(const RegionType & region,
+                                                                                        const ImageType *maskImage,
+                                                                                        BinImageType *binImage)
 {
-  // Iterate over all of those pixels and offsets, adding each
-  // co-occurrence pair to the histogram
+  const HistogramType *output = this->GetOutput();
 
-  const ImageType *input = this->GetInput();
+  MeasurementVectorType             measurement( output->GetMeasurementVectorSize() );
+  typename HistogramType::IndexType index( output->GetMeasurementVectorSize() );
+
+  ImageRegionConstIterator< ImageType > inputIt(this->GetInput(), region);
+  ImageRegionIterator< BinImageType >   binIt(binImage, region);
+  ImageRegionConstIterator< ImageType > maskIt;
+  if ( maskImage != ITK_NULLPTR )
+    {
+    maskIt = ImageRegionConstIterator< ImageType >(maskImage, region);
+    }
+  for (; !inputIt.IsAtEnd(); ++inputIt, ++binIt )
+    {
+    const PixelType pixelIntensity = inputIt.Get();
+    unsigned int    bin = m_NumberOfBinsPerAxis;
+    if ( pixelIntensity >= m_Min && pixelIntensity <= m_Max
+         && ( maskImage == ITK_NULLPTR || maskIt.Get() == m_InsidePixelValue ) )
+      {
+      measurement.Fill(pixelIntensity);
+      if ( output->GetIndex(measurement, index) )
+        {
+        bin = static_cast< unsigned int >( index[0] );
+        }
+      }
+    binIt.Set(bin);
+    if ( maskImage != ITK_NULLPTR )
+      {
+      ++maskIt;
+      }
+    }
+}
+
+template< typename TImageType, typename THistogramFrequencyContainer >
+void
+ScalarImageToCooccurrenceMatrixFilter< TImageType,
+                                       THistogramFrequencyContainer >::ThreadedFillMatrix(const RegionType & region,
+                                                                                          const BinImageType *binImage,
+                                                                                          AbsoluteFrequencyType *matrix)
+{
+  const unsigned int ImageDimension = ImageType::ImageDimension;
 
   HistogramType *output =
     static_cast< HistogramType * >( this->ProcessObject::GetOutput(0) );
 
-  // Iterate over all of those pixels and offsets, adding each
-  // co-occurrence pair to the histogram
-  typedef ConstNeighborhoodIterator< ImageType > NeighborhoodIteratorType;
-  NeighborhoodIteratorType neighborIt, maskNeighborIt;
-  neighborIt = NeighborhoodIteratorType(radius, input, region);
-  maskNeighborIt = NeighborhoodIteratorType(radius, maskImage, region);
-
-  MeasurementVectorType cooccur( output->GetMeasurementVectorSize() );
-  typename HistogramType::IndexType index;
-  for ( neighborIt.GoToBegin(), maskNeighborIt.GoToBegin();
-        !neighborIt.IsAtEnd(); ++neighborIt, ++maskNeighborIt )
+  const RegionType & bufferedRegion = binImage->GetBufferedRegion();
+  const typename RegionType::IndexType bufferedStart = bufferedRegion.GetIndex();
+  const typename RegionType::SizeType  bufferedSize = bufferedRegion.GetSize();
+
+  // Offsets in the buffer of the neighbors of all the offsets
+  std::vector< OffsetType >      offsets;
+  std::vector< OffsetValueType > bufferOffsets;
+  typename OffsetVector::ConstIterator offsetIt;
+  for ( offsetIt = m_Offsets->Begin(); offsetIt != m_Offsets->End(); ++offsetIt )
     {
-    if ( maskNeighborIt.GetCenterPixel() != m_InsidePixelValue )
-      {
-      continue; // Go to the next loop if we're not in the mask
-      }
+    offsets.push_back( offsetIt.Value() );
+    bufferOffsets.push_back( binImage->ComputeOffset( bufferedStart + offsetIt.Value() ) );
+    }
 
-    const PixelType centerPixelIntensity = neighborIt.GetCenterPixel();
+  const unsigned int           matrixStride = m_NumberOfBinsPerAxis + 1;
+  const unsigned int * const   bins = binImage->GetBufferPointer();
+  const OffsetValueType        lineLength = region.GetSize(0);
+  typename HistogramType::IndexType index( output->GetMeasurementVectorSize() );
 
-    if ( centerPixelIntensity < this->GetMin()
-         || centerPixelIntensity > this->GetMax() )
+  // Count the pairs of all the offsets, line by line
+  for ( ImageScanlineConstIterator< BinImageType > it(binImage, region); !it.IsAtEnd(); it.NextLine() )
+    {
+    const typename RegionType::IndexType lineStart = it.GetIndex();
+    const unsigned int *line = bins + binImage->ComputeOffset(lineStart);
+    for ( unsigned int o = 0; o < offsets.size(); ++o )
       {
-      continue; // don't put a pixel in the histogram if the value
-                // is out-of-bounds.
-      }
+      const OffsetType & offset = offsets[o];
 
-    typename OffsetVector::ConstIterator offsets;
-    for ( offsets = this->GetOffsets()->Begin(); offsets != this->GetOffsets()->End(); offsets++ )
-      {
-      if ( maskNeighborIt.GetPixel( offsets.Value() ) != m_InsidePixelValue )
+      // The neighbor line must be in the buffered region
+      bool lineInBounds = true;
+      for ( unsigned int d = 1; d < ImageDimension; ++d )
         {
-        continue; // Go to the next loop if we're not in the mask
+        const IndexValueType neighbor = lineStart[d] + offset[d];
+        lineInBounds = lineInBounds && neighbor >= bufferedStart[d]
+                       && neighbor < bufferedStart[d] + static_cast< IndexValueType >( bufferedSize[d] );
         }
-
-      bool            pixelInBounds;
-      const PixelType pixelIntensity =
-        neighborIt.GetPixel(offsets.Value(), pixelInBounds);
-
-      if ( !pixelInBounds )
+      if ( !lineInBounds )
         {
-        continue; // don't put a pixel in the histogram if it's out-of-bounds.
+        continue;
         }
 
-      if ( pixelIntensity < this->GetMin()
-           || pixelIntensity > this->GetMax() )
+      const OffsetValueType begin =
+        std::max( NumericTraits< OffsetValueType >::ZeroValue(), bufferedStart[0] - offset[0] - lineStart[0] );
+      const OffsetValueType end =
+        std::min( lineLength, bufferedStart[0] + static_cast< OffsetValueType >( bufferedSize[0] )
+                              - offset[0] - lineStart[0] );
+      const unsigned int *neighbors = line + bufferOffsets[o];
+      if ( matrix != ITK_NULLPTR )
         {
-        continue; // don't put a pixel in the histogram if the value
-                  // is out-of-bounds.
+        for ( OffsetValueType x = begin; x < end; ++x )
+          {
+          ++matrix[line[x] * matrixStride + neighbors[x]];
+          }
+        }
+      else
+        {
+        for ( OffsetValueType x = begin; x < end; ++x )
+          {
+          if ( line[x] < m_NumberOfBinsPerAxis && neighbors[x] < m_NumberOfBinsPerAxis )
+            {
+            index[0] = line[x];
+            index[1] = neighbors[x];
+            output->IncreaseFrequencyOfIndex(index, 1);
+            index[0] = neighbors[x];
+            index[1] = line[x];
+            output->IncreaseFrequencyOfIndex(index, 1);
+            }
+          }
         }
-
-      // Now make both possible co-occurrence combinations and increment the
-      // histogram with them.
-
-      cooccur[0] = centerPixelIntensity;
-      cooccur[1] = pixelIntensity;
-      output->GetIndex( cooccur, index );
-      output->IncreaseFrequencyOfIndex(index, 1);
-
-
-      cooccur[1] = centerPixelIntensity;
-      cooccur[0] = pixelIntensity;
-      output->GetIndex( cooccur, index );
-      output->IncreaseFrequencyOfIndex(index, 1);
       }
     }
 }
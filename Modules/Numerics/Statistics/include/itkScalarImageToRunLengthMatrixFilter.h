@@ -92,6 +92,14 @@ namespace Statistics
  * NumericTraits class is the same, and thus cannot hold any larger values,
  * this would cause a float overflow.
  *
+ * The pixels are first mapped to their intensity bins. The runs starting in
+ * different parts of the image are then followed by multiple threads, for all
+ * the offsets in a single pass over each part, and counted in a dense matrix
+ * for each thread. The matrices of the threads are summed in the output
+ * histogram at the end. A pixel starts a run if the previous pixel along the
+ * offset is not in the same run, which does not depend on the order in which
+ * the pixels are visited.
+ *
  * IJ article: https://hdl.handle.net/1926/1374
  *
  * \sa ScalarImageToRunLengthFeaturesFilter
@@ -257,6 +265,41 @@ protected:
 
 private:
 
+  typedef typename HistogramType::AbsoluteFrequencyType   AbsoluteFrequencyType;
+
+  /**
+   * Image of the intensity bins of the pixels. The pixels out of the
+   * intensity bounds of the histogram are in the extra bin
+   * NumberOfBinsPerAxis, and the pixels out of the mask are flagged with
+   * MaskedOutBin.
+   */
+  typedef Image<unsigned int, ImageDimension>             BinImageType;
+
+  static const unsigned int MaskedOutBin = 1u << 31;
+
+  struct FillThreadStruct
+  {
+    Self                                               *Filter;
+    typename BinImageType::Pointer                     BinImage;
+    unsigned int                                       NumberOfPieces;
+    std::vector<std::vector<AbsoluteFrequencyType> >   Matrices;
+  };
+
+  static ITK_THREAD_RETURN_TYPE QuantizeThreaderCallback( void *arg );
+
+  static ITK_THREAD_RETURN_TYPE FillThreaderCallback( void *arg );
+
+  /** Compute the bins of the pixels of a region. */
+  void ThreadedQuantize( const RegionType & region, BinImageType *binImage );
+
+  /**
+   * Count the runs starting in a region in a matrix of NumberOfBinsPerAxis^2
+   * elements, indexed by the bin of the intensity and the bin of the
+   * distance, or directly in the output histogram if the matrix is null.
+   */
+  void ThreadedFillMatrix( const RegionType & region,
+    const BinImageType *binImage, AbsoluteFrequencyType *matrix );
+
   unsigned int             m_NumberOfBinsPerAxis;
   PixelType                m_Min;
   PixelType                m_Max;
@@ -20,8 +20,9 @@
 
 #include "itkScalarImageToRunLengthMatrixFilter.h"
 
-#include "itkConstNeighborhoodIterator.h"
-#include "itkNeighborhood.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionSplitterSlowDimension.h"
 #include "itkMath.h"
 #include "itkMacro.h"
 #include "itkMath.h"
@@ -153,141 +154,266 @@ ScalarImageToRunLengthMatrixFilter<TImageType, THistogramFrequencyContainer>
   this->m_UpperBound[1] = this->m_MaxDistance;
   output->Initialize( size, this->m_LowerBound, this->m_UpperBound );
 
-  MeasurementVectorType run( output->GetMeasurementVectorSize() );
-  typename HistogramType::IndexType hIndex;
-
-  // Iterate over all of those pixels and offsets, adding each
-  // distance/intensity pair to the histogram
-
-  typedef ConstNeighborhoodIterator<ImageType> NeighborhoodIteratorType;
-  typename NeighborhoodIteratorType::RadiusType radius;
-  radius.Fill( 1 );
-  NeighborhoodIteratorType neighborIt( radius,
-    inputImage, inputImage->GetRequestedRegion() );
-
-
-  // this temp image has the same dimension for each offset
-  // moving the allocation out of loop of offsets
-  // while keeping FillBuffer with boolean false in each loop
-  typedef Image<bool, ImageDimension> BoolImageType;
-  typename BoolImageType::Pointer alreadyVisitedImage = BoolImageType::New();
-  alreadyVisitedImage->CopyInformation( inputImage );
-  alreadyVisitedImage->SetRegions( inputImage->GetRequestedRegion() );
-  alreadyVisitedImage->Allocate();
-
-  typename OffsetVector::ConstIterator offsets;
-  for( offsets = this->GetOffsets()->Begin();
-    offsets != this->GetOffsets()->End(); offsets++ )
+  FillThreadStruct str;
+  str.Filter = this;
+  str.BinImage = BinImageType::New();
+  str.BinImage->CopyInformation( inputImage );
+  str.BinImage->SetRegions( inputImage->GetRequestedRegion() );
+  str.BinImage->Allocate();
+
+  MultiThreader *multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfThreads( this->GetNumberOfThreads() );
+  const ThreadIdType numberOfThreads = multiThreader->GetNumberOfThreads();
+
+  typename ImageRegionSplitterSlowDimension::Pointer splitter =
+    ImageRegionSplitterSlowDimension::New();
+
+  // First map the pixels to their intensity bins
+  str.NumberOfPieces = splitter->GetNumberOfSplits(
+    inputImage->GetRequestedRegion(), numberOfThreads );
+  multiThreader->SetSingleMethod( this->QuantizeThreaderCallback, &str );
+  multiThreader->SingleMethodExecute();
+
+  // Then follow the runs, each thread counting them in its own matrix
+  const SizeValueType matrixSize =
+    static_cast<SizeValueType>( this->m_NumberOfBinsPerAxis ) *
+    this->m_NumberOfBinsPerAxis;
+  const SizeValueType maximumMatricesSize = 1 << 24;
+  if( matrixSize > maximumMatricesSize )
     {
+    this->ThreadedFillMatrix( inputImage->GetRequestedRegion(), str.BinImage,
+      ITK_NULLPTR );
+    return;
+    }
 
-    alreadyVisitedImage->FillBuffer( false );
-
-    neighborIt.GoToBegin();
-    OffsetType offset = offsets.Value();
-
-    this->NormalizeOffsetDirection(offset);
-
+  str.NumberOfPieces = std::min( str.NumberOfPieces,
+    static_cast<unsigned int>( maximumMatricesSize / matrixSize ) );
+  str.Matrices.resize( str.NumberOfPieces );
+  for( unsigned int i = 0; i < str.NumberOfPieces; ++i )
+    {
+    str.Matrices[i].resize( matrixSize,
+      NumericTraits<AbsoluteFrequencyType>::ZeroValue() );
+    }
+  multiThreader->SetNumberOfThreads( str.NumberOfPieces );
+  multiThreader->SetSingleMethod( this->FillThreaderCallback, &str );
+  multiThreader->SingleMethodExecute();
 
-    for( neighborIt.GoToBegin(); !neighborIt.IsAtEnd(); ++neighborIt )
+  typename HistogramType::IndexType hIndex( output->GetMeasurementVectorSize() );
+  for( unsigned int i = 0; i < this->m_NumberOfBinsPerAxis; ++i )
+    {
+    for( unsigned int j = 0; j < this->m_NumberOfBinsPerAxis; ++j )
       {
-      const PixelType centerPixelIntensity = neighborIt.GetCenterPixel();
-      IndexType centerIndex = neighborIt.GetIndex();
-      if( centerPixelIntensity < this->m_Min ||
-        centerPixelIntensity > this->m_Max ||
-        alreadyVisitedImage->GetPixel( centerIndex ) || ( this->GetMaskImage() &&
-        this->GetMaskImage()->GetPixel( centerIndex ) !=
-        this->m_InsidePixelValue ) )
+      AbsoluteFrequencyType frequency =
+        NumericTraits<AbsoluteFrequencyType>::ZeroValue();
+      for( unsigned int t = 0; t < str.NumberOfPieces; ++t )
+        {
+        frequency += str.Matrices[t][i * this->m_NumberOfBinsPerAxis + j];
+        }
+      if( frequency > 0 )
         {
-        continue; // don't put a pixel in the histogram if the value
-                  // is out-of-bounds or is outside the mask.
+        hIndex[0] = i;
+        hIndex[1] = j;
+        output->IncreaseFrequencyOfIndex( hIndex, frequency );
         }
+      }
+    }
+}
 
-      itkDebugMacro("===> offset = " << offset << std::endl);
+template<typename TImageType, typename THistogramFrequencyContainer>
+ITK_THREAD_RETURN_TYPE
+ScalarImageToRunLengthMatrixFilter<TImageType, THistogramFrequencyContainer>
+::QuantizeThreaderCallback( void *arg )
+{
+  MultiThreader::ThreadInfoStruct *info =
+    static_cast<MultiThreader::ThreadInfoStruct *>( arg );
+  FillThreadStruct *str = static_cast<FillThreadStruct *>( info->UserData );
 
-      MeasurementType centerBinMin = this->GetOutput()->
-        GetBinMinFromValue( 0, centerPixelIntensity );
-      MeasurementType centerBinMax = this->GetOutput()->
-        GetBinMaxFromValue( 0, centerPixelIntensity );
-      MeasurementType lastBinMax = this->GetOutput()->
-              GetDimensionMaxs( 0 )[ this->GetOutput()->GetSize( 0 ) - 1 ];
+  const ThreadIdType threadId = info->ThreadID;
+  if( threadId < str->NumberOfPieces )
+    {
+    typename ImageRegionSplitterSlowDimension::Pointer splitter =
+      ImageRegionSplitterSlowDimension::New();
+    RegionType region = str->BinImage->GetBufferedRegion();
+    splitter->GetSplit( threadId, str->NumberOfPieces, region );
+    str->Filter->ThreadedQuantize( region, str->BinImage );
+    }
 
-      PixelType pixelIntensity( NumericTraits<PixelType>::ZeroValue() );
-      IndexType index;
+  return ITK_THREAD_RETURN_VALUE;
+}
 
-      index = centerIndex + offset;
-      IndexType lastGoodIndex = centerIndex;
-      bool runLengthSegmentAlreadyVisited = false;
+template<typename TImageType, typename THistogramFrequencyContainer>
+ITK_THREAD_RETURN_TYPE
+ScalarImageToRunLengthMatrixFilter<TImageType, THistogramFrequencyContainer>
+::FillThreaderCallback( void *arg )
+{
+  MultiThreader::ThreadInfoStruct *info =
+    static_cast<MultiThreader::ThreadInfoStruct *>( arg );
+  FillThreadStruct *str = static_cast<FillThreadStruct *>( info->UserData );
 
-      // Scan from the current pixel at index, following
-      // the direction of offset. Run length is computed as the
-      // length of continuous pixels whose pixel values are
-      // in the same bin.
+  const ThreadIdType threadId = info->ThreadID;
+  if( threadId < str->NumberOfPieces )
+    {
+    typename ImageRegionSplitterSlowDimension::Pointer splitter =
+      ImageRegionSplitterSlowDimension::New();
+    RegionType region = str->BinImage->GetBufferedRegion();
+    splitter->GetSplit( threadId, str->NumberOfPieces, region );
+    str->Filter->ThreadedFillMatrix( region, str->BinImage,
+      &str->Matrices[threadId][0] );
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template<typename TImageType, typename THistogramFrequencyContainer>
+void
+ScalarImageToRunLengthMatrixFilter<TImageType, THistogramFrequencyContainer>
+::ThreadedQuantize( const RegionType & region, BinImageType *binImage )
+{
+  const HistogramType *output = this->GetOutput();
+  const ImageType * maskImage = this->GetMaskImage();
 
-      while ( inputImage->GetRequestedRegion().IsInside(index) )
+  MeasurementVectorType measurement( output->GetMeasurementVectorSize() );
+  typename HistogramType::IndexType hIndex( output->GetMeasurementVectorSize() );
+  measurement[1] = this->m_MinDistance;
+
+  ImageRegionConstIterator<ImageType> inputIt( this->GetInput(), region );
+  ImageRegionIterator<BinImageType> binIt( binImage, region );
+  ImageRegionConstIterator<ImageType> maskIt;
+  if( maskImage )
+    {
+    maskIt = ImageRegionConstIterator<ImageType>( maskImage, region );
+    }
+  for( ; !inputIt.IsAtEnd(); ++inputIt, ++binIt )
+    {
+    const PixelType pixelIntensity = inputIt.Get();
+    unsigned int bin = this->m_NumberOfBinsPerAxis;
+    if( pixelIntensity >= this->m_Min && pixelIntensity <= this->m_Max )
+      {
+      // The intensity is the first measurement, whose bin is computed even
+      // if the distance is out of the bounds of the histogram
+      measurement[0] = pixelIntensity;
+      output->GetIndex( measurement, hIndex );
+      if( hIndex[0] < static_cast<IndexValueType>( this->m_NumberOfBinsPerAxis ) )
         {
-        // For the same offset, each run length segment can
-        // only be visited once
-        if (alreadyVisitedImage->GetPixel( index ) )
-          {
-          runLengthSegmentAlreadyVisited = true;
-          break;
-          }
+        bin = static_cast<unsigned int>( hIndex[0] );
+        }
+      }
+    if( maskImage )
+      {
+      if( maskIt.Get() != this->m_InsidePixelValue )
+        {
+        bin |= MaskedOutBin;
+        }
+      ++maskIt;
+      }
+    binIt.Set( bin );
+    }
+}
 
-        pixelIntensity = inputImage->GetPixel( index );
+template<typename TImageType, typename THistogramFrequencyContainer>
+void
+ScalarImageToRunLengthMatrixFilter<TImageType, THistogramFrequencyContainer>
+::ThreadedFillMatrix( const RegionType & region, const BinImageType *binImage,
+  AbsoluteFrequencyType *matrix )
+{
+  HistogramType *output =
+    static_cast<HistogramType *>( this->ProcessObject::GetOutput( 0 ) );
+  const ImageType * inputImage = this->GetInput();
+  const RegionType & requestedRegion = binImage->GetBufferedRegion();
 
-        // Special attention paid to boundaries of bins.
-        // For the last bin,
-        // it is left close and right close (following the previous
-        // gerrit patch).
-        // For all
-        // other bins,
-        // the bin is left close and right open.
+  std::vector<OffsetType> offsets;
+  std::vector<OffsetValueType> bufferOffsets;
+  typename OffsetVector::ConstIterator offsetIt;
+  for( offsetIt = this->GetOffsets()->Begin();
+    offsetIt != this->GetOffsets()->End(); offsetIt++ )
+    {
+    OffsetType offset = offsetIt.Value();
+    this->NormalizeOffsetDirection( offset );
+    offsets.push_back( offset );
+    bufferOffsets.push_back( binImage->ComputeOffset(
+      requestedRegion.GetIndex() + offset ) );
+    }
 
-        if ( pixelIntensity >= centerBinMin
-            && ( pixelIntensity < centerBinMax || ( Math::ExactlyEquals(pixelIntensity, centerBinMax) && Math::ExactlyEquals(centerBinMax, lastBinMax) ) ) )
-          {
-          alreadyVisitedImage->SetPixel( index, true );
-          lastGoodIndex = index;
-          index += offset;
-          }
-        else
+  MeasurementVectorType run( output->GetMeasurementVectorSize() );
+  typename HistogramType::IndexType hIndex( output->GetMeasurementVectorSize() );
+
+  const unsigned int * const bins = binImage->GetBufferPointer();
+
+  // Follow the runs of all the offsets starting at each pixel of the region
+  for( ImageRegionConstIteratorWithIndex<BinImageType> it( binImage, region );
+    !it.IsAtEnd(); ++it )
+    {
+    const unsigned int centerBin = it.Get();
+    if( centerBin >= this->m_NumberOfBinsPerAxis )
+      {
+      continue; // don't put a pixel in the histogram if the value
+                // is out-of-bounds or is outside the mask.
+      }
+
+    const IndexType centerIndex = it.GetIndex();
+    const unsigned int *center = bins + binImage->ComputeOffset( centerIndex );
+
+    for( unsigned int o = 0; o < offsets.size(); ++o )
+      {
+      const OffsetType & offset = offsets[o];
+      const OffsetValueType bufferOffset = bufferOffsets[o];
+
+      // The pixel is in the run of a previous pixel along the offset if
+      // the pixels in between are in the same bin, and the first one is
+      // in the mask. The pixels out of the mask only continue the runs.
+      bool alreadyVisited = false;
+      IndexType index = centerIndex - offset;
+      const unsigned int *pixel = center - bufferOffset;
+      while( requestedRegion.IsInside( index ) &&
+        ( *pixel & ~MaskedOutBin ) == centerBin )
+        {
+        if( !( *pixel & MaskedOutBin ) )
           {
+          alreadyVisited = true;
           break;
           }
+        index -= offset;
+        pixel -= bufferOffset;
         }
-
-      if ( runLengthSegmentAlreadyVisited )
+      if( alreadyVisited )
         {
         continue;
         }
 
+      // Scan from the current pixel at index, following
+      // the direction of offset. Run length is computed as the
+      // length of continuous pixels whose pixel values are
+      // in the same bin.
+      IndexType lastGoodIndex = centerIndex;
+      index = centerIndex + offset;
+      pixel = center + bufferOffset;
+      while( requestedRegion.IsInside( index ) &&
+        ( *pixel & ~MaskedOutBin ) == centerBin )
+        {
+        lastGoodIndex = index;
+        index += offset;
+        pixel += bufferOffset;
+        }
+
       PointType centerPoint;
-      inputImage->TransformIndexToPhysicalPoint(
-        centerIndex, centerPoint );
+      inputImage->TransformIndexToPhysicalPoint( centerIndex, centerPoint );
       PointType point;
       inputImage->TransformIndexToPhysicalPoint( lastGoodIndex, point );
 
-      run[0] = centerPixelIntensity;
+      run[0] = inputImage->GetPixel( centerIndex );
       run[1] = centerPoint.EuclideanDistanceTo( point );
 
-      if( run[1] >= this->m_MinDistance && run[1] <= this->m_MaxDistance )
+      if( run[1] >= this->m_MinDistance && run[1] <= this->m_MaxDistance &&
+        output->GetIndex( run, hIndex ) )
         {
-        output->GetIndex( run, hIndex );
-        output->IncreaseFrequencyOfIndex( hIndex, 1 );
-
-        itkDebugStatement(typename HistogramType::IndexType tempMeasurementIndex;)
-        itkDebugStatement(output->GetIndex(run,tempMeasurementIndex);)
-        itkDebugMacro( "centerIndex<->index: "
-            << static_cast<int>( centerPixelIntensity )
-            << "@"<< centerIndex
-                << "<->" << static_cast<int>( pixelIntensity ) << "@" << index
-                <<", Bin# " << tempMeasurementIndex
-                << ", Measurement: (" << run[0] << ", " << run[1] << ")"
-                << ", Center bin [" << this->GetOutput()->GetBinMinFromValue( 0, run[0] )
-                << "," << this->GetOutput()->GetBinMaxFromValue( 0, run[0] ) << "]"
-                << "~[" << this->GetOutput()->GetBinMinFromValue( 1, run[1] )
-                << "," << this->GetOutput()->GetBinMaxFromValue( 1, run[1] ) << "]"
-                << std::endl );
+        if( matrix )
+          {
+          ++matrix[hIndex[0] * this->m_NumberOfBinsPerAxis + hIndex[1]];
+          }
+        else
+          {
+          output->IncreaseFrequencyOfIndex( hIndex, 1 );
+          }
         }
       }
     }
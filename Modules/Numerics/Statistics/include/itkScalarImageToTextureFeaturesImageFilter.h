@@ -0,0 +1,200 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkScalarImageToTextureFeaturesImageFilter_h
+#define itkScalarImageToTextureFeaturesImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkHistogram.h"
+#include "itkVectorContainer.h"
+#include "itkVectorImage.h"
+
+namespace itk
+{
+namespace Statistics
+{
+/** \class ScalarImageToTextureFeaturesImageFilter
+ *  \brief This class computes a map of texture features, from the
+ * co-occurrence matrix of a neighborhood of each pixel.
+ *
+ * This filter computes, at each pixel, the texture features of
+ * HistogramToTextureFeaturesFilter from the grey-level co-occurrence matrix
+ * of a box of radius NeighborhoodRadius around the pixel. The co-occurrence
+ * matrix of a box is the one computed by
+ * ScalarImageToCooccurrenceMatrixFilter from an image restricted to the box:
+ * both pixels of a pair must be in the box, and in the mask if one is
+ * provided. The boxes are cropped at the border of the image.
+ *
+ * The output has one component per feature, in the order of
+ * HistogramToTextureFeaturesFilter::TextureFeatureName: Energy, Entropy,
+ * Correlation, InverseDifferenceMoment, Inertia, ClusterShade,
+ * ClusterProminence and HaralickCorrelation. The features of the pixels out
+ * of the mask are zero.
+ *
+ * Along each line of the image, the co-occurrence matrix is updated as the
+ * box moves by one pixel: only the pairs of the pixels leaving and entering
+ * the box are counted, instead of all the pairs of the box. The cost of a
+ * pixel is thus proportional to the size of a face of the box, times the
+ * number of offsets, plus the square of the number of bins for the
+ * features, which are computed from dense matrices. A small number of bins,
+ * like the default 8, is usually used for texture maps.
+ *
+ * As in ScalarImageToTextureFeaturesFilter, the default offsets are half
+ * of all the directions one pixel away, the other half being included by
+ * symmetry.
+ *
+ * \sa ScalarImageToCooccurrenceMatrixFilter
+ * \sa HistogramToTextureFeaturesFilter
+ * \sa ScalarImageToTextureFeaturesFilter
+ *
+ * \ingroup ITKStatistics
+ */
+
+template< typename TImageType,
+          typename TOutputImageType = VectorImage< float, TImageType::ImageDimension > >
+class ITK_TEMPLATE_EXPORT ScalarImageToTextureFeaturesImageFilter:
+  public ImageToImageFilter< TImageType, TOutputImageType >
+{
+public:
+  /** Standard typedefs */
+  typedef ScalarImageToTextureFeaturesImageFilter            Self;
+  typedef ImageToImageFilter< TImageType, TOutputImageType > Superclass;
+  typedef SmartPointer< Self >                               Pointer;
+  typedef SmartPointer< const Self >                         ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ScalarImageToTextureFeaturesImageFilter, ImageToImageFilter);
+
+  /** standard New() method support */
+  itkNewMacro(Self);
+
+  typedef TImageType                                   ImageType;
+  typedef typename ImageType::Pointer                  ImagePointer;
+  typedef typename ImageType::ConstPointer             ImageConstPointer;
+  typedef typename ImageType::PixelType                PixelType;
+  typedef typename ImageType::IndexType                IndexType;
+  typedef typename ImageType::RegionType               RegionType;
+  typedef typename ImageType::SizeType                 RadiusType;
+  typedef typename ImageType::OffsetType               OffsetType;
+  typedef VectorContainer< unsigned char, OffsetType > OffsetVector;
+  typedef typename OffsetVector::Pointer               OffsetVectorPointer;
+  typedef typename OffsetVector::ConstPointer          OffsetVectorConstPointer;
+
+  typedef TOutputImageType                     OutputImageType;
+  typedef typename OutputImageType::PixelType  OutputPixelType;
+  typedef typename OutputImageType::RegionType OutputImageRegionType;
+
+  typedef typename NumericTraits< PixelType >::RealType MeasurementType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, TImageType::ImageDimension);
+
+  itkStaticConstMacro(DefaultBinsPerAxis, unsigned int, 8);
+
+  /** Number of texture features, the components of the output. */
+  itkStaticConstMacro(NumberOfFeatures, unsigned int, 8);
+
+  /** Get/Set the offsets over which the co-occurrence pairs will be computed. */
+  itkSetConstObjectMacro(Offsets, OffsetVector);
+  itkGetConstObjectMacro(Offsets, OffsetVector);
+
+  void SetOffset(const OffsetType offset);
+
+  /** Set number of histogram bins along each axis */
+  itkSetMacro(NumberOfBinsPerAxis, unsigned int);
+  itkGetConstMacro(NumberOfBinsPerAxis, unsigned int);
+
+  /** Set the min and max (inclusive) pixel value that will be placed in the
+    histogram */
+  void SetPixelValueMinMax(PixelType min, PixelType max);
+
+  itkGetConstMacro(Min, PixelType);
+  itkGetConstMacro(Max, PixelType);
+
+  /** Set/Get the radius of the box around each pixel. Defaults to 2. */
+  itkSetMacro(NeighborhoodRadius, RadiusType);
+  itkGetConstReferenceMacro(NeighborhoodRadius, RadiusType);
+
+  /** Set/Get the mask image. */
+  itkSetInputMacro(MaskImage, ImageType);
+  itkGetInputMacro(MaskImage, ImageType);
+
+  /** Set the pixel value of the mask that should be considered "inside" the
+    object. Defaults to one. */
+  itkSetMacro(InsidePixelValue, PixelType);
+  itkGetConstMacro(InsidePixelValue, PixelType);
+
+protected:
+  ScalarImageToTextureFeaturesImageFilter();
+  virtual ~ScalarImageToTextureFeaturesImageFilter() {}
+  virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+  /** The output has one component per feature. */
+  virtual void GenerateOutputInformation() ITK_OVERRIDE;
+
+  /** The input is needed in the boxes of the requested pixels. */
+  virtual void GenerateInputRequestedRegion() ITK_OVERRIDE;
+
+  virtual void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+  virtual void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId) ITK_OVERRIDE;
+
+  virtual void AfterThreadedGenerateData() ITK_OVERRIDE;
+
+private:
+  ITK_DISALLOW_COPY_AND_ASSIGN(ScalarImageToTextureFeaturesImageFilter);
+
+  /** Image of the bins of the pixels. The pixels out of the bounds of the
+   * histogram, or out of the mask, are in the extra bin
+   * NumberOfBinsPerAxis. */
+  typedef Image< unsigned int, ImageDimension > BinImageType;
+
+  /** Add increment to the elements of the co-occurrence matrix of the
+   * pairs of the pixels of a box and of their neighbors at a given offset
+   * in the buffer of the bins. */
+  void UpdateMatrix(const RegionType & box, OffsetValueType neighborOffset,
+                    OffsetValueType increment, OffsetValueType *matrix) const;
+
+  /** Add increment to the elements of the co-occurrence matrix of all the
+   * pairs of a window which have one pixel in a slice of the window. */
+  void UpdateMatrixWithSlice(const RegionType & window, const RegionType & slice,
+                             OffsetValueType increment, OffsetValueType *matrix) const;
+
+  /** Compute the features of a co-occurrence matrix, which counts each
+   * pair once. */
+  void ComputeFeatures(const OffsetValueType *matrix, double *marginalSums, OutputPixelType & features) const;
+
+  OffsetVectorConstPointer       m_Offsets;
+  std::vector< OffsetType >      m_OffsetList;
+  std::vector< OffsetValueType > m_BufferOffsets;
+
+  PixelType    m_Min;
+  PixelType    m_Max;
+  unsigned int m_NumberOfBinsPerAxis;
+  RadiusType   m_NeighborhoodRadius;
+  PixelType    m_InsidePixelValue;
+
+  typename BinImageType::Pointer m_BinImage;
+};
+} // end of namespace Statistics
+} // end of namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkScalarImageToTextureFeaturesImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,490 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkScalarImageToTextureFeaturesImageFilter_hxx
+#define itkScalarImageToTextureFeaturesImageFilter_hxx
+
+#include "itkScalarImageToTextureFeaturesImageFilter.h"
+
+#include "itkImageRegionIterator.h"
+#include "itkImageScanlineIterator.h"
+#include "itkNeighborhood.h"
+#include "itkProgressReporter.h"
+#include "itkMath.h"
+
+namespace itk
+{
+namespace Statistics
+{
+template< typename TImageType, typename TOutputImageType >
+ScalarImageToTextureFeaturesImageFilter< TImageType, TOutputImageType >
+::ScalarImageToTextureFeaturesImageFilter()
+{
+  this->m_Min = NumericTraits< PixelType >::NonpositiveMin();
+  this->m_Max = NumericTraits< PixelType >::max();
+  this->m_NumberOfBinsPerAxis = DefaultBinsPerAxis;
+  this->m_NeighborhoodRadius.Fill(2);
+
+  //mask inside pixel value
+  this->m_InsidePixelValue = NumericTraits< PixelType >::OneValue();
+
+  // Set the offset directions to their defaults: half of all the possible
+  // directions 1 pixel away. (The other half is included by symmetry.)
+  typedef Neighborhood< PixelType, ImageDimension > NeighborhoodType;
+  NeighborhoodType hood;
+  hood.SetRadius(1);
+
+  OffsetVectorPointer offsets = OffsetVector::New();
+  for ( unsigned int d = 0; d < hood.GetCenterNeighborhoodIndex(); d++ )
+    {
+    offsets->push_back( hood.GetOffset(d) );
+    }
+  this->SetOffsets(offsets);
+}
+
+template< typename TImageType, typename TOutputImageType >
+void
+ScalarImageToTextureFeaturesImageFilter< TImageType, TOutputImageType >
+::SetOffset(const OffsetType offset)
+{
+  OffsetVectorPointer offsetVector = OffsetVector::New();
+
+  offsetVector->push_back(offset);
+  this->SetOffsets(offsetVector);
+}
+
+template< typename TImageType, typename TOutputImageType >
+void
+ScalarImageToTextureFeaturesImageFilter< TImageType, TOutputImageType >
+::SetPixelValueMinMax(PixelType min, PixelType max)
+{
+  itkDebugMacro("setting Min to " << min << "and Max to " << max);
+  m_Min = min;
+  m_Max = max;
+  this->Modified();
+}
+
+template< typename TImageType, typename TOutputImageType >
+void
+ScalarImageToTextureFeaturesImageFilter< TImageType, TOutputImageType >
+::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+
+  this->GetOutput()->SetNumberOfComponentsPerPixel(NumberOfFeatures);
+}
+
+template< typename TImageType, typename TOutputImageType >
+void
+ScalarImageToTextureFeaturesImageFilter< TImageType, TOutputImageType >
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  ImageType *input = const_cast< ImageType * >( this->GetInput() );
+  ImageType *maskImage = const_cast< ImageType * >( this->GetMaskImage() );
+  if ( !input )
+    {
+    return;
+    }
+
+  RegionType region = this->GetOutput()->GetRequestedRegion();
+  region.PadByRadius(m_NeighborhoodRadius);
+  region.Crop( input->GetLargestPossibleRegion() );
+
+  input->SetRequestedRegion(region);
+  if ( maskImage )
+    {
+    maskImage->SetRequestedRegion(region);
+    }
+}
+
+template< typename TImageType, typename TOutputImageType >
+void
+ScalarImageToTextureFeaturesImageFilter< TImageType, TOutputImageType >
+::BeforeThreadedGenerateData()
+{
+  const ImageType *input = this->GetInput();
+  const ImageType *maskImage = this->GetMaskImage();
+  const RegionType region = input->GetRequestedRegion();
+
+  m_BinImage = BinImageType::New();
+  m_BinImage->CopyInformation(input);
+  m_BinImage->SetRegions(region);
+  m_BinImage->Allocate();
+
+  m_OffsetList.clear();
+  m_BufferOffsets.clear();
+  typename OffsetVector::ConstIterator offsets;
+  for ( offsets = m_Offsets->Begin(); offsets != m_Offsets->End(); offsets++ )
+    {
+    m_OffsetList.push_back( offsets.Value() );
+    m_BufferOffsets.push_back( m_BinImage->ComputeOffset( region.GetIndex() + offsets.Value() ) );
+    }
+
+  // Map the pixels to the bins of the histograms of
+  // ScalarImageToCooccurrenceMatrixFilter
+  typedef Histogram< MeasurementType > HistogramType;
+  typename HistogramType::Pointer histogram = HistogramType::New();
+  histogram->SetMeasurementVectorSize(1);
+  typename HistogramType::SizeType              size(1);
+  typename HistogramType::MeasurementVectorType lowerBound(1);
+  typename HistogramType::MeasurementVectorType upperBound(1);
+  size.Fill(m_NumberOfBinsPerAxis);
+  lowerBound.Fill(m_Min);
+  upperBound.Fill(static_cast< MeasurementType >( m_Max ) + 1);
+  histogram->Initialize(size, lowerBound, upperBound);
+
+  typename HistogramType::MeasurementVectorType measurement(1);
+  typename HistogramType::IndexType             index(1);
+
+  ImageRegionConstIterator< ImageType > inputIt(input, region);
+  ImageRegionIterator< BinImageType >   binIt(m_BinImage, region);
+  ImageRegionConstIterator< ImageType > maskIt;
+  if ( maskImage )
+    {
+    maskIt = ImageRegionConstIterator< ImageType >(maskImage, region);
+    }
+  for (; !inputIt.IsAtEnd(); ++inputIt, ++binIt )
+    {
+    const PixelType pixelIntensity = inputIt.Get();
+    unsigned int    bin = m_NumberOfBinsPerAxis;
+    if ( pixelIntensity >= m_Min && pixelIntensity <= m_Max
+         && ( !maskImage || maskIt.Get() == m_InsidePixelValue ) )
+      {
+      measurement[0] = pixelIntensity;
+      if ( histogram->GetIndex(measurement, index) )
+        {
+        bin = static_cast< unsigned int >( index[0] );
+        }
+      }
+    binIt.Set(bin);
+    if ( maskImage )
+      {
+      ++maskIt;
+      }
+    }
+}
+
+template< typename TImageType, typename TOutputImageType >
+void
+ScalarImageToTextureFeaturesImageFilter< TImageType, TOutputImageType >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId)
+{
+  OutputImageType *output = this->GetOutput();
+  const ImageType *maskImage = this->GetMaskImage();
+
+  const RegionType & largestRegion = this->GetInput()->GetLargestPossibleRegion();
+  const IndexValueType largestRegionEnd =
+    largestRegion.GetIndex(0) + static_cast< IndexValueType >( largestRegion.GetSize(0) );
+  const IndexValueType radius = static_cast< IndexValueType >( m_NeighborhoodRadius[0] );
+
+  // The pairs with a pixel out of the bounds of the histogram, or out of the
+  // mask, are counted in the extra row and column of the matrix
+  const SizeValueType matrixSize =
+    static_cast< SizeValueType >( m_NumberOfBinsPerAxis + 1 ) * ( m_NumberOfBinsPerAxis + 1 );
+  std::vector< OffsetValueType > matrix(matrixSize);
+  std::vector< double >          marginalSums(m_NumberOfBinsPerAxis);
+
+  OutputPixelType features;
+  NumericTraits< OutputPixelType >::SetLength(features, NumberOfFeatures);
+  OutputPixelType zeroFeatures = features;
+  zeroFeatures.Fill(0);
+
+  ProgressReporter progress( this, threadId,
+                             outputRegionForThread.GetNumberOfPixels() / outputRegionForThread.GetSize(0) );
+
+  ImageScanlineIterator< OutputImageType > outputIt(output, outputRegionForThread);
+  ImageScanlineConstIterator< ImageType >  maskIt;
+  if ( maskImage )
+    {
+    maskIt = ImageScanlineConstIterator< ImageType >(maskImage, outputRegionForThread);
+    }
+  while ( !outputIt.IsAtEnd() )
+    {
+    // Count all the pairs of the window of the first pixel of the line
+    IndexType index = outputIt.GetIndex();
+    RegionType window;
+    window.SetIndex(index - m_NeighborhoodRadius);
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      window.SetSize(d, 2 * m_NeighborhoodRadius[d] + 1);
+      }
+    window.Crop(largestRegion);
+
+    std::fill(matrix.begin(), matrix.end(), 0);
+    for ( unsigned int o = 0; o < m_OffsetList.size(); ++o )
+      {
+      RegionType box = window;
+      RegionType shiftedWindow = window;
+      shiftedWindow.SetIndex(window.GetIndex() - m_OffsetList[o]);
+      if ( box.Crop(shiftedWindow) )
+        {
+        this->UpdateMatrix(box, m_BufferOffsets[o], 1, &matrix[0]);
+        }
+      }
+
+    while ( true )
+      {
+      if ( !maskImage || maskIt.Get() == m_InsidePixelValue )
+        {
+        this->ComputeFeatures(&matrix[0], &marginalSums[0], features);
+        outputIt.Set(features);
+        }
+      else
+        {
+        outputIt.Set(zeroFeatures);
+        }
+
+      ++outputIt;
+      if ( maskImage )
+        {
+        ++maskIt;
+        }
+      if ( outputIt.IsAtEndOfLine() )
+        {
+        break;
+        }
+
+      // Move the window by one pixel: remove the pairs of the slice leaving
+      // the window and add the pairs of the slice entering it
+      ++index[0];
+      const IndexValueType leaving = index[0] - 1 - radius;
+      if ( leaving >= largestRegion.GetIndex(0) )
+        {
+        RegionType slice = window;
+        slice.SetSize(0, 1);
+        this->UpdateMatrixWithSlice(window, slice, -1, &matrix[0]);
+        window.SetIndex(0, leaving + 1);
+        window.SetSize(0, window.GetSize(0) - 1);
+        }
+      const IndexValueType entering = index[0] + radius;
+      if ( entering < largestRegionEnd )
+        {
+        window.SetSize(0, window.GetSize(0) + 1);
+        RegionType slice = window;
+        slice.SetIndex(0, entering);
+        slice.SetSize(0, 1);
+        this->UpdateMatrixWithSlice(window, slice, 1, &matrix[0]);
+        }
+      }
+
+    outputIt.NextLine();
+    if ( maskImage )
+      {
+      maskIt.NextLine();
+      }
+    progress.CompletedPixel();
+    }
+}
+
+template< typename TImageType, typename TOutputImageType >
+void
+ScalarImageToTextureFeaturesImageFilter< TImageType, TOutputImageType >
+::AfterThreadedGenerateData()
+{
+  m_BinImage = ITK_NULLPTR;
+}
+
+template< typename TImageType, typename TOutputImageType >
+void
+ScalarImageToTextureFeaturesImageFilter< TImageType, TOutputImageType >
+::UpdateMatrix(const RegionType & box, OffsetValueType neighborOffset,
+               OffsetValueType increment, OffsetValueType *matrix) const
+{
+  const unsigned int    matrixStride = m_NumberOfBinsPerAxis + 1;
+  const unsigned int   *bins = m_BinImage->GetBufferPointer();
+  const IndexType       boxStart = box.GetIndex();
+  const OffsetValueType lineLength = box.GetSize(0);
+  const SizeValueType   numberOfLines = box.GetNumberOfPixels() / box.GetSize(0);
+
+  IndexType lineStart = boxStart;
+  for ( SizeValueType l = 0; l < numberOfLines; ++l )
+    {
+    const unsigned int *line = bins + m_BinImage->ComputeOffset(lineStart);
+    const unsigned int *neighbors = line + neighborOffset;
+    for ( OffsetValueType x = 0; x < lineLength; ++x )
+      {
+      matrix[line[x] * matrixStride + neighbors[x]] += increment;
+      }
+
+    for ( unsigned int d = 1; d < ImageDimension; ++d )
+      {
+      ++lineStart[d];
+      if ( lineStart[d] < boxStart[d] + static_cast< IndexValueType >( box.GetSize(d) ) )
+        {
+        break;
+        }
+      lineStart[d] = boxStart[d];
+      }
+    }
+}
+
+template< typename TImageType, typename TOutputImageType >
+void
+ScalarImageToTextureFeaturesImageFilter< TImageType, TOutputImageType >
+::UpdateMatrixWithSlice(const RegionType & window, const RegionType & slice,
+                        OffsetValueType increment, OffsetValueType *matrix) const
+{
+  for ( unsigned int o = 0; o < m_OffsetList.size(); ++o )
+    {
+    const OffsetType & offset = m_OffsetList[o];
+
+    // The pairs whose first pixel is in the slice
+    RegionType box = slice;
+    RegionType shiftedWindow = window;
+    shiftedWindow.SetIndex(window.GetIndex() - offset);
+    if ( box.Crop(shiftedWindow) )
+      {
+      this->UpdateMatrix(box, m_BufferOffsets[o], increment, matrix);
+      }
+
+    // The pairs whose second pixel only is in the slice
+    if ( offset[0] != 0 )
+      {
+      box = window;
+      RegionType shiftedSlice = slice;
+      shiftedSlice.SetIndex(slice.GetIndex() - offset);
+      if ( box.Crop(shiftedSlice) )
+        {
+        this->UpdateMatrix(box, m_BufferOffsets[o], increment, matrix);
+        }
+      }
+    }
+}
+
+template< typename TImageType, typename TOutputImageType >
+void
+ScalarImageToTextureFeaturesImageFilter< TImageType, TOutputImageType >
+::ComputeFeatures(const OffsetValueType *matrix, double *marginalSums, OutputPixelType & features) const
+{
+  // The features are computed as in HistogramToTextureFeaturesFilter, from
+  // the normalized symmetric matrix, where each pair is counted in both
+  // orders
+  const unsigned int binsPerAxis = m_NumberOfBinsPerAxis;
+  const unsigned int matrixStride = binsPerAxis + 1;
+
+  OffsetValueType numberOfPairs = 0;
+  for ( unsigned int i = 0; i < binsPerAxis; ++i )
+    {
+    for ( unsigned int j = 0; j < binsPerAxis; ++j )
+      {
+      numberOfPairs += matrix[i * matrixStride + j];
+      }
+    }
+  if ( numberOfPairs == 0 )
+    {
+    features.Fill(0);
+    return;
+    }
+  const double totalFrequency = 2.0 * numberOfPairs;
+
+  // Means and variances
+  double pixelMean = 0.0;
+  for ( unsigned int i = 0; i < binsPerAxis; ++i )
+    {
+    marginalSums[i] = 0.0;
+    for ( unsigned int j = 0; j < binsPerAxis; ++j )
+      {
+      const double frequency = ( matrix[i * matrixStride + j] + matrix[j * matrixStride + i] ) / totalFrequency;
+      pixelMean += i * frequency;
+      marginalSums[i] += frequency;
+      }
+    }
+
+  double marginalMean = marginalSums[0];
+  double marginalDevSquared = 0.0;
+  for ( unsigned int i = 1; i < binsPerAxis; ++i )
+    {
+    const double previousMean = marginalMean;
+    marginalMean += ( marginalSums[i] - previousMean ) / ( i + 1 );
+    marginalDevSquared += ( marginalSums[i] - previousMean ) * ( marginalSums[i] - marginalMean );
+    }
+  marginalDevSquared = marginalDevSquared / binsPerAxis;
+
+  double pixelVariance = 0.0;
+  for ( unsigned int i = 0; i < binsPerAxis; ++i )
+    {
+    pixelVariance += ( i - pixelMean ) * ( i - pixelMean ) * marginalSums[i];
+    }
+  double pixelVarianceSquared = pixelVariance * pixelVariance;
+  if ( Math::FloatAlmostEqual( pixelVarianceSquared, 0.0, 4, 2 * NumericTraits< double >::epsilon() ) )
+    {
+    pixelVarianceSquared = 1.0;
+    }
+
+  // Features
+  double       energy = 0.0;
+  double       entropy = 0.0;
+  double       correlation = 0.0;
+  double       inverseDifferenceMoment = 0.0;
+  double       inertia = 0.0;
+  double       clusterShade = 0.0;
+  double       clusterProminence = 0.0;
+  double       haralickCorrelation = 0.0;
+  const double log2 = std::log(2.0);
+  for ( unsigned int i = 0; i < binsPerAxis; ++i )
+    {
+    for ( unsigned int j = 0; j < binsPerAxis; ++j )
+      {
+      const OffsetValueType count = matrix[i * matrixStride + j] + matrix[j * matrixStride + i];
+      if ( count == 0 )
+        {
+        continue;
+        }
+      const double frequency = count / totalFrequency;
+      const double difference = static_cast< double >( i ) - static_cast< double >( j );
+      const double sum = ( i - pixelMean ) + ( j - pixelMean );
+      energy += frequency * frequency;
+      entropy -= ( frequency > 0.0001 ) ? frequency * std::log(frequency) / log2 : 0;
+      correlation += ( ( i - pixelMean ) * ( j - pixelMean ) * frequency ) / pixelVarianceSquared;
+      inverseDifferenceMoment += frequency / ( 1.0 + difference * difference );
+      inertia += difference * difference * frequency;
+      clusterShade += sum * sum * sum * frequency;
+      clusterProminence += sum * sum * sum * sum * frequency;
+      haralickCorrelation += i * j * frequency;
+      }
+    }
+  haralickCorrelation = ( haralickCorrelation - marginalMean * marginalMean ) / marginalDevSquared;
+
+  features[0] = energy;
+  features[1] = entropy;
+  features[2] = correlation;
+  features[3] = inverseDifferenceMoment;
+  features[4] = inertia;
+  features[5] = clusterShade;
+  features[6] = clusterProminence;
+  features[7] = haralickCorrelation;
+}
+
+template< typename TImageType, typename TOutputImageType >
+void
+ScalarImageToTextureFeaturesImageFilter< TImageType, TOutputImageType >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Offsets: " << this->GetOffsets() << std::endl;
+  os << indent << "Min: " << this->GetMin() << std::endl;
+  os << indent << "Max: " << this->GetMax() << std::endl;
+  os << indent << "NumberOfBinsPerAxis: " << this->GetNumberOfBinsPerAxis() << std::endl;
+  os << indent << "NeighborhoodRadius: " << this->GetNeighborhoodRadius() << std::endl;
+  os << indent << "InsidePixelValue: " << this->GetInsidePixelValue() << std::endl;
+}
+} // end of namespace Statistics
+} // end of namespace itk
+
+#endif
@@ -108,9 +108,12 @@ protected:
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(WeightedCentroidKdTreeGenerator);
 
-  MeasurementVectorType m_TempLowerBound;
-  MeasurementVectorType m_TempUpperBound;
-  MeasurementVectorType m_TempMean;
+  /** Adds the sum of the measurement vectors of a child node, between
+   * beginIndex and endIndex, to a weighted centroid. */
+  void AddToWeightedCentroid(KdTreeNodeType *node,
+                             unsigned int beginIndex,
+                             unsigned int endIndex,
+                             typename KdTreeNodeType::CentroidType & weightedCentroid) const;
 };  // end of class
 } // end of namespace Statistics
 } // end of namespace itk
@@ -50,68 +50,11 @@ WeightedCentroidKdTreeGenerator< TSample >
   MeasurementType dimensionUpperBound;
   MeasurementType partitionValue;
   unsigned int    partitionDimension = 0;
-  unsigned int    i;
-  unsigned int    j;
-  MeasurementType spread;
-  MeasurementType maxSpread;
-  unsigned int    medianIndex;
 
-  SubsamplePointer subsample = this->GetSubsample();
-
-  // Sanity check. Verify that the subsample has measurement vectors of the
-  // same length as the sample generated by the tree.
-  if ( this->GetMeasurementVectorSize() != subsample->GetMeasurementVectorSize() )
-    {
-    itkExceptionMacro(<< "Measurement Vector Length mismatch");
-    }
-
-  // calculates the weighted centroid which is the vector sum
-  // of all the associated instances.
-  typename KdTreeNodeType::CentroidType weightedCentroid;
-  NumericTraits<typename KdTreeNodeType::CentroidType>::SetLength( weightedCentroid,
-    this->GetMeasurementVectorSize() );
-  MeasurementVectorType tempVector;
-  weightedCentroid.Fill(NumericTraits< MeasurementType >::ZeroValue());
-
-  for ( i = beginIndex; i < endIndex; i++ )
-    {
-    tempVector = subsample->GetMeasurementVectorByIndex(i);
-    for ( j = 0; j < this->GetMeasurementVectorSize(); j++ )
-      {
-      weightedCentroid[j] += tempVector[j];
-      }
-    }
-
-  // find most widely spread dimension
-  Algorithm::FindSampleBoundAndMean< SubsampleType >(this->GetSubsample(),
-                                                     beginIndex, endIndex,
-                                                     m_TempLowerBound, m_TempUpperBound,
-                                                     m_TempMean);
-
-  maxSpread = NumericTraits< MeasurementType >::NonpositiveMin();
-  for ( i = 0; i < this->GetMeasurementVectorSize(); i++ )
-    {
-    spread = m_TempUpperBound[i] - m_TempLowerBound[i];
-    if ( spread >= maxSpread )
-      {
-      maxSpread = spread;
-      partitionDimension = i;
-      }
-    }
-
-  medianIndex = ( endIndex - beginIndex ) / 2;
-
-  //
-  // Find the medial element by using the NthElement function
-  // based on the STL implementation of the QuickSelect algorithm.
-  //
-  partitionValue =
-    Algorithm::NthElement< SubsampleType >(this->GetSubsample(),
-                                           partitionDimension,
-                                           beginIndex, endIndex,
-                                           medianIndex);
-
-  medianIndex += beginIndex;
+  // find most widely spread dimension, and partition the measurement
+  // vectors around its median
+  const unsigned int medianIndex =
+    this->PartitionMeasurementVectors(beginIndex, endIndex, partitionDimension, partitionValue);
 
   // save bounds for cutting dimension
   dimensionLowerBound = lowerBound[partitionDimension];
@@ -129,6 +72,21 @@ WeightedCentroidKdTreeGenerator< TSample >
   KdTreeNodeType *   right = this->GenerateTreeLoop(beginRightIndex, endRighIndex, lowerBound, upperBound, level + 1);
   lowerBound[partitionDimension] = dimensionLowerBound;
 
+  // calculates the weighted centroid which is the vector sum
+  // of all the associated instances, from those of the children.
+  typename KdTreeNodeType::CentroidType weightedCentroid;
+  NumericTraits<typename KdTreeNodeType::CentroidType>::SetLength( weightedCentroid,
+    this->GetMeasurementVectorSize() );
+  weightedCentroid.Fill(NumericTraits< MeasurementType >::ZeroValue());
+
+  this->AddToWeightedCentroid(left, beginLeftIndex, endLeftIndex, weightedCentroid);
+  this->AddToWeightedCentroid(right, beginRightIndex, endRighIndex, weightedCentroid);
+  const MeasurementType *median = this->GetPartitionedMeasurementVector(medianIndex);
+  for ( unsigned int j = 0; j < this->GetMeasurementVectorSize(); j++ )
+    {
+    weightedCentroid[j] += median[j];
+    }
+
   typedef KdTreeWeightedCentroidNonterminalNode< TSample > KdTreeNonterminalNodeType;
 
   KdTreeNonterminalNodeType *nonTerminalNode =
@@ -139,10 +97,36 @@ WeightedCentroidKdTreeGenerator< TSample >
                                   endIndex - beginIndex);
 
   nonTerminalNode->AddInstanceIdentifier(
-    subsample->GetInstanceIdentifier(medianIndex) );
+    this->GetPartitionedInstanceIdentifier(medianIndex) );
 
   return nonTerminalNode;
 }
+
+template< typename TSample >
+void
+WeightedCentroidKdTreeGenerator< TSample >
+::AddToWeightedCentroid(KdTreeNodeType *node,
+                        unsigned int beginIndex,
+                        unsigned int endIndex,
+                        typename KdTreeNodeType::CentroidType & weightedCentroid) const
+{
+  if ( !node->IsTerminal() )
+    {
+    typename KdTreeNodeType::CentroidType nodeWeightedCentroid;
+    node->GetWeightedCentroid(nodeWeightedCentroid);
+    weightedCentroid += nodeWeightedCentroid;
+    return;
+    }
+
+  for ( unsigned int i = beginIndex; i < endIndex; i++ )
+    {
+    const MeasurementType *measurement = this->GetPartitionedMeasurementVector(i);
+    for ( unsigned int j = 0; j < this->GetMeasurementVectorSize(); j++ )
+      {
+      weightedCentroid[j] += measurement[j];
+      }
+    }
+}
 } // end of namespace Statistics
 } // end of namespace itk
 
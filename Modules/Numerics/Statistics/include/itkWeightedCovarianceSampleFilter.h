@@ -21,6 +21,7 @@
 #include "itkFunctionBase.h"
 #include "itkCovarianceSampleFilter.h"
 #include "itkDataObjectDecorator.h"
+#include "itkSampleThreadRange.h"
 
 namespace itk
 {
@@ -34,6 +35,12 @@ namespace Statistics
  * or an array containing weight values. If none of these two is specified,
  * the covariance matrix is generated with equal weights.
  *
+ * With a weight array, the measurement vectors are split among the
+ * threads of the filter, which accumulate their weighted outer products
+ * and visit them through their own SampleRangeConstIterator. The weighting function is
+ * evaluated by a single thread, since it may not support concurrent
+ * calls.
+ *
  * \sa CovarianceSampleFilter
  *
  * \ingroup ITKStatistics
@@ -113,6 +120,28 @@ protected:
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(WeightedCovarianceSampleFilter);
 
+  struct ComputeCovarianceMatrixWithWeightsStruct
+  {
+    const Self                      *Filter;
+    const SampleType                *Sample;
+    const WeightArrayType           *Weights;
+    MeasurementVectorRealType        Mean;
+    std::vector< MatrixType >        Outputs;
+    std::vector< WeightValueType >   TotalWeights;
+    std::vector< WeightValueType >   TotalSquaredWeights;
+  };
+
+  static ITK_THREAD_RETURN_TYPE ComputeCovarianceMatrixWithWeightsThreaderCallback(void *arg);
+
+  /** Adds the weighted outer products of the differences from the mean of
+   * the measurement vectors of a range of instance identifiers to the
+   * lower triangle of the output. */
+  void AccumulateWithWeights(const SampleType *input, const WeightArrayType & weightsArray,
+                             const MeasurementVectorRealType & mean,
+                             SizeValueType beginIndex, SizeValueType endIndex,
+                             MatrixType & output, WeightValueType & totalWeight,
+                             WeightValueType & totalSquaredWeight) const;
+
 };  // end of class
 } // end of namespace Statistics
 } // end of namespace itk
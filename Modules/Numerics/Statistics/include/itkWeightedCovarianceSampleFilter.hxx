@@ -208,25 +208,123 @@ WeightedCovarianceSampleFilter< TSample >
 
   meanFilter->SetInput( input );
   meanFilter->SetWeights( weightsArray );
+  meanFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
   meanFilter->Update();
 
   const typename WeightedMeanFilterType::MeasurementVectorRealType mean = meanFilter->GetMean();
   decoratedMeanOutput->Set( mean );
 
   // covariance algorithm
-  MeasurementVectorRealType diff;
-  NumericTraits<MeasurementVectorRealType>::SetLength( diff, measurementVectorSize );
+  const SizeValueType numberOfMeasurementVectors = input->Size();
+
+  ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+  if ( numberOfMeasurementVectors < numberOfThreads )
+    {
+    numberOfThreads = std::max( static_cast< ThreadIdType >( numberOfMeasurementVectors ),
+                                static_cast< ThreadIdType >( 1 ) );
+    }
+
+  ComputeCovarianceMatrixWithWeightsStruct str;
+  str.Filter = this;
+  str.Sample = input;
+  str.Weights = &weightsArray;
+  str.Mean = mean;
+  str.Outputs.resize(numberOfThreads, output);
+  str.TotalWeights.resize( numberOfThreads, NumericTraits< WeightValueType >::ZeroValue() );
+  str.TotalSquaredWeights.resize( numberOfThreads, NumericTraits< WeightValueType >::ZeroValue() );
 
+  if ( numberOfThreads > 1 )
+    {
+    this->GetMultiThreader()->SetNumberOfThreads(numberOfThreads);
+    this->GetMultiThreader()->SetSingleMethod(Self::ComputeCovarianceMatrixWithWeightsThreaderCallback, &str);
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
+  else
+    {
+    this->AccumulateWithWeights(input, weightsArray, str.Mean, 0, numberOfMeasurementVectors,
+                                str.Outputs[0], str.TotalWeights[0], str.TotalSquaredWeights[0]);
+    }
+
+  // Add the sums of the threads in order
   WeightValueType totalWeight = NumericTraits< WeightValueType >::ZeroValue();
 
   WeightValueType totalSquaredWeight = NumericTraits< WeightValueType >::ZeroValue();
 
-  typename SampleType::ConstIterator iter =      input->Begin();
-  const typename SampleType::ConstIterator end = input->End();
+  for ( ThreadIdType threadId = 0; threadId < numberOfThreads; ++threadId )
+    {
+    output += str.Outputs[threadId];
+    totalWeight += str.TotalWeights[threadId];
+    totalSquaredWeight += str.TotalSquaredWeights[threadId];
+    }
+
+  // fills the upper triangle using the lower triangle
+  for ( unsigned int row = 1; row < measurementVectorSize; ++row )
+    {
+    for ( unsigned int col = 0; col < row; ++col )
+      {
+      output(col, row) = output(row, col);
+      }
+    }
+
+  const double normalizationFactor = ( totalWeight - ( totalSquaredWeight / totalWeight ) );
+
+  if( normalizationFactor > itk::Math::eps )
+    {
+    const double inverseNormalizationFactor = 1.0 / normalizationFactor;
+
+    output *= inverseNormalizationFactor;
+    }
+  else
+    {
+    itkExceptionMacro("Normalization factor was too close to zero. Value = " << normalizationFactor );
+    }
+
+  decoratedOutput->Set( output );
+}
+
+template< typename TSample >
+ITK_THREAD_RETURN_TYPE
+WeightedCovarianceSampleFilter< TSample >
+::ComputeCovarianceMatrixWithWeightsThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *         info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ComputeCovarianceMatrixWithWeightsStruct *str =
+    static_cast< ComputeCovarianceMatrixWithWeightsStruct * >( info->UserData );
+
+  const ThreadIdType  threadId = info->ThreadID;
+  const ThreadIdType  numberOfThreads = info->NumberOfThreads;
+  const SizeValueType numberOfMeasurementVectors = str->Sample->Size();
+
+  SizeValueType beginIndex;
+  SizeValueType endIndex;
+  GetThreadRange(numberOfMeasurementVectors, threadId, numberOfThreads, beginIndex, endIndex);
+
+  str->Filter->AccumulateWithWeights(str->Sample, *str->Weights, str->Mean, beginIndex, endIndex,
+                                     str->Outputs[threadId], str->TotalWeights[threadId],
+                                     str->TotalSquaredWeights[threadId]);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TSample >
+void
+WeightedCovarianceSampleFilter< TSample >
+::AccumulateWithWeights(const SampleType *input, const WeightArrayType & weightsArray,
+                        const MeasurementVectorRealType & mean,
+                        SizeValueType beginIndex, SizeValueType endIndex,
+                        MatrixType & output, WeightValueType & totalWeight,
+                        WeightValueType & totalSquaredWeight) const
+{
+  const MeasurementVectorSizeType measurementVectorSize = input->GetMeasurementVectorSize();
+
+  MeasurementVectorRealType diff;
+  NumericTraits<MeasurementVectorRealType>::SetLength( diff, measurementVectorSize );
+
+  SampleRangeConstIterator< SampleType > iter(input, beginIndex);
 
   // fills the lower triangle and the diagonal cells in the covariance matrix
-  for ( unsigned int sampleVectorIndex = 0;
-        iter != end;
+  for ( SizeValueType sampleVectorIndex = beginIndex;
+        sampleVectorIndex < endIndex;
         ++iter, ++sampleVectorIndex )
     {
     const MeasurementVectorType & measurement = iter.GetMeasurementVector();
@@ -257,31 +355,8 @@ WeightedCovarianceSampleFilter< TSample >
         }
       }
     }
-
-  // fills the upper triangle using the lower triangle
-  for ( unsigned int row = 1; row < measurementVectorSize; ++row )
-    {
-    for ( unsigned int col = 0; col < row; ++col )
-      {
-      output(col, row) = output(row, col);
-      }
-    }
-
-  const double normalizationFactor = ( totalWeight - ( totalSquaredWeight / totalWeight ) );
-
-  if( normalizationFactor > itk::Math::eps )
-    {
-    const double inverseNormalizationFactor = 1.0 / normalizationFactor;
-
-    output *= inverseNormalizationFactor;
-    }
-  else
-    {
-    itkExceptionMacro("Normalization factor was too close to zero. Value = " << normalizationFactor );
-    }
-
-  decoratedOutput->Set( output );
 }
+
 } // end of namespace Statistics
 } // end of namespace itk
 
@@ -21,6 +21,8 @@
 #include "itkMeanSampleFilter.h"
 #include "itkFunctionBase.h"
 #include "itkDataObjectDecorator.h"
+#include "itkCompensatedSummation.h"
+#include "itkSampleThreadRange.h"
 
 namespace itk
 {
@@ -34,6 +36,11 @@ namespace Statistics
  * using SetInput method and provides weight by an array or function.
  *. Then call the Update method to run the alogithm.
  *
+ * With a weight array, the measurement vectors are split among the
+ * threads of the filter, which accumulate their weighted sums and visit
+ * them through their own SampleRangeConstIterator. The weighting function is evaluated
+ * by a single thread, since it may not support concurrent calls.
+ *
  * \sa MeanSampleFilter
  *
  * \ingroup ITKStatistics
@@ -106,6 +113,27 @@ protected:
 
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(WeightedMeanSampleFilter);
+
+  typedef CompensatedSummation< MeasurementRealType >  MeasurementRealAccumulateType;
+  typedef std::vector< MeasurementRealAccumulateType > MeasurementRealAccumulateVectorType;
+
+  struct ComputeMeanWithWeightsStruct
+  {
+    const Self                                         *Filter;
+    const SampleType                                   *Sample;
+    const WeightArrayType                              *Weights;
+    std::vector< MeasurementRealAccumulateVectorType >  Sums;
+    std::vector< WeightValueType >                      TotalWeights;
+  };
+
+  static ITK_THREAD_RETURN_TYPE ComputeMeanWithWeightsThreaderCallback(void *arg);
+
+  /** Adds the measurement vectors of a range of instance identifiers,
+   * multiplied by their weights and frequencies. */
+  void AccumulateWithWeights(const SampleType *input, const WeightArrayType & weightsArray,
+                             SizeValueType beginIndex, SizeValueType endIndex,
+                             MeasurementRealAccumulateVectorType & sum,
+                             WeightValueType & totalWeight) const;
 };                                        // end of class
 } // end of namespace Statistics
 } // end of namespace itk
@@ -21,7 +21,6 @@
 #include "itkWeightedMeanSampleFilter.h"
 
 #include <vector>
-#include "itkCompensatedSummation.h"
 #include "itkMeasurementVectorTraits.h"
 
 namespace itk
@@ -101,18 +100,98 @@ WeightedMeanSampleFilter< TSample >
   NumericTraits<MeasurementVectorRealType>::SetLength( output, this->GetMeasurementVectorSize() );
 
   // algorithm start
-  typedef CompensatedSummation< MeasurementRealType > MeasurementRealAccumulateType;
-  std::vector< MeasurementRealAccumulateType > sum( measurementVectorSize );
+  const SizeValueType numberOfMeasurementVectors = input->Size();
 
-  const WeightArrayType & weightsArray = this->GetWeights();
+  ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+  if ( numberOfMeasurementVectors < numberOfThreads )
+    {
+    numberOfThreads = std::max( static_cast< ThreadIdType >( numberOfMeasurementVectors ),
+                                static_cast< ThreadIdType >( 1 ) );
+    }
 
+  ComputeMeanWithWeightsStruct str;
+  str.Filter = this;
+  str.Sample = input;
+  str.Weights = &( this->GetWeights() );
+  str.Sums.resize( numberOfThreads, MeasurementRealAccumulateVectorType(measurementVectorSize) );
+  str.TotalWeights.resize( numberOfThreads, NumericTraits< WeightValueType >::ZeroValue() );
+
+  if ( numberOfThreads > 1 )
+    {
+    this->GetMultiThreader()->SetNumberOfThreads(numberOfThreads);
+    this->GetMultiThreader()->SetSingleMethod(Self::ComputeMeanWithWeightsThreaderCallback, &str);
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
+  else
+    {
+    this->AccumulateWithWeights(input, *str.Weights, 0, numberOfMeasurementVectors,
+                                str.Sums[0], str.TotalWeights[0]);
+    }
+
+  // Add the sums of the threads in order
+  MeasurementRealAccumulateVectorType sum( measurementVectorSize );
   WeightValueType totalWeight = NumericTraits< WeightValueType >::ZeroValue();
+  for ( ThreadIdType threadId = 0; threadId < numberOfThreads; ++threadId )
+    {
+    for ( unsigned int dim = 0; dim < measurementVectorSize; dim++ )
+      {
+      sum[dim] += str.Sums[threadId][dim].GetSum();
+      }
+    totalWeight += str.TotalWeights[threadId];
+    }
 
-  typename SampleType::ConstIterator iter = input->Begin();
-  typename SampleType::ConstIterator end =  input->End();
+  if ( totalWeight > itk::Math::eps )
+    {
+    for ( unsigned int dim = 0; dim < measurementVectorSize; dim++ )
+      {
+      output[dim] = ( sum[dim].GetSum() / static_cast< MeasurementRealType >( totalWeight ) );
+      }
+    }
+  else
+    {
+    itkExceptionMacro("Total weight was too close to zero. Value = " << totalWeight );
+    }
+
+  decoratedOutput->Set( output );
+}
+
+template< typename TSample >
+ITK_THREAD_RETURN_TYPE
+WeightedMeanSampleFilter< TSample >
+::ComputeMeanWithWeightsThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ComputeMeanWithWeightsStruct *   str = static_cast< ComputeMeanWithWeightsStruct * >( info->UserData );
+
+  const ThreadIdType  threadId = info->ThreadID;
+  const ThreadIdType  numberOfThreads = info->NumberOfThreads;
+  const SizeValueType numberOfMeasurementVectors = str->Sample->Size();
+
+  SizeValueType beginIndex;
+  SizeValueType endIndex;
+  GetThreadRange(numberOfMeasurementVectors, threadId, numberOfThreads, beginIndex, endIndex);
+
+  str->Filter->AccumulateWithWeights(str->Sample, *str->Weights, beginIndex, endIndex,
+                                     str->Sums[threadId], str->TotalWeights[threadId]);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TSample >
+void
+WeightedMeanSampleFilter< TSample >
+::AccumulateWithWeights(const SampleType *input, const WeightArrayType & weightsArray,
+                        SizeValueType beginIndex, SizeValueType endIndex,
+                        MeasurementRealAccumulateVectorType & sum,
+                        WeightValueType & totalWeight) const
+{
+  const MeasurementVectorSizeType measurementVectorSize =
+    input->GetMeasurementVectorSize();
 
-  for ( unsigned int sampleVectorIndex = 0;
-        iter != end;
+  SampleRangeConstIterator< SampleType > iter(input, beginIndex);
+
+  for ( SizeValueType sampleVectorIndex = beginIndex;
+        sampleVectorIndex < endIndex;
         ++iter, ++sampleVectorIndex )
     {
     const MeasurementVectorType & measurement = iter.GetMeasurementVector();
@@ -132,20 +211,6 @@ WeightedMeanSampleFilter< TSample >
       sum[dim] += ( component * weight );
       }
     }
-
-  if ( totalWeight > itk::Math::eps )
-    {
-    for ( unsigned int dim = 0; dim < measurementVectorSize; dim++ )
-      {
-      output[dim] = ( sum[dim].GetSum() / static_cast< MeasurementRealType >( totalWeight ) );
-      }
-    }
-  else
-    {
-    itkExceptionMacro("Total weight was too close to zero. Value = " << totalWeight );
-    }
-
-  decoratedOutput->Set( output );
 }
 
 template< typename TSample >
@@ -168,8 +233,7 @@ WeightedMeanSampleFilter< TSample >
   NumericTraits<MeasurementVectorRealType>::SetLength( output, this->GetMeasurementVectorSize() );
 
   // algorithm start
-  typedef CompensatedSummation< MeasurementRealType > MeasurementRealAccumulateType;
-  std::vector< MeasurementRealAccumulateType > sum( measurementVectorSize );
+  MeasurementRealAccumulateVectorType sum( measurementVectorSize );
 
   const WeightingFunctionType * const weightFunction = this->GetWeightingFunction();
 
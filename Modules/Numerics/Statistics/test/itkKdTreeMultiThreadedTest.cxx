@@ -0,0 +1,195 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <algorithm>
+#include <sstream>
+
+#include "itkPointSetToListSampleAdaptor.h"
+#include "itkWeightedCentroidKdTreeGenerator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+// The tree must not depend on the number of threads of the generator, and
+// the searches of batches of query points must find the neighbors found
+// one query point at a time and by brute force. The sample is an adaptor,
+// which does not support concurrent calls.
+int itkKdTreeMultiThreadedTest(int, char *[])
+{
+  typedef itk::PointSet< float, 3 >                                    PointSetType;
+  typedef itk::Statistics::PointSetToListSampleAdaptor< PointSetType > SampleType;
+  typedef SampleType::MeasurementVectorType                            MeasurementVectorType;
+  typedef itk::Statistics::KdTreeGenerator< SampleType >               GeneratorType;
+  typedef itk::Statistics::WeightedCentroidKdTreeGenerator< SampleType > WeightedCentroidGeneratorType;
+  typedef GeneratorType::KdTreeType                                    TreeType;
+  typedef TreeType::InstanceIdentifierVectorType                       InstanceIdentifierVectorType;
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator RandomGeneratorType;
+  RandomGeneratorType::Pointer random = RandomGeneratorType::New();
+  random->Initialize(42);
+
+  // Points on a coarse grid, with many ties
+  const unsigned int numberOfPoints = 20000;
+  PointSetType::Pointer pointSet = PointSetType::New();
+  for ( unsigned int i = 0; i < numberOfPoints; ++i )
+    {
+    PointSetType::PointType point;
+    for ( unsigned int d = 0; d < 3; ++d )
+      {
+      point[d] = static_cast< float >( random->GetIntegerVariate(200) ) / 4.0f;
+      }
+    pointSet->SetPoint(i, point);
+    }
+
+  SampleType::Pointer sample = SampleType::New();
+  sample->SetPointSet(pointSet);
+
+  // Generate the trees with several numbers of threads
+  std::string plainTree;
+  std::string weightedCentroidTree;
+  for ( itk::ThreadIdType numberOfThreads = 1; numberOfThreads <= 5; ++numberOfThreads )
+    {
+    GeneratorType::Pointer generator = GeneratorType::New();
+    generator->SetSample(sample);
+    generator->SetBucketSize(8);
+    generator->SetNumberOfThreads(numberOfThreads);
+    TEST_SET_GET_VALUE( numberOfThreads, generator->GetNumberOfThreads() );
+    generator->Update();
+
+    WeightedCentroidGeneratorType::Pointer weightedCentroidGenerator = WeightedCentroidGeneratorType::New();
+    weightedCentroidGenerator->SetSample(sample);
+    weightedCentroidGenerator->SetBucketSize(8);
+    weightedCentroidGenerator->SetNumberOfThreads(numberOfThreads);
+    weightedCentroidGenerator->Update();
+
+    std::ostringstream plainStream;
+    generator->GetOutput()->PrintTree(plainStream);
+    std::ostringstream weightedCentroidStream;
+    weightedCentroidGenerator->GetOutput()->PrintTree(weightedCentroidStream);
+    if ( numberOfThreads == 1 )
+      {
+      plainTree = plainStream.str();
+      weightedCentroidTree = weightedCentroidStream.str();
+      }
+    else if ( plainStream.str() != plainTree || weightedCentroidStream.str() != weightedCentroidTree )
+      {
+      std::cerr << "Test failed: the tree generated with " << numberOfThreads
+                << " threads differs from the tree generated with one thread." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->SetSample(sample);
+  generator->SetBucketSize(8);
+  generator->Update();
+  TreeType::Pointer tree = generator->GetOutput();
+
+  const unsigned int numberOfQueries = 1000;
+  std::vector< MeasurementVectorType > queries(numberOfQueries);
+  for ( unsigned int q = 0; q < numberOfQueries; ++q )
+    {
+    for ( unsigned int d = 0; d < 3; ++d )
+      {
+      queries[q][d] = static_cast< float >( random->GetUniformVariate(-5.0, 55.0) );
+      }
+    }
+
+  const unsigned int numberOfNeighbors = 7;
+  const double       radius = 1.5;
+
+  std::vector< InstanceIdentifierVectorType > nearestNeighbors;
+  std::vector< std::vector< double > >        distances;
+  std::vector< InstanceIdentifierVectorType > neighborsWithinRadius;
+  for ( itk::ThreadIdType numberOfThreads = 1; numberOfThreads <= 4; numberOfThreads += 3 )
+    {
+    // The result vectors are reused by the second batch
+    tree->SetNumberOfThreads(numberOfThreads);
+    TEST_SET_GET_VALUE( numberOfThreads, tree->GetNumberOfThreads() );
+    tree->Search(queries, numberOfNeighbors, nearestNeighbors, distances);
+    tree->Search(queries, radius, neighborsWithinRadius);
+    TEST_EXPECT_EQUAL( nearestNeighbors.size(), numberOfQueries );
+    TEST_EXPECT_EQUAL( neighborsWithinRadius.size(), numberOfQueries );
+
+    for ( unsigned int q = 0; q < numberOfQueries; ++q )
+      {
+      InstanceIdentifierVectorType neighbors;
+      std::vector< double >        neighborDistances;
+      tree->Search(queries[q], numberOfNeighbors, neighbors, neighborDistances);
+      if ( neighbors != nearestNeighbors[q] || neighborDistances != distances[q] )
+        {
+        std::cerr << "Test failed: the batch search of the nearest neighbors of query point "
+                  << q << " differs from its search." << std::endl;
+        return EXIT_FAILURE;
+        }
+      tree->Search(queries[q], radius, neighbors);
+      if ( neighbors != neighborsWithinRadius[q] )
+        {
+        std::cerr << "Test failed: the batch search of the neighbors within the radius of query point "
+                  << q << " differs from its search." << std::endl;
+        return EXIT_FAILURE;
+        }
+
+      // Brute force
+      std::vector< double > allDistances(numberOfPoints);
+      std::vector< bool >   withinRadius(numberOfPoints, false);
+      unsigned int          numberWithinRadius = 0;
+      for ( unsigned int i = 0; i < numberOfPoints; ++i )
+        {
+        allDistances[i] = tree->GetDistanceMetric()->Evaluate( queries[q], sample->GetMeasurementVector(i) );
+        if ( allDistances[i] <= radius )
+          {
+          withinRadius[i] = true;
+          ++numberWithinRadius;
+          }
+        }
+
+      std::vector< double > sortedDistances(allDistances);
+      std::nth_element( sortedDistances.begin(), sortedDistances.begin() + numberOfNeighbors - 1, sortedDistances.end() );
+      const double farthestDistance = sortedDistances[numberOfNeighbors - 1];
+      for ( unsigned int k = 0; k < numberOfNeighbors; ++k )
+        {
+        if ( allDistances[nearestNeighbors[q][k]] > farthestDistance
+             || distances[q][k] != allDistances[nearestNeighbors[q][k]] )
+          {
+          std::cerr << "Test failed: neighbor " << nearestNeighbors[q][k] << " of query point " << q
+                    << " is not among its nearest neighbors." << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+
+      std::vector< bool > found(numberOfPoints, false);
+      for ( size_t k = 0; k < neighborsWithinRadius[q].size(); ++k )
+        {
+        const TreeType::InstanceIdentifier id = neighborsWithinRadius[q][k];
+        if ( !withinRadius[id] || found[id] )
+          {
+          std::cerr << "Test failed: neighbor " << id << " of query point " << q
+                    << " is not within the radius, or found twice." << std::endl;
+          return EXIT_FAILURE;
+          }
+        found[id] = true;
+        }
+      TEST_EXPECT_EQUAL( neighborsWithinRadius[q].size(), numberWithinRadius );
+      }
+    }
+
+  TRY_EXPECT_EXCEPTION( tree->Search(queries, numberOfPoints + 1, nearestNeighbors, distances) );
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,227 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageToListSampleAdaptor.h"
+#include "itkImageRegionIterator.h"
+#include "itkExpectationMaximizationMixtureModelEstimator.h"
+#include "itkGaussianMixtureModelComponent.h"
+#include "itkMiniBatchGaussianMixtureModelEstimator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+// Two Gaussian populations of the pixels of a two band image, read
+// through an adaptor. The mini-batch estimates must be close to the
+// populations and to the estimates of the expectation maximization over
+// the whole sample, which must not depend on the number of threads.
+int itkMiniBatchGaussianMixtureModelEstimatorTest(int, char *[])
+{
+  const unsigned int Dimension = 2;
+  const unsigned int NumberOfBands = 2;
+  const unsigned int NumberOfComponents = 2;
+  const unsigned int NumberOfParameters = NumberOfBands * ( NumberOfBands + 1 );
+
+  typedef itk::Vector< float, NumberOfBands >                                 PixelType;
+  typedef itk::Image< PixelType, Dimension >                                  ImageType;
+  typedef itk::Statistics::ImageToListSampleAdaptor< ImageType >              SampleType;
+  typedef itk::Statistics::MiniBatchGaussianMixtureModelEstimator< SampleType > MiniBatchEstimatorType;
+  typedef itk::Statistics::ExpectationMaximizationMixtureModelEstimator< SampleType > EstimatorType;
+  typedef itk::Statistics::GaussianMixtureModelComponent< SampleType >        ComponentType;
+  typedef MiniBatchEstimatorType::ParametersType                              ParametersType;
+
+  // Means, standard deviations and proportions of the populations
+  const double trueParameters[NumberOfComponents][NumberOfParameters] =
+    { { 100.0, 50.0, 25.0, 0.0, 0.0, 9.0 }, { 140.0, 60.0, 64.0, 0.0, 0.0, 16.0 } };
+  const double trueProportions[NumberOfComponents] = { 0.3, 0.7 };
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator RandomGeneratorType;
+  RandomGeneratorType::Pointer random = RandomGeneratorType::New();
+  random->Initialize(7);
+
+  ImageType::SizeType size;
+  size[0] = 200;
+  size[1] = 150;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for ( itk::ImageRegionIterator< ImageType > it( image, image->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    const unsigned int k = random->GetVariate() < trueProportions[0] ? 0 : 1;
+    PixelType          pixel;
+    pixel[0] = trueParameters[k][0] + std::sqrt(trueParameters[k][2]) * random->GetNormalVariate();
+    pixel[1] = trueParameters[k][1] + std::sqrt(trueParameters[k][5]) * random->GetNormalVariate();
+    it.Set(pixel);
+    }
+
+  SampleType::Pointer sample = SampleType::New();
+  sample->SetImage(image);
+
+  const double initialParameters[NumberOfComponents][NumberOfParameters] =
+    { { 90.0, 45.0, 100.0, 0.0, 0.0, 100.0 }, { 150.0, 65.0, 100.0, 0.0, 0.0, 100.0 } };
+  MiniBatchEstimatorType::ProportionVectorType initialProportions(NumberOfComponents);
+  initialProportions.Fill(0.5);
+
+  // Expectation maximization over the whole sample
+  std::vector< ParametersType > referenceParameters;
+  MiniBatchEstimatorType::ProportionVectorType referenceProportions;
+  for ( itk::ThreadIdType numberOfThreads = 1; numberOfThreads <= 4; numberOfThreads += 3 )
+    {
+    EstimatorType::Pointer estimator = EstimatorType::New();
+    estimator->SetSample(sample);
+    estimator->SetMaximumIteration(20);
+    estimator->SetInitialProportions(initialProportions);
+    estimator->SetNumberOfThreads(numberOfThreads);
+    TEST_SET_GET_VALUE( numberOfThreads, estimator->GetNumberOfThreads() );
+
+    std::vector< ComponentType::Pointer > components;
+    for ( unsigned int k = 0; k < NumberOfComponents; k++ )
+      {
+      ComponentType::Pointer component = ComponentType::New();
+      component->SetSample(sample);
+      ParametersType parameters(NumberOfParameters);
+      for ( unsigned int p = 0; p < NumberOfParameters; p++ )
+        {
+        parameters[p] = initialParameters[k][p];
+        }
+      component->SetParameters(parameters);
+      components.push_back(component);
+      estimator->AddComponent(component);
+      }
+    estimator->Update();
+
+    for ( unsigned int k = 0; k < NumberOfComponents; k++ )
+      {
+      TEST_EXPECT_EQUAL( components[k]->GetNumberOfThreads(), numberOfThreads );
+      if ( numberOfThreads == 1 )
+        {
+        referenceParameters.push_back( components[k]->GetFullParameters() );
+        referenceProportions = estimator->GetProportions();
+        continue;
+        }
+      for ( unsigned int p = 0; p < NumberOfParameters; p++ )
+        {
+        if ( itk::Math::abs( components[k]->GetFullParameters()[p] - referenceParameters[k][p] )
+             > 1e-4 * ( 1.0 + itk::Math::abs( referenceParameters[k][p] ) ) )
+          {
+          std::cerr << "Test failed: the parameters of component " << k << " estimated with "
+                    << numberOfThreads << " threads are " << components[k]->GetFullParameters()
+                    << " instead of " << referenceParameters[k] << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      if ( itk::Math::abs( estimator->GetProportions()[k] - referenceProportions[k] ) > 1e-8 )
+        {
+        std::cerr << "Test failed: the proportions estimated with " << numberOfThreads
+                  << " threads are " << estimator->GetProportions() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // Mini-batches
+  MiniBatchEstimatorType::Pointer miniBatchEstimator = MiniBatchEstimatorType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( miniBatchEstimator, MiniBatchGaussianMixtureModelEstimator, Object );
+
+  TRY_EXPECT_EXCEPTION( miniBatchEstimator->Update() );
+
+  miniBatchEstimator->SetSample(sample);
+  miniBatchEstimator->SetInitialProportions(initialProportions);
+  for ( unsigned int k = 0; k < NumberOfComponents; k++ )
+    {
+    ParametersType parameters(NumberOfParameters);
+    for ( unsigned int p = 0; p < NumberOfParameters; p++ )
+      {
+      parameters[p] = initialParameters[k][p];
+      }
+    TEST_EXPECT_EQUAL( miniBatchEstimator->AddComponent(parameters), k + 1 );
+    }
+  TEST_EXPECT_EQUAL( miniBatchEstimator->GetNumberOfComponents(), NumberOfComponents );
+  TRY_EXPECT_EXCEPTION( miniBatchEstimator->GetComponentParameters(NumberOfComponents) );
+
+  miniBatchEstimator->SetBatchSize(2000);
+  TEST_SET_GET_VALUE( 2000, miniBatchEstimator->GetBatchSize() );
+  miniBatchEstimator->SetMaximumIteration(150);
+  TEST_SET_GET_VALUE( 150, miniBatchEstimator->GetMaximumIteration() );
+  miniBatchEstimator->SetStepSizeExponent(0.6);
+  TEST_SET_GET_VALUE( 0.6, miniBatchEstimator->GetStepSizeExponent() );
+  miniBatchEstimator->SetSeed(1234);
+  TEST_SET_GET_VALUE( 1234, miniBatchEstimator->GetSeed() );
+
+  std::vector< ParametersType > singleThreadedParameters;
+  for ( itk::ThreadIdType numberOfThreads = 1; numberOfThreads <= 3; numberOfThreads += 2 )
+    {
+    miniBatchEstimator->SetNumberOfThreads(numberOfThreads);
+    TEST_SET_GET_VALUE( numberOfThreads, miniBatchEstimator->GetNumberOfThreads() );
+    TRY_EXPECT_NO_EXCEPTION( miniBatchEstimator->Update() );
+
+    std::cout << numberOfThreads << " threads, " << miniBatchEstimator->GetCurrentIteration()
+              << " mini-batches, proportions " << miniBatchEstimator->GetProportions() << std::endl;
+
+    for ( unsigned int k = 0; k < NumberOfComponents; k++ )
+      {
+      const ParametersType & parameters = miniBatchEstimator->GetComponentParameters(k);
+      std::cout << "  Component " << k << ": " << parameters << std::endl;
+
+      if ( numberOfThreads == 1 )
+        {
+        singleThreadedParameters.push_back(parameters);
+        }
+      for ( unsigned int p = 0; p < NumberOfParameters; p++ )
+        {
+        // The mini-batches only depend on the seed
+        if ( itk::Math::abs( parameters[p] - singleThreadedParameters[k][p] )
+             > 1e-6 * ( 1.0 + itk::Math::abs( parameters[p] ) ) )
+          {
+          std::cerr << "Test failed: the estimates depend on the number of threads." << std::endl;
+          return EXIT_FAILURE;
+          }
+
+        // Means within 0.5, variances within 10%
+        const double tolerance = p < NumberOfBands ? 0.5 : 0.1 * std::sqrt(trueParameters[k][2] * trueParameters[k][5]);
+        if ( itk::Math::abs( parameters[p] - trueParameters[k][p] ) > tolerance
+             || itk::Math::abs( parameters[p] - referenceParameters[k][p] ) > tolerance )
+          {
+          std::cerr << "Test failed: parameter " << p << " of component " << k << " is " << parameters[p]
+                    << " instead of " << trueParameters[k][p] << " and " << referenceParameters[k][p]
+                    << " estimated over the whole sample." << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+
+      if ( itk::Math::abs( miniBatchEstimator->GetProportions()[k] - trueProportions[k] ) > 0.01
+           || itk::Math::abs( miniBatchEstimator->GetProportions()[k] - referenceProportions[k] ) > 0.01 )
+        {
+        std::cerr << "Test failed: the proportion of component " << k << " is "
+                  << miniBatchEstimator->GetProportions()[k] << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  const MiniBatchEstimatorType::MembershipFunctionVectorType & membershipFunctions =
+    miniBatchEstimator->GetOutput()->Get();
+  TEST_EXPECT_EQUAL( membershipFunctions.size(), NumberOfComponents );
+  TEST_EXPECT_EQUAL( miniBatchEstimator->GetOutput()->Get().size(), NumberOfComponents );
+  TEST_EXPECT_EQUAL( miniBatchEstimator->GetMembershipFunctionsWeightsArray()->Get().Size(), NumberOfComponents );
+
+  // A component without its covariance
+  miniBatchEstimator->AddComponent( ParametersType(NumberOfBands) );
+  TRY_EXPECT_EXCEPTION( miniBatchEstimator->Update() );
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,99 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkSampleThreadRange.h"
+#include "itkImageToListSampleAdaptor.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+// The ranges of the threads must cover the elements once, in order, and
+// the iterators over a range must visit the same measurement vectors for
+// a list sample, read by instance identifier, and for an image adaptor,
+// read with its own iterator.
+int itkSampleThreadRangeTest(int, char *[])
+{
+  const itk::SizeValueType sizes[4] = { 0, 5, 64, 101 };
+  for ( unsigned int s = 0; s < 4; ++s )
+    {
+    for ( itk::ThreadIdType numberOfThreads = 1; numberOfThreads <= 7; ++numberOfThreads )
+      {
+      itk::SizeValueType previousEnd = 0;
+      for ( itk::ThreadIdType threadId = 0; threadId < numberOfThreads; ++threadId )
+        {
+        itk::SizeValueType begin;
+        itk::SizeValueType end;
+        itk::Statistics::GetThreadRange(sizes[s], threadId, numberOfThreads, begin, end);
+        TEST_EXPECT_EQUAL( begin, previousEnd );
+        TEST_EXPECT_TRUE( end - begin <= sizes[s] / numberOfThreads + 1 );
+        previousEnd = end;
+        }
+      TEST_EXPECT_EQUAL( previousEnd, sizes[s] );
+      }
+    }
+
+  typedef itk::FixedArray< float, 2 >                               MeasurementVectorType;
+  typedef itk::Image< MeasurementVectorType, 2 >                    ImageType;
+  typedef itk::Statistics::ImageToListSampleAdaptor< ImageType >    AdaptorType;
+  typedef itk::Statistics::ListSample< MeasurementVectorType >      ListSampleType;
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator    GeneratorType;
+
+  ImageType::SizeType size;
+  size[0] = 13;
+  size[1] = 8;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(11);
+  ListSampleType::Pointer listSample = ListSampleType::New();
+  listSample->SetMeasurementVectorSize(2);
+  for ( itk::ImageRegionIterator< ImageType > it( image, image->GetLargestPossibleRegion() ); !it.IsAtEnd(); ++it )
+    {
+    MeasurementVectorType measurement;
+    measurement[0] = generator->GetUniformVariate(-1.0, 1.0);
+    measurement[1] = generator->GetUniformVariate(-1.0, 1.0);
+    it.Set(measurement);
+    listSample->PushBack(measurement);
+    }
+
+  AdaptorType::Pointer adaptor = AdaptorType::New();
+  adaptor->SetImage(image);
+
+  const itk::ThreadIdType numberOfThreads = 3;
+  for ( itk::ThreadIdType threadId = 0; threadId < numberOfThreads; ++threadId )
+    {
+    itk::SizeValueType begin;
+    itk::SizeValueType end;
+    itk::Statistics::GetThreadRange(listSample->Size(), threadId, numberOfThreads, begin, end);
+
+    itk::Statistics::SampleRangeConstIterator< ListSampleType > listIt( listSample, begin );
+    itk::Statistics::SampleRangeConstIterator< AdaptorType >    adaptorIt( adaptor, begin );
+    for ( itk::SizeValueType id = begin; id < end; ++id, ++listIt, ++adaptorIt )
+      {
+      TEST_EXPECT_EQUAL( listIt.GetMeasurementVector(), listSample->GetMeasurementVector(id) );
+      TEST_EXPECT_EQUAL( adaptorIt.GetMeasurementVector(), listSample->GetMeasurementVector(id) );
+      TEST_EXPECT_EQUAL( listIt.GetFrequency(), 1 );
+      TEST_EXPECT_EQUAL( adaptorIt.GetFrequency(), 1 );
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkScalarImageToCooccurrenceMatrixFilter.h"
+#include "itkScalarImageToRunLengthMatrixFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkNeighborhood.h"
+#include "itkTestingMacros.h"
+
+// The matrices of the threads are merged in the output histogram: the
+// histograms must be the ones counted by a simple loop, whatever the number
+// of threads.
+int itkScalarImageToCooccurrenceMatrixFilterTest3(int, char* [] )
+{
+  const unsigned int Dimension = 3;
+  typedef itk::Image< short, Dimension >                                    ImageType;
+  typedef itk::Statistics::ScalarImageToCooccurrenceMatrixFilter< ImageType > CooccurrenceFilterType;
+  typedef itk::Statistics::ScalarImageToRunLengthMatrixFilter< ImageType >    RunLengthFilterType;
+  typedef CooccurrenceFilterType::HistogramType                             CooccurrenceHistogramType;
+  typedef RunLengthFilterType::HistogramType                                RunLengthHistogramType;
+
+  ImageType::SizeType size;
+  size[0] = 27;
+  size[1] = 22;
+  size[2] = 13;
+  ImageType::IndexType start;
+  start[0] = -3;
+  start[1] = 4;
+  start[2] = 1;
+  ImageType::RegionType region(start, size);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  ImageType::Pointer mask = ImageType::New();
+  mask->SetRegions(region);
+  mask->Allocate();
+  for ( itk::ImageRegionIteratorWithIndex< ImageType > it( image, region ); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set( static_cast< short >( ( ( index[0] / 3 + index[1] / 2 + index[2] ) % 7 ) * 20
+                                  + ( index[0] * 7 + index[1] * 13 + index[2] * 5 ) % 11 - 20 ) );
+    mask->SetPixel( index, ( index[0] + index[1] < 25 ) ? 1 : 0 );
+    }
+
+  // All the offsets one pixel away
+  itk::Neighborhood< short, Dimension > hood;
+  hood.SetRadius(1);
+  CooccurrenceFilterType::OffsetVectorPointer offsets = CooccurrenceFilterType::OffsetVector::New();
+  for ( unsigned int d = 0; d < hood.GetCenterNeighborhoodIndex(); ++d )
+    {
+    offsets->push_back( hood.GetOffset(d) );
+    }
+
+  const unsigned int numberOfBins = 16;
+  const short        minimum = -10;
+  const short        maximum = 125;
+
+  CooccurrenceFilterType::Pointer cooccurrenceFilter = CooccurrenceFilterType::New();
+  cooccurrenceFilter->SetInput(image);
+  cooccurrenceFilter->SetOffsets(offsets);
+  cooccurrenceFilter->SetNumberOfBinsPerAxis(numberOfBins);
+  cooccurrenceFilter->SetPixelValueMinMax(minimum, maximum);
+
+  RunLengthFilterType::Pointer runLengthFilter = RunLengthFilterType::New();
+  runLengthFilter->SetInput(image);
+  runLengthFilter->SetMaskImage(mask);
+  runLengthFilter->SetOffsets(offsets);
+  runLengthFilter->SetNumberOfBinsPerAxis(numberOfBins);
+  runLengthFilter->SetPixelValueMinMax(minimum, maximum);
+  runLengthFilter->SetDistanceValueMinMax(0, 8);
+
+  std::vector< RunLengthHistogramType::AbsoluteFrequencyType > runLengthReference;
+
+  for ( unsigned int useMask = 0; useMask < 2; ++useMask )
+    {
+    if ( useMask )
+      {
+      cooccurrenceFilter->SetMaskImage(mask);
+      }
+
+    const itk::ThreadIdType numberOfThreads[3] = { 1, 2, 5 };
+    for ( unsigned int t = 0; t < 3; ++t )
+      {
+      cooccurrenceFilter->SetNumberOfThreads(numberOfThreads[t]);
+      TRY_EXPECT_NO_EXCEPTION( cooccurrenceFilter->Update() );
+      const CooccurrenceHistogramType *histogram = cooccurrenceFilter->GetOutput();
+
+      // Count the pairs of bins of all the offsets
+      std::vector< double > reference( numberOfBins * numberOfBins, 0.0 );
+      CooccurrenceHistogramType::MeasurementVectorType measurement(2);
+      CooccurrenceHistogramType::IndexType             index(2);
+      for ( itk::ImageRegionIteratorWithIndex< ImageType > it( image, region ); !it.IsAtEnd(); ++it )
+        {
+        for ( unsigned int o = 0; o < offsets->Size(); ++o )
+          {
+          const ImageType::IndexType neighbor = it.GetIndex() + offsets->ElementAt(o);
+          if ( !region.IsInside(neighbor) )
+            {
+            continue;
+            }
+          const short value = it.Get();
+          const short neighborValue = image->GetPixel(neighbor);
+          if ( value < minimum || value > maximum || neighborValue < minimum || neighborValue > maximum )
+            {
+            continue;
+            }
+          if ( useMask && ( mask->GetPixel( it.GetIndex() ) != 1 || mask->GetPixel(neighbor) != 1 ) )
+            {
+            continue;
+            }
+          measurement[0] = value;
+          measurement[1] = neighborValue;
+          histogram->GetIndex(measurement, index);
+          reference[index[0] * numberOfBins + index[1]] += 1;
+          reference[index[1] * numberOfBins + index[0]] += 1;
+          }
+        }
+
+      double total = 0.0;
+      for ( unsigned int i = 0; i < numberOfBins; ++i )
+        {
+        for ( unsigned int j = 0; j < numberOfBins; ++j )
+          {
+          index[0] = i;
+          index[1] = j;
+          if ( itk::Math::NotExactlyEquals( histogram->GetFrequency(index), reference[i * numberOfBins + j] ) )
+            {
+            std::cerr << "Test failed with " << numberOfThreads[t] << " threads: the frequency of " << index
+                      << " is " << histogram->GetFrequency(index) << " instead of "
+                      << reference[i * numberOfBins + j] << std::endl;
+            return EXIT_FAILURE;
+            }
+          total += reference[i * numberOfBins + j];
+          }
+        }
+      std::cout << "Co-occurrence, mask " << useMask << ", " << numberOfThreads[t] << " threads: "
+                << total << " pairs" << std::endl;
+
+      // The runs do not depend on the number of threads
+      runLengthFilter->SetNumberOfThreads(numberOfThreads[t]);
+      TRY_EXPECT_NO_EXCEPTION( runLengthFilter->Update() );
+      const RunLengthHistogramType *runLengthHistogram = runLengthFilter->GetOutput();
+      if ( runLengthReference.empty() )
+        {
+        TEST_EXPECT_TRUE( runLengthHistogram->GetTotalFrequency() > 0 );
+        for ( unsigned int i = 0; i < runLengthHistogram->Size(); ++i )
+          {
+          runLengthReference.push_back( runLengthHistogram->GetFrequency(i) );
+          }
+        }
+      for ( unsigned int i = 0; i < runLengthReference.size(); ++i )
+        {
+        if ( runLengthHistogram->GetFrequency(i) != runLengthReference[i] )
+          {
+          std::cerr << "Test failed: the run length matrix depends on the number of threads." << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
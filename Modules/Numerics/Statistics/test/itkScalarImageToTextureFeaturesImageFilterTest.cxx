@@ -0,0 +1,187 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkScalarImageToTextureFeaturesImageFilter.h"
+#include "itkScalarImageToCooccurrenceMatrixFilter.h"
+#include "itkHistogramToTextureFeaturesFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+int itkScalarImageToTextureFeaturesImageFilterTest(int, char* [] )
+{
+  const unsigned int Dimension = 3;
+  typedef itk::Image< short, Dimension >                                        ImageType;
+  typedef itk::Statistics::ScalarImageToTextureFeaturesImageFilter< ImageType > FilterType;
+  typedef FilterType::OutputImageType                                           OutputImageType;
+  typedef itk::Statistics::ScalarImageToCooccurrenceMatrixFilter< ImageType >   MatrixFilterType;
+  typedef itk::Statistics::HistogramToTextureFeaturesFilter< MatrixFilterType::HistogramType >
+                                                                                FeaturesFilterType;
+
+  ImageType::SizeType size;
+  size[0] = 17;
+  size[1] = 12;
+  size[2] = 9;
+  ImageType::IndexType start;
+  start[0] = 2;
+  start[1] = -1;
+  start[2] = 0;
+  const ImageType::RegionType region(start, size);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  ImageType::Pointer mask = ImageType::New();
+  mask->SetRegions(region);
+  mask->Allocate();
+  for ( itk::ImageRegionIteratorWithIndex< ImageType > it( image, region ); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set( static_cast< short >( ( ( index[0] / 2 + index[1] + index[2] / 3 ) % 5 ) * 25
+                                  + ( index[0] * 7 + index[1] * 13 + index[2] * 5 ) % 11 ) );
+    mask->SetPixel( index, ( index[0] * index[0] + index[1] * index[1] < 150 ) ? 1 : 0 );
+    }
+
+  FilterType::Pointer filter = FilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( filter, ScalarImageToTextureFeaturesImageFilter, ImageToImageFilter );
+
+  // The default offsets are the 13 forward directions
+  TEST_EXPECT_EQUAL( filter->GetOffsets()->Size(), 13 );
+
+  FilterType::RadiusType radius;
+  radius[0] = 2;
+  radius[1] = 1;
+  radius[2] = 2;
+  const unsigned int numberOfBins = 6;
+  const short        minimum = 3;
+  const short        maximum = 120;
+
+  filter->SetInput(image);
+  filter->SetNeighborhoodRadius(radius);
+  filter->SetNumberOfBinsPerAxis(numberOfBins);
+  filter->SetPixelValueMinMax(minimum, maximum);
+  TEST_SET_GET_VALUE( radius, filter->GetNeighborhoodRadius() );
+  TEST_SET_GET_VALUE( numberOfBins, filter->GetNumberOfBinsPerAxis() );
+  TEST_SET_GET_VALUE( maximum, filter->GetMax() );
+
+  for ( unsigned int useMask = 0; useMask < 2; ++useMask )
+    {
+    if ( useMask )
+      {
+      filter->SetMaskImage(mask);
+      }
+
+    // The features must not depend on the number of threads
+    OutputImageType::Pointer singleThreaded;
+    const itk::ThreadIdType numberOfThreads[2] = { 1, 4 };
+    for ( unsigned int t = 0; t < 2; ++t )
+      {
+      filter->SetNumberOfThreads(numberOfThreads[t]);
+      TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+      if ( t == 0 )
+        {
+        singleThreaded = filter->GetOutput();
+        singleThreaded->DisconnectPipeline();
+        }
+      }
+    const OutputImageType *output = filter->GetOutput();
+    TEST_EXPECT_EQUAL( output->GetNumberOfComponentsPerPixel(), FilterType::NumberOfFeatures );
+
+    // The features of each pixel are the ones of the co-occurrence matrix of
+    // an image restricted to the box around the pixel
+    unsigned int numberOfComparedPixels = 0;
+    for ( itk::ImageRegionConstIteratorWithIndex< OutputImageType > it( output, region ); !it.IsAtEnd(); ++it )
+      {
+      const ImageType::IndexType index = it.GetIndex();
+      const OutputImageType::PixelType features = it.Get();
+      if ( features != singleThreaded->GetPixel(index) )
+        {
+        std::cerr << "Test failed: the features depend on the number of threads at " << index << std::endl;
+        return EXIT_FAILURE;
+        }
+
+      if ( useMask && mask->GetPixel(index) != 1 )
+        {
+        for ( unsigned int f = 0; f < FilterType::NumberOfFeatures; ++f )
+          {
+          if ( itk::Math::NotExactlyEquals( features[f], 0.0f ) )
+            {
+            std::cerr << "Test failed: the features out of the mask must be zero at " << index << std::endl;
+            return EXIT_FAILURE;
+            }
+          }
+        continue;
+        }
+
+      ImageType::RegionType box;
+      box.SetIndex(index - radius);
+      for ( unsigned int d = 0; d < Dimension; ++d )
+        {
+        box.SetSize(d, 2 * radius[d] + 1);
+        }
+      box.Crop(region);
+
+      ImageType::Pointer boxImage = ImageType::New();
+      boxImage->SetRegions(box);
+      boxImage->Allocate();
+      ImageType::Pointer boxMask = ImageType::New();
+      boxMask->SetRegions(box);
+      boxMask->Allocate();
+      for ( itk::ImageRegionIteratorWithIndex< ImageType > boxIt( boxImage, box ); !boxIt.IsAtEnd(); ++boxIt )
+        {
+        boxIt.Set( image->GetPixel( boxIt.GetIndex() ) );
+        boxMask->SetPixel( boxIt.GetIndex(), mask->GetPixel( boxIt.GetIndex() ) );
+        }
+
+      MatrixFilterType::Pointer matrixFilter = MatrixFilterType::New();
+      matrixFilter->SetInput(boxImage);
+      if ( useMask )
+        {
+        matrixFilter->SetMaskImage(boxMask);
+        }
+      matrixFilter->SetOffsets( filter->GetOffsets() );
+      matrixFilter->SetNumberOfBinsPerAxis(numberOfBins);
+      matrixFilter->SetPixelValueMinMax(minimum, maximum);
+      matrixFilter->Update();
+      if ( matrixFilter->GetOutput()->GetTotalFrequency() == 0 )
+        {
+        continue;
+        }
+
+      FeaturesFilterType::Pointer featuresFilter = FeaturesFilterType::New();
+      featuresFilter->SetInput( matrixFilter->GetOutput() );
+      featuresFilter->Update();
+      for ( unsigned int f = 0; f < FilterType::NumberOfFeatures; ++f )
+        {
+        const double expected =
+          featuresFilter->GetFeature( static_cast< FeaturesFilterType::TextureFeatureName >( f ) );
+        if ( !( itk::Math::abs( features[f] - expected ) <= 1e-4 * ( 1.0 + itk::Math::abs(expected) ) ) )
+          {
+          std::cerr << "Test failed: feature " << f << " at " << index << " is " << features[f]
+                    << " instead of " << expected << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      ++numberOfComparedPixels;
+      }
+    std::cout << "Mask " << useMask << ": " << numberOfComparedPixels << " pixels compared" << std::endl;
+    TEST_EXPECT_TRUE( numberOfComparedPixels > 100 );
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
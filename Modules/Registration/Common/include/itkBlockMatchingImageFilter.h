@@ -23,6 +23,11 @@
 #include "itkPointSet.h"
 #include "itkVector.h"
 #include "itkDefaultDynamicMeshTraits.h"
+#include "itkAtomicInt.h"
+#include "itkForwardFFTImageFilter.h"
+#include "itkInverseFFTImageFilter.h"
+#include <complex>
+#include <vector>
 
 
 namespace itk
@@ -41,6 +46,7 @@ namespace itk
  * achieved by using an appropriate mask during selection of feature points.
  * If you are unsure whether feature points satisfy the above condition set
  * CheckBoundary flag to true which turns on boundary checks.
+ * Pixels outside of the images are replicated from the nearest boundary pixel.
  * The default output(0) is a PointSet with displacements stored as vectors.
  * Additional output(1) is a PointSet containing similarities. Similarities
  * are needed to compute displacements and are always computed. The number
@@ -50,6 +56,20 @@ namespace itk
  * The filter is templated over fixed Image, moving Image, input PointSet,
  * output displacements PointSet and output similarities PointSet.
  *
+ * By default the similarity of every candidate displacement is computed
+ * directly, which costs (block volume) x (search volume) operations per
+ * feature point. When UseFFTNormalizedCorrelation is on, the cross-correlation
+ * between the moving block and the whole search window of the fixed image is
+ * computed with forward and inverse FFTs, and the local sums needed for the
+ * normalization are computed with running sums, in the same way as
+ * FFTNormalizedCorrelationImageFilter does. This is considerably faster for
+ * large block and search radii. Both methods produce the same results up to
+ * floating point round-off.
+ *
+ * Feature points are handed out to the threads one at a time, so that
+ * threads which finish their blocks early keep working on the remaining
+ * points instead of waiting for the others.
+ *
  * This filter is intended to be used in the process of Physics-Based
  * Non-Rigid Registration. It computes displacement for selected points based
  * on similarity [M. Bierling, Displacement estimation by hierarchical block
@@ -128,6 +148,13 @@ public:
   itkSetMacro(SearchRadius, ImageSizeType);
   itkGetConstMacro(SearchRadius, ImageSizeType);
 
+  /** set/get whether the similarities are computed through FFT-based
+   * cross-correlation of the moving block with the search window. Default is
+   * false. */
+  itkSetMacro(UseFFTNormalizedCorrelation, bool);
+  itkGetConstMacro(UseFFTNormalizedCorrelation, bool);
+  itkBooleanMacro(UseFFTNormalizedCorrelation);
+
   /** set/get fixed image */
   itkSetInputMacro(FixedImage, FixedImageType);
   itkGetInputMacro(FixedImage, FixedImageType);
@@ -194,9 +221,47 @@ protected:
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(BlockMatchingImageFilter);
 
+  /** Types used to compute the similarities with FFTs */
+  typedef double                                                      FFTRealType;
+  typedef Image< FFTRealType, ImageDimension >                        FFTRealImageType;
+  typedef Image< std::complex< FFTRealType >, ImageDimension >        FFTComplexImageType;
+  typedef ForwardFFTImageFilter< FFTRealImageType, FFTComplexImageType > FFTForwardFilterType;
+  typedef InverseFFTImageFilter< FFTComplexImageType, FFTRealImageType > FFTInverseFilterType;
+
+  /** Brute-force search of the displacement of feature point idx. */
+  void ThreadedMatchBlock( SizeValueType idx );
+
+  /** FFT-based search of the displacement of feature point idx. The
+   * images and filters are owned by the calling thread. */
+  void ThreadedMatchBlockFFT( SizeValueType idx,
+                              FFTRealImageType *windowImage,
+                              FFTRealImageType *blockImage,
+                              FFTForwardFilterType *windowFFT,
+                              FFTForwardFilterType *blockFFT,
+                              FFTComplexImageType *product,
+                              FFTInverseFilterType *inverseFFT );
+
+  /** Copy the pixels of region of image into the beginning of buffer,
+   * replicating the boundary pixels for indices outside the image. */
+  template< typename TImage >
+  static void CopyRegion( const TImage *image, const ImageRegionType & region,
+                          FFTRealImageType *buffer );
+
+  /** Replace each line along dimension dim of values by the sums of its
+   * sliding windows of length samples, shrinking size accordingly. */
+  static void SlidingSum( std::vector< FFTRealType > & values, ImageSizeType & size,
+                          unsigned int dim, SizeValueType length );
+
   // algorithm parameters
   ImageSizeType  m_BlockRadius;
   ImageSizeType  m_SearchRadius;
+  bool           m_UseFFTNormalizedCorrelation;
+
+  // size of the images transformed by the FFT path
+  ImageSizeType  m_FFTSize;
+
+  // next feature point to be matched by any of the threads
+  AtomicInt< SizeValueType > m_NextPointIndex;
 
   // temporary dynamic arrays for storing threads outputs
   SizeValueType         m_PointsCount;
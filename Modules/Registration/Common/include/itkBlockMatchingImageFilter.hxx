@@ -20,7 +20,12 @@
 
 #include "itkBlockMatchingImageFilter.h"
 #include "itkImageRegionConstIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
 #include "itkConstNeighborhoodIterator.h"
+#include "itkMath.h"
+#include <algorithm>
 #include <limits>
 
 
@@ -33,6 +38,8 @@ BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements,
   // defaults
   this->m_BlockRadius.Fill( 2 );
   this->m_SearchRadius.Fill( 3 );
+  this->m_UseFFTNormalizedCorrelation = false;
+  this->m_FFTSize.Fill( 0 );
 
   // make the outputs
   this->ProcessObject::SetNumberOfRequiredOutputs( 2 );
@@ -62,7 +69,8 @@ BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements,
   Superclass::PrintSelf( os, indent );
   os << indent << "Number of threads: " << this->GetNumberOfThreads() << std::endl
      << indent << "m_BlockRadius: " << m_BlockRadius << std::endl
-     << indent << "m_SearchRadius: " << m_SearchRadius << std::endl;
+     << indent << "m_SearchRadius: " << m_SearchRadius << std::endl
+     << indent << "m_UseFFTNormalizedCorrelation: " << m_UseFFTNormalizedCorrelation << std::endl;
 }
 
 template< typename TFixedImage, typename TMovingImage, typename TFeatures, typename TDisplacements, typename TSimilarities >
@@ -149,6 +157,33 @@ BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements,
 
   this->m_DisplacementsVectorsArray = new DisplacementsVector[ this->m_PointsCount ];
   this->m_SimilaritiesValuesArray = new SimilaritiesValue[ this->m_PointsCount ];
+
+  this->m_NextPointIndex = 0;
+
+  if ( this->m_UseFFTNormalizedCorrelation )
+    {
+    // the search window is padded to a size supported by the FFT
+    // implementation; the correlation does not wrap around as long as the
+    // padded size is not smaller than the window
+    const SizeValueType sizeGreatestPrimeFactor = FFTForwardFilterType::New()->GetSizeGreatestPrimeFactor();
+    for ( unsigned i = 0; i < ImageDimension; i++ )
+      {
+      SizeValueType size = 2 * ( this->m_SearchRadius[ i ] + this->m_BlockRadius[ i ] ) + 1;
+      if ( sizeGreatestPrimeFactor > 1 )
+        {
+        while ( Math::GreatestPrimeFactor( size ) > sizeGreatestPrimeFactor )
+          {
+          ++size;
+          }
+        }
+      else if ( sizeGreatestPrimeFactor == 1 )
+        {
+        // make sure the size is even
+        size += size % 2;
+        }
+      this->m_FFTSize[ i ] = size;
+      }
+    }
 }
 
 template< typename TFixedImage, typename TMovingImage, typename TFeatures, typename TDisplacements, typename TSimilarities >
@@ -221,21 +256,65 @@ BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements,
 template< typename TFixedImage, typename TMovingImage, typename TFeatures, typename TDisplacements, typename TSimilarities >
 void
 BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements, TSimilarities >
-::ThreadedGenerateData( ThreadIdType threadId ) throw ( ExceptionObject )
+::ThreadedGenerateData( ThreadIdType itkNotUsed( threadId ) ) throw ( ExceptionObject )
 {
-  FixedImageConstPointer fixedImage = this->GetFixedImage();
-  MovingImageConstPointer movingImage = this->GetMovingImage();
-  FeaturePointsConstPointer featurePoints = this->GetFeaturePoints();
+  // Feature points are not assigned to the threads in advance. Each thread
+  // takes the next point that has not been processed yet, so that the load
+  // stays balanced even when the cost of matching varies between points.
+  SizeValueType idx;
 
-  SizeValueType threadCount = this->GetNumberOfThreads();
+  if ( !this->m_UseFFTNormalizedCorrelation )
+    {
+    while ( ( idx = this->m_NextPointIndex++ ) < this->m_PointsCount )
+      {
+      this->ThreadedMatchBlock( idx );
+      }
+    return;
+    }
+
+  // the images and filters of the FFT path are reused for all the points
+  // processed by this thread
+  const ImageRegionType fftRegion( this->m_FFTSize );
+
+  typename FFTRealImageType::Pointer windowImage = FFTRealImageType::New();
+  windowImage->SetRegions( fftRegion );
+  windowImage->Allocate( true );
+
+  // the block is zero padded: only its first voxels are ever written
+  typename FFTRealImageType::Pointer blockImage = FFTRealImageType::New();
+  blockImage->SetRegions( fftRegion );
+  blockImage->Allocate( true );
 
-  // compute first point and number of points (count) for this thread
-  SizeValueType count = m_PointsCount / threadCount;
-  SizeValueType first = threadId * count;
-  if ( threadId + 1 == threadCount ) // last thread
+  typename FFTComplexImageType::Pointer product = FFTComplexImageType::New();
+  product->SetRegions( fftRegion );
+  product->Allocate();
+
+  typename FFTForwardFilterType::Pointer windowFFT = FFTForwardFilterType::New();
+  windowFFT->SetNumberOfThreads( 1 );
+  windowFFT->SetInput( windowImage );
+
+  typename FFTForwardFilterType::Pointer blockFFT = FFTForwardFilterType::New();
+  blockFFT->SetNumberOfThreads( 1 );
+  blockFFT->SetInput( blockImage );
+
+  typename FFTInverseFilterType::Pointer inverseFFT = FFTInverseFilterType::New();
+  inverseFFT->SetNumberOfThreads( 1 );
+  inverseFFT->SetInput( product );
+
+  while ( ( idx = this->m_NextPointIndex++ ) < this->m_PointsCount )
     {
-    count += this->m_PointsCount % threadCount;
+    this->ThreadedMatchBlockFFT( idx, windowImage, blockImage, windowFFT, blockFFT, product, inverseFFT );
     }
+}
+
+template< typename TFixedImage, typename TMovingImage, typename TFeatures, typename TDisplacements, typename TSimilarities >
+void
+BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements, TSimilarities >
+::ThreadedMatchBlock( SizeValueType idx )
+{
+  FixedImageConstPointer fixedImage = this->GetFixedImage();
+  MovingImageConstPointer movingImage = this->GetMovingImage();
+  FeaturePointsConstPointer featurePoints = this->GetFeaturePoints();
 
   // start constructing window region and center region (single voxel)
   ImageRegionType window;
@@ -253,76 +332,272 @@ BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements,
     numberOfVoxelInBlock *= m_BlockRadius[ i ] + 1 + m_BlockRadius[ i ];
     }
 
-  // loop thru feature points
-  for ( SizeValueType idx = first, last = first + count; idx < last; idx++ )
+  FeaturePointsPhysicalCoordinates originalLocation = featurePoints->GetPoint( idx );
+  ImageIndexType fixedIndex;
+  fixedImage->TransformPhysicalPointToIndex(    originalLocation, fixedIndex );
+  ImageIndexType movingIndex;
+  movingImage->TransformPhysicalPointToIndex( originalLocation, movingIndex );
+
+  // the block is selected for a minimum similarity metric
+  SimilaritiesValue  similarity = NumericTraits< SimilaritiesValue >::ZeroValue();
+
+  // New point location
+  DisplacementsVector displacement;
+
+  // set centers of window and center regions to current location
+  ImageIndexType start = fixedIndex - this->m_SearchRadius;
+  window.SetIndex( start );
+  center.SetIndex( movingIndex );
+
+  // iterate over neighborhoods in region window, for each neighborhood: iterate over voxels in blockRadius
+  ConstNeighborhoodIterator< FixedImageType > windowIterator( m_BlockRadius, fixedImage, window );
+
+  // iterate over voxels in neighborhood of current feature point
+  ConstNeighborhoodIterator< MovingImageType > centerIterator( m_BlockRadius, movingImage, center );
+  centerIterator.GoToBegin();
+
+  // iterate over neighborhoods in region window
+  for ( windowIterator.GoToBegin(); !windowIterator.IsAtEnd(); ++windowIterator )
     {
-    FeaturePointsPhysicalCoordinates originalLocation = featurePoints->GetPoint( idx );
-    ImageIndexType fixedIndex;
-    fixedImage->TransformPhysicalPointToIndex(    originalLocation, fixedIndex );
-    ImageIndexType movingIndex;
-    movingImage->TransformPhysicalPointToIndex( originalLocation, movingIndex );
+    SimilaritiesValue fixedSum = NumericTraits< SimilaritiesValue >::ZeroValue();
+    SimilaritiesValue fixedSumOfSquares = NumericTraits< SimilaritiesValue >::ZeroValue();
+    SimilaritiesValue movingSum = NumericTraits< SimilaritiesValue >::ZeroValue();
+    SimilaritiesValue movingSumOfSquares = NumericTraits< SimilaritiesValue >::ZeroValue();
+    SimilaritiesValue covariance = NumericTraits< SimilaritiesValue >::ZeroValue();
+
+    // iterate over voxels in blockRadius
+    for ( SizeValueType i = 0; i < numberOfVoxelInBlock; i++ ) // windowIterator.Size() == numberOfVoxelInBlock
+      {
+      const SimilaritiesValue fixedValue = windowIterator.GetPixel( i );
+      const SimilaritiesValue movingValue = centerIterator.GetPixel( i );
+      movingSum += movingValue;
+      fixedSum += fixedValue;
+      movingSumOfSquares += movingValue * movingValue;
+      fixedSumOfSquares += fixedValue * fixedValue;
+      covariance += fixedValue * movingValue;
+      }
+    const SimilaritiesValue fixedMean = fixedSum / numberOfVoxelInBlock;
+    const SimilaritiesValue movingMean = movingSum / numberOfVoxelInBlock;
+    const SimilaritiesValue fixedVariance = fixedSumOfSquares - numberOfVoxelInBlock * fixedMean * fixedMean;
+    const SimilaritiesValue movingVariance = movingSumOfSquares - numberOfVoxelInBlock * movingMean * movingMean;
+    covariance -= numberOfVoxelInBlock * fixedMean * movingMean;
+
+    SimilaritiesValue sim = NumericTraits< SimilaritiesValue >::ZeroValue();
+    if ( fixedVariance * movingVariance )
+      {
+      sim = ( covariance * covariance ) / ( fixedVariance * movingVariance );
+      }
 
-    // the block is selected for a minimum similarity metric
-    SimilaritiesValue  similarity = NumericTraits< SimilaritiesValue >::ZeroValue();
+    if ( sim >= similarity )
+      {
+      FeaturePointsPhysicalCoordinates newLocation;
+      fixedImage->TransformIndexToPhysicalPoint( windowIterator.GetIndex(), newLocation );
+      displacement = newLocation - originalLocation;
+      similarity = sim;
+      }
+    }
+  this->m_DisplacementsVectorsArray[ idx ] = displacement;
+  this->m_SimilaritiesValuesArray[ idx ] = similarity;
+}
 
-    // New point location
-    DisplacementsVector displacement;
+template< typename TFixedImage, typename TMovingImage, typename TFeatures, typename TDisplacements, typename TSimilarities >
+void
+BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements, TSimilarities >
+::ThreadedMatchBlockFFT( SizeValueType idx,
+                         FFTRealImageType *windowImage,
+                         FFTRealImageType *blockImage,
+                         FFTForwardFilterType *windowFFT,
+                         FFTForwardFilterType *blockFFT,
+                         FFTComplexImageType *product,
+                         FFTInverseFilterType *inverseFFT )
+{
+  FixedImageConstPointer fixedImage = this->GetFixedImage();
+  MovingImageConstPointer movingImage = this->GetMovingImage();
+  FeaturePointsConstPointer featurePoints = this->GetFeaturePoints();
+
+  ImageSizeType blockSize;
+  ImageSizeType searchSize;
+  ImageSizeType windowSize;
+  SizeValueType numberOfVoxelInBlock = 1;
+  for ( unsigned i = 0; i < ImageDimension; i++ )
+    {
+    blockSize[ i ] = m_BlockRadius[ i ] + 1 + m_BlockRadius[ i ];
+    searchSize[ i ] = m_SearchRadius[ i ] + 1 + m_SearchRadius[ i ];
+    windowSize[ i ] = searchSize[ i ] + blockSize[ i ] - 1;
+    numberOfVoxelInBlock *= blockSize[ i ];
+    }
+
+  FeaturePointsPhysicalCoordinates originalLocation = featurePoints->GetPoint( idx );
+  ImageIndexType fixedIndex;
+  fixedImage->TransformPhysicalPointToIndex(    originalLocation, fixedIndex );
+  ImageIndexType movingIndex;
+  movingImage->TransformPhysicalPointToIndex( originalLocation, movingIndex );
+
+  // the window covers all the voxels of the fixed image visited by the
+  // neighborhoods of the brute-force search
+  const ImageRegionType window( fixedIndex - this->m_SearchRadius - this->m_BlockRadius, windowSize );
+  const ImageRegionType block( movingIndex - this->m_BlockRadius, blockSize );
+  CopyRegion( fixedImage.GetPointer(), window, windowImage );
+  CopyRegion( movingImage.GetPointer(), block, blockImage );
+  windowImage->Modified();
+  blockImage->Modified();
+
+  // cross-correlation of the block with every neighborhood of the window,
+  // computed as the inverse transform of F * conj(M). The result at index t
+  // is the sum of products of the block with the neighborhood starting at t.
+  windowFFT->Update();
+  blockFFT->Update();
+
+  const ImageRegionType fftRegion = product->GetLargestPossibleRegion();
+  ImageRegionConstIterator< FFTComplexImageType > windowFFTIt( windowFFT->GetOutput(), fftRegion );
+  ImageRegionConstIterator< FFTComplexImageType > blockFFTIt( blockFFT->GetOutput(), fftRegion );
+  ImageRegionIterator< FFTComplexImageType > productIt( product, fftRegion );
+  for ( ; !productIt.IsAtEnd(); ++productIt, ++windowFFTIt, ++blockFFTIt )
+    {
+    productIt.Set( windowFFTIt.Get() * std::conj( blockFFTIt.Get() ) );
+    }
+  product->Modified();
+  inverseFFT->Update();
+
+  // sums and sums of squares of the fixed image over every neighborhood
+  const ImageRegionType windowBuffer( windowSize );
+  std::vector< FFTRealType > fixedSums( windowBuffer.GetNumberOfPixels() );
+  std::vector< FFTRealType > fixedSumsOfSquares( windowBuffer.GetNumberOfPixels() );
+  ImageRegionConstIterator< FFTRealImageType > windowIt( windowImage, windowBuffer );
+  for ( SizeValueType i = 0; !windowIt.IsAtEnd(); ++windowIt, i++ )
+    {
+    const FFTRealType value = windowIt.Get();
+    fixedSums[ i ] = value;
+    fixedSumsOfSquares[ i ] = value * value;
+    }
+  ImageSizeType sumsSize = windowSize;
+  ImageSizeType sumsOfSquaresSize = windowSize;
+  for ( unsigned i = 0; i < ImageDimension; i++ )
+    {
+    SlidingSum( fixedSums, sumsSize, i, blockSize[ i ] );
+    SlidingSum( fixedSumsOfSquares, sumsOfSquaresSize, i, blockSize[ i ] );
+    }
+
+  SimilaritiesValue movingSum = NumericTraits< SimilaritiesValue >::ZeroValue();
+  SimilaritiesValue movingSumOfSquares = NumericTraits< SimilaritiesValue >::ZeroValue();
+  ImageRegionConstIterator< FFTRealImageType > blockIt( blockImage, ImageRegionType( blockSize ) );
+  for ( ; !blockIt.IsAtEnd(); ++blockIt )
+    {
+    const SimilaritiesValue movingValue = blockIt.Get();
+    movingSum += movingValue;
+    movingSumOfSquares += movingValue * movingValue;
+    }
+  const SimilaritiesValue movingMean = movingSum / numberOfVoxelInBlock;
+  const SimilaritiesValue movingVariance = movingSumOfSquares - numberOfVoxelInBlock * movingMean * movingMean;
 
-    // set centers of window and center regions to current location
-    ImageIndexType start = fixedIndex - this->m_SearchRadius;
-    window.SetIndex( start );
-    center.SetIndex( movingIndex );
+  // the variances computed from the running sums carry a round-off error
+  // proportional to the sums of squares; smaller values are treated as zero
+  const SimilaritiesValue tolerance = 1000 * NumericTraits< FFTRealType >::epsilon();
 
-    // iterate over neighborhoods in region window, for each neighborhood: iterate over voxels in blockRadius
-    ConstNeighborhoodIterator< FixedImageType > windowIterator( m_BlockRadius, fixedImage, window );
+  // the block is selected for a minimum similarity metric
+  SimilaritiesValue  similarity = NumericTraits< SimilaritiesValue >::ZeroValue();
 
-    // iterate over voxels in neighborhood of current feature point
-    ConstNeighborhoodIterator< MovingImageType > centerIterator( m_BlockRadius, movingImage, center );
-    centerIterator.GoToBegin();
+  // New point location
+  DisplacementsVector displacement;
 
-    // iterate over neighborhoods in region window
-    for ( windowIterator.GoToBegin(); !windowIterator.IsAtEnd(); ++windowIterator )
+  // visit the neighborhoods in the same order as the brute-force search
+  const ImageIndexType start = fixedIndex - this->m_SearchRadius;
+  ImageRegionConstIteratorWithIndex< FFTRealImageType > correlationIt( inverseFFT->GetOutput(), ImageRegionType( searchSize ) );
+  for ( SizeValueType i = 0; !correlationIt.IsAtEnd(); ++correlationIt, i++ )
+    {
+    const SimilaritiesValue fixedMean = fixedSums[ i ] / numberOfVoxelInBlock;
+    const SimilaritiesValue fixedVariance = fixedSumsOfSquares[ i ] - numberOfVoxelInBlock * fixedMean * fixedMean;
+    const SimilaritiesValue covariance = correlationIt.Get() - numberOfVoxelInBlock * fixedMean * movingMean;
+
+    SimilaritiesValue sim = NumericTraits< SimilaritiesValue >::ZeroValue();
+    if ( fixedVariance > tolerance * fixedSumsOfSquares[ i ] && movingVariance > tolerance * movingSumOfSquares )
       {
-      SimilaritiesValue fixedSum = NumericTraits< SimilaritiesValue >::ZeroValue();
-      SimilaritiesValue fixedSumOfSquares = NumericTraits< SimilaritiesValue >::ZeroValue();
-      SimilaritiesValue movingSum = NumericTraits< SimilaritiesValue >::ZeroValue();
-      SimilaritiesValue movingSumOfSquares = NumericTraits< SimilaritiesValue >::ZeroValue();
-      SimilaritiesValue covariance = NumericTraits< SimilaritiesValue >::ZeroValue();
-
-      // iterate over voxels in blockRadius
-      for ( SizeValueType i = 0; i < numberOfVoxelInBlock; i++ ) // windowIterator.Size() == numberOfVoxelInBlock
+      sim = ( covariance * covariance ) / ( fixedVariance * movingVariance );
+      }
+
+    if ( sim >= similarity )
+      {
+      ImageIndexType index = start;
+      for ( unsigned j = 0; j < ImageDimension; j++ )
         {
-        const SimilaritiesValue fixedValue = windowIterator.GetPixel( i );
-        const SimilaritiesValue movingValue = centerIterator.GetPixel( i );
-        movingSum += movingValue;
-        fixedSum += fixedValue;
-        movingSumOfSquares += movingValue * movingValue;
-        fixedSumOfSquares += fixedValue * fixedValue;
-        covariance += fixedValue * movingValue;
+        index[ j ] += correlationIt.GetIndex()[ j ];
         }
-      const SimilaritiesValue fixedMean = fixedSum / numberOfVoxelInBlock;
-      const SimilaritiesValue movingMean = movingSum / numberOfVoxelInBlock;
-      const SimilaritiesValue fixedVariance = fixedSumOfSquares - numberOfVoxelInBlock * fixedMean * fixedMean;
-      const SimilaritiesValue movingVariance = movingSumOfSquares - numberOfVoxelInBlock * movingMean * movingMean;
-      covariance -= numberOfVoxelInBlock * fixedMean * movingMean;
-
-      SimilaritiesValue sim = NumericTraits< SimilaritiesValue >::ZeroValue();
-      if ( fixedVariance * movingVariance )
+      FeaturePointsPhysicalCoordinates newLocation;
+      fixedImage->TransformIndexToPhysicalPoint( index, newLocation );
+      displacement = newLocation - originalLocation;
+      similarity = sim;
+      }
+    }
+  this->m_DisplacementsVectorsArray[ idx ] = displacement;
+  this->m_SimilaritiesValuesArray[ idx ] = similarity;
+}
+
+template< typename TFixedImage, typename TMovingImage, typename TFeatures, typename TDisplacements, typename TSimilarities >
+template< typename TImage >
+void
+BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements, TSimilarities >
+::CopyRegion( const TImage *image, const ImageRegionType & region, FFTRealImageType *buffer )
+{
+  const ImageRegionType & bufferedRegion = image->GetBufferedRegion();
+  const ImageIndexType  & lowerIndex = bufferedRegion.GetIndex();
+  const ImageIndexType    upperIndex = bufferedRegion.GetUpperIndex();
+
+  ImageRegionIteratorWithIndex< FFTRealImageType > it( buffer, ImageRegionType( region.GetSize() ) );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    ImageIndexType index = region.GetIndex();
+    for ( unsigned i = 0; i < ImageDimension; i++ )
+      {
+      index[ i ] += it.GetIndex()[ i ];
+      index[ i ] = std::min( std::max( index[ i ], lowerIndex[ i ] ), upperIndex[ i ] );
+      }
+    it.Set( static_cast< FFTRealType >( image->GetPixel( index ) ) );
+    }
+}
+
+template< typename TFixedImage, typename TMovingImage, typename TFeatures, typename TDisplacements, typename TSimilarities >
+void
+BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements, TSimilarities >
+::SlidingSum( std::vector< FFTRealType > & values, ImageSizeType & size, unsigned int dim, SizeValueType length )
+{
+  SizeValueType stride = 1;
+  SizeValueType count = 1;
+  for ( unsigned i = 0; i < ImageDimension; i++ )
+    {
+    if ( i < dim )
+      {
+      stride *= size[ i ];
+      }
+    else if ( i > dim )
+      {
+      count *= size[ i ];
+      }
+    }
+  const SizeValueType inputLength = size[ dim ];
+  const SizeValueType outputLength = inputLength - length + 1;
+
+  std::vector< FFTRealType > sums( stride * outputLength * count );
+  for ( SizeValueType n = 0; n < count; n++ )
+    {
+    for ( SizeValueType s = 0; s < stride; s++ )
+      {
+      const FFTRealType *in = &values[ n * inputLength * stride + s ];
+      FFTRealType *out = &sums[ n * outputLength * stride + s ];
+      FFTRealType sum = NumericTraits< FFTRealType >::ZeroValue();
+      for ( SizeValueType k = 0; k < length; k++ )
         {
-        sim = ( covariance * covariance ) / ( fixedVariance * movingVariance );
+        sum += in[ k * stride ];
         }
-
-      if ( sim >= similarity )
+      out[ 0 ] = sum;
+      for ( SizeValueType k = 1; k < outputLength; k++ )
         {
-        FeaturePointsPhysicalCoordinates newLocation;
-        fixedImage->TransformIndexToPhysicalPoint( windowIterator.GetIndex(), newLocation );
-        displacement = newLocation - originalLocation;
-        similarity = sim;
+        sum += in[ ( k + length - 1 ) * stride ] - in[ ( k - 1 ) * stride ];
+        out[ k * stride ] = sum;
         }
       }
-    this->m_DisplacementsVectorsArray[ idx ] = displacement;
-    this->m_SimilaritiesValuesArray[ idx ] = similarity;
     }
+  values.swap( sums );
+  size[ dim ] = outputLength;
 }
 
 } // end namespace itk
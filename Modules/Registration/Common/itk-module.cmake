@@ -23,6 +23,7 @@ itk_module(ITKRegistrationCommon
     ITKFiniteDifference
     ITKDisplacementField
     ITKStatistics
+    ITKFFT
   TEST_DEPENDS
     ITKTestKernel
     ITKDistanceMap
@@ -35,3 +36,4 @@ itk_module(ITKRegistrationCommon
 
 # Extra test dependency on ITKDistanceMap is introduced by itkPointSetToPointSetRegistrationTest.
 # Dependency on ITKStatistics is introduced by itkPointsLocator.
+# Dependency on ITKFFT is introduced by itkBlockMatchingImageFilter.
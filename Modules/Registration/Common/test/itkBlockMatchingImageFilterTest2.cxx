@@ -0,0 +1,185 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkBlockMatchingImageFilter.h"
+#include "itkTestingMacros.h"
+
+
+/**
+ * Matches the blocks of a translated synthetic image once by iterating over
+ * the search window and once through the FFT-based cross-correlation. Both
+ * must find the translation, with the same similarities.
+ */
+int itkBlockMatchingImageFilterTest2( int, char * [] )
+{
+  static ITK_CONSTEXPR_VAR unsigned int Dimension = 3;
+
+  typedef float                                     PixelType;
+  typedef itk::Image< PixelType, Dimension >        ImageType;
+  typedef itk::BlockMatchingImageFilter< ImageType > BlockMatchingFilterType;
+
+  typedef BlockMatchingFilterType::FeaturePointsType    PointSetType;
+  typedef BlockMatchingFilterType::DisplacementsType    DisplacementsType;
+  typedef BlockMatchingFilterType::SimilaritiesType     SimilaritiesType;
+
+  ImageType::SizeType size;
+  size.Fill( 32 );
+
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.0;
+  spacing[1] = 0.5;
+  spacing[2] = 2.0;
+
+  ImageType::OffsetType shift;
+  shift[0] = 2;
+  shift[1] = -1;
+  shift[2] = 3;
+
+  // the moving image is the fixed image translated by shift voxels
+  ImageType::Pointer fixedImage = ImageType::New();
+  fixedImage->SetRegions( size );
+  fixedImage->SetSpacing( spacing );
+  fixedImage->Allocate();
+
+  ImageType::Pointer movingImage = ImageType::New();
+  movingImage->SetRegions( size );
+  movingImage->SetSpacing( spacing );
+  movingImage->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > fixedIt( fixedImage, fixedImage->GetLargestPossibleRegion() );
+  itk::ImageRegionIteratorWithIndex< ImageType > movingIt( movingImage, movingImage->GetLargestPossibleRegion() );
+  for ( ; !fixedIt.IsAtEnd(); ++fixedIt, ++movingIt )
+    {
+    ImageType::IndexType index = fixedIt.GetIndex();
+    PixelType value = std::sin( 0.7 * index[0] ) + std::cos( 0.45 * index[1] + 0.3 * index[2] )
+      + ( ( 73 * index[0] + 151 * index[1] + 199 * index[2] ) % 17 ) / 17.0;
+    fixedIt.Set( value );
+
+    index += shift;
+    value = std::sin( 0.7 * index[0] ) + std::cos( 0.45 * index[1] + 0.3 * index[2] )
+      + ( ( 73 * index[0] + 151 * index[1] + 199 * index[2] ) % 17 ) / 17.0;
+    movingIt.Set( value );
+    }
+
+  ImageType::SizeType blockRadius;
+  blockRadius.Fill( 2 );
+
+  ImageType::SizeType searchRadius;
+  searchRadius[0] = 4;
+  searchRadius[1] = 3;
+  searchRadius[2] = 5;
+
+  // feature points on a regular grid, far enough from the boundary
+  PointSetType::Pointer featurePoints = PointSetType::New();
+  PointSetType::PointIdentifier id = 0;
+  ImageType::IndexType index;
+  for ( index[2] = 8; index[2] < 24; index[2] += 5 )
+    {
+    for ( index[1] = 8; index[1] < 24; index[1] += 5 )
+      {
+      for ( index[0] = 8; index[0] < 24; index[0] += 5 )
+        {
+        PointSetType::PointType point;
+        fixedImage->TransformIndexToPhysicalPoint( index, point );
+        featurePoints->SetPoint( id++, point );
+        }
+      }
+    }
+
+  BlockMatchingFilterType::Pointer bruteForceFilter = BlockMatchingFilterType::New();
+
+  EXERCISE_BASIC_OBJECT_METHODS( bruteForceFilter, BlockMatchingImageFilter, MeshToMeshFilter );
+
+  TEST_SET_GET_BOOLEAN( bruteForceFilter, UseFFTNormalizedCorrelation, false );
+
+  bruteForceFilter->SetBlockRadius( blockRadius );
+  bruteForceFilter->SetSearchRadius( searchRadius );
+  bruteForceFilter->SetFixedImage( fixedImage );
+  bruteForceFilter->SetMovingImage( movingImage );
+  bruteForceFilter->SetFeaturePoints( featurePoints );
+  bruteForceFilter->SetNumberOfThreads( 3 );
+
+  TRY_EXPECT_NO_EXCEPTION( bruteForceFilter->Update() );
+
+  BlockMatchingFilterType::Pointer fftFilter = BlockMatchingFilterType::New();
+  fftFilter->SetBlockRadius( blockRadius );
+  fftFilter->SetSearchRadius( searchRadius );
+  fftFilter->SetFixedImage( fixedImage );
+  fftFilter->SetMovingImage( movingImage );
+  fftFilter->SetFeaturePoints( featurePoints );
+  fftFilter->SetNumberOfThreads( 3 );
+  fftFilter->UseFFTNormalizedCorrelationOn();
+
+  TRY_EXPECT_NO_EXCEPTION( fftFilter->Update() );
+
+  DisplacementsType::PixelType expectedDisplacement;
+  for ( unsigned int i = 0; i < Dimension; i++ )
+    {
+    expectedDisplacement[i] = shift[i] * spacing[i];
+    }
+
+  const double tolerance = 1e-6;
+
+  DisplacementsType::Pointer bruteForceDisplacements = bruteForceFilter->GetDisplacements();
+  DisplacementsType::Pointer fftDisplacements = fftFilter->GetDisplacements();
+  SimilaritiesType::Pointer bruteForceSimilarities = bruteForceFilter->GetSimilarities();
+  SimilaritiesType::Pointer fftSimilarities = fftFilter->GetSimilarities();
+
+  if ( bruteForceDisplacements->GetNumberOfPoints() != featurePoints->GetNumberOfPoints() ||
+       fftDisplacements->GetNumberOfPoints() != featurePoints->GetNumberOfPoints() )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Wrong number of displacements." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  for ( PointSetType::PointIdentifier i = 0; i < featurePoints->GetNumberOfPoints(); i++ )
+    {
+    const DisplacementsType::PixelType bruteForceDisplacement = bruteForceDisplacements->GetPointData()->GetElement( i );
+    const DisplacementsType::PixelType fftDisplacement = fftDisplacements->GetPointData()->GetElement( i );
+    const SimilaritiesType::PixelType bruteForceSimilarity = bruteForceSimilarities->GetPointData()->GetElement( i );
+    const SimilaritiesType::PixelType fftSimilarity = fftSimilarities->GetPointData()->GetElement( i );
+
+    if ( ( bruteForceDisplacement - expectedDisplacement ).GetNorm() > tolerance )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Wrong brute-force displacement at point " << i << ": "
+        << bruteForceDisplacement << " != " << expectedDisplacement << std::endl;
+      return EXIT_FAILURE;
+      }
+    if ( ( fftDisplacement - expectedDisplacement ).GetNorm() > tolerance )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Wrong FFT displacement at point " << i << ": "
+        << fftDisplacement << " != " << expectedDisplacement << std::endl;
+      return EXIT_FAILURE;
+      }
+    if ( std::abs( bruteForceSimilarity - fftSimilarity ) > tolerance )
+      {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Similarity mismatch at point " << i << ": "
+        << bruteForceSimilarity << " != " << fftSimilarity << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
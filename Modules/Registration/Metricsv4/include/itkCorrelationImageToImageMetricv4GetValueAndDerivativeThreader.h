@@ -124,12 +124,14 @@ private:
    * say f_i is the i-th pixel of fixed image, m_i is the i-th pixel of moving
    * image: see the comments below
    */
+  typedef CompensatedSummation< InternalComputationValueType > CompensatedSumType;
+
   struct CorrelationMetricValueDerivativePerThreadStruct{    // keep cumlative summation over points for:
-      InternalComputationValueType fm;  // (f_i - \bar f) * (m_i - \bar m)
-      InternalComputationValueType m2;  // (m_i - \bar m)^2
-      InternalComputationValueType f2;  // (f_i - \bar m)^2
-      InternalComputationValueType m;   // m_i
-      InternalComputationValueType f;   // f_i
+      CompensatedSumType fm;  // (f_i - \bar f) * (m_i - \bar m)
+      CompensatedSumType m2;  // (m_i - \bar m)^2
+      CompensatedSumType f2;  // (f_i - \bar m)^2
+      CompensatedSumType m;   // m_i
+      CompensatedSumType f;   // f_i
       DerivativeType fdm; // (f_i - \bar f) * dm_i/dp
       DerivativeType mdm; // (m_i - \bar m) * dm_i/dp
   };
@@ -70,11 +70,11 @@ CorrelationImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner
   // Set initial values.
   for (ThreadIdType i = 0; i < numThreadsUsed; ++i)
     {
-    m_CorrelationMetricValueDerivativePerThreadVariables[i].fm = NumericTraits<InternalComputationValueType>::ZeroValue();
-    m_CorrelationMetricValueDerivativePerThreadVariables[i].f2 = NumericTraits<InternalComputationValueType>::ZeroValue();
-    m_CorrelationMetricValueDerivativePerThreadVariables[i].m2 = NumericTraits<InternalComputationValueType>::ZeroValue();
-    m_CorrelationMetricValueDerivativePerThreadVariables[i].f = NumericTraits<InternalComputationValueType>::ZeroValue();
-    m_CorrelationMetricValueDerivativePerThreadVariables[i].m = NumericTraits<InternalComputationValueType>::ZeroValue();
+    m_CorrelationMetricValueDerivativePerThreadVariables[i].fm.ResetToZero();
+    m_CorrelationMetricValueDerivativePerThreadVariables[i].f2.ResetToZero();
+    m_CorrelationMetricValueDerivativePerThreadVariables[i].m2.ResetToZero();
+    m_CorrelationMetricValueDerivativePerThreadVariables[i].f.ResetToZero();
+    m_CorrelationMetricValueDerivativePerThreadVariables[i].m.ResetToZero();
 
     this->m_CorrelationMetricValueDerivativePerThreadVariables[i].mdm.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
     this->m_CorrelationMetricValueDerivativePerThreadVariables[i].fdm.Fill(NumericTraits<DerivativeValueType>::ZeroValue());
@@ -111,15 +111,19 @@ CorrelationImageToImageMetricv4GetValueAndDerivativeThreader<TDomainPartitioner,
 
   /* Accumulate the metric value from threads and store */
   this->m_CorrelationAssociate->m_Value = NumericTraits<InternalComputationValueType>::ZeroValue();
-  InternalComputationValueType fm = NumericTraits<InternalComputationValueType>::ZeroValue();
-  InternalComputationValueType f2 = NumericTraits<InternalComputationValueType>::ZeroValue();
-  InternalComputationValueType m2 = NumericTraits<InternalComputationValueType>::ZeroValue();
+  typedef CompensatedSummation< typename CompensatedSumType::AccumulateType > ThreadsSumType;
+  ThreadsSumType fmSum;
+  ThreadsSumType f2Sum;
+  ThreadsSumType m2Sum;
   for (ThreadIdType threadId = 0; threadId < numThreadsUsed; ++threadId)
     {
-    fm += this->m_CorrelationMetricValueDerivativePerThreadVariables[threadId].fm;
-    m2 += this->m_CorrelationMetricValueDerivativePerThreadVariables[threadId].m2;
-    f2 += this->m_CorrelationMetricValueDerivativePerThreadVariables[threadId].f2;
+    fmSum += this->m_CorrelationMetricValueDerivativePerThreadVariables[threadId].fm.GetSum();
+    m2Sum += this->m_CorrelationMetricValueDerivativePerThreadVariables[threadId].m2.GetSum();
+    f2Sum += this->m_CorrelationMetricValueDerivativePerThreadVariables[threadId].f2.GetSum();
     }
+  const InternalComputationValueType fm = static_cast<InternalComputationValueType>( fmSum.GetSum() );
+  const InternalComputationValueType f2 = static_cast<InternalComputationValueType>( f2Sum.GetSum() );
+  const InternalComputationValueType m2 = static_cast<InternalComputationValueType>( m2Sum.GetSum() );
 
   InternalComputationValueType m2f2 = m2 * f2;
   if ( m2f2 <= NumericTraits<InternalComputationValueType>::epsilon() )
@@ -119,10 +119,12 @@ protected:
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(CorrelationImageToImageMetricv4HelperThreader);
 
+  typedef CompensatedSummation< InternalComputationValueType > CompensatedSumType;
+
   struct CorrelationMetricPerThreadStruct
     {
-    InternalComputationValueType FixSum;
-    InternalComputationValueType MovSum;
+    CompensatedSumType FixSum;
+    CompensatedSumType MovSum;
     };
   itkPadStruct( ITK_CACHE_LINE_ALIGNMENT, CorrelationMetricPerThreadStruct,
                                           PaddedCorrelationMetricPerThreadStruct);
@@ -57,8 +57,8 @@ CorrelationImageToImageMetricv4HelperThreader< TDomainPartitioner, TImageToImage
     // Set initial values.
   for (ThreadIdType i = 0; i < numThreadsUsed; ++i)
     {
-    this->m_CorrelationMetricPerThreadVariables[i].FixSum = NumericTraits<InternalComputationValueType>::ZeroValue();
-    this->m_CorrelationMetricPerThreadVariables[i].MovSum = NumericTraits<InternalComputationValueType>::ZeroValue();
+    this->m_CorrelationMetricPerThreadVariables[i].FixSum.ResetToZero();
+    this->m_CorrelationMetricPerThreadVariables[i].MovSum.ResetToZero();
     }
 
 }
@@ -86,17 +86,17 @@ CorrelationImageToImageMetricv4HelperThreader<TDomainPartitioner,
     return;
     }
 
-  InternalComputationValueType sumF = NumericTraits<InternalComputationValueType>::ZeroValue();
-  InternalComputationValueType sumM = NumericTraits<InternalComputationValueType>::ZeroValue();
+  CompensatedSummation< typename CompensatedSumType::AccumulateType > sumF;
+  CompensatedSummation< typename CompensatedSumType::AccumulateType > sumM;
 
   for (ThreadIdType threadId = 0; threadId < numThreadsUsed; ++threadId)
     {
-    sumF += this->m_CorrelationMetricPerThreadVariables[threadId].FixSum;
-    sumM += this->m_CorrelationMetricPerThreadVariables[threadId].MovSum;
+    sumF += this->m_CorrelationMetricPerThreadVariables[threadId].FixSum.GetSum();
+    sumM += this->m_CorrelationMetricPerThreadVariables[threadId].MovSum.GetSum();
     }
 
-  this->m_CorrelationAssociate->m_AverageFix = sumF / this->m_CorrelationAssociate->m_NumberOfValidPoints;
-  this->m_CorrelationAssociate->m_AverageMov = sumM / this->m_CorrelationAssociate->m_NumberOfValidPoints;
+  this->m_CorrelationAssociate->m_AverageFix = sumF.GetSum() / this->m_CorrelationAssociate->m_NumberOfValidPoints;
+  this->m_CorrelationAssociate->m_AverageMov = sumM.GetSum() / this->m_CorrelationAssociate->m_NumberOfValidPoints;
 }
 
 template<typename TDomainPartitioner, typename TImageToImageMetric, typename TCorrelationMetric>
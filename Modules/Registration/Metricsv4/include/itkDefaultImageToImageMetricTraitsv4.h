@@ -89,9 +89,10 @@ public:
   /** Type of the filter used to calculate the gradients. */
   typedef typename NumericTraits< FixedImagePixelType >::RealType
                                                     FixedRealType;
-  typedef CovariantVector< FixedRealType,
-                           itkGetStaticConstMacro(FixedImageDimension) >
-                                                    FixedGradientPixelType;
+  /** The gradient images are stored with the precision of the coordinate
+   * representation, so that a metric computing in single precision also
+   * keeps single precision gradient images. */
+  typedef FixedImageGradientType                    FixedGradientPixelType;
   typedef Image< FixedGradientPixelType,
                  itkGetStaticConstMacro(FixedImageDimension) >
                                                 FixedImageGradientImageType;
@@ -101,9 +102,7 @@ public:
 
   typedef typename NumericTraits< MovingImagePixelType >::RealType
                                                  MovingRealType;
-  typedef CovariantVector< MovingRealType,
-                           itkGetStaticConstMacro(MovingImageDimension) >
-                                                 MovingGradientPixelType;
+  typedef MovingImageGradientType                MovingGradientPixelType;
   typedef Image< MovingGradientPixelType,
                  itkGetStaticConstMacro(MovingImageDimension) >
                                                     MovingImageGradientImageType;
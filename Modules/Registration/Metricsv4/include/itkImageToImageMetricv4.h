@@ -28,6 +28,7 @@
 #include "itkThreadedImageRegionPartitioner.h"
 #include "itkImageToImageFilter.h"
 #include "itkImageToImageMetricv4GetValueAndDerivativeThreader.h"
+#include "itkImageToImageMetricv4GradientImageCache.h"
 #include "itkPointSet.h"
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkDefaultImageToImageMetricTraitsv4.h"
@@ -332,6 +333,12 @@ public:
   typedef typename MetricTraits::DefaultFixedImageGradientFilter  DefaultFixedImageGradientFilter;
   typedef typename MetricTraits::DefaultMovingImageGradientFilter DefaultMovingImageGradientFilter;
 
+  /** Caches of the gradient images computed by the default gradient filters. */
+  typedef ImageToImageMetricv4GradientImageCache< FixedImageType, FixedImageGradientImageType >
+                                                                  FixedImageGradientImageCacheType;
+  typedef ImageToImageMetricv4GradientImageCache< MovingImageType, MovingImageGradientImageType >
+                                                                  MovingImageGradientImageCacheType;
+
   /** Image gradient calculator types. The TOutput template parameter
    * is chosen to match that of CentralDiffererenceImageFunction. */
   typedef typename MetricTraits::FixedImageGradientCalculatorType
@@ -436,6 +443,18 @@ public:
   itkSetObjectMacro( MovingImageGradientFilter, MovingImageGradientFilterType );
   itkGetModifiableObjectMacro(MovingImageGradientFilter, MovingImageGradientFilterType );
 
+  /** Set/Get the caches of gradient images. When a cache is set and the
+   * default gradient filter is in use, the gradient image is taken from
+   * the cache, and only computed if the cache holds no gradient of the
+   * same, unmodified image with the same filter settings. A cache may be
+   * shared between metrics, e.g. the metrics of an
+   * ObjectToObjectMultiMetricv4 that use the same images.
+   * No cache is used by default. */
+  itkSetObjectMacro( FixedImageGradientImageCache, FixedImageGradientImageCacheType );
+  itkGetModifiableObjectMacro(FixedImageGradientImageCache, FixedImageGradientImageCacheType );
+  itkSetObjectMacro( MovingImageGradientImageCache, MovingImageGradientImageCacheType );
+  itkGetModifiableObjectMacro(MovingImageGradientImageCache, MovingImageGradientImageCacheType );
+
   /** Set/Get gradient calculators */
   itkSetObjectMacro( FixedImageGradientCalculator, FixedImageGradientCalculatorType);
   itkGetModifiableObjectMacro(FixedImageGradientCalculator, FixedImageGradientCalculatorType);
@@ -658,6 +677,12 @@ protected:
   typename DefaultMovingImageGradientFilter::Pointer
                                              m_DefaultMovingImageGradientFilter;
 
+  /** Optional caches of the default gradient filter outputs. */
+  typename FixedImageGradientImageCacheType::Pointer
+                                             m_FixedImageGradientImageCache;
+  typename MovingImageGradientImageCacheType::Pointer
+                                             m_MovingImageGradientImageCache;
+
   /** Pointer to default gradient calculators. Used for easier
    * initialization of the default filter. */
   typename DefaultFixedImageGradientCalculator::Pointer
@@ -416,8 +416,17 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
 ::ComputeFixedImageGradientFilterImage()
 {
   this->m_FixedImageGradientFilter->SetInput( this->m_FixedImage );
-  this->m_FixedImageGradientFilter->Update();
-  this->m_FixedImageGradientImage = this->m_FixedImageGradientFilter->GetOutput();
+  if( this->m_FixedImageGradientImageCache.IsNotNull() &&
+      this->m_FixedImageGradientFilter.GetPointer() == this->m_DefaultFixedImageGradientFilter.GetPointer() )
+    {
+    this->m_FixedImageGradientImage =
+      this->m_FixedImageGradientImageCache->GetGradientImage( this->m_DefaultFixedImageGradientFilter );
+    }
+  else
+    {
+    this->m_FixedImageGradientFilter->Update();
+    this->m_FixedImageGradientImage = this->m_FixedImageGradientFilter->GetOutput();
+    }
   this->m_FixedImageGradientInterpolator->SetInputImage( this->m_FixedImageGradientImage );
 }
 
@@ -427,8 +436,17 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
 ::ComputeMovingImageGradientFilterImage() const
 {
   this->m_MovingImageGradientFilter->SetInput( this->m_MovingImage );
-  this->m_MovingImageGradientFilter->Update();
-  this->m_MovingImageGradientImage = this->m_MovingImageGradientFilter->GetOutput();
+  if( this->m_MovingImageGradientImageCache.IsNotNull() &&
+      this->m_MovingImageGradientFilter.GetPointer() == this->m_DefaultMovingImageGradientFilter.GetPointer() )
+    {
+    this->m_MovingImageGradientImage =
+      this->m_MovingImageGradientImageCache->GetGradientImage( this->m_DefaultMovingImageGradientFilter );
+    }
+  else
+    {
+    this->m_MovingImageGradientFilter->Update();
+    this->m_MovingImageGradientImage = this->m_MovingImageGradientFilter->GetOutput();
+    }
   this->m_MovingImageGradientInterpolator->SetInputImage( this->m_MovingImageGradientImage );
 }
 
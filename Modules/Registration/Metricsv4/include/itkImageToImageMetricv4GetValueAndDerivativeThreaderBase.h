@@ -84,6 +84,7 @@ public:
   typedef typename ImageToImageMetricv4Type::InternalComputationValueType InternalComputationValueType;
   typedef typename ImageToImageMetricv4Type::NumberOfParametersType       NumberOfParametersType;
 
+  typedef CompensatedSummation<InternalComputationValueType>          CompensatedMeasureType;
   typedef CompensatedSummation<DerivativeValueType>                   CompensatedDerivativeValueType;
   typedef std::vector<CompensatedDerivativeValueType>                 CompensatedDerivativeType;
 
@@ -164,8 +165,10 @@ protected:
 
   struct GetValueAndDerivativePerThreadStruct
     {
-    /** Intermediary threaded metric value storage. */
-    InternalComputationValueType Measure;
+    /** Intermediary threaded metric value storage. The sum is compensated
+     * so that the metric value stays accurate when the internal computation
+     * type is single precision. */
+    CompensatedMeasureType       Measure;
     /** Intermediary threaded metric value storage. */
     DerivativeType               Derivatives;
     /** Intermediary threaded metric value storage. This is used only with global transforms. */
@@ -98,7 +98,7 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImag
   for (ThreadIdType thread = 0; thread < numThreadsUsed; ++thread)
     {
     this->m_GetValueAndDerivativePerThreadVariables[thread].NumberOfValidPoints = NumericTraits< SizeValueType >::ZeroValue();
-    this->m_GetValueAndDerivativePerThreadVariables[thread].Measure = NumericTraits< InternalComputationValueType >::ZeroValue();
+    this->m_GetValueAndDerivativePerThreadVariables[thread].Measure.ResetToZero();
     if( this->m_Associate->GetComputeDerivative() )
       {
       if ( this->m_Associate->m_MovingTransform->GetTransformCategory() != MovingTransformType::DisplacementField )
@@ -137,8 +137,9 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImag
       {
       for (NumberOfParametersType p = 0; p < this->m_Associate->GetNumberOfParameters(); p++ )
         {
-        /* Use a compensated sum to be ready for when there is a very large number of threads */
-        CompensatedDerivativeValueType sum;
+        /* Use a compensated sum to be ready for when there is a very large number of threads.
+         * The per-thread sums are added with their accumulation precision. */
+        CompensatedSummation< typename CompensatedDerivativeValueType::AccumulateType > sum;
         sum.ResetToZero();
         for (ThreadIdType i=0; i<numThreadsUsed; i++)
           {
@@ -154,13 +155,13 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImag
    * and a warning will be output. */
   if( this->m_Associate->VerifyNumberOfValidPoints( this->m_Associate->m_Value, *(this->m_Associate->m_DerivativeResult) ) )
     {
-    this->m_Associate->m_Value = NumericTraits<MeasureType>::ZeroValue();
     /* Accumulate the metric value from threads and store the average. */
+    CompensatedSummation< typename CompensatedMeasureType::AccumulateType > measure;
     for(ThreadIdType threadId = 0; threadId < numThreadsUsed; ++threadId )
       {
-      this->m_Associate->m_Value += this->m_GetValueAndDerivativePerThreadVariables[threadId].Measure;
+      measure += this->m_GetValueAndDerivativePerThreadVariables[threadId].Measure.GetSum();
       }
-    this->m_Associate->m_Value /= this->m_Associate->m_NumberOfValidPoints;
+    this->m_Associate->m_Value = static_cast< MeasureType >( measure.GetSum() / this->m_Associate->m_NumberOfValidPoints );
 
     /* For global transforms, calculate the average values */
     if( this->m_Associate->GetComputeDerivative() )
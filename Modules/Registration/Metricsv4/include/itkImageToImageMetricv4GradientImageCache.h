@@ -0,0 +1,125 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageToImageMetricv4GradientImageCache_h
+#define itkImageToImageMetricv4GradientImageCache_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkGradientRecursiveGaussianImageFilter.h"
+#include <deque>
+
+namespace itk
+{
+
+/** \class ImageToImageMetricv4GradientImageCache
+ * \brief Holds the gradient images computed for the default image
+ * gradient filter of ImageToImageMetricv4.
+ *
+ * An entry is identified by the input image, the modification time of
+ * that image, and the sigma, normalization and image direction settings
+ * of the GradientRecursiveGaussianImageFilter.  GetGradientImage() only
+ * runs the filter when no entry matches, so metrics that share a cache
+ * compute the gradient of a common image only once, e.g. the metrics of
+ * an ObjectToObjectMultiMetricv4 that are given the same fixed image, or
+ * the same metric re-initialized with an unchanged image at the next
+ * level of a registration.
+ *
+ * When more than MaximumNumberOfEntries gradient images are held, the
+ * least recently used entry is discarded.
+ *
+ * \ingroup ITKMetricsv4
+ */
+template< typename TInputImage, typename TGradientImage >
+class ITK_TEMPLATE_EXPORT ImageToImageMetricv4GradientImageCache : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageToImageMetricv4GradientImageCache Self;
+  typedef Object                                 Superclass;
+  typedef SmartPointer< Self >                   Pointer;
+  typedef SmartPointer< const Self >             ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageToImageMetricv4GradientImageCache, Object);
+
+  typedef TInputImage                                   InputImageType;
+  typedef typename InputImageType::ConstPointer         InputImageConstPointer;
+  typedef TGradientImage                                GradientImageType;
+  typedef typename GradientImageType::Pointer           GradientImagePointer;
+
+  typedef GradientRecursiveGaussianImageFilter< InputImageType, GradientImageType >
+                                                        GradientFilterType;
+  typedef typename GradientFilterType::SigmaArrayType   SigmaArrayType;
+
+  /** Return the gradient image that \c filter computes for its current
+   * input and settings.  The filter is only updated if the cache holds
+   * no such image.  The returned image is disconnected from the filter. */
+  GradientImageType * GetGradientImage( GradientFilterType * filter );
+
+  /** Discard all the cached gradient images. */
+  void Clear();
+
+  /** Get the number of gradient images currently held. */
+  SizeValueType GetNumberOfEntries() const
+  {
+    return static_cast< SizeValueType >( this->m_Entries.size() );
+  }
+
+  /** Set/Get the maximum number of gradient images held.  Defaults to 4. */
+  itkSetClampMacro(MaximumNumberOfEntries, SizeValueType, 1, NumericTraits< SizeValueType >::max());
+  itkGetConstMacro(MaximumNumberOfEntries, SizeValueType);
+
+  /** Get the number of times a gradient image had to be computed. */
+  itkGetConstMacro(NumberOfGradientComputations, SizeValueType);
+
+protected:
+  ImageToImageMetricv4GradientImageCache();
+  virtual ~ImageToImageMetricv4GradientImageCache() ITK_OVERRIDE {}
+
+  virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+private:
+  ITK_DISALLOW_COPY_AND_ASSIGN(ImageToImageMetricv4GradientImageCache);
+
+  struct EntryType
+    {
+    /** The image is referenced so that its address cannot be reused by
+     * another image while the entry exists. */
+    InputImageConstPointer Image;
+    ModifiedTimeType       ImageMTime;
+    SigmaArrayType         Sigma;
+    bool                   NormalizeAcrossScale;
+    bool                   UseImageDirection;
+    GradientImagePointer   GradientImage;
+    };
+
+  std::deque< EntryType > m_Entries;
+  SizeValueType           m_MaximumNumberOfEntries;
+  SizeValueType           m_NumberOfGradientComputations;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkImageToImageMetricv4GradientImageCache.hxx"
+#endif
+
+#endif
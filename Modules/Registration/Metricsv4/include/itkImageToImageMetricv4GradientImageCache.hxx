@@ -0,0 +1,108 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageToImageMetricv4GradientImageCache_hxx
+#define itkImageToImageMetricv4GradientImageCache_hxx
+
+#include "itkImageToImageMetricv4GradientImageCache.h"
+
+namespace itk
+{
+
+template< typename TInputImage, typename TGradientImage >
+ImageToImageMetricv4GradientImageCache< TInputImage, TGradientImage >
+::ImageToImageMetricv4GradientImageCache() :
+  m_MaximumNumberOfEntries( 4 ),
+  m_NumberOfGradientComputations( 0 )
+{
+}
+
+template< typename TInputImage, typename TGradientImage >
+typename ImageToImageMetricv4GradientImageCache< TInputImage, TGradientImage >::GradientImageType *
+ImageToImageMetricv4GradientImageCache< TInputImage, TGradientImage >
+::GetGradientImage( GradientFilterType * filter )
+{
+  if( filter == ITK_NULLPTR || filter->GetInput() == ITK_NULLPTR )
+    {
+    itkExceptionMacro( "The gradient filter and its input must be set." );
+    }
+
+  const InputImageType * image = filter->GetInput();
+  const ModifiedTimeType imageMTime = image->GetMTime();
+  const SigmaArrayType sigma = filter->GetSigmaArray();
+
+  for( typename std::deque< EntryType >::iterator it = this->m_Entries.begin(); it != this->m_Entries.end(); ++it )
+    {
+    if( it->Image.GetPointer() == image &&
+        it->ImageMTime == imageMTime &&
+        it->Sigma == sigma &&
+        it->NormalizeAcrossScale == filter->GetNormalizeAcrossScale() &&
+        it->UseImageDirection == filter->GetUseImageDirection() )
+      {
+      // Move the entry to the back so that it is discarded last.
+      const EntryType entry = *it;
+      this->m_Entries.erase( it );
+      this->m_Entries.push_back( entry );
+      return entry.GradientImage;
+      }
+    }
+
+  filter->Update();
+  this->m_NumberOfGradientComputations++;
+
+  EntryType entry;
+  entry.Image = image;
+  entry.ImageMTime = imageMTime;
+  entry.Sigma = sigma;
+  entry.NormalizeAcrossScale = filter->GetNormalizeAcrossScale();
+  entry.UseImageDirection = filter->GetUseImageDirection();
+  entry.GradientImage = filter->GetOutput();
+  // The filter allocates a new output the next time it runs, so the
+  // cached image is not overwritten.
+  entry.GradientImage->DisconnectPipeline();
+
+  this->m_Entries.push_back( entry );
+  while( this->m_Entries.size() > this->m_MaximumNumberOfEntries )
+    {
+    this->m_Entries.pop_front();
+    }
+
+  return entry.GradientImage;
+}
+
+template< typename TInputImage, typename TGradientImage >
+void
+ImageToImageMetricv4GradientImageCache< TInputImage, TGradientImage >
+::Clear()
+{
+  this->m_Entries.clear();
+}
+
+template< typename TInputImage, typename TGradientImage >
+void
+ImageToImageMetricv4GradientImageCache< TInputImage, TGradientImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumNumberOfEntries: " << this->m_MaximumNumberOfEntries << std::endl;
+  os << indent << "NumberOfEntries: " << this->m_Entries.size() << std::endl;
+  os << indent << "NumberOfGradientComputations: " << this->m_NumberOfGradientComputations << std::endl;
+}
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,183 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkCorrelationImageToImageMetricv4.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkTranslationTransform.h"
+#include "itkTestingMacros.h"
+
+/*
+ * Test that metrics sharing gradient image caches compute the gradient
+ * of a common image only once, that the cached gradients match the
+ * gradients computed without a cache, and that a modified image is not
+ * served from the cache.
+ */
+
+namespace
+{
+
+typedef itk::Image< double, 2 > ImageType;
+
+template< typename TGradientImage >
+bool itkImageToImageMetricv4GradientImageCacheTestCompare( const TGradientImage * a, const TGradientImage * b )
+{
+  itk::ImageRegionConstIterator< TGradientImage > itA( a, a->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< TGradientImage > itB( b, b->GetLargestPossibleRegion() );
+  for( ; !itA.IsAtEnd(); ++itA, ++itB )
+    {
+    if( ( itA.Get() - itB.Get() ).GetNorm() > 1e-12 )
+      {
+      std::cerr << "Gradient mismatch: " << itA.Get() << " != " << itB.Get() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+}
+
+int itkImageToImageMetricv4GradientImageCacheTest( int, char * [] )
+{
+  typedef itk::MeanSquaresImageToImageMetricv4< ImageType, ImageType > MeanSquaresMetricType;
+  typedef itk::CorrelationImageToImageMetricv4< ImageType, ImageType > CorrelationMetricType;
+  typedef itk::TranslationTransform< double, 2 >                       TransformType;
+
+  typedef MeanSquaresMetricType::FixedImageGradientImageCacheType  FixedCacheType;
+  typedef MeanSquaresMetricType::MovingImageGradientImageCacheType MovingCacheType;
+
+  // Shifted copies of the same pattern: the fixed and moving images, and
+  // two other images to fill the cache.
+  ImageType::SizeType size;
+  size.Fill( 32 );
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.0;
+  spacing[1] = 1.5;
+  const double shifts[4] = { 0.0, 2.0, 3.0, 4.0 };
+  ImageType::Pointer images[4];
+  for( unsigned int i = 0; i < 4; i++ )
+    {
+    images[i] = ImageType::New();
+    images[i]->SetRegions( ImageType::RegionType( size ) );
+    images[i]->SetSpacing( spacing );
+    images[i]->Allocate();
+
+    itk::ImageRegionIteratorWithIndex< ImageType > it( images[i], images[i]->GetLargestPossibleRegion() );
+    for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      const ImageType::IndexType index = it.GetIndex();
+      it.Set( std::sin( 0.3 * ( index[0] + shifts[i] ) ) * std::cos( 0.2 * index[1] ) );
+      }
+    }
+  ImageType::Pointer fixedImage = images[0];
+  ImageType::Pointer movingImage = images[1];
+
+  FixedCacheType::Pointer fixedCache = FixedCacheType::New();
+  MovingCacheType::Pointer movingCache = MovingCacheType::New();
+
+  EXERCISE_BASIC_OBJECT_METHODS( fixedCache, ImageToImageMetricv4GradientImageCache, Object );
+
+  fixedCache->SetMaximumNumberOfEntries( 2 );
+  TEST_SET_GET_VALUE( 2, fixedCache->GetMaximumNumberOfEntries() );
+
+  TransformType::Pointer transform = TransformType::New();
+  transform->SetIdentity();
+
+  MeanSquaresMetricType::Pointer meanSquaresMetric = MeanSquaresMetricType::New();
+  CorrelationMetricType::Pointer correlationMetric = CorrelationMetricType::New();
+  MeanSquaresMetricType::Pointer referenceMetric = MeanSquaresMetricType::New();
+
+  meanSquaresMetric->SetFixedImageGradientImageCache( fixedCache );
+  meanSquaresMetric->SetMovingImageGradientImageCache( movingCache );
+  correlationMetric->SetFixedImageGradientImageCache( fixedCache );
+  correlationMetric->SetMovingImageGradientImageCache( movingCache );
+
+  TEST_SET_GET_VALUE( fixedCache.GetPointer(), meanSquaresMetric->GetFixedImageGradientImageCache() );
+  TEST_SET_GET_VALUE( movingCache.GetPointer(), meanSquaresMetric->GetMovingImageGradientImageCache() );
+
+  typedef itk::ImageToImageMetricv4< ImageType, ImageType > ImageMetricType;
+  ImageMetricType * metrics[3] = { meanSquaresMetric, correlationMetric, referenceMetric };
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    metrics[i]->SetFixedImage( fixedImage );
+    metrics[i]->SetMovingImage( movingImage );
+    metrics[i]->SetMovingTransform( transform );
+    metrics[i]->SetGradientSource( ImageMetricType::GRADIENT_SOURCE_BOTH );
+    metrics[i]->SetUseFixedImageGradientFilter( true );
+    metrics[i]->SetUseMovingImageGradientFilter( true );
+    TRY_EXPECT_NO_EXCEPTION( metrics[i]->Initialize() );
+    }
+
+  // Both metrics use the gradients computed once for the common images.
+  TEST_EXPECT_EQUAL( fixedCache->GetNumberOfGradientComputations(), 1 );
+  TEST_EXPECT_EQUAL( movingCache->GetNumberOfGradientComputations(), 1 );
+  TEST_EXPECT_EQUAL( fixedCache->GetNumberOfEntries(), 1 );
+  TEST_EXPECT_TRUE( meanSquaresMetric->GetFixedImageGradientImage() ==
+                    correlationMetric->GetFixedImageGradientImage() );
+  TEST_EXPECT_TRUE( meanSquaresMetric->GetMovingImageGradientImage() ==
+                    correlationMetric->GetMovingImageGradientImage() );
+
+  // The cached gradients match those of a metric without a cache.
+  if( !itkImageToImageMetricv4GradientImageCacheTestCompare( meanSquaresMetric->GetFixedImageGradientImage(),
+                                                             referenceMetric->GetFixedImageGradientImage() ) ||
+      !itkImageToImageMetricv4GradientImageCacheTestCompare( meanSquaresMetric->GetMovingImageGradientImage(),
+                                                             referenceMetric->GetMovingImageGradientImage() ) )
+    {
+    std::cerr << "Test failed: cached gradients differ from the uncached ones." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Re-initializing with unchanged images does not recompute the gradients.
+  TRY_EXPECT_NO_EXCEPTION( meanSquaresMetric->Initialize() );
+  TRY_EXPECT_NO_EXCEPTION( correlationMetric->Initialize() );
+  TEST_EXPECT_EQUAL( fixedCache->GetNumberOfGradientComputations(), 1 );
+  TEST_EXPECT_EQUAL( movingCache->GetNumberOfGradientComputations(), 1 );
+
+  // A modified image is not served from the cache.
+  movingImage->Modified();
+  TRY_EXPECT_NO_EXCEPTION( meanSquaresMetric->Initialize() );
+  TRY_EXPECT_NO_EXCEPTION( correlationMetric->Initialize() );
+  TEST_EXPECT_EQUAL( fixedCache->GetNumberOfGradientComputations(), 1 );
+  TEST_EXPECT_EQUAL( movingCache->GetNumberOfGradientComputations(), 2 );
+  TEST_EXPECT_EQUAL( movingCache->GetNumberOfEntries(), 2 );
+
+  // Least recently used entries are discarded.
+  for( unsigned int i = 2; i < 4; i++ )
+    {
+    meanSquaresMetric->SetFixedImage( images[i] );
+    TRY_EXPECT_NO_EXCEPTION( meanSquaresMetric->Initialize() );
+    }
+  TEST_EXPECT_EQUAL( fixedCache->GetNumberOfGradientComputations(), 3 );
+  TEST_EXPECT_EQUAL( fixedCache->GetNumberOfEntries(), 2 );
+  meanSquaresMetric->SetFixedImage( fixedImage );
+  TRY_EXPECT_NO_EXCEPTION( meanSquaresMetric->Initialize() );
+  TEST_EXPECT_EQUAL( fixedCache->GetNumberOfGradientComputations(), 4 );
+
+  // A user supplied gradient filter bypasses the cache.
+  typedef MeanSquaresMetricType::DefaultFixedImageGradientFilter GradientFilterType;
+  GradientFilterType::Pointer gradientFilter = GradientFilterType::New();
+  meanSquaresMetric->SetFixedImageGradientFilter( gradientFilter );
+  TRY_EXPECT_NO_EXCEPTION( meanSquaresMetric->Initialize() );
+  TEST_EXPECT_EQUAL( fixedCache->GetNumberOfGradientComputations(), 4 );
+
+  fixedCache->Clear();
+  TEST_EXPECT_EQUAL( fixedCache->GetNumberOfEntries(), 0 );
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -428,6 +428,18 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
     this->m_MovingImageMasks.clear();
     this->m_MovingImageMasks.resize( this->m_NumberOfMetrics );
 
+    // The image metrics of a multi-metric share gradient image caches so that
+    // the gradient of an image used by several metrics is only computed once.
+    typename ImageMetricType::FixedImageGradientImageCacheType::Pointer fixedImageGradientImageCache = ITK_NULLPTR;
+    typename ImageMetricType::MovingImageGradientImageCacheType::Pointer movingImageGradientImageCache = ITK_NULLPTR;
+    if( this->m_Metric->GetMetricCategory() == MetricType::MULTI_METRIC )
+      {
+      fixedImageGradientImageCache = ImageMetricType::FixedImageGradientImageCacheType::New();
+      fixedImageGradientImageCache->SetMaximumNumberOfEntries( this->m_NumberOfMetrics );
+      movingImageGradientImageCache = ImageMetricType::MovingImageGradientImageCacheType::New();
+      movingImageGradientImageCache->SetMaximumNumberOfEntries( this->m_NumberOfMetrics );
+      }
+
     for( SizeValueType n = 0; n < this->m_NumberOfMetrics; n++ )
       {
       this->m_FixedImageMasks[n] = ITK_NULLPTR;
@@ -440,8 +452,17 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
 
         if( this->m_Metric->GetMetricCategory() == MetricType::MULTI_METRIC )
           {
-          this->m_FixedImageMasks[n] = dynamic_cast<ImageMetricType *>( multiMetric->GetMetricQueue()[n].GetPointer() )->GetFixedImageMask();
-          this->m_MovingImageMasks[n] = dynamic_cast<ImageMetricType *>( multiMetric->GetMetricQueue()[n].GetPointer() )->GetMovingImageMask();
+          ImageMetricType * imageMetric = dynamic_cast<ImageMetricType *>( multiMetric->GetMetricQueue()[n].GetPointer() );
+          this->m_FixedImageMasks[n] = imageMetric->GetFixedImageMask();
+          this->m_MovingImageMasks[n] = imageMetric->GetMovingImageMask();
+          if( imageMetric->GetFixedImageGradientImageCache() == ITK_NULLPTR )
+            {
+            imageMetric->SetFixedImageGradientImageCache( fixedImageGradientImageCache );
+            }
+          if( imageMetric->GetMovingImageGradientImageCache() == ITK_NULLPTR )
+            {
+            imageMetric->SetMovingImageGradientImageCache( movingImageGradientImageCache );
+            }
           }
         else if( this->m_Metric->GetMetricCategory() == MetricType::IMAGE_METRIC )
           {
@@ -581,6 +602,17 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   // that we set the point sets here just like we set the images.
   // Although this isn't necessary, we want to leave the option for
   // changing the point sets per level.
+  //
+  // An input is only smoothed once per level, even if several metrics use
+  // it, and the smoothed images of the previous level are kept when the
+  // smoothing sigma does not change.  The metrics then see the same image
+  // objects and do not need to recompute their gradient images.
+
+  const FixedImagesContainerType previousFixedSmoothImages = this->m_FixedSmoothImages;
+  const MovingImagesContainerType previousMovingSmoothImages = this->m_MovingSmoothImages;
+  const bool reusePreviousSmoothImages = ( level > 0 &&
+    previousFixedSmoothImages.size() == this->m_NumberOfMetrics &&
+    Math::ExactlyEquals( this->m_SmoothingSigmasPerLevel[level], this->m_SmoothingSigmasPerLevel[level - 1] ) );
 
   this->m_FixedSmoothImages.clear();
   this->m_FixedSmoothImages.resize( this->m_NumberOfMetrics );
@@ -602,41 +634,66 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
         ( this->m_Metric->GetMetricCategory() == MetricType::MULTI_METRIC &&
           multiMetric->GetMetricQueue()[n]->GetMetricCategory() == MetricType::IMAGE_METRIC ) )
       {
-      typedef DiscreteGaussianImageFilter<FixedImageType, FixedImageType> FixedImageSmoothingFilterType;
-      typename FixedImageSmoothingFilterType::Pointer fixedImageSmoothingFilter = FixedImageSmoothingFilterType::New();
-      if( this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits == true )
+      if( reusePreviousSmoothImages )
         {
-        fixedImageSmoothingFilter->SetUseImageSpacingOn();
+        this->m_FixedSmoothImages[n] = previousFixedSmoothImages[n];
+        this->m_MovingSmoothImages[n] = previousMovingSmoothImages[n];
         }
-      else
+      for( SizeValueType m = 0; m < n; m++ )
         {
-        fixedImageSmoothingFilter->SetUseImageSpacingOff();
+        if( this->m_FixedSmoothImages[n].IsNull() && this->m_FixedSmoothImages[m].IsNotNull() &&
+            this->GetFixedImage( m ) == this->GetFixedImage( n ) )
+          {
+          this->m_FixedSmoothImages[n] = this->m_FixedSmoothImages[m];
+          }
+        if( this->m_MovingSmoothImages[n].IsNull() && this->m_MovingSmoothImages[m].IsNotNull() &&
+            this->GetMovingImage( m ) == this->GetMovingImage( n ) )
+          {
+          this->m_MovingSmoothImages[n] = this->m_MovingSmoothImages[m];
+          }
         }
-      fixedImageSmoothingFilter->SetVariance( itk::Math::sqr( this->m_SmoothingSigmasPerLevel[level] ) );
-      fixedImageSmoothingFilter->SetMaximumError( 0.01 );
-      fixedImageSmoothingFilter->SetInput( this->GetFixedImage( n ) );
-
-      this->m_FixedSmoothImages[n] = fixedImageSmoothingFilter->GetOutput();
-      this->m_FixedSmoothImages[n]->Update();
-      this->m_FixedSmoothImages[n]->DisconnectPipeline();
 
-      typedef DiscreteGaussianImageFilter<MovingImageType, MovingImageType> MovingImageSmoothingFilterType;
-      typename MovingImageSmoothingFilterType::Pointer movingImageSmoothingFilter = MovingImageSmoothingFilterType::New();
-      if( this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits == true )
+      if( this->m_FixedSmoothImages[n].IsNull() )
         {
-        movingImageSmoothingFilter->SetUseImageSpacingOn();
+        typedef DiscreteGaussianImageFilter<FixedImageType, FixedImageType> FixedImageSmoothingFilterType;
+        typename FixedImageSmoothingFilterType::Pointer fixedImageSmoothingFilter = FixedImageSmoothingFilterType::New();
+        if( this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits == true )
+          {
+          fixedImageSmoothingFilter->SetUseImageSpacingOn();
+          }
+        else
+          {
+          fixedImageSmoothingFilter->SetUseImageSpacingOff();
+          }
+        fixedImageSmoothingFilter->SetVariance( itk::Math::sqr( this->m_SmoothingSigmasPerLevel[level] ) );
+        fixedImageSmoothingFilter->SetMaximumError( 0.01 );
+        fixedImageSmoothingFilter->SetInput( this->GetFixedImage( n ) );
+
+        this->m_FixedSmoothImages[n] = fixedImageSmoothingFilter->GetOutput();
+        this->m_FixedSmoothImages[n]->Update();
+        this->m_FixedSmoothImages[n]->DisconnectPipeline();
         }
-      else
+
+      if( this->m_MovingSmoothImages[n].IsNull() )
         {
-        movingImageSmoothingFilter->SetUseImageSpacingOff();
-        }
-      movingImageSmoothingFilter->SetVariance( itk::Math::sqr( this->m_SmoothingSigmasPerLevel[level] ) );
-      movingImageSmoothingFilter->SetMaximumError( 0.01 );
-      movingImageSmoothingFilter->SetInput( this->GetMovingImage( n ) );
+        typedef DiscreteGaussianImageFilter<MovingImageType, MovingImageType> MovingImageSmoothingFilterType;
+        typename MovingImageSmoothingFilterType::Pointer movingImageSmoothingFilter = MovingImageSmoothingFilterType::New();
+        if( this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits == true )
+          {
+          movingImageSmoothingFilter->SetUseImageSpacingOn();
+          }
+        else
+          {
+          movingImageSmoothingFilter->SetUseImageSpacingOff();
+          }
+        movingImageSmoothingFilter->SetVariance( itk::Math::sqr( this->m_SmoothingSigmasPerLevel[level] ) );
+        movingImageSmoothingFilter->SetMaximumError( 0.01 );
+        movingImageSmoothingFilter->SetInput( this->GetMovingImage( n ) );
 
-      this->m_MovingSmoothImages[n] = movingImageSmoothingFilter->GetOutput();
-      this->m_MovingSmoothImages[n]->Update();
-      this->m_MovingSmoothImages[n]->DisconnectPipeline();
+        this->m_MovingSmoothImages[n] = movingImageSmoothingFilter->GetOutput();
+        this->m_MovingSmoothImages[n]->Update();
+        this->m_MovingSmoothImages[n]->DisconnectPipeline();
+        }
 
       // Update the image metric
 
@@ -0,0 +1,194 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegistrationMethodv4.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTranslationTransform.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkCorrelationImageToImageMetricv4.h"
+#include "itkRegularStepGradientDescentOptimizerv4.h"
+#include "itkTestingMacros.h"
+
+#include <typeinfo>
+
+/*
+ * Register a translated synthetic image pair once with a double precision
+ * pipeline and once with a single precision pipeline (transform, metric,
+ * gradient images and optimizer).  Both must recover the translation and
+ * agree with each other.
+ */
+
+namespace
+{
+const unsigned int Dimension = 2;
+
+typedef float                                   PixelType;
+typedef itk::Image< PixelType, Dimension >      ImageType;
+typedef itk::Vector< double, Dimension >        TranslationType;
+
+ImageType::Pointer
+CreateImage( const TranslationType & translation )
+{
+  ImageType::SizeType size;
+  size.Fill( 64 );
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > It( image, image->GetLargestPossibleRegion() );
+  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+    {
+    ImageType::PointType point;
+    image->TransformIndexToPhysicalPoint( It.GetIndex(), point );
+    point -= translation;
+
+    // two anisotropic blobs, so that the optimum is unique
+    const double x1 = ( point[0] - 28.0 ) / 8.0;
+    const double y1 = ( point[1] - 30.0 ) / 5.0;
+    const double x2 = ( point[0] - 38.0 ) / 4.0;
+    const double y2 = ( point[1] - 36.0 ) / 7.0;
+    It.Set( 100.0 * std::exp( -0.5 * ( x1 * x1 + y1 * y1 ) )
+      + 60.0 * std::exp( -0.5 * ( x2 * x2 + y2 * y2 ) ) );
+    }
+  return image;
+}
+
+template< typename TMetric >
+int
+PerformTranslationRegistration( const ImageType * fixedImage, const ImageType * movingImage,
+  TranslationType & result )
+{
+  typedef typename TMetric::InternalComputationValueType             RealType;
+  typedef itk::TranslationTransform< RealType, Dimension >           TransformType;
+  typedef itk::ImageRegistrationMethodv4< ImageType, ImageType, TransformType >
+                                                                     RegistrationType;
+  typedef itk::RegularStepGradientDescentOptimizerv4< RealType >    OptimizerType;
+
+  typename TMetric::Pointer metric = TMetric::New();
+
+  typename OptimizerType::Pointer optimizer = OptimizerType::New();
+  optimizer->SetLearningRate( 4.0 );
+  optimizer->SetMinimumStepLength( 0.0001 );
+  optimizer->SetRelaxationFactor( 0.5 );
+  optimizer->SetNumberOfIterations( 200 );
+  optimizer->SetDoEstimateLearningRateAtEachIteration( false );
+  optimizer->SetDoEstimateLearningRateOnce( false );
+
+  typename RegistrationType::Pointer registration = RegistrationType::New();
+  registration->SetFixedImage( fixedImage );
+  registration->SetMovingImage( movingImage );
+  registration->SetMetric( metric );
+  registration->SetOptimizer( optimizer );
+  registration->SetNumberOfLevels( 1 );
+
+  typename RegistrationType::ShrinkFactorsArrayType shrinkFactors;
+  shrinkFactors.SetSize( 1 );
+  shrinkFactors[0] = 1;
+  registration->SetShrinkFactorsPerLevel( shrinkFactors );
+
+  typename RegistrationType::SmoothingSigmasArrayType smoothingSigmas;
+  smoothingSigmas.SetSize( 1 );
+  smoothingSigmas[0] = 0;
+  registration->SetSmoothingSigmasPerLevel( smoothingSigmas );
+
+  TRY_EXPECT_NO_EXCEPTION( registration->Update() );
+
+  const typename TransformType::ParametersType & parameters =
+    registration->GetOutput()->Get()->GetParameters();
+  for( unsigned int d = 0; d < Dimension; d++ )
+    {
+    result[d] = parameters[d];
+    }
+
+  std::cout << ( sizeof( RealType ) == sizeof( float ) ? "float " : "double " )
+    << metric->GetNameOfClass() << ": "
+    << result << " after " << optimizer->GetCurrentIteration() << " iterations." << std::endl;
+
+  return EXIT_SUCCESS;
+}
+
+template< typename TDoubleMetric, typename TFloatMetric >
+int
+CompareRegistrations( const ImageType * fixedImage, const ImageType * movingImage,
+  const TranslationType & expected )
+{
+  // The single precision metric keeps single precision gradient images.
+  if( typeid( typename TFloatMetric::MovingImageGradientImageType::PixelType::ValueType ) != typeid( float ) )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "The gradient images of the single precision metric are not single precision." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  TranslationType doubleResult;
+  TranslationType floatResult;
+  if( PerformTranslationRegistration< TDoubleMetric >( fixedImage, movingImage, doubleResult ) == EXIT_FAILURE ||
+    PerformTranslationRegistration< TFloatMetric >( fixedImage, movingImage, floatResult ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  if( ( doubleResult - expected ).GetNorm() > 0.05 )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Double precision result " << doubleResult << " != " << expected << std::endl;
+    return EXIT_FAILURE;
+    }
+  if( ( floatResult - doubleResult ).GetNorm() > 0.01 )
+    {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Single precision result " << floatResult << " != " << doubleResult << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+
+}
+
+int itkImageRegistrationMethodv4FloatTest( int, char *[] )
+{
+  TranslationType zero;
+  zero.Fill( 0.0 );
+
+  TranslationType expected;
+  expected[0] = 3.5;
+  expected[1] = -2.25;
+
+  ImageType::Pointer fixedImage = CreateImage( zero );
+  ImageType::Pointer movingImage = CreateImage( expected );
+
+  typedef itk::MeanSquaresImageToImageMetricv4< ImageType, ImageType, ImageType, double > DoubleMeanSquaresMetricType;
+  typedef itk::MeanSquaresImageToImageMetricv4< ImageType, ImageType, ImageType, float >  FloatMeanSquaresMetricType;
+  typedef itk::CorrelationImageToImageMetricv4< ImageType, ImageType, ImageType, double > DoubleCorrelationMetricType;
+  typedef itk::CorrelationImageToImageMetricv4< ImageType, ImageType, ImageType, float >  FloatCorrelationMetricType;
+
+  if( CompareRegistrations< DoubleMeanSquaresMetricType, FloatMeanSquaresMetricType >(
+      fixedImage, movingImage, expected ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+  if( CompareRegistrations< DoubleCorrelationMetricType, FloatCorrelationMetricType >(
+      fixedImage, movingImage, expected ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -29,6 +29,7 @@
 
 #include "itkImageRegionIterator.h"
 #include "itkMacro.h"
+#include "itkMultiThreader.h"
 
 #include "itkImageModelEstimatorBase.h"
 
@@ -112,6 +113,10 @@ namespace itk
  * The Update() function enables the calculation of the various models, creates
  * the membership function objects and populates them.
  *
+ * The nearest neighbor searches of the iterations split the input image
+ * among NumberOfThreads threads, which accumulate their own histograms,
+ * distortions and centroids of the codewords.
+ *
  * Note: There is a second implementation of k-means algorithm in ITK under the
  * itk::Statistics namespace. While this algorithm (GLA/LBG based algorithm) is
  * memory efficient, the other algorithm is time efficient.
@@ -208,6 +213,11 @@ public:
   /** Return the codebook/cluster centers. */
   CodebookMatrixOfDoubleType GetKmeansResults(void) { return m_Centroid; }
 
+  /** Set/Get the number of threads of the nearest neighbor searches.
+   * Defaults to the global default number of threads. */
+  itkSetClampMacro(NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfThreads, ThreadIdType);
+
 protected:
   ImageKmeansModelEstimator();
   ~ImageKmeansModelEstimator();
@@ -249,6 +259,29 @@ private:
 
   void NearestNeighborSearchBasic(double *distortion);
 
+  typedef typename TInputImage::RegionType InputImageRegionType;
+
+  struct NearestNeighborSearchStruct
+  {
+    const Self                                 *Estimator;
+    std::vector< InputImageRegionType >         Regions;
+    std::vector< CodebookMatrixOfIntegerType >  CodewordHistograms;
+    std::vector< CodebookMatrixOfDoubleType >   CodewordDistortions;
+    std::vector< CodebookMatrixOfDoubleType >   Centroids;
+    std::vector< double >                       Distortions;
+  };
+
+  static ITK_THREAD_RETURN_TYPE NearestNeighborSearchThreaderCallback(void *arg);
+
+  /** Encodes the vectors of a region of the input image, adding to the
+   * histogram, the distortions and the sums of the vectors of the
+   * codewords, and to the total distortion. */
+  void NearestNeighborSearch(const InputImageRegionType & region,
+                             CodebookMatrixOfIntegerType & codewordHistogram,
+                             CodebookMatrixOfDoubleType & codewordDistortion,
+                             CodebookMatrixOfDoubleType & centroid,
+                             double & distortion) const;
+
   void SplitCodewords(int currentSize,
                       int numDesired,
                       int scale);
@@ -278,6 +311,8 @@ private:
 
   CodebookMatrixOfIntegerType m_CodewordHistogram;
   CodebookMatrixOfDoubleType  m_CodewordDistortion;
+
+  ThreadIdType m_NumberOfThreads;
 }; // class ImageKmeansModelEstimator
 
 } // namespace itk
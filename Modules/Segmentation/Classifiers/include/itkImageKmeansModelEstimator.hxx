@@ -19,6 +19,7 @@
 #define itkImageKmeansModelEstimator_hxx
 
 #include "itkImageKmeansModelEstimator.h"
+#include "itkImageRegionSplitterSlowDimension.h"
 
 namespace itk
 {
@@ -38,6 +39,7 @@ ImageKmeansModelEstimator< TInputImage, TMembershipFunction >
   m_VectorDimension   = 1;
   m_NumberOfCodewords = 1;
   m_CurrentNumberOfCodewords = 1;
+  m_NumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
 }
 
 template< typename TInputImage,
@@ -68,6 +70,7 @@ ImageKmeansModelEstimator< TInputImage, TMembershipFunction >
   os << indent << "Maximum number of attempts to split a cluster: " << m_MaxSplitAttempts << std::endl;
   os << indent << "Codebook : " << m_Codebook << std::endl;
   os << indent << "Threshold value :" << m_Threshold << std::endl;
+  os << indent << "Number of threads: " << m_NumberOfThreads << std::endl;
 } // end PrintSelf
 
 template< typename TInputImage,
@@ -450,13 +453,7 @@ ImageKmeansModelEstimator< TInputImage, TMembershipFunction >
 {
   //itkDebugMacro(<<"Start nearest_neighbor_search_basic()");
 
-  double  bestdistortion, tempdistortion, diff;
-  int     bestcodeword;
-  double *tempVec = (double *)new double[m_VectorDimension];
-
-// unused: double *centroidVecTemp = ( double * ) new double[m_VectorDimension];
-
-// initialize codeword histogram and distortion
+  // initialize codeword histogram and distortion
   for ( unsigned int i = 0; i < m_CurrentNumberOfCodewords; i++ )
     {
     m_CodewordHistogram[i][0] = 0;
@@ -470,11 +467,53 @@ ImageKmeansModelEstimator< TInputImage, TMembershipFunction >
   *distortion = 0.0;
 
   //-----------------------------------------------------------------
-  // Declare the iterators for the image and the codebook
+  // Split the input image among the threads
   //-----------------------------------------------------------------
-  InputImageConstPointer  inputImage = this->GetInputImage();
-  InputImageConstIterator inputImageIt( inputImage, inputImage->GetBufferedRegion() );
-  inputImageIt.GoToBegin();
+  InputImageConstPointer     inputImage = this->GetInputImage();
+  const InputImageRegionType region = inputImage->GetBufferedRegion();
+
+  ImageRegionSplitterSlowDimension::Pointer splitter = ImageRegionSplitterSlowDimension::New();
+  const unsigned int numberOfSplits = splitter->GetNumberOfSplits(region, m_NumberOfThreads);
+
+  NearestNeighborSearchStruct str;
+  str.Estimator = this;
+  str.Regions.resize(numberOfSplits, region);
+  for ( unsigned int i = 0; i < numberOfSplits; i++ )
+    {
+    splitter->GetSplit(i, numberOfSplits, str.Regions[i]);
+    }
+  str.CodewordHistograms.resize(numberOfSplits, m_CodewordHistogram);
+  str.CodewordDistortions.resize(numberOfSplits, m_CodewordDistortion);
+  str.Centroids.resize(numberOfSplits, m_Centroid);
+  str.Distortions.resize(numberOfSplits, 0.0);
+
+  if ( numberOfSplits > 1 )
+    {
+    MultiThreader::Pointer multiThreader = MultiThreader::New();
+    multiThreader->SetNumberOfThreads(numberOfSplits);
+    multiThreader->SetSingleMethod(Self::NearestNeighborSearchThreaderCallback, &str);
+    multiThreader->SingleMethodExecute();
+    }
+  else
+    {
+    this->NearestNeighborSearch(region, str.CodewordHistograms[0], str.CodewordDistortions[0],
+                                str.Centroids[0], str.Distortions[0]);
+    }
+
+  // Add the contributions of the threads in order
+  for ( unsigned int t = 0; t < numberOfSplits; t++ )
+    {
+    for ( unsigned int i = 0; i < m_CurrentNumberOfCodewords; i++ )
+      {
+      m_CodewordHistogram[i][0] += str.CodewordHistograms[t][i][0];
+      m_CodewordDistortion[i][0] += str.CodewordDistortions[t][i][0];
+      for ( unsigned int j = 0; j < m_VectorDimension; j++ )
+        {
+        m_Centroid[i][j] += str.Centroids[t][i][j];
+        }
+      }
+    *distortion += str.Distortions[t];
+    }
 
   //-----------------------------------------------------------------
   // Calculate the number of vectors in the input data set
@@ -488,23 +527,85 @@ ImageKmeansModelEstimator< TInputImage, TMembershipFunction >
     totalNumVecsInInput *= (SizeValueType)size[i];
     }
 
-  //-----------------------------------------------------------------
-  //Loop through the input image vectors
-  //-----------------------------------------------------------------
+  // compute table frequency and distortion
+  for ( unsigned int i = 0; i < m_CurrentNumberOfCodewords; i++ )
+    {
+    if ( m_CodewordHistogram[i][0] > 0 )
+      {
+      m_CodewordDistortion[i][0] /= (double)m_CodewordHistogram[i][0];
+      }
+    }
+
+  // compute centroid
+  for ( unsigned int i = 0; i < m_CurrentNumberOfCodewords; i++ )
+    {
+    if ( m_CodewordHistogram[i][0] > 0 )
+      {
+      for ( unsigned int j = 0; j < m_VectorDimension; j++ )
+        {
+        m_Centroid[i][j] /= (double)m_CodewordHistogram[i][0];
+        }
+      }
+    }
+
+  // normalize the distortions
+  *distortion /= (double)totalNumVecsInInput;
+
+  // check for bizarre errors
+  if ( *distortion < 0.0 )
+    {
+    itkExceptionMacro(<< "Computational overflow");
+    }
+} // End nearest_neighbor_search_basic
+
+//-----------------------------------------------------------------
+template< typename TInputImage,
+          typename TMembershipFunction >
+ITK_THREAD_RETURN_TYPE
+ImageKmeansModelEstimator< TInputImage, TMembershipFunction >
+::NearestNeighborSearchThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  NearestNeighborSearchStruct *    str = static_cast< NearestNeighborSearchStruct * >( info->UserData );
+
+  const ThreadIdType threadId = info->ThreadID;
+  str->Estimator->NearestNeighborSearch(str->Regions[threadId], str->CodewordHistograms[threadId],
+                                        str->CodewordDistortions[threadId], str->Centroids[threadId],
+                                        str->Distortions[threadId]);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+//-----------------------------------------------------------------
+template< typename TInputImage,
+          typename TMembershipFunction >
+void
+ImageKmeansModelEstimator< TInputImage, TMembershipFunction >
+::NearestNeighborSearch(const InputImageRegionType & region,
+                        CodebookMatrixOfIntegerType & codewordHistogram,
+                        CodebookMatrixOfDoubleType & codewordDistortion,
+                        CodebookMatrixOfDoubleType & centroid,
+                        double & distortion) const
+{
+  double bestdistortion, tempdistortion, diff;
+  int    bestcodeword;
+
+  InputImageConstIterator inputImageIt( this->GetInputImage(), region );
 
   InputPixelVectorType inputImagePixelVector;
 
-  for ( unsigned int n = 0; n < totalNumVecsInInput; n++ )
+  for ( inputImageIt.GoToBegin(); !inputImageIt.IsAtEnd(); ++inputImageIt )
     {
     // keep convention that ties go to lower index
     bestdistortion = m_DoubleMaximum;
     bestcodeword = 0;
 
+    inputImagePixelVector = inputImageIt.Get();
+
     for ( unsigned int i = 0; i < m_CurrentNumberOfCodewords; i++ )
       {
       // find the best codeword
       tempdistortion = 0.0;
-      inputImagePixelVector = inputImageIt.Get();
 
       for ( unsigned int j = 0; j < m_VectorDimension; j++ )
         {
@@ -524,53 +625,16 @@ ImageKmeansModelEstimator< TInputImage, TMembershipFunction >
       if ( bestdistortion == 0.0 ) { break; }
       }
 
-    m_CodewordHistogram[bestcodeword][0] += 1;
-    m_CodewordDistortion[bestcodeword][0] += bestdistortion;
-    *distortion += bestdistortion;
-
-    //inputImagePixelVector = *tempImgIt;
-    inputImagePixelVector = inputImageIt.Get();
+    codewordHistogram[bestcodeword][0] += 1;
+    codewordDistortion[bestcodeword][0] += bestdistortion;
+    distortion += bestdistortion;
 
     for ( unsigned int j = 0; j < m_VectorDimension; j++ )
       {
-      m_Centroid[bestcodeword][j] += inputImagePixelVector[j];
-      }
-
-    ++inputImageIt;
-    } // all training vectors have been encoded
-
-  // compute table frequency and distortion
-  for ( unsigned int i = 0; i < m_CurrentNumberOfCodewords; i++ )
-    {
-    if ( m_CodewordHistogram[i][0] > 0 )
-      {
-      m_CodewordDistortion[i][0] /= (double)m_CodewordHistogram[i][0];
-      }
-    }
-
-  // compute centroid
-  for ( unsigned int i = 0; i < m_CurrentNumberOfCodewords; i++ )
-    {
-    if ( m_CodewordHistogram[i][0] > 0 )
-      {
-      for ( unsigned int j = 0; j < m_VectorDimension; j++ )
-        {
-        m_Centroid[i][j] /= (double)m_CodewordHistogram[i][0];
-        }
+      centroid[bestcodeword][j] += inputImagePixelVector[j];
       }
-    }
-
-  // normalize the distortions
-  *distortion /= (double)totalNumVecsInInput;
-
-  delete[] tempVec;
-
-  // check for bizarre errors
-  if ( *distortion < 0.0 )
-    {
-    itkExceptionMacro(<< "Computational overflow");
-    }
-} // End nearest_neighbor_search_basic
+    } // all training vectors of the region have been encoded
+}
 
 //-----------------------------------------------------------------
 template< typename TInputImage,
@@ -43,6 +43,9 @@ namespace itk
  * unsigned char, under the assumption that the classifier will generate less
  * than 256 classes.
  *
+ * The k-d tree of the intensities is generated with the number of threads
+ * of the filter.
+ *
  * You may want to look also at the RelabelImageFilter that may be used as a
  * postprocessing stage, in particular if you are interested in ordering the
  * labels by their relative size in number of pixels.
@@ -84,6 +84,7 @@ ScalarImageKmeansImageFilter< TInputImage, TOutputImage >
 
   treeGenerator->SetSample(adaptor);
   treeGenerator->SetBucketSize(16);
+  treeGenerator->SetNumberOfThreads( this->GetNumberOfThreads() );
   treeGenerator->Update();
 
   typename EstimatorType::Pointer estimator = EstimatorType::New();
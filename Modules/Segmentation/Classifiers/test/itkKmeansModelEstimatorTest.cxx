@@ -284,5 +284,28 @@ int itkKmeansModelEstimatorTest(int, char* [] )
     return EXIT_FAILURE;
     }
 
+  //The vectors have integer components, so that the results must not
+  //depend on the number of threads splitting the image
+  applyKmeansEstimator->SetNumberOfThreads(1);
+  applyKmeansEstimator->SetCodebook(inCDBK);
+  applyKmeansEstimator->Update();
+  const vnl_matrix<double> singleThreadedResult = applyKmeansEstimator->GetKmeansResults();
+  for( itk::ThreadIdType numberOfThreads = 2; numberOfThreads <= 5; numberOfThreads++ )
+    {
+    applyKmeansEstimator->SetNumberOfThreads(numberOfThreads);
+    if( applyKmeansEstimator->GetNumberOfThreads() != numberOfThreads )
+      {
+      std::cout << "Error in Set/GetNumberOfThreads" << std::endl;
+      return EXIT_FAILURE;
+      }
+    applyKmeansEstimator->SetCodebook(inCDBK);
+    applyKmeansEstimator->Update();
+    if( applyKmeansEstimator->GetKmeansResults() != singleThreadedResult )
+      {
+      std::cout << "Kmeans algorithm failed (" << numberOfThreads << " threads)" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
   return EXIT_SUCCESS;
 }
@@ -20,6 +20,7 @@
 
 #include "itkLevelSetVelocityNeighborhoodExtractor.h"
 #include "itkFastMarchingExtensionImageFilter.h"
+#include "itkFastSweepingExtensionImageFilter.h"
 #include "itkReinitializeLevelSetImageFilter.h"
 
 namespace itk
@@ -39,6 +40,10 @@ namespace itk
  * For the output, the extended velocity is only valid for a distance
  * of OutputNarrowBandwidth / 2 of either side of the level set of interest.
  *
+ * When UseFastSweeping is on, the distances and the velocities are computed
+ * by a FastSweepingExtensionImageFilter on several threads instead of a
+ * FastMarchingExtensionImageFilter.
+ *
  * Implementation of this class is based on Chapter 11 of
  * "Level Set Methods and Fast Marching Methods", J.A. Sethian,
  * Cambridge Press, Second edition, 1999.
@@ -126,16 +131,28 @@ protected:
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(ExtensionVelocitiesImageFilter);
 
+  /** Extend the velocities with a fast marching or a fast sweeping
+   * filter. */
+  template< typename TPropagator >
+  void ExtendFull(TPropagator *propagator);
+
+  template< typename TPropagator >
+  void ExtendNarrowBand(TPropagator *propagator);
+
   /** Internal typedefs. */
   typedef Image< float, itkGetStaticConstMacro(SetDimension) > SpeedImageType;
 
   typedef LevelSetVelocityNeighborhoodExtractor< TLevelSet, TAuxValue, VAuxDimension > LocatorType;
   typedef FastMarchingExtensionImageFilter< TLevelSet, TAuxValue, VAuxDimension,
                                             SpeedImageType > FastMarchingImageFilterType;
+  typedef FastSweepingExtensionImageFilter< TLevelSet, TAuxValue, VAuxDimension,
+                                            SpeedImageType > FastSweepingImageFilterType;
 
   typename LocatorType::Pointer m_Locator;
 
   typename FastMarchingImageFilterType::Pointer m_Marcher;
+
+  typename FastSweepingImageFilterType::Pointer m_Sweeper;
 };
 } // namespace itk
 
@@ -33,6 +33,7 @@ ExtensionVelocitiesImageFilter< TLevelSet, TAuxValue, VAuxDimension >
 {
   m_Locator = LocatorType::New();
   m_Marcher = FastMarchingImageFilterType::New();
+  m_Sweeper = FastSweepingImageFilterType::New();
 
   this->ProcessObject::SetNumberOfRequiredInputs(VAuxDimension + 1);
   this->ProcessObject::SetNumberOfRequiredOutputs(VAuxDimension + 1);
@@ -138,6 +139,8 @@ ExtensionVelocitiesImageFilter< TLevelSet, TAuxValue, VAuxDimension >
   LevelSetPointer outputPtr = this->GetOutput();
   m_Marcher->SetOutputSize(
     outputPtr->GetRequestedRegion().GetSize() );
+  m_Sweeper->SetOutputSize(
+    outputPtr->GetRequestedRegion().GetSize() );
 }
 
 /**
@@ -147,10 +150,29 @@ template< typename TLevelSet, typename TAuxValue, unsigned int VAuxDimension >
 void
 ExtensionVelocitiesImageFilter< TLevelSet, TAuxValue, VAuxDimension >
 ::GenerateDataFull()
+{
+  m_Locator->SetNumberOfThreads( this->GetNumberOfThreads() );
+  m_Sweeper->SetNumberOfThreads( this->GetNumberOfThreads() );
+
+  if ( this->GetUseFastSweeping() )
+    {
+    this->ExtendFull( m_Sweeper.GetPointer() );
+    }
+  else
+    {
+    this->ExtendFull( m_Marcher.GetPointer() );
+    }
+}
+
+template< typename TLevelSet, typename TAuxValue, unsigned int VAuxDimension >
+template< typename TPropagator >
+void
+ExtensionVelocitiesImageFilter< TLevelSet, TAuxValue, VAuxDimension >
+::ExtendFull(TPropagator *propagator)
 {
   LevelSetConstPointer inputPtr = this->GetInput();
   LevelSetPointer      outputPtr = this->GetOutput();
-  LevelSetPointer      tempLevelSet = m_Marcher->GetOutput();
+  LevelSetPointer      tempLevelSet = propagator->GetOutput();
 
   double levelSetValue = this->GetLevelSetValue();
 
@@ -193,9 +215,9 @@ ExtensionVelocitiesImageFilter< TLevelSet, TAuxValue, VAuxDimension >
   this->UpdateProgress(0.33);
 
   // march outward
-  m_Marcher->SetTrialPoints( m_Locator->GetOutsidePoints() );
-  m_Marcher->SetAuxiliaryTrialValues( m_Locator->GetModifiableAuxOutsideValues() );
-  m_Marcher->Update();
+  propagator->SetTrialPoints( m_Locator->GetOutsidePoints() );
+  propagator->SetAuxiliaryTrialValues( m_Locator->GetModifiableAuxOutsideValues() );
+  propagator->Update();
 
   tempIt = IteratorType( tempLevelSet,
                          tempLevelSet->GetBufferedRegion() );
@@ -203,7 +225,7 @@ ExtensionVelocitiesImageFilter< TLevelSet, TAuxValue, VAuxDimension >
   for ( unsigned int k = 0; k < VAuxDimension; k++ )
     {
     AuxImagePointer ptr;
-    ptr = m_Marcher->GetAuxiliaryImage(k);
+    ptr = propagator->GetAuxiliaryImage(k);
     auxTempIt[k] = AuxIteratorType( ptr,
                                     ptr->GetBufferedRegion() );
     }
@@ -245,9 +267,9 @@ ExtensionVelocitiesImageFilter< TLevelSet, TAuxValue, VAuxDimension >
   this->UpdateProgress(0.66);
 
   // march inward
-  m_Marcher->SetTrialPoints( m_Locator->GetInsidePoints() );
-  m_Marcher->SetAuxiliaryTrialValues( m_Locator->GetModifiableAuxInsideValues() );
-  m_Marcher->Update();
+  propagator->SetTrialPoints( m_Locator->GetInsidePoints() );
+  propagator->SetAuxiliaryTrialValues( m_Locator->GetModifiableAuxInsideValues() );
+  propagator->Update();
 
   inputIt.GoToBegin();
   outputIt.GoToBegin();
@@ -290,10 +312,29 @@ template< typename TLevelSet, typename TAuxValue, unsigned int VAuxDimension >
 void
 ExtensionVelocitiesImageFilter< TLevelSet, TAuxValue, VAuxDimension >
 ::GenerateDataNarrowBand()
+{
+  m_Locator->SetNumberOfThreads( this->GetNumberOfThreads() );
+  m_Sweeper->SetNumberOfThreads( this->GetNumberOfThreads() );
+
+  if ( this->GetUseFastSweeping() )
+    {
+    this->ExtendNarrowBand( m_Sweeper.GetPointer() );
+    }
+  else
+    {
+    this->ExtendNarrowBand( m_Marcher.GetPointer() );
+    }
+}
+
+template< typename TLevelSet, typename TAuxValue, unsigned int VAuxDimension >
+template< typename TPropagator >
+void
+ExtensionVelocitiesImageFilter< TLevelSet, TAuxValue, VAuxDimension >
+::ExtendNarrowBand(TPropagator *propagator)
 {
   LevelSetConstPointer inputPtr = this->GetInput();
   LevelSetPointer      outputPtr = this->GetOutput();
-  LevelSetPointer      tempLevelSet = m_Marcher->GetOutput();
+  LevelSetPointer      tempLevelSet = propagator->GetOutput();
 
   double levelSetValue = this->GetLevelSetValue();
   double outputBandwidth = this->GetOutputNarrowBandwidth();
@@ -368,7 +409,7 @@ ExtensionVelocitiesImageFilter< TLevelSet, TAuxValue, VAuxDimension >
   AuxImagePointer outputAuxImage[VAuxDimension];
   for ( unsigned int k = 0; k < VAuxDimension; k++ )
     {
-    tempAuxImage[k] = m_Marcher->GetAuxiliaryImage(k);
+    tempAuxImage[k] = propagator->GetAuxiliaryImage(k);
     outputAuxImage[k] = this->GetOutputVelocityImage(k);
     }
 
@@ -403,13 +444,13 @@ ExtensionVelocitiesImageFilter< TLevelSet, TAuxValue, VAuxDimension >
 
   // march outward
   double stoppingValue = ( outputBandwidth / 2.0 ) + 2.0;
-  m_Marcher->SetStoppingValue(stoppingValue);
-  m_Marcher->CollectPointsOn();
-  m_Marcher->SetTrialPoints( m_Locator->GetOutsidePoints() );
-  m_Marcher->SetAuxiliaryTrialValues( m_Locator->GetModifiableAuxOutsideValues() );
-  m_Marcher->Update();
+  propagator->SetStoppingValue(stoppingValue);
+  propagator->CollectPointsOn();
+  propagator->SetTrialPoints( m_Locator->GetOutsidePoints() );
+  propagator->SetAuxiliaryTrialValues( m_Locator->GetModifiableAuxOutsideValues() );
+  propagator->Update();
 
-  NodeContainerPointer procPoints = m_Marcher->GetProcessedPoints();
+  NodeContainerPointer procPoints = propagator->GetProcessedPoints();
 
   typename NodeContainer::ConstIterator pointsIt;
   typename NodeContainer::ConstIterator pointsEnd;
@@ -443,11 +484,11 @@ ExtensionVelocitiesImageFilter< TLevelSet, TAuxValue, VAuxDimension >
   this->UpdateProgress(0.66);
 
   // march inward
-  m_Marcher->SetTrialPoints( m_Locator->GetInsidePoints() );
-  m_Marcher->SetAuxiliaryTrialValues( m_Locator->GetModifiableAuxInsideValues() );
-  m_Marcher->Update();
+  propagator->SetTrialPoints( m_Locator->GetInsidePoints() );
+  propagator->SetAuxiliaryTrialValues( m_Locator->GetModifiableAuxInsideValues() );
+  propagator->Update();
 
-  procPoints = m_Marcher->GetProcessedPoints();
+  procPoints = propagator->GetProcessedPoints();
   pointsIt = procPoints->Begin();
   pointsEnd = procPoints->End();
 
@@ -21,6 +21,7 @@
 #include "itkLightProcessObject.h"
 #include "itkLevelSet.h"
 #include "itkIndex.h"
+#include "itkLevelSetNeighborhoodExtractorThreader.h"
 
 namespace itk
 {
@@ -45,6 +46,11 @@ namespace itk
  * provided, the alogrithm will only search pixels within the
  * narrowband.
  *
+ * The pixels next to the level set are searched with NumberOfThreads
+ * threads. Their distances are then calculated with a single thread, in
+ * the order of the image or of the narrowband, so that the containers do
+ * not depend on the number of threads.
+ *
  * Implemenation of this class is based on Chapter 11 of
  * "Level Set Methods and Fast Marching Methods", J.A. Sethian,
  * Cambridge Press, Second edition, 1999.
@@ -126,6 +132,11 @@ public:
   NodeContainerPointer GetOutsidePoints(void)
   { return m_OutsidePoints; }
 
+  /** Set/Get the number of threads used to search the pixels next to the
+   * level set. Defaults to the global default number of threads. */
+  itkSetClampMacro( NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS );
+  itkGetConstMacro(NumberOfThreads, ThreadIdType);
+
   /** Locate the level set. This method evokes the level set
    * location algorithm. */
   void Locate();
@@ -145,6 +156,11 @@ protected:
 
   virtual double CalculateDistance(IndexType & index);
 
+  /** Returns true if CalculateDistance() finds a neighbor of the pixel on
+   * the other side of the level set, that is if it adds the pixel to the
+   * inside or outside points. This method is thread safe. */
+  bool IsNextToLevelSet(const IndexType & index) const;
+
   virtual void GenerateData() ITK_OVERRIDE;
 
   bool GetLastPointIsInside() const
@@ -153,10 +169,17 @@ protected:
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(LevelSetNeighborhoodExtractor);
 
+  typedef LevelSetNeighborhoodExtractorThreader< Self > ThreaderType;
+  friend class LevelSetNeighborhoodExtractorThreader< Self >;
+
   void      GenerateDataFull();
 
   void      GenerateDataNarrowBand();
 
+  /** Calculates the distances of the pixels next to the level set found
+   * by the threader, in order. */
+  void      CalculateDistances(const std::vector< IndexType > & indices);
+
   double m_LevelSetValue;
 
   NodeContainerPointer m_InsidePoints;
@@ -174,6 +197,9 @@ private:
   std::vector< NodeType > m_NodesUsed;
 
   bool m_LastPointIsInside;
+
+  ThreadIdType                   m_NumberOfThreads;
+  typename ThreaderType::Pointer m_Threader;
 };
 } // namespace itk
 
@@ -21,6 +21,7 @@
 #include "itkLevelSetNeighborhoodExtractor.h"
 #include "itkImageRegionIterator.h"
 #include "itkNumericTraits.h"
+#include "itkMultiThreader.h"
 #include "itkMath.h"
 
 #include <algorithm>
@@ -41,7 +42,9 @@ LevelSetNeighborhoodExtractor< TLevelSet >
   m_NarrowBandwidth(12.0),
   m_InputNarrowBand(ITK_NULLPTR),
   m_LargeValue(NumericTraits< PixelType >::max()),
-  m_LastPointIsInside(false)
+  m_LastPointIsInside(false),
+  m_NumberOfThreads( MultiThreader::GetGlobalDefaultNumberOfThreads() ),
+  m_Threader( ThreaderType::New() )
 {
   m_NodesUsed.resize(SetDimension);
 }
@@ -62,6 +65,7 @@ LevelSetNeighborhoodExtractor< TLevelSet >
   os << indent << "Narrowbanding: " << m_NarrowBanding << std::endl;
   os << indent << "Input narrow band: ";
   os << m_InputNarrowBand.GetPointer() << std::endl;
+  os << indent << "Number of threads: " << m_NumberOfThreads << std::endl;
 }
 
 /*
@@ -142,30 +146,12 @@ void
 LevelSetNeighborhoodExtractor< TLevelSet >
 ::GenerateDataFull()
 {
-  typedef ImageRegionConstIterator< LevelSetImageType > InputConstIterator;
+  std::vector< IndexType > indices;
 
-  InputConstIterator inIt ( m_InputLevelSet,
-                            m_InputLevelSet->GetBufferedRegion() );
+  m_Threader->SetMaximumNumberOfThreads(m_NumberOfThreads);
+  m_Threader->FindPixelsNextToLevelSet(this, indices);
 
-  IndexType inputIndex;
-
-  SizeValueType totalPixels  =
-    m_InputLevelSet->GetBufferedRegion().GetNumberOfPixels();
-  SizeValueType updateVisits = totalPixels / 10;
-  if ( updateVisits < 1 ) { updateVisits = 1; }
-
-  SizeValueType i;
-  for ( i = 0; !inIt.IsAtEnd(); ++inIt, ++i )
-    {
-    // update progress
-    if ( !( i % updateVisits ) )
-      {
-      this->UpdateProgress( (float)i / (float)totalPixels );
-      }
-
-    inputIndex = inIt.GetIndex();
-    this->CalculateDistance(inputIndex);
-    }
+  this->CalculateDistances(indices);
 }
 
 /**
@@ -181,32 +167,40 @@ LevelSetNeighborhoodExtractor< TLevelSet >
     itkExceptionMacro(<< "InputNarrowBand has not been set");
     }
 
-  typename NodeContainer::ConstIterator pointsIter;
-  typename NodeContainer::ConstIterator pointsEnd;
+  std::vector< IndexType > indices;
+
+  m_Threader->SetMaximumNumberOfThreads(m_NumberOfThreads);
+  m_Threader->FindPixelsNextToLevelSet(this, indices);
 
-  pointsIter = m_InputNarrowBand->Begin();
-  pointsEnd = m_InputNarrowBand->End();
-  NodeType node;
-  double   maxValue = m_NarrowBandwidth / 2.0;
+  this->CalculateDistances(indices);
+}
 
-  SizeValueType totalPixels  = m_InputNarrowBand->Size();
+/**
+ *
+ */
+template< typename TLevelSet >
+void
+LevelSetNeighborhoodExtractor< TLevelSet >
+::CalculateDistances(const std::vector< IndexType > & indices)
+{
+  this->UpdateProgress(0.5);
+
+  SizeValueType totalPixels  = indices.size();
   SizeValueType updateVisits = totalPixels / 10;
   if ( updateVisits < 1 ) { updateVisits = 1; }
 
-  unsigned int i;
-  for ( i = 0; pointsIter != pointsEnd; ++pointsIter, ++i )
+  IndexType index;
+
+  for ( SizeValueType i = 0; i < totalPixels; ++i )
     {
     // update progress
     if ( !( i % updateVisits ) )
       {
-      this->UpdateProgress( (float)i / (float)totalPixels );
+      this->UpdateProgress( 0.5f + 0.5f * (float)i / (float)totalPixels );
       }
 
-    node = pointsIter.Value();
-    if ( itk::Math::abs( node.GetValue() ) <= maxValue )
-      {
-      this->CalculateDistance( node.GetIndex() );
-      }
+    index = indices[i];
+    this->CalculateDistance(index);
     }
 }
 
@@ -324,6 +318,62 @@ LevelSetNeighborhoodExtractor< TLevelSet >
 
   return distance;
 }
+
+/**
+ *
+ */
+template< typename TLevelSet >
+bool
+LevelSetNeighborhoodExtractor< TLevelSet >
+::IsNextToLevelSet(
+  const IndexType & index) const
+{
+  // Same tests as CalculateDistance()
+  typename LevelSetImageType::PixelType centerValue;
+  PixelType inputPixel;
+
+  inputPixel = m_InputLevelSet->GetPixel(index);
+  centerValue = (double)inputPixel;
+  centerValue -= m_LevelSetValue;
+
+  if ( centerValue == 0.0 )
+    {
+    return true;
+    }
+
+  bool inside = ( centerValue <= 0.0 );
+
+  IndexType neighIndex = index;
+  typename LevelSetImageType::PixelType neighValue;
+
+  for ( unsigned int j = 0; j < SetDimension; j++ )
+    {
+    for ( int s = -1; s < 2; s = s + 2 )
+      {
+      neighIndex[j] = index[j] + s;
+
+      if ( ! this->m_ImageRegion.IsInside( neighIndex ) )
+        {
+        continue;
+        }
+
+      inputPixel = m_InputLevelSet->GetPixel(neighIndex);
+      neighValue = inputPixel;
+      neighValue -= m_LevelSetValue;
+
+      if ( ( neighValue > 0 && inside )
+           || ( neighValue < 0 && !inside ) )
+        {
+        return true;
+        }
+      }
+
+    // reset neighIndex
+    neighIndex[j] = index[j];
+    }
+
+  return false;
+}
 } // namespace itk
 
 #endif
@@ -0,0 +1,100 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLevelSetNeighborhoodExtractorThreader_h
+#define itkLevelSetNeighborhoodExtractorThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class LevelSetNeighborhoodExtractorThreader
+ * \brief Thread the search of the pixels next to a level set for
+ * LevelSetNeighborhoodExtractor.
+ *
+ * The pixels of the input level set, or the nodes of the input narrowband
+ * when narrowbanding is on, are split in ranges, one per thread. Each
+ * thread keeps the pixels that have a neighbor on the other side of the
+ * level set. The pixels are returned in the order of the image or of the
+ * narrowband, so that the extractor can compute their distances to the
+ * level set with a single thread, exactly as if it had visited all the
+ * pixels itself.
+ *
+ * \tparam TExtractor LevelSetNeighborhoodExtractor or a subclass
+ *
+ * \ingroup ITKLevelSets
+ */
+template< typename TExtractor >
+class ITK_TEMPLATE_EXPORT LevelSetNeighborhoodExtractorThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, TExtractor >
+{
+public:
+  /** Standard class typedefs. */
+  typedef LevelSetNeighborhoodExtractorThreader                              Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, TExtractor > Superclass;
+  typedef SmartPointer< Self >                                               Pointer;
+  typedef SmartPointer< const Self >                                         ConstPointer;
+
+  /** Run time type information. */
+  itkTypeMacro( LevelSetNeighborhoodExtractorThreader, DomainThreader );
+
+  /** Standard New macro. */
+  itkNewMacro( Self );
+
+  /** Superclass types. */
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+
+  typedef TExtractor                                ExtractorType;
+  typedef typename ExtractorType::IndexType         IndexType;
+  typedef typename ExtractorType::LevelSetImageType LevelSetImageType;
+  typedef typename ExtractorType::NodeContainer     NodeContainer;
+  typedef std::vector< IndexType >                  IndexContainerType;
+
+  /** Find the pixels next to the level set located by the extractor, and
+   * store them in the order of the image or of the narrowband. */
+  void FindPixelsNextToLevelSet( ExtractorType * extractor, IndexContainerType & indices );
+
+protected:
+  LevelSetNeighborhoodExtractorThreader();
+
+  virtual void BeforeThreadedExecution() ITK_OVERRIDE;
+
+  virtual void ThreadedExecution( const DomainType & subRange, const ThreadIdType threadId ) ITK_OVERRIDE;
+
+  virtual void AfterThreadedExecution() ITK_OVERRIDE;
+
+  typedef std::vector< IndexContainerType > IndicesPerThreadType;
+  IndicesPerThreadType m_IndicesPerThread;
+
+  IndexContainerType * m_Indices;
+
+private:
+  ITK_DISALLOW_COPY_AND_ASSIGN(LevelSetNeighborhoodExtractorThreader);
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkLevelSetNeighborhoodExtractorThreader.hxx"
+#endif
+
+#endif
@@ -0,0 +1,144 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLevelSetNeighborhoodExtractorThreader_hxx
+#define itkLevelSetNeighborhoodExtractorThreader_hxx
+
+#include "itkLevelSetNeighborhoodExtractorThreader.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkMath.h"
+
+namespace itk
+{
+
+template< typename TExtractor >
+LevelSetNeighborhoodExtractorThreader< TExtractor >
+::LevelSetNeighborhoodExtractorThreader() :
+  m_Indices( ITK_NULLPTR )
+{
+}
+
+template< typename TExtractor >
+void
+LevelSetNeighborhoodExtractorThreader< TExtractor >
+::FindPixelsNextToLevelSet( ExtractorType * extractor, IndexContainerType & indices )
+{
+  indices.clear();
+
+  // The domain is the range of the nodes of the narrowband, or of the
+  // offsets of the pixels in the buffer of the level set
+  SizeValueType numberOfElements;
+  if( extractor->m_NarrowBanding )
+    {
+    numberOfElements = extractor->m_InputNarrowBand->Size();
+    }
+  else
+    {
+    numberOfElements = extractor->m_InputLevelSet->GetBufferedRegion().GetNumberOfPixels();
+    }
+
+  // The partitioner cannot split an empty range
+  if( numberOfElements == 0 )
+    {
+    return;
+    }
+
+  this->m_Indices = &indices;
+
+  DomainType completeDomain;
+  completeDomain[0] = 0;
+  completeDomain[1] = numberOfElements - 1;
+  this->Execute( extractor, completeDomain );
+
+  this->m_Indices = ITK_NULLPTR;
+}
+
+template< typename TExtractor >
+void
+LevelSetNeighborhoodExtractorThreader< TExtractor >
+::BeforeThreadedExecution()
+{
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
+  this->m_IndicesPerThread.resize( numberOfThreads );
+
+  for( ThreadIdType ii = 0; ii < numberOfThreads; ++ii )
+    {
+    this->m_IndicesPerThread[ii].clear();
+    }
+}
+
+template< typename TExtractor >
+void
+LevelSetNeighborhoodExtractorThreader< TExtractor >
+::ThreadedExecution( const DomainType & subRange,
+                     const ThreadIdType threadId )
+{
+  const ExtractorType * extractor = this->m_Associate;
+  IndexContainerType &  indices = this->m_IndicesPerThread[threadId];
+
+  if( extractor->m_NarrowBanding )
+    {
+    const NodeContainer * narrowBand = extractor->m_InputNarrowBand;
+    const double          maxValue = extractor->m_NarrowBandwidth / 2.0;
+
+    for( typename DomainType::IndexValueType ii = subRange[0]; ii <= subRange[1]; ++ii )
+      {
+      const typename NodeContainer::Element & node = narrowBand->ElementAt(
+        static_cast< typename NodeContainer::ElementIdentifier >( ii ) );
+      if( itk::Math::abs( node.GetValue() ) <= maxValue
+          && extractor->IsNextToLevelSet( node.GetIndex() ) )
+        {
+        indices.push_back( node.GetIndex() );
+        }
+      }
+    }
+  else
+    {
+    const LevelSetImageType * levelSet = extractor->m_InputLevelSet;
+
+    ImageRegionConstIteratorWithIndex< LevelSetImageType > it( levelSet, levelSet->GetBufferedRegion() );
+    it.SetIndex( levelSet->ComputeIndex( subRange[0] ) );
+
+    for( typename DomainType::IndexValueType ii = subRange[0]; ii <= subRange[1]; ++ii, ++it )
+      {
+      if( extractor->IsNextToLevelSet( it.GetIndex() ) )
+        {
+        indices.push_back( it.GetIndex() );
+        }
+      }
+    }
+}
+
+template< typename TExtractor >
+void
+LevelSetNeighborhoodExtractorThreader< TExtractor >
+::AfterThreadedExecution()
+{
+  // The ranges of the threads follow each other in the domain
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
+  for( ThreadIdType ii = 0; ii < numberOfThreads; ++ii )
+    {
+    this->m_Indices->insert( this->m_Indices->end(),
+                             this->m_IndicesPerThread[ii].begin(),
+                             this->m_IndicesPerThread[ii].end() );
+    this->m_IndicesPerThread[ii].clear();
+    }
+}
+
+} // end namespace itk
+
+#endif
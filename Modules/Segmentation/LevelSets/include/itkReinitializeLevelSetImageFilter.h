@@ -20,6 +20,7 @@
 
 #include "itkLevelSetNeighborhoodExtractor.h"
 #include "itkFastMarchingImageFilter.h"
+#include "itkFastSweepingImageFilter.h"
 
 namespace itk
 {
@@ -43,6 +44,13 @@ namespace itk
  * For the output, the reinitialize level set is only valid for a distance
  * of OutputNarrowBandwidth / 2 of either side of the level set of interest.
  *
+ * By default, the distances are computed by a FastMarchingImageFilter,
+ * which runs on a single thread. When UseFastSweeping is on, they are
+ * computed by a FastSweepingImageFilter instead, which sweeps tiles of the
+ * image on several threads and gives the same distances. The level set is
+ * also located on several threads by the LevelSetNeighborhoodExtractor.
+ * Both use the number of threads of this filter.
+ *
  * Implementation of this class is based on Chapter 11 of
  * "Level Set Methods and Fast Marching Methods", J.A. Sethian,
  * Cambridge Press, Second edition, 1999.
@@ -121,6 +129,12 @@ public:
   NodeContainerPointer GetOutputNarrowBand() const
   { return m_OutputNarrowBand; }
 
+  /** Set/Get whether the distances are computed by fast sweeping on several
+   * threads instead of fast marching. By default, fast marching is used. */
+  itkSetMacro(UseFastSweeping, bool);
+  itkGetConstMacro(UseFastSweeping, bool);
+  itkBooleanMacro(UseFastSweeping);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   // Begin concept checking
   itkConceptMacro( LevelSetDoubleAdditiveOperatorsCheck,
@@ -139,6 +153,7 @@ protected:
   typedef Image< float, itkGetStaticConstMacro(SetDimension) > SpeedImageType;
   typedef LevelSetNeighborhoodExtractor< TLevelSet >           LocatorType;
   typedef FastMarchingImageFilter< TLevelSet, SpeedImageType > FastMarchingImageFilterType;
+  typedef FastSweepingImageFilter< TLevelSet, SpeedImageType > FastSweepingImageFilterType;
 
   void GenerateData() ITK_OVERRIDE;
 
@@ -158,12 +173,24 @@ protected:
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(ReinitializeLevelSetImageFilter);
 
+  /** Reinitialize the level set with the distances computed by a fast
+   * marching or a fast sweeping filter. */
+  template< typename TPropagator >
+  void ReinitializeFull(TPropagator *propagator);
+
+  template< typename TPropagator >
+  void ReinitializeNarrowBand(TPropagator *propagator);
+
   double m_LevelSetValue;
 
   typename LocatorType::Pointer m_Locator;
 
   typename FastMarchingImageFilterType::Pointer m_Marcher;
 
+  typename FastSweepingImageFilterType::Pointer m_Sweeper;
+
+  bool m_UseFastSweeping;
+
   bool                 m_NarrowBanding;
   double               m_InputNarrowBandwidth;
   double               m_OutputNarrowBandwidth;
@@ -35,6 +35,8 @@ ReinitializeLevelSetImageFilter< TLevelSet >
 
   m_Locator = LocatorType::New();
   m_Marcher = FastMarchingImageFilterType::New();
+  m_Sweeper = FastSweepingImageFilterType::New();
+  m_UseFastSweeping = false;
 
   m_NarrowBanding = false;
   m_InputNarrowBandwidth = 12.0;
@@ -78,6 +80,7 @@ ReinitializeLevelSetImageFilter< TLevelSet >
   os << std::endl;
   os << indent << "Output narrow band: " << m_OutputNarrowBand.GetPointer();
   os << std::endl;
+  os << indent << "Use fast sweeping: " << m_UseFastSweeping << std::endl;
 }
 
 /*
@@ -140,6 +143,12 @@ ReinitializeLevelSetImageFilter< TLevelSet >
   this->m_Marcher->SetOutputOrigin( this->GetInput()->GetOrigin() );
   this->m_Marcher->SetOutputSpacing( this->GetInput()->GetSpacing() );
   this->m_Marcher->SetOutputDirection( this->GetInput()->GetDirection() );
+
+  // set the sweeper output size
+  this->m_Sweeper->SetOutputRegion( outputPtr->GetRequestedRegion() );
+  this->m_Sweeper->SetOutputOrigin( this->GetInput()->GetOrigin() );
+  this->m_Sweeper->SetOutputSpacing( this->GetInput()->GetSpacing() );
+  this->m_Sweeper->SetOutputDirection( this->GetInput()->GetDirection() );
 }
 
 /*
@@ -152,6 +161,9 @@ ReinitializeLevelSetImageFilter< TLevelSet >
 {
   this->AllocateOutput();
 
+  m_Locator->SetNumberOfThreads( this->GetNumberOfThreads() );
+  m_Sweeper->SetNumberOfThreads( this->GetNumberOfThreads() );
+
   if ( m_NarrowBanding )
     {
     this->GenerateDataNarrowBand();
@@ -169,10 +181,26 @@ template< typename TLevelSet >
 void
 ReinitializeLevelSetImageFilter< TLevelSet >
 ::GenerateDataFull()
+{
+  if ( m_UseFastSweeping )
+    {
+    this->ReinitializeFull( m_Sweeper.GetPointer() );
+    }
+  else
+    {
+    this->ReinitializeFull( m_Marcher.GetPointer() );
+    }
+}
+
+template< typename TLevelSet >
+template< typename TPropagator >
+void
+ReinitializeLevelSetImageFilter< TLevelSet >
+::ReinitializeFull(TPropagator *propagator)
 {
   LevelSetConstPointer inputPtr = this->GetInput();
   LevelSetPointer      outputPtr = this->GetOutput();
-  LevelSetPointer      tempLevelSet = m_Marcher->GetOutput();
+  LevelSetPointer      tempLevelSet = propagator->GetOutput();
 
   // define iterators
   typedef ImageRegionIterator< LevelSetImageType >      IteratorType;
@@ -195,8 +223,8 @@ ReinitializeLevelSetImageFilter< TLevelSet >
   this->UpdateProgress(0.33);
 
   // march outward
-  m_Marcher->SetTrialPoints( m_Locator->GetOutsidePoints() );
-  m_Marcher->Update();
+  propagator->SetTrialPoints( m_Locator->GetOutsidePoints() );
+  propagator->Update();
 
   tempIt = IteratorType( tempLevelSet,
                          tempLevelSet->GetBufferedRegion() );
@@ -219,8 +247,8 @@ ReinitializeLevelSetImageFilter< TLevelSet >
   this->UpdateProgress(0.66);
 
   // march inward
-  m_Marcher->SetTrialPoints( m_Locator->GetInsidePoints() );
-  m_Marcher->Update();
+  propagator->SetTrialPoints( m_Locator->GetInsidePoints() );
+  propagator->Update();
 
   inputIt.GoToBegin();
   outputIt.GoToBegin();
@@ -248,10 +276,26 @@ template< typename TLevelSet >
 void
 ReinitializeLevelSetImageFilter< TLevelSet >
 ::GenerateDataNarrowBand()
+{
+  if ( m_UseFastSweeping )
+    {
+    this->ReinitializeNarrowBand( m_Sweeper.GetPointer() );
+    }
+  else
+    {
+    this->ReinitializeNarrowBand( m_Marcher.GetPointer() );
+    }
+}
+
+template< typename TLevelSet >
+template< typename TPropagator >
+void
+ReinitializeLevelSetImageFilter< TLevelSet >
+::ReinitializeNarrowBand(TPropagator *propagator)
 {
   LevelSetConstPointer inputPtr = this->GetInput();
   LevelSetPointer      outputPtr = this->GetOutput();
-  LevelSetPointer      tempLevelSet = m_Marcher->GetOutput();
+  LevelSetPointer      tempLevelSet = propagator->GetOutput();
 
   // define iterators
   typedef ImageRegionIterator< LevelSetImageType >      IteratorType;
@@ -315,12 +359,12 @@ ReinitializeLevelSetImageFilter< TLevelSet >
 
   // march outward
   double stoppingValue = ( m_OutputNarrowBandwidth / 2.0 ) + 2.0;
-  m_Marcher->SetStoppingValue(stoppingValue);
-  m_Marcher->CollectPointsOn();
-  m_Marcher->SetTrialPoints( m_Locator->GetOutsidePoints() );
-  m_Marcher->Update();
+  propagator->SetStoppingValue(stoppingValue);
+  propagator->CollectPointsOn();
+  propagator->SetTrialPoints( m_Locator->GetOutsidePoints() );
+  propagator->Update();
 
-  NodeContainerPointer procPoints = m_Marcher->GetProcessedPoints();
+  NodeContainerPointer procPoints = propagator->GetProcessedPoints();
 
   typename NodeContainer::ConstIterator pointsIt;
   typename NodeContainer::ConstIterator pointsEnd;
@@ -348,10 +392,10 @@ ReinitializeLevelSetImageFilter< TLevelSet >
   this->UpdateProgress(0.66);
 
   // march inward
-  m_Marcher->SetTrialPoints( m_Locator->GetInsidePoints() );
-  m_Marcher->Update();
+  propagator->SetTrialPoints( m_Locator->GetInsidePoints() );
+  propagator->Update();
 
-  procPoints = m_Marcher->GetProcessedPoints();
+  procPoints = propagator->GetProcessedPoints();
   pointsIt = procPoints->Begin();
   pointsEnd = procPoints->End();
 
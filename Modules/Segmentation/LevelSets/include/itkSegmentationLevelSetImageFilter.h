@@ -132,6 +132,11 @@ namespace itk
  * equation. Setting this value will  override any value already set by
  * FeatureScaling.
  *
+ * \par
+ * The UseTiledEvolution parameter, inherited from
+ * SparseFieldLevelSetImageFilter, splits the sparse field into tiles of
+ * TileSize pixels which the threads of the filter evolve in parallel.
+ *
  * \warning This is an abstract class. It is not intended to be instantiated
  * by itself. Instead, you should use the derived classes. This is the reason
  * why the New() operator (itkNewMacro) is missing from the class API.
@@ -157,17 +157,18 @@ ShapePriorSegmentationLevelSetImageFilter< TInputImage, TFeatureImage, TOutputPi
   const typename Superclass::FiniteDifferenceFunctionType::Pointer df =
     this->GetDifferenceFunction();
 
-  typename Superclass::LayerType::ConstIterator layerIt;
+  std::vector< typename OutputImageType::IndexType > layerIndices;
   NeighborhoodIterator< OutputImageType > outputIt( df->GetRadius(),
                                                     this->GetOutput(), this->GetOutput()->GetRequestedRegion() );
 
   unsigned int counter = 0;
   for ( unsigned int k = 0; k < this->GetNumberOfLayers(); k++ )
     {
-    for ( layerIt = this->m_Layers[k]->Begin(); layerIt != this->m_Layers[k]->End(); ++layerIt )
+    this->GetLayerIndices(k, layerIndices);
+    for ( size_t n = 0; n < layerIndices.size(); ++n )
       {
       NodeType node;
-      outputIt.SetLocation(layerIt->m_Value);
+      outputIt.SetLocation(layerIndices[n]);
       node.SetIndex( outputIt.GetIndex() );
       node.SetValue( outputIt.GetCenterPixel() );
       ptr->InsertElement(counter++, node);
@@ -201,16 +201,16 @@ bool
 SparseFieldFourthOrderLevelSetImageFilter< TInputImage, TOutputImage >
 ::ActiveLayerCheckBand() const
 {
-  typename LayerType::Iterator layerIt;
+  std::vector< IndexType > activeLayer;
   typename SparseImageType::Pointer
   im = m_LevelSetFunction->GetSparseTargetImage();
   bool      flag = false;
   NodeType *node;
 
-  layerIt = this->m_Layers[0]->Begin();
-  while ( layerIt != this->m_Layers[0]->End() )
+  this->GetLayerIndices(0, activeLayer);
+  for ( size_t k = 0; k < activeLayer.size(); ++k )
     {
-    node = im->GetPixel(layerIt->m_Value);
+    node = im->GetPixel(activeLayer[k]);
     if ( ( node == ITK_NULLPTR )
          || ( node->m_CurvatureFlag == false ) )
       {
@@ -218,7 +218,6 @@ SparseFieldFourthOrderLevelSetImageFilter< TInputImage, TOutputImage >
       flag = true;
       break;
       }
-    ++layerIt;
     }
   return flag;
 }
@@ -20,6 +20,8 @@
 
 #include "itkFiniteDifferenceImageFilter.h"
 #include "itkMultiThreader.h"
+#include "itkBarrier.h"
+#include "itkAtomicInt.h"
 #include "itkSparseFieldLayer.h"
 #include "itkObjectStore.h"
 #include <vector>
@@ -210,6 +212,20 @@ private:
  * initializes, it will subtract the IsoSurfaceValue from all values, in the
  * input, shifting the isosurface of interest to zero in the output.
  *
+ * \par TILED EVOLUTION
+ * By default, the layers are linked lists which a single thread traverses.
+ * When UseTiledEvolution is on, the image is divided into tiles of TileSize
+ * pixels along each dimension, and each tile holds the nodes of the layers
+ * that lie in it in arrays.  The threads of the filter pick the tiles one
+ * at a time and evolve them through a fixed sequence of phases separated by
+ * barriers.  A tile only writes the pixels it owns: the nodes that move to
+ * a neighboring tile are posted to an outbox which that tile reads in the
+ * next phase, so that no lock is needed.  Opposite moves of adjacent active
+ * nodes are resolved symmetrically, and the time step is the smallest of
+ * the time steps of the tiles, so the result does not depend on the number
+ * of threads, but it may slightly differ from the result of the lists.
+ * The difference function and CalculateUpdateValue() must be thread safe.
+ *
  * \par IMPORTANT!
  *  Read the documentation for FiniteDifferenceImageFilter before attempting to
  *  use this filter.  The solver requires that you specify a
@@ -240,6 +256,8 @@ public:
   typedef typename Superclass::TimeStepType           TimeStepType;
   typedef typename Superclass::RadiusType             RadiusType;
   typedef typename Superclass::NeighborhoodScalesType NeighborhoodScalesType;
+  typedef typename Superclass::FiniteDifferenceFunctionType
+  FiniteDifferenceFunctionType;
 
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
@@ -312,6 +330,17 @@ public:
   void InterpolateSurfaceLocationOff()
   { this->SetInterpolateSurfaceLocation(false); }
 
+  /** Set/Get whether the layers are split into tiles which are evolved by
+   * several threads. Off by default. See the class documentation. */
+  itkSetMacro(UseTiledEvolution, bool);
+  itkGetConstMacro(UseTiledEvolution, bool);
+  itkBooleanMacro(UseTiledEvolution);
+
+  /** Set/Get the number of pixels of the tiles along each dimension when
+   * UseTiledEvolution is on. Defaults to 32. */
+  itkSetClampMacro(TileSize, SizeValueType, 1, NumericTraits< SizeValueType >::max());
+  itkGetConstMacro(TileSize, SizeValueType);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   // Begin concept checking
   itkConceptMacro( OutputEqualityComparableCheck,
@@ -413,6 +442,10 @@ protected:
   /** */
   void ProcessOutsideList(LayerType *OutsideList, StatusType ChangeToStatus);
 
+  /** Copies the indices of the nodes of a layer, whether the layers are
+   *  lists or are split into tiles. */
+  void GetLayerIndices(StatusType layer, std::vector< IndexType > & indices) const;
+
   itkGetConstMacro(ValueZero, ValueType);
   itkGetConstMacro(ValueOne, ValueType);
 
@@ -500,6 +533,125 @@ private:
   /** This flag is true when methods need to check boundary conditions and
       false when methods do not need to check for boundary conditions. */
   bool m_BoundsCheckingActive;
+
+  /** A node posted by a tile to a neighboring tile, with the value it
+   *  proposes for it. */
+  struct TileNodeType
+  {
+    IndexType Index;
+    ValueType Value;
+  };
+  typedef std::vector< TileNodeType > TileNodeListType;
+
+  /** The nodes of the layers which lie in a tile, and the buffers of the
+   *  tile for the current iteration.  Index 0 of the pairs of lists refers
+   *  to the nodes moving inside, index 1 to the nodes moving outside. */
+  struct TileType
+  {
+    std::vector< std::vector< IndexType > > Layers;
+    UpdateBufferType                        UpdateBuffer;
+    std::vector< StatusType >               Moves;
+    std::vector< IndexType >                StatusLists[2];
+    std::vector< TileNodeListType >         Outboxes[2];
+    std::vector< IndexType >                Promotions[2];
+    TimeStepType                            TimeStep;
+    bool                                    ValidTimeStep;
+    double                                  RMSChangeAccumulator;
+    SizeValueType                           NumberOfUpdatedNodes;
+    bool                                    BoundaryReached;
+  };
+
+  struct TiledEvolutionStruct
+  {
+    Self                                     *Filter;
+    TimeStepType                              TimeStep;
+    ValueType                                 MinimumNorm;
+    std::vector< AtomicInt< SizeValueType > > NextTile;
+    Barrier::Pointer                          PhaseBarrier;
+  };
+
+  /** Splits the output into tiles and moves the nodes of the layer lists
+   *  to the tiles. */
+  void InitializeTiles();
+
+  /** Index of the tile of a pixel. */
+  SizeValueType ComputeTileIndex(const IndexType & index) const;
+
+  /** Claims the next tile to process in a phase of an iteration, or returns
+   *  false when all the tiles have been claimed. */
+  bool GetNextTile(TiledEvolutionStruct *str, unsigned int phase, SizeValueType & tileIndex) const;
+
+  /** Posts a neighbor of a node of a tile to the outbox of a chain of the
+   *  tile for the tile of the neighbor, which is either the same tile or
+   *  its neighbor across a face. */
+  void PostNode(SizeValueType tileIndex, unsigned int chain, unsigned int neighbor,
+                const IndexType & index, ValueType value);
+
+  /** Takes the nodes with a status posted to a tile by the tile and its
+   *  neighbors into a status list or a layer.  When acceptValues is true,
+   *  the values posted with the nodes are also applied. */
+  void ReceiveNodes(SizeValueType tileIndex, unsigned int chain, StatusType searchForStatus,
+                    StatusType changeToStatus, bool acceptValues);
+
+  /** Computes the change at the node at the center of a neighborhood of the
+   *  active layer. */
+  ValueType ComputeActiveLayerNodeUpdate(FiniteDifferenceFunctionType *df,
+                                         const NeighborhoodIterator< OutputImageType > & outputIt,
+                                         void *globalData, ValueType minimumNorm) const;
+
+  TimeStepType TiledCalculateChange();
+
+  void TiledApplyUpdate(const TimeStepType & dt);
+
+  static ITK_THREAD_RETURN_TYPE TiledCalculateChangeThreaderCallback(void *arg);
+
+  static ITK_THREAD_RETURN_TYPE TiledApplyUpdateThreaderCallback(void *arg);
+
+  /** Computes the changes of the active nodes of a tile and the time step
+   *  of the tile. */
+  void ThreadedCalculateChange(SizeValueType tileIndex, FiniteDifferenceFunctionType *df,
+                               NeighborhoodIterator< OutputImageType > & outputIt, ValueType minimumNorm);
+
+  /** Computes the new values of the active nodes of a tile, and marks the
+   *  nodes whose value leaves the active range. */
+  void ThreadedUpdateActiveLayerValues(SizeValueType tileIndex, const TimeStepType & dt);
+
+  /** Cancels the moves of active nodes next to active nodes moving in the
+   *  opposite direction, and posts the first layer neighbors of the moving
+   *  nodes with their new active values. */
+  void ThreadedPostActiveLayerMoves(SizeValueType tileIndex, NeighborhoodIterator< StatusImageType > & statusIt);
+
+  /** Applies the new values and the moves of the active nodes of a tile,
+   *  and takes the nodes posted to the tile into the active layer. */
+  void ThreadedMoveActiveLayerNodes(SizeValueType tileIndex);
+
+  /** Posts the neighbors with a status of the nodes of the status lists of
+   *  a tile. */
+  void ThreadedPostStatusListNeighbors(SizeValueType tileIndex, const StatusType searchForStatus[2],
+                                       NeighborhoodIterator< StatusImageType > & statusIt);
+
+  /** Moves the nodes of the status lists of a tile to their new layers, and
+   *  builds the next status lists from the nodes posted to the tile. When
+   *  the posted nodes are outside of the sparse field, they are added to
+   *  the outermost layers instead. */
+  void ThreadedProcessStatusLists(SizeValueType tileIndex, const StatusType changeToStatus[2],
+                                  const StatusType searchForStatus[2], bool outermost);
+
+  /** Tiled version of PropagateLayerValues(), for the pair of inside and
+   *  outside layers at a distance from the active layer. The promotions
+   *  are recorded, and applied by ThreadedPromoteLayerNodes(). */
+  void ThreadedPropagateLayerValues(SizeValueType tileIndex, unsigned int distance,
+                                    NeighborhoodIterator< OutputImageType > & outputIt,
+                                    NeighborhoodIterator< StatusImageType > & statusIt);
+
+  void ThreadedPromoteLayerNodes(SizeValueType tileIndex, unsigned int distance);
+
+  bool                    m_UseTiledEvolution;
+  SizeValueType           m_TileSize;
+  std::vector< TileType > m_Tiles;
+  IndexType               m_TileGridIndex;
+  SizeValueType           m_TileGridSize[ImageDimension];
+  SizeValueType           m_TileGridStrides[ImageDimension];
 };
 } // end namespace itk
 
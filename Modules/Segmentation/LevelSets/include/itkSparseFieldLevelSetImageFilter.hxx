@@ -136,8 +136,17 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
   m_InterpolateSurfaceLocation(true),
   m_InputImage(ITK_NULLPTR),
   m_OutputImage(ITK_NULLPTR),
-  m_BoundsCheckingActive(false)
+  m_BoundsCheckingActive(false),
+  m_UseTiledEvolution(false),
+  m_TileSize(32)
 {
+  m_TileGridIndex.Fill(0);
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    m_TileGridSize[i] = 0;
+    m_TileGridStrides[i] = 0;
+    }
+
   m_LayerNodeStore = LayerNodeStorageType::New();
   m_LayerNodeStore->SetGrowthStrategyToExponential();
   this->SetRMSChange( static_cast< double >( m_ValueZero ) );
@@ -153,6 +162,12 @@ void
 SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
 ::ApplyUpdate(const TimeStepType& dt)
 {
+  if ( !m_Tiles.empty() )
+    {
+    this->TiledApplyUpdate(dt);
+    return;
+    }
+
   unsigned int i, j, k, t;
 
   StatusType up_to, up_search;
@@ -631,6 +646,15 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
   // filter.  See PostProcessOutput method for more information.
   this->InitializeBackgroundPixels();
 
+  // Move the nodes to the tiles if the layers are evolved in tiles.
+  if ( m_UseTiledEvolution )
+    {
+    this->InitializeTiles();
+    }
+  else
+    {
+    m_Tiles.clear();
+    }
 }
 
 template< typename TInputImage, typename TOutputImage >
@@ -902,11 +926,13 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >::TimeStepType
 SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
 ::CalculateChange()
 {
+  if ( !m_Tiles.empty() )
+    {
+    return this->TiledCalculateChange();
+    }
+
   const typename Superclass::FiniteDifferenceFunctionType::Pointer df =
     this->GetDifferenceFunction();
-  typename Superclass::FiniteDifferenceFunctionType::FloatOffsetType offset;
-  ValueType norm_grad_phi_squared, dx_forward, dx_backward, forwardValue,
-            backwardValue, centerValue;
   unsigned  i;
   ValueType MIN_NORM      = 1.0e-6;
   if ( this->GetUseImageSpacing() )
@@ -941,74 +967,89 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
   for ( layerIt = m_Layers[0]->Begin(); layerIt != m_Layers[0]->End(); ++layerIt )
     {
     outputIt.SetLocation(layerIt->m_Value);
+    m_UpdateBuffer.push_back( this->ComputeActiveLayerNodeUpdate(df, outputIt, globalData, MIN_NORM) );
+    }
+
+  // Ask the finite difference function to compute the time step for
+  // this iteration.  We give it the global data pointer to use, then
+  // ask it to free the global data memory.
+  timeStep = df->ComputeGlobalTimeStep(globalData);
 
-    // Calculate the offset to the surface from the center of this
-    // neighborhood.  This is used by some level set functions in sampling a
-    // speed, advection, or curvature term.
-    if ( this->GetInterpolateSurfaceLocation()
-         && ( centerValue = outputIt.GetCenterPixel() ) != 0.0 )
+  df->ReleaseGlobalDataPointer(globalData);
+
+  return timeStep;
+}
+
+template< typename TInputImage, typename TOutputImage >
+typename
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >::ValueType
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::ComputeActiveLayerNodeUpdate(FiniteDifferenceFunctionType *df,
+                               const NeighborhoodIterator< OutputImageType > & outputIt,
+                               void *globalData, ValueType minimumNorm) const
+{
+  typename FiniteDifferenceFunctionType::FloatOffsetType offset;
+  ValueType norm_grad_phi_squared, dx_forward, dx_backward, forwardValue,
+            backwardValue, centerValue;
+  unsigned  i;
+
+  // Calculate the offset to the surface from the center of this
+  // neighborhood.  This is used by some level set functions in sampling a
+  // speed, advection, or curvature term.
+  if ( this->GetInterpolateSurfaceLocation()
+       && ( centerValue = outputIt.GetCenterPixel() ) != 0.0 )
+    {
+    // Surface is at the zero crossing, so distance to surface is:
+    // phi(x) / norm(grad(phi)), where phi(x) is the center of the
+    // neighborhood.  The location is therefore
+    // (i,j,k) - ( phi(x) * grad(phi(x)) ) / norm(grad(phi))^2
+    norm_grad_phi_squared = 0.0;
+    for ( i = 0; i < ImageDimension; ++i )
       {
-      // Surface is at the zero crossing, so distance to surface is:
-      // phi(x) / norm(grad(phi)), where phi(x) is the center of the
-      // neighborhood.  The location is therefore
-      // (i,j,k) - ( phi(x) * grad(phi(x)) ) / norm(grad(phi))^2
-      norm_grad_phi_squared = 0.0;
-      for ( i = 0; i < ImageDimension; ++i )
-        {
-        forwardValue  = outputIt.GetNext(i);
-        backwardValue = outputIt.GetPrevious(i);
+      forwardValue  = outputIt.GetNext(i);
+      backwardValue = outputIt.GetPrevious(i);
 
-        if ( forwardValue * backwardValue >= 0 )
-          { //  Neighbors are same sign OR at least one neighbor is zero.
-          dx_forward  = forwardValue - centerValue;
-          dx_backward = centerValue - backwardValue;
+      if ( forwardValue * backwardValue >= 0 )
+        { //  Neighbors are same sign OR at least one neighbor is zero.
+        dx_forward  = forwardValue - centerValue;
+        dx_backward = centerValue - backwardValue;
 
-          // Pick the larger magnitude derivative.
-          if ( ::itk::Math::abs(dx_forward) > ::itk::Math::abs(dx_backward) )
-            {
-            offset[i] = dx_forward;
-            }
-          else
-            {
-            offset[i] = dx_backward;
-            }
+        // Pick the larger magnitude derivative.
+        if ( ::itk::Math::abs(dx_forward) > ::itk::Math::abs(dx_backward) )
+          {
+          offset[i] = dx_forward;
           }
-        else //Neighbors are opposite sign, pick the direction of the 0 surface.
+        else
           {
-          if ( forwardValue * centerValue < 0 )
-            {
-            offset[i] = forwardValue - centerValue;
-            }
-          else
-            {
-            offset[i] = centerValue - backwardValue;
-            }
+          offset[i] = dx_backward;
           }
-
-        norm_grad_phi_squared += offset[i] * offset[i];
         }
-
-      for ( i = 0; i < ImageDimension; ++i )
+      else //Neighbors are opposite sign, pick the direction of the 0 surface.
         {
-        offset[i] = ( offset[i] * centerValue ) / ( norm_grad_phi_squared + MIN_NORM );
+        if ( forwardValue * centerValue < 0 )
+          {
+          offset[i] = forwardValue - centerValue;
+          }
+        else
+          {
+          offset[i] = centerValue - backwardValue;
+          }
         }
 
-      m_UpdateBuffer.push_back( df->ComputeUpdate(outputIt, globalData, offset) );
+      norm_grad_phi_squared += offset[i] * offset[i];
       }
-    else // Don't do interpolation
+
+    for ( i = 0; i < ImageDimension; ++i )
       {
-      m_UpdateBuffer.push_back( df->ComputeUpdate(outputIt, globalData) );
+      offset[i] = ( offset[i] * centerValue ) / ( norm_grad_phi_squared + minimumNorm );
       }
-    }
-
-  // Ask the finite difference function to compute the time step for
-  // this iteration.  We give it the global data pointer to use, then
-  // ask it to free the global data memory.
-  timeStep = df->ComputeGlobalTimeStep(globalData);
 
-  df->ReleaseGlobalDataPointer(globalData);
-
-  return timeStep;
+    return df->ComputeUpdate(outputIt, globalData, offset);
+    }
+  else // Don't do interpolation
+    {
+    return df->ComputeUpdate(outputIt, globalData);
+    }
 }
 
 template< typename TInputImage, typename TOutputImage >
@@ -1149,6 +1190,803 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
     }
 }
 
+template< typename TInputImage, typename TOutputImage >
+void
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::GetLayerIndices(StatusType layer, std::vector< IndexType > & indices) const
+{
+  indices.clear();
+  if ( !m_Tiles.empty() )
+    {
+    for ( SizeValueType t = 0; t < m_Tiles.size(); ++t )
+      {
+      indices.insert( indices.end(), m_Tiles[t].Layers[layer].begin(), m_Tiles[t].Layers[layer].end() );
+      }
+    }
+  else
+    {
+    indices.reserve( m_Layers[layer]->Size() );
+    for ( typename LayerType::ConstIterator layerIt = m_Layers[layer]->Begin();
+          layerIt != m_Layers[layer]->End(); ++layerIt )
+      {
+      indices.push_back(layerIt->m_Value);
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::InitializeTiles()
+{
+  const typename OutputImageType::RegionType region = this->m_OutputImage->GetRequestedRegion();
+
+  SizeValueType numberOfTiles = 1;
+  m_TileGridIndex = region.GetIndex();
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    m_TileGridSize[i] = ( region.GetSize()[i] + m_TileSize - 1 ) / m_TileSize;
+    m_TileGridStrides[i] = numberOfTiles;
+    numberOfTiles *= m_TileGridSize[i];
+    }
+
+  m_Tiles.clear();
+  m_Tiles.resize(numberOfTiles);
+  for ( SizeValueType t = 0; t < numberOfTiles; ++t )
+    {
+    m_Tiles[t].Layers.resize( m_Layers.size() );
+    for ( unsigned int c = 0; c < 2; ++c )
+      {
+      m_Tiles[t].Outboxes[c].resize(2 * ImageDimension + 1);
+      }
+    m_Tiles[t].TimeStep = NumericTraits< TimeStepType >::ZeroValue();
+    m_Tiles[t].ValidTimeStep = false;
+    m_Tiles[t].RMSChangeAccumulator = 0.0;
+    m_Tiles[t].NumberOfUpdatedNodes = 0;
+    m_Tiles[t].BoundaryReached = false;
+    }
+
+  // Move the nodes of the lists to the arrays of their tiles.
+  LayerNodeType *node;
+  for ( unsigned int k = 0; k < m_Layers.size(); ++k )
+    {
+    while ( !m_Layers[k]->Empty() )
+      {
+      node = m_Layers[k]->Front();
+      m_Layers[k]->PopFront();
+      m_Tiles[this->ComputeTileIndex(node->m_Value)].Layers[k].push_back(node->m_Value);
+      m_LayerNodeStore->Return(node);
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+SizeValueType
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::ComputeTileIndex(const IndexType & index) const
+{
+  SizeValueType tileIndex = 0;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    tileIndex += static_cast< SizeValueType >( index[i] - m_TileGridIndex[i] ) / m_TileSize * m_TileGridStrides[i];
+    }
+  return tileIndex;
+}
+
+template< typename TInputImage, typename TOutputImage >
+bool
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::GetNextTile(TiledEvolutionStruct *str, unsigned int phase, SizeValueType & tileIndex) const
+{
+  tileIndex = str->NextTile[phase]++;
+  return tileIndex < m_Tiles.size();
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::PostNode(SizeValueType tileIndex, unsigned int chain, unsigned int neighbor,
+           const IndexType & index, ValueType value)
+{
+  const typename OutputImageType::OffsetType & offset = m_NeighborList.GetNeighborhoodOffset(neighbor);
+
+  // The neighbors differ from the node along a single dimension, so that
+  // the neighbor is either in the same tile or across a face of the tile.
+  unsigned int box = 0;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    if ( offset[i] != 0 )
+      {
+      const OffsetValueType position = index[i] - m_TileGridIndex[i];
+      if ( position / static_cast< OffsetValueType >( m_TileSize )
+           != ( position - offset[i] ) / static_cast< OffsetValueType >( m_TileSize ) )
+        {
+        box = 1 + 2 * i + ( offset[i] > 0 ? 1 : 0 );
+        }
+      break;
+      }
+    }
+
+  TileNodeType node;
+  node.Index = index;
+  node.Value = value;
+  m_Tiles[tileIndex].Outboxes[chain][box].push_back(node);
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::ReceiveNodes(SizeValueType tileIndex, unsigned int chain, StatusType searchForStatus,
+               StatusType changeToStatus, bool acceptValues)
+{
+  const ValueType LOWER_ACTIVE_THRESHOLD = -( m_ConstantGradientValue / 2.0 );
+  const ValueType UPPER_ACTIVE_THRESHOLD =    m_ConstantGradientValue / 2.0;
+
+  TileType & tile = m_Tiles[tileIndex];
+
+  // The nodes posted by the tile itself are in box 0.  A neighbor across
+  // a face posts to the box of the direction from it to this tile.
+  for ( unsigned int box = 0; box < 2 * ImageDimension + 1; ++box )
+    {
+    SizeValueType source = tileIndex;
+    if ( box > 0 )
+      {
+      const unsigned int  i = ( box - 1 ) / 2;
+      const SizeValueType position = ( tileIndex / m_TileGridStrides[i] ) % m_TileGridSize[i];
+      if ( box % 2 == 0 )
+        {
+        if ( position == 0 )
+          {
+          continue;
+          }
+        source = tileIndex - m_TileGridStrides[i];
+        }
+      else
+        {
+        if ( position + 1 >= m_TileGridSize[i] )
+          {
+          continue;
+          }
+        source = tileIndex + m_TileGridStrides[i];
+        }
+      }
+
+    const TileNodeListType & nodes = m_Tiles[source].Outboxes[chain][box];
+    for ( typename TileNodeListType::const_iterator it = nodes.begin(); it != nodes.end(); ++it )
+      {
+      const StatusType status = m_StatusImage->GetPixel(it->Index);
+      if ( status == searchForStatus )
+        {
+        m_StatusImage->SetPixel(it->Index, changeToStatus);
+        if ( changeToStatus == m_StatusChanging )
+          {
+          tile.StatusLists[chain].push_back(it->Index);
+          }
+        else
+          {
+          tile.Layers[changeToStatus].push_back(it->Index);
+          }
+        }
+      else if ( status != m_StatusChanging )
+        {
+        continue;
+        }
+
+      if ( acceptValues )
+        {
+        // Keep the value closest to the zero level set, as in
+        // UpdateActiveLayerValues().
+        const ValueType value = this->m_OutputImage->GetPixel(it->Index);
+        if ( ( chain == 0 && value < LOWER_ACTIVE_THRESHOLD )
+             || ( chain == 1 && value >= UPPER_ACTIVE_THRESHOLD )
+             || ::itk::Math::abs(it->Value) < ::itk::Math::abs(value) )
+          {
+          this->m_OutputImage->SetPixel(it->Index, it->Value);
+          }
+        }
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+typename
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >::TimeStepType
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::TiledCalculateChange()
+{
+  ValueType MIN_NORM = 1.0e-6;
+  if ( this->GetUseImageSpacing() )
+    {
+    SpacePrecisionType minSpacing = NumericTraits< SpacePrecisionType >::max();
+    for ( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      minSpacing = std::min(minSpacing, this->GetInput()->GetSpacing()[i]);
+      }
+    MIN_NORM *= minSpacing;
+    }
+
+  TiledEvolutionStruct str;
+  str.Filter = this;
+  str.TimeStep = NumericTraits< TimeStepType >::ZeroValue();
+  str.MinimumNorm = MIN_NORM;
+  str.NextTile.resize(1);
+
+  const ThreadIdType numberOfThreads =
+    static_cast< ThreadIdType >( std::min( static_cast< SizeValueType >( this->GetNumberOfThreads() ),
+                                           static_cast< SizeValueType >( m_Tiles.size() ) ) );
+  // The threader is shared with the rest of the filter: restore its number
+  // of threads once the tiles are processed.
+  MultiThreader *    threader = this->GetMultiThreader();
+  const ThreadIdType previousNumberOfThreads = threader->GetNumberOfThreads();
+  threader->SetNumberOfThreads(numberOfThreads);
+  threader->SetSingleMethod(this->TiledCalculateChangeThreaderCallback, &str);
+  threader->SingleMethodExecute();
+  threader->SetNumberOfThreads(previousNumberOfThreads);
+
+  // The time step of the iteration is the smallest time step of the tiles.
+  std::vector< TimeStepType > timeStepList( m_Tiles.size() );
+  std::vector< bool >         valid( m_Tiles.size() );
+  bool                        anyValid = false;
+  for ( SizeValueType t = 0; t < m_Tiles.size(); ++t )
+    {
+    timeStepList[t] = m_Tiles[t].TimeStep;
+    valid[t] = m_Tiles[t].ValidTimeStep;
+    anyValid = anyValid || valid[t];
+    }
+  if ( !anyValid )
+    {
+    // No active node changes: ask the function for its time step, as the
+    // lists do.
+    const typename FiniteDifferenceFunctionType::Pointer df = this->GetDifferenceFunction();
+    void *globalData = df->GetGlobalDataPointer();
+    const TimeStepType timeStep = df->ComputeGlobalTimeStep(globalData);
+    df->ReleaseGlobalDataPointer(globalData);
+    return timeStep;
+    }
+  return this->ResolveTimeStep(timeStepList, valid);
+}
+
+template< typename TInputImage, typename TOutputImage >
+ITK_THREAD_RETURN_TYPE
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::TiledCalculateChangeThreaderCallback(void *arg)
+{
+  TiledEvolutionStruct *str = (TiledEvolutionStruct *)
+                              ( ( (MultiThreader::ThreadInfoStruct *)( arg ) )->UserData );
+  Self *filter = str->Filter;
+
+  const typename FiniteDifferenceFunctionType::Pointer df = filter->GetDifferenceFunction();
+  NeighborhoodIterator< OutputImageType > outputIt( df->GetRadius(), filter->m_OutputImage,
+                                                    filter->m_OutputImage->GetRequestedRegion() );
+  if ( filter->m_BoundsCheckingActive == false )
+    {
+    outputIt.NeedToUseBoundaryConditionOff();
+    }
+
+  SizeValueType tileIndex;
+  while ( filter->GetNextTile(str, 0, tileIndex) )
+    {
+    filter->ThreadedCalculateChange(tileIndex, df, outputIt, str->MinimumNorm);
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::ThreadedCalculateChange(SizeValueType tileIndex, FiniteDifferenceFunctionType *df,
+                          NeighborhoodIterator< OutputImageType > & outputIt, ValueType minimumNorm)
+{
+  TileType &                       tile = m_Tiles[tileIndex];
+  const std::vector< IndexType > & activeLayer = tile.Layers[0];
+
+  tile.UpdateBuffer.clear();
+  tile.ValidTimeStep = !activeLayer.empty();
+  if ( !tile.ValidTimeStep )
+    {
+    return;
+    }
+  tile.UpdateBuffer.reserve( activeLayer.size() );
+
+  void *globalData = df->GetGlobalDataPointer();
+  for ( SizeValueType k = 0; k < activeLayer.size(); ++k )
+    {
+    outputIt.SetLocation(activeLayer[k]);
+    tile.UpdateBuffer.push_back( this->ComputeActiveLayerNodeUpdate(df, outputIt, globalData, minimumNorm) );
+    }
+  // A tile whose nodes do not change constrains the time step of no tile,
+  // as it does not change the maximum changes over the whole active layer.
+  tile.TimeStep = df->ComputeGlobalTimeStep(globalData);
+  tile.ValidTimeStep = tile.TimeStep > NumericTraits< TimeStepType >::ZeroValue();
+  df->ReleaseGlobalDataPointer(globalData);
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::TiledApplyUpdate(const TimeStepType & dt)
+{
+  TiledEvolutionStruct str;
+  str.Filter = this;
+  str.TimeStep = dt;
+  str.MinimumNorm = NumericTraits< ValueType >::ZeroValue();
+
+  // One counter for each phase: the update, the posting and the moves of
+  // the active nodes, two phases for each status list of the outward
+  // sweep, and two phases for each distance of the propagation.
+  str.NextTile.resize(3 + 2 * ( m_Layers.size() - 1 ));
+
+  const ThreadIdType numberOfThreads =
+    static_cast< ThreadIdType >( std::min( static_cast< SizeValueType >( this->GetNumberOfThreads() ),
+                                           static_cast< SizeValueType >( m_Tiles.size() ) ) );
+  MultiThreader *    threader = this->GetMultiThreader();
+  const ThreadIdType previousNumberOfThreads = threader->GetNumberOfThreads();
+  threader->SetNumberOfThreads(numberOfThreads);
+  str.PhaseBarrier = Barrier::New();
+  str.PhaseBarrier->Initialize( threader->GetNumberOfThreads() );
+  threader->SetSingleMethod(this->TiledApplyUpdateThreaderCallback, &str);
+  threader->SingleMethodExecute();
+  threader->SetNumberOfThreads(previousNumberOfThreads);
+
+  // Merge the results of the tiles in a fixed order.
+  double        rms_change_accumulator = 0.0;
+  SizeValueType counter = 0;
+  for ( SizeValueType t = 0; t < m_Tiles.size(); ++t )
+    {
+    rms_change_accumulator += m_Tiles[t].RMSChangeAccumulator;
+    counter += m_Tiles[t].NumberOfUpdatedNodes;
+    if ( m_Tiles[t].BoundaryReached )
+      {
+      m_BoundsCheckingActive = true;
+      }
+    }
+
+  if ( counter == 0 )
+    {
+    this->SetRMSChange( static_cast< double >( m_ValueZero ) );
+    }
+  else
+    {
+    this->SetRMSChange( std::sqrt( rms_change_accumulator / static_cast< double >( counter ) ) );
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+ITK_THREAD_RETURN_TYPE
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::TiledApplyUpdateThreaderCallback(void *arg)
+{
+  TiledEvolutionStruct *str = (TiledEvolutionStruct *)
+                              ( ( (MultiThreader::ThreadInfoStruct *)( arg ) )->UserData );
+  Self *filter = str->Filter;
+
+  NeighborhoodIterator< OutputImageType >
+  outputIt( filter->m_NeighborList.GetRadius(), filter->m_OutputImage,
+            filter->m_OutputImage->GetRequestedRegion() );
+  NeighborhoodIterator< StatusImageType >
+  statusIt( filter->m_NeighborList.GetRadius(), filter->m_StatusImage,
+            filter->m_OutputImage->GetRequestedRegion() );
+  if ( filter->m_BoundsCheckingActive == false )
+    {
+    outputIt.NeedToUseBoundaryConditionOff();
+    statusIt.NeedToUseBoundaryConditionOff();
+    }
+
+  const StatusType numberOfLayers = static_cast< StatusType >( filter->m_Layers.size() );
+  unsigned int     phase = 0;
+  SizeValueType    tileIndex;
+
+  // Update the active layer.
+  while ( filter->GetNextTile(str, phase, tileIndex) )
+    {
+    filter->ThreadedUpdateActiveLayerValues(tileIndex, str->TimeStep);
+    }
+  str->PhaseBarrier->Wait();
+  ++phase;
+
+  while ( filter->GetNextTile(str, phase, tileIndex) )
+    {
+    filter->ThreadedPostActiveLayerMoves(tileIndex, statusIt);
+    }
+  str->PhaseBarrier->Wait();
+  ++phase;
+
+  while ( filter->GetNextTile(str, phase, tileIndex) )
+    {
+    filter->ThreadedMoveActiveLayerNodes(tileIndex);
+    }
+  str->PhaseBarrier->Wait();
+  ++phase;
+
+  // Process the status lists outwards from the active layer, as in
+  // ApplyUpdate().
+  StatusType changeToStatus[2] = { 0, 0 };
+  StatusType searchForStatus[2] = { 3, 4 };
+  for (;; )
+    {
+    const bool outermost = searchForStatus[1] >= numberOfLayers;
+    if ( outermost )
+      {
+      searchForStatus[0] = searchForStatus[1] = filter->m_StatusNull;
+      }
+
+    while ( filter->GetNextTile(str, phase, tileIndex) )
+      {
+      filter->ThreadedPostStatusListNeighbors(tileIndex, searchForStatus, statusIt);
+      }
+    str->PhaseBarrier->Wait();
+    ++phase;
+
+    while ( filter->GetNextTile(str, phase, tileIndex) )
+      {
+      filter->ThreadedProcessStatusLists(tileIndex, changeToStatus, searchForStatus, outermost);
+      }
+    str->PhaseBarrier->Wait();
+    ++phase;
+
+    if ( outermost )
+      {
+      break;
+      }
+
+    if ( changeToStatus[0] == 0 ) { changeToStatus[0] += 1; }
+    else { changeToStatus[0] += 2; }
+    changeToStatus[1] += 2;
+
+    searchForStatus[0] += 2;
+    searchForStatus[1] += 2;
+    }
+
+  // Update the values of the layers, one distance from the active layer
+  // at a time.
+  for ( unsigned int distance = 1; static_cast< StatusType >( 2 * distance ) < numberOfLayers; ++distance )
+    {
+    while ( filter->GetNextTile(str, phase, tileIndex) )
+      {
+      filter->ThreadedPropagateLayerValues(tileIndex, distance, outputIt, statusIt);
+      }
+    str->PhaseBarrier->Wait();
+    ++phase;
+
+    while ( filter->GetNextTile(str, phase, tileIndex) )
+      {
+      filter->ThreadedPromoteLayerNodes(tileIndex, distance);
+      }
+    str->PhaseBarrier->Wait();
+    ++phase;
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::ThreadedUpdateActiveLayerValues(SizeValueType tileIndex, const TimeStepType & dt)
+{
+  const ValueType LOWER_ACTIVE_THRESHOLD = -( m_ConstantGradientValue / 2.0 );
+  const ValueType UPPER_ACTIVE_THRESHOLD =    m_ConstantGradientValue / 2.0;
+
+  TileType &                       tile = m_Tiles[tileIndex];
+  const std::vector< IndexType > & activeLayer = tile.Layers[0];
+
+  // Replace the changes by the new values, and mark the nodes which leave
+  // the active layer.  The marks are read by the neighbors of the nodes in
+  // the next phase.
+  tile.Moves.resize( activeLayer.size() );
+  for ( SizeValueType k = 0; k < activeLayer.size(); ++k )
+    {
+    const ValueType new_value = this->CalculateUpdateValue(activeLayer[k], dt,
+                                                           this->m_OutputImage->GetPixel(activeLayer[k]),
+                                                           tile.UpdateBuffer[k]);
+    tile.UpdateBuffer[k] = new_value;
+
+    if ( new_value >= UPPER_ACTIVE_THRESHOLD )
+      {
+      tile.Moves[k] = m_StatusActiveChangingUp;
+      }
+    else if ( new_value < LOWER_ACTIVE_THRESHOLD )
+      {
+      tile.Moves[k] = m_StatusActiveChangingDown;
+      }
+    else
+      {
+      tile.Moves[k] = 0;
+      continue;
+      }
+    m_StatusImage->SetPixel(activeLayer[k], tile.Moves[k]);
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::ThreadedPostActiveLayerMoves(SizeValueType tileIndex, NeighborhoodIterator< StatusImageType > & statusIt)
+{
+  TileType &                       tile = m_Tiles[tileIndex];
+  const std::vector< IndexType > & activeLayer = tile.Layers[0];
+  const typename OutputImageType::RegionType region = this->m_OutputImage->GetRequestedRegion();
+
+  tile.RMSChangeAccumulator = 0.0;
+  tile.NumberOfUpdatedNodes = 0;
+  tile.BoundaryReached = false;
+  for ( unsigned int c = 0; c < 2; ++c )
+    {
+    for ( unsigned int box = 0; box < tile.Outboxes[c].size(); ++box )
+      {
+      tile.Outboxes[c][box].clear();
+      }
+    }
+
+  for ( SizeValueType k = 0; k < activeLayer.size(); ++k )
+    {
+    const StatusType move = tile.Moves[k];
+    if ( move != 0 )
+      {
+      // A node does not move next to a node moving in the opposite
+      // direction, which would leave a hole in the active layer.  Unlike
+      // UpdateActiveLayerValues(), both nodes stay, so that the result
+      // does not depend on the order of the nodes.
+      const StatusType opposite = ( move == m_StatusActiveChangingUp )
+                                  ? m_StatusActiveChangingDown : m_StatusActiveChangingUp;
+      statusIt.SetLocation(activeLayer[k]);
+      bool blocked = false;
+      for ( unsigned int i = 0; i < m_NeighborList.GetSize(); ++i )
+        {
+        if ( statusIt.GetPixel( m_NeighborList.GetArrayIndex(i) ) == opposite )
+          {
+          blocked = true;
+          break;
+          }
+        }
+      if ( blocked )
+        {
+        tile.Moves[k] = m_StatusChanging;
+        continue;
+        }
+      }
+
+    const ValueType new_value = tile.UpdateBuffer[k];
+    tile.RMSChangeAccumulator += itk::Math::sqr( new_value - this->m_OutputImage->GetPixel(activeLayer[k]) );
+    ++tile.NumberOfUpdatedNodes;
+    if ( move == 0 )
+      {
+      continue;
+      }
+
+    // Post the first layer neighbors on the side of the move, which join
+    // the active layer, with the value they take from this node.
+    const unsigned int chain = ( move == m_StatusActiveChangingUp ) ? 0 : 1;
+    const StatusType   searchForStatus = ( chain == 0 ) ? 1 : 2;
+    const ValueType    value = ( chain == 0 ) ? new_value - m_ConstantGradientValue
+                                              : new_value + m_ConstantGradientValue;
+    for ( unsigned int i = 0; i < m_NeighborList.GetSize(); ++i )
+      {
+      const StatusType neighbor_status = statusIt.GetPixel( m_NeighborList.GetArrayIndex(i) );
+      if ( neighbor_status == m_StatusBoundaryPixel )
+        {
+        tile.BoundaryReached = true;
+        }
+      if ( neighbor_status == searchForStatus )
+        {
+        const IndexType index = activeLayer[k] + m_NeighborList.GetNeighborhoodOffset(i);
+        if ( m_BoundsCheckingActive && !region.IsInside(index) )
+          {
+          continue;
+          }
+        this->PostNode(tileIndex, chain, i, index, value);
+        }
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::ThreadedMoveActiveLayerNodes(SizeValueType tileIndex)
+{
+  TileType &                 tile = m_Tiles[tileIndex];
+  std::vector< IndexType > & activeLayer = tile.Layers[0];
+
+  SizeValueType kept = 0;
+  for ( SizeValueType k = 0; k < activeLayer.size(); ++k )
+    {
+    const IndexType & index = activeLayer[k];
+    if ( tile.Moves[k] == 0 )
+      {
+      this->m_OutputImage->SetPixel(index, tile.UpdateBuffer[k]);
+      }
+    else if ( tile.Moves[k] == m_StatusChanging )
+      {
+      m_StatusImage->SetPixel(index, 0);
+      }
+    else
+      {
+      const StatusType layer = ( tile.Moves[k] == m_StatusActiveChangingUp ) ? 2 : 1;
+      m_StatusImage->SetPixel(index, layer);
+      tile.Layers[layer].push_back(index);
+      continue;
+      }
+    activeLayer[kept++] = index;
+    }
+  activeLayer.resize(kept);
+
+  this->ReceiveNodes(tileIndex, 0, 1, m_StatusChanging, true);
+  this->ReceiveNodes(tileIndex, 1, 2, m_StatusChanging, true);
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::ThreadedPostStatusListNeighbors(SizeValueType tileIndex, const StatusType searchForStatus[2],
+                                  NeighborhoodIterator< StatusImageType > & statusIt)
+{
+  TileType & tile = m_Tiles[tileIndex];
+  const typename OutputImageType::RegionType region = this->m_OutputImage->GetRequestedRegion();
+
+  for ( unsigned int c = 0; c < 2; ++c )
+    {
+    for ( unsigned int box = 0; box < tile.Outboxes[c].size(); ++box )
+      {
+      tile.Outboxes[c][box].clear();
+      }
+
+    const std::vector< IndexType > & statusList = tile.StatusLists[c];
+    for ( SizeValueType k = 0; k < statusList.size(); ++k )
+      {
+      statusIt.SetLocation(statusList[k]);
+      for ( unsigned int i = 0; i < m_NeighborList.GetSize(); ++i )
+        {
+        const StatusType neighbor_status = statusIt.GetPixel( m_NeighborList.GetArrayIndex(i) );
+        if ( neighbor_status == m_StatusBoundaryPixel )
+          {
+          tile.BoundaryReached = true;
+          }
+        if ( neighbor_status == searchForStatus[c] )
+          {
+          const IndexType index = statusList[k] + m_NeighborList.GetNeighborhoodOffset(i);
+          if ( m_BoundsCheckingActive && !region.IsInside(index) )
+            {
+            continue;
+            }
+          this->PostNode(tileIndex, c, i, index, m_ValueZero);
+          }
+        }
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::ThreadedProcessStatusLists(SizeValueType tileIndex, const StatusType changeToStatus[2],
+                             const StatusType searchForStatus[2], bool outermost)
+{
+  TileType &       tile = m_Tiles[tileIndex];
+  const StatusType numberOfLayers = static_cast< StatusType >( m_Layers.size() );
+
+  for ( unsigned int c = 0; c < 2; ++c )
+    {
+    std::vector< IndexType > & statusList = tile.StatusLists[c];
+    for ( SizeValueType k = 0; k < statusList.size(); ++k )
+      {
+      m_StatusImage->SetPixel(statusList[k], changeToStatus[c]);
+      tile.Layers[changeToStatus[c]].push_back(statusList[k]);
+      }
+    statusList.clear();
+    }
+
+  // The nodes found beyond the outermost layers are brought into them, as
+  // in ProcessOutsideList().
+  for ( unsigned int c = 0; c < 2; ++c )
+    {
+    const StatusType to = outermost ? static_cast< StatusType >( numberOfLayers - 2 + c ) : m_StatusChanging;
+    this->ReceiveNodes(tileIndex, c, searchForStatus[c], to, false);
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::ThreadedPropagateLayerValues(SizeValueType tileIndex, unsigned int distance,
+                               NeighborhoodIterator< OutputImageType > & outputIt,
+                               NeighborhoodIterator< StatusImageType > & statusIt)
+{
+  TileType & tile = m_Tiles[tileIndex];
+
+  // The inside layer is odd, the outside layer even.  The nodes which
+  // have no neighbor in the layer closer to the active layer are promoted
+  // in the next phase, since their status is read by the neighboring tiles
+  // in this phase.
+  for ( unsigned int side = 0; side < 2; ++side )
+    {
+    const StatusType to = static_cast< StatusType >( 2 * distance - 1 + side );
+    const StatusType from = ( distance == 1 ) ? 0 : static_cast< StatusType >( to - 2 );
+    const ValueType  delta = ( side == 0 ) ? -m_ConstantGradientValue : m_ConstantGradientValue;
+
+    std::vector< IndexType > & layer = tile.Layers[to];
+    tile.Promotions[side].clear();
+
+    SizeValueType kept = 0;
+    for ( SizeValueType k = 0; k < layer.size(); ++k )
+      {
+      const IndexType index = layer[k];
+      statusIt.SetLocation(index);
+
+      // Drop the nodes which have moved to another layer.
+      if ( statusIt.GetCenterPixel() != to )
+        {
+        continue;
+        }
+
+      outputIt.SetLocation(index);
+
+      bool      found_neighbor_flag = false;
+      ValueType value = NumericTraits< ValueType >::ZeroValue();
+      for ( unsigned int i = 0; i < m_NeighborList.GetSize(); ++i )
+        {
+        if ( statusIt.GetPixel( m_NeighborList.GetArrayIndex(i) ) == from )
+          {
+          const ValueType value_temp = outputIt.GetPixel( m_NeighborList.GetArrayIndex(i) );
+          if ( found_neighbor_flag == false
+               || ( side == 0 && value_temp > value )
+               || ( side == 1 && value_temp < value ) )
+            {
+            value = value_temp;
+            }
+          found_neighbor_flag = true;
+          }
+        }
+
+      if ( found_neighbor_flag == true )
+        {
+        outputIt.SetCenterPixel(value + delta);
+        layer[kept++] = index;
+        }
+      else
+        {
+        tile.Promotions[side].push_back(index);
+        }
+      }
+    layer.resize(kept);
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::ThreadedPromoteLayerNodes(SizeValueType tileIndex, unsigned int distance)
+{
+  TileType &       tile = m_Tiles[tileIndex];
+  const StatusType past_end = static_cast< StatusType >( m_Layers.size() ) - 1;
+
+  for ( unsigned int side = 0; side < 2; ++side )
+    {
+    const StatusType to = static_cast< StatusType >( 2 * distance - 1 + side );
+    const StatusType promote = to + 2;
+
+    const std::vector< IndexType > & promotions = tile.Promotions[side];
+    for ( SizeValueType k = 0; k < promotions.size(); ++k )
+      {
+      // A node listed twice in the layer is promoted once.
+      if ( m_StatusImage->GetPixel(promotions[k]) != to )
+        {
+        continue;
+        }
+      if ( promote > past_end )
+        {
+        m_StatusImage->SetPixel(promotions[k], m_StatusNull);
+        }
+      else
+        {
+        m_StatusImage->SetPixel(promotions[k], promote);
+        tile.Layers[promote].push_back(promotions[k]);
+        }
+      }
+    }
+}
+
 template< typename TInputImage, typename TOutputImage >
 void
 SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
@@ -1205,6 +2043,9 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
     }
   os << indent << "m_UpdateBuffer: size=" << static_cast< SizeValueType >( m_UpdateBuffer.size() )
      << " capacity=" << static_cast< SizeValueType >( m_UpdateBuffer.capacity() ) << std::endl;
+  os << indent << "m_UseTiledEvolution: " << m_UseTiledEvolution << std::endl;
+  os << indent << "m_TileSize: " << m_TileSize << std::endl;
+  os << indent << "Number of tiles: " << static_cast< SizeValueType >( m_Tiles.size() ) << std::endl;
 }
 } // end namespace itk
 
@@ -0,0 +1,184 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkExtensionVelocitiesImageFilter.h"
+#include "itkImageDuplicator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+typedef itk::Image< float, 3 > ImageType;
+
+// Run the filter with fast marching, then with fast sweeping on one and on
+// three threads, and compare the level sets, the velocities and the output
+// narrow bands.
+template< typename TFilter >
+bool
+CompareWithFastMarching( TFilter *filter, unsigned int numberOfOutputs )
+{
+  typedef itk::ImageDuplicator< ImageType > DuplicatorType;
+  typedef typename TFilter::NodeContainer   NodeContainer;
+
+  filter->UseFastSweepingOff();
+  filter->Update();
+
+  std::vector< ImageType::Pointer > references;
+  for ( unsigned int k = 0; k < numberOfOutputs; ++k )
+    {
+    typename DuplicatorType::Pointer duplicator = DuplicatorType::New();
+    duplicator->SetInputImage( static_cast< ImageType * >( filter->GetOutputs()[k].GetPointer() ) );
+    duplicator->Update();
+    references.push_back( duplicator->GetOutput() );
+    }
+  typename NodeContainer::Pointer referenceBand = filter->GetOutputNarrowBand();
+
+  filter->UseFastSweepingOn();
+  for ( itk::ThreadIdType numberOfThreads = 1; numberOfThreads <= 3; numberOfThreads += 2 )
+    {
+    filter->SetNumberOfThreads(numberOfThreads);
+    filter->Update();
+
+    for ( unsigned int k = 0; k < numberOfOutputs; ++k )
+      {
+      ImageType *output = static_cast< ImageType * >( filter->GetOutputs()[k].GetPointer() );
+      double     maximumDifference = 0.0;
+      itk::ImageRegionConstIterator< ImageType > referenceIt( references[k], references[k]->GetBufferedRegion() );
+      itk::ImageRegionConstIterator< ImageType > outputIt( output, output->GetBufferedRegion() );
+      for (; !outputIt.IsAtEnd(); ++outputIt, ++referenceIt )
+        {
+        maximumDifference = std::max( maximumDifference,
+                                      static_cast< double >( itk::Math::abs( outputIt.Get() - referenceIt.Get() ) ) );
+        }
+      std::cout << "  " << numberOfThreads << " threads, output " << k
+                << ": largest difference with fast marching " << maximumDifference << std::endl;
+      if ( maximumDifference > 1e-4 )
+        {
+        std::cerr << "Output " << k << " differs from fast marching." << std::endl;
+        return false;
+        }
+      }
+
+    if ( referenceBand )
+      {
+      typename NodeContainer::Pointer band = filter->GetOutputNarrowBand();
+      std::cout << "  " << band->Size() << " points in the output narrow band, "
+                << referenceBand->Size() << " with fast marching" << std::endl;
+      if ( band->Size() != referenceBand->Size() )
+        {
+        std::cerr << "The output narrow band differs from fast marching." << std::endl;
+        return false;
+        }
+      for ( typename NodeContainer::ConstIterator it = band->Begin(); it != band->End(); ++it )
+        {
+        if ( itk::Math::abs( it.Value().GetValue() - references[0]->GetPixel( it.Value().GetIndex() ) ) > 1e-4 )
+          {
+          std::cerr << "The output narrow band at " << it.Value().GetIndex() << " differs from fast marching."
+                    << std::endl;
+          return false;
+          }
+        }
+      }
+    }
+
+  return true;
+}
+}
+
+// Reinitialize two overlapping spheres scaled by a varying factor, and
+// extend a velocity from them, with the distances computed by fast sweeping.
+int itkReinitializeLevelSetImageFilterFastSweepingTest(int, char *[])
+{
+  ImageType::SizeType size;
+  size[0] = 48;
+  size[1] = 40;
+  size[2] = 36;
+
+  ImageType::Pointer levelSet = ImageType::New();
+  levelSet->SetRegions(size);
+  levelSet->Allocate();
+
+  ImageType::Pointer velocity = ImageType::New();
+  velocity->SetRegions(size);
+  velocity->Allocate();
+
+  for ( itk::ImageRegionIteratorWithIndex< ImageType > it( levelSet, levelSet->GetBufferedRegion() );
+        !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    const double distance1 = std::sqrt( itk::Math::sqr(index[0] - 18.2) + itk::Math::sqr(index[1] - 20.4)
+                                        + itk::Math::sqr(index[2] - 17.0) ) - 9.3;
+    const double distance2 = std::sqrt( itk::Math::sqr(index[0] - 29.7) + itk::Math::sqr(index[1] - 18.1)
+                                        + itk::Math::sqr(index[2] - 19.6) ) - 7.8;
+    it.Set( std::min(distance1, distance2) * ( 0.6 + 0.01 * index[0] ) );
+    velocity->SetPixel( index, std::sin(0.2 * index[0]) + std::cos(0.3 * index[1]) - 0.05 * index[2] );
+    }
+
+  typedef itk::ReinitializeLevelSetImageFilter< ImageType > ReinitializerType;
+  ReinitializerType::Pointer reinitializer = ReinitializerType::New();
+  reinitializer->SetInput(levelSet);
+
+  TEST_SET_GET_VALUE( false, reinitializer->GetUseFastSweeping() );
+
+  std::cout << "Reinitialize the level set:" << std::endl;
+  if ( !CompareWithFastMarching( reinitializer.GetPointer(), 1 ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Reinitialize the level set in a narrow band:" << std::endl;
+  reinitializer->NarrowBandingOn();
+  reinitializer->SetNarrowBandwidth(8.0);
+  if ( !CompareWithFastMarching( reinitializer.GetPointer(), 1 ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Reinitialize the level set in the narrow band of the previous level set:" << std::endl;
+  ReinitializerType::NodeContainerPointer inputBand = reinitializer->GetOutputNarrowBand();
+  ImageType::Pointer reinitialized = reinitializer->GetOutput();
+  reinitialized->DisconnectPipeline();
+  reinitializer->SetInput(reinitialized);
+  reinitializer->SetInputNarrowBand(inputBand);
+  if ( !CompareWithFastMarching( reinitializer.GetPointer(), 1 ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  typedef itk::ExtensionVelocitiesImageFilter< ImageType, float, 1 > ExtensionType;
+  ExtensionType::Pointer extension = ExtensionType::New();
+  extension->SetInput(levelSet);
+  extension->SetInputVelocityImage(velocity, 0);
+
+  std::cout << "Extend the velocity:" << std::endl;
+  if ( !CompareWithFastMarching( extension.GetPointer(), 2 ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Extend the velocity in a narrow band:" << std::endl;
+  extension->NarrowBandingOn();
+  extension->SetNarrowBandwidth(8.0);
+  if ( !CompareWithFastMarching( extension.GetPointer(), 2 ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
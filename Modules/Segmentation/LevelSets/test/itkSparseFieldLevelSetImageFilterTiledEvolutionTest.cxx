@@ -0,0 +1,288 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkThresholdSegmentationLevelSetImageFilter.h"
+#include "itkGeodesicActiveContourShapePriorLevelSetImageFilter.h"
+#include "itkIsotropicFourthOrderLevelSetImageFilter.h"
+#include "itkSphereSignedDistanceFunction.h"
+#include "itkAmoebaOptimizer.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+// Run the evolution of the layer lists, then the tiled evolution with tiles
+// of 32 and of 5 pixels, on one and on three threads. The tiled evolution
+// must not depend on the number of threads, and must segment the same
+// region as the evolution of the layer lists. It only differs from it by
+// the resolution of opposite moves and by the time step.
+template< typename TFilter >
+bool
+CompareTiledEvolution( TFilter *filter, unsigned int numberOfIterations )
+{
+  typedef typename TFilter::OutputImageType ImageType;
+
+  const typename ImageType::RegionType region = filter->GetInput()->GetLargestPossibleRegion();
+
+  filter->UseTiledEvolutionOff();
+  filter->SetNumberOfThreads(1);
+  filter->Update();
+  typename ImageType::Pointer reference = filter->GetOutput();
+  reference->DisconnectPipeline();
+
+  filter->UseTiledEvolutionOn();
+  const itk::SizeValueType tileSizes[2] = { 32, 5 };
+  for ( unsigned int s = 0; s < 2; ++s )
+    {
+    filter->SetTileSize(tileSizes[s]);
+
+    typename ImageType::Pointer singleThreaded;
+    for ( itk::ThreadIdType numberOfThreads = 1; numberOfThreads <= 3; numberOfThreads += 2 )
+      {
+      // The tiles may use fewer threads than the filter, but must leave the
+      // number of threads of its threader unchanged
+      filter->SetNumberOfThreads(numberOfThreads);
+      filter->GetMultiThreader()->SetNumberOfThreads(7);
+      filter->Update();
+      if ( filter->GetMultiThreader()->GetNumberOfThreads() != 7 )
+        {
+        std::cerr << "The tiled evolution changed the number of threads of the threader to "
+                  << filter->GetMultiThreader()->GetNumberOfThreads() << std::endl;
+        return false;
+        }
+
+      std::cout << "  Tile size " << tileSizes[s] << ", " << numberOfThreads << " threads: RMS change "
+                << filter->GetRMSChange() << std::endl;
+
+      if ( filter->GetElapsedIterations() != numberOfIterations )
+        {
+        std::cerr << "The tiled evolution stopped after " << filter->GetElapsedIterations()
+                  << " iterations instead of " << numberOfIterations << std::endl;
+        return false;
+        }
+
+      typename ImageType::Pointer output = filter->GetOutput();
+      if ( numberOfThreads == 1 )
+        {
+        singleThreaded = output;
+        singleThreaded->DisconnectPipeline();
+        continue;
+        }
+
+      itk::SizeValueType differentValues = 0;
+      itk::SizeValueType differentSigns = 0;
+      itk::ImageRegionConstIterator< ImageType > referenceIt( reference, region );
+      itk::ImageRegionConstIterator< ImageType > singleThreadedIt( singleThreaded, region );
+      itk::ImageRegionConstIterator< ImageType > outputIt( output, region );
+      for (; !outputIt.IsAtEnd(); ++outputIt, ++singleThreadedIt, ++referenceIt )
+        {
+        if ( itk::Math::NotExactlyEquals( outputIt.Get(), singleThreadedIt.Get() ) )
+          {
+          ++differentValues;
+          }
+        if ( ( outputIt.Get() < 0.0f ) != ( referenceIt.Get() < 0.0f ) )
+          {
+          ++differentSigns;
+          }
+        }
+
+      std::cout << "  " << differentSigns << " pixels segmented differently by the layer lists" << std::endl;
+
+      if ( differentValues > 0 )
+        {
+        std::cerr << differentValues << " pixels differ between 1 and " << numberOfThreads << " threads." << std::endl;
+        return false;
+        }
+      if ( differentSigns > region.GetNumberOfPixels() / 1000 )
+        {
+        std::cerr << "The tiled evolution differs from the evolution of the layer lists." << std::endl;
+        return false;
+        }
+      }
+    }
+
+  return true;
+}
+}
+
+// A sphere grows into a diamond, as in
+// itkThresholdSegmentationLevelSetImageFilterTest, then the filters that
+// read the layers of the sparse field evolve in tiles.
+int itkSparseFieldLevelSetImageFilterTiledEvolutionTest(int, char *[])
+{
+  const unsigned int Dimension = 3;
+  const int          Size = 64;
+
+  typedef itk::Image< float, Dimension >                                            ImageType;
+  typedef itk::Image< char, Dimension >                                             SeedImageType;
+  typedef itk::ThresholdSegmentationLevelSetImageFilter< SeedImageType, ImageType > FilterType;
+
+  ImageType::SizeType size;
+  size.Fill(Size);
+  ImageType::RegionType region;
+  region.SetSize(size);
+
+  SeedImageType::Pointer seedImage = SeedImageType::New();
+  seedImage->SetRegions(region);
+  seedImage->Allocate();
+  ImageType::Pointer featureImage = ImageType::New();
+  featureImage->SetRegions(region);
+  featureImage->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< SeedImageType > seedIt( seedImage, region );
+  itk::ImageRegionIteratorWithIndex< ImageType >     featureIt( featureImage, region );
+  for (; !seedIt.IsAtEnd(); ++seedIt, ++featureIt )
+    {
+    float distance = 0.0f;
+    float diamond = 0.0f;
+    for ( unsigned int i = 0; i < Dimension; ++i )
+      {
+      const float x = ( seedIt.GetIndex()[i] - Size / 2.0f ) / ( 0.2f * Size );
+      distance += x * x;
+      diamond += seedIt.GetIndex()[i] < Size / 2 ? seedIt.GetIndex()[i] : Size - seedIt.GetIndex()[i];
+      }
+    seedIt.Set(distance <= 1.0f ? 1 : 0);
+    featureIt.Set(diamond);
+    }
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(seedImage);
+  filter->SetFeatureImage(featureImage);
+  filter->SetUpperThreshold(63);
+  filter->SetLowerThreshold(50);
+  filter->SetMaximumRMSError(0.0);
+  filter->SetNumberOfIterations(40);
+  filter->ReverseExpansionDirectionOn();
+  filter->SetIsoSurfaceValue(0.5);
+
+  TEST_SET_GET_VALUE( false, filter->GetUseTiledEvolution() );
+  TEST_SET_GET_VALUE( 32, filter->GetTileSize() );
+  filter->UseTiledEvolutionOn();
+  TEST_SET_GET_VALUE( true, filter->GetUseTiledEvolution() );
+  filter->SetTileSize(5);
+  TEST_SET_GET_VALUE( 5, filter->GetTileSize() );
+
+  std::cout << "Threshold segmentation:" << std::endl;
+  if ( !CompareTiledEvolution( filter.GetPointer(), 40 ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // The shape prior is fitted to the layers gathered from the tiles, as in
+  // itkGeodesicActiveContourShapePriorLevelSetImageFilterTest: a circle is
+  // segmented from a bright disc crossed by a bar.
+  typedef itk::Image< float, 2 >                                                          ImageType2D;
+  typedef itk::GeodesicActiveContourShapePriorLevelSetImageFilter< ImageType2D, ImageType2D > ShapePriorFilterType;
+  typedef itk::SphereSignedDistanceFunction< double, 2 >                                  ShapeFunctionType;
+  typedef itk::ShapePriorMAPCostFunction< ImageType2D, float >                            CostFunctionType;
+  typedef itk::AmoebaOptimizer                                                            OptimizerType;
+
+  ImageType2D::SizeType size2D;
+  size2D.Fill(64);
+  ImageType2D::RegionType region2D;
+  region2D.SetSize(size2D);
+
+  ImageType2D::Pointer initialLevelSet = ImageType2D::New();
+  initialLevelSet->SetRegions(region2D);
+  initialLevelSet->Allocate();
+  ImageType2D::Pointer edgePotential = ImageType2D::New();
+  edgePotential->SetRegions(region2D);
+  edgePotential->Allocate();
+
+  for ( itk::ImageRegionIteratorWithIndex< ImageType2D > it( initialLevelSet, region2D ); !it.IsAtEnd(); ++it )
+    {
+    const ImageType2D::IndexType & index = it.GetIndex();
+    it.Set( std::sqrt( itk::Math::sqr(index[0] - 23.0) + itk::Math::sqr(index[1] - 23.0) ) - 5.0 );
+    const double disc = std::sqrt( itk::Math::sqr(index[0] - 25.0) + itk::Math::sqr(index[1] - 28.5) ) - 15.0;
+    const double bar = std::max( std::abs(index[0] - 24.5) - 20.0, std::abs(index[1] - 27.0) - 2.5 );
+    const double edge = std::min( std::abs(disc), std::abs(bar) );
+    edgePotential->SetPixel( index, 1.0 - std::exp( -0.5 * edge * edge ) );
+    }
+
+  ShapeFunctionType::Pointer shape = ShapeFunctionType::New();
+  shape->Initialize();
+
+  CostFunctionType::Pointer   costFunction = CostFunctionType::New();
+  CostFunctionType::ArrayType mean( shape->GetNumberOfShapeParameters() );
+  CostFunctionType::ArrayType stddev( shape->GetNumberOfShapeParameters() );
+  mean[0] = 12.5;
+  stddev[0] = 1.5;
+  costFunction->SetShapeParameterMeans(mean);
+  costFunction->SetShapeParameterStandardDeviations(stddev);
+  CostFunctionType::WeightsType weights;
+  weights.Fill(1.0);
+  weights[1] = 10.0;
+  costFunction->SetWeights(weights);
+
+  OptimizerType::Pointer optimizer = OptimizerType::New();
+  optimizer->SetFunctionConvergenceTolerance(0.1);
+  optimizer->SetParametersConvergenceTolerance(0.5);
+  optimizer->SetMaximumNumberOfIterations(50);
+
+  ShapePriorFilterType::ParametersType parameters( shape->GetNumberOfParameters() );
+  parameters[0] = mean[0];
+  parameters[1] = 32;
+  parameters[2] = 32;
+
+  ShapePriorFilterType::Pointer shapePriorFilter = ShapePriorFilterType::New();
+  shapePriorFilter->SetInput(initialLevelSet);
+  shapePriorFilter->SetFeatureImage(edgePotential);
+  shapePriorFilter->SetShapeFunction(shape);
+  shapePriorFilter->SetCostFunction(costFunction);
+  shapePriorFilter->SetOptimizer(optimizer);
+  shapePriorFilter->SetInitialParameters(parameters);
+  shapePriorFilter->SetPropagationScaling(0.5);
+  shapePriorFilter->SetAdvectionScaling(1.0);
+  shapePriorFilter->SetCurvatureScaling(1.0);
+  shapePriorFilter->SetShapePriorScaling(0.1);
+  shapePriorFilter->SetNumberOfLayers(4);
+  shapePriorFilter->SetMaximumRMSError(0.0);
+  shapePriorFilter->SetNumberOfIterations(60);
+
+  std::cout << "Geodesic active contour with a shape prior:" << std::endl;
+  if ( !CompareTiledEvolution( shapePriorFilter.GetPointer(), 60 ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // The fourth order filter checks that the active layer gathered from the
+  // tiles stays in the band of the processed normals.
+  typedef itk::IsotropicFourthOrderLevelSetImageFilter< ImageType2D, ImageType2D > FourthOrderFilterType;
+
+  ImageType2D::Pointer square = ImageType2D::New();
+  square->SetRegions(region2D);
+  square->Allocate();
+  for ( itk::ImageRegionIteratorWithIndex< ImageType2D > it( square, region2D ); !it.IsAtEnd(); ++it )
+    {
+    const ImageType2D::IndexType & index = it.GetIndex();
+    it.Set( index[0] >= 16 && index[0] <= 48 && index[1] >= 16 && index[1] <= 48 ? -1.0f : 1.0f );
+    }
+
+  FourthOrderFilterType::Pointer fourthOrderFilter = FourthOrderFilterType::New();
+  fourthOrderFilter->SetInput(square);
+  fourthOrderFilter->SetMaxFilterIteration(50);
+
+  std::cout << "Isotropic fourth order smoothing:" << std::endl;
+  if ( !CompareTiledEvolution( fourthOrderFilter.GetPointer(), 50 ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -26,6 +26,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 namespace itk
 {
@@ -118,6 +119,23 @@ public:
   LevelSetOutputRealType Evaluate( const LevelSetInputIndexType& iP,
                                    const LevelSetDataType& iData );
 
+  typedef std::vector< LevelSetOutputRealType > CFLContributionArrayType;
+
+  /** Evaluate the term at a given pixel location, and keep the largest
+   * absolute values of the terms in ioContributions, in the order of the
+   * terms, instead of in the container. Several threads can then evaluate
+   * the container, each one with its own contributions. */
+  LevelSetOutputRealType Evaluate( const LevelSetInputIndexType& iP,
+                                   CFLContributionArrayType& ioContributions );
+
+  LevelSetOutputRealType Evaluate( const LevelSetInputIndexType& iP,
+                                   const LevelSetDataType& iData,
+                                   CFLContributionArrayType& ioContributions );
+
+  /** Merge the contributions gathered by Evaluate into the ones of the
+   * container */
+  void UpdateCFLContributions( const CFLContributionArrayType& iContributions );
+
   /** Update the term parameters at end of iteration */
   void Update();
 
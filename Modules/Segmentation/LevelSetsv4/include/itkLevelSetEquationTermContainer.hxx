@@ -331,6 +331,80 @@ LevelSetEquationTermContainer< TInputImage, TLevelSetContainer >
   return oValue;
 }
 
+// ----------------------------------------------------------------------------
+template< typename TInputImage, typename TLevelSetContainer >
+typename LevelSetEquationTermContainer< TInputImage, TLevelSetContainer >::LevelSetOutputRealType
+LevelSetEquationTermContainer< TInputImage, TLevelSetContainer >
+::Evaluate( const LevelSetInputIndexType& iP, CFLContributionArrayType& ioContributions )
+{
+  MapTermContainerIteratorType term_it  = m_Container.begin();
+  MapTermContainerIteratorType term_end = m_Container.end();
+
+  ioContributions.resize( m_Container.size(), NumericTraits< LevelSetOutputRealType >::ZeroValue() );
+  typename CFLContributionArrayType::iterator cfl_it = ioContributions.begin();
+
+  LevelSetOutputRealType oValue = NumericTraits< LevelSetOutputRealType >::ZeroValue();
+
+  while( term_it != term_end )
+    {
+    LevelSetOutputRealType temp_val = ( term_it->second )->Evaluate( iP );
+
+    *cfl_it = std::max( itk::Math::abs( temp_val ), *cfl_it );
+
+    oValue += temp_val;
+    ++term_it;
+    ++cfl_it;
+    }
+
+  return oValue;
+}
+
+// ----------------------------------------------------------------------------
+template< typename TInputImage, typename TLevelSetContainer >
+typename LevelSetEquationTermContainer< TInputImage, TLevelSetContainer >::LevelSetOutputRealType
+LevelSetEquationTermContainer< TInputImage, TLevelSetContainer >
+::Evaluate( const LevelSetInputIndexType& iP, const LevelSetDataType& iData,
+            CFLContributionArrayType& ioContributions )
+{
+  MapTermContainerIteratorType term_it  = m_Container.begin();
+  MapTermContainerIteratorType term_end = m_Container.end();
+
+  ioContributions.resize( m_Container.size(), NumericTraits< LevelSetOutputRealType >::ZeroValue() );
+  typename CFLContributionArrayType::iterator cfl_it = ioContributions.begin();
+
+  LevelSetOutputRealType oValue = NumericTraits< LevelSetOutputRealType >::ZeroValue();
+
+  while( term_it != term_end )
+    {
+    LevelSetOutputRealType temp_val = ( term_it->second )->Evaluate( iP, iData );
+
+    *cfl_it = std::max( itk::Math::abs( temp_val ), *cfl_it );
+
+    oValue += temp_val;
+    ++term_it;
+    ++cfl_it;
+    }
+
+  return oValue;
+}
+
+// ----------------------------------------------------------------------------
+template< typename TInputImage, typename TLevelSetContainer >
+void
+LevelSetEquationTermContainer< TInputImage, TLevelSetContainer >
+::UpdateCFLContributions( const CFLContributionArrayType& iContributions )
+{
+  MapCFLContainerIterator cfl_it = m_TermContribution.begin();
+  typename CFLContributionArrayType::const_iterator contribution_it = iContributions.begin();
+
+  while( cfl_it != m_TermContribution.end() && contribution_it != iContributions.end() )
+    {
+    cfl_it->second = std::max( *contribution_it, cfl_it->second );
+    ++cfl_it;
+    ++contribution_it;
+    }
+}
+
 // ----------------------------------------------------------------------------
 template< typename TInputImage, typename TLevelSetContainer >
 void
@@ -42,6 +42,12 @@ namespace itk
  *  \tparam TEquationContainer Container holding the system of level set of equations
  *  \tparam TLevelSet Level-set function representation (e.g. dense, sparse)
  *
+ *  The sparse level sets (Whitaker, Shi, Malcolm) are split into groups
+ *  whose domains, given by the domain map of the level set container, do
+ *  not overlap. The groups are updated one after the other, and the level
+ *  sets of a group, which are independent of each other, are updated
+ *  concurrently, each by a single thread.
+ *
  *   \ingroup ITKLevelSetsv4
  */
 template< typename TEquationContainer, typename TLevelSet >
@@ -218,6 +224,9 @@ public:
   typedef typename Superclass::CacheImageType               CacheImageType;
   typedef typename Superclass::DomainMapImageFilterType     DomainMapImageFilterType;
 
+  typedef typename Superclass::LevelSetGroupType          LevelSetGroupType;
+  typedef typename Superclass::LevelSetGroupContainerType LevelSetGroupContainerType;
+
   typedef typename Superclass::StoppingCriterionType    StoppingCriterionType;
   typedef typename Superclass::StoppingCriterionPointer StoppingCriterionPointer;
 
@@ -261,6 +270,17 @@ protected:
   typedef LevelSetEvolutionComputeIterationThreader< LevelSetType, SplitLevelSetPartitionerType, Self > SplitLevelSetComputeIterationThreaderType;
   typename SplitLevelSetComputeIterationThreaderType::Pointer m_SplitLevelSetComputeIterationThreader;
 
+  typedef ThreadedIndexedContainerPartitioner SplitLevelSetContainerPartitionerType;
+  friend class LevelSetEvolutionUpdateLevelSetsThreader< LevelSetType, SplitLevelSetContainerPartitionerType, Self >;
+  typedef LevelSetEvolutionUpdateLevelSetsThreader< LevelSetType, SplitLevelSetContainerPartitionerType, Self > SplitLevelSetContainerUpdateLevelSetsThreaderType;
+  typename SplitLevelSetContainerUpdateLevelSetsThreaderType::Pointer m_SplitLevelSetContainerUpdateLevelSetsThreader;
+
+  /** Filters updating each level set in UpdateLevelSets */
+  std::vector< UpdateLevelSetFilterPointer > m_UpdateLevelSetFilters;
+
+  /** Positions of the filters of the group updated concurrently */
+  LevelSetGroupType m_LevelSetGroupToUpdate;
+
 private:
   LevelSetEvolution( const Self& );
   void operator = ( const Self& );
@@ -324,6 +344,9 @@ public:
   typedef typename Superclass::CacheImageType               CacheImageType;
   typedef typename Superclass::DomainMapImageFilterType     DomainMapImageFilterType;
 
+  typedef typename Superclass::LevelSetGroupType          LevelSetGroupType;
+  typedef typename Superclass::LevelSetGroupContainerType LevelSetGroupContainerType;
+
   typedef typename Superclass::StoppingCriterionType    StoppingCriterionType;
   typedef typename Superclass::StoppingCriterionPointer StoppingCriterionPointer;
 
@@ -332,6 +355,11 @@ public:
   typedef UpdateShiSparseLevelSet< ImageDimension, EquationContainerType >  UpdateLevelSetFilterType;
   typedef typename UpdateLevelSetFilterType::Pointer                        UpdateLevelSetFilterPointer;
 
+  /** Set the maximum number of threads to be used. */
+  void SetNumberOfThreads( const ThreadIdType threads );
+  /** Set the maximum number of threads to be used. */
+  ThreadIdType GetNumberOfThreads() const;
+
 protected:
   LevelSetEvolution();
   ~LevelSetEvolution();
@@ -342,6 +370,17 @@ protected:
   /** Update the equations at the end of 1 iteration */
   virtual void UpdateEquations() ITK_OVERRIDE;
 
+  typedef ThreadedIndexedContainerPartitioner SplitLevelSetContainerPartitionerType;
+  friend class LevelSetEvolutionUpdateLevelSetsThreader< LevelSetType, SplitLevelSetContainerPartitionerType, Self >;
+  typedef LevelSetEvolutionUpdateLevelSetsThreader< LevelSetType, SplitLevelSetContainerPartitionerType, Self > SplitLevelSetContainerUpdateLevelSetsThreaderType;
+  typename SplitLevelSetContainerUpdateLevelSetsThreaderType::Pointer m_SplitLevelSetContainerUpdateLevelSetsThreader;
+
+  /** Filters updating each level set in UpdateLevelSets */
+  std::vector< UpdateLevelSetFilterPointer > m_UpdateLevelSetFilters;
+
+  /** Positions of the filters of the group updated concurrently */
+  LevelSetGroupType m_LevelSetGroupToUpdate;
+
 private:
   LevelSetEvolution( const Self& );
   void operator = ( const Self& );
@@ -404,6 +443,9 @@ public:
   typedef typename Superclass::CacheImageType               CacheImageType;
   typedef typename Superclass::DomainMapImageFilterType     DomainMapImageFilterType;
 
+  typedef typename Superclass::LevelSetGroupType          LevelSetGroupType;
+  typedef typename Superclass::LevelSetGroupContainerType LevelSetGroupContainerType;
+
   typedef typename Superclass::StoppingCriterionType    StoppingCriterionType;
   typedef typename Superclass::StoppingCriterionPointer StoppingCriterionPointer;
 
@@ -412,6 +454,11 @@ public:
   typedef UpdateMalcolmSparseLevelSet< ImageDimension, EquationContainerType > UpdateLevelSetFilterType;
   typedef typename UpdateLevelSetFilterType::Pointer UpdateLevelSetFilterPointer;
 
+  /** Set the maximum number of threads to be used. */
+  void SetNumberOfThreads( const ThreadIdType threads );
+  /** Set the maximum number of threads to be used. */
+  ThreadIdType GetNumberOfThreads() const;
+
 protected:
   LevelSetEvolution();
   virtual ~LevelSetEvolution();
@@ -420,6 +467,17 @@ protected:
 
   virtual void UpdateEquations() ITK_OVERRIDE;
 
+  typedef ThreadedIndexedContainerPartitioner SplitLevelSetContainerPartitionerType;
+  friend class LevelSetEvolutionUpdateLevelSetsThreader< LevelSetType, SplitLevelSetContainerPartitionerType, Self >;
+  typedef LevelSetEvolutionUpdateLevelSetsThreader< LevelSetType, SplitLevelSetContainerPartitionerType, Self > SplitLevelSetContainerUpdateLevelSetsThreaderType;
+  typename SplitLevelSetContainerUpdateLevelSetsThreaderType::Pointer m_SplitLevelSetContainerUpdateLevelSetsThreader;
+
+  /** Filters updating each level set in UpdateLevelSets */
+  std::vector< UpdateLevelSetFilterPointer > m_UpdateLevelSetFilters;
+
+  /** Positions of the filters of the group updated concurrently */
+  LevelSetGroupType m_LevelSetGroupToUpdate;
+
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(LevelSetEvolution);
 };
@@ -220,6 +220,7 @@ LevelSetEvolution< TEquationContainer, WhitakerSparseLevelSetImage< TOutput, VDi
 ::LevelSetEvolution()
 {
   this->m_SplitLevelSetComputeIterationThreader = SplitLevelSetComputeIterationThreaderType::New();
+  this->m_SplitLevelSetContainerUpdateLevelSetsThreader = SplitLevelSetContainerUpdateLevelSetsThreaderType::New();
 }
 
 template< typename TEquationContainer, typename TOutput, unsigned int VDimension >
@@ -240,6 +241,7 @@ LevelSetEvolution< TEquationContainer, WhitakerSparseLevelSetImage< TOutput, VDi
 ::SetNumberOfThreads( const ThreadIdType numberOfThreads)
 {
   this->m_SplitLevelSetComputeIterationThreader->SetMaximumNumberOfThreads( numberOfThreads );
+  this->m_SplitLevelSetContainerUpdateLevelSetsThreader->SetMaximumNumberOfThreads( numberOfThreads );
 }
 
 template< typename TEquationContainer, typename TOutput, unsigned int VDimension >
@@ -289,7 +291,7 @@ LevelSetEvolution< TEquationContainer, WhitakerSparseLevelSetImage< TOutput, VDi
   while( this->m_LevelSetContainerIteratorToProcessWhenThreading != this->m_LevelSetContainer->End() )
     {
     typename LevelSetType::ConstPointer levelSet = this->m_LevelSetContainerIteratorToProcessWhenThreading->GetLevelSet();
-    const LevelSetLayerType zeroLayer = levelSet->GetLayer( 0 );
+    const LevelSetLayerType & zeroLayer = levelSet->GetLayer( 0 );
     typename LevelSetType::LayerConstIterator layerBegin = zeroLayer.begin();
     typename LevelSetType::LayerConstIterator layerEnd = zeroLayer.end();
     typename SplitLevelSetPartitionerType::DomainType completeDomain( layerBegin, layerEnd );
@@ -339,26 +341,59 @@ void
 LevelSetEvolution< TEquationContainer, WhitakerSparseLevelSetImage< TOutput, VDimension > >
 ::UpdateLevelSets()
 {
+  this->m_UpdateLevelSetFilters.clear();
+
   typename LevelSetContainerType::Iterator it = this->m_LevelSetContainer->Begin();
   while( it != this->m_LevelSetContainer->End() )
     {
-    typename LevelSetType::Pointer levelSet = it->GetLevelSet();
-
     UpdateLevelSetFilterPointer updateLevelSet = UpdateLevelSetFilterType::New();
-    updateLevelSet->SetInputLevelSet( levelSet );
+    updateLevelSet->SetInputLevelSet( it->GetLevelSet() );
     updateLevelSet->SetUpdate( * this->m_UpdateBuffer[it->GetIdentifier()] );
     updateLevelSet->SetEquationContainer( this->m_EquationContainer );
     updateLevelSet->SetTimeStep( this->m_Dt );
     updateLevelSet->SetCurrentLevelSetId( it->GetIdentifier() );
-    updateLevelSet->Update();
-
-    levelSet->Graft( updateLevelSet->GetOutputLevelSet() );
-
-    this->m_RMSChangeAccumulator = updateLevelSet->GetRMSChangeAccumulator();
+    this->m_UpdateLevelSetFilters.push_back( updateLevelSet );
 
     this->m_UpdateBuffer[it->GetIdentifier()]->clear();
     ++it;
     }
+
+  const IndexValueType numberOfLevelSets = static_cast< IndexValueType >( this->m_UpdateLevelSetFilters.size() );
+
+  // The groups are updated in the same order whatever the number of threads
+  LevelSetGroupContainerType groups;
+  this->ComputeLevelSetGroups( groups );
+
+  for( typename LevelSetGroupContainerType::const_iterator groupIt = groups.begin(); groupIt != groups.end(); ++groupIt )
+    {
+    const IndexValueType groupSize = static_cast< IndexValueType >( groupIt->size() );
+    const bool concurrently = groupSize > 1 && this->GetNumberOfThreads() > 1;
+
+    if( concurrently )
+      {
+      this->m_LevelSetGroupToUpdate = *groupIt;
+      typename SplitLevelSetContainerUpdateLevelSetsThreaderType::DomainType completeDomain;
+      completeDomain[0] = 0;
+      completeDomain[1] = groupSize - 1;
+      this->m_SplitLevelSetContainerUpdateLevelSetsThreader->Execute( this, completeDomain );
+      }
+    else
+      {
+      for( IndexValueType ii = 0; ii < groupSize; ++ii )
+        {
+        UpdateLevelSetFilterType * updateLevelSet = this->m_UpdateLevelSetFilters[( *groupIt )[ii]];
+        updateLevelSet->Update();
+
+        updateLevelSet->GetModifiableInputLevelSet()->Graft( updateLevelSet->GetOutputLevelSet() );
+        }
+      }
+    }
+
+  for( IndexValueType ii = 0; ii < numberOfLevelSets; ++ii )
+    {
+    this->m_RMSChangeAccumulator += this->m_UpdateLevelSetFilters[ii]->GetRMSChangeAccumulator();
+    }
+  this->m_UpdateLevelSetFilters.clear();
 }
 
 template< typename TEquationContainer, typename TOutput, unsigned int VDimension >
@@ -374,6 +409,7 @@ template< typename TEquationContainer, unsigned int VDimension >
 LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension > >
 ::LevelSetEvolution()
 {
+  this->m_SplitLevelSetContainerUpdateLevelSetsThreader = SplitLevelSetContainerUpdateLevelSetsThreaderType::New();
 }
 
 template< typename TEquationContainer, unsigned int VDimension >
@@ -381,28 +417,81 @@ LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension > >
 ::~LevelSetEvolution()
 {}
 
+template< typename TEquationContainer, unsigned int VDimension >
+void
+LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension > >
+::SetNumberOfThreads( const ThreadIdType numberOfThreads )
+{
+  this->m_SplitLevelSetContainerUpdateLevelSetsThreader->SetMaximumNumberOfThreads( numberOfThreads );
+}
+
+template< typename TEquationContainer, unsigned int VDimension >
+ThreadIdType
+LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension > >
+::GetNumberOfThreads() const
+{
+  return this->m_SplitLevelSetContainerUpdateLevelSetsThreader->GetMaximumNumberOfThreads();
+}
+
 template< typename TEquationContainer, unsigned int VDimension >
 void LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension > >
 ::UpdateLevelSets()
 {
-  typename LevelSetContainerType::Iterator it = this->m_LevelSetContainer->Begin();
+  this->m_UpdateLevelSetFilters.clear();
 
+  typename LevelSetContainerType::Iterator it = this->m_LevelSetContainer->Begin();
   while( it != this->m_LevelSetContainer->End() )
     {
-    typename LevelSetType::Pointer levelSet = it->GetLevelSet();
-
     UpdateLevelSetFilterPointer updateLevelSet = UpdateLevelSetFilterType::New();
-    updateLevelSet->SetInputLevelSet( levelSet );
+    updateLevelSet->SetInputLevelSet( it->GetLevelSet() );
     updateLevelSet->SetCurrentLevelSetId( it->GetIdentifier() );
     updateLevelSet->SetEquationContainer( this->m_EquationContainer );
-    updateLevelSet->Update();
+    this->m_UpdateLevelSetFilters.push_back( updateLevelSet );
+    ++it;
+    }
 
-    levelSet->Graft( updateLevelSet->GetOutputLevelSet() );
+  const IndexValueType numberOfLevelSets = static_cast< IndexValueType >( this->m_UpdateLevelSetFilters.size() );
 
-    this->m_RMSChangeAccumulator = updateLevelSet->GetRMSChangeAccumulator();
+  // The groups are updated in the same order whatever the number of threads
+  LevelSetGroupContainerType groups;
+  this->ComputeLevelSetGroups( groups );
 
-    ++it;
+  for( typename LevelSetGroupContainerType::const_iterator groupIt = groups.begin(); groupIt != groups.end(); ++groupIt )
+    {
+    const IndexValueType groupSize = static_cast< IndexValueType >( groupIt->size() );
+    const bool concurrently = groupSize > 1 && this->GetNumberOfThreads() > 1;
+
+    // Each level set is updated by a single thread when they are updated concurrently
+    for( IndexValueType ii = 0; ii < groupSize; ++ii )
+      {
+      this->m_UpdateLevelSetFilters[( *groupIt )[ii]]->SetNumberOfThreads( concurrently ? 1 : this->GetNumberOfThreads() );
+      }
+
+    if( concurrently )
+      {
+      this->m_LevelSetGroupToUpdate = *groupIt;
+      typename SplitLevelSetContainerUpdateLevelSetsThreaderType::DomainType completeDomain;
+      completeDomain[0] = 0;
+      completeDomain[1] = groupSize - 1;
+      this->m_SplitLevelSetContainerUpdateLevelSetsThreader->Execute( this, completeDomain );
+      }
+    else
+      {
+      for( IndexValueType ii = 0; ii < groupSize; ++ii )
+        {
+        UpdateLevelSetFilterType * updateLevelSet = this->m_UpdateLevelSetFilters[( *groupIt )[ii]];
+        updateLevelSet->Update();
+
+        updateLevelSet->GetModifiableInputLevelSet()->Graft( updateLevelSet->GetOutputLevelSet() );
+        }
+      }
+    }
+
+  for( IndexValueType ii = 0; ii < numberOfLevelSets; ++ii )
+    {
+    this->m_RMSChangeAccumulator += this->m_UpdateLevelSetFilters[ii]->GetRMSChangeAccumulator();
     }
+  this->m_UpdateLevelSetFilters.clear();
 }
 
 template< typename TEquationContainer, unsigned int VDimension >
@@ -417,6 +506,7 @@ template< typename TEquationContainer, unsigned int VDimension >
 LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimension > >
 ::LevelSetEvolution()
 {
+  this->m_SplitLevelSetContainerUpdateLevelSetsThreader = SplitLevelSetContainerUpdateLevelSetsThreaderType::New();
 }
 
 template< typename TEquationContainer, unsigned int VDimension >
@@ -424,29 +514,81 @@ LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimension >
 ::~LevelSetEvolution()
 {}
 
+template< typename TEquationContainer, unsigned int VDimension >
+void
+LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimension > >
+::SetNumberOfThreads( const ThreadIdType numberOfThreads )
+{
+  this->m_SplitLevelSetContainerUpdateLevelSetsThreader->SetMaximumNumberOfThreads( numberOfThreads );
+}
+
+template< typename TEquationContainer, unsigned int VDimension >
+ThreadIdType
+LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimension > >
+::GetNumberOfThreads() const
+{
+  return this->m_SplitLevelSetContainerUpdateLevelSetsThreader->GetMaximumNumberOfThreads();
+}
+
 template< typename TEquationContainer, unsigned int VDimension >
 void LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimension > >
 ::UpdateLevelSets()
 {
-  typename LevelSetContainerType::Iterator it = this->m_LevelSetContainer->Begin();
+  this->m_UpdateLevelSetFilters.clear();
 
+  typename LevelSetContainerType::Iterator it = this->m_LevelSetContainer->Begin();
   while( it != this->m_LevelSetContainer->End() )
     {
-    typename LevelSetType::Pointer levelSet = it->GetLevelSet();
-    LevelSetIdentifierType       levelSetId = it->GetIdentifier();
-
     UpdateLevelSetFilterPointer updateLevelSet = UpdateLevelSetFilterType::New();
-    updateLevelSet->SetInputLevelSet( levelSet );
-    updateLevelSet->SetCurrentLevelSetId( levelSetId );
+    updateLevelSet->SetInputLevelSet( it->GetLevelSet() );
+    updateLevelSet->SetCurrentLevelSetId( it->GetIdentifier() );
     updateLevelSet->SetEquationContainer( this->m_EquationContainer );
-    updateLevelSet->Update();
+    this->m_UpdateLevelSetFilters.push_back( updateLevelSet );
+    ++it;
+    }
 
-    levelSet->Graft( updateLevelSet->GetOutputLevelSet() );
+  const IndexValueType numberOfLevelSets = static_cast< IndexValueType >( this->m_UpdateLevelSetFilters.size() );
 
-    this->m_RMSChangeAccumulator = updateLevelSet->GetRMSChangeAccumulator();
+  // The groups are updated in the same order whatever the number of threads
+  LevelSetGroupContainerType groups;
+  this->ComputeLevelSetGroups( groups );
 
-    ++it;
+  for( typename LevelSetGroupContainerType::const_iterator groupIt = groups.begin(); groupIt != groups.end(); ++groupIt )
+    {
+    const IndexValueType groupSize = static_cast< IndexValueType >( groupIt->size() );
+    const bool concurrently = groupSize > 1 && this->GetNumberOfThreads() > 1;
+
+    // Each level set is updated by a single thread when they are updated concurrently
+    for( IndexValueType ii = 0; ii < groupSize; ++ii )
+      {
+      this->m_UpdateLevelSetFilters[( *groupIt )[ii]]->SetNumberOfThreads( concurrently ? 1 : this->GetNumberOfThreads() );
+      }
+
+    if( concurrently )
+      {
+      this->m_LevelSetGroupToUpdate = *groupIt;
+      typename SplitLevelSetContainerUpdateLevelSetsThreaderType::DomainType completeDomain;
+      completeDomain[0] = 0;
+      completeDomain[1] = groupSize - 1;
+      this->m_SplitLevelSetContainerUpdateLevelSetsThreader->Execute( this, completeDomain );
+      }
+    else
+      {
+      for( IndexValueType ii = 0; ii < groupSize; ++ii )
+        {
+        UpdateLevelSetFilterType * updateLevelSet = this->m_UpdateLevelSetFilters[( *groupIt )[ii]];
+        updateLevelSet->Update();
+
+        updateLevelSet->GetModifiableInputLevelSet()->Graft( updateLevelSet->GetOutputLevelSet() );
+        }
+      }
+    }
+
+  for( IndexValueType ii = 0; ii < numberOfLevelSets; ++ii )
+    {
+    this->m_RMSChangeAccumulator += this->m_UpdateLevelSetFilters[ii]->GetRMSChangeAccumulator();
     }
+  this->m_UpdateLevelSetFilters.clear();
 }
 
 template< typename TEquationContainer, unsigned int VDimension >
@@ -21,6 +21,9 @@
 #define itkLevelSetEvolutionBase_h
 
 #include <list>
+#include <map>
+#include <set>
+#include <vector>
 
 #include "itkImage.h"
 #include "itkDiscreteLevelSetImage.h"
@@ -148,6 +151,19 @@ protected:
 
   virtual void UpdateEquations() = 0;
 
+  /** Positions of level sets in the level set container */
+  typedef std::vector< IndexValueType >    LevelSetGroupType;
+  typedef std::vector< LevelSetGroupType > LevelSetGroupContainerType;
+
+  /** Split the level sets into groups whose domains do not overlap, with a
+   *  greedy coloring of the graph of the overlaps given by the domain map
+   *  of the level set container. Each level set joins the first group,
+   *  in the order of the container, that has no level set overlapping it.
+   *  The level sets of a group can then be updated independently of each
+   *  other, the groups one after the other. Without a domain map, each
+   *  level set is a group. */
+  void ComputeLevelSetGroups( LevelSetGroupContainerType & groups ) const;
+
   StoppingCriterionPointer    m_StoppingCriterion;
 
   EquationContainerPointer                 m_EquationContainer;
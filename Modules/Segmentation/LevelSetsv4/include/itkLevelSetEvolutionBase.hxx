@@ -268,5 +268,99 @@ LevelSetEvolutionBase< TEquationContainer, TLevelSet >
 {
 }
 
+template< typename TEquationContainer, typename TLevelSet >
+void
+LevelSetEvolutionBase< TEquationContainer, TLevelSet >
+::ComputeLevelSetGroups( LevelSetGroupContainerType & groups ) const
+{
+  groups.clear();
+
+  typedef std::map< LevelSetIdentifierType, IndexValueType > PositionMapType;
+  PositionMapType positions;
+
+  typename LevelSetContainerType::Iterator it = this->m_LevelSetContainer->Begin();
+  while( it != this->m_LevelSetContainer->End() )
+    {
+    const IndexValueType position = static_cast< IndexValueType >( positions.size() );
+    positions[it->GetIdentifier()] = position;
+    ++it;
+    }
+
+  const IndexValueType numberOfLevelSets = static_cast< IndexValueType >( positions.size() );
+
+  if( !this->m_LevelSetContainer->HasDomainMap() )
+    {
+    for( IndexValueType ii = 0; ii < numberOfLevelSets; ++ii )
+      {
+      groups.push_back( LevelSetGroupType( 1, ii ) );
+      }
+    return;
+    }
+
+  // The identifiers of the domain map start at 1, see
+  // LevelSetEquationChanAndVeseExternalTerm
+  std::vector< std::set< IndexValueType > > overlaps( numberOfLevelSets );
+
+  typedef typename DomainMapImageFilterType::DomainMapType DomainMapType;
+  const DomainMapType & domainMap = this->m_LevelSetContainer->GetDomainMapFilter()->GetDomainMap();
+
+  typename DomainMapType::const_iterator mapIt = domainMap.begin();
+  while( mapIt != domainMap.end() )
+    {
+    const IdListType * idList = mapIt->second.GetIdList();
+
+    std::vector< IndexValueType > domainPositions;
+    for( IdListConstIterator idIt = idList->begin(); idIt != idList->end(); ++idIt )
+      {
+      typename PositionMapType::const_iterator positionIt =
+        positions.find( static_cast< LevelSetIdentifierType >( *idIt - 1 ) );
+      if( positionIt != positions.end() )
+        {
+        domainPositions.push_back( positionIt->second );
+        }
+      }
+
+    for( size_t ii = 0; ii < domainPositions.size(); ++ii )
+      {
+      for( size_t jj = 0; jj < domainPositions.size(); ++jj )
+        {
+        if( ii != jj )
+          {
+          overlaps[domainPositions[ii]].insert( domainPositions[jj] );
+          }
+        }
+      }
+    ++mapIt;
+    }
+
+  for( IndexValueType ii = 0; ii < numberOfLevelSets; ++ii )
+    {
+    typename LevelSetGroupContainerType::iterator groupIt = groups.begin();
+    while( groupIt != groups.end() )
+      {
+      bool overlapping = false;
+      for( typename LevelSetGroupType::const_iterator memberIt = groupIt->begin();
+           memberIt != groupIt->end() && !overlapping; ++memberIt )
+        {
+        overlapping = overlaps[ii].count( *memberIt ) > 0;
+        }
+      if( !overlapping )
+        {
+        break;
+        }
+      ++groupIt;
+      }
+
+    if( groupIt == groups.end() )
+      {
+      groups.push_back( LevelSetGroupType( 1, ii ) );
+      }
+    else
+      {
+      groupIt->push_back( ii );
+      }
+    }
+}
+
 }
 #endif // itkLevelSetEvolutionBase_hxx
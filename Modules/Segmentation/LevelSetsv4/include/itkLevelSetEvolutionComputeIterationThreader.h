@@ -178,6 +178,7 @@ public:
   typedef typename LevelSetEvolutionType::LevelSetDataType       LevelSetDataType;
   typedef typename LevelSetEvolutionType::TermContainerType      TermContainerType;
   typedef typename LevelSetEvolutionType::NodePairType           NodePairType;
+  typedef typename TermContainerType::CFLContributionArrayType   CFLContributionArrayType;
 
 protected:
   LevelSetEvolutionComputeIterationThreader();
@@ -191,6 +192,11 @@ protected:
   typedef std::vector< std::vector< NodePairType > > NodePairsPerThreadType;
   NodePairsPerThreadType m_NodePairsPerThread;
 
+  /** Largest absolute values of the terms, kept by each thread and merged
+   * into the term container after the threads */
+  typedef std::vector< CFLContributionArrayType > CFLContributionsPerThreadType;
+  CFLContributionsPerThreadType m_CFLContributionsPerThread;
+
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(LevelSetEvolutionComputeIterationThreader);
 };
@@ -182,10 +182,12 @@ LevelSetEvolutionComputeIterationThreader<
 {
   const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
   this->m_NodePairsPerThread.resize( numberOfThreads );
+  this->m_CFLContributionsPerThread.resize( numberOfThreads );
 
   for( ThreadIdType ii = 0; ii < numberOfThreads; ++ii )
     {
     this->m_NodePairsPerThread[ii].clear();
+    this->m_CFLContributionsPerThread[ii].clear();
     }
 }
 
@@ -218,7 +220,8 @@ LevelSetEvolutionComputeIterationThreader<
     termContainer->ComputeRequiredData( inputIndex, characteristics );
 
     const LevelSetOutputType temp_update =
-        static_cast< LevelSetOutputType >( termContainer->Evaluate( inputIndex, characteristics ) );
+        static_cast< LevelSetOutputType >( termContainer->Evaluate( inputIndex, characteristics,
+                                                                    this->m_CFLContributionsPerThread[threadId] ) );
 
     this->m_NodePairsPerThread[threadId].push_back( NodePairType( levelsetIndex, temp_update ) );
 
@@ -237,10 +240,13 @@ LevelSetEvolutionComputeIterationThreader<
   typename LevelSetContainerType::Iterator it = this->m_Associate->m_LevelSetContainerIteratorToProcessWhenThreading;
   LevelSetIdentifierType levelSetId = it->GetIdentifier();
   typename LevelSetEvolutionType::LevelSetLayerType * levelSetLayerUpdateBuffer = this->m_Associate->m_UpdateBuffer[ levelSetId ];
+  typename TermContainerType::Pointer termContainer = this->m_Associate->m_EquationContainer->GetEquation( levelSetId );
 
   const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
   for( ThreadIdType ii = 0; ii < numberOfThreads; ++ii )
     {
+    termContainer->UpdateCFLContributions( this->m_CFLContributionsPerThread[ii] );
+
     typename std::vector< NodePairType >::const_iterator pairIt = this->m_NodePairsPerThread[ii].begin();
     while( pairIt != this->m_NodePairsPerThread[ii].end() )
       {
@@ -22,6 +22,7 @@
 #include "itkDomainThreader.h"
 #include "itkLevelSetDenseImage.h"
 #include "itkThreadedImageRegionPartitioner.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
 
 namespace itk
 {
@@ -84,6 +85,43 @@ private:
   ITK_DISALLOW_COPY_AND_ASSIGN(LevelSetEvolutionUpdateLevelSetsThreader);
 };
 
+// For sparse level sets split by putting whole level sets of a group in
+// each thread. The level sets of the group must be independent of each
+// other, i.e. their domains must not overlap.
+template< typename TLevelSet, typename TLevelSetEvolution >
+class ITK_TEMPLATE_EXPORT LevelSetEvolutionUpdateLevelSetsThreader< TLevelSet, ThreadedIndexedContainerPartitioner, TLevelSetEvolution >
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, TLevelSetEvolution >
+{
+public:
+  /** Standard class typedefs. */
+  typedef LevelSetEvolutionUpdateLevelSetsThreader                                 Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, TLevelSetEvolution > Superclass;
+  typedef SmartPointer< Self >                                                     Pointer;
+  typedef SmartPointer< const Self >                                               ConstPointer;
+
+  /** Run time type information. */
+  itkTypeMacro( LevelSetEvolutionUpdateLevelSetsThreader, DomainThreader );
+
+  /** Standard New macro. */
+  itkNewMacro( Self );
+
+  /** Superclass types. */
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+
+  /** Types of the associate class. */
+  typedef TLevelSetEvolution                                       LevelSetEvolutionType;
+  typedef typename LevelSetEvolutionType::UpdateLevelSetFilterType UpdateLevelSetFilterType;
+
+protected:
+  LevelSetEvolutionUpdateLevelSetsThreader();
+
+  virtual void ThreadedExecution( const DomainType & indexSubRange, const ThreadIdType threadId ) ITK_OVERRIDE;
+
+private:
+  ITK_DISALLOW_COPY_AND_ASSIGN(LevelSetEvolutionUpdateLevelSetsThreader);
+};
+
 } // end namespace itk
 
 #ifndef ITK_MANUAL_INSTANTIATION
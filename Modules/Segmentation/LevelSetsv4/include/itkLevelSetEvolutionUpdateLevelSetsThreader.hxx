@@ -89,6 +89,28 @@ LevelSetEvolutionUpdateLevelSetsThreader< LevelSetDenseImage< TImage >, Threaded
     }
 }
 
+template< typename TLevelSet, typename TLevelSetEvolution >
+LevelSetEvolutionUpdateLevelSetsThreader< TLevelSet, ThreadedIndexedContainerPartitioner, TLevelSetEvolution >
+::LevelSetEvolutionUpdateLevelSetsThreader()
+{
+}
+
+template< typename TLevelSet, typename TLevelSetEvolution >
+void
+LevelSetEvolutionUpdateLevelSetsThreader< TLevelSet, ThreadedIndexedContainerPartitioner, TLevelSetEvolution >
+::ThreadedExecution( const DomainType & indexSubRange,
+                     const ThreadIdType itkNotUsed(threadId) )
+{
+  for( IndexValueType ii = indexSubRange[0]; ii <= indexSubRange[1]; ++ii )
+    {
+    UpdateLevelSetFilterType * updateLevelSet =
+      this->m_Associate->m_UpdateLevelSetFilters[this->m_Associate->m_LevelSetGroupToUpdate[ii]];
+    updateLevelSet->Update();
+
+    updateLevelSet->GetModifiableInputLevelSet()->Graft( updateLevelSet->GetOutputLevelSet() );
+    }
+}
+
 } // end namespace itk
 
 #endif
@@ -0,0 +1,112 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLevelSetLayerEvaluateThreader_h
+#define itkLevelSetLayerEvaluateThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIteratorRangePartitioner.h"
+
+namespace itk
+{
+
+/** \class LevelSetLayerEvaluateThreader
+ * \brief Thread the evaluation of a term container over a layer of a
+ * sparse level set.
+ *
+ * The nodes of the layer are split in ranges, one per thread, and the
+ * term container is evaluated at each node. The updates are returned in
+ * the order of the layer, so that the caller can move the nodes between
+ * the layers with a single thread, exactly as if it had evaluated them
+ * itself.
+ *
+ * Each thread keeps the largest absolute values of the terms, used for
+ * the CFL condition, and they are merged into the term container after
+ * the threads. The terms themselves must not be modified during the
+ * evaluation, i.e. the UpdatePixel method of the container must not be
+ * called concurrently.
+ *
+ * \tparam TLayer Layer of the sparse level set
+ * \tparam TTermContainer Term container of the level set equation
+ *
+ * \ingroup ITKLevelSetsv4
+ */
+template< typename TLayer, typename TTermContainer >
+class ITK_TEMPLATE_EXPORT LevelSetLayerEvaluateThreader
+  : public DomainThreader< ThreadedIteratorRangePartitioner< typename TLayer::const_iterator >, TTermContainer >
+{
+public:
+  /** Standard class typedefs. */
+  typedef LevelSetLayerEvaluateThreader                                                                        Self;
+  typedef DomainThreader< ThreadedIteratorRangePartitioner< typename TLayer::const_iterator >, TTermContainer > Superclass;
+  typedef SmartPointer< Self >                                                                                 Pointer;
+  typedef SmartPointer< const Self >                                                                           ConstPointer;
+
+  /** Run time type information. */
+  itkTypeMacro( LevelSetLayerEvaluateThreader, DomainThreader );
+
+  /** Standard New macro. */
+  itkNewMacro( Self );
+
+  /** Superclass types. */
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+
+  typedef TLayer                                             LayerType;
+  typedef typename LayerType::const_iterator                 LayerConstIterator;
+  typedef typename LayerType::key_type                       LevelSetInputType;
+  typedef typename LevelSetInputType::OffsetType             LevelSetOffsetType;
+  typedef TTermContainer                                     TermContainerType;
+  typedef typename TermContainerType::LevelSetOutputRealType LevelSetOutputRealType;
+  typedef typename TermContainerType::CFLContributionArrayType CFLContributionArrayType;
+  typedef std::vector< LevelSetOutputRealType >                UpdateContainerType;
+
+  /** Evaluate the term container at the nodes of the layer, moved by the
+   * offset of the domain of the level set, and store the updates in the
+   * order of the layer. */
+  void Evaluate( TermContainerType * termContainer, const LayerType & layer,
+                 const LevelSetOffsetType & offset, UpdateContainerType & updates );
+
+protected:
+  LevelSetLayerEvaluateThreader();
+
+  virtual void BeforeThreadedExecution() ITK_OVERRIDE;
+
+  virtual void ThreadedExecution( const DomainType & iteratorSubRange, const ThreadIdType threadId ) ITK_OVERRIDE;
+
+  virtual void AfterThreadedExecution() ITK_OVERRIDE;
+
+  typedef std::vector< UpdateContainerType > UpdatesPerThreadType;
+  UpdatesPerThreadType m_UpdatesPerThread;
+
+  typedef std::vector< CFLContributionArrayType > CFLContributionsPerThreadType;
+  CFLContributionsPerThreadType m_CFLContributionsPerThread;
+
+  LevelSetOffsetType    m_Offset;
+  UpdateContainerType * m_Updates;
+
+private:
+  ITK_DISALLOW_COPY_AND_ASSIGN(LevelSetLayerEvaluateThreader);
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkLevelSetLayerEvaluateThreader.hxx"
+#endif
+
+#endif
@@ -0,0 +1,109 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLevelSetLayerEvaluateThreader_hxx
+#define itkLevelSetLayerEvaluateThreader_hxx
+
+#include "itkLevelSetLayerEvaluateThreader.h"
+
+namespace itk
+{
+
+template< typename TLayer, typename TTermContainer >
+LevelSetLayerEvaluateThreader< TLayer, TTermContainer >
+::LevelSetLayerEvaluateThreader() :
+  m_Updates( ITK_NULLPTR )
+{
+  this->m_Offset.Fill( 0 );
+}
+
+template< typename TLayer, typename TTermContainer >
+void
+LevelSetLayerEvaluateThreader< TLayer, TTermContainer >
+::Evaluate( TermContainerType * termContainer, const LayerType & layer,
+            const LevelSetOffsetType & offset, UpdateContainerType & updates )
+{
+  updates.clear();
+
+  // The partitioner cannot split an empty range
+  if( layer.empty() )
+    {
+    return;
+    }
+
+  this->m_Offset = offset;
+  this->m_Updates = &updates;
+
+  DomainType completeDomain( layer.begin(), layer.end() );
+  this->Execute( termContainer, completeDomain );
+
+  this->m_Updates = ITK_NULLPTR;
+}
+
+template< typename TLayer, typename TTermContainer >
+void
+LevelSetLayerEvaluateThreader< TLayer, TTermContainer >
+::BeforeThreadedExecution()
+{
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
+  this->m_UpdatesPerThread.resize( numberOfThreads );
+  this->m_CFLContributionsPerThread.resize( numberOfThreads );
+
+  for( ThreadIdType ii = 0; ii < numberOfThreads; ++ii )
+    {
+    this->m_UpdatesPerThread[ii].clear();
+    this->m_CFLContributionsPerThread[ii].clear();
+    }
+}
+
+template< typename TLayer, typename TTermContainer >
+void
+LevelSetLayerEvaluateThreader< TLayer, TTermContainer >
+::ThreadedExecution( const DomainType & iteratorSubRange,
+                     const ThreadIdType threadId )
+{
+  UpdateContainerType &      updates = this->m_UpdatesPerThread[threadId];
+  CFLContributionArrayType & contributions = this->m_CFLContributionsPerThread[threadId];
+
+  LayerConstIterator nodeIt = iteratorSubRange.Begin();
+  while( nodeIt != iteratorSubRange.End() )
+    {
+    updates.push_back( this->m_Associate->Evaluate( nodeIt->first + this->m_Offset, contributions ) );
+    ++nodeIt;
+    }
+}
+
+template< typename TLayer, typename TTermContainer >
+void
+LevelSetLayerEvaluateThreader< TLayer, TTermContainer >
+::AfterThreadedExecution()
+{
+  // The ranges of the threads follow each other in the layer
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
+  for( ThreadIdType ii = 0; ii < numberOfThreads; ++ii )
+    {
+    this->m_Updates->insert( this->m_Updates->end(),
+                             this->m_UpdatesPerThread[ii].begin(),
+                             this->m_UpdatesPerThread[ii].end() );
+    this->m_UpdatesPerThread[ii].clear();
+    this->m_Associate->UpdateCFLContributions( this->m_CFLContributionsPerThread[ii] );
+    }
+}
+
+} // end namespace itk
+
+#endif
@@ -27,6 +27,7 @@
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkLabelMapToLabelImageFilter.h"
 #include "itkLabelImageToLabelMapFilter.h"
+#include "itkLevelSetLayerEvaluateThreader.h"
 
 namespace itk
 {
@@ -34,6 +35,10 @@ namespace itk
  *  \class UpdateMalcolmSparseLevelSet
  *  \brief Base class for updating the Malcolm representation of level-set function
  *
+ *  The equation is evaluated at the nodes of the zero layer with
+ *  NumberOfThreads threads. The nodes are then moved by a single thread,
+ *  so that the result does not depend on the number of threads.
+ *
  *  \tparam VDimension Dimension of the input space
  *  \tparam TEquationContainer Container of the system of levelset equations
  *  \ingroup ITKLevelSetsv4
@@ -81,6 +86,7 @@ public:
 
   typedef TEquationContainer                                    EquationContainerType;
   typedef typename EquationContainerType::Pointer               EquationContainerPointer;
+  typedef typename EquationContainerType::TermContainerType     TermContainerType;
   typedef typename EquationContainerType::TermContainerPointer  TermContainerPointer;
 
   itkGetModifiableObjectMacro(OutputLevelSet, LevelSetType );
@@ -103,6 +109,10 @@ public:
   itkSetMacro( CurrentLevelSetId, IdentifierType );
   itkGetMacro( CurrentLevelSetId, IdentifierType );
 
+  /** Set/Get the maximum number of threads evaluating the equation */
+  void SetNumberOfThreads( const ThreadIdType threads );
+  ThreadIdType GetNumberOfThreads() const;
+
 protected:
   UpdateMalcolmSparseLevelSet();
   virtual ~UpdateMalcolmSparseLevelSet();
@@ -123,6 +133,9 @@ protected:
 
   typedef ShapedNeighborhoodIterator< LabelImageType > NeighborhoodIteratorType;
 
+  typedef LevelSetLayerEvaluateThreader< LevelSetLayerType, TermContainerType > LayerEvaluateThreaderType;
+  typename LayerEvaluateThreaderType::Pointer m_LayerEvaluateThreader;
+
   bool m_IsUsingUnPhasedPropagation;
 
   /** Compute the updates for all points in the 0 layer and store in UpdateContainer */
@@ -35,6 +35,7 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
 {
   this->m_Offset.Fill( 0 );
   this->m_OutputLevelSet = LevelSetType::New();
+  this->m_LayerEvaluateThreader = LayerEvaluateThreaderType::New();
 }
 
 template< unsigned int VDimension, typename TEquationContainer >
@@ -42,6 +43,22 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
 ::~UpdateMalcolmSparseLevelSet()
 {}
 
+template< unsigned int VDimension, typename TEquationContainer >
+void
+UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
+::SetNumberOfThreads( const ThreadIdType numberOfThreads )
+{
+  this->m_LayerEvaluateThreader->SetMaximumNumberOfThreads( numberOfThreads );
+}
+
+template< unsigned int VDimension, typename TEquationContainer >
+ThreadIdType
+UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
+::GetNumberOfThreads() const
+{
+  return this->m_LayerEvaluateThreader->GetMaximumNumberOfThreads();
+}
+
 
 template< unsigned int VDimension, typename TEquationContainer >
 void
@@ -135,20 +152,20 @@ void
 UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
 ::FillUpdateContainer()
 {
-  LevelSetLayerType levelZero = this->m_OutputLevelSet->GetLayer( LevelSetType::ZeroLayer() );
-
-  LevelSetLayerIterator nodeIt = levelZero.begin();
-  LevelSetLayerIterator nodeEnd = levelZero.end();
+  const LevelSetLayerType & levelZero = this->m_OutputLevelSet->GetLayer( LevelSetType::ZeroLayer() );
 
   TermContainerPointer termContainer = this->m_EquationContainer->GetEquation( this->m_CurrentLevelSetId );
 
-  LevelSetInputType inputIndex;
+  typename LayerEvaluateThreaderType::UpdateContainerType updates;
+  this->m_LayerEvaluateThreader->Evaluate( termContainer, levelZero, this->m_Offset, updates );
+  typename LayerEvaluateThreaderType::UpdateContainerType::const_iterator upIt = updates.begin();
+
+  LevelSetLayerConstIterator nodeIt = levelZero.begin();
+  LevelSetLayerConstIterator nodeEnd = levelZero.end();
+
   while( nodeIt != nodeEnd )
     {
-    const LevelSetInputType currentIndex = nodeIt->first;
-    inputIndex = currentIndex + this->m_Offset;
-
-    const LevelSetOutputRealType update = termContainer->Evaluate( inputIndex );
+    const LevelSetOutputRealType update = *upIt;
 
     LevelSetOutputType value = NumericTraits< LevelSetOutputType >::ZeroValue();
 
@@ -161,9 +178,11 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
       value = - NumericTraits< LevelSetOutputType >::OneValue();
       }
 
-    this->m_Update.insert( NodePairType( currentIndex, value ) );
+    // The nodes come in the order of the map
+    this->m_Update.insert( this->m_Update.end(), NodePairType( nodeIt->first, value ) );
 
     ++nodeIt;
+    ++upIt;
     }
 }
 
@@ -27,6 +27,7 @@
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkLabelMapToLabelImageFilter.h"
 #include "itkLabelImageToLabelMapFilter.h"
+#include "itkLevelSetLayerEvaluateThreader.h"
 
 namespace itk
 {
@@ -34,6 +35,11 @@ namespace itk
  *  \class UpdateShiSparseLevelSet
  *  \brief Base class for updating the Shi representation of level-set function
  *
+ *  The equation is evaluated at the nodes of the +1 and -1 layers with
+ *  NumberOfThreads threads before the nodes are moved between the layers,
+ *  which is done by a single thread. The result does not depend on the
+ *  number of threads.
+ *
  *  \tparam VDimension Dimension of the input space
  *  \tparam TEquationContainer Container of the system of levelset equations
  *  \ingroup ITKLevelSetsv4
@@ -81,6 +87,7 @@ public:
 
   typedef TEquationContainer                                    EquationContainerType;
   typedef typename EquationContainerType::Pointer               EquationContainerPointer;
+  typedef typename EquationContainerType::TermContainerType     TermContainerType;
   typedef typename EquationContainerType::TermContainerPointer  TermContainerPointer;
 
   itkGetModifiableObjectMacro(OutputLevelSet, LevelSetType );
@@ -103,6 +110,10 @@ public:
   itkSetMacro( CurrentLevelSetId, IdentifierType );
   itkGetMacro( CurrentLevelSetId, IdentifierType );
 
+  /** Set/Get the maximum number of threads evaluating the equation */
+  void SetNumberOfThreads( const ThreadIdType threads );
+  ThreadIdType GetNumberOfThreads() const;
+
 protected:
   UpdateShiSparseLevelSet();
   virtual ~UpdateShiSparseLevelSet();
@@ -121,6 +132,9 @@ protected:
 
   typedef ShapedNeighborhoodIterator< LabelImageType > NeighborhoodIteratorType;
 
+  typedef LevelSetLayerEvaluateThreader< LevelSetLayerType, TermContainerType > LayerEvaluateThreaderType;
+  typename LayerEvaluateThreaderType::Pointer m_LayerEvaluateThreader;
+
   /** Update +1 level set layers by checking the direction of the movement towards -1 */
   // this is the same as Procedure 2
   // Input is a update image point m_UpdateImage
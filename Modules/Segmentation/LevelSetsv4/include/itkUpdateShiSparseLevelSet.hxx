@@ -32,6 +32,7 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
 {
   this->m_Offset.Fill( 0 );
   this->m_OutputLevelSet = LevelSetType::New();
+  this->m_LayerEvaluateThreader = LayerEvaluateThreaderType::New();
 }
 
 template< unsigned int VDimension,
@@ -40,6 +41,22 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
 ::~UpdateShiSparseLevelSet()
 {}
 
+template< unsigned int VDimension, typename TEquationContainer >
+void
+UpdateShiSparseLevelSet< VDimension, TEquationContainer >
+::SetNumberOfThreads( const ThreadIdType numberOfThreads )
+{
+  this->m_LayerEvaluateThreader->SetMaximumNumberOfThreads( numberOfThreads );
+}
+
+template< unsigned int VDimension, typename TEquationContainer >
+ThreadIdType
+UpdateShiSparseLevelSet< VDimension, TEquationContainer >
+::GetNumberOfThreads() const
+{
+  return this->m_LayerEvaluateThreader->GetMaximumNumberOfThreads();
+}
+
 
 template< unsigned int VDimension, typename TEquationContainer >
 void
@@ -229,21 +246,24 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
   LevelSetLayerType insertListIn;
   LevelSetLayerType insertListOut;
 
+  // The equation does not change before the nodes are moved
+  typename LayerEvaluateThreaderType::UpdateContainerType updates;
+  this->m_LayerEvaluateThreader->Evaluate( termContainer, listOut, this->m_Offset, updates );
+  typename LayerEvaluateThreaderType::UpdateContainerType::const_iterator upIt = updates.begin();
+
   LevelSetLayerIterator nodeIt   = listOut.begin();
   LevelSetLayerIterator nodeEnd  = listOut.end();
 
-  LevelSetInputType inputIndex;
-
   // for each point in Lz
   while( nodeIt != nodeEnd )
     {
     bool erased = false;
     const LevelSetInputType   currentIndex = nodeIt->first;
     const LevelSetOutputType  currentValue = nodeIt->second;
-    inputIndex = currentIndex + this->m_Offset;
 
     // update the level set
-    LevelSetOutputRealType update = termContainer->Evaluate( inputIndex );
+    const LevelSetOutputRealType update = *upIt;
+    ++upIt;
 
     if( update < NumericTraits< LevelSetOutputRealType >::ZeroValue() )
       {
@@ -346,6 +366,11 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
   LevelSetLayerType insertListIn;
   LevelSetLayerType insertListOut;
 
+  // The equation does not change before the nodes are moved
+  typename LayerEvaluateThreaderType::UpdateContainerType updates;
+  this->m_LayerEvaluateThreader->Evaluate( termContainer, listIn, this->m_Offset, updates );
+  typename LayerEvaluateThreaderType::UpdateContainerType::const_iterator upIt = updates.begin();
+
   LevelSetLayerIterator nodeIt   = listIn.begin();
   LevelSetLayerIterator nodeEnd  = listIn.end();
 
@@ -355,10 +380,10 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
     bool erased = false;
     const LevelSetInputType   currentIndex = nodeIt->first;
     const LevelSetOutputType  currentValue = nodeIt->second;
-    const LevelSetInputType inputIndex = currentIndex + this->m_Offset;
 
     // update for the current level set
-    LevelSetOutputRealType update = termContainer->Evaluate( inputIndex );
+    const LevelSetOutputRealType update = *upIt;
+    ++upIt;
 
     if( update > NumericTraits< LevelSetOutputRealType >::ZeroValue() )
       {
@@ -0,0 +1,286 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkWhitakerSparseLevelSetImage.h"
+#include "itkShiSparseLevelSetImage.h"
+#include "itkMalcolmSparseLevelSetImage.h"
+#include "itkLevelSetContainer.h"
+#include "itkLevelSetEquationChanAndVeseInternalTerm.h"
+#include "itkLevelSetEquationChanAndVeseExternalTerm.h"
+#include "itkLevelSetEquationTermContainer.h"
+#include "itkLevelSetEquationContainer.h"
+#include "itkLevelSetEvolution.h"
+#include "itkLevelSetEvolutionNumberOfIterationsStoppingCriterion.h"
+#include "itkBinaryImageToLevelSetImageAdaptor.h"
+#include "itkAtanRegularizedHeavisideStepFunction.h"
+#include "itkLevelSetDomainMapImageFilter.h"
+#include "itkTestingMacros.h"
+
+// Three level sets evolve in the three thirds of an image. The domain of
+// the second one also covers half of the first third, so the first and the
+// last level sets are updated concurrently when several threads are used,
+// then the second one, whose layers are evaluated by several threads. The
+// result must not depend on the number of threads.
+template< typename TLevelSet >
+int itkMultiLevelSetSparseConcurrentUpdate( itk::ThreadIdType numberOfThreads,
+                                            std::vector< typename TLevelSet::OutputType > & values )
+{
+  const unsigned int Dimension = TLevelSet::Dimension;
+
+  typedef unsigned short                                      InputPixelType;
+  typedef itk::Image< InputPixelType, Dimension >             InputImageType;
+  typedef itk::ImageRegionIteratorWithIndex< InputImageType > InputIteratorType;
+
+  typedef TLevelSet                                  LevelSetType;
+  typedef typename LevelSetType::OutputRealType      LevelSetOutputRealType;
+
+  typedef itk::IdentifierType                                     IdentifierType;
+  typedef itk::LevelSetContainer< IdentifierType, LevelSetType >  LevelSetContainerType;
+
+  typedef itk::LevelSetEquationChanAndVeseInternalTerm< InputImageType, LevelSetContainerType >
+                                                                      ChanAndVeseInternalTermType;
+  typedef itk::LevelSetEquationChanAndVeseExternalTerm< InputImageType, LevelSetContainerType >
+                                                                      ChanAndVeseExternalTermType;
+  typedef itk::LevelSetEquationTermContainer< InputImageType, LevelSetContainerType >
+                                                                      TermContainerType;
+
+  typedef itk::LevelSetEquationContainer< TermContainerType >           EquationContainerType;
+  typedef itk::LevelSetEvolution< EquationContainerType, LevelSetType > LevelSetEvolutionType;
+
+  typedef itk::AtanRegularizedHeavisideStepFunction<
+      LevelSetOutputRealType, LevelSetOutputRealType >          HeavisideFunctionBaseType;
+
+  typedef itk::BinaryImageToLevelSetImageAdaptor< InputImageType, LevelSetType > BinaryImageToLevelSetType;
+
+  typedef std::list< IdentifierType >                          IdListType;
+  typedef itk::Image< IdListType, Dimension >                  IdListImageType;
+  typedef itk::Image< short, Dimension >                       CacheImageType;
+  typedef itk::ImageRegionIteratorWithIndex< IdListImageType > IdIteratorType;
+  typedef itk::LevelSetDomainMapImageFilter< IdListImageType, CacheImageType >
+                                                               DomainMapImageFilterType;
+
+  typedef itk::LevelSetEvolutionNumberOfIterationsStoppingCriterion< LevelSetContainerType >
+                                                               StoppingCriterionType;
+
+  const unsigned int NumberOfLevelSets = 3;
+  const itk::SizeValueType DomainSize = 60;
+
+  // A bright square in each third of the input
+  typename InputImageType::SizeType size;
+  size[0] = NumberOfLevelSets * DomainSize;
+  size[1] = DomainSize;
+  typename InputImageType::RegionType region;
+  region.SetSize( size );
+
+  typename InputImageType::Pointer input = InputImageType::New();
+  input->SetRegions( region );
+  input->Allocate();
+  input->FillBuffer( itk::NumericTraits< InputPixelType >::ZeroValue() );
+
+  typename IdListImageType::Pointer idImage = IdListImageType::New();
+  idImage->SetRegions( region );
+  idImage->Allocate();
+  idImage->FillBuffer( IdListType() );
+
+  typename HeavisideFunctionBaseType::Pointer heaviside = HeavisideFunctionBaseType::New();
+  heaviside->SetEpsilon( 1.0 );
+
+  typename LevelSetContainerType::Pointer lscontainer = LevelSetContainerType::New();
+  lscontainer->SetHeaviside( heaviside );
+
+  typename EquationContainerType::Pointer equationContainer = EquationContainerType::New();
+  equationContainer->SetLevelSetContainer( lscontainer );
+
+  std::vector< typename LevelSetType::Pointer >                levelSets;
+  std::vector< typename ChanAndVeseInternalTermType::Pointer > internalTerms;
+  std::vector< typename InputImageType::RegionType >           domains;
+  for( unsigned int i = 0; i < NumberOfLevelSets; i++ )
+    {
+    typename InputImageType::RegionType domain;
+    domain.SetIndex( 0, i == 1 ? DomainSize / 2 : i * DomainSize );
+    domain.SetIndex( 1, 0 );
+    domain.SetSize( 0, ( i + 1 ) * DomainSize - domain.GetIndex( 0 ) );
+    domain.SetSize( 1, DomainSize );
+    domains.push_back( domain );
+
+    typename InputImageType::RegionType square;
+    square.SetIndex( 0, i * DomainSize + 15 + 5 * i );
+    square.SetIndex( 1, 10 );
+    square.SetSize( 0, 25 );
+    square.SetSize( 1, 30 );
+    InputIteratorType iIt( input, square );
+    while( !iIt.IsAtEnd() )
+      {
+      iIt.Set( 100 );
+      ++iIt;
+      }
+
+    IdIteratorType it( idImage, domain );
+    while( !it.IsAtEnd() )
+      {
+      it.Value().push_back( i + 1 );
+      ++it;
+      }
+
+    // The initial contour is a smaller square, in the coordinates of the domain
+    typename InputImageType::Pointer binary = InputImageType::New();
+    binary->SetRegions( domain.GetSize() );
+    binary->Allocate();
+    binary->FillBuffer( itk::NumericTraits< InputPixelType >::ZeroValue() );
+
+    typename InputImageType::RegionType seed;
+    seed.SetIndex( 0, i * DomainSize + 25 - domain.GetIndex( 0 ) );
+    seed.SetIndex( 1, 20 );
+    seed.SetSize( 0, 10 );
+    seed.SetSize( 1, 12 );
+    InputIteratorType bIt( binary, seed );
+    while( !bIt.IsAtEnd() )
+      {
+      bIt.Set( itk::NumericTraits< InputPixelType >::OneValue() );
+      ++bIt;
+      }
+
+    typename BinaryImageToLevelSetType::Pointer adaptor = BinaryImageToLevelSetType::New();
+    adaptor->SetInputImage( binary );
+    adaptor->Initialize();
+    typename LevelSetType::Pointer levelSet = adaptor->GetModifiableLevelSet();
+    levelSet->SetDomainOffset( domain.GetIndex() - binary->GetLargestPossibleRegion().GetIndex() );
+    levelSets.push_back( levelSet );
+
+    if( !lscontainer->AddLevelSet( i, levelSet, false ) )
+      {
+      std::cerr << "Level set " << i << " could not be added." << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    typename ChanAndVeseInternalTermType::Pointer cvInternalTerm = ChanAndVeseInternalTermType::New();
+    cvInternalTerm->SetInput( input );
+    cvInternalTerm->SetCoefficient( 1.0 );
+    internalTerms.push_back( cvInternalTerm );
+
+    typename ChanAndVeseExternalTermType::Pointer cvExternalTerm = ChanAndVeseExternalTermType::New();
+    cvExternalTerm->SetInput( input );
+    cvExternalTerm->SetCoefficient( 1.0 );
+
+    typename TermContainerType::Pointer termContainer = TermContainerType::New();
+    termContainer->SetInput( input );
+    termContainer->SetCurrentLevelSetId( i );
+    termContainer->SetLevelSetContainer( lscontainer );
+    termContainer->AddTerm( 0, cvInternalTerm );
+    termContainer->AddTerm( 1, cvExternalTerm );
+
+    equationContainer->AddEquation( i, termContainer );
+    }
+
+  typename DomainMapImageFilterType::Pointer domainMapFilter = DomainMapImageFilterType::New();
+  domainMapFilter->SetInput( idImage );
+  domainMapFilter->Update();
+  lscontainer->SetDomainMapFilter( domainMapFilter );
+
+  typename StoppingCriterionType::Pointer criterion = StoppingCriterionType::New();
+  criterion->SetNumberOfIterations( 30 );
+
+  typename LevelSetEvolutionType::Pointer evolution = LevelSetEvolutionType::New();
+  evolution->SetEquationContainer( equationContainer );
+  evolution->SetStoppingCriterion( criterion );
+  evolution->SetLevelSetContainer( lscontainer );
+  evolution->SetNumberOfThreads( numberOfThreads );
+  TEST_SET_GET_VALUE( numberOfThreads, evolution->GetNumberOfThreads() );
+
+  TRY_EXPECT_NO_EXCEPTION( evolution->Update() );
+
+  values.clear();
+  for( unsigned int i = 0; i < NumberOfLevelSets; i++ )
+    {
+    std::cout << "  Level set " << i << ": internal mean " << internalTerms[i]->GetMean() << std::endl;
+    itk::ImageRegionConstIteratorWithIndex< IdListImageType > it( idImage, domains[i] );
+    while( !it.IsAtEnd() )
+      {
+      values.push_back( levelSets[i]->Evaluate( it.GetIndex() ) );
+      ++it;
+      }
+
+    // Each contour must have grown out of its seed into the bright square
+    // of its third, without leaking to the corner of its domain
+    typename InputImageType::IndexType inside;
+    inside[0] = i * DomainSize + 23 + 5 * i;
+    inside[1] = 14;
+    if( levelSets[i]->Evaluate( inside ) > 0 || levelSets[i]->Evaluate( domains[i].GetIndex() ) < 0 )
+      {
+      std::cerr << "Test failed: level set " << i << " did not segment the square of its domain." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
+
+template< typename TLevelSet >
+int itkMultiLevelSetSparseConcurrentUpdateCompare( const char * name )
+{
+  typedef typename TLevelSet::OutputType OutputType;
+
+  std::vector< OutputType > singleThreaded;
+  std::vector< OutputType > multiThreaded;
+
+  std::cout << name << ", 1 thread" << std::endl;
+  if( itkMultiLevelSetSparseConcurrentUpdate< TLevelSet >( 1, singleThreaded ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << name << ", 3 threads" << std::endl;
+  if( itkMultiLevelSetSparseConcurrentUpdate< TLevelSet >( 3, multiThreaded ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  TEST_EXPECT_EQUAL( singleThreaded.size(), multiThreaded.size() );
+  for( size_t k = 0; k < singleThreaded.size(); k++ )
+    {
+    if( itk::Math::NotExactlyEquals( singleThreaded[k], multiThreaded[k] ) )
+      {
+      std::cerr << "Test failed: the " << name << " level sets depend on the number of threads." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+int itkMultiLevelSetSparseConcurrentUpdateTest( int, char* [] )
+{
+  const unsigned int Dimension = 2;
+
+  if( itkMultiLevelSetSparseConcurrentUpdateCompare< itk::WhitakerSparseLevelSetImage< float, Dimension > >( "Whitaker" )
+      == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+  if( itkMultiLevelSetSparseConcurrentUpdateCompare< itk::ShiSparseLevelSetImage< Dimension > >( "Shi" )
+      == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+  if( itkMultiLevelSetSparseConcurrentUpdateCompare< itk::MalcolmSparseLevelSetImage< Dimension > >( "Malcolm" )
+      == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}